@@ -18,6 +18,7 @@ import 'package:suxingchahui/utils/device/device_utils.dart'; // 设备工具类
 import 'package:suxingchahui/widgets/ui/common/initialization_screen.dart'; // 初始化屏幕
 import 'package:suxingchahui/widgets/ui/dart/color_extensions.dart'; // 颜色扩展
 import 'package:suxingchahui/layouts/background/mouse_trail_effect.dart'; // 鼠标拖尾效果
+import 'package:suxingchahui/windows/native/render_budget_channel.dart'; // 窗口不可见时暂停轮播
 
 const Key _particleEffectKey =
     ValueKey('global_particle_effect'); // 粒子效果的全局 Key
@@ -187,8 +188,10 @@ class _AppBackgroundEffectState extends State<AppBackgroundEffect>
     _imageTimer?.cancel(); // 取消旧定时器
     _imageTimer = Timer.periodic(const Duration(seconds: 10), (timer) {
       // 启动新定时器
-      if (mounted && !_isCurrentlyResizing) {
-        // 组件已挂载且未调整大小时
+      if (mounted &&
+          !_isCurrentlyResizing &&
+          RenderBudgetChannel.level.value != RenderBudgetLevel.paused) {
+        // 组件已挂载、未调整大小且窗口可见时
         setState(() {
           _currentImageIndex = (_currentImageIndex + 1) %
               GlobalConstants.defaultBackgroundImages.length; // 切换到下一张图片
@@ -9,6 +9,8 @@ import 'dart:math' as math; // 数学函数所需
 import 'dart:io' show Platform; // 平台检测所需
 import 'package:flutter/foundation.dart' show kIsWeb; // Web 平台检测所需
 import 'package:suxingchahui/widgets/ui/dart/color_extensions.dart'; // 颜色扩展
+import 'package:suxingchahui/windows/native/native_particle_system.dart'; // Windows 原生粒子模拟
+import 'package:suxingchahui/windows/native/render_budget_channel.dart'; // 窗口不可见或节电时停用
 
 // --- 常量 ---
 const double _kMinOpacity = 0.01; // 粒子最小不透明度
@@ -116,6 +118,10 @@ class _MouseTrailEffectState extends State<MouseTrailEffect>
   late AnimationController _animationController; // 动画控制器
   final math.Random _random = math.Random(); // 随机数生成器
   bool _isEnabled = true; // 粒子效果是否启用
+  NativeParticleSystem? _nativeSystem; // Windows 上的原生粒子池，不可用时为 null
+  NativeParticleAtlas? _nativeAtlas; // 原生粒子的圆形精灵
+  final Stopwatch _stepClock = Stopwatch(); // 距上次推进原生粒子的时间
+  bool _pausedWhileAnimating = false; // 渲染预算暂停时是否打断了动画
 
   /// 初始化状态。
   ///
@@ -129,7 +135,10 @@ class _MouseTrailEffectState extends State<MouseTrailEffect>
 
     if (!_isEnabled) return; // 未启用时直接返回
 
-    for (int i = 0; i < widget.maxParticles * 2; i++) {
+    _initNativeParticles(); // Windows 上优先使用原生粒子池
+
+    final poolSize = _nativeSystem == null ? widget.maxParticles * 2 : 0;
+    for (int i = 0; i < poolSize; i++) {
       // 初始化粒子池
       _particlePool.add(MouseTrailParticle(
         position: Offset.zero,
@@ -143,6 +152,42 @@ class _MouseTrailEffectState extends State<MouseTrailEffect>
       vsync: this, // 垂直同步
       duration: _kParticleUpdateInterval, // 动画持续时间
     )..addListener(_updateParticlesAndCheckCleanup); // 添加监听器
+    RenderBudgetChannel.level.addListener(_onBudgetChanged);
+  }
+
+  /// 渲染预算变为暂停时停止动画，恢复后让剩余粒子继续淡出。
+  void _onBudgetChanged() {
+    if (RenderBudgetChannel.level.value == RenderBudgetLevel.paused) {
+      if (_animationController.isAnimating) {
+        _animationController.stop();
+        _stepClock.stop();
+        _pausedWhileAnimating = true;
+      }
+    } else if (_pausedWhileAnimating) {
+      _pausedWhileAnimating = false;
+      _stepClock
+        ..reset()
+        ..start(); // 不补推暂停期间的帧
+      _animationController.repeat();
+    }
+  }
+
+  /// 创建原生粒子池，运动规则与 [MouseTrailParticle.update] 一致。
+  void _initNativeParticles() {
+    final nativeSystem = NativeParticleSystem.create(widget.maxParticles);
+    if (nativeSystem == null) return;
+    nativeSystem.setBehavior(const NativeParticleBehavior(
+      opacityDecay: 0.94,
+      sizeDecay: 0.97,
+      minOpacity: _kMinOpacity,
+      minSize: _kMinSize,
+    ));
+    _nativeAtlas = NativeParticleAtlas.build([
+      (canvas, radius) =>
+          canvas.drawCircle(Offset.zero, radius, Paint()..color = Colors.white),
+    ]);
+    nativeSystem.setSprites(_nativeAtlas!);
+    _nativeSystem = nativeSystem;
   }
 
   /// 更新粒子状态并检查清理。
@@ -152,6 +197,19 @@ class _MouseTrailEffectState extends State<MouseTrailEffect>
   void _updateParticlesAndCheckCleanup() {
     if (!_isEnabled || !mounted) return; // 未启用或组件未挂载时返回
 
+    final nativeSystem = _nativeSystem;
+    if (nativeSystem != null) {
+      // 按实际间隔换算成 60fps 下的帧数
+      final frames = _stepClock.elapsedMicroseconds /
+          _kParticleUpdateInterval.inMicroseconds;
+      _stepClock.reset();
+      if (nativeSystem.step(frames, Size.zero) == 0 &&
+          _animationController.isAnimating) {
+        _animationController.stop(); // 所有粒子都已淡出
+      }
+      return;
+    }
+
     for (int i = _activeParticles.length - 1; i >= 0; i--) {
       // 倒序遍历活跃粒子
       final particle = _activeParticles[i]; // 获取粒子
@@ -175,9 +233,38 @@ class _MouseTrailEffectState extends State<MouseTrailEffect>
   /// 从粒子池中取出粒子，重置其状态并添加到活跃粒子列表。
   void _addParticlesAtPosition(Offset position) {
     if (!_isEnabled) return; // 未启用时返回
+    if (RenderBudgetChannel.level.value != RenderBudgetLevel.full) {
+      return; // 降帧或暂停时不生成拖尾，已有粒子照常淡出
+    }
     const int particlesToAddPerEvent = 2; // 每次事件添加的粒子数量
     int addedCount = 0; // 已添加的粒子数量
 
+    final nativeSystem = _nativeSystem;
+    if (nativeSystem != null) {
+      for (int i = 0; i < particlesToAddPerEvent; i++) {
+        final angle = _random.nextDouble() * 2 * math.pi; // 随机角度
+        final speed = 0.8 + _random.nextDouble() * 1.2; // 随机速度
+        // 池满时原生侧替换最暗（即最早生成）的粒子
+        nativeSystem.spawn(
+          position: position +
+              Offset(_random.nextDouble() * 6 - 3,
+                  _random.nextDouble() * 6 - 3), // 随机偏移位置
+          velocity: Offset(math.cos(angle) * speed, math.sin(angle) * speed),
+          size: 2.5 + _random.nextDouble() * 2.5, // 随机初始尺寸
+          opacity: 0.6 + _random.nextDouble() * 0.4, // 随机初始不透明度
+          angle: angle,
+          color: _randomParticleColor(),
+        );
+      }
+      if (!_animationController.isAnimating) {
+        _stepClock
+          ..reset()
+          ..start();
+        _animationController.repeat(); // 循环播放动画
+      }
+      return;
+    }
+
     for (int i = 0;
         i < _particlePool.length && addedCount < particlesToAddPerEvent;
         i++) {
@@ -190,12 +277,7 @@ class _MouseTrailEffectState extends State<MouseTrailEffect>
         final initialSize = 2.5 + _random.nextDouble() * 2.5; // 随机初始尺寸
         final initialOpacity = 0.6 + _random.nextDouble() * 0.4; // 随机初始不透明度
 
-        HSLColor hslColor =
-            HSLColor.fromColor(widget.particleColor); // 从粒子颜色获取 HSL 颜色
-        double newHue = (hslColor.hue + _random.nextDouble() * 30.0 - 15.0) %
-            360.0; // 随机调整色相
-        if (newHue < 0) newHue += 360.0; // 确保色相在 0-360 范围内
-        final newParticleColor = hslColor.withHue(newHue).toColor(); // 生成新粒子颜色
+        final newParticleColor = _randomParticleColor(); // 生成新粒子颜色
 
         particle.reset(
           // 重置粒子状态
@@ -226,6 +308,16 @@ class _MouseTrailEffectState extends State<MouseTrailEffect>
     }
   }
 
+  /// 在 [MouseTrailEffect.particleColor] 的基础上随机调整色相。
+  Color _randomParticleColor() {
+    HSLColor hslColor =
+        HSLColor.fromColor(widget.particleColor); // 从粒子颜色获取 HSL 颜色
+    double newHue = (hslColor.hue + _random.nextDouble() * 30.0 - 15.0) %
+        360.0; // 随机调整色相
+    if (newHue < 0) newHue += 360.0; // 确保色相在 0-360 范围内
+    return hslColor.withHue(newHue).toColor();
+  }
+
   /// 处理鼠标移动事件。
   ///
   /// [localPosition]：鼠标在本地坐标系中的位置。
@@ -260,7 +352,12 @@ class _MouseTrailEffectState extends State<MouseTrailEffect>
   /// 销毁动画控制器。
   @override
   void dispose() {
-    _animationController.dispose(); // 销毁动画控制器
+    if (_isEnabled) {
+      RenderBudgetChannel.level.removeListener(_onBudgetChanged);
+      _animationController.dispose(); // 销毁动画控制器
+    }
+    _nativeSystem?.dispose(); // 释放原生粒子池
+    _nativeAtlas?.dispose();
     super.dispose();
   }
 
@@ -288,11 +385,17 @@ class _MouseTrailEffectState extends State<MouseTrailEffect>
           // 忽略指针事件
           child: CustomPaint(
             // 自定义绘制
-            painter: _MouseTrailPainter(
-              // 绘制器
-              particles: _activeParticles, // 活跃粒子列表
-              animation: _animationController, // 动画控制器
-            ),
+            painter: _nativeSystem != null
+                ? _NativeMouseTrailPainter(
+                    system: _nativeSystem!,
+                    atlas: _nativeAtlas!,
+                    animation: _animationController,
+                  )
+                : _MouseTrailPainter(
+                    // 绘制器
+                    particles: _activeParticles, // 活跃粒子列表
+                    animation: _animationController, // 动画控制器
+                  ),
             size: Size.infinite, // 无限大小
           ),
         ),
@@ -350,3 +453,23 @@ class _MouseTrailPainter extends CustomPainter {
         particles.length != oldDelegate.particles.length; // 粒子数量不同
   }
 }
+
+/// `_NativeMouseTrailPainter` 类：绘制原生粒子池中的拖尾粒子。
+class _NativeMouseTrailPainter extends CustomPainter {
+  final NativeParticleSystem system; // 原生粒子池
+  final NativeParticleAtlas atlas; // 圆形精灵
+
+  _NativeMouseTrailPainter({
+    required this.system,
+    required this.atlas,
+    required Listenable animation,
+  }) : super(repaint: animation); // 监听动画，触发重绘
+
+  @override
+  void paint(Canvas canvas, Size size) => system.paint(canvas, atlas);
+
+  @override
+  bool shouldRepaint(_NativeMouseTrailPainter oldDelegate) {
+    return system != oldDelegate.system;
+  }
+}
\ No newline at end of file
@@ -1,11 +1,14 @@
 // lib/layouts/background/render_particle_effect.dart
 library;
 
+import 'dart:async';
 import 'dart:math' as math;
 import 'package:flutter/material.dart';
 import 'package:flutter/rendering.dart';
 import 'package:flutter/scheduler.dart';
 import 'package:suxingchahui/layouts/background/particle_effect.dart'; // 引入 Particle 和 ParticleShape
+import 'package:suxingchahui/windows/native/native_particle_system.dart'; // Windows 原生粒子模拟
+import 'package:suxingchahui/windows/native/render_budget_channel.dart'; // 窗口不可见或节电时降帧
 
 /// ParticleEffectRenderObjectWidget 是一个高性能的粒子效果组件。
 /// 它将所有动画和绘制逻辑封装在底层的 RenderObject 中，避免了 build 方法的开销。
@@ -47,6 +50,16 @@ class RenderParticleEffect extends RenderBox {
   ];
   Ticker? _ticker;
 
+  // Windows 上由原生侧模拟和生成绘制数组，其余平台使用上面的 Dart 实现
+  NativeParticleSystem? _nativeSystem;
+  NativeParticleAtlas? _nativeAtlas;
+  Duration? _lastElapsed; // 上一帧的 Ticker 时间，用于按实际间隔推进
+
+  // 原生侧给出的渲染预算：降帧时改用定时器驱动，暂停时不驱动
+  final ValueListenable<RenderBudgetLevel> _budget = RenderBudgetChannel.level;
+  Timer? _reducedTimer;
+  final Stopwatch _reducedClock = Stopwatch();
+
   RenderParticleEffect({
     required int particleCount,
     required bool isResizing,
@@ -60,6 +73,7 @@ class RenderParticleEffect extends RenderBox {
   set particleCount(int value) {
     if (_particleCount == value) return;
     _particleCount = value;
+    _disposeNative(); // 容量随数量变化
     // 粒子数量变化，需要重新初始化
     _initParticles();
   }
@@ -83,6 +97,7 @@ class RenderParticleEffect extends RenderBox {
   @override
   void attach(PipelineOwner owner) {
     super.attach(owner);
+    _budget.addListener(_onBudgetChanged);
     // 挂载时，如果不是在调整大小，就开始动画
     if (!_isResizing) {
       _startAnimation();
@@ -91,7 +106,9 @@ class RenderParticleEffect extends RenderBox {
 
   @override
   void detach() {
+    _budget.removeListener(_onBudgetChanged);
     _stopAnimation(); // 卸载时必须停止动画
+    _disposeNative();
     super.detach();
   }
 
@@ -108,6 +125,10 @@ class RenderParticleEffect extends RenderBox {
 
   void _initParticles() {
     if (size == Size.zero) return;
+    if (_initNativeParticles()) {
+      _startAnimation();
+      return;
+    }
     _particles.clear();
     final random = math.Random();
     for (int i = 0; i < _particleCount; i++) {
@@ -128,8 +149,75 @@ class RenderParticleEffect extends RenderBox {
     _startAnimation();
   }
 
+  /// 在 Windows 上用原生粒子池生成粒子，不可用时返回 false。
+  bool _initNativeParticles() {
+    if (!NativeParticleSystem.isSupported) return false;
+    if (_nativeSystem == null) {
+      _nativeSystem = NativeParticleSystem.create(math.max(_particleCount, 1));
+      if (_nativeSystem == null) return false;
+      _nativeAtlas = _buildShapeAtlas();
+      _nativeSystem!
+        ..setBehavior(const NativeParticleBehavior(
+          drag: 0.98,
+          jitter: 0.1,
+          spin: 0.02,
+          wrap: true,
+          riseMin: 0.3,
+          riseMax: 1.1,
+          sizeMin: 2,
+          sizeMax: 6,
+          opacityMin: 0.3,
+          opacityMax: 0.7,
+        ))
+        ..setPalette(_pastelColors)
+        ..setSprites(_nativeAtlas!);
+    }
+    _nativeSystem!
+      ..scatter(_particleCount, size)
+      ..step(0, size); // 只写出绘制数组
+    return true;
+  }
+
+  /// 用 [ParticlesPainter] 把每种形状画成白色精灵，下标与 [ParticleShape] 一致。
+  NativeParticleAtlas _buildShapeAtlas() {
+    return NativeParticleAtlas.build([
+      for (final shape in ParticleShape.values)
+        (canvas, radius) => ParticlesPainter([
+              Particle(
+                x: 0,
+                y: 0,
+                speed: 0,
+                size: radius,
+                opacity: 1,
+                shape: shape,
+                color: Colors.white,
+              ),
+            ]).paint(canvas, Size.zero),
+    ]);
+  }
+
+  void _disposeNative() {
+    _nativeSystem?.dispose();
+    _nativeSystem = null;
+    _nativeAtlas?.dispose();
+    _nativeAtlas = null;
+  }
+
   void _startAnimation() {
+    final level = _budget.value;
+    if (level == RenderBudgetLevel.paused) return;
+    if (level == RenderBudgetLevel.reduced) {
+      if (_reducedTimer != null) return;
+      _lastElapsed = null;
+      _reducedClock
+        ..reset()
+        ..start();
+      _reducedTimer = Timer.periodic(RenderBudgetChannel.reducedFrameInterval,
+          (_) => _tick(_reducedClock.elapsed));
+      return;
+    }
     if (_ticker != null && !_ticker!.isTicking) {
+      _lastElapsed = null; // Ticker 重新开始计时
       _ticker!.start();
     }
   }
@@ -138,10 +226,33 @@ class RenderParticleEffect extends RenderBox {
     if (_ticker != null && _ticker!.isTicking) {
       _ticker!.stop();
     }
+    _reducedTimer?.cancel();
+    _reducedTimer = null;
+    _reducedClock.stop();
+  }
+
+  /// 渲染预算变化时换用对应的驱动方式。
+  void _onBudgetChanged() {
+    _stopAnimation();
+    if (!_isResizing) {
+      _startAnimation();
+    }
   }
 
-  // Ticker 的每一帧都会调用这个方法
+  // Ticker 或降帧定时器的每一帧都会调用这个方法
   void _tick(Duration elapsed) {
+    final nativeSystem = _nativeSystem;
+    if (nativeSystem != null) {
+      final last = _lastElapsed ?? elapsed;
+      _lastElapsed = elapsed;
+      if (size == Size.zero) return;
+      // 原参数按 60fps 每帧设定，按实际间隔换算成帧数，高刷新率下速度不变
+      nativeSystem.step(
+          (elapsed - last).inMicroseconds / Duration.microsecondsPerSecond * 60,
+          size);
+      markNeedsPaint();
+      return;
+    }
     _updateParticles();
   }
 
@@ -181,7 +292,8 @@ class RenderParticleEffect extends RenderBox {
   @override
   void paint(PaintingContext context, Offset offset) {
     // 如果正在调整大小，或者没有粒子，就啥也不画
-    if (_isResizing || _particles.isEmpty) {
+    final nativeSystem = _nativeSystem;
+    if (_isResizing || (_particles.isEmpty && nativeSystem == null)) {
       return;
     }
 
@@ -189,6 +301,12 @@ class RenderParticleEffect extends RenderBox {
     canvas.save();
     canvas.translate(offset.dx, offset.dy);
 
+    if (nativeSystem != null) {
+      nativeSystem.paint(canvas, _nativeAtlas!);
+      canvas.restore();
+      return;
+    }
+
     // 把 ParticlesPainter 的绘制逻辑直接搬过来
     final painter = ParticlesPainter(_particles);
     painter.paint(canvas, size);
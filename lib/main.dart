@@ -4,14 +4,26 @@ import 'package:window_manager/window_manager.dart';
 import 'dart:io';
 import 'app.dart';
 import 'constants/global_constants.dart'; // 引入 GlobalConstants
+import 'windows/native/font_subset_channel.dart'; // 字体子集
+import 'windows/native/memory_telemetry_channel.dart'; // 内存采样
+import 'windows/native/startup_snapshot_channel.dart'; // 启动快照
+import 'windows/native/startup_trace_channel.dart'; // 启动时间线
 
 void main() async {
+  final mainStopwatch = Stopwatch()..start(); // Dart main 到首帧的耗时
   WidgetsFlutterBinding.ensureInitialized();
+  StartupTraceChannel.instant('dart_main');
+  MemoryTelemetryChannel.startImageCacheReporting();
+  // 尽早取回上次的首页快照，与窗口初始化并行
+  final snapshotLoad = StartupSnapshotChannel.load();
+  // 注册上次生成的字体子集，同样与窗口初始化并行
+  final fontSubsetLoad = FontSubsetChannel.loadCachedSubset();
 
   const platform =
       MethodChannel('com.example.suxingchahui/flutter_ready_signal');
 
   WidgetsBinding.instance.addPostFrameCallback((_) async {
+    StartupTraceChannel.addSpan('dart_main_to_first_frame', mainStopwatch.elapsed);
     try {
       if (Platform.isAndroid){
         await platform.invokeMethod('flutterFirstFrameReady');
@@ -23,7 +35,8 @@ void main() async {
   });
 
   if (Platform.isWindows || Platform.isMacOS || Platform.isLinux) {
-    await windowManager.ensureInitialized();
+    await StartupTraceChannel.trace(
+        'windowManager.ensureInitialized', windowManager.ensureInitialized);
 
     WindowOptions windowOptions = const WindowOptions(
       size: Size(1280, 720),
@@ -33,11 +46,16 @@ void main() async {
       titleBarStyle: TitleBarStyle.hidden,
     );
 
-    await windowManager.waitUntilReadyToShow(windowOptions, () async {
-      await windowManager.show();
-      await windowManager.focus();
-    });
+    await StartupTraceChannel.trace(
+        'windowManager.waitUntilReadyToShow',
+        () => windowManager.waitUntilReadyToShow(windowOptions, () async {
+              await windowManager.show();
+              await windowManager.focus();
+            }));
   }
 
+  await snapshotLoad;
+  await fontSubsetLoad;
   runApp(const App());
+  FontSubsetChannel.scheduleBuild();
 }
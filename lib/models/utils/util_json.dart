@@ -27,16 +27,16 @@ class UtilJson {
       return DateTime.fromMillisecondsSinceEpoch(dateValue.seconds * 1000,
           isUtc: true);
     }
-    try {
-      return DateTime.parse(dateValue.toString()).toLocal(); // 解析为本地时间
-    } catch (e) {
-      final millis = int.tryParse(dateValue.toString());
-      if (millis != null) {
-        return DateTime.fromMillisecondsSinceEpoch(millis, isUtc: true)
-            .toLocal(); // 解析毫秒为本地时间
-      }
-      return DateTime.fromMillisecondsSinceEpoch(0, isUtc: true); // 错误回退
+    // 列表接口的每条记录都会走到这里，用 tryParse 避免回退路径抛出异常
+    final text = dateValue.toString();
+    final parsed = DateTime.tryParse(text);
+    if (parsed != null) return parsed.toLocal(); // 解析为本地时间
+    final millis = int.tryParse(text);
+    if (millis != null) {
+      return DateTime.fromMillisecondsSinceEpoch(millis, isUtc: true)
+          .toLocal(); // 解析毫秒为本地时间
     }
+    return DateTime.fromMillisecondsSinceEpoch(0, isUtc: true); // 错误回退
   }
 
   // 安全解析可空 DateTime
@@ -2,12 +2,14 @@
 import 'package:flutter/material.dart';
 import 'package:provider/provider.dart';
 import 'package:flutter_cache_manager/flutter_cache_manager.dart';
+import 'package:suxingchahui/windows/native/native_cache_manager.dart';
 
 class CacheManagerProviderWidget extends StatefulWidget {
   final Widget child;
   final String cacheKey;
   final Duration stalePeriod;
   final int maxNrOfCacheObjects;
+  final int maxCacheBytes;
 
   const CacheManagerProviderWidget({
     super.key,
@@ -15,6 +17,7 @@ class CacheManagerProviderWidget extends StatefulWidget {
     this.cacheKey = 'globalAppCache', // 默认的缓存键
     this.stalePeriod = const Duration(days: 7),
     this.maxNrOfCacheObjects = 200, // 默认缓存对象数量
+    this.maxCacheBytes = 512 * 1024 * 1024, // 原生缓存的总字节上限
   });
 
   @override
@@ -29,14 +32,21 @@ class _CacheManagerProviderWidgetState
   @override
   void initState() {
     super.initState();
-    _cacheManager = CacheManager(
-      Config(
-        widget.cacheKey,
-        stalePeriod: widget.stalePeriod,
-        maxNrOfCacheObjects: widget.maxNrOfCacheObjects,
-        // 如果需要，这里可以暴露更多 Config 参数给 widget
-      ),
-    );
+    // Windows 上使用原生磁盘缓存（按字节数淘汰），其它平台或原生缓存
+    // 打开失败时回退到 flutter_cache_manager（按对象数量淘汰）
+    _cacheManager = NativeCacheManager.create(
+          widget.cacheKey,
+          stalePeriod: widget.stalePeriod,
+          maxCacheBytes: widget.maxCacheBytes,
+        ) ??
+        CacheManager(
+          Config(
+            widget.cacheKey,
+            stalePeriod: widget.stalePeriod,
+            maxNrOfCacheObjects: widget.maxNrOfCacheObjects,
+            // 如果需要，这里可以暴露更多 Config 参数给 widget
+          ),
+        );
   }
 
   @override
@@ -2,6 +2,7 @@
 import 'dart:async';
 import 'package:flutter/material.dart';
 import 'package:suxingchahui/utils/font/font_config.dart';
+import 'package:suxingchahui/windows/native/native_kv_store.dart'; // Windows 上保存主题设置
 
 
 /// 管理应用的主题，并提供主题变更的数据流。
@@ -9,6 +10,12 @@ class ThemeProvider {
   /// 初始主题模式。
   static const _initialThemeMode = ThemeMode.system;
 
+  /// 保存主题模式的键。
+  static const _themeModeKey = 'theme_mode';
+
+  /// 保存设置的原生存储，仅 Windows 上可用，其它平台为 null（不保存）。
+  final NativeKvStore? _settings = NativeKvStore.open('settings');
+
   /// 当前的主题模式。
   /// 用于为新的流监听者提供初始值。
   ThemeMode _currentThemeMode = _initialThemeMode;
@@ -31,6 +38,7 @@ class ThemeProvider {
     if (mode == _currentThemeMode) return;
 
     _currentThemeMode = mode;
+    _settings?.putJson(_themeModeKey, mode.name);
     _themeController.add(_currentThemeMode);
   }
 
@@ -43,10 +51,14 @@ class ThemeProvider {
 
   /// 加载主题模式。
   ///
-  /// 实际应用中，这里应从持久化存储（如 SharedPreferences）加载主题。
+  /// Windows 上从原生存储读取上次选择的主题，其它平台或没有保存过时使用初始值。
   void _loadThemeMode() {
-    // 此处仅设置初始值并推送到流中。
-    _themeController.add(_initialThemeMode);
+    final stored = _settings?.getJson(_themeModeKey);
+    _currentThemeMode = ThemeMode.values.firstWhere(
+      (mode) => mode.name == stored,
+      orElse: () => _initialThemeMode,
+    );
+    _themeController.add(_currentThemeMode);
   }
 
   // --- 主题数据定义 ---
@@ -2,10 +2,12 @@
 
 /// 该文件定义了 WindowStateProvider，管理窗口状态
 /// WindowStateProvider 跟踪窗口的拖拽和尺寸调整状态。
+/// Windows 上使用 runner 推送的准确开始/结束事件，其它桌面平台按窗口事件防抖。
 library;
 
 import 'dart:async'; // 异步编程所需
 import 'package:flutter/foundation.dart'; // 平台判断所需
+import 'package:suxingchahui/windows/native/window_resize_channel.dart'; // 原生尺寸调整事件
 import 'package:window_manager/window_manager.dart'; // 窗口管理库
 
 /// `WindowStateProvider` 类：管理窗口状态的 Provider。
@@ -17,6 +19,9 @@ class WindowStateProvider with WindowListener {
   static const Duration _resizeDebounceDuration =
       Duration(milliseconds: 300); // 尺寸调整防抖延迟
   bool _isDraggingTitleBar = false; // 标识标题栏是否正在被拖拽
+  bool _isNativeResizing = false; // 原生侧报告的尺寸调整状态
+  StreamSubscription<bool>?
+      _nativeResizeSubscription; // 原生尺寸调整事件的订阅，为 null 时使用防抖
 
   // --- Stream 控制器和 Stream ---
   final _isResizingWindowController =
@@ -42,9 +47,26 @@ class WindowStateProvider with WindowListener {
             defaultTargetPlatform == TargetPlatform.macOS)) {
       return;
     }
+    if (WindowResizeChannel.isSupported) {
+      _nativeResizeSubscription = WindowResizeChannel.events.listen(
+        _onNativeResize,
+        onError: (_) {
+          // 旧版本 runner 没有这个通道，退回防抖
+          _nativeResizeSubscription?.cancel();
+          _nativeResizeSubscription = null;
+        },
+      );
+    }
     windowManager.addListener(this); // 添加窗口事件监听器
   }
 
+  /// 原生侧报告尺寸调整开始或结束。
+  void _onNativeResize(bool isResizing) {
+    _isNativeResizing = isResizing;
+    _resizeEndTimer?.cancel(); // 不再需要防抖
+    _updateIsResizingWindowState(isResizing || _isDraggingTitleBar);
+  }
+
   /// 私有辅助方法：更新 `_isResizingWindow` 状态。
   ///
   /// [newValue]：新的窗口尺寸调整状态。
@@ -64,8 +86,12 @@ class WindowStateProvider with WindowListener {
 
   /// 结束窗口尺寸调整或标题栏拖拽的逻辑。
   ///
-  /// 启动防抖计时器，在延迟后将窗口调整尺寸状态设为 false。
+  /// 有原生事件时立即结束；否则启动防抖计时器，在延迟后将窗口调整尺寸状态设为 false。
   void _endResizingOrTitleBarDragging() {
+    if (_nativeResizeSubscription != null) {
+      _updateIsResizingWindowState(_isNativeResizing || _isDraggingTitleBar);
+      return;
+    }
     _resizeEndTimer = Timer(_resizeDebounceDuration, () {
       // 启动防抖计时器
       if (_isResizingWindow && !_isDraggingTitleBar) {
@@ -92,6 +118,7 @@ class WindowStateProvider with WindowListener {
   /// 窗口尺寸调整事件回调。
   @override
   void onWindowResize() {
+    if (_nativeResizeSubscription != null) return; // 由原生事件给出开始和结束
     _startResizingOrTitleBarDragging(); // 启动调整尺寸逻辑
     _endResizingOrTitleBarDragging(); // 结束调整尺寸逻辑
   }
@@ -147,6 +174,7 @@ class WindowStateProvider with WindowListener {
       windowManager.removeListener(this); // 移除窗口监听器
     }
     _resizeEndTimer?.cancel(); // 取消计时器
+    _nativeResizeSubscription?.cancel(); // 取消原生事件订阅
     _isResizingWindowController.close(); // 关闭 StreamController
   }
 }
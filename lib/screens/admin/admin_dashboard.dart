@@ -21,6 +21,8 @@ import 'package:suxingchahui/screens/admin/widgets/user_management.dart';
 import 'package:suxingchahui/screens/admin/widgets/ip_management.dart';
 import 'package:suxingchahui/screens/admin/widgets/maintenance_management.dart';
 import 'package:suxingchahui/screens/admin/widgets/announcement_management.dart'; // 导入公告管理组件
+import 'package:suxingchahui/screens/admin/widgets/memory_telemetry_panel.dart'; // 内存监控
+import 'package:suxingchahui/windows/native/memory_telemetry_channel.dart';
 import 'package:suxingchahui/widgets/ui/appbar/custom_app_bar.dart';
 
 class AdminDashboard extends StatefulWidget {
@@ -133,6 +135,8 @@ class _AdminDashboardState extends State<AdminDashboard> {
         IPManagement(
           inputStateService: widget.inputStateService,
         ),
+        // 内存监控只在有原生采样器的平台上显示
+        if (MemoryTelemetryChannel.isSupported) const MemoryTelemetryPanel(),
       ];
     }
 
@@ -176,6 +180,11 @@ class _AdminDashboardState extends State<AdminDashboard> {
           icon: Icon(Icons.security),
           label: 'IP管理',
         ),
+        if (MemoryTelemetryChannel.isSupported)
+          const NavigationDestination(
+            icon: Icon(Icons.memory),
+            label: '内存监控',
+          ),
       ];
     }
 
@@ -202,6 +211,8 @@ class _AdminDashboardState extends State<AdminDashboard> {
         return '系统维护';
       case 6:
         return 'IP管理';
+      case 7:
+        return '内存监控';
       default:
         return '管理面板';
     }
@@ -0,0 +1,309 @@
+// lib/screens/admin/widgets/memory_telemetry_panel.dart
+import 'dart:async';
+import 'dart:math' as math;
+import 'package:flutter/material.dart';
+import 'package:suxingchahui/widgets/ui/common/error_widget.dart';
+import 'package:suxingchahui/widgets/ui/common/loading_widget.dart';
+import 'package:suxingchahui/widgets/ui/snackBar/app_snack_bar.dart';
+import 'package:suxingchahui/windows/native/memory_telemetry_channel.dart';
+
+/// 内存监控：显示原生采样器记录的进程内存和各子系统计数器，可以导出 CSV。
+class MemoryTelemetryPanel extends StatefulWidget {
+  const MemoryTelemetryPanel({super.key});
+
+  @override
+  State<MemoryTelemetryPanel> createState() => _MemoryTelemetryPanelState();
+}
+
+class _MemoryTelemetryPanelState extends State<MemoryTelemetryPanel> {
+  static const Duration _pollInterval = Duration(seconds: 2);
+  static const List<Duration> _intervals = [
+    Duration(seconds: 1),
+    Duration(seconds: 5),
+    Duration(seconds: 10),
+    Duration(seconds: 60),
+  ];
+
+  MemoryTelemetryStatus? _status;
+  List<String> _labels = const [];
+  final List<MemoryTelemetryRow> _rows = [];
+  Timer? _pollTimer;
+  bool _isLoading = true;
+  bool _isProcessing = false;
+  String? _error;
+
+  @override
+  void initState() {
+    super.initState();
+    _refresh();
+    _pollTimer = Timer.periodic(_pollInterval, (_) => _poll());
+  }
+
+  @override
+  void dispose() {
+    _pollTimer?.cancel();
+    super.dispose();
+  }
+
+  Future<void> _refresh() async {
+    try {
+      final status = await MemoryTelemetryChannel.status();
+      _rows.clear();
+      if (!mounted) return;
+      setState(() {
+        _status = status;
+        _error = status == null ? '当前平台不支持内存监控' : null;
+      });
+      await _poll();
+    } catch (e) {
+      if (mounted) setState(() => _error = '加载失败: $e');
+    } finally {
+      if (mounted) setState(() => _isLoading = false);
+    }
+  }
+
+  /// 只取上次之后的新行。
+  Future<void> _poll() async {
+    final status = _status;
+    if (status == null) return;
+    try {
+      final series = await MemoryTelemetryChannel.series(
+          after: _rows.isEmpty ? 0 : _rows.last.sequence);
+      if (!mounted || series.rows.isEmpty) return;
+      setState(() {
+        _labels = series.labels;
+        _rows.addAll(series.rows);
+        if (_rows.length > status.capacity) {
+          _rows.removeRange(0, _rows.length - status.capacity);
+        }
+      });
+    } catch (_) {
+      // 下一次轮询再试
+    }
+  }
+
+  Future<void> _run(Future<void> Function() action) async {
+    if (_isProcessing) return;
+    setState(() => _isProcessing = true);
+    try {
+      await action();
+    } catch (e) {
+      AppSnackBar.showError('操作失败: $e');
+    } finally {
+      if (mounted) setState(() => _isProcessing = false);
+    }
+  }
+
+  Future<void> _setInterval(Duration interval) => _run(() async {
+        await MemoryTelemetryChannel.start(interval);
+        final status = await MemoryTelemetryChannel.status();
+        if (mounted) setState(() => _status = status);
+      });
+
+  Future<void> _toggleRunning() => _run(() async {
+        final status = _status;
+        if (status == null) return;
+        if (status.running) {
+          await MemoryTelemetryChannel.stop();
+        } else {
+          await MemoryTelemetryChannel.start(status.interval);
+        }
+        final updated = await MemoryTelemetryChannel.status();
+        if (mounted) setState(() => _status = updated);
+      });
+
+  Future<void> _sampleNow() => _run(() async {
+        await MemoryTelemetryChannel.sample();
+        await _poll();
+      });
+
+  Future<void> _dump() => _run(() async {
+        final path = await MemoryTelemetryChannel.dump();
+        if (path != null) AppSnackBar.showSuccess('已导出到 $path');
+      });
+
+  static String _formatBytes(int bytes) {
+    const units = ['B', 'KB', 'MB', 'GB'];
+    double value = bytes.toDouble();
+    int unit = 0;
+    while (value.abs() >= 1024 && unit < units.length - 1) {
+      value /= 1024;
+      unit++;
+    }
+    return '${value.toStringAsFixed(unit == 0 ? 0 : 1)} ${units[unit]}';
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    if (_isLoading) return const LoadingWidget();
+    if (_error != null) {
+      return CustomErrorWidget(errorMessage: _error!, onRetry: _refresh);
+    }
+    final status = _status!;
+    final latest = _rows.isEmpty ? null : _rows.last;
+
+    return ListView(
+      padding: const EdgeInsets.all(16),
+      children: [
+        Wrap(
+          spacing: 12,
+          runSpacing: 8,
+          crossAxisAlignment: WrapCrossAlignment.center,
+          children: [
+            DropdownButton<Duration>(
+              value: _intervals.contains(status.interval)
+                  ? status.interval
+                  : null,
+              hint: Text('${status.interval.inMilliseconds} ms'),
+              items: [
+                for (final interval in _intervals)
+                  DropdownMenuItem(
+                    value: interval,
+                    child: Text('每 ${interval.inSeconds} 秒'),
+                  ),
+              ],
+              onChanged: _isProcessing
+                  ? null
+                  : (value) {
+                      if (value != null) _setInterval(value);
+                    },
+            ),
+            ElevatedButton.icon(
+              onPressed: _isProcessing ? null : _toggleRunning,
+              icon: Icon(status.running ? Icons.pause : Icons.play_arrow),
+              label: Text(status.running ? '暂停采样' : '开始采样'),
+            ),
+            OutlinedButton.icon(
+              onPressed: _isProcessing ? null : _sampleNow,
+              icon: const Icon(Icons.camera),
+              label: const Text('立即采样'),
+            ),
+            OutlinedButton.icon(
+              onPressed: _isProcessing ? null : _dump,
+              icon: const Icon(Icons.save_alt),
+              label: const Text('导出 CSV'),
+            ),
+            Text('已记录 ${_rows.length} / ${status.capacity} 行'),
+          ],
+        ),
+        const SizedBox(height: 16),
+        SizedBox(
+          height: 220,
+          child: CustomPaint(
+            painter: _SeriesPainter(_rows, Theme.of(context).colorScheme),
+          ),
+        ),
+        const SizedBox(height: 8),
+        const Wrap(
+          spacing: 16,
+          children: [
+            _Legend(color: Colors.blue, label: '工作集'),
+            _Legend(color: Colors.orange, label: '私有字节'),
+          ],
+        ),
+        const SizedBox(height: 16),
+        if (latest != null)
+          Card(
+            child: Column(
+              children: [
+                ListTile(
+                  title: const Text('最近一次采样'),
+                  subtitle: Text(latest.time.toLocal().toString()),
+                ),
+                _row('工作集', _formatBytes(latest.workingSet)),
+                _row('私有字节', _formatBytes(latest.privateBytes)),
+                _row('已提交', _formatBytes(latest.commit)),
+                _row('句柄', '${latest.handles}'),
+                for (int i = 0; i < _labels.length; i++)
+                  _row(
+                    _labels[i],
+                    i < latest.counters.length
+                        ? _formatBytes(latest.counters[i])
+                        : '-',
+                  ),
+              ],
+            ),
+          ),
+      ],
+    );
+  }
+
+  Widget _row(String label, String value) {
+    return ListTile(
+      dense: true,
+      title: Text(label),
+      trailing: Text(value),
+    );
+  }
+}
+
+class _Legend extends StatelessWidget {
+  final Color color;
+  final String label;
+
+  const _Legend({required this.color, required this.label});
+
+  @override
+  Widget build(BuildContext context) {
+    return Row(
+      mainAxisSize: MainAxisSize.min,
+      children: [
+        Container(width: 12, height: 12, color: color),
+        const SizedBox(width: 4),
+        Text(label),
+      ],
+    );
+  }
+}
+
+/// 工作集和私有字节随时间的折线。
+class _SeriesPainter extends CustomPainter {
+  final List<MemoryTelemetryRow> rows;
+  final ColorScheme colors;
+  final int _lastSequence; // 有新行时重绘
+
+  _SeriesPainter(this.rows, this.colors)
+      : _lastSequence = rows.isEmpty ? 0 : rows.last.sequence;
+
+  @override
+  void paint(Canvas canvas, Size size) {
+    canvas.drawRect(
+      Offset.zero & size,
+      Paint()
+        ..color = colors.outlineVariant
+        ..style = PaintingStyle.stroke,
+    );
+    if (rows.length < 2) return;
+    int maxBytes = 1;
+    for (final row in rows) {
+      maxBytes = math.max(maxBytes, math.max(row.workingSet, row.privateBytes));
+    }
+    final first = rows.first.time.millisecondsSinceEpoch;
+    final span = math.max(1, rows.last.time.millisecondsSinceEpoch - first);
+
+    Path line(int Function(MemoryTelemetryRow row) value) {
+      final path = Path();
+      for (int i = 0; i < rows.length; i++) {
+        final x =
+            (rows[i].time.millisecondsSinceEpoch - first) / span * size.width;
+        final y = size.height - value(rows[i]) / maxBytes * size.height;
+        i == 0 ? path.moveTo(x, y) : path.lineTo(x, y);
+      }
+      return path;
+    }
+
+    final stroke = Paint()
+      ..style = PaintingStyle.stroke
+      ..strokeWidth = 1.5;
+    canvas.drawPath(
+        line((row) => row.workingSet), stroke..color = Colors.blue);
+    canvas.drawPath(
+        line((row) => row.privateBytes), stroke..color = Colors.orange);
+  }
+
+  @override
+  bool shouldRepaint(_SeriesPainter oldDelegate) =>
+      oldDelegate.rows != rows ||
+      oldDelegate._lastSequence != _lastSequence ||
+      oldDelegate.colors != colors;
+}
@@ -41,6 +41,7 @@ import 'package:suxingchahui/widgets/components/screen/game/section/tag/mobile_t
 import 'package:suxingchahui/widgets/ui/buttons/functional_button.dart'; // 导入功能按钮
 import 'package:suxingchahui/widgets/ui/snackBar/app_snack_bar.dart'; // 导入应用 SnackBar 工具
 import 'package:visibility_detector/visibility_detector.dart'; // 导入可见性检测器
+import 'package:suxingchahui/windows/native/native_game_store.dart'; // 导入本地游戏列式存储
 import 'package:suxingchahui/widgets/components/screen/game/panel/game_left_panel.dart'; // 导入游戏左侧面板
 import 'package:suxingchahui/widgets/components/screen/game/panel/game_right_panel.dart'; // 导入游戏右侧面板
 
@@ -448,11 +449,26 @@ class _GamesListScreenState extends State<GamesListScreen>
 
     _isInitialized = true; // 标记为已初始化
 
+    // 本地已知的游戏先给出这一页，服务器结果回来后替换
+    final localPage = forceRefresh
+        ? null
+        : NativeGameStore.query(
+            category: _currentCategory,
+            tag: _currentCategory == null ? _currentTag : null,
+            sortBy: _currentSortBy,
+            descending: _isDescending,
+            page: targetPage,
+            pageSize: _pageSize,
+          );
+
     setState(() {
       _isLoadingGameData = true; // 设置加载状态
       _lastLoadingGameTime = DateTime.now();
       _errorMessage = null; // 清空错误消息
-      if (isRefresh || isInitialLoad) {
+      if (localPage != null) {
+        _gamesList = localPage.games;
+        _currentPage = targetPage;
+      } else if (isRefresh || isInitialLoad) {
         // 刷新或初始加载时清空游戏列表
         _gamesList = [];
       }
@@ -491,6 +507,7 @@ class _GamesListScreenState extends State<GamesListScreen>
       if (!mounted) return; // 组件未挂载时返回
 
       final games = result.games; // 获取游戏列表
+      NativeGameStore.putAll(games); // 记入本地存储，供之后的筛选和翻页使用
       final pagination = result.pagination; // 获取分页信息
       final int serverPage = pagination.page; // 服务器返回的页码
       final int serverPageSize = pagination.limit;
@@ -510,7 +527,8 @@ class _GamesListScreenState extends State<GamesListScreen>
       if (mounted) {
         setState(() {
           _errorMessage = '加载失败，请稍后重试。'; // 设置错误消息
-          if (isRefresh || isInitialLoad) {
+          // 离线时保留本地给出的这一页
+          if (localPage == null && (isRefresh || isInitialLoad)) {
             // 刷新或初始加载时清空列表和重置分页
             _gamesList = [];
             _currentPage = 1;
@@ -1045,6 +1063,7 @@ class _GamesListScreenState extends State<GamesListScreen>
         // 确认删除回调
         try {
           await widget.gameService.deleteGame(game); // 调用删除游戏服务
+          NativeGameStore.remove(game.id); // 从本地存储中移除
           if (!mounted) return; // 组件未挂载时返回
           AppSnackBar.showSuccess("成功删除游戏"); // 提示删除成功
           await _loadGames(isRefresh: true);
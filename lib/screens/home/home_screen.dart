@@ -29,6 +29,7 @@ import 'package:suxingchahui/widgets/components/screen/home/section/home_latest_
 import 'package:suxingchahui/widgets/components/screen/home/section/home_banner.dart'; // 导入首页 Banner 组件
 import 'package:suxingchahui/services/main/game/game_service.dart'; // 导入游戏服务
 import 'package:suxingchahui/widgets/ui/common/loading_widget.dart'; // 导入加载组件
+import 'package:suxingchahui/windows/native/startup_snapshot_channel.dart'; // 导入启动快照
 
 /// `HomeScreen` 类：应用主页屏幕组件。
 ///
@@ -81,6 +82,7 @@ class _HomeScreenState extends State<HomeScreen> with WidgetsBindingObserver {
   String? _overallErrorMessage; // 整体页面框架的错误消息
 
   bool _hasPlayedEntryAnimation = false; // 用于首次进入动画的控制标记
+  bool _hasSnapshotContent = false; // 正在显示上次退出时的快照
 
   bool _isPerformingHomeScreenRefresh = false; // 正在执行主页刷新操作标记
   DateTime? _lastHomeScreenRefreshAttemptTime; // 上次尝试主页刷新的时间
@@ -134,6 +136,7 @@ class _HomeScreenState extends State<HomeScreen> with WidgetsBindingObserver {
     WidgetsBinding.instance.addObserver(this); // 添加应用生命周期观察者
     _hotGamesPageController = PageController(); // 初始化 PageController
     _bannerImage = GlobalConstants.bannerImageFirst;
+    _applyStartupSnapshot(); // 先显示上次的内容
   }
 
   @override
@@ -261,6 +264,58 @@ class _HomeScreenState extends State<HomeScreen> with WidgetsBindingObserver {
     }
   }
 
+  /// 用上次退出时的启动快照填充各板块。
+  ///
+  /// 快照属于其他账号时不使用。网络数据到达后会替换这里的内容。
+  void _applyStartupSnapshot() {
+    final snapshot = StartupSnapshotChannel.snapshot;
+    if (snapshot == null) return;
+    final session = snapshot.json(StartupSnapshotChannel.sessionSection);
+    final snapshotUserId = session is Map ? session['userId'] : null;
+    if (snapshotUserId != widget.authProvider.currentUserId) return;
+
+    try {
+      final hotGames = snapshot.json(StartupSnapshotChannel.hotGamesSection);
+      final latestGames =
+          snapshot.json(StartupSnapshotChannel.latestGamesSection);
+      final hotPosts = snapshot.json(StartupSnapshotChannel.hotPostsSection);
+      if (hotGames != null) _hotGamesData = Game.fromListJson(hotGames);
+      if (latestGames != null) {
+        _latestGamesData = Game.fromListJson(latestGames);
+      }
+      if (hotPosts != null) _hotPostsData = Post.fromListJson(hotPosts);
+    } catch (e) {
+      // 快照与当前模型不兼容时当作没有快照
+      _hotGamesData = null;
+      _latestGamesData = null;
+      _hotPostsData = null;
+    }
+    _hasSnapshotContent = _hotGamesData != null ||
+        _latestGamesData != null ||
+        _hotPostsData != null;
+  }
+
+  /// 把板块的最新数据写入启动快照，供下次启动时首帧显示。
+  void _saveStartupSnapshot(HomeDataType type, dynamic data) {
+    if (data is! List) return;
+    String section;
+    switch (type) {
+      case HomeDataType.hotGames:
+        section = StartupSnapshotChannel.hotGamesSection;
+        break;
+      case HomeDataType.latestGames:
+        section = StartupSnapshotChannel.latestGamesSection;
+        break;
+      case HomeDataType.hotPosts:
+        section = StartupSnapshotChannel.hotPostsSection;
+        break;
+    }
+    StartupSnapshotChannel.put(
+        section, data.map((item) => item.toJson()).toList());
+    StartupSnapshotChannel.put(StartupSnapshotChannel.sessionSection,
+        {'userId': widget.authProvider.currentUserId});
+  }
+
   /// 处理可见性变化。
   ///
   /// [visibilityInfo]：可见性信息。
@@ -486,6 +541,7 @@ class _HomeScreenState extends State<HomeScreen> with WidgetsBindingObserver {
           if (mounted) setState(() => _hotPostsData = data); // 更新热门帖子数据
           break;
       }
+      _saveStartupSnapshot(type, data); // 更新启动快照
     } catch (e) {
       if (mounted) {
         // 捕获错误时
@@ -766,6 +822,7 @@ class _HomeScreenState extends State<HomeScreen> with WidgetsBindingObserver {
   /// 构建 Scaffold 内容。
   Widget _buildScaffoldContent() {
     if (!_isOverallInitialized &&
+        !_hasSnapshotContent &&
         (_isHotGamesLoading ||
             _isLatestGamesLoading ||
             _isHotPostsLoading ||
@@ -784,7 +841,9 @@ class _HomeScreenState extends State<HomeScreen> with WidgetsBindingObserver {
       );
     }
 
-    if (_overallErrorMessage != null && !_isOverallInitialized) {
+    if (_overallErrorMessage != null &&
+        !_isOverallInitialized &&
+        !_hasSnapshotContent) {
       // 整体加载错误时显示错误组件
       return Scaffold(
         body: CustomErrorWidget(
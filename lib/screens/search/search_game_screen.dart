@@ -2,6 +2,7 @@
 import 'package:flutter/material.dart';
 import 'package:suxingchahui/models/game/game/game.dart';
 import 'package:suxingchahui/models/game/game/game_list_pagination.dart';
+import 'package:suxingchahui/models/common/pagination.dart';
 import 'package:suxingchahui/providers/windows/window_state_provider.dart';
 import 'package:suxingchahui/services/main/user/cache/search_history_cache_service.dart';
 import 'package:suxingchahui/widgets/ui/animation/animated_list_view.dart';
@@ -18,6 +19,22 @@ import 'package:suxingchahui/widgets/ui/common/loading_widget.dart';
 import 'package:suxingchahui/widgets/ui/components/game/common_game_card.dart';
 import 'package:suxingchahui/widgets/ui/dart/lazy_layout_builder.dart';
 
+// 本地索引
+import 'package:suxingchahui/windows/native/native_search_index.dart';
+
+/// 搜索到的游戏，进程内共享。新的查询先在这里找，不用等服务器。
+final NativeSearchCorpus<Game> _localGames = NativeSearchCorpus<Game>(
+  'games',
+  idOf: (game) => game.id,
+  fieldsOf: (game) => [
+    NativeSearchField(game.title, weight: 3.0),
+    NativeSearchField(game.tags.join(' '), weight: 2.0),
+    NativeSearchField(game.category, weight: 1.5),
+    NativeSearchField(game.summary),
+    NativeSearchField(game.description, weight: 0.5),
+  ],
+);
+
 class SearchGameScreen extends StatefulWidget {
   final GameService gameService;
   final SearchHistoryCacheService searchHistoryCacheService;
@@ -149,6 +166,13 @@ class _SearchGameScreenState extends State<SearchGameScreen> {
       return;
     }
 
+    // 先显示本地索引的结果，服务器结果回来后再合并
+    final localGames = _localGames.search(trimmedQuery, limit: 20);
+    setState(() {
+      _error = null;
+      _searchResults = localGames.isEmpty ? null : _localPage(localGames);
+    });
+
     // 防抖
     _debounceTimer = Timer(Duration(milliseconds: 500), () async {
       if (!mounted) return;
@@ -156,8 +180,8 @@ class _SearchGameScreenState extends State<SearchGameScreen> {
       setState(() {
         _error = null;
         if (isRefresh || _currentPage == 1) {
-          _isSearching = true; // 首次搜索或刷新时显示主加载
-          _searchResults = null; // 刷新时清空旧数据
+          // 没有本地结果时才显示主加载
+          _isSearching = localGames.isEmpty;
         } else {
           // 这种情况理论上不会发生，因为这是首次搜索的逻辑
         }
@@ -172,8 +196,9 @@ class _SearchGameScreenState extends State<SearchGameScreen> {
         );
         if (!mounted) return;
 
+        _localGames.putAll(results.games);
         setState(() {
-          _searchResults = results;
+          _searchResults = _mergeLocalGames(results, localGames);
           // _isSearching 会在 finally 中处理
         });
 
@@ -184,7 +209,8 @@ class _SearchGameScreenState extends State<SearchGameScreen> {
         if (!mounted) return;
         setState(() {
           _error = '搜索失败，请稍后重试';
-          _searchResults = null;
+          // 离线时保留本地结果
+          _searchResults = localGames.isEmpty ? null : _localPage(localGames);
         });
       } finally {
         if (mounted) {
@@ -211,10 +237,16 @@ class _SearchGameScreenState extends State<SearchGameScreen> {
       );
       if (!mounted) return;
 
+      _localGames.putAll(results.games);
       setState(() {
         if (_searchResults != null) {
+          // 第一页合并进来的本地结果可能出现在后面的页中
+          final shownIds = _searchResults!.games.map((g) => g.id).toSet();
           _searchResults = _searchResults!.copyWith(
-            games: [..._searchResults!.games, ...results.games],
+            games: [
+              ..._searchResults!.games,
+              ...results.games.where((g) => !shownIds.contains(g.id)),
+            ],
             pagination: results.pagination, // 更新分页信息
           );
         } else {
@@ -235,6 +267,25 @@ class _SearchGameScreenState extends State<SearchGameScreen> {
     }
   }
 
+  /// 只有本地结果时的单页列表。
+  GameListPagination _localPage(List<Game> games) {
+    return GameListPagination(
+      games: games,
+      pagination: PaginationData.fromItemList(games, 1, pageSize: games.length),
+    );
+  }
+
+  /// 服务器结果在前，后面接上服务器没有返回的本地结果。
+  GameListPagination _mergeLocalGames(
+      GameListPagination results, List<Game> localGames) {
+    if (localGames.isEmpty) return results;
+    final serverIds = results.games.map((g) => g.id).toSet();
+    final localOnly =
+        localGames.where((g) => !serverIds.contains(g.id)).toList();
+    if (localOnly.isEmpty) return results;
+    return results.copyWith(games: [...results.games, ...localOnly]);
+  }
+
   bool _hasMoreResults() {
     return _searchResults?.pagination.hasNextPage() ?? false;
   }
@@ -25,6 +25,20 @@ import 'package:suxingchahui/widgets/ui/common/loading_widget.dart';
 import 'package:suxingchahui/widgets/components/screen/forum/card/base_post_card.dart';
 import 'package:suxingchahui/widgets/ui/dart/lazy_layout_builder.dart';
 
+// 本地索引
+import 'package:suxingchahui/windows/native/native_search_index.dart';
+
+/// 搜索到的帖子，进程内共享。新的查询先在这里找，不用等服务器。
+final NativeSearchCorpus<Post> _localPosts = NativeSearchCorpus<Post>(
+  'posts',
+  idOf: (post) => post.id,
+  fieldsOf: (post) => [
+    NativeSearchField(post.title, weight: 3.0),
+    NativeSearchField(post.tags.join(' '), weight: 2.0),
+    NativeSearchField(post.content),
+  ],
+);
+
 class SearchPostScreen extends StatefulWidget {
   final SearchHistoryCacheService searchHistoryCacheService;
   final PostService postService;
@@ -181,6 +195,18 @@ class _SearchPostScreenState extends State<SearchPostScreen> {
   // --- 核心搜索逻辑 ---
   Future<void> _performSearch(String query, {bool isNewSearch = true}) async {
     _debounceTimer?.cancel();
+
+    // 新搜索先显示本地索引的结果，服务器结果回来后再合并
+    final List<Post> localPosts = isNewSearch
+        ? _localPosts.search(query.trim(), limit: _limit)
+        : const [];
+    if (isNewSearch && query.trim().isNotEmpty) {
+      setState(() {
+        _searchResults = [...localPosts];
+        _error = null;
+      });
+    }
+
     _debounceTimer = Timer(Duration(milliseconds: 500), () async {
       final trimmedQuery = query.trim();
       if (!mounted) return;
@@ -202,7 +228,7 @@ class _SearchPostScreenState extends State<SearchPostScreen> {
       if (isNewSearch) {
         // 新搜索：显示 _isSearching 的加载，重置所有相关状态
         setState(() {
-          _searchResults.clear();
+          _searchResults = [...localPosts];
           _currentPage = 1;
           _totalPages = 1;
           _error = null;
@@ -228,12 +254,21 @@ class _SearchPostScreenState extends State<SearchPostScreen> {
         final List<Post> newPosts = resultsData.posts;
         final pagination = resultsData.pagination;
         final int serverTotalPages = pagination.pages;
+        _localPosts.putAll(newPosts);
 
         setState(() {
           if (isNewSearch) {
-            _searchResults = newPosts;
+            // 服务器结果在前，后面接上服务器没有返回的本地结果
+            final serverIds = newPosts.map((p) => p.id).toSet();
+            _searchResults = [
+              ...newPosts,
+              ...localPosts.where((p) => !serverIds.contains(p.id)),
+            ];
           } else {
-            _searchResults.addAll(newPosts);
+            // 第一页合并进来的本地结果可能出现在后面的页中
+            final shownIds = _searchResults.map((p) => p.id).toSet();
+            _searchResults
+                .addAll(newPosts.where((p) => !shownIds.contains(p.id)));
           }
           _totalPages = serverTotalPages;
           _error = null; // 清除错误
@@ -249,6 +284,11 @@ class _SearchPostScreenState extends State<SearchPostScreen> {
         // print("SearchPostScreen: Search failed: $e\n$s");
         if (!mounted) return;
         setState(() {
+          if (isNewSearch && localPosts.isNotEmpty) {
+            // 离线时保留本地结果，不显示全屏错误
+            _searchResults = [...localPosts];
+            return;
+          }
           _error = '搜索失败：$e'; // 设置错误信息
           if (isNewSearch) {
             _searchResults.clear();
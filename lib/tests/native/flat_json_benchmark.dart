@@ -0,0 +1,121 @@
+// lib/tests/native/flat_json_benchmark.dart
+
+/// 对比 [NativeFlatJson.decode] 与 `jsonDecode` 的耗时和生成的 Dart 对象数。
+/// 需要 runner.exe 导出的原生符号，只能作为应用入口在 Windows 上运行：
+///
+///   flutter run --profile -d windows -t lib/tests/native/flat_json_benchmark.dart
+///
+/// 每种规模分别测两种读取方式：卡片列表只读 id 和 title，完整遍历读取
+/// 每个字段。对象数统计解码和读取过程中生成的 Map、List、String 和 double，
+/// `jsonDecode` 在解码时就生成了整棵树，扁平视图只生成被读到的部分。
+library;
+
+import 'dart:convert'; // jsonDecode、UTF-8
+import 'dart:typed_data'; // Uint8List
+import 'package:flutter/foundation.dart'; // debugPrint
+
+import 'package:suxingchahui/windows/native/native_flat_json.dart';
+
+/// 与 runner_core/bench/flat_json_bench.cpp 中相同结构的游戏列表。
+Uint8List _gameListJson(int count) {
+  final games = List.generate(
+      count,
+      (i) => {
+            'id': '65f0c1a2b3c4d5e6f7a8${1000 + i}',
+            'title': '塞尔达传说 旷野之息',
+            'category': 'action',
+            'tags': ['开放世界', '冒险'],
+            'rating': 4.5,
+            'viewCount': i * 37,
+            'summary': '「广阔世界」 line\nbreak',
+            'published': true,
+          });
+  return utf8.encode(jsonEncode({'games': games}));
+}
+
+int _objects = 0; // 读取过程中取得的堆对象数
+
+/// 记录并返回 [value]；小整数、布尔和 null 不分配对象。
+dynamic _touch(dynamic value) {
+  if (value is Map || value is List || value is String || value is double) {
+    _objects++;
+  }
+  return value;
+}
+
+/// `jsonDecode` 生成的对象总数。
+int _countTree(dynamic value) {
+  if (value is Map) {
+    return 1 +
+        value.length +
+        value.values.fold<int>(0, (sum, v) => sum + _countTree(v));
+  }
+  if (value is List) {
+    return 1 + value.fold<int>(0, (sum, v) => sum + _countTree(v));
+  }
+  return value is String || value is double ? 1 : 0;
+}
+
+void _readCards(dynamic root) {
+  final games = _touch((root as Map)['games']) as List;
+  for (final game in games) {
+    final map = _touch(game) as Map;
+    _touch(map['id']);
+    _touch(map['title']);
+  }
+}
+
+void _readAll(dynamic value) {
+  if (value is Map) {
+    for (final key in value.keys) {
+      _touch(key);
+      _readAll(_touch(value[key]));
+    }
+  } else if (value is List) {
+    for (final element in value) {
+      _readAll(_touch(element));
+    }
+  }
+}
+
+/// 运行 [body] 直到超过 200 ms，返回平均每次的微秒数。
+double _measure(void Function() body) {
+  for (int i = 0; i < 3; i++) {
+    body();
+  }
+  final stopwatch = Stopwatch()..start();
+  int runs = 0;
+  while (stopwatch.elapsedMilliseconds < 200) {
+    body();
+    runs++;
+  }
+  return stopwatch.elapsedMicroseconds / runs;
+}
+
+void main() {
+  if (NativeFlatJson.parse(Uint8List.fromList(utf8.encode('[]'))) == null) {
+    debugPrint('原生解码不可用，需要在 Windows 上以应用入口运行');
+    return;
+  }
+  for (final count in [20, 1000, 20000]) {
+    final bytes = _gameListJson(count);
+    // jsonDecode 在解码时就生成了整棵树，与读取方式无关
+    final treeObjects = _countTree(jsonDecode(utf8.decode(bytes)));
+    for (final read in [_readCards, _readAll]) {
+      final name = read == _readCards ? 'cards' : 'all';
+      final dartMicros =
+          _measure(() => read(jsonDecode(utf8.decode(bytes))));
+      final nativeMicros = _measure(() => read(NativeFlatJson.decode(bytes)));
+
+      _objects = 0;
+      read(NativeFlatJson.decode(bytes));
+      final nativeObjects = _objects;
+
+      debugPrint('games=$count read=$name bytes=${bytes.length} '
+          'jsonDecode=${dartMicros.toStringAsFixed(1)}us '
+          'objects=$treeObjects | '
+          'NativeFlatJson=${nativeMicros.toStringAsFixed(1)}us '
+          'objects=$nativeObjects');
+    }
+  }
+}
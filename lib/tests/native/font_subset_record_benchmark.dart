@@ -0,0 +1,85 @@
+// lib/tests/native/font_subset_record_benchmark.dart
+
+/// 测量 [FontSubsetChannel.record] 给 AppText.build 增加的开销：模拟一帧里
+/// 重建首页的全部文本，对比不记录、逐字符记录（87d8796 的做法）和现在只
+/// 入队的做法。只在 Windows 上记录，需要作为应用入口运行：
+///
+///   flutter run --profile -d windows -t lib/tests/native/font_subset_record_benchmark.dart
+library;
+
+import 'package:flutter/foundation.dart'; // debugPrint
+
+import 'package:suxingchahui/windows/native/font_subset_channel.dart';
+
+/// 首页一帧里的文本：游戏卡片的标题、分类和标签，以及导航和按钮文字。
+List<String> _frameTexts(int cards) {
+  final texts = <String>['首页', '游戏', '帖子', '活动', '我的', '查看更多'];
+  for (int i = 0; i < cards; i++) {
+    texts
+      ..add('塞尔达传说 旷野之息 第$i部')
+      ..add('动作冒险')
+      ..add('开放世界')
+      ..add('${i * 37} 浏览');
+  }
+  return texts;
+}
+
+/// 87d8796 里 record 的做法：每次调用都逐字符查表。
+final Set<int> _eagerSeen = <int>{};
+final StringBuffer _eagerPending = StringBuffer();
+
+void _recordEagerly(String text) {
+  for (final rune in text.runes) {
+    if (rune < 0x80 || !_eagerSeen.add(rune)) continue;
+    _eagerPending.writeCharCode(rune);
+  }
+}
+
+/// 运行 [body] 直到超过 200 ms，返回平均每次的微秒数。
+double _measure(void Function() body) {
+  for (int i = 0; i < 3; i++) {
+    body();
+  }
+  final stopwatch = Stopwatch()..start();
+  int runs = 0;
+  while (stopwatch.elapsedMilliseconds < 200) {
+    body();
+    runs++;
+  }
+  return stopwatch.elapsedMicroseconds / runs;
+}
+
+int _sink = 0;
+
+void main() {
+  if (!FontSubsetChannel.isSupported) {
+    debugPrint('只在 Windows 上记录，需要在 Windows 上以应用入口运行');
+    return;
+  }
+  for (final cards in [20, 200]) {
+    final texts = _frameTexts(cards);
+    // 基线只读取文本长度，相当于 build 里其余的工作不变
+    final baseline = _measure(() {
+      for (final text in texts) {
+        _sink += text.length;
+      }
+    });
+    final eager = _measure(() {
+      for (final text in texts) {
+        _sink += text.length;
+        _recordEagerly(text);
+      }
+    });
+    final queued = _measure(() {
+      for (final text in texts) {
+        _sink += text.length;
+        FontSubsetChannel.record(text);
+      }
+    });
+    debugPrint('texts=${texts.length} '
+        'baseline=${baseline.toStringAsFixed(2)}us '
+        'eager=${eager.toStringAsFixed(2)}us '
+        'queued=${queued.toStringAsFixed(2)}us per frame');
+  }
+  debugPrint('$_sink');
+}
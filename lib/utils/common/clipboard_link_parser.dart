@@ -6,8 +6,9 @@
 library;
 
 import 'package:flutter/services.dart';
-import 'package:mongo_dart/mongo_dart.dart' as mongo;
 import 'package:suxingchahui/models/game/game/game_download_link.dart';
+import 'package:suxingchahui/windows/native/native_download_channel.dart';
+import 'package:suxingchahui/windows/native/native_object_id.dart';
 
 /// [ClipboardLinkParser] 类：一个用于从剪贴板解析下载链接的工具类。
 class ClipboardLinkParser {
@@ -37,6 +38,10 @@ class ClipboardLinkParser {
       } else if (line.contains('提取码：')) {
         description =
             '${description ?? ''}${description != null && description.isNotEmpty ? '; ' : ''}提取码：${line.replaceAll('提取码：', '').trim()}';
+      } else if (NativeDownloadChannel.extractSha256(line) case final sha256?) {
+        // 校验值写进描述，原生下载完成后按它校验
+        description =
+            '${description ?? ''}${description != null && description.isNotEmpty ? '; ' : ''}SHA256：$sha256';
       } else if (title == null &&
           line.isNotEmpty &&
           !line.contains('http') &&
@@ -47,7 +52,7 @@ class ClipboardLinkParser {
 
     if (title != null && url != null) {
       final newLink = GameDownloadLink(
-        id: mongo.ObjectId().oid,
+        id: NativeObjectIdTable.generateHex(),
         userId: currentUserId,
         title: title,
         url: url,
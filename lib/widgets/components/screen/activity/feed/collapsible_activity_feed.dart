@@ -2,6 +2,7 @@
 
 /// 该文件定义了 CollapsibleActivityFeed 组件，一个可折叠的用户活动动态列表。
 /// CollapsibleActivityFeed 根据指定模式分组和显示用户活动，并支持折叠/展开。
+/// 排序、去重和分组由 NativeFeedMerger 增量维护，列表变化时只改动变化的条目和分组。
 library;
 
 import 'dart:async'; // 导入异步操作所需
@@ -28,6 +29,7 @@ import 'package:suxingchahui/widgets/ui/animation/animated_feed_item.dart'; // 
 import 'package:suxingchahui/widgets/ui/badges/user_info_badge.dart'; // 导入用户信息徽章
 import 'package:suxingchahui/widgets/ui/common/loading_widget.dart'; // 导入加载组件
 import 'package:suxingchahui/widgets/ui/dart/color_extensions.dart'; // 导入颜色扩展工具
+import 'package:suxingchahui/windows/native/native_feed_merger.dart'; // 导入时间线合并
 
 /// `CollapsibleActivityFeed` 类：可折叠的用户活动动态列表组件。
 ///
@@ -124,6 +126,18 @@ class _CollapsibleActivityFeedState extends State<CollapsibleActivityFeed>
     with SingleTickerProviderStateMixin {
   final Map<String, bool> _expandedGroups = {}; // 存储分组的展开状态
   late AnimationController _animationController; // 动画控制器
+  final NativeFeedMerger<Activity> _feed = NativeFeedMerger<Activity>(
+    idOf: (activity) => activity.id,
+    userOf: (activity) => activity.userId,
+    typeOf: (activity) => activity.type,
+    timeOf: (activity) => activity.createTime,
+    versionOf: (activity) => Object.hash(
+        activity.updateTime,
+        activity.likesCount,
+        activity.commentsCount,
+        activity.isLiked,
+        activity.comments.length), // 点赞、评论变化时刷新对应条目
+  ); // 去重排序后的时间线和分组
 
   User? _currentUser; // 当前用户
 
@@ -132,6 +146,7 @@ class _CollapsibleActivityFeedState extends State<CollapsibleActivityFeed>
     super.initState();
     _animationController = AnimationController(
         duration: const Duration(milliseconds: 300), vsync: this); // 初始化动画控制器
+    _feed.replace(widget.activities); // 建立时间线和分组
     _initExpandedGroups(); // 初始化分组展开状态
   }
 
@@ -144,15 +159,18 @@ class _CollapsibleActivityFeedState extends State<CollapsibleActivityFeed>
   @override
   void dispose() {
     _animationController.dispose(); // 销毁动画控制器
+    _feed.dispose(); // 释放时间线
     super.dispose();
   }
 
   @override
   void didUpdateWidget(CollapsibleActivityFeed oldWidget) {
     super.didUpdateWidget(oldWidget);
+    // 列表可能被原地修改，每次都同步，只应用差异
+    final listChanged = _feed.replace(widget.activities);
     if (oldWidget.collapseMode != widget.collapseMode ||
-        _listPossiblyChanged(oldWidget.activities, widget.activities)) {
-      // 折叠模式或列表变化时
+        (listChanged && _expandedGroups.isEmpty)) {
+      // 折叠模式变化或第一次有内容时
       _initExpandedGroups(); // 重新初始化分组展开状态
     }
     if (_currentUser != widget.currentUser) {
@@ -163,50 +181,23 @@ class _CollapsibleActivityFeedState extends State<CollapsibleActivityFeed>
     }
   }
 
-  /// 判断列表是否可能发生变化。
-  ///
-  /// [a]：旧列表。
-  /// [b]：新列表。
-  /// 返回 true 表示列表可能发生变化，否则返回 false。
-  bool _listPossiblyChanged(List<Activity> a, List<Activity> b) {
-    if (a.length != b.length) return true; // 长度不同则变化
-    if (a.isEmpty) return false; // 均为空则无变化
-    return a.first.id != b.first.id; // 首项ID不同则变化
-  }
-
   /// 初始化分组展开状态。
   ///
   /// 清空现有状态，并根据折叠模式默认展开第一个分组。
+  /// 之后新出现的分组默认收起，已有分组保持用户选择的状态。
   void _initExpandedGroups() {
     _expandedGroups.clear(); // 清空展开状态
     if (widget.collapseMode.isAll) return; // 不折叠模式时返回
-    final groups = _getGroupedActivities(); // 获取分组活动
-    if (groups.isNotEmpty) {
-      final firstKey = groups.keys.first; // 第一个分组的键
-      _expandedGroups[firstKey] = true; // 默认展开第一个分组
-      groups.keys
-          .where((key) => key != firstKey)
-          .forEach((key) => _expandedGroups[key] = false); // 其他分组收起
+    final keys = _feed.groupKeys(_grouping); // 分组键，最新的在前
+    for (int i = 0; i < keys.length; i++) {
+      _expandedGroups[keys[i]] = i == 0; // 默认展开第一个分组，其他分组收起
     }
   }
 
-  /// 获取分组后的活动列表。
-  ///
-  /// 根据折叠模式按用户或按类型分组活动。
-  Map<String, List<Activity>> _getGroupedActivities() {
-    if (widget.collapseMode.isAll) {
-      // 不折叠模式时返回所有活动在一个组中
-      return {EnrichCollapseMode.all: widget.activities};
-    }
-    final Map<String, List<Activity>> grouped = {}; // 分组 Map
-    for (final activity in widget.activities) {
-      String key = (widget.collapseMode.isByUser)
-          ? (activity.userId)
-          : activity.type; // 根据模式获取分组键
-      grouped.putIfAbsent(key, () => []).add(activity); // 添加活动到对应分组
-    }
-    return grouped;
-  }
+  /// 当前折叠模式对应的分组方式。
+  NativeFeedGrouping get _grouping => widget.collapseMode.isByUser
+      ? NativeFeedGrouping.byUser
+      : NativeFeedGrouping.byType;
 
   /// 获取分组图标。
   ///
@@ -253,32 +244,30 @@ class _CollapsibleActivityFeedState extends State<CollapsibleActivityFeed>
           onRefresh: widget.onRefresh);
     }
 
-    final groupedActivities = _getGroupedActivities(); // 获取分组活动
     return RefreshIndicator(
       onRefresh: widget.onRefresh, // 刷新回调
       child: widget.collapseMode.isAll // 根据折叠模式构建不同 UI
           ? _buildStandardFeed()
-          : _buildCollapsibleFeed(groupedActivities),
+          : _buildCollapsibleFeed(),
     );
   }
 
   /// 构建标准动态流。
   ///
-  /// 显示所有活动，不进行分组折叠。
+  /// 显示所有活动（按时间倒序、已去重），不进行分组折叠。
   Widget _buildStandardFeed() {
     return ListView.builder(
       controller: widget.scrollController, // 滚动控制器
       padding: const EdgeInsets.symmetric(vertical: 8, horizontal: 8), // 内边距
-      itemCount:
-          widget.activities.length + (widget.isLoadingMore ? 1 : 0), // 项数量
+      itemCount: _feed.length + (widget.isLoadingMore ? 1 : 0), // 项数量
       itemBuilder: (context, index) {
-        if (index == widget.activities.length) {
+        if (index == _feed.length) {
           // 最后一项且正在加载更多时显示加载指示器
           return const LoadingWidget(
             size: 24,
           );
         }
-        final activity = widget.activities[index]; // 当前活动
+        final activity = _feed[index]; // 当前活动
         final bool isAlternate =
             widget.useAlternatingLayout && index % 2 == 1; // 是否交替布局
 
@@ -320,22 +309,22 @@ class _CollapsibleActivityFeedState extends State<CollapsibleActivityFeed>
 
   /// 构建可折叠动态流。
   ///
-  /// [groupedActivities]：分组后的活动列表。
   /// 显示分组后的活动，并支持折叠/展开。
-  Widget _buildCollapsibleFeed(Map<String, List<Activity>> groupedActivities) {
+  Widget _buildCollapsibleFeed() {
+    final grouping = _grouping; // 分组方式
+    final groupKeys = _feed.groupKeys(grouping); // 分组键，最新的在前
     return ListView.builder(
       controller: widget.scrollController, // 滚动控制器
       padding: const EdgeInsets.symmetric(vertical: 8), // 内边距
-      itemCount:
-          groupedActivities.length + (widget.isLoadingMore ? 1 : 0), // 项数量
+      itemCount: groupKeys.length + (widget.isLoadingMore ? 1 : 0), // 项数量
       itemBuilder: (context, index) {
-        if (index == groupedActivities.length) {
+        if (index == groupKeys.length) {
           // 最后一项且正在加载更多时显示加载指示器
           return const LoadingWidget();
         }
 
-        final groupKey = groupedActivities.keys.elementAt(index); // 分组键
-        final activities = groupedActivities[groupKey]!; // 分组活动
+        final groupKey = groupKeys[index]; // 分组键
+        final activities = _feed.groupMembers(grouping, groupKey); // 分组活动
         final isExpanded = _expandedGroups[groupKey] ?? false; // 是否展开
         return _buildCollapsibleGroup(
             groupKey, activities, isExpanded, index); // 构建可折叠分组
@@ -175,7 +175,7 @@ class BaseGameCard extends StatelessWidget {
                   SafeCachedImage(
                     imageUrl: game.coverImage, // 封面图 URL
                     fit: BoxFit.cover, // 填充模式
-                    memCacheWidth: DeviceUtils.isDesktop ? 320 : 240, // 内存缓存宽度
+                    useThumbnail: true, // 按卡片实际宽度加载缩略图
                   ),
                   Positioned(
                     top: 0, // 顶部偏移
@@ -297,7 +297,7 @@ class BaseGameCard extends StatelessWidget {
           SafeCachedImage(
             imageUrl: game.coverImage, // 封面图 URL
             fit: BoxFit.cover, // 填充模式
-            memCacheWidth: isDesktop ? 240 : 200, // 内存缓存宽度
+            useThumbnail: true, // 按封面实际宽度加载缩略图
             backgroundColor: Colors.grey[200], // 背景色
           ),
           Positioned(
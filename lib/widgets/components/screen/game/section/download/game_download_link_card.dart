@@ -3,6 +3,7 @@
 import 'package:flutter/material.dart';
 import 'package:flutter/services.dart';
 import 'package:suxingchahui/models/game/game/game_download_link.dart';
+import 'package:suxingchahui/widgets/components/screen/game/section/download/native_download_button.dart';
 import 'package:suxingchahui/widgets/ui/buttons/url/open_url_button.dart';
 import 'package:suxingchahui/widgets/ui/snackBar/app_snack_bar.dart';
 
@@ -46,6 +47,7 @@ class GameDownLoadLinkCard extends StatelessWidget {
         trailing: Row(
           mainAxisSize: MainAxisSize.min, // 行主轴尺寸最小化
           children: [
+            NativeDownloadButton(link: link), // 原生分段下载
             OpenUrlButton(
               url: link.url, // URL
               webViewTitle: link.title, // WebView 标题
@@ -0,0 +1,197 @@
+// lib/widgets/components/screen/game/section/download/native_download_button.dart
+
+/// 该文件定义了 NativeDownloadButton 组件，用原生分段下载器下载游戏直链。
+/// 点击后先探测链接：文件直链开始下载并显示进度，再次点击暂停或继续；
+/// 网盘分享页等不能直接下载的链接提示在浏览器中打开。
+library;
+
+import 'dart:async'; // StreamSubscription
+
+import 'package:flutter/material.dart';
+import 'package:flutter/services.dart'; // PlatformException
+import 'package:suxingchahui/models/game/game/game_download_link.dart';
+import 'package:suxingchahui/widgets/ui/snackBar/app_snack_bar.dart';
+import 'package:suxingchahui/windows/native/native_download_channel.dart';
+
+/// `NativeDownloadButton` 类：下载链接卡片上的原生下载按钮。
+///
+/// 仅在支持原生下载的平台上显示。
+class NativeDownloadButton extends StatefulWidget {
+  final GameDownloadLink link; // 下载链接
+
+  const NativeDownloadButton({
+    super.key,
+    required this.link,
+  });
+
+  @override
+  State<NativeDownloadButton> createState() => _NativeDownloadButtonState();
+}
+
+class _NativeDownloadButtonState extends State<NativeDownloadButton> {
+  StreamSubscription<NativeDownloadEvent>? _subscription; // 进度订阅
+  NativeDownloadEvent? _event; // 最近的进度或结果
+  bool _probing = false; // 正在探测链接
+  String? _fileName; // 探测得到的文件名，继续下载时复用
+  String? _path; // 目标路径
+
+  @override
+  void initState() {
+    super.initState();
+    if (NativeDownloadChannel.isSupported) {
+      _subscription = NativeDownloadChannel.events
+          .where((event) => event.id == widget.link.id)
+          .listen(_onEvent, onError: (Object _) {
+        // 旧版本 runner 没有这个通道，按钮仍可发起下载
+      });
+    }
+  }
+
+  @override
+  void dispose() {
+    _subscription?.cancel(); // 下载在原生侧继续，不随组件销毁
+    super.dispose();
+  }
+
+  void _onEvent(NativeDownloadEvent event) {
+    if (!mounted) return;
+    setState(() {
+      _event = event;
+      _path = event.path ?? _path;
+    });
+    switch (event.state) {
+      case NativeDownloadState.completed:
+        AppSnackBar.showSuccess('下载完成：${event.path ?? ''}');
+        break;
+      case NativeDownloadState.failed:
+        AppSnackBar.showError(event.checksumMismatch
+            ? '文件校验失败（SHA-256 不一致），已删除'
+            : '下载失败：${event.error ?? '未知错误'}');
+        break;
+      default:
+        break;
+    }
+  }
+
+  bool get _running => _event?.state == NativeDownloadState.running;
+
+  bool get _paused => _event?.state == NativeDownloadState.paused;
+
+  Future<void> _onPressed() async {
+    if (_running) {
+      await NativeDownloadChannel.pause(widget.link.id);
+      return;
+    }
+    if (_event?.state == NativeDownloadState.completed) {
+      AppSnackBar.showInfo('已下载到：${_path ?? ''}');
+      return;
+    }
+    try {
+      if (_fileName == null) {
+        setState(() => _probing = true);
+        final probe = await NativeDownloadChannel.probe(widget.link.url);
+        if (!probe.isDirectFile) {
+          AppSnackBar.showInfo('该链接不是文件直链，请在浏览器中打开');
+          return;
+        }
+        _fileName =
+            probe.fileName.isNotEmpty ? probe.fileName : widget.link.title;
+      }
+      final path = await NativeDownloadChannel.start(
+        id: widget.link.id,
+        url: widget.link.url,
+        fileName: _fileName!,
+        sha256: NativeDownloadChannel.extractSha256(widget.link.description),
+      );
+      if (!mounted) return;
+      setState(() => _path = path);
+    } on PlatformException catch (e) {
+      AppSnackBar.showError('无法下载：${e.message ?? e.code}');
+    } finally {
+      if (mounted && _probing) setState(() => _probing = false);
+    }
+  }
+
+  Future<void> _onCancel() async {
+    await NativeDownloadChannel.cancel(widget.link.id, path: _path);
+    if (!mounted) return;
+    if (_paused) {
+      // 暂停的下载没有工作线程，不会再收到事件
+      setState(() => _event = null);
+    }
+  }
+
+  /// 按钮提示：下载中显示进度和速度。
+  String _tooltip() {
+    final event = _event;
+    if (event == null) return '直接下载';
+    final fraction = event.fraction;
+    final percent =
+        fraction != null ? '${(fraction * 100).toStringAsFixed(1)}%' : '';
+    final speed = '${(event.bytesPerSecond / (1024 * 1024)).toStringAsFixed(1)}'
+        ' MB/s';
+    switch (event.state) {
+      case NativeDownloadState.running:
+        return '下载中 $percent $speed（${event.connections} 条连接），点击暂停';
+      case NativeDownloadState.paused:
+        return '已暂停 $percent，点击继续';
+      case NativeDownloadState.completed:
+        return '已下载';
+      case NativeDownloadState.cancelled:
+      case NativeDownloadState.failed:
+        return '重新下载';
+    }
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    if (!NativeDownloadChannel.isSupported) return const SizedBox.shrink();
+
+    final Widget icon;
+    if (_probing) {
+      icon = const SizedBox(
+        width: 20,
+        height: 20,
+        child: CircularProgressIndicator(strokeWidth: 2),
+      );
+    } else if (_running) {
+      icon = SizedBox(
+        width: 22,
+        height: 22,
+        child: Stack(
+          alignment: Alignment.center,
+          children: [
+            CircularProgressIndicator(
+                value: _event?.fraction, strokeWidth: 2.5), // 进度环
+            const Icon(Icons.pause, size: 14),
+          ],
+        ),
+      );
+    } else if (_paused) {
+      icon = const Icon(Icons.play_circle_outline);
+    } else if (_event?.state == NativeDownloadState.completed) {
+      icon = const Icon(Icons.download_done);
+    } else {
+      icon = const Icon(Icons.download);
+    }
+
+    return Row(
+      mainAxisSize: MainAxisSize.min,
+      children: [
+        IconButton(
+          icon: icon,
+          tooltip: _tooltip(),
+          color: Colors.blue,
+          onPressed: _probing ? null : _onPressed,
+        ),
+        if (_running || _paused)
+          IconButton(
+            icon: const Icon(Icons.close),
+            tooltip: '取消下载',
+            color: Colors.grey[700],
+            onPressed: _onCancel,
+          ),
+      ],
+    );
+  }
+}
@@ -8,6 +8,7 @@ import 'package:suxingchahui/widgets/ui/dart/color_extensions.dart';
 import 'package:suxingchahui/widgets/ui/text/app_text.dart';
 import 'package:suxingchahui/widgets/ui/text/app_text_type.dart';
 import 'package:suxingchahui/utils/device/device_utils.dart'; // 引入 DeviceUtils
+import 'package:suxingchahui/windows/native/render_budget_channel.dart'; // 窗口不可见时暂停 GIF
 import 'package:suxingchahui/windows/ui/windows_controls.dart'; // 引入 WindowsControls
 import 'package:window_manager/window_manager.dart'; // 引入 window_manager
 import 'dart:math';
@@ -144,9 +145,17 @@ class _InitializationScreenState extends State<InitializationScreen> {
                   SizedBox(
                     width: logoSize,
                     height: logoSize,
-                    child: Image.asset(
-                      _logoGifFile,
-                      fit: BoxFit.contain, // 保持比例
+                    // 窗口不可见时 GIF 停在当前帧
+                    child: ValueListenableBuilder<RenderBudgetLevel>(
+                      valueListenable: RenderBudgetChannel.level,
+                      builder: (context, level, child) => TickerMode(
+                        enabled: level != RenderBudgetLevel.paused,
+                        child: child!,
+                      ),
+                      child: Image.asset(
+                        _logoGifFile,
+                        fit: BoxFit.contain, // 保持比例
+                      ),
                     ),
                   ),
                   const SizedBox(height: 40), // Logo 和下方内容的间距
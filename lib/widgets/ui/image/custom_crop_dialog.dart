@@ -17,6 +17,7 @@ import 'package:suxingchahui/widgets/ui/dart/color_extensions.dart'; // 颜色
 import 'package:suxingchahui/widgets/ui/dialogs/base_input_dialog.dart';
 import 'package:suxingchahui/widgets/ui/image/hand_drawn_crop_widget.dart';
 import 'package:suxingchahui/widgets/ui/snackBar/app_snack_bar.dart'; // 应用 SnackBar 工具
+import 'package:suxingchahui/windows/native/native_image_pipeline.dart'; // 原生图片管线
 import 'package:vector_math/vector_math_64.dart' show Vector3; // 向量数学库
 import 'package:suxingchahui/widgets/ui/buttons/functional_button.dart'; // 功能按钮组件
 import 'package:path/path.dart' as p; // 路径处理库
@@ -91,9 +92,9 @@ class _CustomCropDialogContentState extends State<CustomCropDialogContent> {
   final TransformationController _transformationController =
       TransformationController(); // 交互式视图的变换控制器
 
-  Uint8List? _originalImageBytes; // 原始图片字节数据
-  ui.Image? _decodedUiImage; // 用于显示和获取原始尺寸的 dart:ui Image
+  ui.Image? _decodedUiImage; // 用于显示和计算裁剪区域的 dart:ui Image
   img.Image? _decodedImageForProcessing; // 用于实际裁剪和编码的 image 库 Image
+  NativeImageSession? _nativeSession; // Windows 上由原生管线解码的原图
 
   bool _isLoadingImage = false; // 图片是否正在加载中
   bool _isProcessingConfirm = false; // 确认裁剪是否正在处理中
@@ -106,6 +107,9 @@ class _CustomCropDialogContentState extends State<CustomCropDialogContent> {
 
   String? _originalFileExtension; // 原始文件的扩展名
 
+  /// 原生管线生成预览时的输出尺寸，预览头像直径的两倍，高分屏上也足够清晰。
+  static const int _previewOutputSize = 240;
+
   @override
   void initState() {
     super.initState();
@@ -117,6 +121,7 @@ class _CustomCropDialogContentState extends State<CustomCropDialogContent> {
     _transformationController.removeListener(_onInteractionUpdate); // 移除监听器
     _transformationController.dispose(); // 销毁控制器
     _debounceTimer?.cancel(); // 取消计时器
+    _nativeSession?.close(); // 释放原生侧的原图
     super.dispose();
   }
 
@@ -124,21 +129,21 @@ class _CustomCropDialogContentState extends State<CustomCropDialogContent> {
   ///
   /// 从相册选择一张图片，并解码处理。
   Future<void> _pickImage() async {
+    final NativeImageSession? oldSession = _nativeSession;
     setState(() {
       _isLoadingImage = true; // 设置加载状态
-      _originalImageBytes = null; // 清空旧数据
-      _croppedPreviewBytes = null;
+      _croppedPreviewBytes = null; // 清空旧数据
       _decodedUiImage = null;
       _decodedImageForProcessing = null;
+      _nativeSession = null;
       _originalFileExtension = null;
       _transformationController.value = Matrix4.identity(); // 重置变换
     });
+    oldSession?.close(); // 界面不再引用旧预览图后再释放
     try {
       final XFile? pickedFile =
           await _picker.pickImage(source: ImageSource.gallery); // 调起图片选择器
       if (pickedFile != null && mounted) {
-        final bytes = await pickedFile.readAsBytes(); // 读取图片字节
-
         String extension =
             p.extension(pickedFile.path).toLowerCase(); // 获取文件扩展名
         if (extension == ".jpeg") {
@@ -153,26 +158,41 @@ class _CustomCropDialogContentState extends State<CustomCropDialogContent> {
             extension = '.png';
           }
         }
-        _originalFileExtension = (extension == ".jpg" || extension == ".png")
-            ? extension
-            : ".png"; // 存储有效扩展名
 
-        _decodedImageForProcessing = img.decodeImage(bytes); // 解码图片用于处理
-        if (_decodedImageForProcessing == null) {
-          throw Exception("无法解码图片格式，请重新换一张图片"); // 解码失败抛出异常
+        if (NativeImagePipeline.isSupported && pickedFile.path.isNotEmpty) {
+          // 原生后台线程解码，只取回缩小后的预览图
+          final session = await NativeImagePipeline.open(path: pickedFile.path);
+          if (!mounted) {
+            session.close();
+            return;
+          }
+          if (extension.isEmpty) {
+            extension = session.format == 'jpeg' ? '.jpg' : '.png';
+          }
+          _nativeSession = session;
+          _decodedUiImage = session.preview;
+        } else {
+          final bytes = await pickedFile.readAsBytes(); // 读取图片字节
+          _decodedImageForProcessing = img.decodeImage(bytes); // 解码图片用于处理
+          if (_decodedImageForProcessing == null) {
+            throw Exception("无法解码图片格式，请重新换一张图片"); // 解码失败抛出异常
+          }
+
+          final Completer<ui.Image> completerUi = Completer(); // 创建 Completer
+          ui.decodeImageFromList(bytes, (ui.Image decodedImg) {
+            if (!completerUi.isCompleted) {
+              completerUi.complete(decodedImg); // 解码 UI Image
+            }
+          });
+          _decodedUiImage = await completerUi.future; // 获取 UI Image
         }
 
-        final Completer<ui.Image> completerUi = Completer(); // 创建 Completer
-        ui.decodeImageFromList(bytes, (ui.Image decodedImg) {
-          if (!completerUi.isCompleted) {
-            completerUi.complete(decodedImg); // 解码 UI Image
-          }
-        });
-        _decodedUiImage = await completerUi.future; // 获取 UI Image
+        _originalFileExtension = (extension == ".jpg" || extension == ".png")
+            ? extension
+            : ".png"; // 存储有效扩展名
 
         if (mounted) {
           setState(() {
-            _originalImageBytes = bytes; // 存储原始字节
             _isLoadingImage = false; // 取消加载状态
             WidgetsBinding.instance.addPostFrameCallback((_) {
               if (mounted) _setInitialTransformation(); // 设置初始变换
@@ -232,7 +252,7 @@ class _CustomCropDialogContentState extends State<CustomCropDialogContent> {
   ///
   /// 使用防抖机制，避免频繁更新预览。
   void _schedulePreviewUpdate() {
-    if (_decodedImageForProcessing == null || _isLoadingImage || !mounted) {
+    if (!_hasSourceImage || _isLoadingImage || !mounted) {
       return; // 不满足条件时返回
     }
     _debounceTimer?.cancel(); // 取消现有计时器
@@ -245,11 +265,10 @@ class _CustomCropDialogContentState extends State<CustomCropDialogContent> {
   ///
   /// 执行实际裁剪操作以生成预览图。
   Future<void> _updatePreview() async {
-    if (_decodedImageForProcessing == null || !mounted) return; // 不满足条件时返回
+    if (!_hasSourceImage || !mounted) return; // 不满足条件时返回
     if (mounted) setState(() => _isPreviewLoading = true); // 设置预览加载状态
 
-    final result =
-        await Future(() => _performActualCrop(forPreview: true)); // 执行裁剪生成预览
+    final result = await _performCrop(forPreview: true); // 执行裁剪生成预览
     if (mounted) {
       setState(() {
         _croppedPreviewBytes = result?.bytes; // 更新预览字节
@@ -319,6 +338,45 @@ class _CustomCropDialogContentState extends State<CustomCropDialogContent> {
     return imageRect;
   }
 
+  /// 是否已经有可供裁剪的原图（原生会话或 image 库解码结果）。
+  bool get _hasSourceImage =>
+      _nativeSession != null || _decodedImageForProcessing != null;
+
+  /// 裁剪图片，Windows 上交给原生管线，其它平台使用 image 库。
+  ///
+  /// [forPreview]：是否为预览裁剪。预览只需要小图，原生管线按
+  /// [_previewOutputSize] 输出 PNG。
+  Future<CropResult?> _performCrop({required bool forPreview}) async {
+    final NativeImageSession? session = _nativeSession;
+    if (session == null) {
+      return Future(() => _performActualCrop(forPreview: forPreview));
+    }
+
+    final Rect cropRect = _calculateCropRect(); // 预览图坐标下的裁剪矩形
+    if (cropRect.isEmpty) return null;
+    final double previewWidth = session.preview.width.toDouble();
+    final double previewHeight = session.preview.height.toDouble();
+    final Rect region = Rect.fromLTRB(
+        cropRect.left / previewWidth,
+        cropRect.top / previewHeight,
+        cropRect.right / previewWidth,
+        cropRect.bottom / previewHeight); // 换算为原图宽高的比例
+
+    final String outputExtension =
+        forPreview ? ".png" : (_originalFileExtension ?? ".png");
+    try {
+      final bytes = await session.crop(
+        region,
+        maxOutputSize: forPreview ? _previewOutputSize : null,
+        format: outputExtension == ".jpg" ? 'jpeg' : 'png',
+      );
+      if (bytes.isEmpty) return null;
+      return CropResult(bytes: bytes, outputExtension: outputExtension);
+    } catch (_) {
+      return null; // 原生裁剪失败时按裁剪失败处理
+    }
+  }
+
   /// 执行实际的图片裁剪操作。
   ///
   /// [forPreview]：是否为预览裁剪。
@@ -396,14 +454,14 @@ class _CustomCropDialogContentState extends State<CustomCropDialogContent> {
   ///
   /// 执行最终裁剪并返回结果。
   void _confirmCrop() async {
-    if (_isProcessingConfirm || _decodedImageForProcessing == null) {
+    if (_isProcessingConfirm || !_hasSourceImage) {
       return; // 正在处理或未解码图片时返回
     }
 
     setState(() => _isProcessingConfirm = true); // 设置处理状态
 
     final CropResult? finalResult =
-        await Future(() => _performActualCrop(forPreview: false)); // 执行最终裁剪
+        await _performCrop(forPreview: false); // 执行最终裁剪
 
     if (mounted) {
       // 检查组件是否挂载
@@ -484,8 +542,7 @@ class _CustomCropDialogContentState extends State<CustomCropDialogContent> {
                         Widget content;
                         if (_isLoadingImage) {
                           content = const LoadingWidget(size: 24);
-                        } else if (_originalImageBytes == null ||
-                            _decodedUiImage == null) {
+                        } else if (_decodedUiImage == null) {
                           content = Center(
                             child: FunctionalButton(
                               icon: Icons.upload_file,
@@ -617,14 +674,13 @@ class _CustomCropDialogContentState extends State<CustomCropDialogContent> {
 
   // 在 _CustomCropDialogContentState 类里，加这个新方法
   Future<void> _debugDecodeImage() async {
-    if (_isProcessingConfirm || _decodedImageForProcessing == null) {
+    if (_isProcessingConfirm || !_hasSourceImage) {
       AppSnackBar.showWarning("正在处理或无图片，无法测试");
       return;
     }
 
     // 1. 生成最终要上传的图片数据
-    final CropResult? finalResult =
-        await Future(() => _performActualCrop(forPreview: false));
+    final CropResult? finalResult = await _performCrop(forPreview: false);
 
     if (finalResult == null || finalResult.bytes.isEmpty) {
       AppSnackBar.showError("生成最终图片失败！");
@@ -11,6 +11,7 @@ import 'package:suxingchahui/constants/global_constants.dart';
 import 'package:suxingchahui/utils/network/url_utils.dart'; // URL 工具类
 import 'package:suxingchahui/widgets/ui/common/loading_widget.dart';
 import 'package:suxingchahui/widgets/ui/image/images_preview_screen.dart'; // 引入图片预览屏幕
+import 'package:suxingchahui/windows/native/native_thumbnail_image.dart'; // 原生缩略图
 import 'package:visibility_detector/visibility_detector.dart'; // 可见性检测库
 import 'package:flutter_cache_manager/flutter_cache_manager.dart'; // 缓存管理库
 import 'package:provider/provider.dart'; // Provider 状态管理库
@@ -35,6 +36,7 @@ class SafeCachedImage extends StatefulWidget {
   final Alignment alignment; // 图片对齐方式
   final bool allowPreview; // 是否允许点击打开图片预览
   final bool allowDownloadInPreview; // 在预览中是否允许下载
+  final bool useThumbnail; // 是否按显示宽度加载缩略图（列表、网格中的封面）
 
   const SafeCachedImage({
     super.key,
@@ -54,6 +56,7 @@ class SafeCachedImage extends StatefulWidget {
     this.alignment = Alignment.center,
     this.allowPreview = false, // 默认不允许预览
     this.allowDownloadInPreview = true, // 预览时默认允许下载
+    this.useThumbnail = false,
   });
 
   @override
@@ -70,6 +73,7 @@ class _SafeCachedImageState extends State<SafeCachedImage> {
   late final Key _visibilityDetectorKey; // 可见性检测器的唯一键
   late final BaseCacheManager _cacheManager; // 缓存管理器实例
   bool _hasInitializedDependencies = false; // 依赖初始化标记
+  NativeThumbnailImage? _thumbnailImage; // 当前使用的原生缩略图
 
   @override
   void initState() {
@@ -115,6 +119,12 @@ class _SafeCachedImageState extends State<SafeCachedImage> {
   }
 
   void _tryEvictImage() {
+    final thumbnailImage = _thumbnailImage;
+    if (thumbnailImage != null) {
+      // 缩略图只释放内存中的位图，磁盘上的变体留给下次滚动回来时使用
+      thumbnailImage.evict().catchError((_) => false);
+      return;
+    }
     _cacheManager.removeFile(widget.imageUrl).catchError((_) {});
   }
 
@@ -167,6 +177,77 @@ class _SafeCachedImageState extends State<SafeCachedImage> {
     widget.onTap?.call();
   }
 
+  /// 按显示宽度加载缩略图。
+  ///
+  /// 宽度取 [SafeCachedImage.width]，未指定时取布局约束的宽度，再乘以设备像素比
+  /// 并向上取整到 [NativeThumbnailImage.widths] 中的档位。Windows 上由原生
+  /// 缩略图服务提供像素，其它平台按同样的档位设置 memCacheWidth。
+  Widget _buildThumbnail(BuildContext context, String safeUrl) {
+    final dpr = MediaQuery.of(context).devicePixelRatio;
+    return LayoutBuilder(
+      builder: (context, constraints) {
+        final double logicalWidth = widget.width ??
+            (constraints.hasBoundedWidth
+                ? constraints.maxWidth
+                : NativeThumbnailImage.widths.last / dpr);
+        final int thumbnailWidth =
+            NativeThumbnailImage.widthFor(logicalWidth * dpr);
+
+        if (!NativeThumbnailImage.isSupported) {
+          _thumbnailImage = null;
+          return _buildNetworkImage(safeUrl, thumbnailWidth, null);
+        }
+
+        final thumbnailImage = NativeThumbnailImage(
+          safeUrl,
+          width: thumbnailWidth,
+          cacheManager: _cacheManager,
+        );
+        _thumbnailImage = thumbnailImage;
+        return Image(
+          image: thumbnailImage,
+          width: widget.width,
+          height: widget.height,
+          fit: widget.fit,
+          alignment: widget.alignment,
+          gaplessPlayback: true,
+          frameBuilder: (context, child, frame, wasSynchronouslyLoaded) {
+            if (wasSynchronouslyLoaded) return child;
+            return AnimatedSwitcher(
+              duration: const Duration(milliseconds: 150),
+              child: frame == null ? _buildPlaceholder(context) : child,
+            );
+          },
+          errorBuilder: (context, error, stackTrace) {
+            widget.onError?.call(safeUrl, error);
+            return _buildErrorWidget(context);
+          },
+        );
+      },
+    );
+  }
+
+  Widget _buildNetworkImage(
+      String safeUrl, int? memCacheWidth, int? memCacheHeight) {
+    return CachedNetworkImage(
+      imageUrl: safeUrl,
+      cacheManager: _cacheManager,
+      width: widget.width,
+      height: widget.height,
+      fit: widget.fit,
+      alignment: widget.alignment,
+      memCacheWidth: memCacheWidth,
+      memCacheHeight: memCacheHeight,
+      placeholder: (context, url) => _buildPlaceholder(context),
+      errorWidget: (context, url, error) {
+        widget.onError?.call(url, error);
+        return _buildErrorWidget(context);
+      },
+      fadeInDuration: const Duration(milliseconds: 150),
+      fadeOutDuration: const Duration(milliseconds: 150),
+    );
+  }
+
   @override
   Widget build(BuildContext context) {
     final safeUrl = UrlUtils.getSafeUrl(widget.imageUrl);
@@ -186,24 +267,11 @@ class _SafeCachedImageState extends State<SafeCachedImage> {
     }
 
     Widget imageContent;
-    if (_isVisible || _hasTriedLoading) {
-      imageContent = CachedNetworkImage(
-        imageUrl: safeUrl,
-        cacheManager: _cacheManager,
-        width: widget.width,
-        height: widget.height,
-        fit: widget.fit,
-        alignment: widget.alignment,
-        memCacheWidth: finalCacheWidth,
-        memCacheHeight: finalCacheHeight,
-        placeholder: (context, url) => _buildPlaceholder(context),
-        errorWidget: (context, url, error) {
-          widget.onError?.call(url, error);
-          return _buildErrorWidget(context);
-        },
-        fadeInDuration: const Duration(milliseconds: 150),
-        fadeOutDuration: const Duration(milliseconds: 150),
-      );
+    if ((_isVisible || _hasTriedLoading) && widget.useThumbnail) {
+      imageContent = _buildThumbnail(context, safeUrl);
+    } else if (_isVisible || _hasTriedLoading) {
+      imageContent =
+          _buildNetworkImage(safeUrl, finalCacheWidth, finalCacheHeight);
     } else {
       imageContent = _buildPlaceholder(context);
     }
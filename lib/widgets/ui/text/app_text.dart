@@ -1,6 +1,7 @@
 // lib/widgets/ui/text/app_text.dart
 import 'package:flutter/material.dart';
 import 'package:suxingchahui/utils/font/font_config.dart';
+import 'package:suxingchahui/windows/native/font_subset_channel.dart';
 import 'package:suxingchahui/widgets/ui/dart/color_extensions.dart';
 import 'app_text_type.dart';
 
@@ -77,6 +78,9 @@ class AppText extends StatelessWidget {
 
   @override
   Widget build(BuildContext context) {
+    // 记录界面用到的字符，用于生成字体子集；这里只入队，逐字符处理推迟到合并定时器里
+    FontSubsetChannel.record(data);
+
     // 1. 根据 type 获取基础样式
     final TextStyle styleFromType = _getStyleForType(context, type);
 
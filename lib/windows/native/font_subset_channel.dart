@@ -0,0 +1,123 @@
+// lib/windows/native/font_subset_channel.dart
+
+/// 该文件定义了 FontSubsetChannel，使用 runner 生成的 NotoSansSC 子集。
+/// 完整字体有两兆多，界面实际用到的汉字只占一小部分。运行时把 UI 文本和缓存
+/// 内容里出现的字符交给 runner 记录，启动一分钟后在后台按记录生成子集；
+/// 下次启动时用 FontLoader 以内置字体的字体族名注册子集，代替完整字体。
+/// 界面的字体族解析（FontConfig）不变，只有用到内置字体族的地方改用子集，
+/// 子集里没有的字符按各处的 fontFamilyFallback 回退。
+library;
+
+import 'dart:async'; // Timer
+import 'dart:io'; // File
+
+import 'package:flutter/foundation.dart'; // 平台判断所需
+import 'package:flutter/services.dart'; // MethodChannel / FontLoader
+
+/// `FontSubsetChannel` 类：字体子集的 Dart 端入口。
+///
+/// 仅在 Windows 上可用，其它平台所有方法直接返回。
+class FontSubsetChannel {
+  static const MethodChannel _channel =
+      MethodChannel('com.example.suxingchahui/font_subset'); // 原生通道
+
+  // pubspec 中内置字体的字体族。只有 Regular 一种字重，子集也只有 Regular，
+  // 粗体照旧由引擎合成
+  static const String bundledFamily = 'NotoSansSC';
+
+  static const Duration _flushDelay = Duration(seconds: 5); // 记录的合并间隔
+  static const Duration _buildDelay = Duration(seconds: 60); // 避开启动高峰
+  // 一个合并间隔内最多保留的文本数，超出的丢弃，下次出现时再记录
+  static const int _maxQueuedTexts = 1024;
+
+  static final List<String> _queued = <String>[]; // 等待扫描的文本
+  static final Set<int> _seen = <int>{}; // 本次运行已经记录过的字符
+  static final StringBuffer _pending = StringBuffer(); // 还没发给 runner 的字符
+  static Timer? _flushTimer;
+  static bool _buildScheduled = false;
+  static bool _loaded = false;
+
+  /// 当前平台是否有原生子集缓存。
+  static bool get isSupported =>
+      !kIsWeb && defaultTargetPlatform == TargetPlatform.windows;
+
+  /// 本次启动是否已经注册了子集字体。
+  static bool get loaded => _loaded;
+
+  /// 以 [bundledFamily] 注册上次生成的子集。动态注册的字体优先于资源里的
+  /// 同名字体，没有可用子集时照旧使用完整字体。应在 runApp 前完成。
+  static Future<void> loadCachedSubset() async {
+    if (!isSupported || _loaded) return;
+    try {
+      final path = await _channel.invokeMethod<String>('lookup');
+      if (path == null) return;
+      final bytes = await File(path).readAsBytes();
+      final loader = FontLoader(bundledFamily)
+        ..addFont(Future.value(ByteData.sublistView(bytes)));
+      await loader.load();
+      _loaded = true;
+    } on MissingPluginException {
+      // 旧版本 runner
+    } on FileSystemException {
+      // 子集被删除，下次生成时重建
+    } on PlatformException {
+      // 查找失败时使用完整字体
+    }
+  }
+
+  /// 记录 [text] 中的非 ASCII 字符，攒一批后再发给 runner。
+  ///
+  /// 在 AppText.build 里对每段文本调用，这里只把文本放进队列，不逐字符
+  /// 处理；合并间隔到期时再统一扫描。连续重复的同一个字符串只排一次，
+  /// 队列满时直接返回。
+  static void record(String text) {
+    if (text.isEmpty || !isSupported) return;
+    if (_queued.length >= _maxQueuedTexts ||
+        (_queued.isNotEmpty && identical(_queued.last, text))) {
+      return;
+    }
+    _queued.add(text);
+    _flushTimer ??= Timer(_flushDelay, _flush);
+  }
+
+  /// 启动 [_buildDelay] 后在后台生成子集，供下次启动使用。只安排一次。
+  static void scheduleBuild() {
+    if (!isSupported || _buildScheduled) return;
+    _buildScheduled = true;
+    Timer(_buildDelay, () async {
+      await _flush();
+      try {
+        await _channel.invokeMethod<void>('build');
+      } on MissingPluginException {
+        // 旧版本 runner
+      } on PlatformException {
+        // 生成失败时继续使用完整字体
+      }
+    });
+  }
+
+  /// 扫描队列里的文本，把新出现的非 ASCII 字符放进 [_pending]。
+  static void _scanQueued() {
+    for (final text in _queued) {
+      for (final rune in text.runes) {
+        if (rune < 0x80 || !_seen.add(rune)) continue;
+        _pending.writeCharCode(rune);
+      }
+    }
+    _queued.clear();
+  }
+
+  static Future<void> _flush() async {
+    _flushTimer?.cancel();
+    _flushTimer = null;
+    _scanQueued();
+    if (_pending.isEmpty) return;
+    final text = _pending.toString();
+    _pending.clear();
+    try {
+      await _channel.invokeMethod<void>('record', {'text': text});
+    } on MissingPluginException {
+      // 旧版本 runner
+    }
+  }
+}
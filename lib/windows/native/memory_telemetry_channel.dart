@@ -0,0 +1,173 @@
+// lib/windows/native/memory_telemetry_channel.dart
+
+/// 该文件定义了 MemoryTelemetryChannel，读取原生侧周期记录的进程内存数据。
+/// runner 的采样线程按固定间隔记录工作集、私有字节、已提交内存、句柄数和各
+/// 子系统登记的计数器（对象 ID 表、游戏索引、KV 存储、搜索索引等），写入固定
+/// 大小的环形缓冲区。Dart 侧把自己的图片缓存大小推送为 `dart.image_cache`。
+library;
+
+import 'dart:async'; // Timer
+import 'dart:typed_data'; // Int64List
+
+import 'package:flutter/foundation.dart'; // 平台判断所需
+import 'package:flutter/painting.dart'; // PaintingBinding.imageCache
+import 'package:flutter/services.dart'; // MethodChannel
+
+/// 采样器的状态。
+class MemoryTelemetryStatus {
+  final bool running; // 采样线程是否在运行
+  final Duration interval; // 采样间隔
+  final int capacity; // 环形缓冲区的行数
+  final List<String> labels; // 已登记的计数器
+
+  const MemoryTelemetryStatus({
+    required this.running,
+    required this.interval,
+    required this.capacity,
+    required this.labels,
+  });
+}
+
+/// 一次采样，字节数均为原始值。
+class MemoryTelemetryRow {
+  final int sequence; // 从 1 开始递增
+  final DateTime time;
+  final int workingSet;
+  final int privateBytes;
+  final int commit;
+  final int handles;
+  final List<int> counters; // 与 [MemoryTelemetrySeries.labels] 一一对应
+
+  const MemoryTelemetryRow({
+    required this.sequence,
+    required this.time,
+    required this.workingSet,
+    required this.privateBytes,
+    required this.commit,
+    required this.handles,
+    required this.counters,
+  });
+}
+
+/// 一批采样，按序号从旧到新。
+class MemoryTelemetrySeries {
+  final List<String> labels;
+  final List<MemoryTelemetryRow> rows;
+
+  const MemoryTelemetrySeries(this.labels, this.rows);
+}
+
+/// `MemoryTelemetryChannel` 类：内存采样的 Dart 端入口。
+///
+/// 仅在 Windows 上可用，其它平台查询返回空结果。
+class MemoryTelemetryChannel {
+  static const MethodChannel _channel =
+      MethodChannel('com.example.suxingchahui/memory_telemetry'); // 原生通道
+
+  static const String imageCacheLabel = 'dart.image_cache'; // 图片缓存计数器
+  static const int _columnsBeforeCounters = 6;
+
+  static Timer? _imageCacheTimer;
+
+  /// 当前平台是否有原生采样器。
+  static bool get isSupported =>
+      !kIsWeb && defaultTargetPlatform == TargetPlatform.windows;
+
+  /// 采样器状态，不支持或通道不可用时返回 null。
+  static Future<MemoryTelemetryStatus?> status() async {
+    if (!isSupported) return null;
+    try {
+      final result =
+          await _channel.invokeMapMethod<String, dynamic>('status');
+      if (result == null) return null;
+      return MemoryTelemetryStatus(
+        running: result['running'] == true,
+        interval: Duration(milliseconds: (result['intervalMs'] as int?) ?? 0),
+        capacity: (result['capacity'] as int?) ?? 0,
+        labels: List<String>.from(result['labels'] as List? ?? const []),
+      );
+    } on MissingPluginException {
+      return null; // 旧版本 runner
+    }
+  }
+
+  /// 以 [interval] 开始采样；已经在采样时只修改间隔。
+  static Future<void> start(Duration interval) async {
+    if (!isSupported) return;
+    await _channel
+        .invokeMethod<void>('start', {'intervalMs': interval.inMilliseconds});
+  }
+
+  static Future<void> stop() async {
+    if (!isSupported) return;
+    await _channel.invokeMethod<void>('stop');
+  }
+
+  /// 立即记录一行。
+  static Future<void> sample() async {
+    if (!isSupported) return;
+    await _reportImageCache();
+    await _channel.invokeMethod<void>('sample');
+  }
+
+  /// 返回序号大于 [after] 的采样。
+  static Future<MemoryTelemetrySeries> series({int after = 0}) async {
+    if (!isSupported) return const MemoryTelemetrySeries([], []);
+    final result = await _channel
+        .invokeMapMethod<String, dynamic>('series', {'after': after});
+    if (result == null) return const MemoryTelemetrySeries([], []);
+    final labels = List<String>.from(result['labels'] as List? ?? const []);
+    final columns = (result['columns'] as int?) ?? 0;
+    final values = result['values'] as Int64List? ?? Int64List(0);
+    final rows = <MemoryTelemetryRow>[];
+    for (int offset = 0;
+        columns > 0 && offset + columns <= values.length;
+        offset += columns) {
+      rows.add(MemoryTelemetryRow(
+        sequence: values[offset],
+        time: DateTime.fromMillisecondsSinceEpoch(values[offset + 1]),
+        workingSet: values[offset + 2],
+        privateBytes: values[offset + 3],
+        commit: values[offset + 4],
+        handles: values[offset + 5],
+        counters: values.sublist(
+            offset + _columnsBeforeCounters, offset + columns),
+      ));
+    }
+    return MemoryTelemetrySeries(labels, rows);
+  }
+
+  /// 写出全部采样为 CSV，返回文件路径。不传 [path] 时写到应用数据目录。
+  static Future<String?> dump([String? path]) async {
+    if (!isSupported) return null;
+    return _channel.invokeMethod<String>(
+        'dump', path == null ? null : {'path': path});
+  }
+
+  /// 推送名为 [label] 的计数器。
+  static Future<bool> setCounter(String label, int value) async {
+    if (!isSupported) return false;
+    return await _channel.invokeMethod<bool>(
+            'setCounter', {'label': label, 'value': value}) ??
+        false;
+  }
+
+  /// 定期把图片缓存占用推送给原生采样器，重复调用只保留一个定时器。
+  static void startImageCacheReporting(
+      {Duration interval = const Duration(seconds: 10)}) {
+    if (!isSupported) return;
+    _imageCacheTimer?.cancel();
+    unawaited(_reportImageCache());
+    _imageCacheTimer = Timer.periodic(interval, (_) => _reportImageCache());
+  }
+
+  static Future<void> _reportImageCache() async {
+    try {
+      await setCounter(imageCacheLabel,
+          PaintingBinding.instance.imageCache.currentSizeBytes);
+    } on MissingPluginException {
+      _imageCacheTimer?.cancel(); // 旧版本 runner
+      _imageCacheTimer = null;
+    }
+  }
+}
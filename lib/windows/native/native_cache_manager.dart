@@ -0,0 +1,219 @@
+// lib/windows/native/native_cache_manager.dart
+
+/// 该文件定义了 NativeCacheManager，以原生磁盘缓存（NativeDiskCache）为存储的 BaseCacheManager。
+/// 与 flutter_cache_manager 默认实现相比：按总字节数而不是对象数量淘汰，
+/// 索引是内存映射的哈希表而不是 SQLite，相同内容的图片只存一份。
+library;
+
+import 'dart:async'; // 异步操作所需
+import 'dart:io' as io; // 下载临时文件
+import 'dart:typed_data'; // Uint8List
+import 'package:file/file.dart'; // FileInfo 使用的 File 类型
+import 'package:file/local.dart'; // 本地文件系统
+import 'package:flutter_cache_manager/flutter_cache_manager.dart'; // BaseCacheManager 接口
+import 'package:suxingchahui/windows/native/native_disk_cache.dart'; // 原生磁盘缓存
+import 'package:suxingchahui/windows/native/native_http_file_service.dart'; // 原生连接池下载
+
+/// `NativeCacheManager` 类：可以直接替换 `CacheManager` 的缓存管理器。
+///
+/// 下载默认使用 [NativeHttpFileService]（原生连接池），下载内容先写入原生缓存的
+/// 临时目录，完成后整体移入缓存。不支持下载进度，`withProgress` 会被忽略。
+class NativeCacheManager implements BaseCacheManager {
+  static const LocalFileSystem _fileSystem = LocalFileSystem(); // 本地文件系统
+  static const Duration _trimDelay = Duration(seconds: 30); // 启动后延迟清理过期条目
+
+  final NativeDiskCache _cache; // 原生缓存
+  final Duration stalePeriod; // 超过该时长未访问的条目会被移除
+  final FileService _fileService; // 下载服务
+  final Map<String, Future<FileInfo>> _downloads = {}; // 进行中的下载，同一个 key 只下载一次
+  int _tempFileCounter = 0; // 临时文件序号
+  Timer? _trimTimer; // 延迟清理计时器
+
+  NativeCacheManager._(this._cache, this.stalePeriod, this._fileService) {
+    _trimTimer = Timer(_trimDelay, () {
+      _cache.removeOlderThan(DateTime.now().subtract(stalePeriod));
+    });
+  }
+
+  /// 创建名为 [cacheKey] 的缓存管理器，当前平台不支持原生缓存时返回 null。
+  static NativeCacheManager? create(
+    String cacheKey, {
+    Duration stalePeriod = const Duration(days: 30),
+    int maxCacheBytes = 512 * 1024 * 1024,
+    FileService? fileService,
+  }) {
+    final cache = NativeDiskCache.open(
+      cacheKey.replaceAll(RegExp(r'[^A-Za-z0-9_-]'), '_'),
+      maxBytes: maxCacheBytes,
+    );
+    if (cache == null) return null;
+    return NativeCacheManager._(
+        cache, stalePeriod, fileService ?? NativeHttpFileService());
+  }
+
+  /// 原生缓存统计。
+  NativeDiskCacheStats get stats => _cache.stats();
+
+  @override
+  Future<File> getSingleFile(
+    String url, {
+    String? key,
+    Map<String, String>? headers,
+  }) async {
+    key ??= url;
+    final cached = await getFileFromCache(key);
+    if (cached != null && cached.validTill.isAfter(DateTime.now())) {
+      return cached.file;
+    }
+    return (await downloadFile(url, key: key, authHeaders: headers)).file;
+  }
+
+  @override
+  @Deprecated('Prefer to use the new getFileStream method')
+  Stream<FileInfo> getFile(
+    String url, {
+    String? key,
+    Map<String, String>? headers,
+  }) {
+    return getFileStream(url, key: key, headers: headers)
+        .where((response) => response is FileInfo)
+        .cast<FileInfo>();
+  }
+
+  @override
+  Stream<FileResponse> getFileStream(
+    String url, {
+    String? key,
+    Map<String, String>? headers,
+    bool withProgress = false,
+  }) async* {
+    key ??= url;
+    final cached = await getFileFromCache(key);
+    if (cached != null) yield cached;
+    if (cached == null || cached.validTill.isBefore(DateTime.now())) {
+      try {
+        yield await downloadFile(url, key: key, authHeaders: headers);
+      } catch (_) {
+        if (cached == null) rethrow; // 已经给出过缓存版本时忽略刷新失败
+      }
+    }
+  }
+
+  @override
+  Future<FileInfo> downloadFile(
+    String url, {
+    String? key,
+    Map<String, String>? authHeaders,
+    bool force = false,
+  }) {
+    key ??= url;
+    final pending = _downloads[key];
+    if (pending != null) return pending;
+    final download = _download(url, key, authHeaders)
+        .whenComplete(() => _downloads.remove(key));
+    _downloads[key] = download;
+    return download;
+  }
+
+  @override
+  Future<FileInfo?> getFileFromCache(
+    String key, {
+    bool ignoreMemCache = false,
+  }) async {
+    final entry = _cache.lookup(key);
+    if (entry == null) return null;
+    final file = _fileSystem.file(entry.path);
+    if (!await file.exists()) {
+      _cache.remove(key); // 内容文件被外部删除
+      return null;
+    }
+    return FileInfo(file, FileSource.Cache, entry.validTill, key);
+  }
+
+  @override
+  Future<FileInfo?> getFileFromMemory(String key) {
+    // 原生索引本身就在内存映射中，与 getFileFromCache 相同
+    return getFileFromCache(key);
+  }
+
+  @override
+  Future<File> putFile(
+    String url,
+    Uint8List fileBytes, {
+    String? key,
+    String? eTag,
+    Duration maxAge = const Duration(days: 30),
+    String fileExtension = 'file',
+  }) async {
+    final tempFile = _createTempFile();
+    await tempFile.writeAsBytes(fileBytes, flush: true);
+    return await _commit(key ?? url, tempFile, DateTime.now().add(maxAge));
+  }
+
+  @override
+  Future<File> putFileStream(
+    String url,
+    Stream<List<int>> source, {
+    String? key,
+    String? eTag,
+    Duration maxAge = const Duration(days: 30),
+    String fileExtension = 'file',
+  }) async {
+    final tempFile = _createTempFile();
+    final sink = tempFile.openWrite();
+    await sink.addStream(source);
+    await sink.close();
+    return await _commit(key ?? url, tempFile, DateTime.now().add(maxAge));
+  }
+
+  @override
+  Future<void> removeFile(String key) async {
+    _cache.remove(key);
+  }
+
+  @override
+  Future<void> emptyCache() async {
+    _cache.clear();
+  }
+
+  @override
+  Future<void> dispose() async {
+    _trimTimer?.cancel(); // 原生缓存在进程内共享，不需要关闭
+  }
+
+  Future<FileInfo> _download(
+    String url,
+    String key,
+    Map<String, String>? headers,
+  ) async {
+    final response = await _fileService.get(url, headers: headers);
+    if (response.statusCode != io.HttpStatus.ok) {
+      throw HttpExceptionWithStatus(
+        response.statusCode,
+        'Invalid statusCode: ${response.statusCode}',
+        uri: Uri.parse(url),
+      );
+    }
+    final tempFile = _createTempFile();
+    final sink = tempFile.openWrite();
+    try {
+      await sink.addStream(response.content);
+    } finally {
+      await sink.close();
+    }
+    final file = await _commit(key, tempFile, response.validTill);
+    return FileInfo(file, FileSource.Online, response.validTill, url);
+  }
+
+  io.File _createTempFile() {
+    return io.File('${_cache.tempDirectory}${io.Platform.pathSeparator}'
+        '${DateTime.now().microsecondsSinceEpoch}_${_tempFileCounter++}.part');
+  }
+
+  /// 把临时文件移入缓存。放不进缓存（例如单个文件过大）时直接返回临时文件，
+  /// 临时目录会在下次启动时清空。计算内容哈希在后台 isolate 中进行。
+  Future<File> _commit(String key, io.File tempFile, DateTime validTill) async {
+    final entry = await _cache.putFile(key, tempFile.path, validTill);
+    return _fileSystem.file(entry?.path ?? tempFile.path);
+  }
+}
@@ -0,0 +1,260 @@
+// lib/windows/native/native_disk_cache.dart
+
+/// 该文件定义了 NativeDiskCache，原生按内容寻址磁盘缓存（runner 中的 DiskCache）的 FFI 绑定。
+/// 索引为内存映射文件，查询只是一次哈希表查找，直接在调用线程上同步执行；
+/// 写入需要对整个文件计算哈希，在后台 isolate 中执行。
+library;
+
+import 'dart:ffi'; // FFI
+import 'dart:isolate'; // 后台写入
+import 'package:ffi/ffi.dart'; // UTF-8 字符串与内存分配
+import 'package:flutter/foundation.dart'; // 平台判断所需
+
+/// 与 runner 中 RunnerDiskCacheEntry 的布局一致。
+final class _RunnerDiskCacheEntry extends Struct {
+  @Int64()
+  external int size;
+  @Int64()
+  external int validTillMs;
+  @Int64()
+  external int lastAccessMs;
+}
+
+/// 与 runner 中 RunnerDiskCacheStats 的布局一致。
+final class _RunnerDiskCacheStats extends Struct {
+  @Int64()
+  external int entries;
+  @Int64()
+  external int bytes;
+  @Int64()
+  external int hits;
+  @Int64()
+  external int misses;
+  @Int64()
+  external int evictions;
+}
+
+typedef _OpenNative = Pointer<Void> Function(Pointer<Utf8>, Int64, Int32);
+typedef _OpenDart = Pointer<Void> Function(Pointer<Utf8>, int, int);
+typedef _LookupNative = Int32 Function(Pointer<Void>, Pointer<Utf8>,
+    Pointer<_RunnerDiskCacheEntry>, Pointer<Utf8>, Int32);
+typedef _LookupDart = int Function(Pointer<Void>, Pointer<Utf8>,
+    Pointer<_RunnerDiskCacheEntry>, Pointer<Utf8>, int);
+typedef _PutFileNative = Int32 Function(Pointer<Void>, Pointer<Utf8>,
+    Pointer<Utf8>, Int64, Pointer<_RunnerDiskCacheEntry>, Pointer<Utf8>, Int32);
+typedef _PutFileDart = int Function(Pointer<Void>, Pointer<Utf8>,
+    Pointer<Utf8>, int, Pointer<_RunnerDiskCacheEntry>, Pointer<Utf8>, int);
+typedef _RemoveNative = Int32 Function(Pointer<Void>, Pointer<Utf8>);
+typedef _RemoveDart = int Function(Pointer<Void>, Pointer<Utf8>);
+typedef _RemoveOlderThanNative = Int64 Function(Pointer<Void>, Int64);
+typedef _RemoveOlderThanDart = int Function(Pointer<Void>, int);
+typedef _ClearNative = Void Function(Pointer<Void>);
+typedef _ClearDart = void Function(Pointer<Void>);
+typedef _TempDirectoryNative = Int32 Function(
+    Pointer<Void>, Pointer<Utf8>, Int32);
+typedef _TempDirectoryDart = int Function(Pointer<Void>, Pointer<Utf8>, int);
+typedef _StatsNative = Void Function(
+    Pointer<Void>, Pointer<_RunnerDiskCacheStats>);
+typedef _StatsDart = void Function(
+    Pointer<Void>, Pointer<_RunnerDiskCacheStats>);
+
+/// runner.exe 导出的函数。
+class _Bindings {
+  final _OpenDart open;
+  final _LookupDart lookup;
+  final _PutFileDart putFile;
+  final _RemoveDart remove;
+  final _RemoveOlderThanDart removeOlderThan;
+  final _ClearDart clear;
+  final _TempDirectoryDart tempDirectory;
+  final _StatsDart stats;
+
+  _Bindings(DynamicLibrary library)
+      : open = library.lookupFunction<_OpenNative, _OpenDart>(
+            'runner_disk_cache_open'),
+        lookup = library.lookupFunction<_LookupNative, _LookupDart>(
+            'runner_disk_cache_lookup'),
+        putFile = library.lookupFunction<_PutFileNative, _PutFileDart>(
+            'runner_disk_cache_put_file'),
+        remove = library.lookupFunction<_RemoveNative, _RemoveDart>(
+            'runner_disk_cache_remove'),
+        removeOlderThan = library
+            .lookupFunction<_RemoveOlderThanNative, _RemoveOlderThanDart>(
+                'runner_disk_cache_remove_older_than'),
+        clear = library.lookupFunction<_ClearNative, _ClearDart>(
+            'runner_disk_cache_clear'),
+        tempDirectory =
+            library.lookupFunction<_TempDirectoryNative, _TempDirectoryDart>(
+                'runner_disk_cache_temp_directory'),
+        stats = library.lookupFunction<_StatsNative, _StatsDart>(
+            'runner_disk_cache_stats');
+
+  static _Bindings? _instance; // 符号只查找一次
+  static bool _loadFailed = false; // 旧版本 runner 没有导出这些符号
+
+  static _Bindings? get instance {
+    if (_instance != null || _loadFailed) return _instance;
+    try {
+      _instance = _Bindings(DynamicLibrary.executable());
+    } catch (_) {
+      _loadFailed = true;
+    }
+    return _instance;
+  }
+}
+
+/// `NativeDiskCacheEntry` 类：一条缓存记录。
+class NativeDiskCacheEntry {
+  final String path; // 内容文件路径
+  final int size; // 字节数
+  final DateTime validTill; // 有效期
+  final DateTime lastAccess; // 最后访问时间
+
+  const NativeDiskCacheEntry({
+    required this.path,
+    required this.size,
+    required this.validTill,
+    required this.lastAccess,
+  });
+}
+
+/// `NativeDiskCacheStats` 类：缓存统计。
+class NativeDiskCacheStats {
+  final int entries; // 条目数
+  final int bytes; // 总字节数
+  final int hits; // 命中次数
+  final int misses; // 未命中次数
+  final int evictions; // 因容量淘汰的条目数
+
+  const NativeDiskCacheStats({
+    required this.entries,
+    required this.bytes,
+    required this.hits,
+    required this.misses,
+    required this.evictions,
+  });
+}
+
+/// `NativeDiskCache` 类：一个按名称打开的原生磁盘缓存。
+///
+/// 同名缓存在原生侧只打开一次，句柄在进程退出前一直有效，因此不需要关闭。
+class NativeDiskCache {
+  static const int _pathCapacity = 4096; // 路径缓冲区字节数
+
+  final _Bindings _bindings;
+  final Pointer<Void> _handle; // 原生 DiskCache*
+  final Pointer<_RunnerDiskCacheEntry> _entry; // 复用的结果缓冲区
+  final Pointer<Utf8> _path; // 复用的路径缓冲区
+  late final String tempDirectory = _readTempDirectory(); // 下载临时目录
+
+  NativeDiskCache._(this._bindings, this._handle)
+      : _entry = calloc<_RunnerDiskCacheEntry>(),
+        _path = calloc<Uint8>(_pathCapacity).cast<Utf8>();
+
+  /// 当前平台是否可以使用原生缓存。
+  static bool get isSupported =>
+      !kIsWeb && defaultTargetPlatform == TargetPlatform.windows;
+
+  /// 打开名为 [name] 的缓存，失败或平台不支持时返回 null。
+  ///
+  /// [maxBytes] 为内容文件总字节上限，[maxEntries] 为索引容量。
+  static NativeDiskCache? open(
+    String name, {
+    required int maxBytes,
+    int maxEntries = 65536,
+  }) {
+    if (!isSupported) return null;
+    final bindings = _Bindings.instance;
+    if (bindings == null) return null;
+    final handle = using((arena) =>
+        bindings.open(name.toNativeUtf8(allocator: arena), maxBytes, maxEntries));
+    if (handle == nullptr) return null;
+    return NativeDiskCache._(bindings, handle);
+  }
+
+  /// 查询 [key]，命中时同时刷新访问时间。
+  NativeDiskCacheEntry? lookup(String key) {
+    final length = using((arena) => _bindings.lookup(_handle,
+        key.toNativeUtf8(allocator: arena), _entry, _path, _pathCapacity));
+    return _readEntry(length);
+  }
+
+  /// 把已经写好的 [sourcePath]（应位于 [tempDirectory] 中）移入缓存。
+  ///
+  /// 在后台 isolate 中执行。成功时文件被移走；失败（例如文件超过容量）时
+  /// 返回 null，文件保持不变。
+  Future<NativeDiskCacheEntry?> putFile(
+      String key, String sourcePath, DateTime validTill) {
+    final handle = _handle.address; // 原生缓存在进程内共享，地址可以跨 isolate 使用
+    final validTillMs = validTill.millisecondsSinceEpoch;
+    return Isolate.run(() => _putFileOn(handle, key, sourcePath, validTillMs));
+  }
+
+  static NativeDiskCacheEntry? _putFileOn(
+      int handle, String key, String sourcePath, int validTillMs) {
+    final bindings = _Bindings.instance; // 后台 isolate 中重新查找符号
+    if (bindings == null) return null;
+    return using((arena) {
+      final entry = arena<_RunnerDiskCacheEntry>();
+      final path = arena<Uint8>(_pathCapacity).cast<Utf8>();
+      final length = bindings.putFile(
+          Pointer<Void>.fromAddress(handle),
+          key.toNativeUtf8(allocator: arena),
+          sourcePath.toNativeUtf8(allocator: arena),
+          validTillMs,
+          entry,
+          path,
+          _pathCapacity);
+      return _toEntry(length, entry, path);
+    });
+  }
+
+  /// 移除 [key]，返回是否存在。
+  bool remove(String key) {
+    return using((arena) =>
+        _bindings.remove(_handle, key.toNativeUtf8(allocator: arena)) != 0);
+  }
+
+  /// 移除最后访问时间早于 [time] 的条目，返回移除数量。
+  int removeOlderThan(DateTime time) =>
+      _bindings.removeOlderThan(_handle, time.millisecondsSinceEpoch);
+
+  /// 移除所有条目。
+  void clear() => _bindings.clear(_handle);
+
+  /// 读取统计。
+  NativeDiskCacheStats stats() {
+    final stats = calloc<_RunnerDiskCacheStats>();
+    try {
+      _bindings.stats(_handle, stats);
+      return NativeDiskCacheStats(
+        entries: stats.ref.entries,
+        bytes: stats.ref.bytes,
+        hits: stats.ref.hits,
+        misses: stats.ref.misses,
+        evictions: stats.ref.evictions,
+      );
+    } finally {
+      calloc.free(stats);
+    }
+  }
+
+  NativeDiskCacheEntry? _readEntry(int length) =>
+      _toEntry(length, _entry, _path);
+
+  static NativeDiskCacheEntry? _toEntry(
+      int length, Pointer<_RunnerDiskCacheEntry> entry, Pointer<Utf8> path) {
+    if (length <= 0) return null; // 未命中或路径过长
+    return NativeDiskCacheEntry(
+      path: path.toDartString(length: length),
+      size: entry.ref.size,
+      validTill: DateTime.fromMillisecondsSinceEpoch(entry.ref.validTillMs),
+      lastAccess: DateTime.fromMillisecondsSinceEpoch(entry.ref.lastAccessMs),
+    );
+  }
+
+  String _readTempDirectory() {
+    final length = _bindings.tempDirectory(_handle, _path, _pathCapacity);
+    return length > 0 ? _path.toDartString(length: length) : '';
+  }
+}
@@ -0,0 +1,182 @@
+// lib/windows/native/native_download_channel.dart
+
+/// 该文件定义了 NativeDownloadChannel，通过原生分段下载器下载游戏直链。
+/// 支持 Range 的服务器上，文件由多条连接按段并行下载，进度和 SHA-256 中间状态
+/// 定期写入日志，暂停或程序退出后可以从断点继续；不支持 Range 时退化为单连接。
+library;
+
+import 'dart:async'; // Stream
+
+import 'package:flutter/foundation.dart'; // 平台判断所需
+import 'package:flutter/services.dart'; // MethodChannel、EventChannel
+
+/// `NativeDownloadProbe` 类：下载前探测链接的结果。
+class NativeDownloadProbe {
+  final int statusCode; // 状态码
+  final bool rangeSupported; // 支持分段和续传
+  final int totalBytes; // 文件大小，0 表示未知
+  final String contentType; // 小写，不含参数
+  final String fileName; // 服务器给出的文件名，可能为空
+
+  const NativeDownloadProbe({
+    required this.statusCode,
+    required this.rangeSupported,
+    required this.totalBytes,
+    required this.contentType,
+    required this.fileName,
+  });
+
+  /// 是否为文件直链：网盘分享页等返回 HTML 的链接只能在浏览器中打开。
+  bool get isDirectFile =>
+      (statusCode == 200 || statusCode == 206) &&
+      contentType != 'text/html' &&
+      contentType != 'application/xhtml+xml';
+}
+
+/// 下载状态，与原生侧事件的 state 字段一致。
+enum NativeDownloadState {
+  running, // 下载中
+  completed, // 已完成，文件已改名为目标路径
+  paused, // 已暂停，可以继续
+  cancelled, // 已取消，未完成的文件已删除
+  failed, // 失败
+}
+
+/// `NativeDownloadEvent` 类：原生侧推送的下载进度或结果。
+class NativeDownloadEvent {
+  final String id; // start 时传入的 id
+  final NativeDownloadState state; // 状态
+  final int totalBytes; // 文件大小，0 表示未知
+  final int receivedBytes; // 已下载，包括之前下载的部分
+  final int verifiedBytes; // 已计算 SHA-256 的字节数
+  final double bytesPerSecond; // 当前速度
+  final int connections; // 正在使用的连接数
+  final String? path; // 目标路径，结束时有效
+  final String? sha256; // 完成时的 SHA-256（小写十六进制）
+  final String? error; // 失败原因
+  final bool checksumMismatch; // 失败是因为 SHA-256 不一致
+
+  const NativeDownloadEvent({
+    required this.id,
+    required this.state,
+    required this.totalBytes,
+    required this.receivedBytes,
+    required this.verifiedBytes,
+    required this.bytesPerSecond,
+    required this.connections,
+    this.path,
+    this.sha256,
+    this.error,
+    this.checksumMismatch = false,
+  });
+
+  /// 完成比例，大小未知时为 null。
+  double? get fraction =>
+      totalBytes > 0 ? (receivedBytes / totalBytes).clamp(0.0, 1.0) : null;
+
+  static NativeDownloadEvent? fromMap(Object? event) {
+    if (event is! Map) return null;
+    final state = NativeDownloadState.values
+        .where((value) => value.name == event['state'])
+        .firstOrNull;
+    final id = event['id'];
+    if (state == null || id is! String) return null;
+    int intOf(String key) => (event[key] as num?)?.toInt() ?? 0;
+    return NativeDownloadEvent(
+      id: id,
+      state: state,
+      totalBytes: intOf('totalBytes'),
+      receivedBytes: intOf('receivedBytes'),
+      verifiedBytes: intOf('verifiedBytes'),
+      bytesPerSecond: (event['bytesPerSecond'] as num?)?.toDouble() ?? 0,
+      connections: intOf('connections'),
+      path: event['path'] as String?,
+      sha256: event['sha256'] as String?,
+      error: event['error'] as String?,
+      checksumMismatch: event['checksumMismatch'] == true,
+    );
+  }
+}
+
+/// `NativeDownloadChannel` 类：原生分段下载器的 Dart 端入口。
+///
+/// 仅在 Windows 上可用，调用前先检查 [isSupported]。
+class NativeDownloadChannel {
+  static const MethodChannel _channel =
+      MethodChannel('com.example.suxingchahui/download'); // 原生通道
+  static const EventChannel _eventChannel =
+      EventChannel('com.example.suxingchahui/download_events'); // 进度事件
+
+  static Stream<NativeDownloadEvent>? _events;
+
+  /// 描述中 "SHA256：<64 位十六进制>" 形式的校验值。
+  static final RegExp _sha256Pattern =
+      RegExp(r'SHA-?256\s*[：:]\s*([0-9a-fA-F]{64})', caseSensitive: false);
+
+  /// 当前平台是否可以使用原生下载。
+  static bool get isSupported =>
+      !kIsWeb && defaultTargetPlatform == TargetPlatform.windows;
+
+  /// 所有下载的进度和结果，多个监听者共享一个原生订阅。
+  static Stream<NativeDownloadEvent> get events =>
+      _events ??= _eventChannel
+          .receiveBroadcastStream()
+          .map(NativeDownloadEvent.fromMap)
+          .where((event) => event != null)
+          .cast<NativeDownloadEvent>()
+          .asBroadcastStream();
+
+  /// 从下载链接的描述中取出 SHA-256，没有时返回 null。
+  static String? extractSha256(String description) =>
+      _sha256Pattern.firstMatch(description)?.group(1)?.toLowerCase();
+
+  /// 探测 [url]。网络错误时抛出 [PlatformException]。
+  static Future<NativeDownloadProbe> probe(String url) async {
+    final result = await _channel
+        .invokeMapMethod<String, dynamic>('probe', {'url': url});
+    if (result == null) {
+      throw PlatformException(code: 'probe_failed', message: '探测结果为空');
+    }
+    return NativeDownloadProbe(
+      statusCode: (result['statusCode'] as num?)?.toInt() ?? 0,
+      rangeSupported: result['rangeSupported'] == true,
+      totalBytes: (result['totalBytes'] as num?)?.toInt() ?? 0,
+      contentType: result['contentType'] as String? ?? '',
+      fileName: result['fileName'] as String? ?? '',
+    );
+  }
+
+  /// 开始或继续下载，返回目标路径。进度通过 [events] 推送。
+  ///
+  /// [directory] 为空时下载到系统的“下载”文件夹；同一目标有未完成的下载时
+  /// 从断点继续。给出 [sha256] 时完成后校验，不一致则删除文件。
+  static Future<String> start({
+    required String id,
+    required String url,
+    required String fileName,
+    String? directory,
+    String? sha256,
+    int? connections,
+  }) async {
+    final path = await _channel.invokeMethod<String>('start', {
+      'id': id,
+      'url': url,
+      'fileName': fileName,
+      if (directory != null) 'directory': directory,
+      if (sha256 != null) 'sha256': sha256,
+      if (connections != null) 'connections': connections,
+    });
+    return path ?? '';
+  }
+
+  /// 暂停，保留未完成的文件以便继续。
+  static Future<void> pause(String id) =>
+      _channel.invokeMethod<bool>('pause', {'id': id});
+
+  /// 取消并删除未完成的文件。已经暂停的下载需要传入 start 返回的 [path]。
+  static Future<void> cancel(String id, {String? path}) =>
+      _channel.invokeMethod<bool>('cancel', {
+        'id': id,
+        if (path != null) 'path': path,
+      });
+}
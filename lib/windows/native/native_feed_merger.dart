@@ -0,0 +1,386 @@
+// lib/windows/native/native_feed_merger.dart
+
+/// 该文件定义了 NativeFeedMerger，原生动态时间线合并（runner 中的 FeedMerger）的 FFI 绑定。
+/// 原生侧按时间对分页多路归并、按 ID 去重，并增量维护按用户和按类型折叠的分组，
+/// 每次修改只返回插入、删除、更新这几类操作，Dart 侧按操作改动自己的列表，
+/// 不必在每次构建时重新排序和分组。
+library;
+
+import 'dart:ffi'; // FFI
+import 'package:ffi/ffi.dart'; // 内存分配
+import 'package:flutter/foundation.dart'; // 平台判断所需
+
+/// 与 runner 中 RunnerFeedItem 的布局一致。
+final class _RunnerFeedItem extends Struct {
+  @Uint32()
+  external int id;
+  @Uint32()
+  external int user;
+  @Uint32()
+  external int type;
+  @Int32()
+  external int reserved;
+  @Int64()
+  external int timestamp;
+  @Uint64()
+  external int version;
+}
+
+/// 与 runner 中 RunnerFeedOp 的布局一致。
+final class _RunnerFeedOp extends Struct {
+  @Uint8()
+  external int kind;
+  @Uint8()
+  external int scope;
+  @Uint16()
+  external int reserved;
+  @Uint32()
+  external int index;
+  @Uint32()
+  external int key;
+}
+
+typedef _CreateNative = Pointer<Void> Function();
+typedef _CreateDart = Pointer<Void> Function();
+typedef _HandleNative = Void Function(Pointer<Void>);
+typedef _HandleDart = void Function(Pointer<Void>);
+typedef _MergeNative = Int32 Function(Pointer<Void>, Pointer<_RunnerFeedItem>,
+    Pointer<Int32>, Int32, Pointer<Pointer<_RunnerFeedOp>>);
+typedef _MergeDart = int Function(Pointer<Void>, Pointer<_RunnerFeedItem>,
+    Pointer<Int32>, int, Pointer<Pointer<_RunnerFeedOp>>);
+typedef _ReplaceNative = Int32 Function(Pointer<Void>,
+    Pointer<_RunnerFeedItem>, Int32, Pointer<Pointer<_RunnerFeedOp>>);
+typedef _ReplaceDart = int Function(Pointer<Void>, Pointer<_RunnerFeedItem>,
+    int, Pointer<Pointer<_RunnerFeedOp>>);
+typedef _RemoveNative = Int32 Function(
+    Pointer<Void>, Uint32, Pointer<Pointer<_RunnerFeedOp>>);
+typedef _RemoveDart = int Function(
+    Pointer<Void>, int, Pointer<Pointer<_RunnerFeedOp>>);
+typedef _MembersNative = Int32 Function(
+    Pointer<Void>, Int32, Uint32, Pointer<Uint32>, Int32);
+typedef _MembersDart = int Function(
+    Pointer<Void>, int, int, Pointer<Uint32>, int);
+
+/// runner.exe 导出的函数，都不会回调 Dart，按叶子调用查找。
+class _Bindings {
+  final _CreateDart create;
+  final _HandleDart destroy;
+  final _MergeDart merge;
+  final _ReplaceDart replace;
+  final _RemoveDart remove;
+  final _HandleDart clear;
+  final _MembersDart members;
+
+  _Bindings(DynamicLibrary library)
+      : create = library.lookupFunction<_CreateNative, _CreateDart>(
+            'runner_feed_create',
+            isLeaf: true),
+        destroy = library.lookupFunction<_HandleNative, _HandleDart>(
+            'runner_feed_destroy',
+            isLeaf: true),
+        merge = library.lookupFunction<_MergeNative, _MergeDart>(
+            'runner_feed_merge',
+            isLeaf: true),
+        replace = library.lookupFunction<_ReplaceNative, _ReplaceDart>(
+            'runner_feed_replace',
+            isLeaf: true),
+        remove = library.lookupFunction<_RemoveNative, _RemoveDart>(
+            'runner_feed_remove',
+            isLeaf: true),
+        clear = library.lookupFunction<_HandleNative, _HandleDart>(
+            'runner_feed_clear',
+            isLeaf: true),
+        members = library.lookupFunction<_MembersNative, _MembersDart>(
+            'runner_feed_members',
+            isLeaf: true);
+
+  static _Bindings? _instance; // 符号只查找一次
+  static bool _loadFailed = false; // 旧版本 runner 没有导出这些符号
+
+  static _Bindings? get instance {
+    if (_instance != null || _loadFailed) return _instance;
+    try {
+      _instance = _Bindings(DynamicLibrary.executable());
+    } catch (_) {
+      _loadFailed = true;
+    }
+    return _instance;
+  }
+}
+
+// 与 runner 中 FeedMerger::OpKind 的取值一致
+const int _kOpInsert = 0;
+const int _kOpRemove = 1;
+
+/// 折叠分组的方式，`index + 1` 与 runner 中 FeedMerger::Scope 的取值一致。
+enum NativeFeedGrouping { byUser, byType }
+
+/// `NativeFeedMerger` 类：按时间倒序、按 ID 去重的动态时间线，同时维护两种折叠分组。
+///
+/// 时间线按 [timeOf] 倒序排列；分组按其中最新一条的时间排列，
+/// 组内同样按时间倒序。[versionOf] 在条目内容（点赞、评论等）变化时应当改变。
+/// 不支持的平台上在 Dart 中整体重排，结果相同。
+/// 只能在 UI 线程上使用，不再需要时必须调用 [dispose]。
+class NativeFeedMerger<T> {
+  final String Function(T item) idOf;
+  final String Function(T item) userOf;
+  final String Function(T item) typeOf;
+  final DateTime Function(T item) timeOf;
+  final int Function(T item) versionOf;
+
+  final _Bindings? _bindings;
+  final Pointer<Void> _handle; // 原生 Feed*，不支持时为 nullptr
+  final Map<String, int> _codes = {}; // ID、用户、类型到编号
+  final List<String> _names = []; // 编号到字符串
+  final Map<int, T> _items = {}; // 条目编号到最新的条目
+  final List<int> _order = []; // 时间线中的条目编号
+  final List<List<String>> _groups = [[], []]; // 每种分组方式的分组 key
+  final List<Map<String, List<T>>> _members = [{}, {}]; // 分组成员缓存
+  final Pointer<Pointer<_RunnerFeedOp>> _ops; // 接收操作数组地址
+  Pointer<_RunnerFeedItem> _buffer = nullptr; // 复用的条目缓冲区
+  int _bufferCapacity = 0;
+  Pointer<Uint32> _ids = nullptr; // 复用的分组成员缓冲区
+  int _idCapacity = 0;
+  bool _disposed = false;
+
+  NativeFeedMerger._(this._bindings, this._handle,
+      {required this.idOf,
+      required this.userOf,
+      required this.typeOf,
+      required this.timeOf,
+      required this.versionOf})
+      : _ops = _bindings != null
+            ? calloc<Pointer<_RunnerFeedOp>>()
+            : nullptr;
+
+  /// 创建时间线，平台不支持时使用 Dart 实现。
+  factory NativeFeedMerger({
+    required String Function(T item) idOf,
+    required String Function(T item) userOf,
+    required String Function(T item) typeOf,
+    required DateTime Function(T item) timeOf,
+    required int Function(T item) versionOf,
+  }) {
+    final bindings = isSupported ? _Bindings.instance : null;
+    final handle = bindings?.create() ?? nullptr;
+    return NativeFeedMerger._(handle != nullptr ? bindings : null, handle,
+        idOf: idOf,
+        userOf: userOf,
+        typeOf: typeOf,
+        timeOf: timeOf,
+        versionOf: versionOf);
+  }
+
+  /// 当前平台是否可以使用原生合并。
+  static bool get isSupported =>
+      !kIsWeb && defaultTargetPlatform == TargetPlatform.windows;
+
+  /// 时间线中的条目数。
+  int get length => _order.length;
+
+  bool get isEmpty => _order.isEmpty;
+
+  /// 时间线中的第 [index] 条。
+  T operator [](int index) => _items[_order[index]] as T;
+
+  /// 按 [grouping] 折叠时的分组 key，按各组最新一条的时间倒序。
+  List<String> groupKeys(NativeFeedGrouping grouping) =>
+      _groups[grouping.index];
+
+  /// 分组 [key] 中的条目，按时间倒序。
+  List<T> groupMembers(NativeFeedGrouping grouping, String key) {
+    final cache = _members[grouping.index];
+    final cached = cache[key];
+    if (cached != null) return cached;
+    final bindings = _bindings;
+    final members = <T>[];
+    if (bindings != null) {
+      final code = _codes[key];
+      if (code == null) return members;
+      var total =
+          bindings.members(_handle, grouping.index + 1, code, _ids, _idCapacity);
+      if (total > _idCapacity) {
+        if (_ids != nullptr) calloc.free(_ids);
+        _idCapacity = total;
+        _ids = calloc<Uint32>(total);
+        total = bindings.members(
+            _handle, grouping.index + 1, code, _ids, _idCapacity);
+      }
+      for (int i = 0; i < total; i++) {
+        final item = _items[_ids[i]];
+        if (item != null) members.add(item);
+      }
+    } else {
+      for (final itemCode in _order) {
+        final item = _items[itemCode] as T;
+        final itemKey =
+            grouping == NativeFeedGrouping.byUser ? userOf(item) : typeOf(item);
+        if (itemKey == key) members.add(item);
+      }
+    }
+    return cache[key] = members;
+  }
+
+  /// 让时间线恰好包含 [items]（顺序不限）。返回是否有变化。
+  bool replace(List<T> items) {
+    final bindings = _bindings;
+    if (bindings == null) {
+      _items.clear();
+      for (final item in items) {
+        _items[_code(idOf(item))] = item;
+      }
+      _rebuild();
+      return true;
+    }
+    _fill(items);
+    final count = bindings.replace(_handle, _buffer, items.length, _ops);
+    _apply(count);
+    for (final item in items) {
+      _items[_code(idOf(item))] = item;
+    }
+    return count > 0;
+  }
+
+  /// 合并若干页，每页按时间倒序排列；同一 ID 出现多次时以时间最新的为准。
+  /// 返回是否有变化。
+  bool merge(List<List<T>> pages) {
+    final latest = <int, T>{};
+    for (final page in pages) {
+      for (final item in page) {
+        final code = _code(idOf(item));
+        final previous = latest[code];
+        if (previous == null || timeOf(item).isAfter(timeOf(previous))) {
+          latest[code] = item;
+        }
+      }
+    }
+    final bindings = _bindings;
+    if (bindings == null) {
+      _items.addAll(latest);
+      _rebuild();
+      return latest.isNotEmpty;
+    }
+    final items = [for (final page in pages) ...page];
+    _fill(items);
+    final count = using((arena) {
+      final sizes = arena<Int32>(pages.isEmpty ? 1 : pages.length);
+      for (int i = 0; i < pages.length; i++) {
+        sizes[i] = pages[i].length;
+      }
+      return bindings.merge(_handle, _buffer, sizes, pages.length, _ops);
+    });
+    _apply(count);
+    _items.addAll(latest);
+    return count > 0;
+  }
+
+  /// 删除 ID 为 [id] 的条目。返回是否存在。
+  bool remove(String id) {
+    final code = _codes[id];
+    if (code == null || !_items.containsKey(code)) return false;
+    final bindings = _bindings;
+    if (bindings == null) {
+      _items.remove(code);
+      _rebuild();
+      return true;
+    }
+    _apply(bindings.remove(_handle, code, _ops));
+    return true;
+  }
+
+  void clear() {
+    _bindings?.clear(_handle);
+    _items.clear();
+    _order.clear();
+    for (int i = 0; i < _groups.length; i++) {
+      _groups[i].clear();
+      _members[i].clear();
+    }
+  }
+
+  /// 释放原生时间线。之后不能再调用其他方法。
+  void dispose() {
+    if (_disposed) return;
+    _disposed = true;
+    final bindings = _bindings;
+    if (bindings == null) return;
+    bindings.destroy(_handle);
+    calloc.free(_ops);
+    if (_buffer != nullptr) calloc.free(_buffer);
+    if (_ids != nullptr) calloc.free(_ids);
+  }
+
+  int _code(String value) {
+    final existing = _codes[value];
+    if (existing != null) return existing;
+    _names.add(value);
+    return _codes[value] = _names.length; // 从 1 开始
+  }
+
+  String _name(int code) => _names[code - 1];
+
+  void _fill(List<T> items) {
+    if (_bufferCapacity < items.length) {
+      if (_buffer != nullptr) calloc.free(_buffer);
+      _bufferCapacity = items.length;
+      _buffer = calloc<_RunnerFeedItem>(items.length);
+    }
+    for (int i = 0; i < items.length; i++) {
+      final item = items[i];
+      final record = (_buffer + i).ref;
+      record.id = _code(idOf(item));
+      record.user = _code(userOf(item));
+      record.type = _code(typeOf(item));
+      record.timestamp = timeOf(item).millisecondsSinceEpoch;
+      record.version = versionOf(item);
+    }
+  }
+
+  /// 依次应用原生侧输出的 [count] 个操作。
+  void _apply(int count) {
+    if (count == 0) return;
+    final ops = _ops.value;
+    for (int i = 0; i < count; i++) {
+      final op = (ops + i).ref;
+      if (op.scope == 0) {
+        if (op.kind == _kOpInsert) {
+          _order.insert(op.index, op.key);
+        } else if (op.kind == _kOpRemove) {
+          _order.removeAt(op.index);
+          _items.remove(op.key);
+        }
+        continue;
+      }
+      final groups = _groups[op.scope - 1];
+      final key = _name(op.key);
+      if (op.kind == _kOpInsert) {
+        groups.insert(op.index, key);
+      } else if (op.kind == _kOpRemove) {
+        groups.removeAt(op.index);
+      }
+      _members[op.scope - 1].remove(key); // 组内条目或条数有变化
+    }
+  }
+
+  /// Dart 实现：按时间倒序重排整条时间线并重新分组。
+  void _rebuild() {
+    _order
+      ..clear()
+      ..addAll(_items.keys);
+    _order.sort((a, b) {
+      final byTime = timeOf(_items[b] as T).compareTo(timeOf(_items[a] as T));
+      return byTime != 0 ? byTime : b.compareTo(a);
+    });
+    for (final grouping in NativeFeedGrouping.values) {
+      final seen = <String>{};
+      final groups = _groups[grouping.index]..clear();
+      _members[grouping.index].clear();
+      for (final code in _order) {
+        final item = _items[code] as T;
+        final key =
+            grouping == NativeFeedGrouping.byUser ? userOf(item) : typeOf(item);
+        if (seen.add(key)) groups.add(key);
+      }
+    }
+  }
+}
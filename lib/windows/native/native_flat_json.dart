@@ -0,0 +1,307 @@
+// lib/windows/native/native_flat_json.dart
+
+/// 该文件定义了 NativeFlatJson，原生 JSON 解码（runner 中的 ParseFlatJson）的 FFI 绑定。
+/// 原生侧用 SIMD 扫描后把整个文档写成一块扁平的二进制布局（定长节点加字符串区），
+/// Dart 侧通过 [FlatJsonMap]、[FlatJsonList] 按需读取字段：只有真正被访问的字符串
+/// 才会解码，解码时不构建中间的 `Map<String, dynamic>` 树。
+/// 两个视图实现了 Map/List 接口，现有的 `fromJson(Map<String, dynamic>)` 可以直接使用。
+library;
+
+import 'dart:collection'; // ListBase、UnmodifiableMapBase
+import 'dart:convert'; // UTF-8 与 JSON 回退
+import 'dart:ffi'; // FFI
+import 'dart:typed_data'; // ByteData、Uint8List
+import 'package:ffi/ffi.dart'; // 内存分配
+import 'package:flutter/foundation.dart'; // 平台判断所需
+
+typedef _ParseNative = Pointer<Uint8> Function(
+    Pointer<Uint8>, Int64, Pointer<Int64>, Pointer<Int64>);
+typedef _ParseDart = Pointer<Uint8> Function(
+    Pointer<Uint8>, int, Pointer<Int64>, Pointer<Int64>);
+
+/// runner.exe 导出的函数。
+class _Bindings {
+  final _ParseDart parse;
+  final Pointer<NativeFinalizerFunction> freePointer; // 释放 parse 返回的缓冲区
+
+  _Bindings(DynamicLibrary library)
+      : parse = library.lookupFunction<_ParseNative, _ParseDart>(
+            'runner_json_parse',
+            isLeaf: true),
+        freePointer =
+            library.lookup<NativeFinalizerFunction>('runner_json_free');
+
+  static _Bindings? _instance; // 符号只查找一次
+  static bool _loadFailed = false; // 旧版本 runner 没有导出这些符号
+
+  static _Bindings? get instance {
+    if (_instance != null || _loadFailed) return _instance;
+    try {
+      _instance = _Bindings(DynamicLibrary.executable());
+    } catch (_) {
+      _loadFailed = true;
+    }
+    return _instance;
+  }
+}
+
+// 与 runner 中 flat_json.h 的布局一致
+const int _kMagic = 0x4A465853; // "SXFJ"
+const int _kHeaderSize = 16;
+const int _kNodeSize = 16;
+const int _kTypeNull = 0;
+const int _kTypeFalse = 1;
+const int _kTypeTrue = 2;
+const int _kTypeInt = 3;
+const int _kTypeDouble = 4;
+const int _kTypeString = 5;
+const int _kTypeArray = 6;
+const int _kTypeObject = 7;
+
+/// `FlatJsonDocument` 类：一次解码的结果，持有原生缓冲区。
+///
+/// 缓冲区在文档和从它取出的所有视图都不可达后由 GC 释放。
+class FlatJsonDocument {
+  final Uint8List _bytes; // 整个扁平布局，直接引用原生内存
+  final ByteData _data; // 读取定长字段
+  final int _nodeCount; // 节点数
+  final int _stringsOffset; // 字符串区在缓冲区中的偏移
+  final Map<int, String> _keys = {}; // 键在字符串区中去重，按偏移缓存解码结果
+
+  FlatJsonDocument._(this._bytes, this._data)
+      : _nodeCount = _data.getUint32(4, Endian.little),
+        _stringsOffset =
+            _kHeaderSize + _data.getUint32(4, Endian.little) * _kNodeSize;
+
+  /// 缓冲区字节数。
+  int get sizeInBytes => _bytes.length;
+
+  /// 节点数。
+  int get nodeCount => _nodeCount;
+
+  /// 根值：[FlatJsonMap]、[FlatJsonList]、String、int、double、bool 或 null。
+  dynamic get root => _value(0);
+
+  int _type(int node) => _bytes[_kHeaderSize + node * _kNodeSize];
+
+  int _a(int node) =>
+      _data.getUint32(_kHeaderSize + node * _kNodeSize + 4, Endian.little);
+
+  int _b(int node) =>
+      _data.getInt64(_kHeaderSize + node * _kNodeSize + 8, Endian.little);
+
+  /// [node] 之后的第一个兄弟节点，容器跳过整个子树。
+  int _next(int node) {
+    final type = _type(node);
+    return type == _kTypeArray || type == _kTypeObject ? _b(node) : node + 1;
+  }
+
+  String _string(int node) {
+    final start = _stringsOffset + _b(node);
+    return utf8.decode(
+        Uint8List.sublistView(_bytes, start, start + _a(node)),
+        allowMalformed: true);
+  }
+
+  String _key(int node) => _keys[_b(node)] ??= _string(node);
+
+  dynamic _value(int node) {
+    switch (_type(node)) {
+      case _kTypeNull:
+        return null;
+      case _kTypeFalse:
+        return false;
+      case _kTypeTrue:
+        return true;
+      case _kTypeInt:
+        return _b(node);
+      case _kTypeDouble:
+        return _data.getFloat64(
+            _kHeaderSize + node * _kNodeSize + 8, Endian.little);
+      case _kTypeString:
+        return _string(node);
+      case _kTypeArray:
+        return FlatJsonList._(this, node);
+      case _kTypeObject:
+        return FlatJsonMap._(this, node);
+    }
+    throw StateError('Unknown flat JSON node type ${_type(node)}');
+  }
+}
+
+/// `FlatJsonMap` 类：JSON 对象的只读视图。
+///
+/// 按键查找是对键值对的线性扫描，从上一次命中的位置之后开始，
+/// `fromJson` 按字段顺序读取时每次查找通常只比较一两个键。
+class FlatJsonMap extends UnmodifiableMapBase<String, dynamic> {
+  final FlatJsonDocument _document;
+  final int _node; // 对象节点的下标
+  int _cursorPair = 0; // 上一次命中之后的键值对序号
+  int _cursorNode = -1; // 对应的键节点下标，-1 表示从头开始
+
+  FlatJsonMap._(this._document, this._node);
+
+  @override
+  int get length => _document._a(_node);
+
+  @override
+  bool get isEmpty => length == 0;
+
+  @override
+  bool get isNotEmpty => length != 0;
+
+  @override
+  Iterable<String> get keys sync* {
+    final document = _document;
+    int keyNode = _node + 1;
+    for (int i = 0; i < length; i++) {
+      yield document._key(keyNode);
+      keyNode = document._next(keyNode + 1);
+    }
+  }
+
+  @override
+  dynamic operator [](Object? key) {
+    final valueNode = _find(key);
+    return valueNode < 0 ? null : _document._value(valueNode);
+  }
+
+  @override
+  bool containsKey(Object? key) => _find(key) >= 0;
+
+  /// 返回 [key] 对应的值节点下标，不存在时返回 -1。
+  int _find(Object? key) {
+    if (key is! String) return -1;
+    final document = _document;
+    final count = length;
+    if (_cursorNode < 0 || _cursorPair >= count) {
+      _cursorPair = 0;
+      _cursorNode = _node + 1;
+    }
+    int pair = _cursorPair;
+    int keyNode = _cursorNode;
+    for (int checked = 0; checked < count; checked++) {
+      final valueNode = keyNode + 1;
+      final nextKeyNode = document._next(valueNode);
+      if (document._key(keyNode) == key) {
+        _cursorPair = pair + 1;
+        _cursorNode = nextKeyNode;
+        return valueNode;
+      }
+      pair++;
+      keyNode = nextKeyNode;
+      if (pair == count) {
+        pair = 0;
+        keyNode = _node + 1;
+      }
+    }
+    return -1;
+  }
+}
+
+/// `FlatJsonList` 类：JSON 数组的只读视图。
+///
+/// 元素是变长的子树，按下标访问时从上一次访问的位置向后走，
+/// 顺序遍历的总开销和元素个数成正比。
+class FlatJsonList extends ListBase<dynamic> {
+  final FlatJsonDocument _document;
+  final int _node; // 数组节点的下标
+  int _cursorIndex = 0; // 上一次访问的元素序号
+  int _cursorNode; // 对应的节点下标
+
+  FlatJsonList._(this._document, this._node) : _cursorNode = _node + 1;
+
+  @override
+  int get length => _document._a(_node);
+
+  @override
+  set length(int newLength) {
+    throw UnsupportedError('Cannot change the length of a flat JSON list');
+  }
+
+  @override
+  dynamic operator [](int index) {
+    RangeError.checkValidIndex(index, this);
+    if (index < _cursorIndex) {
+      _cursorIndex = 0;
+      _cursorNode = _node + 1;
+    }
+    while (_cursorIndex < index) {
+      _cursorNode = _document._next(_cursorNode);
+      _cursorIndex++;
+    }
+    return _document._value(_cursorNode);
+  }
+
+  @override
+  void operator []=(int index, dynamic value) {
+    throw UnsupportedError('Cannot modify a flat JSON list');
+  }
+
+  @override
+  Iterator<dynamic> get iterator => _FlatJsonListIterator(this);
+}
+
+/// 顺序遍历数组，不依赖下标访问的游标。
+class _FlatJsonListIterator implements Iterator<dynamic> {
+  final FlatJsonList _list;
+  int _remaining; // 剩余元素数
+  int _nextNode; // 下一个元素的节点下标
+  dynamic _current;
+
+  _FlatJsonListIterator(this._list)
+      : _remaining = _list.length,
+        _nextNode = _list._node + 1;
+
+  @override
+  dynamic get current => _current;
+
+  @override
+  bool moveNext() {
+    if (_remaining == 0) {
+      _current = null;
+      return false;
+    }
+    final document = _list._document;
+    _current = document._value(_nextNode);
+    _nextNode = document._next(_nextNode);
+    _remaining--;
+    return true;
+  }
+}
+
+/// `NativeFlatJson` 类：原生 JSON 解码入口。
+class NativeFlatJson {
+  static Pointer<Int64>? _outputs; // 复用的输出参数：[大小, 出错位置]
+
+  /// 当前平台是否可以使用原生解码。
+  static bool get isSupported =>
+      !kIsWeb && defaultTargetPlatform == TargetPlatform.windows;
+
+  /// 解码 UTF-8 编码的 [bytes]。原生解码不可用或 [bytes] 不是有效的 JSON
+  /// 时返回 null。
+  static FlatJsonDocument? parse(Uint8List bytes) {
+    if (!isSupported || bytes.isEmpty) return null;
+    final bindings = _Bindings.instance;
+    if (bindings == null) return null;
+    final outputs = _outputs ??= calloc<Int64>(2);
+    // 叶子调用，原生侧直接读取 Dart 堆上的字节，不复制输入
+    final data = bindings.parse(bytes.address, bytes.length, outputs,
+        outputs + 1);
+    if (data == nullptr) return null;
+    final buffer =
+        data.asTypedList(outputs.value, finalizer: bindings.freePointer);
+    final view = ByteData.sublistView(buffer);
+    if (view.getUint32(0, Endian.little) != _kMagic) return null;
+    return FlatJsonDocument._(buffer, view);
+  }
+
+  /// 解码 UTF-8 编码的 [bytes]，结果与 `json.fuse(utf8).decode` 相同，
+  /// 但对象和数组是惰性的只读视图。原生解码不可用或失败时回退到 Dart 的
+  /// 解码器，无效的 JSON 同样抛出 [FormatException]。
+  static dynamic decode(Uint8List bytes) {
+    final document = parse(bytes);
+    if (document != null) return document.root;
+    return json.fuse(utf8).decode(bytes);
+  }
+}
@@ -0,0 +1,298 @@
+// lib/windows/native/native_game_store.dart
+
+/// 该文件定义了 NativeGameStore，原生游戏列式存储（runner 中的 GameColumnStore）的 FFI 绑定。
+/// 原生侧只保存排序和筛选用到的字段（创建/更新时间、浏览、点赞、评分、分类、标签），
+/// 分类和标签用 Roaring 位图索引，每个排序字段维护排好的排列；
+/// 游戏列表切换筛选、排序或翻页时，先用本地已知的游戏在几十微秒内给出一页。
+library;
+
+import 'dart:collection'; // LinkedHashMap
+import 'dart:convert'; // UTF-8
+import 'dart:ffi'; // FFI
+import 'dart:typed_data'; // Uint8List
+import 'package:ffi/ffi.dart'; // 内存分配
+import 'package:flutter/foundation.dart'; // 平台判断所需
+import 'package:suxingchahui/models/common/pagination.dart'; // 分页信息
+import 'package:suxingchahui/models/game/game/game.dart'; // 游戏模型
+import 'package:suxingchahui/models/game/game/game_list_pagination.dart'; // 查询结果
+import 'package:suxingchahui/windows/native/native_object_id.dart'; // 游戏 ID 句柄
+
+/// 与 runner 中 RunnerGameRecord 的布局一致。
+final class _RunnerGameRecord extends Struct {
+  @Uint32()
+  external int handle;
+  @Int32()
+  external int reserved;
+  @Int64()
+  external int createTime;
+  @Int64()
+  external int updateTime;
+  @Int64()
+  external int viewCount;
+  @Int64()
+  external int likeCount;
+  @Double()
+  external double rating;
+  external Pointer<Uint8> category;
+  @Int64()
+  external int categoryLength;
+  external Pointer<Uint8> tags;
+  @Int64()
+  external int tagsLength;
+}
+
+/// 与 runner 中 RunnerGameQuery 的布局一致。
+final class _RunnerGameQuery extends Struct {
+  external Pointer<Uint8> category;
+  @Int64()
+  external int categoryLength;
+  external Pointer<Uint8> tag;
+  @Int64()
+  external int tagLength;
+  @Int32()
+  external int sortKey;
+  @Int32()
+  external int descending;
+  @Int64()
+  external int offset;
+}
+
+/// 与 runner 中 RunnerGameStats 的布局一致。
+final class _RunnerGameStats extends Struct {
+  @Int64()
+  external int games;
+  @Int64()
+  external int labels;
+  @Int64()
+  external int indexBytes;
+}
+
+typedef _UpsertNative = Void Function(Pointer<_RunnerGameRecord>, Int32);
+typedef _UpsertDart = void Function(Pointer<_RunnerGameRecord>, int);
+typedef _RemoveNative = Int32 Function(Uint32);
+typedef _RemoveDart = int Function(int);
+typedef _ClearNative = Void Function();
+typedef _ClearDart = void Function();
+typedef _QueryNative = Int32 Function(
+    Pointer<_RunnerGameQuery>, Pointer<Uint32>, Int32, Pointer<Int64>);
+typedef _QueryDart = int Function(
+    Pointer<_RunnerGameQuery>, Pointer<Uint32>, int, Pointer<Int64>);
+typedef _StatsNative = Void Function(Pointer<_RunnerGameStats>);
+typedef _StatsDart = void Function(Pointer<_RunnerGameStats>);
+
+/// runner.exe 导出的函数，都不会回调 Dart，按叶子调用查找。
+class _Bindings {
+  final _UpsertDart upsert;
+  final _RemoveDart remove;
+  final _ClearDart clear;
+  final _QueryDart query;
+  final _StatsDart stats;
+
+  _Bindings(DynamicLibrary library)
+      : upsert = library.lookupFunction<_UpsertNative, _UpsertDart>(
+            'runner_games_upsert',
+            isLeaf: true),
+        remove = library.lookupFunction<_RemoveNative, _RemoveDart>(
+            'runner_games_remove',
+            isLeaf: true),
+        clear = library.lookupFunction<_ClearNative, _ClearDart>(
+            'runner_games_clear',
+            isLeaf: true),
+        query = library.lookupFunction<_QueryNative, _QueryDart>(
+            'runner_games_query',
+            isLeaf: true),
+        stats = library.lookupFunction<_StatsNative, _StatsDart>(
+            'runner_games_stats',
+            isLeaf: true);
+
+  static _Bindings? _instance; // 符号只查找一次
+  static bool _loadFailed = false; // 旧版本 runner 没有导出这些符号
+
+  static _Bindings? get instance {
+    if (_instance != null || _loadFailed) return _instance;
+    try {
+      _instance = _Bindings(DynamicLibrary.executable());
+    } catch (_) {
+      _loadFailed = true;
+    }
+    return _instance;
+  }
+}
+
+/// `NativeGameStoreStats` 类：列式存储统计。
+class NativeGameStoreStats {
+  final int games; // 游戏数
+  final int labels; // 不同的分类和标签数
+  final int indexBytes; // 位图和排列占用的字节数
+
+  const NativeGameStoreStats({
+    required this.games,
+    required this.labels,
+    required this.indexBytes,
+  });
+}
+
+/// `NativeGameStore` 类：本地已知游戏的筛选、排序和分页。
+///
+/// 游戏对象按句柄保存在 Dart 侧，超过 [capacity] 时淘汰最早放入的。
+/// 查询只覆盖本地见过的游戏，结果用于在服务器返回之前先显示，
+/// 不代替服务器的分页。
+class NativeGameStore {
+  static const int capacity = 20000;
+
+  // 与 runner 中 GameSortKey 的取值一致
+  static const Map<String, int> _sortKeys = {
+    Game.sortByCreateTime: 0,
+    Game.sortByUpdateTime: 1,
+    Game.sortByViewCount: 2,
+    Game.sortByRating: 3,
+    Game.jsonKeyLikeCount: 4,
+  };
+
+  static final LinkedHashMap<int, Game> _games =
+      LinkedHashMap(); // 句柄到游戏，按放入顺序
+  static Pointer<Uint32>? _handles; // 复用的查询结果缓冲区
+  static int _handleCapacity = 0;
+
+  /// 当前平台是否可以使用原生存储。
+  static bool get isSupported =>
+      !kIsWeb && defaultTargetPlatform == TargetPlatform.windows;
+
+  static _Bindings? get _bindings => isSupported ? _Bindings.instance : null;
+
+  /// 是否可以在本地按 [sortBy] 排序。
+  static bool canSortBy(String sortBy) => _sortKeys.containsKey(sortBy);
+
+  /// 放入或更新游戏。
+  static void putAll(List<Game> games) {
+    final bindings = _bindings;
+    if (bindings == null || games.isEmpty) return;
+    final handles = NativeObjectIdTable.internAll([
+      for (final game in games) game.id,
+    ]);
+    using((arena) {
+      final records = arena<_RunnerGameRecord>(games.length);
+      int count = 0;
+      for (int i = 0; i < games.length; i++) {
+        final handle = handles[i];
+        if (handle == NativeObjectIdTable.invalidHandle) continue;
+        final game = games[i];
+        final record = (records + count).ref;
+        record.handle = handle;
+        record.createTime = game.createTime.millisecondsSinceEpoch;
+        record.updateTime = game.updateTime.millisecondsSinceEpoch;
+        record.viewCount = game.viewCount;
+        record.likeCount = game.likeCount;
+        record.rating = game.rating;
+        final category = utf8.encode(game.category);
+        record.category = _copy(arena, category);
+        record.categoryLength = category.length;
+        final tags = utf8.encode(game.tags.join('\u0000'));
+        record.tags = _copy(arena, tags);
+        record.tagsLength = tags.length;
+        count++;
+        _games.remove(handle);
+        _games[handle] = game;
+      }
+      bindings.upsert(records, count);
+    });
+    while (_games.length > capacity) {
+      final oldest = _games.keys.first;
+      _games.remove(oldest);
+      bindings.remove(oldest);
+    }
+  }
+
+  /// 游戏被删除时调用。
+  static void remove(String id) {
+    final bindings = _bindings;
+    if (bindings == null) return;
+    final handle = NativeObjectIdTable.find(id);
+    if (handle == NativeObjectIdTable.invalidHandle) return;
+    _games.remove(handle);
+    bindings.remove(handle);
+  }
+
+  static void clear() {
+    _games.clear();
+    _bindings?.clear();
+  }
+
+  /// 按筛选和排序返回本地已知游戏的第 [page] 页（从 1 开始）。
+  /// 不支持的平台、不支持的排序字段或本地没有符合条件的游戏时返回 null。
+  static GameListPagination? query({
+    String? category,
+    String? tag,
+    required String sortBy,
+    required bool descending,
+    required int page,
+    required int pageSize,
+  }) {
+    final bindings = _bindings;
+    final sortKey = _sortKeys[sortBy];
+    if (bindings == null || sortKey == null || page < 1 || pageSize <= 0) {
+      return null;
+    }
+    if (_handleCapacity < pageSize) {
+      if (_handles != null) calloc.free(_handles!);
+      _handles = calloc<Uint32>(pageSize);
+      _handleCapacity = pageSize;
+    }
+    final output = _handles!;
+    return using((arena) {
+      final query = arena<_RunnerGameQuery>();
+      final categoryBytes = utf8.encode(category ?? '');
+      query.ref.category = _copy(arena, categoryBytes);
+      query.ref.categoryLength = categoryBytes.length;
+      final tagBytes = utf8.encode(tag ?? '');
+      query.ref.tag = _copy(arena, tagBytes);
+      query.ref.tagLength = tagBytes.length;
+      query.ref.sortKey = sortKey;
+      query.ref.descending = descending ? 1 : 0;
+      query.ref.offset = (page - 1) * pageSize;
+      final total = arena<Int64>();
+      final count = bindings.query(query, output, pageSize, total);
+      if (count == 0) return null;
+      final games = <Game>[];
+      for (int i = 0; i < count; i++) {
+        final game = _games[output[i]];
+        if (game != null) games.add(game);
+      }
+      return GameListPagination(
+        games: games,
+        pagination: PaginationData(
+          page: page,
+          limit: pageSize,
+          total: total.value,
+          pages: (total.value + pageSize - 1) ~/ pageSize,
+        ),
+        categoryName: category,
+        tag: tag,
+      );
+    });
+  }
+
+  /// 读取统计，不支持的平台上返回 null。
+  static NativeGameStoreStats? stats() {
+    final bindings = _bindings;
+    if (bindings == null) return null;
+    final stats = calloc<_RunnerGameStats>();
+    try {
+      bindings.stats(stats);
+      return NativeGameStoreStats(
+        games: stats.ref.games,
+        labels: stats.ref.labels,
+        indexBytes: stats.ref.indexBytes,
+      );
+    } finally {
+      calloc.free(stats);
+    }
+  }
+
+  static Pointer<Uint8> _copy(Arena arena, Uint8List bytes) {
+    if (bytes.isEmpty) return nullptr;
+    final pointer = arena<Uint8>(bytes.length);
+    pointer.asTypedList(bytes.length).setAll(0, bytes);
+    return pointer;
+  }
+}
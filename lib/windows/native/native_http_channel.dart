@@ -0,0 +1,115 @@
+// lib/windows/native/native_http_channel.dart
+
+/// 该文件定义了 NativeHttpChannel，通过原生 WinHTTP 连接池发送 HTTP 请求。
+/// 原生侧在启动检查窗口阶段就会对上次访问过的主机预热连接，
+/// 首批请求可以直接复用已经完成 TLS 握手的连接。
+library;
+
+import 'package:flutter/foundation.dart'; // 平台判断所需
+import 'package:flutter/services.dart'; // MethodChannel
+import 'package:suxingchahui/windows/native/native_flat_json.dart'; // 原生 JSON 解码
+
+/// `NativeHttpResponse` 类：原生请求的响应。
+class NativeHttpResponse {
+  final int statusCode; // 状态码
+  final Map<String, List<String>> headers; // 响应头，名称为小写
+  final Uint8List body; // 响应体
+
+  const NativeHttpResponse({
+    required this.statusCode,
+    required this.headers,
+    required this.body,
+  });
+
+  /// 取响应头 [name] 的第一个值。
+  String? header(String name) => headers[name.toLowerCase()]?.first;
+
+  /// 把响应体解码为 JSON，对象和数组是原生解码结果的只读视图。
+  dynamic decodeJson() => NativeFlatJson.decode(body);
+}
+
+/// `NativeHttpStats` 类：连接池统计。
+class NativeHttpStats {
+  final int opened; // 新建的连接数
+  final int reused; // 复用空闲连接的次数
+  final int evicted; // 因空闲超时关闭的连接数
+  final int failed; // 失败的请求数
+
+  const NativeHttpStats({
+    required this.opened,
+    required this.reused,
+    required this.evicted,
+    required this.failed,
+  });
+}
+
+/// `NativeHttpChannel` 类：原生 HTTP 连接池的 Dart 端入口。
+///
+/// 仅在 Windows 上可用，调用前先检查 [isSupported]。
+class NativeHttpChannel {
+  static const MethodChannel _channel =
+      MethodChannel('com.example.suxingchahui/http'); // 原生通道
+
+  /// 当前平台是否可以使用原生 HTTP。
+  static bool get isSupported =>
+      !kIsWeb && defaultTargetPlatform == TargetPlatform.windows;
+
+  /// 保存下次启动时需要预热的地址（只取 scheme、host 和端口）。
+  static Future<bool> configurePrewarmOrigins(List<String> origins) async {
+    if (!isSupported) return false;
+    try {
+      return await _channel.invokeMethod<bool>(
+              'configurePrewarm', {'origins': origins}) ??
+          false;
+    } catch (_) {
+      return false; // 预热只是优化，失败时忽略
+    }
+  }
+
+  /// 立即在后台为 [origins] 预热连接，不等待完成。
+  static Future<void> prewarm(List<String> origins) async {
+    if (!isSupported) return;
+    try {
+      await _channel.invokeMethod<void>('prewarm', {'origins': origins});
+    } catch (_) {
+      // 预热只是优化，失败时忽略
+    }
+  }
+
+  /// 发送请求。网络错误或证书校验失败时抛出 [PlatformException]。
+  static Future<NativeHttpResponse> request(
+    String method,
+    Uri url, {
+    Map<String, String>? headers,
+    Uint8List? body,
+    Duration timeout = const Duration(seconds: 15),
+  }) async {
+    final result = await _channel.invokeMapMethod<String, dynamic>('request', {
+      'method': method,
+      'url': url.toString(),
+      'headers': headers ?? const <String, String>{},
+      'body': body,
+      'timeoutMillis': timeout.inMilliseconds,
+    });
+    final rawHeaders = (result?['headers'] as Map?) ?? const {}; // 原始响应头
+    return NativeHttpResponse(
+      statusCode: result?['statusCode'] as int? ?? 0,
+      headers: rawHeaders.map((key, value) => MapEntry(
+          key as String, (value as List).cast<String>().toList())),
+      body: result?['body'] as Uint8List? ?? Uint8List(0),
+    );
+  }
+
+  /// 读取连接池统计。
+  static Future<NativeHttpStats?> stats() async {
+    if (!isSupported) return null;
+    final result = await _channel.invokeMapMethod<String, int>('stats');
+    if (result == null) return null;
+    return NativeHttpStats(
+      opened: result['opened'] ?? 0,
+      reused: result['reused'] ?? 0,
+      evicted: result['evicted'] ?? 0,
+      failed: result['failed'] ?? 0,
+    );
+  }
+}
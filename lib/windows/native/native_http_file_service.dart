@@ -0,0 +1,99 @@
+// lib/windows/native/native_http_file_service.dart
+
+/// 该文件定义了 NativeHttpFileService，让 flutter_cache_manager 的下载走原生 HTTP 连接池。
+/// 图片请求会复用启动阶段预热好的连接；本次运行中访问过的图片主机会被保存，
+/// 下次启动时在检查窗口阶段预热。
+library;
+
+import 'dart:async'; // 异步操作所需
+import 'package:flutter_cache_manager/flutter_cache_manager.dart'; // FileService 接口
+import 'package:suxingchahui/windows/native/native_http_channel.dart'; // 原生 HTTP 通道
+
+/// `NativeHttpFileService` 类：基于 [NativeHttpChannel] 的 [FileService]。
+///
+/// 仅在 Windows 上可用，调用前先检查 [NativeHttpChannel.isSupported]。
+class NativeHttpFileService extends FileService {
+  static const int _maxPrewarmOrigins = 4; // 最多保存的预热地址数
+  static const Duration _defaultMaxAge = Duration(days: 7); // 响应未给出 max-age 时的有效期
+
+  final Set<String> _origins = {}; // 本次运行访问过的地址（scheme://host:port）
+
+  @override
+  Future<FileServiceResponse> get(String url,
+      {Map<String, String>? headers}) async {
+    final uri = Uri.parse(url);
+    final response = await NativeHttpChannel.request('GET', uri,
+        headers: headers, timeout: const Duration(seconds: 30));
+    if (response.statusCode == 200) {
+      _rememberOrigin(uri);
+    }
+    return _NativeHttpGetResponse(response, DateTime.now());
+  }
+
+  void _rememberOrigin(Uri uri) {
+    if (_origins.length >= _maxPrewarmOrigins) return;
+    if (!_origins.add(uri.origin)) return;
+    unawaited(NativeHttpChannel.configurePrewarmOrigins(_origins.toList()));
+  }
+
+  /// 按 Cache-Control 的 max-age 计算有效期，no-cache 和 no-store 视为立即过期。
+  static DateTime _validTill(NativeHttpResponse response, DateTime received) {
+    var maxAge = _defaultMaxAge;
+    final cacheControl = response.header('cache-control');
+    if (cacheControl != null) {
+      for (final directive in cacheControl.split(',')) {
+        final value = directive.trim().toLowerCase();
+        if (value == 'no-cache' || value == 'no-store') {
+          maxAge = Duration.zero;
+        } else if (value.startsWith('max-age=')) {
+          final seconds = int.tryParse(value.substring('max-age='.length));
+          if (seconds != null) maxAge = Duration(seconds: seconds);
+        }
+      }
+    }
+    return received.add(maxAge);
+  }
+}
+
+/// `_NativeHttpGetResponse` 类：把原生响应适配为 [FileServiceResponse]。
+class _NativeHttpGetResponse implements FileServiceResponse {
+  final NativeHttpResponse _response; // 原生响应
+  final DateTime _received; // 收到响应的时间
+
+  _NativeHttpGetResponse(this._response, this._received);
+
+  @override
+  Stream<List<int>> get content => Stream.value(_response.body);
+
+  @override
+  int? get contentLength => _response.body.length;
+
+  @override
+  int get statusCode => _response.statusCode;
+
+  @override
+  DateTime get validTill =>
+      NativeHttpFileService._validTill(_response, _received);
+
+  @override
+  String? get eTag => _response.header('etag');
+
+  @override
+  String get fileExtension {
+    final contentType = _response.header('content-type');
+    if (contentType == null) return '';
+    final mimeType = contentType.split(';').first.trim().toLowerCase();
+    const extensions = {
+      'image/jpeg': '.jpg',
+      'image/png': '.png',
+      'image/gif': '.gif',
+      'image/webp': '.webp',
+      'image/bmp': '.bmp',
+      'image/svg+xml': '.svg',
+    };
+    final known = extensions[mimeType];
+    if (known != null) return known;
+    final slash = mimeType.indexOf('/');
+    return slash < 0 ? '' : '.${mimeType.substring(slash + 1)}';
+  }
+}
@@ -0,0 +1,115 @@
+// lib/windows/native/native_image_pipeline.dart
+
+/// 该文件定义了 NativeImagePipeline，在原生后台线程上解码、裁剪和编码图片。
+/// 裁剪对话框只拿到预览像素和最终的文件字节，UI 线程上不做任何图片处理。
+library;
+
+import 'dart:async'; // Completer
+import 'dart:ui' as ui; // decodeImageFromPixels
+import 'package:flutter/foundation.dart'; // 平台判断所需
+import 'package:flutter/services.dart'; // MethodChannel
+
+/// `NativeImageSession` 类：原生侧已解码的一张图片。
+///
+/// 原图保留在原生内存中，用完后必须调用 [close]。
+class NativeImageSession {
+  final int id; // 原生会话 ID
+  final int width; // 原图宽度（已按 EXIF 方向摆正）
+  final int height; // 原图高度
+  final String format; // 原图格式：jpeg、png 或 other
+  final ui.Image preview; // 缩小后的预览图，用于交互显示
+
+  const NativeImageSession._({
+    required this.id,
+    required this.width,
+    required this.height,
+    required this.format,
+    required this.preview,
+  });
+
+  /// 裁剪 [region] 并编码，[region] 为原图宽高的比例（0-1）。
+  ///
+  /// [maxOutputSize] 为输出的最长边，不传时按原图分辨率输出。
+  /// [format] 为 `jpeg` 或 `png`，JPEG 会合成到白色背景上。
+  Future<Uint8List> crop(
+    ui.Rect region, {
+    int? maxOutputSize,
+    bool circle = true,
+    String format = 'png',
+    int quality = 90,
+  }) async {
+    final bytes = await NativeImagePipeline._channel.invokeMethod<Uint8List>(
+      'crop',
+      {
+        'session': id,
+        'left': region.left,
+        'top': region.top,
+        'width': region.width,
+        'height': region.height,
+        if (maxOutputSize != null) 'maxOutputSize': maxOutputSize,
+        'circle': circle,
+        'format': format,
+        'quality': quality,
+      },
+    );
+    return bytes ?? Uint8List(0);
+  }
+
+  /// 释放原生侧的原图和预览图。
+  Future<void> close() async {
+    preview.dispose();
+    try {
+      await NativeImagePipeline._channel
+          .invokeMethod<void>('close', {'session': id});
+    } catch (_) {
+      // 窗口关闭时通道可能已经不可用
+    }
+  }
+}
+
+/// `NativeImagePipeline` 类：原生图片管线的 Dart 端入口。
+///
+/// 仅在 Windows 上可用，调用前先检查 [isSupported]。
+class NativeImagePipeline {
+  static const MethodChannel _channel =
+      MethodChannel('com.example.suxingchahui/image'); // 原生通道
+
+  /// 当前平台是否可以使用原生图片管线。
+  static bool get isSupported =>
+      !kIsWeb && defaultTargetPlatform == TargetPlatform.windows;
+
+  /// 解码 [path] 或 [bytes] 指向的图片，预览图最长边不超过 [previewMaxDimension]。
+  ///
+  /// 无法解码时抛出 [PlatformException]。
+  static Future<NativeImageSession> open({
+    String? path,
+    Uint8List? bytes,
+    int previewMaxDimension = 2048,
+  }) async {
+    final reply = await _channel.invokeMapMethod<String, Object?>('open', {
+      if (path != null) 'path': path,
+      if (bytes != null) 'bytes': bytes,
+      'previewMaxDimension': previewMaxDimension,
+    });
+    if (reply == null) {
+      throw PlatformException(code: 'decode_failed', message: 'Empty reply');
+    }
+    final int previewWidth = reply['previewWidth'] as int;
+    final int previewHeight = reply['previewHeight'] as int;
+    final Completer<ui.Image> completer = Completer();
+    ui.decodeImageFromPixels(
+      reply['preview'] as Uint8List,
+      previewWidth,
+      previewHeight,
+      ui.PixelFormat.bgra8888,
+      completer.complete,
+    );
+    return NativeImageSession._(
+      id: reply['session'] as int,
+      width: reply['width'] as int,
+      height: reply['height'] as int,
+      format: reply['format'] as String,
+      preview: await completer.future,
+    );
+  }
+}
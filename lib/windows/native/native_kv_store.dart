@@ -0,0 +1,304 @@
+// lib/windows/native/native_kv_store.dart
+
+/// 该文件定义了 NativeKvStore，原生日志结构键值存储（runner 中的 KvStore）的 FFI 绑定。
+/// 值以二进制原样存取，列表页缓存读出来就是 JSON 字节，解码后直接得到
+/// `Map<String, dynamic>`，不再需要把 Hive 返回的 `Map<dynamic, dynamic>` 逐层转换。
+library;
+
+import 'dart:async'; // StreamController
+import 'dart:convert'; // UTF-8 与 JSON
+import 'dart:ffi'; // FFI
+import 'dart:typed_data'; // Uint8List
+import 'package:ffi/ffi.dart'; // UTF-8 字符串与内存分配
+import 'package:flutter/foundation.dart'; // 平台判断所需
+
+/// 与 runner 中 RunnerKvStats 的布局一致。
+final class _RunnerKvStats extends Struct {
+  @Int64()
+  external int entries;
+  @Int64()
+  external int liveBytes;
+  @Int64()
+  external int deadBytes;
+  @Int64()
+  external int fileBytes;
+  @Int64()
+  external int compactions;
+}
+
+typedef _ChangeCallbackNative = Void Function(Pointer<Uint8>, Int32, Int32);
+
+typedef _OpenNative = Pointer<Void> Function(Pointer<Utf8>);
+typedef _OpenDart = Pointer<Void> Function(Pointer<Utf8>);
+typedef _GetNative = Pointer<Uint8> Function(
+    Pointer<Void>, Pointer<Utf8>, Pointer<Int64>);
+typedef _GetDart = Pointer<Uint8> Function(
+    Pointer<Void>, Pointer<Utf8>, Pointer<Int64>);
+typedef _PutNative = Int32 Function(
+    Pointer<Void>, Pointer<Utf8>, Pointer<Uint8>, Int64);
+typedef _PutDart = int Function(
+    Pointer<Void>, Pointer<Utf8>, Pointer<Uint8>, int);
+typedef _RemoveNative = Int32 Function(Pointer<Void>, Pointer<Utf8>);
+typedef _RemoveDart = int Function(Pointer<Void>, Pointer<Utf8>);
+typedef _RemovePrefixNative = Int64 Function(Pointer<Void>, Pointer<Utf8>);
+typedef _RemovePrefixDart = int Function(Pointer<Void>, Pointer<Utf8>);
+typedef _KeysNative = Pointer<Uint8> Function(
+    Pointer<Void>, Pointer<Utf8>, Int32, Pointer<Int64>);
+typedef _KeysDart = Pointer<Uint8> Function(
+    Pointer<Void>, Pointer<Utf8>, int, Pointer<Int64>);
+typedef _SubscribeNative = Int64 Function(Pointer<Void>, Pointer<Utf8>,
+    Pointer<NativeFunction<_ChangeCallbackNative>>);
+typedef _SubscribeDart = int Function(Pointer<Void>, Pointer<Utf8>,
+    Pointer<NativeFunction<_ChangeCallbackNative>>);
+typedef _UnsubscribeNative = Void Function(Pointer<Void>, Int64);
+typedef _UnsubscribeDart = void Function(Pointer<Void>, int);
+typedef _FlushNative = Void Function(Pointer<Void>);
+typedef _FlushDart = void Function(Pointer<Void>);
+typedef _CompactNative = Int32 Function(Pointer<Void>);
+typedef _CompactDart = int Function(Pointer<Void>);
+typedef _StatsNative = Void Function(Pointer<Void>, Pointer<_RunnerKvStats>);
+typedef _StatsDart = void Function(Pointer<Void>, Pointer<_RunnerKvStats>);
+typedef _FreeNative = Void Function(Pointer<Void>);
+typedef _FreeDart = void Function(Pointer<Void>);
+
+/// runner.exe 导出的函数。
+class _Bindings {
+  final _OpenDart open;
+  final _GetDart get;
+  final _PutDart put;
+  final _RemoveDart remove;
+  final _RemovePrefixDart removePrefix;
+  final _KeysDart keys;
+  final _SubscribeDart subscribe;
+  final _UnsubscribeDart unsubscribe;
+  final _FlushDart flush;
+  final _CompactDart compact;
+  final _StatsDart stats;
+  final _FreeDart free;
+  final Pointer<NativeFinalizerFunction> freePointer; // 释放 get 返回的值
+
+  _Bindings(DynamicLibrary library)
+      : open = library.lookupFunction<_OpenNative, _OpenDart>('runner_kv_open'),
+        get = library.lookupFunction<_GetNative, _GetDart>('runner_kv_get'),
+        put = library.lookupFunction<_PutNative, _PutDart>('runner_kv_put'),
+        remove = library
+            .lookupFunction<_RemoveNative, _RemoveDart>('runner_kv_remove'),
+        removePrefix =
+            library.lookupFunction<_RemovePrefixNative, _RemovePrefixDart>(
+                'runner_kv_remove_prefix'),
+        keys = library.lookupFunction<_KeysNative, _KeysDart>('runner_kv_keys'),
+        subscribe = library.lookupFunction<_SubscribeNative, _SubscribeDart>(
+            'runner_kv_subscribe'),
+        unsubscribe =
+            library.lookupFunction<_UnsubscribeNative, _UnsubscribeDart>(
+                'runner_kv_unsubscribe'),
+        flush =
+            library.lookupFunction<_FlushNative, _FlushDart>('runner_kv_flush'),
+        compact = library
+            .lookupFunction<_CompactNative, _CompactDart>('runner_kv_compact'),
+        stats =
+            library.lookupFunction<_StatsNative, _StatsDart>('runner_kv_stats'),
+        free = library.lookupFunction<_FreeNative, _FreeDart>('runner_kv_free'),
+        freePointer = library.lookup<NativeFinalizerFunction>('runner_kv_free');
+
+  static _Bindings? _instance; // 符号只查找一次
+  static bool _loadFailed = false; // 旧版本 runner 没有导出这些符号
+
+  static _Bindings? get instance {
+    if (_instance != null || _loadFailed) return _instance;
+    try {
+      _instance = _Bindings(DynamicLibrary.executable());
+    } catch (_) {
+      _loadFailed = true;
+    }
+    return _instance;
+  }
+}
+
+/// `NativeKvChange` 类：一次键变化。字段与 Hive 的 BoxEvent 对应。
+class NativeKvChange {
+  final String key; // 发生变化的键
+  final bool deleted; // 是否为删除
+
+  const NativeKvChange(this.key, this.deleted);
+
+  @override
+  String toString() => 'NativeKvChange($key, deleted: $deleted)';
+}
+
+/// `NativeKvStats` 类：存储统计。
+class NativeKvStats {
+  final int entries; // 键数量
+  final int liveBytes; // 存活记录占用的日志字节数
+  final int deadBytes; // 等待压缩回收的字节数
+  final int fileBytes; // 日志有效长度
+  final int compactions; // 本次运行的压缩次数
+
+  const NativeKvStats({
+    required this.entries,
+    required this.liveBytes,
+    required this.deadBytes,
+    required this.fileBytes,
+    required this.compactions,
+  });
+}
+
+/// `NativeKvStore` 类：一个按名称打开的原生键值存储。
+///
+/// 读写都是同步的 FFI 调用：写入只是追加到内存映射的日志，读取是一次有序
+/// 索引查找加一次复制。同名存储在原生侧只打开一次，句柄在进程退出前一直
+/// 有效，因此不需要关闭；runner 在引擎关闭后会把数据写回磁盘。
+class NativeKvStore {
+  final _Bindings _bindings;
+  final Pointer<Void> _handle; // 原生 KvStore*
+  final Pointer<Int64> _size; // 复用的长度输出参数
+
+  static final Map<String, NativeKvStore> _opened = {}; // 同名只包装一次
+
+  NativeKvStore._(this._bindings, this._handle) : _size = calloc<Int64>();
+
+  /// 当前平台是否可以使用原生存储。
+  static bool get isSupported =>
+      !kIsWeb && defaultTargetPlatform == TargetPlatform.windows;
+
+  /// 打开名为 [name] 的存储，失败或平台不支持时返回 null。
+  static NativeKvStore? open(String name) {
+    final opened = _opened[name];
+    if (opened != null) return opened;
+    if (!isSupported) return null;
+    final bindings = _Bindings.instance;
+    if (bindings == null) return null;
+    final handle = using(
+        (arena) => bindings.open(name.toNativeUtf8(allocator: arena)));
+    if (handle == nullptr) return null;
+    return _opened[name] = NativeKvStore._(bindings, handle);
+  }
+
+  /// 读取 [key] 的值，未命中时返回 null。
+  ///
+  /// 返回的字节直接引用原生内存，由 GC 回收时释放，不再复制一次。
+  Uint8List? getBytes(String key) {
+    final data = using((arena) =>
+        _bindings.get(_handle, key.toNativeUtf8(allocator: arena), _size));
+    if (data == nullptr) return null;
+    return data.asTypedList(_size.value, finalizer: _bindings.freePointer);
+  }
+
+  /// 写入 [key]，返回是否成功。
+  bool putBytes(String key, Uint8List value) {
+    return using((arena) {
+      final data = arena<Uint8>(value.isEmpty ? 1 : value.length);
+      data.asTypedList(value.length).setAll(0, value);
+      return _bindings.put(_handle, key.toNativeUtf8(allocator: arena), data,
+              value.length) !=
+          0;
+    });
+  }
+
+  /// 读取以 UTF-8 JSON 保存的值，未命中或解析失败时返回 null。
+  Object? getJson(String key) {
+    final bytes = getBytes(key);
+    if (bytes == null) return null;
+    try {
+      return json.fuse(utf8).decode(bytes);
+    } catch (_) {
+      return null;
+    }
+  }
+
+  /// 以 UTF-8 JSON 保存 [value]。
+  bool putJson(String key, Object? value) {
+    return putBytes(key, utf8.encode(jsonEncode(value)));
+  }
+
+  /// 是否存在 [key]。
+  bool containsKey(String key) => keys(key, limit: 1).contains(key);
+
+  /// 移除 [key]，返回是否存在。
+  bool remove(String key) {
+    return using((arena) =>
+        _bindings.remove(_handle, key.toNativeUtf8(allocator: arena)) != 0);
+  }
+
+  /// 移除所有以 [prefix] 开头的键，返回移除的数量。
+  int removePrefix(String prefix) {
+    return using((arena) => _bindings.removePrefix(
+        _handle, prefix.toNativeUtf8(allocator: arena)));
+  }
+
+  /// 按字典序返回以 [prefix] 开头的键，[limit] 为 0 时不限数量。
+  List<String> keys(String prefix, {int limit = 0}) {
+    final data = using((arena) => _bindings.keys(
+        _handle, prefix.toNativeUtf8(allocator: arena), limit, _size));
+    if (data == nullptr) return const [];
+    try {
+      final bytes = data.asTypedList(_size.value);
+      final result = <String>[];
+      int start = 0;
+      for (int i = 0; i < bytes.length; i++) {
+        if (bytes[i] != 0) continue;
+        result.add(utf8.decode(Uint8List.sublistView(bytes, start, i)));
+        start = i + 1;
+      }
+      return result;
+    } finally {
+      _bindings.free(data.cast());
+    }
+  }
+
+  /// 监听以 [prefix] 开头的键的变化（空字符串表示全部）。
+  ///
+  /// 原生侧在写入时回调，事件异步送达当前 isolate。取消订阅后不再收到事件。
+  Stream<NativeKvChange> watch({String prefix = ''}) {
+    NativeCallable<_ChangeCallbackNative>? callable;
+    int subscription = 0;
+    late final StreamController<NativeKvChange> controller;
+    controller = StreamController<NativeKvChange>(
+      onListen: () {
+        callable = NativeCallable<_ChangeCallbackNative>.listener(
+            (Pointer<Uint8> key, int length, int deleted) {
+          try {
+            if (!controller.isClosed) {
+              controller.add(NativeKvChange(
+                  utf8.decode(key.asTypedList(length)), deleted != 0));
+            }
+          } finally {
+            _bindings.free(key.cast());
+          }
+        });
+        subscription = using((arena) => _bindings.subscribe(_handle,
+            prefix.toNativeUtf8(allocator: arena), callable!.nativeFunction));
+      },
+      onCancel: () {
+        // 先取消原生订阅，之后原生侧不会再调用这个函数指针
+        if (subscription != 0) _bindings.unsubscribe(_handle, subscription);
+        callable?.close();
+        callable = null;
+      },
+    );
+    return controller.stream;
+  }
+
+  /// 把已修改的数据写回磁盘。
+  void flush() => _bindings.flush(_handle);
+
+  /// 立即压缩日志，返回是否成功。写入时会在需要时自动压缩。
+  bool compact() => _bindings.compact(_handle) != 0;
+
+  /// 读取统计。
+  NativeKvStats stats() {
+    final stats = calloc<_RunnerKvStats>();
+    try {
+      _bindings.stats(_handle, stats);
+      return NativeKvStats(
+        entries: stats.ref.entries,
+        liveBytes: stats.ref.liveBytes,
+        deadBytes: stats.ref.deadBytes,
+        fileBytes: stats.ref.fileBytes,
+        compactions: stats.ref.compactions,
+      );
+    } finally {
+      calloc.free(stats);
+    }
+  }
+}
@@ -0,0 +1,204 @@
+// lib/windows/native/native_object_id.dart
+
+/// 该文件定义了 NativeObjectIdTable，原生 ObjectId 驻留表（runner 中的 ObjectIdTable）的 FFI 绑定。
+/// 每个 ObjectId 在原生侧只存 12 字节，并对应一个从 1 开始的 32 位句柄，
+/// 原生缓存和索引用句柄作为键；Dart 侧只在需要展示或发请求时才格式化成 24 位字符串。
+library;
+
+import 'dart:ffi'; // FFI
+import 'dart:typed_data'; // Uint32List
+import 'package:ffi/ffi.dart'; // 内存分配
+import 'package:flutter/foundation.dart'; // 平台判断所需
+import 'package:mongo_dart/mongo_dart.dart' as mongo; // 非 Windows 平台生成 ID
+
+/// 与 runner 中 RunnerOidStats 的布局一致。
+final class _RunnerOidStats extends Struct {
+  @Int64()
+  external int count;
+  @Int64()
+  external int memoryBytes;
+}
+
+typedef _InternNative = Uint32 Function(Pointer<Uint8>, Int32);
+typedef _InternDart = int Function(Pointer<Uint8>, int);
+typedef _InternBatchNative = Void Function(
+    Pointer<Uint8>, Int32, Pointer<Uint32>);
+typedef _InternBatchDart = void Function(Pointer<Uint8>, int, Pointer<Uint32>);
+typedef _FormatNative = Int32 Function(Uint32, Pointer<Uint8>);
+typedef _FormatDart = int Function(int, Pointer<Uint8>);
+typedef _TimestampNative = Int64 Function(Uint32);
+typedef _TimestampDart = int Function(int);
+typedef _GenerateNative = Uint32 Function(Pointer<Uint8>);
+typedef _GenerateDart = int Function(Pointer<Uint8>);
+typedef _StatsNative = Void Function(Pointer<_RunnerOidStats>);
+typedef _StatsDart = void Function(Pointer<_RunnerOidStats>);
+
+/// runner.exe 导出的函数，都不会回调 Dart，按叶子调用查找。
+class _Bindings {
+  final _InternDart intern;
+  final _InternBatchDart internBatch;
+  final _InternDart find;
+  final _FormatDart format;
+  final _TimestampDart timestamp;
+  final _GenerateDart generate;
+  final _StatsDart stats;
+
+  _Bindings(DynamicLibrary library)
+      : intern = library.lookupFunction<_InternNative, _InternDart>(
+            'runner_oid_intern',
+            isLeaf: true),
+        internBatch =
+            library.lookupFunction<_InternBatchNative, _InternBatchDart>(
+                'runner_oid_intern_batch',
+                isLeaf: true),
+        find = library.lookupFunction<_InternNative, _InternDart>(
+            'runner_oid_find',
+            isLeaf: true),
+        format = library.lookupFunction<_FormatNative, _FormatDart>(
+            'runner_oid_format',
+            isLeaf: true),
+        timestamp = library.lookupFunction<_TimestampNative, _TimestampDart>(
+            'runner_oid_timestamp',
+            isLeaf: true),
+        generate = library.lookupFunction<_GenerateNative, _GenerateDart>(
+            'runner_oid_generate',
+            isLeaf: true),
+        stats = library.lookupFunction<_StatsNative, _StatsDart>(
+            'runner_oid_stats',
+            isLeaf: true);
+
+  static _Bindings? _instance; // 符号只查找一次
+  static bool _loadFailed = false; // 旧版本 runner 没有导出这些符号
+
+  static _Bindings? get instance {
+    if (_instance != null || _loadFailed) return _instance;
+    try {
+      _instance = _Bindings(DynamicLibrary.executable());
+    } catch (_) {
+      _loadFailed = true;
+    }
+    return _instance;
+  }
+}
+
+/// `NativeObjectIdStats` 类：驻留表统计。
+class NativeObjectIdStats {
+  final int count; // 已驻留的 ObjectId 数
+  final int memoryBytes; // 原生侧占用的字节数
+
+  const NativeObjectIdStats({required this.count, required this.memoryBytes});
+}
+
+/// `NativeObjectIdTable` 类：进程内共享的 ObjectId 驻留表。
+///
+/// 句柄 0 表示无效。句柄在进程退出前一直有效，可以在任意 isolate 上使用。
+class NativeObjectIdTable {
+  static const int invalidHandle = 0;
+  static const int _hexLength = 24;
+
+  static Pointer<Uint8>? _hex; // 复用的 24 字节十六进制缓冲区
+
+  /// 当前平台是否可以使用原生驻留表。
+  static bool get isSupported =>
+      !kIsWeb && defaultTargetPlatform == TargetPlatform.windows;
+
+  static _Bindings? get _bindings => isSupported ? _Bindings.instance : null;
+
+  /// 非 ASCII 字符写成 0，避免截断成有效的十六进制字符。
+  static int _asciiAt(String hex, int index) {
+    final unit = hex.codeUnitAt(index);
+    return unit < 0x80 ? unit : 0;
+  }
+
+  /// 把 [hex] 写入复用的缓冲区，长度不对时返回 null。
+  static Pointer<Uint8>? _writeHex(String hex) {
+    if (hex.length != _hexLength) return null;
+    final buffer = _hex ??= calloc<Uint8>(_hexLength);
+    for (int i = 0; i < _hexLength; i++) {
+      buffer[i] = _asciiAt(hex, i);
+    }
+    return buffer;
+  }
+
+  /// 返回 [hex] 的句柄，不存在时驻留。[hex] 不是有效的 ObjectId 时返回 0。
+  static int intern(String hex) {
+    final bindings = _bindings;
+    final buffer = _writeHex(hex);
+    if (bindings == null || buffer == null) return invalidHandle;
+    return bindings.intern(buffer, _hexLength);
+  }
+
+  /// 一次驻留多个 ObjectId，返回与 [hexes] 一一对应的句柄。
+  static Uint32List internAll(List<String> hexes) {
+    final handles = Uint32List(hexes.length);
+    final bindings = _bindings;
+    if (bindings == null || hexes.isEmpty) return handles;
+    using((arena) {
+      final buffer = arena<Uint8>(hexes.length * _hexLength);
+      for (int i = 0; i < hexes.length; i++) {
+        final hex = hexes[i];
+        // 长度不对的项写入无效字符，原生侧返回句柄 0
+        for (int j = 0; j < _hexLength; j++) {
+          buffer[i * _hexLength + j] =
+              hex.length == _hexLength ? _asciiAt(hex, j) : 0;
+        }
+      }
+      final output = arena<Uint32>(hexes.length);
+      bindings.internBatch(buffer, hexes.length, output);
+      handles.setAll(0, output.asTypedList(hexes.length));
+    });
+    return handles;
+  }
+
+  /// 返回 [hex] 的句柄，未驻留或无效时返回 0。
+  static int find(String hex) {
+    final bindings = _bindings;
+    final buffer = _writeHex(hex);
+    if (bindings == null || buffer == null) return invalidHandle;
+    return bindings.find(buffer, _hexLength);
+  }
+
+  /// 把 [handle] 格式化为 24 位小写十六进制字符串，句柄无效时返回 null。
+  static String? format(int handle) {
+    final bindings = _bindings;
+    if (bindings == null) return null;
+    final buffer = _hex ??= calloc<Uint8>(_hexLength);
+    if (bindings.format(handle, buffer) == 0) return null;
+    return String.fromCharCodes(buffer.asTypedList(_hexLength));
+  }
+
+  /// ObjectId 内嵌的创建时间（UTC），句柄无效时返回 null。
+  static DateTime? timestamp(int handle) {
+    final bindings = _bindings;
+    if (bindings == null) return null;
+    final seconds = bindings.timestamp(handle);
+    if (seconds < 0) return null;
+    return DateTime.fromMillisecondsSinceEpoch(seconds * 1000, isUtc: true);
+  }
+
+  /// 生成新的 ObjectId 并返回十六进制形式。原生侧会同时驻留它；
+  /// 不支持的平台上使用 mongo_dart 生成。
+  static String generateHex() {
+    final bindings = _bindings;
+    if (bindings == null) return mongo.ObjectId().oid;
+    final buffer = _hex ??= calloc<Uint8>(_hexLength);
+    bindings.generate(buffer);
+    return String.fromCharCodes(buffer.asTypedList(_hexLength));
+  }
+
+  /// 读取统计，不支持的平台上返回 null。
+  static NativeObjectIdStats? stats() {
+    final bindings = _bindings;
+    if (bindings == null) return null;
+    final stats = calloc<_RunnerOidStats>();
+    try {
+      bindings.stats(stats);
+      return NativeObjectIdStats(
+        count: stats.ref.count,
+        memoryBytes: stats.ref.memoryBytes,
+      );
+    } finally {
+      calloc.free(stats);
+    }
+  }
+}
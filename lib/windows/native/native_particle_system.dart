@@ -0,0 +1,388 @@
+// lib/windows/native/native_particle_system.dart
+
+/// 该文件定义了 NativeParticleSystem，原生粒子模拟（runner 中的 ParticleSystem）的 FFI 绑定。
+/// 粒子的积分在原生侧用 SIMD 批量完成，并直接写出 drawRawAtlas 需要的数组，
+/// Dart 侧通过零拷贝视图一次画完所有粒子，每帧没有逐粒子的 Dart 代码和对象分配。
+library;
+
+import 'dart:ffi'; // FFI
+import 'dart:typed_data'; // Float32List、Int32List
+import 'dart:ui' as ui; // Image、PictureRecorder
+import 'package:ffi/ffi.dart'; // 内存分配
+import 'package:flutter/foundation.dart'; // 平台判断所需
+import 'package:flutter/painting.dart'; // Canvas、Color、Rect
+
+/// 与 runner 中 RunnerParticleBehavior 的布局一致。
+final class _RunnerParticleBehavior extends Struct {
+  @Float()
+  external double drag;
+  @Float()
+  external double jitter;
+  @Float()
+  external double spin;
+  @Float()
+  external double opacityDecay;
+  @Float()
+  external double sizeDecay;
+  @Float()
+  external double minOpacity;
+  @Float()
+  external double minSize;
+  @Int32()
+  external int wrap;
+  @Float()
+  external double riseMin;
+  @Float()
+  external double riseMax;
+  @Float()
+  external double sizeMin;
+  @Float()
+  external double sizeMax;
+  @Float()
+  external double opacityMin;
+  @Float()
+  external double opacityMax;
+}
+
+/// 与 runner 中 RunnerParticleSpawn 的布局一致。
+final class _RunnerParticleSpawn extends Struct {
+  @Float()
+  external double x;
+  @Float()
+  external double y;
+  @Float()
+  external double vx;
+  @Float()
+  external double vy;
+  @Float()
+  external double rise;
+  @Float()
+  external double size;
+  @Float()
+  external double opacity;
+  @Float()
+  external double angle;
+  @Uint32()
+  external int color;
+  @Uint32()
+  external int shape;
+}
+
+typedef _CreateNative = Pointer<Void> Function(Int32, Uint32);
+typedef _CreateDart = Pointer<Void> Function(int, int);
+typedef _HandleNative = Void Function(Pointer<Void>);
+typedef _HandleDart = void Function(Pointer<Void>);
+typedef _SetBehaviorNative = Void Function(
+    Pointer<Void>, Pointer<_RunnerParticleBehavior>);
+typedef _SetBehaviorDart = void Function(
+    Pointer<Void>, Pointer<_RunnerParticleBehavior>);
+typedef _SetPaletteNative = Void Function(
+    Pointer<Void>, Pointer<Uint32>, Int32);
+typedef _SetPaletteDart = void Function(Pointer<Void>, Pointer<Uint32>, int);
+typedef _SetSpritesNative = Void Function(
+    Pointer<Void>, Pointer<Float>, Int32, Float);
+typedef _SetSpritesDart = void Function(
+    Pointer<Void>, Pointer<Float>, int, double);
+typedef _ScatterNative = Void Function(Pointer<Void>, Int32, Float, Float);
+typedef _ScatterDart = void Function(Pointer<Void>, int, double, double);
+typedef _SpawnNative = Void Function(
+    Pointer<Void>, Pointer<_RunnerParticleSpawn>, Int32);
+typedef _SpawnDart = void Function(
+    Pointer<Void>, Pointer<_RunnerParticleSpawn>, int);
+typedef _StepNative = Int32 Function(Pointer<Void>, Float, Float, Float);
+typedef _StepDart = int Function(Pointer<Void>, double, double, double);
+typedef _FloatArrayNative = Pointer<Float> Function(Pointer<Void>);
+typedef _FloatArrayDart = Pointer<Float> Function(Pointer<Void>);
+typedef _ColorArrayNative = Pointer<Int32> Function(Pointer<Void>);
+typedef _ColorArrayDart = Pointer<Int32> Function(Pointer<Void>);
+
+/// runner.exe 导出的函数。
+class _Bindings {
+  final _CreateDart create;
+  final _HandleDart destroy;
+  final _SetBehaviorDart setBehavior;
+  final _SetPaletteDart setPalette;
+  final _SetSpritesDart setSprites;
+  final _ScatterDart scatter;
+  final _SpawnDart spawn;
+  final _HandleDart clear;
+  final _StepDart step;
+  final _FloatArrayDart transforms;
+  final _FloatArrayDart rects;
+  final _ColorArrayDart colors;
+
+  _Bindings(DynamicLibrary library)
+      : create = library.lookupFunction<_CreateNative, _CreateDart>(
+            'runner_particles_create'),
+        destroy = library.lookupFunction<_HandleNative, _HandleDart>(
+            'runner_particles_destroy'),
+        setBehavior =
+            library.lookupFunction<_SetBehaviorNative, _SetBehaviorDart>(
+                'runner_particles_set_behavior'),
+        setPalette = library.lookupFunction<_SetPaletteNative, _SetPaletteDart>(
+            'runner_particles_set_palette'),
+        setSprites = library.lookupFunction<_SetSpritesNative, _SetSpritesDart>(
+            'runner_particles_set_sprites'),
+        scatter = library.lookupFunction<_ScatterNative, _ScatterDart>(
+            'runner_particles_scatter'),
+        spawn = library.lookupFunction<_SpawnNative, _SpawnDart>(
+            'runner_particles_spawn'),
+        clear = library.lookupFunction<_HandleNative, _HandleDart>(
+            'runner_particles_clear'),
+        step = library.lookupFunction<_StepNative, _StepDart>(
+            'runner_particles_step'),
+        transforms = library.lookupFunction<_FloatArrayNative, _FloatArrayDart>(
+            'runner_particles_transforms'),
+        rects = library.lookupFunction<_FloatArrayNative, _FloatArrayDart>(
+            'runner_particles_rects'),
+        colors = library.lookupFunction<_ColorArrayNative, _ColorArrayDart>(
+            'runner_particles_colors');
+
+  static _Bindings? _instance; // 符号只查找一次
+  static bool _loadFailed = false; // 旧版本 runner 没有导出这些符号
+
+  static _Bindings? get instance {
+    if (_instance != null || _loadFailed) return _instance;
+    try {
+      _instance = _Bindings(DynamicLibrary.executable());
+    } catch (_) {
+      _loadFailed = true;
+    }
+    return _instance;
+  }
+}
+
+/// `NativeParticleBehavior` 类：粒子的运动规则，数值都是每帧（1/60 秒）的量。
+class NativeParticleBehavior {
+  final double drag; // 速度每帧的乘数
+  final double jitter; // X 速度每帧的随机扰动幅度
+  final double spin; // 角度每帧的增量（弧度）
+  final double opacityDecay; // 不透明度每帧的乘数
+  final double sizeDecay; // 尺寸每帧的乘数
+  final double minOpacity; // 低于此值时回收（wrap 为 false）
+  final double minSize; // 低于此值时回收（wrap 为 false）
+  final bool wrap; // 从顶部飘出后在底部重生，左右循环
+  final double riseMin; // 以下为 scatter 和重生时的随机范围
+  final double riseMax;
+  final double sizeMin;
+  final double sizeMax;
+  final double opacityMin;
+  final double opacityMax;
+
+  const NativeParticleBehavior({
+    this.drag = 1.0,
+    this.jitter = 0.0,
+    this.spin = 0.0,
+    this.opacityDecay = 1.0,
+    this.sizeDecay = 1.0,
+    this.minOpacity = 0.0,
+    this.minSize = 0.0,
+    this.wrap = false,
+    this.riseMin = 0.0,
+    this.riseMax = 0.0,
+    this.sizeMin = 1.0,
+    this.sizeMax = 1.0,
+    this.opacityMin = 1.0,
+    this.opacityMax = 1.0,
+  });
+}
+
+/// `NativeParticleAtlas` 类：粒子精灵图集。
+///
+/// 每种形状占一个边长为 2 * [radius] 的格子，以格子中心为锚点，用白色绘制，
+/// 绘制时再由粒子颜色着色（[BlendMode.modulate]）。
+class NativeParticleAtlas {
+  final ui.Image image; // 图集位图
+  final List<Rect> rects; // 每种形状在图集中的位置
+  final double radius; // 精灵的半边长，对应粒子尺寸 1.0
+
+  NativeParticleAtlas._(this.image, this.rects, this.radius);
+
+  /// 依次调用 [painters] 在各自格子中心（画布原点）绘制半径为 [radius] 的形状。
+  factory NativeParticleAtlas.build(
+    List<void Function(Canvas canvas, double radius)> painters, {
+    double radius = 16.0,
+  }) {
+    final cell = radius * 2;
+    final recorder = ui.PictureRecorder();
+    final canvas = Canvas(recorder);
+    final rects = <Rect>[];
+    for (int i = 0; i < painters.length; i++) {
+      rects.add(Rect.fromLTWH(i * cell, 0, cell, cell));
+      canvas.save();
+      canvas.translate(i * cell + radius, radius);
+      painters[i](canvas, radius);
+      canvas.restore();
+    }
+    final picture = recorder.endRecording();
+    final image =
+        picture.toImageSync((cell * painters.length).ceil(), cell.ceil());
+    picture.dispose();
+    return NativeParticleAtlas._(image, rects, radius);
+  }
+
+  void dispose() => image.dispose();
+}
+
+/// `NativeParticleSystem` 类：一个固定容量的原生粒子池。
+///
+/// 只能在 UI 线程上使用，不再需要时必须调用 [dispose]。
+class NativeParticleSystem {
+  final _Bindings _bindings;
+  final Pointer<Void> _handle; // 原生 ParticleSystem*
+  final Pointer<_RunnerParticleSpawn> _spawn; // 复用的生成参数缓冲区
+  final Float32List _transforms; // 原生绘制数组的视图，长度按容量
+  final Float32List _rects;
+  final Int32List _colors;
+  final Paint _paint = Paint();
+  int _count = 0; // 最近一次 step 后存活的粒子数
+  bool _disposed = false;
+
+  NativeParticleSystem._(this._bindings, this._handle, int capacity)
+      : _spawn = calloc<_RunnerParticleSpawn>(),
+        _transforms =
+            _bindings.transforms(_handle).asTypedList(capacity * 4),
+        _rects = _bindings.rects(_handle).asTypedList(capacity * 4),
+        _colors = _bindings.colors(_handle).asTypedList(capacity);
+
+  /// 当前平台是否可以使用原生粒子。
+  static bool get isSupported =>
+      !kIsWeb && defaultTargetPlatform == TargetPlatform.windows;
+
+  /// 创建容量为 [capacity] 的粒子池，失败或平台不支持时返回 null。
+  static NativeParticleSystem? create(int capacity, {int seed = 0}) {
+    if (!isSupported || capacity <= 0) return null;
+    final bindings = _Bindings.instance;
+    if (bindings == null) return null;
+    final handle =
+        bindings.create(capacity, seed != 0 ? seed : _defaultSeed());
+    if (handle == nullptr) return null;
+    return NativeParticleSystem._(bindings, handle, capacity);
+  }
+
+  static int _defaultSeed() =>
+      DateTime.now().microsecondsSinceEpoch & 0xFFFFFFFF;
+
+  /// 存活的粒子数。
+  int get count => _count;
+
+  /// 设置运动规则。
+  void setBehavior(NativeParticleBehavior behavior) {
+    final native = calloc<_RunnerParticleBehavior>();
+    try {
+      native.ref
+        ..drag = behavior.drag
+        ..jitter = behavior.jitter
+        ..spin = behavior.spin
+        ..opacityDecay = behavior.opacityDecay
+        ..sizeDecay = behavior.sizeDecay
+        ..minOpacity = behavior.minOpacity
+        ..minSize = behavior.minSize
+        ..wrap = behavior.wrap ? 1 : 0
+        ..riseMin = behavior.riseMin
+        ..riseMax = behavior.riseMax
+        ..sizeMin = behavior.sizeMin
+        ..sizeMax = behavior.sizeMax
+        ..opacityMin = behavior.opacityMin
+        ..opacityMax = behavior.opacityMax;
+      _bindings.setBehavior(_handle, native);
+    } finally {
+      calloc.free(native);
+    }
+  }
+
+  /// 设置 scatter 和重生时随机选取的颜色。
+  void setPalette(List<Color> colors) {
+    final native = calloc<Uint32>(colors.length);
+    try {
+      for (int i = 0; i < colors.length; i++) {
+        native[i] = colors[i].toARGB32();
+      }
+      _bindings.setPalette(_handle, native, colors.length);
+    } finally {
+      calloc.free(native);
+    }
+  }
+
+  /// 设置精灵图集，粒子的 shape 为 [atlas] 中形状的下标。
+  void setSprites(NativeParticleAtlas atlas) {
+    final native = calloc<Float>(atlas.rects.length * 4);
+    try {
+      for (int i = 0; i < atlas.rects.length; i++) {
+        final rect = atlas.rects[i];
+        native[i * 4] = rect.left;
+        native[i * 4 + 1] = rect.top;
+        native[i * 4 + 2] = rect.right;
+        native[i * 4 + 3] = rect.bottom;
+      }
+      _bindings.setSprites(_handle, native, atlas.rects.length, atlas.radius);
+    } finally {
+      calloc.free(native);
+    }
+  }
+
+  /// 清空后在 [area] 内随机生成 [count] 个粒子。
+  void scatter(int count, Size area) {
+    _bindings.scatter(_handle, count, area.width, area.height);
+  }
+
+  /// 生成一个粒子。池满时替换最暗的粒子。
+  void spawn({
+    required Offset position,
+    Offset velocity = Offset.zero,
+    double rise = 0.0,
+    required double size,
+    double opacity = 1.0,
+    double angle = 0.0,
+    required Color color,
+    int shape = 0,
+  }) {
+    _spawn.ref
+      ..x = position.dx
+      ..y = position.dy
+      ..vx = velocity.dx
+      ..vy = velocity.dy
+      ..rise = rise
+      ..size = size
+      ..opacity = opacity
+      ..angle = angle
+      ..color = color.toARGB32()
+      ..shape = shape;
+    _bindings.spawn(_handle, _spawn, 1);
+  }
+
+  /// 移除所有粒子。
+  void clear() {
+    _bindings.clear(_handle);
+    _count = 0;
+  }
+
+  /// 前进 [frames] 帧（60fps 下的帧数，可以是小数），返回存活的粒子数。
+  int step(double frames, Size area) {
+    _count = _bindings.step(_handle, frames, area.width, area.height);
+    return _count;
+  }
+
+  /// 用 [atlas] 在 [canvas] 上绘制最近一次 [step] 的结果。
+  void paint(Canvas canvas, NativeParticleAtlas atlas) {
+    if (_count == 0) return;
+    // drawRawAtlas 会复制数组，下一次 step 覆盖原生数组不影响已录制的画面
+    canvas.drawRawAtlas(
+      atlas.image,
+      Float32List.sublistView(_transforms, 0, _count * 4),
+      Float32List.sublistView(_rects, 0, _count * 4),
+      Int32List.sublistView(_colors, 0, _count),
+      BlendMode.modulate,
+      null,
+      _paint,
+    );
+  }
+
+  /// 释放原生粒子池。之后不能再调用其他方法。
+  void dispose() {
+    if (_disposed) return;
+    _disposed = true;
+    _bindings.destroy(_handle);
+    calloc.free(_spawn);
+  }
+}
@@ -0,0 +1,311 @@
+// lib/windows/native/native_search_index.dart
+
+/// 该文件定义了 NativeSearchIndex，原生全文索引（runner 中的 SearchIndex）的 FFI 绑定，
+/// 以及在它之上按 ObjectId 保存条目的 [NativeSearchCorpus]。
+/// 索引对中文按单字和相邻两字切分、对拉丁文按词切分，结果按 BM25 排序，
+/// 搜索页用它在请求服务器之前先从本地已有的游戏和帖子中给出结果。
+library;
+
+import 'dart:collection'; // LinkedHashMap
+import 'dart:convert'; // UTF-8
+import 'dart:ffi'; // FFI
+import 'dart:typed_data'; // Uint8List
+import 'package:ffi/ffi.dart'; // 内存分配
+import 'package:flutter/foundation.dart'; // 平台判断所需
+import 'package:suxingchahui/windows/native/native_object_id.dart'; // 文档 ID
+
+/// 与 runner 中 RunnerSearchField 的布局一致。
+final class _RunnerSearchField extends Struct {
+  external Pointer<Uint8> text;
+  @Int64()
+  external int length;
+  @Float()
+  external double weight;
+}
+
+/// 与 runner 中 RunnerSearchHit 的布局一致。
+final class _RunnerSearchHit extends Struct {
+  @Uint32()
+  external int id;
+  @Float()
+  external double score;
+}
+
+/// 与 runner 中 RunnerSearchStats 的布局一致。
+final class _RunnerSearchStats extends Struct {
+  @Int64()
+  external int documents;
+  @Int64()
+  external int deleted;
+  @Int64()
+  external int terms;
+  @Int64()
+  external int postingBytes;
+  @Int64()
+  external int compactions;
+}
+
+typedef _OpenNative = Pointer<Void> Function(Pointer<Utf8>);
+typedef _OpenDart = Pointer<Void> Function(Pointer<Utf8>);
+typedef _UpsertNative = Int32 Function(
+    Pointer<Void>, Uint32, Pointer<_RunnerSearchField>, Int32);
+typedef _UpsertDart = int Function(
+    Pointer<Void>, int, Pointer<_RunnerSearchField>, int);
+typedef _RemoveNative = Int32 Function(Pointer<Void>, Uint32);
+typedef _RemoveDart = int Function(Pointer<Void>, int);
+typedef _ClearNative = Void Function(Pointer<Void>);
+typedef _ClearDart = void Function(Pointer<Void>);
+typedef _QueryNative = Int32 Function(
+    Pointer<Void>, Pointer<Uint8>, Int64, Pointer<_RunnerSearchHit>, Int32);
+typedef _QueryDart = int Function(
+    Pointer<Void>, Pointer<Uint8>, int, Pointer<_RunnerSearchHit>, int);
+typedef _StatsNative = Void Function(Pointer<Void>, Pointer<_RunnerSearchStats>);
+typedef _StatsDart = void Function(Pointer<Void>, Pointer<_RunnerSearchStats>);
+
+/// runner.exe 导出的函数，都不会回调 Dart，按叶子调用查找。
+class _Bindings {
+  final _OpenDart open;
+  final _UpsertDart upsert;
+  final _RemoveDart remove;
+  final _ClearDart clear;
+  final _QueryDart query;
+  final _StatsDart stats;
+
+  _Bindings(DynamicLibrary library)
+      : open = library.lookupFunction<_OpenNative, _OpenDart>(
+            'runner_search_open',
+            isLeaf: true),
+        upsert = library.lookupFunction<_UpsertNative, _UpsertDart>(
+            'runner_search_upsert',
+            isLeaf: true),
+        remove = library.lookupFunction<_RemoveNative, _RemoveDart>(
+            'runner_search_remove',
+            isLeaf: true),
+        clear = library.lookupFunction<_ClearNative, _ClearDart>(
+            'runner_search_clear',
+            isLeaf: true),
+        query = library.lookupFunction<_QueryNative, _QueryDart>(
+            'runner_search_query',
+            isLeaf: true),
+        stats = library.lookupFunction<_StatsNative, _StatsDart>(
+            'runner_search_stats',
+            isLeaf: true);
+
+  static _Bindings? _instance; // 符号只查找一次
+  static bool _loadFailed = false; // 旧版本 runner 没有导出这些符号
+
+  static _Bindings? get instance {
+    if (_instance != null || _loadFailed) return _instance;
+    try {
+      _instance = _Bindings(DynamicLibrary.executable());
+    } catch (_) {
+      _loadFailed = true;
+    }
+    return _instance;
+  }
+}
+
+/// `NativeSearchField` 类：文档的一个字段。
+class NativeSearchField {
+  final String text;
+  final double weight; // 标题等字段可以给更高的权重
+
+  const NativeSearchField(this.text, {this.weight = 1.0});
+}
+
+/// `NativeSearchHit` 类：一条搜索结果。
+class NativeSearchHit {
+  final int handle; // NativeObjectIdTable 的句柄
+  final double score; // BM25 得分
+
+  const NativeSearchHit({required this.handle, required this.score});
+}
+
+/// `NativeSearchStats` 类：索引统计。
+class NativeSearchStats {
+  final int documents; // 存活文档数
+  final int deleted; // 等待压缩的文档数
+  final int terms; // 词数
+  final int postingBytes; // 倒排表字节数
+  final int compactions; // 压缩次数
+
+  const NativeSearchStats({
+    required this.documents,
+    required this.deleted,
+    required this.terms,
+    required this.postingBytes,
+    required this.compactions,
+  });
+}
+
+/// `NativeSearchIndex` 类：按名称打开的进程内全文索引。
+///
+/// 文档以 ObjectId 为键，原生侧保存的是 [NativeObjectIdTable] 的句柄。
+class NativeSearchIndex {
+  static final Map<String, NativeSearchIndex> _opened = {}; // 同名索引只打开一次
+  static Pointer<_RunnerSearchHit>? _hits; // 复用的结果缓冲区
+  static int _hitCapacity = 0;
+
+  final _Bindings _bindings;
+  final Pointer<Void> _index;
+
+  NativeSearchIndex._(this._bindings, this._index);
+
+  /// 当前平台是否可以使用原生索引。
+  static bool get isSupported =>
+      !kIsWeb && defaultTargetPlatform == TargetPlatform.windows;
+
+  /// 打开名为 [name] 的索引，不支持的平台或名称无效时返回 null。
+  /// [name] 只能包含字母、数字、'_' 和 '-'。
+  static NativeSearchIndex? open(String name) {
+    if (!isSupported) return null;
+    final existing = _opened[name];
+    if (existing != null) return existing;
+    final bindings = _Bindings.instance;
+    if (bindings == null) return null;
+    final nativeName = name.toNativeUtf8();
+    try {
+      final index = bindings.open(nativeName);
+      if (index == nullptr) return null;
+      return _opened[name] = NativeSearchIndex._(bindings, index);
+    } finally {
+      calloc.free(nativeName);
+    }
+  }
+
+  /// 添加或替换 ObjectId 为 [id] 的文档，[id] 无效时返回 false。
+  bool upsert(String id, List<NativeSearchField> fields) {
+    final handle = NativeObjectIdTable.intern(id);
+    if (handle == NativeObjectIdTable.invalidHandle) return false;
+    final encoded = [for (final field in fields) utf8.encode(field.text)];
+    final totalBytes =
+        encoded.fold<int>(0, (sum, bytes) => sum + bytes.length);
+    return using((arena) {
+      // 所有字段的文本放在同一块内存里，字段结构体指向各自的区间
+      final text = arena<Uint8>(totalBytes > 0 ? totalBytes : 1);
+      final textBytes = text.asTypedList(totalBytes);
+      final nativeFields =
+          arena<_RunnerSearchField>(fields.isNotEmpty ? fields.length : 1);
+      int offset = 0;
+      for (int i = 0; i < fields.length; i++) {
+        final bytes = encoded[i];
+        textBytes.setAll(offset, bytes);
+        final field = (nativeFields + i).ref;
+        field.text = text + offset;
+        field.length = bytes.length;
+        field.weight = fields[i].weight;
+        offset += bytes.length;
+      }
+      return _bindings.upsert(_index, handle, nativeFields, fields.length) !=
+          0;
+    });
+  }
+
+  /// 删除文档，返回是否存在。
+  bool remove(String id) {
+    final handle = NativeObjectIdTable.find(id);
+    if (handle == NativeObjectIdTable.invalidHandle) return false;
+    return _bindings.remove(_index, handle) != 0;
+  }
+
+  void clear() => _bindings.clear(_index);
+
+  /// 按得分从高到低返回最多 [limit] 条结果。
+  List<NativeSearchHit> search(String query, {int limit = 20}) {
+    if (query.trim().isEmpty || limit <= 0) return const [];
+    if (_hitCapacity < limit) {
+      if (_hits != null) calloc.free(_hits!);
+      _hits = calloc<_RunnerSearchHit>(limit);
+      _hitCapacity = limit;
+    }
+    final hits = _hits!;
+    final Uint8List bytes = utf8.encode(query);
+    // 叶子调用，原生侧直接读取 Dart 堆上的字节
+    final count =
+        _bindings.query(_index, bytes.address, bytes.length, hits, limit);
+    return [
+      for (int i = 0; i < count; i++)
+        NativeSearchHit(handle: (hits + i).ref.id, score: (hits + i).ref.score),
+    ];
+  }
+
+  NativeSearchStats stats() {
+    final stats = calloc<_RunnerSearchStats>();
+    try {
+      _bindings.stats(_index, stats);
+      return NativeSearchStats(
+        documents: stats.ref.documents,
+        deleted: stats.ref.deleted,
+        terms: stats.ref.terms,
+        postingBytes: stats.ref.postingBytes,
+        compactions: stats.ref.compactions,
+      );
+    } finally {
+      calloc.free(stats);
+    }
+  }
+}
+
+/// `NativeSearchCorpus` 类：可本地搜索的一组条目。
+///
+/// 条目按 ObjectId 保存在 Dart 侧，文本写入同名的原生索引。超过 [capacity]
+/// 时淘汰最早放入的条目，同时从索引中删除。不支持原生索引的平台上
+/// [search] 总是返回空列表，调用方照常请求服务器即可。
+class NativeSearchCorpus<T> {
+  final String Function(T item) idOf; // 条目的 ObjectId
+  final List<NativeSearchField> Function(T item) fieldsOf; // 要索引的文本
+  final int capacity;
+  final NativeSearchIndex? _index;
+  final LinkedHashMap<int, T> _items = LinkedHashMap(); // 句柄到条目，按放入顺序
+
+  NativeSearchCorpus(
+    String name, {
+    required this.idOf,
+    required this.fieldsOf,
+    this.capacity = 5000,
+  }) : _index = NativeSearchIndex.open(name);
+
+  int get length => _items.length;
+
+  /// 放入或更新条目，再次放入的条目移到最新的位置。
+  void put(T item) {
+    final index = _index;
+    if (index == null) return;
+    final id = idOf(item);
+    if (!index.upsert(id, fieldsOf(item))) return;
+    final handle = NativeObjectIdTable.find(id);
+    _items.remove(handle);
+    _items[handle] = item;
+    while (_items.length > capacity) {
+      final oldest = _items.keys.first;
+      final oldestItem = _items.remove(oldest);
+      if (oldestItem != null) index.remove(idOf(oldestItem));
+    }
+  }
+
+  void putAll(Iterable<T> items) {
+    for (final item in items) {
+      put(item);
+    }
+  }
+
+  /// 条目离开缓存（例如被删除）时调用。
+  void remove(String id) {
+    final index = _index;
+    if (index == null) return;
+    _items.remove(NativeObjectIdTable.find(id));
+    index.remove(id);
+  }
+
+  /// 按相关度返回最多 [limit] 个条目。
+  List<T> search(String query, {int limit = 20}) {
+    final index = _index;
+    if (index == null || _items.isEmpty) return const [];
+    final results = <T>[];
+    for (final hit in index.search(query, limit: limit)) {
+      final item = _items[hit.handle];
+      if (item != null) results.add(item);
+    }
+    return results;
+  }
+}
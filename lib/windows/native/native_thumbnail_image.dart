@@ -0,0 +1,109 @@
+// lib/windows/native/native_thumbnail_image.dart
+
+/// 该文件定义了 NativeThumbnailImage，从原生缩略图服务加载显示尺寸的封面。
+/// 原生侧把原图缩小到固定的几档宽度并缓存像素，列表滚动时不再解码原图，
+/// 内存中也只保留显示尺寸的位图。
+library;
+
+import 'dart:ui' as ui; // ImageDescriptor
+import 'package:flutter/foundation.dart'; // 平台判断所需
+import 'package:flutter/painting.dart'; // ImageProvider
+import 'package:flutter/services.dart'; // MethodChannel
+import 'package:flutter_cache_manager/flutter_cache_manager.dart'; // 原图下载和缓存
+
+/// `NativeThumbnailImage` 类：按档位宽度加载缩略图的 [ImageProvider]。
+///
+/// 缩略图未生成时先通过 [cacheManager] 取得原图文件，再由原生侧生成。
+/// 仅在 Windows 上可用，调用前先检查 [isSupported]。
+class NativeThumbnailImage extends ImageProvider<NativeThumbnailImage> {
+  static const MethodChannel _channel =
+      MethodChannel('com.example.suxingchahui/thumbnail'); // 原生通道
+
+  /// 缩略图宽度档位（物理像素），必须与原生侧 kThumbnailWidths 一致。
+  static const List<int> widths = [96, 160, 240, 320, 480, 640, 960];
+
+  final String url; // 原图 URL，同时作为缓存键
+  final int width; // 档位宽度（物理像素）
+  final BaseCacheManager cacheManager; // 用于下载原图，不参与相等比较
+
+  /// 构造函数。[width] 应为 [widthFor] 的返回值。
+  const NativeThumbnailImage(
+    this.url, {
+    required this.width,
+    required this.cacheManager,
+  });
+
+  /// 当前平台是否可以使用原生缩略图。
+  static bool get isSupported =>
+      !kIsWeb && defaultTargetPlatform == TargetPlatform.windows;
+
+  /// 返回不小于 [physicalWidth] 的最小档位，超过最大档位时返回最大档位。
+  static int widthFor(double physicalWidth) {
+    for (final width in widths) {
+      if (width >= physicalWidth) return width;
+    }
+    return widths.last;
+  }
+
+  @override
+  Future<NativeThumbnailImage> obtainKey(ImageConfiguration configuration) {
+    return SynchronousFuture<NativeThumbnailImage>(this);
+  }
+
+  @override
+  ImageStreamCompleter loadImage(
+      NativeThumbnailImage key, ImageDecoderCallback decode) {
+    return OneFrameImageStreamCompleter(
+      key._load(),
+      informationCollector: () => [
+        DiagnosticsProperty<ImageProvider>('Image provider', this),
+        DiagnosticsProperty<NativeThumbnailImage>('Image key', key),
+      ],
+    );
+  }
+
+  Future<ImageInfo> _load() async {
+    Map<String, Object?>? reply = await _channel
+        .invokeMapMethod<String, Object?>('load', {'key': url, 'width': width});
+    if (reply == null) {
+      // 缩略图缓存未命中：取得原图文件后由原生侧生成
+      final file = await cacheManager.getSingleFile(url);
+      reply = await _channel.invokeMapMethod<String, Object?>(
+          'load', {'key': url, 'width': width, 'path': file.path});
+    }
+    if (reply == null) {
+      throw StateError('Thumbnail unavailable: $url');
+    }
+
+    final buffer =
+        await ui.ImmutableBuffer.fromUint8List(reply['pixels'] as Uint8List);
+    final descriptor = ui.ImageDescriptor.raw(
+      buffer,
+      width: reply['width'] as int,
+      height: reply['height'] as int,
+      pixelFormat: ui.PixelFormat.bgra8888,
+    );
+    try {
+      final codec = await descriptor.instantiateCodec();
+      final frame = await codec.getNextFrame();
+      codec.dispose();
+      return ImageInfo(image: frame.image, debugLabel: url);
+    } finally {
+      descriptor.dispose();
+      buffer.dispose();
+    }
+  }
+
+  @override
+  bool operator ==(Object other) {
+    return other is NativeThumbnailImage &&
+        other.url == url &&
+        other.width == width;
+  }
+
+  @override
+  int get hashCode => Object.hash(url, width);
+
+  @override
+  String toString() => 'NativeThumbnailImage("$url", width: $width)';
+}
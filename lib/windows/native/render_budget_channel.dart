@@ -0,0 +1,54 @@
+// lib/windows/native/render_budget_channel.dart
+
+/// 该文件定义了 RenderBudgetChannel，接收原生侧推送的背景动画渲染预算。
+/// runner 根据窗口最小化、被遮挡、锁屏、显示器关闭和电源状态给出级别：
+/// 看不见窗口时暂停，使用电池或节电模式时降帧，其余情况全速。
+library;
+
+import 'dart:async'; // StreamSubscription
+
+import 'package:flutter/foundation.dart'; // 平台判断和 ValueListenable
+import 'package:flutter/services.dart'; // EventChannel
+
+/// 背景动画的渲染预算，下标与原生侧的 RenderBudgetLevel 一致。
+enum RenderBudgetLevel {
+  full, // 全速
+  reduced, // 降帧，见 [RenderBudgetChannel.reducedFrameInterval]
+  paused, // 暂停
+}
+
+/// `RenderBudgetChannel` 类：渲染预算的 Dart 端入口。
+class RenderBudgetChannel {
+  static const EventChannel _channel =
+      EventChannel('com.example.suxingchahui/render_budget'); // 原生通道
+
+  /// 降帧时背景动画的帧间隔，约 30fps。
+  static const Duration reducedFrameInterval = Duration(milliseconds: 33);
+
+  static final ValueNotifier<RenderBudgetLevel> _level =
+      ValueNotifier(RenderBudgetLevel.full);
+  static StreamSubscription<dynamic>? _subscription;
+
+  /// 当前平台是否有原生事件。
+  static bool get isSupported =>
+      !kIsWeb && defaultTargetPlatform == TargetPlatform.windows;
+
+  /// 当前级别。第一次访问时开始监听；不支持或通道出错时保持全速。
+  static ValueListenable<RenderBudgetLevel> get level {
+    if (_subscription == null && isSupported) {
+      _subscription = _channel.receiveBroadcastStream().listen(
+        (event) {
+          final index = event is int ? event : 0;
+          _level.value = RenderBudgetLevel
+              .values[index.clamp(0, RenderBudgetLevel.values.length - 1)];
+        },
+        onError: (Object _) {
+          // 旧版本 runner 没有这个通道，保留订阅避免重复尝试
+          _level.value = RenderBudgetLevel.full;
+        },
+        cancelOnError: true,
+      );
+    }
+    return _level;
+  }
+}
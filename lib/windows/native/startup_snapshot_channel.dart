@@ -0,0 +1,104 @@
+// lib/windows/native/startup_snapshot_channel.dart
+
+/// 该文件定义了 StartupSnapshotChannel，读写 runner 保存的启动快照。
+/// 首页把热门游戏、最新游戏、热门帖子和会话摘要推送给 runner，runner 在退出时
+/// 写成紧凑的二进制快照；下次启动时在创建引擎的同时映射并校验，Dart 在 main
+/// 里第一时间取回，首页第一帧就能显示上次的内容，网络数据到达后再替换。
+library;
+
+import 'dart:async'; // Future
+import 'dart:convert'; // jsonEncode / utf8
+import 'dart:typed_data'; // Uint8List
+
+import 'package:flutter/foundation.dart'; // 平台判断所需
+import 'package:flutter/services.dart'; // MethodChannel
+
+import 'font_subset_channel.dart'; // 记录缓存内容用到的字符
+import 'native_flat_json.dart'; // 原生 JSON 解码
+
+/// 上次退出时保存的快照。
+class StartupSnapshot {
+  final DateTime savedAt; // 写入时间
+  final Map<String, Uint8List> sections; // 段名 -> UTF-8 JSON
+
+  const StartupSnapshot(this.savedAt, this.sections);
+
+  /// 把段 [name] 解码为 JSON，没有或无法解析时返回 null。
+  ///
+  /// 首页第一帧之前解码，走原生解码：对象和数组是只读的惰性视图，
+  /// `fromJson` 没读到的字段不会生成 Dart 对象。
+  Object? json(String name) {
+    final bytes = sections[name];
+    if (bytes == null) return null;
+    try {
+      return NativeFlatJson.decode(bytes);
+    } on FormatException {
+      return null;
+    }
+  }
+}
+
+/// `StartupSnapshotChannel` 类：启动快照的 Dart 端入口。
+///
+/// 仅在 Windows 上可用，其它平台读取返回 null，写入直接忽略。
+class StartupSnapshotChannel {
+  static const MethodChannel _channel =
+      MethodChannel('com.example.suxingchahui/startup_snapshot'); // 原生通道
+
+  /// 段内容的结构版本。修改任何段的结构时加一，旧快照随之作废。
+  static const int schemaVersion = 1;
+
+  static const String hotGamesSection = 'home.hot_games'; // 热门游戏
+  static const String latestGamesSection = 'home.latest_games'; // 最新游戏
+  static const String hotPostsSection = 'home.hot_posts'; // 热门帖子
+  static const String sessionSection = 'session'; // 写入快照时的登录用户
+
+  static Future<StartupSnapshot?>? _loading;
+  static StartupSnapshot? _snapshot;
+
+  /// 当前平台是否有原生快照。
+  static bool get isSupported =>
+      !kIsWeb && defaultTargetPlatform == TargetPlatform.windows;
+
+  /// 已经取回的快照，还没取回或没有可用快照时为 null。
+  static StartupSnapshot? get snapshot => _snapshot;
+
+  /// 取回快照，只请求一次。应在 main 里尽早调用。
+  static Future<StartupSnapshot?> load() => _loading ??= _load();
+
+  static Future<StartupSnapshot?> _load() async {
+    if (!isSupported) return null;
+    try {
+      final result = await _channel.invokeMapMethod<String, dynamic>('load');
+      if (result == null || result['schema'] != schemaVersion) return null;
+      final sections = <String, Uint8List>{};
+      (result['sections'] as Map? ?? const {}).forEach((key, value) {
+        if (key is String && value is Uint8List) sections[key] = value;
+      });
+      return _snapshot = StartupSnapshot(
+        DateTime.fromMillisecondsSinceEpoch((result['savedAt'] as int?) ?? 0),
+        sections,
+      );
+    } on MissingPluginException {
+      return null; // 旧版本 runner
+    }
+  }
+
+  /// 更新段 [name]，runner 退出时写入快照。[value] 为 null 时删除该段。
+  static Future<void> put(String name, Object? value) async {
+    if (!isSupported) return;
+    final json = value == null ? null : jsonEncode(value);
+    if (json != null) FontSubsetChannel.record(json);
+    try {
+      await _channel.invokeMethod<void>('put', {
+        'schema': schemaVersion,
+        'name': name,
+        'data': json == null ? null : Uint8List.fromList(utf8.encode(json)),
+      });
+    } on MissingPluginException {
+      // 旧版本 runner
+    } on PlatformException {
+      // 段过大时放弃，不影响正常使用
+    }
+  }
+}
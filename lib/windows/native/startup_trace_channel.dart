@@ -0,0 +1,66 @@
+// lib/windows/native/startup_trace_channel.dart
+
+/// 该文件定义了 StartupTraceChannel，把 Dart 侧的启动阶段追加到原生启动时间线。
+/// 原生侧只有在以 `--startup-trace` 启动时才会记录，其余情况下调用是空操作。
+library;
+
+import 'dart:async'; // 异步编程所需
+import 'dart:developer' show Timeline; // 与原生同源的单调时钟
+import 'package:flutter/foundation.dart'; // 平台判断所需
+import 'package:flutter/services.dart'; // MethodChannel
+
+/// `StartupTraceChannel` 类：启动时间线的 Dart 端入口。
+///
+/// 仅在 Windows 上生效，其它平台所有方法直接返回。
+class StartupTraceChannel {
+  static const MethodChannel _channel =
+      MethodChannel('com.example.suxingchahui/startup_trace'); // 原生通道
+
+  static bool? _enabled; // 缓存原生侧是否启用了记录
+
+  static bool get _isSupported =>
+      !kIsWeb && defaultTargetPlatform == TargetPlatform.windows;
+
+  /// 原生侧是否正在记录启动时间线。
+  static Future<bool> isEnabled() async {
+    if (!_isSupported) return false;
+    if (_enabled != null) return _enabled!;
+    try {
+      _enabled = await _channel.invokeMethod<bool>('isEnabled') ?? false;
+    } catch (_) {
+      _enabled = false; // 通道不可用时视为未启用
+    }
+    return _enabled!;
+  }
+
+  /// 追加一个以当前时刻为结束时间、时长为 [duration] 的时间段。
+  ///
+  /// 结束时间在调用时取自 [Timeline.now]（Windows 上与原生 steady_clock
+  /// 同为 QPC），通道往返的延迟不会计入时间段。
+  static Future<void> addSpan(String name, Duration duration) async {
+    final endMicros = Timeline.now; // 必须在第一个 await 之前读取
+    if (!await isEnabled()) return;
+    await _channel.invokeMethod<void>('addSpan', {
+      'name': name,
+      'durationMicros': duration.inMicroseconds,
+      'endMicros': endMicros,
+    });
+  }
+
+  /// 追加一个瞬时事件。
+  static Future<void> instant(String name) async {
+    if (!await isEnabled()) return;
+    await _channel.invokeMethod<void>('instant', {'name': name});
+  }
+
+  /// 执行 [action] 并把耗时记录为名为 [name] 的时间段。
+  static Future<T> trace<T>(String name, FutureOr<T> Function() action) async {
+    final stopwatch = Stopwatch()..start(); // 计时
+    try {
+      return await action();
+    } finally {
+      stopwatch.stop();
+      unawaited(addSpan(name, stopwatch.elapsed)); // 记录不阻塞启动流程
+    }
+  }
+}
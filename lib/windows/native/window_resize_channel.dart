@@ -0,0 +1,25 @@
+// lib/windows/native/window_resize_channel.dart
+
+/// 该文件定义了 WindowResizeChannel，接收原生侧推送的窗口尺寸调整开始和结束事件。
+/// runner 跟踪 WM_ENTERSIZEMOVE、WM_SIZE 和 WM_EXITSIZEMOVE：拖动边框改变尺寸时立即
+/// 发送开始，松开鼠标时立即发送结束，只移动窗口不发送。
+library;
+
+import 'package:flutter/foundation.dart'; // 平台判断所需
+import 'package:flutter/services.dart'; // EventChannel
+
+/// `WindowResizeChannel` 类：窗口尺寸调整事件的 Dart 端入口。
+class WindowResizeChannel {
+  static const EventChannel _channel =
+      EventChannel('com.example.suxingchahui/window_resize'); // 原生通道
+
+  /// 当前平台是否有原生事件。
+  static bool get isSupported =>
+      !kIsWeb && defaultTargetPlatform == TargetPlatform.windows;
+
+  /// 尺寸调整状态：true 开始，false 结束。监听时先收到当前状态。
+  ///
+  /// 旧版本 runner 没有这个通道时，流以 MissingPluginException 报错。
+  static Stream<bool> get events =>
+      _channel.receiveBroadcastStream().map((event) => event == true);
+}
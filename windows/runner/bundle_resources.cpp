@@ -0,0 +1,44 @@
+#include "bundle_resources.h"
+
+#include <algorithm>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+std::vector<fs::path> RequiredBundleResources() {
+  const fs::path data = "data";
+  return {
+      data / "flutter_assets",
+      data / "icudtl.dat",
+  };
+}
+
+std::vector<fs::path> PrefetchBundleResources() {
+  // AOT 快照、ICU 数据和 CJK 字体最先被引擎读取，其余资源随后
+  const fs::path data = "data";
+  std::vector<fs::path> resources = {
+      data / "app.so",
+      data / "icudtl.dat",
+      data / "flutter_assets" / "assets" / "fonts" / "NotoSansSC-Regular.ttf",
+  };
+  for (auto& resource : RequiredBundleResources()) {
+    if (std::find(resources.begin(), resources.end(), resource) ==
+        resources.end()) {
+      resources.push_back(std::move(resource));
+    }
+  }
+  return resources;
+}
+
+std::vector<fs::path> FindMissingResources(
+    const fs::path& root,
+    const std::vector<fs::path>& resources) {
+  std::vector<fs::path> missing;
+  for (const auto& resource : resources) {
+    std::error_code error;
+    if (!fs::exists(root / resource, error)) {
+      missing.push_back(resource);
+    }
+  }
+  return missing;
+}
@@ -0,0 +1,21 @@
+#ifndef RUNNER_BUNDLE_RESOURCES_H_
+#define RUNNER_BUNDLE_RESOURCES_H_
+
+#include <filesystem>
+#include <vector>
+
+// 启动时用到的安装包资源（与平台无关）。路径都相对可执行文件目录。
+
+// 启动前必须存在的资源，缺少任何一个预初始化检查都会失败。
+std::vector<std::filesystem::path> RequiredBundleResources();
+
+// 启动时预读的文件，按引擎首次访问的顺序排列，包含
+// RequiredBundleResources 的全部条目。
+std::vector<std::filesystem::path> PrefetchBundleResources();
+
+// |resources| 中在 |root| 下不存在的条目，保持原顺序。
+std::vector<std::filesystem::path> FindMissingResources(
+    const std::filesystem::path& root,
+    const std::vector<std::filesystem::path>& resources);
+
+#endif  // RUNNER_BUNDLE_RESOURCES_H_
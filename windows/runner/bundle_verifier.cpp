@@ -0,0 +1,303 @@
+#include "bundle_verifier.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <system_error>
+
+#include "mapped_file.h"
+#include "thread_pool.h"
+#include "xxhash64.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kManifestHeader[] = "# suxingchahui bundle manifest v1";
+constexpr char kCacheMagic[4] = {'S', 'X', 'B', 'F'};
+constexpr uint32_t kCacheVersion = 1;
+
+bool HashFile(const fs::path& path, uint64_t* hash) {
+  MappedFile file;
+  if (!file.Open(path)) {
+    return false;
+  }
+  *hash = XxHash64(file.data(), file.size());
+  return true;
+}
+
+int64_t ModifiedTime(const fs::path& path, std::error_code* error) {
+  const auto time = fs::last_write_time(path, *error);
+  return static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+template <typename T>
+void WritePod(std::ostream& out, T value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool ReadPod(std::istream& in, T* value) {
+  return static_cast<bool>(
+      in.read(reinterpret_cast<char*>(value), sizeof(*value)));
+}
+
+void WriteString(std::ostream& out, const std::string& value) {
+  WritePod(out, static_cast<uint32_t>(value.size()));
+  out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+bool ReadString(std::istream& in, std::string* value) {
+  uint32_t length = 0;
+  if (!ReadPod(in, &length) || length > (1u << 16)) {
+    return false;
+  }
+  value->resize(length);
+  return static_cast<bool>(in.read(value->data(), length));
+}
+
+}  // namespace
+
+bool BuildBundleManifest(const fs::path& root,
+                         BundleManifest* manifest,
+                         size_t thread_count) {
+  std::error_code error;
+  std::vector<fs::path> files;
+  for (fs::recursive_directory_iterator it(root, error), end;
+       !error && it != end; it.increment(error)) {
+    if (!it->is_regular_file(error)) {
+      continue;
+    }
+    if (it->path().filename() == kBundleManifestFileName &&
+        it->path().parent_path() == root) {
+      continue;
+    }
+    files.push_back(it->path());
+  }
+  if (error) {
+    return false;
+  }
+
+  BundleManifest entries(files.size());
+  std::vector<char> succeeded(files.size(), 0);
+  ParallelFor(files.size(), thread_count, [&](size_t i) {
+    BundleManifestEntry& entry = entries[i];
+    entry.path = files[i].lexically_relative(root).generic_u8string();
+    std::error_code size_error;
+    entry.size = static_cast<uint64_t>(fs::file_size(files[i], size_error));
+    succeeded[i] = !size_error && HashFile(files[i], &entry.hash);
+  });
+  if (std::find(succeeded.begin(), succeeded.end(), 0) != succeeded.end()) {
+    return false;
+  }
+
+  std::sort(entries.begin(), entries.end(),
+            [](const BundleManifestEntry& a, const BundleManifestEntry& b) {
+              return a.path < b.path;
+            });
+  *manifest = std::move(entries);
+  return true;
+}
+
+bool WriteBundleManifest(const fs::path& file, const BundleManifest& manifest) {
+  std::ofstream out(file, std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!out) {
+    return false;
+  }
+  out << kManifestHeader << '\n';
+  char prefix[64];
+  for (const auto& entry : manifest) {
+    std::snprintf(prefix, sizeof(prefix), "%016" PRIx64 " %" PRIu64 " ",
+                  entry.hash, entry.size);
+    out << prefix << entry.path << '\n';
+  }
+  return static_cast<bool>(out);
+}
+
+bool ReadBundleManifest(const fs::path& file, BundleManifest* manifest) {
+  std::ifstream in(file, std::ios::in | std::ios::binary);
+  if (!in) {
+    return false;
+  }
+  std::string line;
+  if (!std::getline(in, line) || line.rfind(kManifestHeader, 0) != 0) {
+    return false;
+  }
+  BundleManifest entries;
+  while (std::getline(in, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (line.empty()) {
+      continue;
+    }
+    // 路径中可能包含空格，所以只按前两个空格切分
+    const size_t first_space = line.find(' ');
+    const size_t second_space =
+        first_space == std::string::npos ? first_space
+                                         : line.find(' ', first_space + 1);
+    if (second_space == std::string::npos) {
+      return false;
+    }
+    BundleManifestEntry entry;
+    char* hash_end = nullptr;
+    char* size_end = nullptr;
+    entry.hash = std::strtoull(line.c_str(), &hash_end, 16);
+    entry.size = std::strtoull(line.c_str() + first_space + 1, &size_end, 10);
+    if (hash_end != line.c_str() + first_space ||
+        size_end != line.c_str() + second_space) {
+      return false;
+    }
+    entry.path = line.substr(second_space + 1);
+    entries.push_back(std::move(entry));
+  }
+  *manifest = std::move(entries);
+  return true;
+}
+
+bool BundleFingerprintCache::Load(const fs::path& file, const fs::path& root) {
+  entries_.clear();
+  std::ifstream in(file, std::ios::in | std::ios::binary);
+  if (!in) {
+    return false;
+  }
+  char magic[4];
+  uint32_t version = 0;
+  std::string cached_root;
+  uint32_t count = 0;
+  if (!in.read(magic, sizeof(magic)) ||
+      !std::equal(magic, magic + 4, kCacheMagic) || !ReadPod(in, &version) ||
+      version != kCacheVersion || !ReadString(in, &cached_root) ||
+      cached_root != root.generic_u8string() || !ReadPod(in, &count)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < count; ++i) {
+    std::string path;
+    Fingerprint fingerprint;
+    if (!ReadString(in, &path) || !ReadPod(in, &fingerprint.size) ||
+        !ReadPod(in, &fingerprint.modified_time) ||
+        !ReadPod(in, &fingerprint.hash)) {
+      // 缓存损坏时整体丢弃，下次全部重新计算
+      entries_.clear();
+      return false;
+    }
+    entries_[std::move(path)] = fingerprint;
+  }
+  return true;
+}
+
+bool BundleFingerprintCache::Save(const fs::path& file,
+                                  const fs::path& root) const {
+  // 先写临时文件再改名，避免写到一半时进程退出留下损坏的缓存
+  fs::path temp_file = file;
+  temp_file += ".tmp";
+  {
+    std::ofstream out(temp_file,
+                      std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!out) {
+      return false;
+    }
+    out.write(kCacheMagic, sizeof(kCacheMagic));
+    WritePod(out, kCacheVersion);
+    WriteString(out, root.generic_u8string());
+    WritePod(out, static_cast<uint32_t>(entries_.size()));
+    for (const auto& [path, fingerprint] : entries_) {
+      WriteString(out, path);
+      WritePod(out, fingerprint.size);
+      WritePod(out, fingerprint.modified_time);
+      WritePod(out, fingerprint.hash);
+    }
+    if (!out) {
+      return false;
+    }
+  }
+  std::error_code error;
+  fs::rename(temp_file, file, error);
+  return !error;
+}
+
+const BundleFingerprintCache::Fingerprint* BundleFingerprintCache::Find(
+    const std::string& path) const {
+  auto it = entries_.find(path);
+  return it == entries_.end() ? nullptr : &it->second;
+}
+
+void BundleFingerprintCache::Update(const std::string& path,
+                                    const Fingerprint& fingerprint) {
+  entries_[path] = fingerprint;
+}
+
+BundleVerifyResult VerifyBundle(const fs::path& root,
+                                const BundleManifest& manifest,
+                                BundleFingerprintCache* cache,
+                                size_t thread_count) {
+  enum class State : uint8_t { kOk, kMissing, kCorrupted };
+  struct Outcome {
+    State state = State::kOk;
+    bool hashed = false;
+    BundleFingerprintCache::Fingerprint fingerprint;
+  };
+  std::vector<Outcome> outcomes(manifest.size());
+
+  // 工作线程只读缓存，更新统一在合并阶段进行
+  ParallelFor(manifest.size(), thread_count, [&](size_t i) {
+    const BundleManifestEntry& entry = manifest[i];
+    Outcome& outcome = outcomes[i];
+    const fs::path path = root / fs::u8path(entry.path);
+
+    std::error_code error;
+    const uintmax_t size = fs::file_size(path, error);
+    if (error) {
+      outcome.state = State::kMissing;
+      return;
+    }
+    // 解压不完整的文件通常大小就不对，不需要读内容
+    if (static_cast<uint64_t>(size) != entry.size) {
+      outcome.state = State::kCorrupted;
+      return;
+    }
+    outcome.fingerprint.size = entry.size;
+    outcome.fingerprint.modified_time = ModifiedTime(path, &error);
+
+    const BundleFingerprintCache::Fingerprint* cached =
+        cache ? cache->Find(entry.path) : nullptr;
+    if (!error && cached && cached->size == entry.size &&
+        cached->modified_time == outcome.fingerprint.modified_time) {
+      outcome.fingerprint.hash = cached->hash;
+    } else {
+      if (!HashFile(path, &outcome.fingerprint.hash)) {
+        outcome.state = State::kMissing;
+        return;
+      }
+      outcome.hashed = true;
+    }
+    if (outcome.fingerprint.hash != entry.hash) {
+      outcome.state = State::kCorrupted;
+    }
+  });
+
+  BundleVerifyResult result;
+  for (size_t i = 0; i < manifest.size(); ++i) {
+    const Outcome& outcome = outcomes[i];
+    switch (outcome.state) {
+      case State::kMissing:
+        result.missing.push_back(manifest[i].path);
+        break;
+      case State::kCorrupted:
+        result.corrupted.push_back(manifest[i].path);
+        break;
+      case State::kOk:
+        break;
+    }
+    if (outcome.hashed) {
+      ++result.hashed_files;
+      result.hashed_bytes += outcome.fingerprint.size;
+      if (cache) {
+        cache->Update(manifest[i].path, outcome.fingerprint);
+      }
+    }
+  }
+  return result;
+}
@@ -0,0 +1,80 @@
+#ifndef RUNNER_BUNDLE_VERIFIER_H_
+#define RUNNER_BUNDLE_VERIFIER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// data\ 目录完整性校验（与平台无关）。
+//
+// 构建安装时生成清单（相对路径、大小、XXH64），启动时对照清单校验。
+// 大小不一致直接判定损坏，不需要读文件；大小一致时用内存映射读取并在
+// 线程池上并行计算哈希。指纹缓存记录每个文件上次的大小、修改时间和哈希，
+// 热启动时只有发生变化的文件才需要重新计算。
+
+// 清单中的一项。|path| 为相对于根目录的 UTF-8 路径，使用 '/' 分隔。
+struct BundleManifestEntry {
+  std::string path;
+  uint64_t size = 0;
+  uint64_t hash = 0;
+};
+
+using BundleManifest = std::vector<BundleManifestEntry>;
+
+// 清单文件名，位于根目录下，生成清单时会跳过它自身。
+constexpr char kBundleManifestFileName[] = "bundle_manifest.txt";
+
+// 扫描 |root| 下的全部文件并计算哈希，结果按路径排序。
+bool BuildBundleManifest(const std::filesystem::path& root,
+                         BundleManifest* manifest,
+                         size_t thread_count = 0);
+
+// 文本格式：首行为版本头，之后每行 "<hash 16 位十六进制> <size> <path>"。
+bool WriteBundleManifest(const std::filesystem::path& file,
+                         const BundleManifest& manifest);
+bool ReadBundleManifest(const std::filesystem::path& file,
+                        BundleManifest* manifest);
+
+// 文件指纹缓存，按相对路径索引。
+class BundleFingerprintCache {
+ public:
+  struct Fingerprint {
+    uint64_t size = 0;
+    int64_t modified_time = 0;
+    uint64_t hash = 0;
+  };
+
+  // 读取缓存。|root| 与写入时不同（安装目录变了）时缓存作废。
+  bool Load(const std::filesystem::path& file,
+            const std::filesystem::path& root);
+  bool Save(const std::filesystem::path& file,
+            const std::filesystem::path& root) const;
+
+  const Fingerprint* Find(const std::string& path) const;
+  void Update(const std::string& path, const Fingerprint& fingerprint);
+  size_t size() const { return entries_.size(); }
+
+ private:
+  std::unordered_map<std::string, Fingerprint> entries_;
+};
+
+struct BundleVerifyResult {
+  std::vector<std::string> missing;
+  std::vector<std::string> corrupted;
+  // 实际重新计算哈希的文件数和字节数，其余命中指纹缓存或仅比对了大小
+  size_t hashed_files = 0;
+  uint64_t hashed_bytes = 0;
+
+  bool ok() const { return missing.empty() && corrupted.empty(); }
+};
+
+// 按清单校验 |root|。|cache| 可以为空；非空时会被更新为最新指纹。
+BundleVerifyResult VerifyBundle(const std::filesystem::path& root,
+                                const BundleManifest& manifest,
+                                BundleFingerprintCache* cache,
+                                size_t thread_count = 0);
+
+#endif  // RUNNER_BUNDLE_VERIFIER_H_
@@ -0,0 +1,376 @@
+#include "cert_pinning.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+#include "xxhash64.h"
+
+namespace {
+
+constexpr uint8_t kTagInteger = 0x02;
+constexpr uint8_t kTagSequence = 0x30;
+// tbsCertificate 中的 version 字段：[0] EXPLICIT
+constexpr uint8_t kTagVersion = 0xA0;
+
+// 单个 DER TLV。只支持单字节标签和定长编码，X.509 证书中足够。
+struct DerElement {
+  uint8_t tag = 0;
+  const uint8_t* begin = nullptr;  // 包含头部
+  const uint8_t* content = nullptr;
+  size_t content_size = 0;
+  size_t total_size = 0;
+};
+
+bool ReadDerElement(const uint8_t* data, size_t size, DerElement* element) {
+  if (size < 2 || (data[0] & 0x1F) == 0x1F) {
+    return false;
+  }
+  size_t header_size = 2;
+  size_t length = data[1];
+  if (length & 0x80) {
+    const size_t length_bytes = length & 0x7F;
+    // 0x80 为不定长编码，DER 中不允许
+    if (length_bytes == 0 || length_bytes > 4 || size < 2 + length_bytes) {
+      return false;
+    }
+    length = 0;
+    for (size_t i = 0; i < length_bytes; ++i) {
+      length = (length << 8) | data[2 + i];
+    }
+    header_size += length_bytes;
+  }
+  if (length > size - header_size) {
+    return false;
+  }
+  element->tag = data[0];
+  element->begin = data;
+  element->content = data + header_size;
+  element->content_size = length;
+  element->total_size = header_size + length;
+  return true;
+}
+
+// 按顺序读取 SEQUENCE 中的元素
+class DerReader {
+ public:
+  DerReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  bool Next(DerElement* element) {
+    if (!ReadDerElement(data_, size_, element)) {
+      return false;
+    }
+    data_ += element->total_size;
+    size_ -= element->total_size;
+    return true;
+  }
+
+  bool NextWithTag(uint8_t tag, DerElement* element) {
+    return Next(element) && element->tag == tag;
+  }
+
+  bool PeekTag(uint8_t* tag) const {
+    if (size_ == 0) {
+      return false;
+    }
+    *tag = data_[0];
+    return true;
+  }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+};
+
+std::string ToLowerAscii(std::string value) {
+  std::transform(value.begin(), value.end(), value.begin(), [](char c) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  });
+  return value;
+}
+
+std::string Trim(const std::string& value) {
+  const size_t begin = value.find_first_not_of(" \t\r");
+  if (begin == std::string::npos) {
+    return std::string();
+  }
+  const size_t end = value.find_last_not_of(" \t\r");
+  return value.substr(begin, end - begin + 1);
+}
+
+int HexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+int Base64Value(char c) {
+  if (c >= 'A' && c <= 'Z') return c - 'A';
+  if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+  if (c >= '0' && c <= '9') return c - '0' + 52;
+  if (c == '+') return 62;
+  if (c == '/') return 63;
+  return -1;
+}
+
+bool DecodeBase64(const std::string& text, std::vector<uint8_t>* output) {
+  output->clear();
+  uint32_t buffer = 0;
+  int bits = 0;
+  size_t padding = 0;
+  for (char c : text) {
+    if (c == '=') {
+      ++padding;
+      continue;
+    }
+    const int value = Base64Value(c);
+    if (value < 0 || padding > 0) {
+      return false;
+    }
+    buffer = (buffer << 6) | static_cast<uint32_t>(value);
+    bits += 6;
+    if (bits >= 8) {
+      bits -= 8;
+      output->push_back(static_cast<uint8_t>(buffer >> bits));
+    }
+  }
+  return padding <= 2;
+}
+
+}  // namespace
+
+bool ExtractSubjectPublicKeyInfo(const uint8_t* der,
+                                 size_t size,
+                                 const uint8_t** spki,
+                                 size_t* spki_size) {
+  // Certificate ::= SEQUENCE { tbsCertificate, signatureAlgorithm, signature }
+  DerElement certificate;
+  if (!ReadDerElement(der, size, &certificate) ||
+      certificate.tag != kTagSequence) {
+    return false;
+  }
+  DerReader certificate_reader(certificate.content, certificate.content_size);
+  DerElement tbs;
+  if (!certificate_reader.NextWithTag(kTagSequence, &tbs)) {
+    return false;
+  }
+
+  // TBSCertificate ::= SEQUENCE { [0] version OPTIONAL, serialNumber,
+  //     signature, issuer, validity, subject, subjectPublicKeyInfo, ... }
+  DerReader reader(tbs.content, tbs.content_size);
+  DerElement element;
+  uint8_t tag = 0;
+  if (reader.PeekTag(&tag) && tag == kTagVersion && !reader.Next(&element)) {
+    return false;
+  }
+  if (!reader.NextWithTag(kTagInteger, &element)) {
+    return false;
+  }
+  // signature、issuer、validity、subject
+  for (int i = 0; i < 4; ++i) {
+    if (!reader.NextWithTag(kTagSequence, &element)) {
+      return false;
+    }
+  }
+  if (!reader.NextWithTag(kTagSequence, &element)) {
+    return false;
+  }
+  *spki = element.begin;
+  *spki_size = element.total_size;
+  return true;
+}
+
+bool ComputeSpkiDigest(const uint8_t* der, size_t size, Sha256Digest* digest) {
+  const uint8_t* spki = nullptr;
+  size_t spki_size = 0;
+  if (!ExtractSubjectPublicKeyInfo(der, size, &spki, &spki_size)) {
+    return false;
+  }
+  *digest = Sha256::Hash(spki, spki_size);
+  return true;
+}
+
+bool ParsePin(const std::string& text, Sha256Digest* pin) {
+  constexpr char kBase64Prefix[] = "sha256/";
+  constexpr size_t kBase64PrefixLength = sizeof(kBase64Prefix) - 1;
+  if (text.compare(0, kBase64PrefixLength, kBase64Prefix) == 0) {
+    std::vector<uint8_t> bytes;
+    if (!DecodeBase64(text.substr(kBase64PrefixLength), &bytes) ||
+        bytes.size() != pin->size()) {
+      return false;
+    }
+    std::copy(bytes.begin(), bytes.end(), pin->begin());
+    return true;
+  }
+
+  if (text.size() != pin->size() * 2) {
+    return false;
+  }
+  for (size_t i = 0; i < pin->size(); ++i) {
+    const int high = HexValue(text[2 * i]);
+    const int low = HexValue(text[2 * i + 1]);
+    if (high < 0 || low < 0) {
+      return false;
+    }
+    (*pin)[i] = static_cast<uint8_t>((high << 4) | low);
+  }
+  return true;
+}
+
+std::string BytesToHex(const uint8_t* data, size_t size) {
+  static constexpr char kHexDigits[] = "0123456789abcdef";
+  std::string hex(size * 2, '\0');
+  for (size_t i = 0; i < size; ++i) {
+    hex[i * 2] = kHexDigits[data[i] >> 4];
+    hex[i * 2 + 1] = kHexDigits[data[i] & 0x0F];
+  }
+  return hex;
+}
+
+std::string DigestToHex(const Sha256Digest& digest) {
+  return BytesToHex(digest.data(), digest.size());
+}
+
+CertificatePinner::CertificatePinner(size_t max_cached_certificates)
+    : max_cached_certificates_(max_cached_certificates) {}
+
+void CertificatePinner::AddPin(const std::string& host_pattern,
+                               const Sha256Digest& pin) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& pins = pins_[ToLowerAscii(host_pattern)];
+  if (std::find(pins.begin(), pins.end(), pin) == pins.end()) {
+    pins.push_back(pin);
+  }
+}
+
+bool CertificatePinner::LoadPinsFromFile(const std::filesystem::path& file) {
+  std::ifstream in(file, std::ios::in | std::ios::binary);
+  if (!in) {
+    return false;
+  }
+  // 先全部解析，任意一行有误时整个文件都不生效
+  std::vector<std::pair<std::string, Sha256Digest>> entries;
+  std::string line;
+  while (std::getline(in, line)) {
+    line = Trim(line);
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    const size_t space = line.find_first_of(" \t");
+    if (space == std::string::npos) {
+      return false;
+    }
+    Sha256Digest pin;
+    if (!ParsePin(Trim(line.substr(space + 1)), &pin)) {
+      return false;
+    }
+    entries.emplace_back(line.substr(0, space), pin);
+  }
+  for (const auto& entry : entries) {
+    AddPin(entry.first, entry.second);
+  }
+  return true;
+}
+
+bool CertificatePinner::empty() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pins_.empty();
+}
+
+std::vector<std::string> CertificatePinner::host_patterns() const {
+  std::vector<std::string> patterns;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    patterns.reserve(pins_.size());
+    for (const auto& entry : pins_) {
+      patterns.push_back(entry.first);
+    }
+  }
+  std::sort(patterns.begin(), patterns.end());
+  return patterns;
+}
+
+std::vector<Sha256Digest> CertificatePinner::FindPins(
+    const std::string& hostname) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto* pins = FindPinsLocked(ToLowerAscii(hostname));
+  return pins ? *pins : std::vector<Sha256Digest>();
+}
+
+const std::vector<Sha256Digest>* CertificatePinner::FindPinsLocked(
+    const std::string& hostname) const {
+  auto it = pins_.find(hostname);
+  if (it != pins_.end()) {
+    return &it->second;
+  }
+  // "*.example.com" 只匹配一级子域名
+  const size_t dot = hostname.find('.');
+  if (dot == std::string::npos || dot == 0) {
+    return nullptr;
+  }
+  it = pins_.find("*" + hostname.substr(dot));
+  return it != pins_.end() ? &it->second : nullptr;
+}
+
+PinVerdict CertificatePinner::Check(const std::string& hostname,
+                                    const uint8_t* der,
+                                    size_t size) {
+  const std::string host = ToLowerAscii(hostname);
+  CertificateKey key;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto* pins = FindPinsLocked(host);
+    if (!pins) {
+      return PinVerdict::kNotPinned;
+    }
+    // 命中并且原文一致时跳过 DER 解析和 SPKI 哈希。XXH64 比加锁还便宜，
+    // 放在锁内计算，命中时整个校验只加一次锁
+    key = CertificateKey{XxHash64(der, size), size};
+    auto it = certificates_.find(key);
+    if (it != certificates_.end() && it->second.der.size() == size &&
+        (size == 0 || std::memcmp(it->second.der.data(), der, size) == 0)) {
+      ++cache_hits_;
+      return Verdict(*pins, it->second);
+    }
+    ++cache_misses_;
+  }
+
+  CachedCertificate certificate;
+  certificate.valid = ComputeSpkiDigest(der, size, &certificate.spki_digest);
+  certificate.der.assign(der, der + size);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // 证书种类很少，超过上限说明在被刷缓存，直接清空即可
+  if (certificates_.size() >= max_cached_certificates_) {
+    certificates_.clear();
+  }
+  // 键碰撞时新证书替换旧条目
+  CachedCertificate& entry = certificates_[key];
+  entry = std::move(certificate);
+  const auto* pins = FindPinsLocked(host);
+  return pins ? Verdict(*pins, entry) : PinVerdict::kNotPinned;
+}
+
+PinVerdict CertificatePinner::Verdict(const std::vector<Sha256Digest>& pins,
+                                      const CachedCertificate& certificate) {
+  if (!certificate.valid) {
+    return PinVerdict::kMalformed;
+  }
+  return std::find(pins.begin(), pins.end(), certificate.spki_digest) !=
+                 pins.end()
+             ? PinVerdict::kAllowed
+             : PinVerdict::kMismatch;
+}
+
+size_t CertificatePinner::cache_hits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cache_hits_;
+}
+
+size_t CertificatePinner::cache_misses() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cache_misses_;
+}
@@ -0,0 +1,114 @@
+#ifndef RUNNER_CERT_PINNING_H_
+#define RUNNER_CERT_PINNING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sha256.h"
+
+// 证书公钥固定（与平台无关）。
+//
+// 固定的是证书中 SubjectPublicKeyInfo 的 SHA-256，与 HPKP / OkHttp 的
+// "sha256/<base64>" 相同，证书续期但密钥不变时无需更新。
+// 同一张证书在多次握手中反复出现，解析结果按整张证书的 SHA-256 缓存，
+// 命中时只需要一次哈希和一次查表。
+
+// 从 DER 编码的 X.509 证书中取出 SubjectPublicKeyInfo（包含 TLV 头）。
+// |spki| 指向 |der| 内部。格式不正确时返回 false。
+bool ExtractSubjectPublicKeyInfo(const uint8_t* der,
+                                 size_t size,
+                                 const uint8_t** spki,
+                                 size_t* spki_size);
+
+// 计算证书 SPKI 的 SHA-256。
+bool ComputeSpkiDigest(const uint8_t* der, size_t size, Sha256Digest* digest);
+
+// 解析 64 位十六进制或 "sha256/<base64>" 形式的固定值。
+bool ParsePin(const std::string& text, Sha256Digest* pin);
+
+// 小写十六进制。
+std::string BytesToHex(const uint8_t* data, size_t size);
+std::string DigestToHex(const Sha256Digest& digest);
+
+enum class PinVerdict {
+  kAllowed,    // 证书公钥与固定值匹配
+  kNotPinned,  // 该主机没有配置固定值
+  kMismatch,   // 配置了固定值但不匹配
+  kMalformed,  // 主机已固定，但证书无法解析
+};
+
+class CertificatePinner {
+ public:
+  explicit CertificatePinner(size_t max_cached_certificates = 1024);
+
+  CertificatePinner(const CertificatePinner&) = delete;
+  CertificatePinner& operator=(const CertificatePinner&) = delete;
+
+  // |host_pattern| 为主机名或 "*.example.com"（只匹配一级子域名）。
+  // 主机名不区分大小写。
+  void AddPin(const std::string& host_pattern, const Sha256Digest& pin);
+
+  // 每行 "<host_pattern> <pin>"，'#' 开头为注释。同一主机可以有多行，
+  // 任意一个匹配即通过（用于密钥轮换时的备用固定值）。
+  bool LoadPinsFromFile(const std::filesystem::path& file);
+
+  bool empty() const;
+  // 已配置的主机模式，按字母排序。
+  std::vector<std::string> host_patterns() const;
+  // |hostname| 对应的固定值；未固定时返回空。
+  std::vector<Sha256Digest> FindPins(const std::string& hostname) const;
+
+  // 校验一张证书。可以在任意线程调用。
+  PinVerdict Check(const std::string& hostname,
+                   const uint8_t* der,
+                   size_t size);
+
+  size_t cache_hits() const;
+  size_t cache_misses() const;
+
+ private:
+  // 缓存键：整张证书的 XXH64 和长度，计算开销远小于 DER 解析加 SPKI 哈希。
+  struct CertificateKey {
+    uint64_t hash = 0;
+    size_t size = 0;
+
+    bool operator==(const CertificateKey& other) const {
+      return hash == other.hash && size == other.size;
+    }
+  };
+
+  struct CertificateKeyHasher {
+    size_t operator()(const CertificateKey& key) const {
+      return static_cast<size_t>(key.hash);
+    }
+  };
+
+  // 证书解析结果。|valid| 为 false 表示证书格式不正确。
+  struct CachedCertificate {
+    bool valid = false;
+    Sha256Digest spki_digest{};
+    // 证书原文，命中时逐字节比对，键碰撞的证书不会拿到别人的结果
+    std::vector<uint8_t> der;
+  };
+
+  const std::vector<Sha256Digest>* FindPinsLocked(
+      const std::string& hostname) const;
+  static PinVerdict Verdict(const std::vector<Sha256Digest>& pins,
+                            const CachedCertificate& certificate);
+
+  const size_t max_cached_certificates_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::vector<Sha256Digest>> pins_;
+  std::unordered_map<CertificateKey, CachedCertificate, CertificateKeyHasher>
+      certificates_;
+  size_t cache_hits_ = 0;
+  size_t cache_misses_ = 0;
+};
+
+#endif  // RUNNER_CERT_PINNING_H_
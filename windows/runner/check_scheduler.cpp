@@ -0,0 +1,246 @@
+#include "check_scheduler.h"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+#include "thread_pool.h"
+
+CheckScheduler::CheckScheduler() : CheckScheduler(Options()) {}
+
+CheckScheduler::CheckScheduler(Options options) : options_(options) {}
+
+CheckScheduler::~CheckScheduler() {
+  Cancel();
+  // 取消后不会再投递新任务，线程池析构会等待正在执行的检查结束，
+  // 队列里尚未开始的检查会直接被标记为跳过
+  pool_.reset();
+}
+
+CheckScheduler::CheckId CheckScheduler::AddCheck(
+    std::wstring name,
+    CheckFunction check,
+    std::vector<CheckId> dependencies) {
+  const CheckId id = checks_.size();
+  Check item;
+  item.name = std::move(name);
+  item.function = std::move(check);
+  item.dependencies = std::move(dependencies);
+  checks_.push_back(std::move(item));
+  return id;
+}
+
+void CheckScheduler::SetRequired(CheckId id) {
+  if (id < checks_.size()) {
+    checks_[id].required = true;
+  }
+}
+
+bool CheckScheduler::Start(ProgressCallback on_progress,
+                           CompletionCallback on_complete) {
+  std::vector<CheckId> skipped;
+  bool all_passed = false;
+  bool complete = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (started_) {
+      return false;
+    }
+    for (CheckId id = 0; id < checks_.size(); ++id) {
+      for (CheckId dependency : checks_[id].dependencies) {
+        if (dependency >= id) {
+          return false;
+        }
+      }
+    }
+    started_ = true;
+    // 依赖的编号总是更小，倒序一遍就能把必需标记传给所有间接依赖
+    for (CheckId id = checks_.size(); id-- > 0;) {
+      if (checks_[id].required) {
+        for (CheckId dependency : checks_[id].dependencies) {
+          checks_[dependency].required = true;
+        }
+      }
+    }
+    on_progress_ = std::move(on_progress);
+    on_complete_ = std::move(on_complete);
+
+    for (CheckId id = 0; id < checks_.size(); ++id) {
+      Check& check = checks_[id];
+      check.remaining_dependencies = check.dependencies.size();
+      for (CheckId dependency : check.dependencies) {
+        checks_[dependency].dependents.push_back(id);
+      }
+    }
+
+    size_t parallelism = options_.max_parallelism;
+    if (parallelism == 0) {
+      parallelism = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    parallelism = std::min(parallelism, checks_.size());
+    if (parallelism > 0) {
+      pool_ = std::make_unique<ThreadPool>(parallelism);
+    }
+
+    for (CheckId id = 0; id < checks_.size(); ++id) {
+      if (checks_[id].remaining_dependencies == 0) {
+        ScheduleLocked(id, &skipped);
+      }
+    }
+    complete = TakeCompletionLocked(&all_passed);
+  }
+
+  Notify(checks_.size(), CheckStatus::kPending, skipped, complete, all_passed);
+  return true;
+}
+
+void CheckScheduler::Cancel() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cancelled_ = true;
+}
+
+void CheckScheduler::CancelOptional() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  optional_cancelled_ = true;
+}
+
+bool CheckScheduler::WaitForCompletion(std::chrono::milliseconds timeout) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return completed_cv_.wait_for(lock, timeout,
+                                [this]() { return completion_delivered_; });
+}
+
+CheckStatus CheckScheduler::status(CheckId id) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return checks_[id].status;
+}
+
+CheckResult CheckScheduler::result(CheckId id) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return checks_[id].result;
+}
+
+size_t CheckScheduler::resolved_count() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return resolved_;
+}
+
+bool CheckScheduler::IsCancelledLocked(CheckId id) const {
+  return cancelled_ || (optional_cancelled_ && !checks_[id].required);
+}
+
+void CheckScheduler::ScheduleLocked(CheckId id, std::vector<CheckId>* skipped) {
+  Check& check = checks_[id];
+  if (IsCancelledLocked(id) ||
+      (any_failed_ && options_.stop_on_first_failure)) {
+    check.status = CheckStatus::kSkipped;
+    skipped->push_back(id);
+    ResolveLocked(id, skipped);
+    return;
+  }
+  check.status = CheckStatus::kRunning;
+  // 在锁内投递，保证 Cancel 之后不会再有新的任务进入线程池
+  pool_->Post([this, id]() { Run(id); });
+}
+
+void CheckScheduler::ResolveLocked(CheckId id, std::vector<CheckId>* skipped) {
+  ++resolved_;
+  if (checks_[id].status == CheckStatus::kPassed) {
+    ++passed_;
+  }
+  for (CheckId dependent_id : checks_[id].dependents) {
+    Check& dependent = checks_[dependent_id];
+    if (--dependent.remaining_dependencies != 0) {
+      continue;
+    }
+    const bool dependencies_passed = std::all_of(
+        dependent.dependencies.begin(), dependent.dependencies.end(),
+        [this](CheckId dependency) {
+          return checks_[dependency].status == CheckStatus::kPassed;
+        });
+    if (dependencies_passed) {
+      ScheduleLocked(dependent_id, skipped);
+    } else {
+      dependent.status = CheckStatus::kSkipped;
+      skipped->push_back(dependent_id);
+      ResolveLocked(dependent_id, skipped);
+    }
+  }
+}
+
+bool CheckScheduler::TakeCompletionLocked(bool* all_passed) {
+  if (completion_sent_) {
+    return false;
+  }
+  const bool finished = resolved_ == checks_.size();
+  const bool early_exit = any_failed_ && options_.stop_on_first_failure;
+  if (!finished && !early_exit) {
+    return false;
+  }
+  completion_sent_ = true;
+  *all_passed = passed_ == checks_.size();
+  return true;
+}
+
+void CheckScheduler::Run(CheckId id) {
+  bool cancelled;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancelled = IsCancelledLocked(id);
+  }
+
+  CheckResult result;
+  if (!cancelled) {
+    if (on_progress_) {
+      on_progress_(id, CheckStatus::kRunning);
+    }
+    result = checks_[id].function();
+  }
+
+  std::vector<CheckId> skipped;
+  bool all_passed = false;
+  bool complete = false;
+  CheckStatus status;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Check& check = checks_[id];
+    if (cancelled) {
+      status = CheckStatus::kSkipped;
+    } else {
+      status = result.passed ? CheckStatus::kPassed : CheckStatus::kFailed;
+    }
+    check.status = status;
+    check.result = std::move(result);
+    if (status == CheckStatus::kFailed) {
+      any_failed_ = true;
+    }
+    ResolveLocked(id, &skipped);
+    complete = TakeCompletionLocked(&all_passed);
+  }
+
+  Notify(id, status, skipped, complete, all_passed);
+}
+
+void CheckScheduler::Notify(CheckId id,
+                            CheckStatus status,
+                            const std::vector<CheckId>& skipped,
+                            bool complete,
+                            bool all_passed) {
+  if (on_progress_) {
+    if (id < checks_.size()) {
+      on_progress_(id, status);
+    }
+    for (CheckId skipped_id : skipped) {
+      on_progress_(skipped_id, CheckStatus::kSkipped);
+    }
+  }
+  if (!complete) {
+    return;
+  }
+  if (on_complete_) {
+    on_complete_(all_passed);
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  completion_delivered_ = true;
+  completed_cv_.notify_all();
+}
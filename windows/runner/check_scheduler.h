@@ -0,0 +1,140 @@
+#ifndef RUNNER_CHECK_SCHEDULER_H_
+#define RUNNER_CHECK_SCHEDULER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// 单个检查项的执行结果。
+struct CheckResult {
+  bool passed = true;
+  // 失败时展示给用户的错误信息
+  std::wstring error;
+
+  static CheckResult Pass() { return CheckResult(); }
+  static CheckResult Fail(std::wstring message) {
+    CheckResult result;
+    result.passed = false;
+    result.error = std::move(message);
+    return result;
+  }
+};
+
+enum class CheckStatus {
+  kPending,
+  kRunning,
+  kPassed,
+  kFailed,
+  // 依赖失败或调度被提前终止，检查没有执行
+  kSkipped,
+};
+
+// 带依赖关系的并发检查调度器（与平台无关）。
+//
+// 每个检查在工作线程上执行，依赖全部通过后才会开始。回调都在工作线程上
+// 触发，调用方需要自行切回 UI 线程（PreInitWindow 通过 PostMessage）。
+class CheckScheduler {
+ public:
+  using CheckId = size_t;
+  using CheckFunction = std::function<CheckResult()>;
+  // 检查开始（kRunning）或结束（kPassed/kFailed/kSkipped）时调用。
+  using ProgressCallback = std::function<void(CheckId id, CheckStatus status)>;
+  // 所有检查结束，或开启 stop_on_first_failure 时出现第一个失败，调用一次。
+  using CompletionCallback = std::function<void(bool all_passed)>;
+
+  struct Options {
+    // 出现第一个失败后立即完成，未开始的检查全部跳过
+    bool stop_on_first_failure = true;
+    // 最大并行数，0 表示不超过检查数量和 CPU 核数
+    size_t max_parallelism = 0;
+  };
+
+  CheckScheduler();
+  explicit CheckScheduler(Options options);
+  // 等待正在执行的检查结束。
+  ~CheckScheduler();
+
+  CheckScheduler(const CheckScheduler&) = delete;
+  CheckScheduler& operator=(const CheckScheduler&) = delete;
+
+  // 添加检查。|dependencies| 只能引用已经添加的检查，因此不会出现环。
+  // 必须在 Start 之前调用。
+  CheckId AddCheck(std::wstring name,
+                   CheckFunction check,
+                   std::vector<CheckId> dependencies = {});
+
+  // 标记为必需：CancelOptional 之后仍然执行并等待结果，用于安全相关的检查。
+  // 它依赖的检查也随之成为必需。必须在 Start 之前调用。
+  void SetRequired(CheckId id);
+
+  // 开始调度。依赖非法或重复启动时返回 false。
+  bool Start(ProgressCallback on_progress, CompletionCallback on_complete);
+
+  // 跳过所有尚未开始的检查。已经在运行的检查不会被打断。
+  void Cancel();
+
+  // 只跳过尚未开始的非必需检查，必需检查照常执行，全部结束后触发完成回调。
+  void CancelOptional();
+
+  // 阻塞等待完成回调触发，超时返回 false。
+  bool WaitForCompletion(std::chrono::milliseconds timeout);
+
+  size_t check_count() const { return checks_.size(); }
+  const std::wstring& name(CheckId id) const { return checks_[id].name; }
+  CheckStatus status(CheckId id) const;
+  CheckResult result(CheckId id) const;
+
+  // 已经结束（通过、失败或跳过）的检查数量。
+  size_t resolved_count() const;
+
+ private:
+  struct Check {
+    std::wstring name;
+    CheckFunction function;
+    std::vector<CheckId> dependencies;
+    std::vector<CheckId> dependents;
+    size_t remaining_dependencies = 0;
+    bool required = false;
+    CheckStatus status = CheckStatus::kPending;
+    CheckResult result;
+  };
+
+  // 以下方法要求持有 mutex_。
+  void ScheduleLocked(CheckId id, std::vector<CheckId>* skipped);
+  void ResolveLocked(CheckId id, std::vector<CheckId>* skipped);
+  bool TakeCompletionLocked(bool* all_passed);
+
+  bool IsCancelledLocked(CheckId id) const;
+  void Run(CheckId id);
+  void Notify(CheckId id, CheckStatus status,
+              const std::vector<CheckId>& skipped, bool complete,
+              bool all_passed);
+
+  Options options_;
+  std::vector<Check> checks_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable completed_cv_;
+  ProgressCallback on_progress_;
+  CompletionCallback on_complete_;
+  size_t resolved_ = 0;
+  size_t passed_ = 0;
+  bool started_ = false;
+  bool cancelled_ = false;
+  bool optional_cancelled_ = false;
+  bool any_failed_ = false;
+  bool completion_sent_ = false;
+  bool completion_delivered_ = false;
+
+  // 声明在最后，最先析构，保证工作线程退出前其余成员仍然有效
+  std::unique_ptr<ThreadPool> pool_;
+};
+
+#endif  // RUNNER_CHECK_SCHEDULER_H_
@@ -0,0 +1,70 @@
+#include "cpu_features.h"
+
+#if RUNNER_ARCH_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace {
+
+#if RUNNER_ARCH_X86
+void Cpuid(int leaf, int subleaf, unsigned int registers[4]) {
+#if defined(_MSC_VER)
+  int values[4];
+  __cpuidex(values, leaf, subleaf);
+  for (int i = 0; i < 4; ++i) {
+    registers[i] = static_cast<unsigned int>(values[i]);
+  }
+#else
+  __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2],
+                registers[3]);
+#endif
+}
+
+// AVX 寄存器需要操作系统在上下文切换时保存（XCR0 的 bit 1、2）
+bool OsSavesYmmRegisters() {
+#if defined(_MSC_VER)
+  return (_xgetbv(0) & 0x6) == 0x6;
+#else
+  unsigned int eax, edx;
+  __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (eax & 0x6) == 0x6;
+#endif
+}
+#endif
+
+CpuFeatures DetectCpuFeatures() {
+  CpuFeatures features;
+#if RUNNER_ARCH_X86
+  unsigned int registers[4] = {0, 0, 0, 0};
+  Cpuid(0, 0, registers);
+  const unsigned int max_leaf = registers[0];
+  if (max_leaf < 1) {
+    return features;
+  }
+  Cpuid(1, 0, registers);
+  const unsigned int ecx1 = registers[2];
+  features.ssse3 = (ecx1 & (1u << 9)) != 0;
+  features.sse41 = (ecx1 & (1u << 19)) != 0;
+  const bool osxsave = (ecx1 & (1u << 27)) != 0;
+  const bool avx = (ecx1 & (1u << 28)) != 0;
+  if (max_leaf >= 7) {
+    Cpuid(7, 0, registers);
+    const unsigned int ebx7 = registers[1];
+    features.avx2 =
+        avx && osxsave && OsSavesYmmRegisters() && (ebx7 & (1u << 5)) != 0;
+    features.sha = (ebx7 & (1u << 29)) != 0;
+  }
+#endif
+  return features;
+}
+
+}  // namespace
+
+const CpuFeatures& GetCpuFeatures() {
+  static const CpuFeatures features = DetectCpuFeatures();
+  return features;
+}
@@ -0,0 +1,30 @@
+#ifndef RUNNER_CPU_FEATURES_H_
+#define RUNNER_CPU_FEATURES_H_
+
+// 运行时检测到的 CPU 指令集扩展。非 x86 平台上全部为 false。
+struct CpuFeatures {
+  bool sse41 = false;
+  bool ssse3 = false;
+  bool avx2 = false;
+  bool sha = false;
+};
+
+// 第一次调用时执行 CPUID，之后返回缓存的结果。
+const CpuFeatures& GetCpuFeatures();
+
+// GCC/Clang 需要在函数上声明目标指令集才能使用对应的 intrinsics，
+// MSVC 不需要。
+#if defined(__GNUC__) || defined(__clang__)
+#define RUNNER_TARGET_ATTRIBUTE(targets) __attribute__((target(targets)))
+#else
+#define RUNNER_TARGET_ATTRIBUTE(targets)
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || \
+    defined(__i386__)
+#define RUNNER_ARCH_X86 1
+#else
+#define RUNNER_ARCH_X86 0
+#endif
+
+#endif  // RUNNER_CPU_FEATURES_H_
@@ -0,0 +1,708 @@
+#include "disk_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <utility>
+
+#include "sha256.h"
+#include "xxhash64.h"
+
+namespace {
+
+constexpr uint32_t kIndexMagic = 0x43445853;  // "SXDC"
+constexpr uint32_t kIndexVersion = 1;
+constexpr uint32_t kShardCount = 16;
+constexpr uint32_t kMinSlotsPerShard = 64;
+constexpr uint32_t kSlotUsed = 1;
+constexpr uint32_t kNil = UINT32_MAX;
+constexpr uint64_t kKeySeed = 0x9E3779B97F4A7C15ull;
+constexpr char kIndexFileName[] = "index.bin";
+constexpr char kBlobDirName[] = "blobs";
+constexpr char kTempDirName[] = "tmp";
+constexpr char kTrashDirName[] = "trash";
+
+struct IndexHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t shard_count;
+  uint32_t slots_per_shard;
+  uint8_t reserved[48];
+};
+static_assert(sizeof(IndexHeader) == 64, "IndexHeader must be 64 bytes");
+
+uint32_t RoundUpToPowerOfTwo(uint32_t value) {
+  uint32_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+uint64_t LoadBigEndian64(const uint8_t* bytes) {
+  uint64_t value = 0;
+  for (int i = 0; i < 8; ++i) {
+    value = (value << 8) | bytes[i];
+  }
+  return value;
+}
+
+}  // namespace
+
+struct DiskCache::IndexRecord {
+  uint64_t key_high;
+  uint64_t key_low;
+  uint64_t digest_high;
+  uint64_t digest_low;
+  uint64_t size;
+  int64_t last_access_ms;
+  int64_t valid_till_ms;
+  uint32_t state;
+  // 前面字段的 XXH64 低 32 位，用于丢弃写了一半的记录
+  uint32_t checksum;
+};
+
+namespace {
+
+constexpr size_t kRecordChecksumOffset = 60;
+
+}  // namespace
+
+struct DiskCache::Shard {
+  struct Link {
+    uint32_t prev = kNil;
+    uint32_t next = kNil;
+  };
+
+  std::mutex mutex;
+  IndexRecord* records = nullptr;
+  std::vector<Link> links;
+  uint32_t head = kNil;  // 最近使用
+  uint32_t tail = kNil;  // 最久未使用
+  uint32_t count = 0;
+  uint32_t max_count = 0;
+  uint64_t bytes = 0;
+};
+
+namespace {
+
+uint32_t RecordChecksum(const void* record) {
+  return static_cast<uint32_t>(XxHash64(record, kRecordChecksumOffset));
+}
+
+}  // namespace
+
+DiskCache::DiskCache(std::filesystem::path directory, const Options& options)
+    : directory_(std::move(directory)),
+      blob_dir_(directory_ / kBlobDirName),
+      temp_dir_(directory_ / kTempDirName),
+      trash_dir_(directory_ / kTrashDirName),
+      options_(options) {
+  static_assert(sizeof(IndexRecord) == 64, "IndexRecord must be 64 bytes");
+  static_assert(offsetof(IndexRecord, checksum) == kRecordChecksumOffset,
+                "checksum must be the last field");
+  shard_count_ = kShardCount;
+  slots_per_shard_ = std::max(
+      kMinSlotsPerShard,
+      RoundUpToPowerOfTwo((options_.max_entries + kShardCount - 1) /
+                          kShardCount));
+  shard_max_bytes_ = options_.max_bytes / shard_count_;
+}
+
+DiskCache::~DiskCache() {
+  Flush();
+}
+
+bool DiskCache::Open() {
+  std::error_code error;
+  std::filesystem::create_directories(blob_dir_, error);
+  std::filesystem::create_directories(trash_dir_, error);
+  // 上次退出时没写完的临时文件
+  MoveToTrash(temp_dir_);
+
+  const size_t index_size =
+      sizeof(IndexHeader) + static_cast<size_t>(shard_count_) *
+                                slots_per_shard_ * sizeof(IndexRecord);
+  if (!index_.OpenWritable(directory_ / kIndexFileName, index_size)) {
+    return false;
+  }
+
+  shards_.clear();
+  auto* records = reinterpret_cast<IndexRecord*>(index_.mutable_data() +
+                                                 sizeof(IndexHeader));
+  for (uint32_t i = 0; i < shard_count_; ++i) {
+    auto shard = std::make_unique<Shard>();
+    shard->records = records + static_cast<size_t>(i) * slots_per_shard_;
+    shard->links.resize(slots_per_shard_);
+    shard->max_count = slots_per_shard_ / 8 * 7;
+    shards_.push_back(std::move(shard));
+  }
+
+  IndexHeader header;
+  std::memcpy(&header, index_.data(), sizeof(header));
+  if (header.magic == kIndexMagic && header.version == kIndexVersion &&
+      header.shard_count == shard_count_ &&
+      header.slots_per_shard == slots_per_shard_) {
+    LoadIndex();
+  } else {
+    // 索引丢失或格式不同：已有的内容文件都无法再找到
+    ResetIndex();
+    MoveToTrash(blob_dir_);
+  }
+  return true;
+}
+
+bool DiskCache::Lookup(std::string_view key, Entry* entry) {
+  const KeyHash key_hash = HashKey(key);
+  Shard& shard = ShardFor(key_hash);
+  IndexRecord record;
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const uint32_t slot = FindSlotLocked(shard, key_hash);
+    if (slot == kNil) {
+      misses_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    IndexRecord& stored = shard.records[slot];
+    stored.last_access_ms = NowMillis();
+    stored.checksum = RecordChecksum(&stored);
+    UnlinkLocked(&shard, slot);
+    LinkFrontLocked(&shard, slot);
+    record = stored;
+  }
+  hits_.fetch_add(1, std::memory_order_relaxed);
+  FillEntry(record, entry);
+  return true;
+}
+
+bool DiskCache::Put(std::string_view key,
+                    const void* data,
+                    size_t size,
+                    int64_t valid_till_ms,
+                    Entry* entry) {
+  if (size > shard_max_bytes_) {
+    return false;
+  }
+  const Sha256Digest sha = Sha256::Hash(data, size);
+  const Digest digest{LoadBigEndian64(sha.data()),
+                      LoadBigEndian64(sha.data() + 8)};
+  if (RetainBlob(digest)) {
+    const std::filesystem::path temp =
+        temp_dir_ / (DigestToName(digest) + "." +
+                     std::to_string(temp_counter_.fetch_add(1)));
+    bool written = false;
+    {
+      std::ofstream out(temp, std::ios::out | std::ios::binary);
+      out.write(static_cast<const char*>(data),
+                static_cast<std::streamsize>(size));
+      out.close();
+      written = static_cast<bool>(out);
+    }
+    const bool installed = written && InstallBlob(temp, digest);
+    FinishInstall(digest, installed);
+    if (!installed) {
+      std::error_code error;
+      std::filesystem::remove(temp, error);
+      ReleaseBlob(digest);
+      return false;
+    }
+  }
+  return Insert(HashKey(key), digest, size, valid_till_ms, entry);
+}
+
+bool DiskCache::PutFile(std::string_view key,
+                        const std::filesystem::path& source,
+                        int64_t valid_till_ms,
+                        Entry* entry) {
+  std::error_code error;
+  const uint64_t size = std::filesystem::file_size(source, error);
+  if (error || size > shard_max_bytes_) {
+    return false;
+  }
+  Digest digest;
+  {
+    MappedFile file;
+    if (!file.Open(source) || file.size() != size) {
+      return false;
+    }
+    const Sha256Digest sha = Sha256::Hash(file.data(), file.size());
+    digest = Digest{LoadBigEndian64(sha.data()),
+                    LoadBigEndian64(sha.data() + 8)};
+  }
+  if (RetainBlob(digest)) {
+    const bool installed = InstallBlob(source, digest);
+    FinishInstall(digest, installed);
+    if (!installed) {
+      ReleaseBlob(digest);
+      return false;
+    }
+  } else {
+    std::filesystem::remove(source, error);
+  }
+  return Insert(HashKey(key), digest, size, valid_till_ms, entry);
+}
+
+bool DiskCache::Remove(std::string_view key) {
+  const KeyHash key_hash = HashKey(key);
+  Shard& shard = ShardFor(key_hash);
+  std::vector<Digest> unreferenced;
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const uint32_t slot = FindSlotLocked(shard, key_hash);
+    if (slot == kNil) {
+      return false;
+    }
+    EraseSlotLocked(&shard, slot, &unreferenced);
+  }
+  DeleteBlobs(unreferenced);
+  return true;
+}
+
+size_t DiskCache::RemoveOlderThan(int64_t last_access_ms) {
+  size_t removed = 0;
+  for (auto& shard : shards_) {
+    std::vector<Digest> unreferenced;
+    {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      while (shard->tail != kNil &&
+             shard->records[shard->tail].last_access_ms < last_access_ms) {
+        EraseSlotLocked(shard.get(), shard->tail, &unreferenced);
+        ++removed;
+      }
+    }
+    DeleteBlobs(unreferenced);
+  }
+  return removed;
+}
+
+void DiskCache::Clear() {
+  for (auto& shard : shards_) {
+    std::vector<Digest> unreferenced;
+    {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      while (shard->tail != kNil) {
+        EraseSlotLocked(shard.get(), shard->tail, &unreferenced);
+      }
+    }
+    DeleteBlobs(unreferenced);
+  }
+}
+
+size_t DiskCache::CollectGarbage() {
+  size_t removed = 0;
+  std::lock_guard<std::mutex> lock(blob_mutex_);
+  std::error_code error;
+  std::vector<std::filesystem::path> orphans;
+  for (const auto& item :
+       std::filesystem::recursive_directory_iterator(blob_dir_, error)) {
+    std::error_code type_error;
+    if (!item.is_regular_file(type_error)) {
+      continue;
+    }
+    Digest digest;
+    if (!NameToDigest(item.path().filename().string(), &digest) ||
+        blobs_.find(digest) == blobs_.end()) {
+      orphans.push_back(item.path());
+    }
+  }
+  for (const auto& path : orphans) {
+    if (std::filesystem::remove(path, error)) {
+      ++removed;
+    }
+  }
+  return removed;
+}
+
+size_t DiskCache::EmptyTrash() {
+  size_t removed = 0;
+  std::error_code error;
+  for (const auto& item :
+       std::filesystem::directory_iterator(trash_dir_, error)) {
+    std::error_code remove_error;
+    const auto count = std::filesystem::remove_all(item.path(), remove_error);
+    if (count != static_cast<std::uintmax_t>(-1)) {
+      removed += static_cast<size_t>(count);
+    }
+  }
+  return removed;
+}
+
+void DiskCache::Flush() {
+  index_.Flush();
+}
+
+DiskCache::Stats DiskCache::stats() const {
+  Stats stats;
+  for (const auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    stats.entries += shard->count;
+    stats.bytes += shard->bytes;
+  }
+  stats.hits = hits_.load(std::memory_order_relaxed);
+  stats.misses = misses_.load(std::memory_order_relaxed);
+  stats.evictions = evictions_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+int64_t DiskCache::NowMillis() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+DiskCache::KeyHash DiskCache::HashKey(std::string_view key) {
+  return KeyHash{XxHash64(key.data(), key.size(), kKeySeed),
+                 XxHash64(key.data(), key.size())};
+}
+
+std::string DiskCache::DigestToName(const Digest& digest) {
+  static constexpr char kHexDigits[] = "0123456789abcdef";
+  std::string name(32, '0');
+  for (int i = 0; i < 16; ++i) {
+    const int shift = i * 4;
+    name[static_cast<size_t>(15 - i)] = kHexDigits[(digest.high >> shift) & 0xF];
+    name[static_cast<size_t>(31 - i)] = kHexDigits[(digest.low >> shift) & 0xF];
+  }
+  return name;
+}
+
+bool DiskCache::NameToDigest(const std::string& name, Digest* digest) {
+  if (name.size() != 32) {
+    return false;
+  }
+  uint64_t parts[2] = {0, 0};
+  for (size_t i = 0; i < 32; ++i) {
+    const char c = name[i];
+    uint64_t nibble;
+    if (c >= '0' && c <= '9') {
+      nibble = static_cast<uint64_t>(c - '0');
+    } else if (c >= 'a' && c <= 'f') {
+      nibble = static_cast<uint64_t>(c - 'a' + 10);
+    } else {
+      return false;
+    }
+    parts[i / 16] = (parts[i / 16] << 4) | nibble;
+  }
+  digest->high = parts[0];
+  digest->low = parts[1];
+  return true;
+}
+
+std::filesystem::path DiskCache::BlobPath(const Digest& digest) const {
+  const std::string name = DigestToName(digest);
+  return blob_dir_ / name.substr(0, 2) / name;
+}
+
+void DiskCache::MoveToTrash(const std::filesystem::path& directory) {
+  std::error_code error;
+  const bool empty = std::filesystem::is_empty(directory, error);
+  if (error || empty) {
+    std::filesystem::create_directories(directory, error);
+    return;
+  }
+  const std::filesystem::path target =
+      trash_dir_ / (directory.filename().string() + "." +
+                    std::to_string(NowMillis()) + "." +
+                    std::to_string(temp_counter_.fetch_add(1)));
+  std::filesystem::rename(directory, target, error);
+  if (error) {
+    // 改名失败（例如目录中有文件正被占用）时就地删除
+    for (const auto& item :
+         std::filesystem::directory_iterator(directory, error)) {
+      std::error_code remove_error;
+      std::filesystem::remove_all(item.path(), remove_error);
+    }
+  }
+  std::filesystem::create_directories(directory, error);
+}
+
+DiskCache::Shard& DiskCache::ShardFor(const KeyHash& key_hash) {
+  return *shards_[key_hash.low & (shard_count_ - 1)];
+}
+
+bool DiskCache::RetainBlob(const Digest& digest) {
+  std::unique_lock<std::mutex> lock(blob_mutex_);
+  // 持有引用期间记录不会被移除，引用保持有效
+  BlobState& state = blobs_[digest];
+  ++state.refs;
+  blob_installed_.wait(lock, [&state] { return !state.installing; });
+  if (state.installed) {
+    return false;
+  }
+  state.installing = true;
+  return true;
+}
+
+void DiskCache::FinishInstall(const Digest& digest, bool installed) {
+  {
+    std::lock_guard<std::mutex> lock(blob_mutex_);
+    BlobState& state = blobs_[digest];
+    state.installing = false;
+    state.installed = installed;
+  }
+  blob_installed_.notify_all();
+}
+
+void DiskCache::ReleaseBlob(const Digest& digest) {
+  std::vector<Digest> unreferenced;
+  {
+    std::lock_guard<std::mutex> lock(blob_mutex_);
+    ReleaseBlobLocked(digest, &unreferenced);
+  }
+  DeleteBlobs(unreferenced);
+}
+
+void DiskCache::ReleaseBlobLocked(const Digest& digest,
+                                  std::vector<Digest>* unreferenced) {
+  auto it = blobs_.find(digest);
+  if (it == blobs_.end()) {
+    return;
+  }
+  if (--it->second.refs == 0) {
+    blobs_.erase(it);
+    unreferenced->push_back(digest);
+  }
+}
+
+void DiskCache::DeleteBlobs(const std::vector<Digest>& digests) {
+  if (digests.empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(blob_mutex_);
+  for (const auto& digest : digests) {
+    if (blobs_.find(digest) != blobs_.end()) {
+      // 释放之后又被新的条目引用
+      continue;
+    }
+    std::error_code error;
+    std::filesystem::remove(BlobPath(digest), error);
+  }
+}
+
+bool DiskCache::InstallBlob(const std::filesystem::path& source,
+                            const Digest& digest) {
+  const std::filesystem::path target = BlobPath(digest);
+  std::error_code error;
+  std::filesystem::create_directories(target.parent_path(), error);
+  std::filesystem::rename(source, target, error);
+  if (!error) {
+    return true;
+  }
+  // 孤立的同名内容文件（或者正被读取、无法替换）：内容相同，保留原文件
+  std::error_code exists_error;
+  if (std::filesystem::exists(target, exists_error)) {
+    std::filesystem::remove(source, error);
+    return true;
+  }
+  return false;
+}
+
+bool DiskCache::Insert(const KeyHash& key_hash,
+                       const Digest& digest,
+                       uint64_t size,
+                       int64_t valid_till_ms,
+                       Entry* entry) {
+  Shard& shard = ShardFor(key_hash);
+  std::vector<Digest> unreferenced;
+  IndexRecord record;
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    // 覆盖已有条目时先整体移除，淘汰会移动槽位，不能持有旧的槽位号
+    const uint32_t existing = FindSlotLocked(shard, key_hash);
+    if (existing != kNil) {
+      EraseSlotLocked(&shard, existing, &unreferenced);
+    }
+    EvictLocked(&shard, size, 1, &unreferenced);
+
+    const uint32_t mask = slots_per_shard_ - 1;
+    uint32_t slot = static_cast<uint32_t>(key_hash.high) & mask;
+    while (shard.records[slot].state == kSlotUsed) {
+      slot = (slot + 1) & mask;
+    }
+    IndexRecord& stored = shard.records[slot];
+    stored.key_high = key_hash.high;
+    stored.key_low = key_hash.low;
+    stored.digest_high = digest.high;
+    stored.digest_low = digest.low;
+    stored.size = size;
+    stored.last_access_ms = NowMillis();
+    stored.valid_till_ms = valid_till_ms;
+    stored.state = kSlotUsed;
+    stored.checksum = RecordChecksum(&stored);
+    LinkFrontLocked(&shard, slot);
+    ++shard.count;
+    shard.bytes += size;
+    record = stored;
+  }
+  DeleteBlobs(unreferenced);
+  FillEntry(record, entry);
+  return true;
+}
+
+uint32_t DiskCache::FindSlotLocked(const Shard& shard,
+                                   const KeyHash& key_hash) const {
+  const uint32_t mask = slots_per_shard_ - 1;
+  uint32_t slot = static_cast<uint32_t>(key_hash.high) & mask;
+  while (shard.records[slot].state == kSlotUsed) {
+    const IndexRecord& record = shard.records[slot];
+    if (record.key_high == key_hash.high && record.key_low == key_hash.low) {
+      return slot;
+    }
+    slot = (slot + 1) & mask;
+  }
+  return kNil;
+}
+
+void DiskCache::EraseSlotLocked(Shard* shard,
+                                uint32_t slot,
+                                std::vector<Digest>* unreferenced) {
+  IndexRecord* records = shard->records;
+  shard->bytes -= records[slot].size;
+  --shard->count;
+  {
+    std::lock_guard<std::mutex> lock(blob_mutex_);
+    ReleaseBlobLocked(Digest{records[slot].digest_high,
+                             records[slot].digest_low},
+                      unreferenced);
+  }
+  UnlinkLocked(shard, slot);
+
+  // 线性探测的后移删除：把后面探测链上的记录前移填补空位，不留墓碑
+  const uint32_t mask = slots_per_shard_ - 1;
+  uint32_t hole = slot;
+  uint32_t next = (hole + 1) & mask;
+  while (records[next].state == kSlotUsed) {
+    const uint32_t home = static_cast<uint32_t>(records[next].key_high) & mask;
+    if (((next - home) & mask) >= ((next - hole) & mask)) {
+      MoveSlotLocked(shard, next, hole);
+      hole = next;
+    }
+    next = (next + 1) & mask;
+  }
+  std::memset(&records[hole], 0, sizeof(IndexRecord));
+  shard->links[hole] = Shard::Link();
+}
+
+void DiskCache::MoveSlotLocked(Shard* shard, uint32_t from, uint32_t to) {
+  shard->records[to] = shard->records[from];
+  const Shard::Link link = shard->links[from];
+  shard->links[to] = link;
+  if (link.prev != kNil) {
+    shard->links[link.prev].next = to;
+  } else {
+    shard->head = to;
+  }
+  if (link.next != kNil) {
+    shard->links[link.next].prev = to;
+  } else {
+    shard->tail = to;
+  }
+}
+
+void DiskCache::LinkFrontLocked(Shard* shard, uint32_t slot) {
+  Shard::Link& link = shard->links[slot];
+  link.prev = kNil;
+  link.next = shard->head;
+  if (shard->head != kNil) {
+    shard->links[shard->head].prev = slot;
+  } else {
+    shard->tail = slot;
+  }
+  shard->head = slot;
+}
+
+void DiskCache::UnlinkLocked(Shard* shard, uint32_t slot) {
+  Shard::Link& link = shard->links[slot];
+  if (link.prev != kNil) {
+    shard->links[link.prev].next = link.next;
+  } else {
+    shard->head = link.next;
+  }
+  if (link.next != kNil) {
+    shard->links[link.next].prev = link.prev;
+  } else {
+    shard->tail = link.prev;
+  }
+  link = Shard::Link();
+}
+
+void DiskCache::EvictLocked(Shard* shard,
+                            uint64_t incoming_bytes,
+                            uint32_t incoming_entries,
+                            std::vector<Digest>* unreferenced) {
+  while (shard->tail != kNil &&
+         (shard->bytes + incoming_bytes > shard_max_bytes_ ||
+          shard->count + incoming_entries > shard->max_count)) {
+    EraseSlotLocked(shard, shard->tail, unreferenced);
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void DiskCache::FillEntry(const IndexRecord& record, Entry* entry) const {
+  if (!entry) {
+    return;
+  }
+  entry->path = BlobPath(Digest{record.digest_high, record.digest_low});
+  entry->size = record.size;
+  entry->valid_till_ms = record.valid_till_ms;
+  entry->last_access_ms = record.last_access_ms;
+}
+
+void DiskCache::LoadIndex() {
+  // 把有效记录取出后重新插入：丢掉写了一半的记录后探测链可能断开，
+  // 重新插入最简单可靠。按访问时间从旧到新插入，得到正确的 LRU 顺序。
+  std::vector<Digest> unreferenced;
+  std::vector<IndexRecord> valid;
+  for (auto& shard : shards_) {
+    valid.clear();
+    for (uint32_t slot = 0; slot < slots_per_shard_; ++slot) {
+      const IndexRecord& record = shard->records[slot];
+      if (record.state == kSlotUsed &&
+          record.checksum == RecordChecksum(&record)) {
+        valid.push_back(record);
+      }
+    }
+    std::sort(valid.begin(), valid.end(),
+              [](const IndexRecord& a, const IndexRecord& b) {
+                return a.last_access_ms < b.last_access_ms;
+              });
+    std::memset(shard->records, 0,
+                static_cast<size_t>(slots_per_shard_) * sizeof(IndexRecord));
+
+    const uint32_t mask = slots_per_shard_ - 1;
+    for (const IndexRecord& record : valid) {
+      const KeyHash key_hash{record.key_high, record.key_low};
+      if (FindSlotLocked(*shard, key_hash) != kNil) {
+        continue;
+      }
+      EvictLocked(shard.get(), 0, 1, &unreferenced);
+      uint32_t slot = static_cast<uint32_t>(record.key_high) & mask;
+      while (shard->records[slot].state == kSlotUsed) {
+        slot = (slot + 1) & mask;
+      }
+      shard->records[slot] = record;
+      LinkFrontLocked(shard.get(), slot);
+      ++shard->count;
+      shard->bytes += record.size;
+      BlobState& blob = blobs_[Digest{record.digest_high, record.digest_low}];
+      ++blob.refs;
+      blob.installed = true;
+    }
+    // Options 中的字节上限可能比上次小
+    EvictLocked(shard.get(), 0, 0, &unreferenced);
+  }
+  DeleteBlobs(unreferenced);
+}
+
+void DiskCache::ResetIndex() {
+  std::memset(index_.mutable_data(), 0, index_.size());
+  IndexHeader header = {};
+  header.magic = kIndexMagic;
+  header.version = kIndexVersion;
+  header.shard_count = shard_count_;
+  header.slots_per_shard = slots_per_shard_;
+  std::memcpy(index_.mutable_data(), &header, sizeof(header));
+}
@@ -0,0 +1,202 @@
+#ifndef RUNNER_DISK_CACHE_H_
+#define RUNNER_DISK_CACHE_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "mapped_file.h"
+
+// 按内容寻址的磁盘缓存（与平台无关），用于网络图片。
+//
+// 目录结构：
+//   index.bin                 内存映射的索引（固定大小的开放寻址哈希表）
+//   blobs/ab/ab01...ef        内容文件，以内容 SHA-256 的前 128 位命名
+//   tmp/                      写入中的临时文件，打开缓存时移入 trash/
+//   trash/                    等待删除的旧文件，由 EmptyTrash 删除
+//
+// 索引按键的哈希分成若干分片，每个分片有自己的锁、哈希表区域和 LRU 链表，
+// 淘汰按字节数而不是条目数进行（每个分片负责总上限的 1/分片数）。内容相同
+// 的条目共享一个内容文件，最后一个引用被移除时才删除文件。内容文件先写到
+// tmp/ 再改名到 blobs/，不会出现写了一半的内容文件。
+class DiskCache {
+ public:
+  struct Options {
+    uint64_t max_bytes = 512ull << 20;
+    // 索引槽位总数，向上取整为分片数乘以 2 的幂。条目数最多为槽位数的 7/8。
+    uint32_t max_entries = 65536;
+  };
+
+  struct Entry {
+    std::filesystem::path path;
+    uint64_t size = 0;
+    int64_t valid_till_ms = 0;    // Unix 毫秒
+    int64_t last_access_ms = 0;   // Unix 毫秒
+  };
+
+  struct Stats {
+    uint64_t entries = 0;
+    uint64_t bytes = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+  };
+
+  DiskCache(std::filesystem::path directory, const Options& options);
+  ~DiskCache();
+
+  DiskCache(const DiskCache&) = delete;
+  DiskCache& operator=(const DiskCache&) = delete;
+
+  // 创建目录、映射并加载索引。索引不存在、损坏或与 Options 不匹配时
+  // 重建索引，原有的内容文件连同上次留下的临时文件整体改名移入 trash/，
+  // 打开的耗时与文件数量无关。
+  bool Open();
+
+  // 删除 trash/ 中的文件，返回删除的数量。可以在后台线程上与其它方法
+  // 同时调用。
+  size_t EmptyTrash();
+
+  // 以下方法可以在多个线程上同时调用。
+
+  // 命中时更新访问时间并返回 true。不检查内容文件是否还在。
+  bool Lookup(std::string_view key, Entry* entry);
+
+  // 写入 |data|。单个条目超过分片容量时返回 false。
+  bool Put(std::string_view key,
+           const void* data,
+           size_t size,
+           int64_t valid_till_ms,
+           Entry* entry = nullptr);
+
+  // 把已经写好的 |source| 移入缓存。|source| 应位于 temp_directory() 中
+  // （同一卷上改名即可完成）。成功时 |source| 被移走，失败时保持不变。
+  bool PutFile(std::string_view key,
+               const std::filesystem::path& source,
+               int64_t valid_till_ms,
+               Entry* entry = nullptr);
+
+  bool Remove(std::string_view key);
+
+  // 移除最后访问时间早于 |last_access_ms| 的条目，返回移除的数量。
+  size_t RemoveOlderThan(int64_t last_access_ms);
+
+  // 移除所有条目和内容文件。
+  void Clear();
+
+  // 删除没有被任何条目引用的内容文件（例如进程在改名之后、写索引之前
+  // 退出留下的文件），返回删除的数量。会遍历整个 blobs/ 目录。
+  size_t CollectGarbage();
+
+  // 把索引中已修改的页写回磁盘。
+  void Flush();
+
+  const std::filesystem::path& temp_directory() const { return temp_dir_; }
+  Stats stats() const;
+
+  static int64_t NowMillis();
+
+ private:
+  struct Digest {
+    uint64_t high = 0;
+    uint64_t low = 0;
+    bool operator==(const Digest& other) const {
+      return high == other.high && low == other.low;
+    }
+  };
+  struct DigestHash {
+    size_t operator()(const Digest& digest) const {
+      return static_cast<size_t>(digest.low);
+    }
+  };
+  struct KeyHash {
+    uint64_t high = 0;
+    uint64_t low = 0;
+  };
+  // 内容文件的引用计数和写入状态。同一内容同时写入时只有一个线程写文件，
+  // 其它线程等它完成，失败时由等待的线程接着写。
+  struct BlobState {
+    uint32_t refs = 0;
+    bool installing = false;
+    bool installed = false;
+  };
+  struct IndexRecord;
+  struct Shard;
+
+  static KeyHash HashKey(std::string_view key);
+  static std::string DigestToName(const Digest& digest);
+  static bool NameToDigest(const std::string& name, Digest* digest);
+
+  std::filesystem::path BlobPath(const Digest& digest) const;
+  // 把 |directory| 改名移入 trash/ 并重新创建为空目录。
+  void MoveToTrash(const std::filesystem::path& directory);
+  Shard& ShardFor(const KeyHash& key_hash);
+
+  // 增加内容文件的引用，返回调用方是否需要写入内容文件。另一个线程正在
+  // 写入同一内容时等待其完成。返回 true 时调用方写完后必须调用 FinishInstall。
+  bool RetainBlob(const Digest& digest);
+  void FinishInstall(const Digest& digest, bool installed);
+  // 减少引用，引用归零时删除内容文件。调用方不能持有任何锁。
+  void ReleaseBlob(const Digest& digest);
+  // 同上，但要求持有 blob_mutex_，引用归零的内容文件追加到 |unreferenced|。
+  void ReleaseBlobLocked(const Digest& digest,
+                         std::vector<Digest>* unreferenced);
+  // 删除仍然没有引用的内容文件。调用方不能持有分片锁。
+  void DeleteBlobs(const std::vector<Digest>& digests);
+
+  // 把内容文件放到位：|source| 改名为内容文件，目标已存在时删除 |source|。
+  bool InstallBlob(const std::filesystem::path& source, const Digest& digest);
+  bool Insert(const KeyHash& key_hash,
+              const Digest& digest,
+              uint64_t size,
+              int64_t valid_till_ms,
+              Entry* entry);
+
+  // 以下方法要求持有 |shard| 的锁。
+  uint32_t FindSlotLocked(const Shard& shard, const KeyHash& key_hash) const;
+  void EraseSlotLocked(Shard* shard,
+                       uint32_t slot,
+                       std::vector<Digest>* unreferenced);
+  void MoveSlotLocked(Shard* shard, uint32_t from, uint32_t to);
+  void LinkFrontLocked(Shard* shard, uint32_t slot);
+  void UnlinkLocked(Shard* shard, uint32_t slot);
+  void EvictLocked(Shard* shard,
+                   uint64_t incoming_bytes,
+                   uint32_t incoming_entries,
+                   std::vector<Digest>* unreferenced);
+  void FillEntry(const IndexRecord& record, Entry* entry) const;
+
+  void LoadIndex();
+  void ResetIndex();
+
+  const std::filesystem::path directory_;
+  const std::filesystem::path blob_dir_;
+  const std::filesystem::path temp_dir_;
+  const std::filesystem::path trash_dir_;
+  Options options_;
+  uint32_t shard_count_ = 0;
+  uint32_t slots_per_shard_ = 0;
+  uint64_t shard_max_bytes_ = 0;
+
+  MappedFile index_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  std::mutex blob_mutex_;
+  std::condition_variable blob_installed_;
+  std::unordered_map<Digest, BlobState, DigestHash> blobs_;
+
+  std::atomic<uint64_t> temp_counter_{0};
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> evictions_{0};
+};
+
+#endif  // RUNNER_DISK_CACHE_H_
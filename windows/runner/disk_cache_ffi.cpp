@@ -0,0 +1,178 @@
+#include "disk_cache_ffi.h"
+
+#include <windows.h>
+
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "disk_cache.h"
+#include "utils.h"
+
+namespace {
+
+constexpr wchar_t kDiskCacheDirName[] = L"disk_cache";
+
+bool IsValidCacheName(const std::string& name) {
+  if (name.empty() || name.size() > 64) {
+    return false;
+  }
+  for (char c : name) {
+    const bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                       (c >= '0' && c <= '9') || c == '_' || c == '-';
+    if (!valid) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int32_t CopyPath(const std::filesystem::path& value,
+                 char* buffer,
+                 int32_t capacity) {
+  const std::string utf8 = Utf8FromUtf16(value.c_str());
+  if (utf8.empty() || capacity <= 0 ||
+      utf8.size() >= static_cast<size_t>(capacity)) {
+    return -1;
+  }
+  std::memcpy(buffer, utf8.data(), utf8.size());
+  buffer[utf8.size()] = '\0';
+  return static_cast<int32_t>(utf8.size());
+}
+
+void CopyEntry(const DiskCache::Entry& from, RunnerDiskCacheEntry* to) {
+  to->size = static_cast<int64_t>(from.size);
+  to->valid_till_ms = from.valid_till_ms;
+  to->last_access_ms = from.last_access_ms;
+}
+
+DiskCache* AsCache(void* cache) {
+  return static_cast<DiskCache*>(cache);
+}
+
+}  // namespace
+
+DiskCache* OpenNamedDiskCache(const std::string& name,
+                              uint64_t max_bytes,
+                              uint32_t max_entries) {
+  // 不析构：Dart 侧可能在任何时候持有句柄
+  static std::mutex* mutex = new std::mutex();
+  static auto* caches = new std::map<std::string, DiskCache*>();
+
+  if (!IsValidCacheName(name) || max_bytes == 0 || max_entries == 0) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(*mutex);
+  auto it = caches->find(name);
+  if (it != caches->end()) {
+    return it->second;
+  }
+  const std::wstring app_data_dir = GetAppDataDirectory();
+  if (app_data_dir.empty()) {
+    return nullptr;
+  }
+  DiskCache::Options options;
+  options.max_bytes = max_bytes;
+  options.max_entries = max_entries;
+  auto cache = std::make_unique<DiskCache>(
+      std::filesystem::path(app_data_dir) / kDiskCacheDirName /
+          Utf16FromUtf8(name),
+      options);
+  if (!cache->Open()) {
+    return nullptr;
+  }
+  DiskCache* raw = cache.release();
+  caches->emplace(name, raw);
+  // 旧文件可能有上万个，在后台删除，不阻塞调用 open 的 Dart 线程。缓存
+  // 不会析构，线程可以分离。
+  std::thread([raw] { raw->EmptyTrash(); }).detach();
+  return raw;
+}
+
+void* runner_disk_cache_open(const char* name,
+                             int64_t max_bytes,
+                             int32_t max_entries) {
+  if (!name || max_bytes <= 0 || max_entries <= 0) {
+    return nullptr;
+  }
+  return OpenNamedDiskCache(name, static_cast<uint64_t>(max_bytes),
+                            static_cast<uint32_t>(max_entries));
+}
+
+int32_t runner_disk_cache_lookup(void* cache,
+                                 const char* key,
+                                 RunnerDiskCacheEntry* entry,
+                                 char* path,
+                                 int32_t path_capacity) {
+  DiskCache::Entry found;
+  if (!cache || !key || !AsCache(cache)->Lookup(key, &found)) {
+    return 0;
+  }
+  CopyEntry(found, entry);
+  return CopyPath(found.path, path, path_capacity);
+}
+
+int32_t runner_disk_cache_put_file(void* cache,
+                                   const char* key,
+                                   const char* source_path,
+                                   int64_t valid_till_ms,
+                                   RunnerDiskCacheEntry* entry,
+                                   char* path,
+                                   int32_t path_capacity) {
+  DiskCache::Entry stored;
+  if (!cache || !key || !source_path ||
+      !AsCache(cache)->PutFile(key,
+                               std::filesystem::path(
+                                   Utf16FromUtf8(source_path)),
+                               valid_till_ms, &stored)) {
+    return 0;
+  }
+  CopyEntry(stored, entry);
+  return CopyPath(stored.path, path, path_capacity);
+}
+
+int32_t runner_disk_cache_remove(void* cache, const char* key) {
+  if (!cache || !key) {
+    return 0;
+  }
+  return AsCache(cache)->Remove(key) ? 1 : 0;
+}
+
+int64_t runner_disk_cache_remove_older_than(void* cache,
+                                            int64_t last_access_ms) {
+  if (!cache) {
+    return 0;
+  }
+  return static_cast<int64_t>(AsCache(cache)->RemoveOlderThan(last_access_ms));
+}
+
+void runner_disk_cache_clear(void* cache) {
+  if (cache) {
+    AsCache(cache)->Clear();
+  }
+}
+
+int32_t runner_disk_cache_temp_directory(void* cache,
+                                         char* path,
+                                         int32_t path_capacity) {
+  if (!cache) {
+    return -1;
+  }
+  return CopyPath(AsCache(cache)->temp_directory(), path, path_capacity);
+}
+
+void runner_disk_cache_stats(void* cache, RunnerDiskCacheStats* stats) {
+  DiskCache::Stats values;
+  if (cache) {
+    values = AsCache(cache)->stats();
+  }
+  stats->entries = static_cast<int64_t>(values.entries);
+  stats->bytes = static_cast<int64_t>(values.bytes);
+  stats->hits = static_cast<int64_t>(values.hits);
+  stats->misses = static_cast<int64_t>(values.misses);
+  stats->evictions = static_cast<int64_t>(values.evictions);
+}
@@ -0,0 +1,80 @@
+#ifndef RUNNER_DISK_CACHE_FFI_H_
+#define RUNNER_DISK_CACHE_FFI_H_
+
+#include <cstdint>
+#include <string>
+
+#include "ffi_export.h"
+
+class DiskCache;
+
+// DiskCache 的 C 接口，供 lib/windows/native/native_disk_cache.dart 使用。
+// 结构体布局必须和 Dart 侧的 Struct 定义一致。
+//
+// 缓存按名称打开，位于 %LOCALAPPDATA%\suxingchahui\disk_cache\<name>，
+// 同名缓存只打开一次，句柄在进程退出前一直有效。字符串均为 UTF-8。
+
+struct RunnerDiskCacheEntry {
+  int64_t size;
+  int64_t valid_till_ms;
+  int64_t last_access_ms;
+};
+
+struct RunnerDiskCacheStats {
+  int64_t entries;
+  int64_t bytes;
+  int64_t hits;
+  int64_t misses;
+  int64_t evictions;
+};
+
+// 打开（或取得已经打开的）同名缓存，原生代码和 Dart 共用同一个实例。
+// 失败时返回 nullptr。|name| 只能包含字母、数字、'_' 和 '-'。同名缓存
+// 已经打开时忽略 |max_bytes| 和 |max_entries|。
+DiskCache* OpenNamedDiskCache(const std::string& name,
+                              uint64_t max_bytes,
+                              uint32_t max_entries);
+
+// 失败时返回 nullptr。|name| 只能包含字母、数字、'_' 和 '-'。
+RUNNER_FFI_EXPORT void* runner_disk_cache_open(const char* name,
+                                               int64_t max_bytes,
+                                               int32_t max_entries);
+
+// 命中时返回内容文件路径的字节数并写入 |path|，未命中返回 0，
+// |path_capacity| 不足时返回 -1。
+RUNNER_FFI_EXPORT int32_t runner_disk_cache_lookup(void* cache,
+                                                   const char* key,
+                                                   RunnerDiskCacheEntry* entry,
+                                                   char* path,
+                                                   int32_t path_capacity);
+
+// 把 |source_path| 移入缓存，返回值同 runner_disk_cache_lookup，
+// 失败时返回 0 且 |source_path| 保持不变。
+RUNNER_FFI_EXPORT int32_t runner_disk_cache_put_file(
+    void* cache,
+    const char* key,
+    const char* source_path,
+    int64_t valid_till_ms,
+    RunnerDiskCacheEntry* entry,
+    char* path,
+    int32_t path_capacity);
+
+RUNNER_FFI_EXPORT int32_t runner_disk_cache_remove(void* cache,
+                                                   const char* key);
+
+RUNNER_FFI_EXPORT int64_t runner_disk_cache_remove_older_than(
+    void* cache,
+    int64_t last_access_ms);
+
+RUNNER_FFI_EXPORT void runner_disk_cache_clear(void* cache);
+
+// 写入临时目录路径（下载时先写到这里再调用 put_file），返回值同 lookup。
+RUNNER_FFI_EXPORT int32_t runner_disk_cache_temp_directory(
+    void* cache,
+    char* path,
+    int32_t path_capacity);
+
+RUNNER_FFI_EXPORT void runner_disk_cache_stats(void* cache,
+                                               RunnerDiskCacheStats* stats);
+
+#endif  // RUNNER_DISK_CACHE_FFI_H_
@@ -0,0 +1,333 @@
+#include "download_channel.h"
+
+#include <flutter/event_stream_handler_functions.h>
+#include <flutter/standard_method_codec.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cwchar>
+#include <filesystem>
+#include <optional>
+#include <utility>
+
+#include "cert_pinning.h"
+#include "method_channel_utils.h"
+#include "pre_init_window.h"
+#include "utils.h"
+#include "winhttp_connection.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kChannelName[] = "com.example.suxingchahui/download";
+constexpr char kEventChannelName[] =
+    "com.example.suxingchahui/download_events";
+constexpr int64_t kMaxConnections = 8;
+constexpr wchar_t kDefaultFileName[] = L"download";
+
+using flutter::EncodableMap;
+using flutter::EncodableValue;
+
+HttpConnectionPool::Options PoolOptions() {
+  HttpConnectionPool::Options options;
+  // 三个下载、每个最多八条连接，通常都在同一个网盘域名下
+  options.max_connections_per_host = 3 * kMaxConnections;
+  options.idle_timeout = std::chrono::seconds(30);
+  return options;
+}
+
+// 去掉 Windows 文件名里不允许的字符和结尾的点、空格。
+std::wstring SanitizeFileName(const std::wstring& name) {
+  std::wstring result;
+  result.reserve(name.size());
+  for (wchar_t c : name) {
+    if (c < 0x20 || wcschr(L"<>:\"/\\|?*", c)) {
+      result.push_back(L'_');
+    } else {
+      result.push_back(c);
+    }
+  }
+  while (!result.empty() && (result.back() == L'.' || result.back() == L' ')) {
+    result.pop_back();
+  }
+  return result.empty() ? kDefaultFileName : result;
+}
+
+const char* StateName(DownloadStatus status) {
+  switch (status) {
+    case DownloadStatus::kCompleted:
+      return "completed";
+    case DownloadStatus::kPaused:
+      return "paused";
+    case DownloadStatus::kFailed:
+      return "failed";
+  }
+  return "failed";
+}
+
+EncodableMap EncodeProgress(const std::string& id,
+                            const char* state,
+                            const DownloadProgress& progress) {
+  return EncodableMap{
+      {EncodableValue("id"), EncodableValue(id)},
+      {EncodableValue("state"), EncodableValue(state)},
+      {EncodableValue("totalBytes"),
+       EncodableValue(static_cast<int64_t>(progress.total_size))},
+      {EncodableValue("receivedBytes"),
+       EncodableValue(static_cast<int64_t>(progress.received))},
+      {EncodableValue("verifiedBytes"),
+       EncodableValue(static_cast<int64_t>(progress.verified))},
+      {EncodableValue("bytesPerSecond"),
+       EncodableValue(progress.bytes_per_second)},
+      {EncodableValue("connections"),
+       EncodableValue(static_cast<int64_t>(progress.connections))},
+      {EncodableValue("segments"),
+       EncodableValue(static_cast<int64_t>(progress.segments))},
+  };
+}
+
+EncodableValue EncodeProbe(const DownloadProbe& probe) {
+  return EncodableValue(EncodableMap{
+      {EncodableValue("statusCode"), EncodableValue(probe.status_code)},
+      {EncodableValue("rangeSupported"), EncodableValue(probe.ranges)},
+      {EncodableValue("totalBytes"),
+       EncodableValue(static_cast<int64_t>(probe.total_size))},
+      {EncodableValue("contentType"), EncodableValue(probe.content_type)},
+      {EncodableValue("fileName"), EncodableValue(probe.file_name)},
+  });
+}
+
+}  // namespace
+
+DownloadChannel::DownloadChannel(
+    flutter::BinaryMessenger* messenger,
+    std::shared_ptr<PlatformTaskRunner> task_runner)
+    : channel_(std::make_unique<flutter::MethodChannel<EncodableValue>>(
+          messenger, kChannelName,
+          &flutter::StandardMethodCodec::GetInstance())),
+      event_channel_(std::make_unique<flutter::EventChannel<EncodableValue>>(
+          messenger, kEventChannelName,
+          &flutter::StandardMethodCodec::GetInstance())),
+      events_(std::make_shared<EventSinkHolder>()),
+      task_runner_(std::move(task_runner)),
+      pool_(std::make_unique<HttpConnectionPool>(
+          std::make_unique<WinHttpConnectionFactory>(
+              [](const std::string& hostname, PCCERT_CONTEXT certificate) {
+                return PreInitWindow::ValidateServerCertificate(
+                    hostname.c_str(), certificate);
+              }),
+          PoolOptions())) {
+  channel_->SetMethodCallHandler(
+      [this](const auto& call, auto result) {
+        HandleMethodCall(call, std::move(result));
+      });
+  event_channel_->SetStreamHandler(
+      std::make_unique<flutter::StreamHandlerFunctions<EncodableValue>>(
+          [events = events_](
+              const EncodableValue* /*arguments*/,
+              std::unique_ptr<flutter::EventSink<EncodableValue>>&& sink)
+              -> std::unique_ptr<flutter::StreamHandlerError<EncodableValue>> {
+            events->sink = std::move(sink);
+            return nullptr;
+          },
+          [events = events_](const EncodableValue* /*arguments*/)
+              -> std::unique_ptr<flutter::StreamHandlerError<EncodableValue>> {
+            events->sink = nullptr;
+            return nullptr;
+          }));
+}
+
+DownloadChannel::~DownloadChannel() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& entry : jobs_) {
+    entry.second->download->Pause();
+  }
+}
+
+void DownloadChannel::HandleMethodCall(
+    const flutter::MethodCall<EncodableValue>& call,
+    std::unique_ptr<flutter::MethodResult<EncodableValue>> result) {
+  const std::string& method = call.method_name();
+  if (method == "probe") {
+    HandleProbe(call.arguments(), std::move(result));
+    return;
+  }
+  if (method == "start") {
+    HandleStart(call.arguments(), std::move(result));
+    return;
+  }
+  if (method == "pause" || method == "cancel") {
+    HandleStop(call.arguments(), method == "cancel", std::move(result));
+    return;
+  }
+  result->NotImplemented();
+}
+
+void DownloadChannel::HandleProbe(
+    const EncodableValue* arguments,
+    std::unique_ptr<flutter::MethodResult<EncodableValue>> result) {
+  const auto url = GetStringArgument(arguments, "url");
+  if (!url) {
+    result->Error("bad_args", "Missing url");
+    return;
+  }
+  std::shared_ptr<flutter::MethodResult<EncodableValue>> shared_result =
+      std::move(result);
+  std::weak_ptr<PlatformTaskRunner> weak_runner = task_runner_;
+  workers_.Post([pool = pool_.get(), weak_runner, shared_result, url = *url]() {
+    DownloadProbe probe;
+    std::string error;
+    const bool ok = ProbeDownload(pool, url, &probe, &error);
+    auto runner = weak_runner.lock();
+    if (!runner) {
+      return;
+    }
+    runner->PostTask([shared_result, ok, probe = std::move(probe),
+                      error = std::move(error)]() {
+      if (ok) {
+        shared_result->Success(EncodeProbe(probe));
+      } else {
+        shared_result->Error("probe_failed", error);
+      }
+    });
+  });
+}
+
+void DownloadChannel::HandleStart(
+    const EncodableValue* arguments,
+    std::unique_ptr<flutter::MethodResult<EncodableValue>> result) {
+  const auto id = GetStringArgument(arguments, "id");
+  const auto url = GetStringArgument(arguments, "url");
+  const auto file_name = GetStringArgument(arguments, "fileName");
+  if (!id || !url || !file_name) {
+    result->Error("bad_args", "Missing id, url or fileName");
+    return;
+  }
+  std::optional<Sha256Digest> expected;
+  if (const auto sha256 = GetStringArgument(arguments, "sha256")) {
+    Sha256Digest digest;
+    if (!ParsePin(*sha256, &digest)) {
+      result->Error("bad_args", "sha256 must be 64 hex digits");
+      return;
+    }
+    expected = digest;
+  }
+  std::wstring directory;
+  if (const auto argument = GetStringArgument(arguments, "directory")) {
+    directory = Utf16FromUtf8(*argument);
+  } else {
+    directory = GetDownloadsDirectory();
+  }
+  if (directory.empty()) {
+    result->Error("no_directory", "Unable to locate the download directory");
+    return;
+  }
+
+  DownloadOptions options;
+  if (const auto connections = GetIntArgument(arguments, "connections")) {
+    options.max_connections =
+        static_cast<size_t>(std::clamp<int64_t>(*connections, 1,
+                                                kMaxConnections));
+  }
+  auto job = std::make_shared<Job>();
+  job->destination = fs::path(directory) /
+                     SanitizeFileName(Utf16FromUtf8(*file_name));
+  job->download = std::make_shared<SegmentedDownload>(pool_.get(), *url,
+                                                      job->destination,
+                                                      options);
+  if (expected) {
+    job->download->set_expected_sha256(*expected);
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : jobs_) {
+      if (entry.first == *id || entry.second->destination == job->destination) {
+        result->Error("already_running", "The download is already running");
+        return;
+      }
+    }
+    jobs_[*id] = job;
+  }
+  const std::string path = Utf8FromUtf16(job->destination.c_str());
+  result->Success(EncodableValue(path));
+
+  workers_.Post([this, id = *id, job, path]() {
+    DownloadProgress progress;
+    const DownloadResult outcome = job->download->Run(
+        [this, &id, &progress](const DownloadProgress& current) {
+          progress = current;
+          PostEvent(EncodableValue(EncodeProgress(id, "running", progress)));
+        });
+    bool cancelled = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cancelled = job->cancelled;
+      jobs_.erase(id);
+    }
+    if (cancelled) {
+      SegmentedDownload::Discard(job->destination);
+    }
+
+    progress.bytes_per_second = 0.0;
+    progress.connections = 0;
+    if (outcome.status == DownloadStatus::kCompleted) {
+      progress.total_size = outcome.size;
+      progress.received = outcome.size;
+      progress.verified = outcome.size;
+    }
+    EncodableMap event = EncodeProgress(
+        id, cancelled ? "cancelled" : StateName(outcome.status), progress);
+    event[EncodableValue("path")] = EncodableValue(path);
+    event[EncodableValue("resumedBytes")] =
+        EncodableValue(static_cast<int64_t>(outcome.resumed_from));
+    if (outcome.status == DownloadStatus::kCompleted) {
+      event[EncodableValue("sha256")] =
+          EncodableValue(DigestToHex(outcome.sha256));
+    } else if (outcome.status == DownloadStatus::kFailed && !cancelled) {
+      event[EncodableValue("error")] = EncodableValue(outcome.error);
+      event[EncodableValue("checksumMismatch")] =
+          EncodableValue(outcome.checksum_mismatch);
+    }
+    PostEvent(EncodableValue(std::move(event)));
+  });
+}
+
+void DownloadChannel::HandleStop(
+    const EncodableValue* arguments,
+    bool cancel,
+    std::unique_ptr<flutter::MethodResult<EncodableValue>> result) {
+  const auto id = GetStringArgument(arguments, "id");
+  if (!id) {
+    result->Error("bad_args", "Missing id");
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = jobs_.find(*id);
+    if (it != jobs_.end()) {
+      // 工作线程在 Run 返回后删除文件并发送事件
+      it->second->cancelled = it->second->cancelled || cancel;
+      it->second->download->Pause();
+      result->Success(EncodableValue(true));
+      return;
+    }
+  }
+  if (cancel) {
+    if (const auto path = GetStringArgument(arguments, "path")) {
+      SegmentedDownload::Discard(fs::path(Utf16FromUtf8(*path)));
+    }
+  }
+  result->Success(EncodableValue(false));
+}
+
+void DownloadChannel::PostEvent(EncodableValue event) {
+  std::weak_ptr<EventSinkHolder> weak_events = events_;
+  task_runner_->PostTask([weak_events, event = std::move(event)]() {
+    auto events = weak_events.lock();
+    if (events && events->sink) {
+      events->sink->Success(event);
+    }
+  });
+}
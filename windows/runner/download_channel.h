@@ -0,0 +1,95 @@
+#ifndef RUNNER_DOWNLOAD_CHANNEL_H_
+#define RUNNER_DOWNLOAD_CHANNEL_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+#include <flutter/event_channel.h>
+#include <flutter/event_sink.h>
+#include <flutter/method_channel.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "http_connection_pool.h"
+#include "platform_task_runner.h"
+#include "segmented_download.h"
+#include "thread_pool.h"
+
+// 游戏直链的分段、可续传下载，见 segmented_download.h。
+//
+// 通道：com.example.suxingchahui/download
+//   probe {url}
+//       -> {statusCode, rangeSupported, totalBytes, contentType, fileName}
+//       totalBytes 为 0 表示未知
+//   start {id, url, fileName, directory?, sha256?, connections?} -> path
+//       下载到 directory（默认为系统的“下载”文件夹）下的 fileName，返回
+//       目标路径。同一路径有未完成的下载时从上次的位置继续。sha256 为
+//       64 位十六进制，给出时完成后校验，不一致则删除文件
+//   pause {id}           暂停，保留 .part 和日志以便续传
+//   cancel {id, path?}   停止并删除未完成的文件；path 为 start 返回的路径，
+//                        用于取消已经暂停的下载
+//
+// 通道：com.example.suxingchahui/download_events（EventChannel）
+//   {id, state, totalBytes, receivedBytes, verifiedBytes, bytesPerSecond,
+//    connections, segments}
+//   state 为 running、completed、paused、cancelled 或 failed；结束的事件
+//   另有 path、resumedBytes，completed 有 sha256，failed 有 error 和
+//   checksumMismatch。
+class DownloadChannel {
+ public:
+  DownloadChannel(flutter::BinaryMessenger* messenger,
+                  std::shared_ptr<PlatformTaskRunner> task_runner);
+  // 暂停所有下载并等待它们写好日志。
+  ~DownloadChannel();
+
+  DownloadChannel(const DownloadChannel&) = delete;
+  DownloadChannel& operator=(const DownloadChannel&) = delete;
+
+ private:
+  // 只在平台线程上使用。
+  struct EventSinkHolder {
+    std::unique_ptr<flutter::EventSink<flutter::EncodableValue>> sink;
+  };
+
+  struct Job {
+    std::shared_ptr<SegmentedDownload> download;
+    std::filesystem::path destination;
+    bool cancelled = false;
+  };
+
+  void HandleMethodCall(
+      const flutter::MethodCall<flutter::EncodableValue>& call,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleProbe(
+      const flutter::EncodableValue* arguments,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+  void HandleStart(
+      const flutter::EncodableValue* arguments,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+  void HandleStop(
+      const flutter::EncodableValue* arguments,
+      bool cancel,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  // 可以在任意线程调用。
+  void PostEvent(flutter::EncodableValue event);
+
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> channel_;
+  std::unique_ptr<flutter::EventChannel<flutter::EncodableValue>>
+      event_channel_;
+  std::shared_ptr<EventSinkHolder> events_;
+  std::shared_ptr<PlatformTaskRunner> task_runner_;
+  // 单独的连接池：下载占用的连接不影响 API 请求。
+  std::unique_ptr<HttpConnectionPool> pool_;
+
+  std::mutex mutex_;
+  std::map<std::string, std::shared_ptr<Job>> jobs_;  // 按 id，未结束的下载
+
+  // 同时进行的下载数，多出的排队。最后声明，最先析构。
+  ThreadPool workers_{3};
+};
+
+#endif  // RUNNER_DOWNLOAD_CHANNEL_H_
@@ -0,0 +1,326 @@
+#include "feed_merger.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <unordered_set>
+
+namespace {
+
+void Emit(std::vector<FeedMerger::Op>* ops,
+          FeedMerger::OpKind kind,
+          FeedMerger::Scope scope,
+          size_t index,
+          uint32_t key) {
+  const FeedMerger::Op op{kind, scope, 0, static_cast<uint32_t>(index), key};
+  // 同一批里同一行的连续更新只保留一次
+  if (kind == FeedMerger::OpKind::kUpdate && !ops->empty()) {
+    const FeedMerger::Op& last = ops->back();
+    if (last.kind == kind && last.scope == scope && last.index == op.index &&
+        last.key == key) {
+      return;
+    }
+  }
+  ops->push_back(op);
+}
+
+}  // namespace
+
+void FeedMerger::Merge(const Item* items,
+                       const size_t* page_sizes,
+                       size_t page_count,
+                       std::vector<Op>* ops) {
+  // 多路归并：每页一个游标，堆顶是各页当前最新的一条
+  struct Cursor {
+    const Item* next;
+    const Item* end;
+  };
+  auto older = [](const Cursor& a, const Cursor& b) {
+    return KeyOf(*a.next) < KeyOf(*b.next);
+  };
+  std::priority_queue<Cursor, std::vector<Cursor>, decltype(older)> heap(
+      older);
+  const Item* cursor = items;
+  size_t total = 0;
+  for (size_t page = 0; page < page_count; ++page) {
+    if (page_sizes[page] > 0) {
+      heap.push({cursor, cursor + page_sizes[page]});
+    }
+    cursor += page_sizes[page];
+    total += page_sizes[page];
+  }
+  std::vector<Item> run;
+  run.reserve(total);
+  std::unordered_set<uint32_t> seen;
+  while (!heap.empty()) {
+    Cursor top = heap.top();
+    heap.pop();
+    if (seen.insert(top.next->id).second) {
+      run.push_back(*top.next);
+    }
+    if (++top.next != top.end) {
+      heap.push(top);
+    }
+  }
+
+  std::vector<Item> fresh;
+  for (const Item& item : run) {
+    Upsert(item, &fresh, ops);
+  }
+  InsertFresh(&fresh, ops);
+}
+
+void FeedMerger::Replace(const Item* items,
+                         size_t count,
+                         std::vector<Op>* ops) {
+  std::unordered_map<uint32_t, size_t> wanted;
+  wanted.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    wanted[items[i].id] = i;  // 重复的 ID 以最后一条为准
+  }
+
+  // 先删除不再出现的条目。按位置递增删除，下标是已保留的条数
+  std::vector<SortKey> kept;
+  kept.reserve(timeline_.size());
+  std::vector<Item> removed;
+  for (const SortKey& key : timeline_) {
+    if (wanted.count(key.second)) {
+      kept.push_back(key);
+      continue;
+    }
+    Emit(ops, OpKind::kRemove, Scope::kList, kept.size(), key.second);
+    removed.push_back(items_[key.second]);
+  }
+  timeline_.swap(kept);
+  for (const Item& item : removed) {
+    GroupRemove(Scope::kUserGroups, item.user, KeyOf(item), ops);
+    GroupRemove(Scope::kTypeGroups, item.type, KeyOf(item), ops);
+    items_.erase(item.id);
+  }
+
+  std::vector<Item> fresh;
+  for (const auto& [id, index] : wanted) {
+    Upsert(items[index], &fresh, ops);
+  }
+  InsertFresh(&fresh, ops);
+}
+
+void FeedMerger::Remove(uint32_t id, std::vector<Op>* ops) {
+  auto it = items_.find(id);
+  if (it != items_.end()) {
+    Erase(it->second, ops);
+  }
+}
+
+void FeedMerger::Clear() {
+  timeline_.clear();
+  items_.clear();
+  user_groups_ = GroupIndex();
+  type_groups_ = GroupIndex();
+}
+
+void FeedMerger::Members(Scope scope,
+                         uint32_t key,
+                         std::vector<uint32_t>* ids) const {
+  ids->clear();
+  if (scope == Scope::kList) {
+    return;
+  }
+  const GroupIndex& index = Groups(scope);
+  auto it = index.groups.find(key);
+  if (it == index.groups.end()) {
+    return;
+  }
+  ids->reserve(it->second.members.size());
+  for (auto member = it->second.members.rbegin();
+       member != it->second.members.rend(); ++member) {
+    ids->push_back(member->second);
+  }
+}
+
+size_t FeedMerger::TimelineIndex(const SortKey& key) const {
+  return static_cast<size_t>(
+      std::lower_bound(timeline_.begin(), timeline_.end(), key,
+                       std::greater<SortKey>()) -
+      timeline_.begin());
+}
+
+void FeedMerger::Erase(const Item& item, std::vector<Op>* ops) {
+  // |item| 可能引用 items_ 中的元素，先复制
+  const Item copy = item;
+  const SortKey key = KeyOf(copy);
+  const size_t index = TimelineIndex(key);
+  timeline_.erase(timeline_.begin() + static_cast<ptrdiff_t>(index));
+  Emit(ops, OpKind::kRemove, Scope::kList, index, copy.id);
+  GroupRemove(Scope::kUserGroups, copy.user, key, ops);
+  GroupRemove(Scope::kTypeGroups, copy.type, key, ops);
+  items_.erase(copy.id);
+}
+
+void FeedMerger::Upsert(const Item& item,
+                        std::vector<Item>* fresh,
+                        std::vector<Op>* ops) {
+  auto it = items_.find(item.id);
+  if (it == items_.end()) {
+    fresh->push_back(item);
+    return;
+  }
+  Item& existing = it->second;
+  if (existing.timestamp != item.timestamp || existing.user != item.user ||
+      existing.type != item.type) {
+    Erase(existing, ops);
+    fresh->push_back(item);
+    return;
+  }
+  if (existing.version == item.version) {
+    return;
+  }
+  existing.version = item.version;
+  Emit(ops, OpKind::kUpdate, Scope::kList, TimelineIndex(KeyOf(item)),
+       item.id);
+  GroupUpdate(Scope::kUserGroups, item.user, ops);
+  GroupUpdate(Scope::kTypeGroups, item.type, ops);
+}
+
+void FeedMerger::InsertFresh(std::vector<Item>* fresh, std::vector<Op>* ops) {
+  if (fresh->empty()) {
+    return;
+  }
+  auto newer = [](const Item& a, const Item& b) { return KeyOf(a) > KeyOf(b); };
+  if (!std::is_sorted(fresh->begin(), fresh->end(), newer)) {
+    std::sort(fresh->begin(), fresh->end(), newer);
+  }
+  // 从末尾原地归并，只移动第一个插入位置之后的部分
+  const size_t old_size = timeline_.size();
+  const size_t count = fresh->size();
+  timeline_.resize(old_size + count);
+  std::vector<size_t> positions(count);
+  size_t read = old_size;
+  size_t write = old_size + count;
+  for (size_t i = count; i-- > 0;) {
+    const SortKey key = KeyOf((*fresh)[i]);
+    while (read > 0 && timeline_[read - 1] < key) {
+      timeline_[--write] = timeline_[--read];
+    }
+    timeline_[--write] = key;
+    positions[i] = write;
+  }
+  // 按最终位置递增输出，依次插入即得到最终列表
+  for (size_t i = 0; i < count; ++i) {
+    const Item& item = (*fresh)[i];
+    Emit(ops, OpKind::kInsert, Scope::kList, positions[i], item.id);
+    items_[item.id] = item;
+    GroupAdd(Scope::kUserGroups, item.user, KeyOf(item), ops);
+    GroupAdd(Scope::kTypeGroups, item.type, KeyOf(item), ops);
+  }
+  fresh->clear();
+}
+
+void FeedMerger::GroupAdd(Scope scope,
+                          uint32_t key,
+                          const SortKey& item,
+                          std::vector<Op>* ops) {
+  GroupIndex& index = Groups(scope);
+  Group& group = index.groups[key];
+  auto position = [&index](const SortKey& latest) {
+    return static_cast<size_t>(
+        std::lower_bound(index.order.begin(), index.order.end(), latest,
+                         std::greater<SortKey>()) -
+        index.order.begin());
+  };
+  if (group.members.empty()) {
+    group.members.insert(item);
+    const size_t at = position(item);
+    index.order.insert(index.order.begin() + static_cast<ptrdiff_t>(at), item);
+    index.keys.insert(index.keys.begin() + static_cast<ptrdiff_t>(at), key);
+    Emit(ops, OpKind::kInsert, scope, at, key);
+    return;
+  }
+  const SortKey old_latest = *group.members.rbegin();
+  group.members.insert(item);
+  const size_t old_at = position(old_latest);
+  if (item < old_latest) {
+    // 最新一条不变，只有条数变化
+    Emit(ops, OpKind::kUpdate, scope, old_at, key);
+    return;
+  }
+  index.order.erase(index.order.begin() + static_cast<ptrdiff_t>(old_at));
+  index.keys.erase(index.keys.begin() + static_cast<ptrdiff_t>(old_at));
+  const size_t new_at = position(item);
+  index.order.insert(index.order.begin() + static_cast<ptrdiff_t>(new_at),
+                     item);
+  index.keys.insert(index.keys.begin() + static_cast<ptrdiff_t>(new_at), key);
+  if (new_at == old_at) {
+    Emit(ops, OpKind::kUpdate, scope, new_at, key);
+  } else {
+    Emit(ops, OpKind::kRemove, scope, old_at, key);
+    Emit(ops, OpKind::kInsert, scope, new_at, key);
+  }
+}
+
+void FeedMerger::GroupRemove(Scope scope,
+                             uint32_t key,
+                             const SortKey& item,
+                             std::vector<Op>* ops) {
+  GroupIndex& index = Groups(scope);
+  auto it = index.groups.find(key);
+  if (it == index.groups.end()) {
+    return;
+  }
+  Group& group = it->second;
+  auto position = [&index](const SortKey& latest) {
+    return static_cast<size_t>(
+        std::lower_bound(index.order.begin(), index.order.end(), latest,
+                         std::greater<SortKey>()) -
+        index.order.begin());
+  };
+  const SortKey old_latest = *group.members.rbegin();
+  group.members.erase(item);
+  const size_t old_at = position(old_latest);
+  if (group.members.empty()) {
+    index.order.erase(index.order.begin() + static_cast<ptrdiff_t>(old_at));
+    index.keys.erase(index.keys.begin() + static_cast<ptrdiff_t>(old_at));
+    index.groups.erase(it);
+    Emit(ops, OpKind::kRemove, scope, old_at, key);
+    return;
+  }
+  const SortKey new_latest = *group.members.rbegin();
+  if (new_latest == old_latest) {
+    Emit(ops, OpKind::kUpdate, scope, old_at, key);
+    return;
+  }
+  index.order.erase(index.order.begin() + static_cast<ptrdiff_t>(old_at));
+  index.keys.erase(index.keys.begin() + static_cast<ptrdiff_t>(old_at));
+  const size_t new_at = position(new_latest);
+  index.order.insert(index.order.begin() + static_cast<ptrdiff_t>(new_at),
+                     new_latest);
+  index.keys.insert(index.keys.begin() + static_cast<ptrdiff_t>(new_at), key);
+  if (new_at == old_at) {
+    Emit(ops, OpKind::kUpdate, scope, new_at, key);
+  } else {
+    Emit(ops, OpKind::kRemove, scope, old_at, key);
+    Emit(ops, OpKind::kInsert, scope, new_at, key);
+  }
+}
+
+void FeedMerger::GroupUpdate(Scope scope, uint32_t key, std::vector<Op>* ops) {
+  GroupIndex& index = Groups(scope);
+  auto it = index.groups.find(key);
+  if (it == index.groups.end() || it->second.members.empty()) {
+    return;
+  }
+  const SortKey latest = *it->second.members.rbegin();
+  const size_t at = static_cast<size_t>(
+      std::lower_bound(index.order.begin(), index.order.end(), latest,
+                       std::greater<SortKey>()) -
+      index.order.begin());
+  Emit(ops, OpKind::kUpdate, scope, at, key);
+}
+
+FeedMerger::GroupIndex& FeedMerger::Groups(Scope scope) {
+  return scope == Scope::kUserGroups ? user_groups_ : type_groups_;
+}
+
+const FeedMerger::GroupIndex& FeedMerger::Groups(Scope scope) const {
+  return scope == Scope::kUserGroups ? user_groups_ : type_groups_;
+}
@@ -0,0 +1,117 @@
+#ifndef RUNNER_FEED_MERGER_H_
+#define RUNNER_FEED_MERGER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 动态时间线的合并、去重和折叠分组（与平台无关）。
+//
+// 时间线按 (时间, ID) 倒序排列，ID 不重复。分页到达的数据先按时间
+// 多路归并成一段，再线性归并进时间线；同一 ID 再次出现时按版本号
+// 判断是否变化。同时维护按用户和按类型折叠的两组分组，分组按其中
+// 最新一条的位置排列，切换折叠模式不需要重新分组。
+//
+// 每次修改输出一串按顺序应用的操作（插入、删除、更新），下标都是
+// 应用到该操作时的位置，列表视图据此只改动变化的行。不是线程安全的。
+class FeedMerger {
+ public:
+  struct Item {
+    uint32_t id = 0;        // 条目编号，由调用方分配
+    uint32_t user = 0;      // 用户编号
+    uint32_t type = 0;      // 类型编号
+    int64_t timestamp = 0;  // 毫秒
+    uint64_t version = 0;   // 内容变化时改变
+  };
+
+  enum class Scope : uint8_t {
+    kList = 0,        // 完整的时间线，key 为条目 ID
+    kUserGroups = 1,  // 按用户折叠的分组，key 为用户
+    kTypeGroups = 2,  // 按类型折叠的分组，key 为类型
+  };
+
+  enum class OpKind : uint8_t {
+    kInsert = 0,
+    kRemove = 1,
+    kUpdate = 2,  // 条目内容变化，或分组的条数、最新一条变化
+  };
+
+  struct Op {
+    OpKind kind;
+    Scope scope;
+    uint16_t reserved;
+    uint32_t index;
+    uint32_t key;
+  };
+  static_assert(sizeof(Op) == 12, "Op must be 12 bytes");
+
+  FeedMerger() = default;
+
+  FeedMerger(const FeedMerger&) = delete;
+  FeedMerger& operator=(const FeedMerger&) = delete;
+
+  // 合并若干页，每页按时间倒序排列。|page_sizes| 为每页的条数。
+  void Merge(const Item* items,
+             const size_t* page_sizes,
+             size_t page_count,
+             std::vector<Op>* ops);
+
+  // 让时间线恰好包含 |items|（顺序不限），只输出差异。
+  void Replace(const Item* items, size_t count, std::vector<Op>* ops);
+
+  void Remove(uint32_t id, std::vector<Op>* ops);
+
+  // 清空时间线和分组，不输出操作，调用方同时清空自己的列表。
+  void Clear();
+
+  // 分组中的条目 ID，按时间倒序。
+  void Members(Scope scope, uint32_t key, std::vector<uint32_t>* ids) const;
+
+  size_t size() const { return timeline_.size(); }
+
+ private:
+  // 倒序比较用的排序键
+  using SortKey = std::pair<int64_t, uint32_t>;
+
+  struct Group {
+    std::set<SortKey> members;  // 升序，最新的在末尾
+  };
+
+  struct GroupIndex {
+    std::unordered_map<uint32_t, Group> groups;
+    std::vector<SortKey> order;  // 每个分组最新一条的排序键，倒序
+    std::vector<uint32_t> keys;  // 与 order 对应的分组 key
+  };
+
+  static SortKey KeyOf(const Item& item) { return {item.timestamp, item.id}; }
+
+  size_t TimelineIndex(const SortKey& key) const;
+  // 删除已有的条目。
+  void Erase(const Item& item, std::vector<Op>* ops);
+  // 已有的条目原地更新，排序位置或分组变化的先删除再放进 |fresh|，
+  // 新条目直接放进 |fresh|。
+  void Upsert(const Item& item, std::vector<Item>* fresh, std::vector<Op>* ops);
+  // 把 |fresh| 中的新条目归并进时间线。
+  void InsertFresh(std::vector<Item>* fresh, std::vector<Op>* ops);
+  void GroupAdd(Scope scope,
+                uint32_t key,
+                const SortKey& item,
+                std::vector<Op>* ops);
+  void GroupRemove(Scope scope,
+                   uint32_t key,
+                   const SortKey& item,
+                   std::vector<Op>* ops);
+  void GroupUpdate(Scope scope, uint32_t key, std::vector<Op>* ops);
+  GroupIndex& Groups(Scope scope);
+  const GroupIndex& Groups(Scope scope) const;
+
+  std::vector<SortKey> timeline_;  // 倒序
+  std::unordered_map<uint32_t, Item> items_;
+  GroupIndex user_groups_;
+  GroupIndex type_groups_;
+};
+
+#endif  // RUNNER_FEED_MERGER_H_
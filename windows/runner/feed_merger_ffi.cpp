@@ -0,0 +1,136 @@
+#include "feed_merger_ffi.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "feed_merger.h"
+
+static_assert(sizeof(RunnerFeedOp) == sizeof(FeedMerger::Op),
+              "RunnerFeedOp must match FeedMerger::Op");
+static_assert(offsetof(RunnerFeedOp, index) ==
+                  offsetof(FeedMerger::Op, index) &&
+              offsetof(RunnerFeedOp, key) == offsetof(FeedMerger::Op, key),
+              "RunnerFeedOp must match FeedMerger::Op");
+
+namespace {
+
+struct Feed {
+  FeedMerger merger;
+  std::vector<FeedMerger::Op> ops;  // 最近一次修改输出的操作
+  std::vector<FeedMerger::Item> items;
+  std::vector<uint32_t> members;
+};
+
+Feed* AsFeed(void* feed) {
+  return static_cast<Feed*>(feed);
+}
+
+void Convert(const RunnerFeedItem* items, size_t count, Feed* feed) {
+  feed->items.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    FeedMerger::Item& item = feed->items[i];
+    item.id = items[i].id;
+    item.user = items[i].user;
+    item.type = items[i].type;
+    item.timestamp = items[i].timestamp;
+    item.version = items[i].version;
+  }
+}
+
+int32_t Publish(Feed* feed, const RunnerFeedOp** ops) {
+  if (ops) {
+    *ops = reinterpret_cast<const RunnerFeedOp*>(feed->ops.data());
+  }
+  return static_cast<int32_t>(feed->ops.size());
+}
+
+}  // namespace
+
+void* runner_feed_create() {
+  return new Feed();
+}
+
+void runner_feed_destroy(void* feed) {
+  delete AsFeed(feed);
+}
+
+int32_t runner_feed_merge(void* feed,
+                          const RunnerFeedItem* items,
+                          const int32_t* page_sizes,
+                          int32_t page_count,
+                          const RunnerFeedOp** ops) {
+  Feed* self = AsFeed(feed);
+  if (!self) {
+    return 0;
+  }
+  self->ops.clear();
+  std::vector<size_t> sizes;
+  size_t total = 0;
+  if (items && page_sizes && page_count > 0) {
+    sizes.resize(static_cast<size_t>(page_count));
+    for (size_t i = 0; i < sizes.size(); ++i) {
+      sizes[i] = page_sizes[i] > 0 ? static_cast<size_t>(page_sizes[i]) : 0;
+      total += sizes[i];
+    }
+  }
+  Convert(items, total, self);
+  self->merger.Merge(self->items.data(), sizes.data(), sizes.size(),
+                     &self->ops);
+  return Publish(self, ops);
+}
+
+int32_t runner_feed_replace(void* feed,
+                            const RunnerFeedItem* items,
+                            int32_t count,
+                            const RunnerFeedOp** ops) {
+  Feed* self = AsFeed(feed);
+  if (!self) {
+    return 0;
+  }
+  self->ops.clear();
+  Convert(items, items && count > 0 ? static_cast<size_t>(count) : 0, self);
+  self->merger.Replace(self->items.data(), self->items.size(), &self->ops);
+  return Publish(self, ops);
+}
+
+int32_t runner_feed_remove(void* feed,
+                           uint32_t id,
+                           const RunnerFeedOp** ops) {
+  Feed* self = AsFeed(feed);
+  if (!self) {
+    return 0;
+  }
+  self->ops.clear();
+  self->merger.Remove(id, &self->ops);
+  return Publish(self, ops);
+}
+
+void runner_feed_clear(void* feed) {
+  Feed* self = AsFeed(feed);
+  if (!self) {
+    return;
+  }
+  self->ops.clear();
+  self->merger.Clear();
+}
+
+int32_t runner_feed_members(void* feed,
+                            int32_t scope,
+                            uint32_t key,
+                            uint32_t* ids,
+                            int32_t capacity) {
+  Feed* self = AsFeed(feed);
+  if (!self || scope <= 0 || scope > 2) {
+    return 0;
+  }
+  self->merger.Members(static_cast<FeedMerger::Scope>(scope), key,
+                       &self->members);
+  const size_t count = std::min(
+      self->members.size(),
+      ids && capacity > 0 ? static_cast<size_t>(capacity) : size_t{0});
+  for (size_t i = 0; i < count; ++i) {
+    ids[i] = self->members[i];
+  }
+  return static_cast<int32_t>(self->members.size());
+}
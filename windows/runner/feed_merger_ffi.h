@@ -0,0 +1,60 @@
+#ifndef RUNNER_FEED_MERGER_FFI_H_
+#define RUNNER_FEED_MERGER_FFI_H_
+
+#include <cstdint>
+
+#include "ffi_export.h"
+
+// FeedMerger 的 C 接口，供 lib/windows/native/native_feed_merger.dart
+// 使用。结构体布局必须和 Dart 侧的 Struct 定义一致。
+//
+// 句柄只能在创建它的线程（UI 线程）上使用。修改函数返回操作的个数，
+// 并把操作数组的地址写入 |ops|，数组在下一次修改或销毁前有效。
+
+struct RunnerFeedItem {
+  uint32_t id;
+  uint32_t user;
+  uint32_t type;
+  int32_t reserved;
+  int64_t timestamp;  // 毫秒
+  uint64_t version;
+};
+
+struct RunnerFeedOp {
+  uint8_t kind;   // 0 插入，1 删除，2 更新
+  uint8_t scope;  // 0 时间线，1 按用户分组，2 按类型分组
+  uint16_t reserved;
+  uint32_t index;
+  uint32_t key;  // 时间线中为条目编号，分组中为用户或类型编号
+};
+
+RUNNER_FFI_EXPORT void* runner_feed_create();
+
+RUNNER_FFI_EXPORT void runner_feed_destroy(void* feed);
+
+// |items| 依次为 |page_count| 页，每页的条数在 |page_sizes| 中。
+RUNNER_FFI_EXPORT int32_t runner_feed_merge(void* feed,
+                                            const RunnerFeedItem* items,
+                                            const int32_t* page_sizes,
+                                            int32_t page_count,
+                                            const RunnerFeedOp** ops);
+
+RUNNER_FFI_EXPORT int32_t runner_feed_replace(void* feed,
+                                              const RunnerFeedItem* items,
+                                              int32_t count,
+                                              const RunnerFeedOp** ops);
+
+RUNNER_FFI_EXPORT int32_t runner_feed_remove(void* feed,
+                                             uint32_t id,
+                                             const RunnerFeedOp** ops);
+
+RUNNER_FFI_EXPORT void runner_feed_clear(void* feed);
+
+// 向 |ids| 写入分组中最多 |capacity| 个条目编号，返回分组的总条数。
+RUNNER_FFI_EXPORT int32_t runner_feed_members(void* feed,
+                                              int32_t scope,
+                                              uint32_t key,
+                                              uint32_t* ids,
+                                              int32_t capacity);
+
+#endif  // RUNNER_FEED_MERGER_FFI_H_
@@ -0,0 +1,12 @@
+#ifndef RUNNER_FFI_EXPORT_H_
+#define RUNNER_FFI_EXPORT_H_
+
+// 从 runner.exe 导出给 Dart FFI 的函数。Dart 侧通过
+// DynamicLibrary.executable() 查找这些符号，函数名以 runner_ 开头。
+#ifdef _WIN32
+#define RUNNER_FFI_EXPORT extern "C" __declspec(dllexport)
+#else
+#define RUNNER_FFI_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+#endif  // RUNNER_FFI_EXPORT_H_
@@ -0,0 +1,220 @@
+#include "file_prefetcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <set>
+#include <system_error>
+#include <utility>
+
+#include "startup_trace.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr size_t kChunkSize = 1u << 20;
+
+int64_t NowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+bool Cancelled(const std::atomic<bool>* cancel) {
+  return cancel && cancel->load(std::memory_order_relaxed);
+}
+
+#ifdef _WIN32
+
+void LowerCurrentThreadIoPriority() {
+  // 后台模式同时降低 CPU、I/O 和内存优先级
+  SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+}
+
+// 顺序读完 |path|，数据留在系统文件缓存里。返回读取的字节数，打不开时
+// 返回 -1。
+int64_t ReadThrough(const std::filesystem::path& path,
+                    std::vector<char>* buffer,
+                    const std::atomic<bool>* cancel) {
+  HANDLE file = CreateFileW(path.c_str(), GENERIC_READ,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE |
+                                FILE_SHARE_DELETE,
+                            nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return -1;
+  }
+  int64_t total = 0;
+  DWORD read = 0;
+  while (!Cancelled(cancel) &&
+         ReadFile(file, buffer->data(), static_cast<DWORD>(buffer->size()),
+                  &read, nullptr) &&
+         read > 0) {
+    total += read;
+  }
+  CloseHandle(file);
+  return total;
+}
+
+#else
+
+void LowerCurrentThreadIoPriority() {
+#ifdef SYS_ioprio_set
+  // IOPRIO_WHO_PROCESS 对线程 ID 生效；IOPRIO_CLASS_IDLE
+  constexpr int kIoprioWhoProcess = 1;
+  constexpr int kIoprioClassIdle = 3;
+  constexpr int kIoprioClassShift = 13;
+  syscall(SYS_ioprio_set, kIoprioWhoProcess, 0,
+          kIoprioClassIdle << kIoprioClassShift);
+#endif
+}
+
+int64_t ReadThrough(const std::filesystem::path& path,
+                    std::vector<char>* buffer,
+                    const std::atomic<bool>* cancel) {
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return -1;
+  }
+  posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  int64_t total = 0;
+  while (!Cancelled(cancel)) {
+    const ssize_t read_size = read(fd, buffer->data(), buffer->size());
+    if (read_size <= 0) {
+      break;
+    }
+    total += read_size;
+  }
+  close(fd);
+  return total;
+}
+
+#endif
+
+}  // namespace
+
+FilePrefetcher::~FilePrefetcher() {
+  Stop();
+}
+
+bool FilePrefetcher::Start(std::filesystem::path root,
+                           std::vector<std::filesystem::path> entries,
+                           uint64_t max_bytes) {
+  if (thread_.joinable() || done()) {
+    return false;
+  }
+  thread_ = std::thread([this, root = std::move(root),
+                         entries = std::move(entries), max_bytes]() {
+    StartupTrace::GetInstance().SetCurrentThreadName("prefetch");
+    LowerCurrentThreadIoPriority();
+    stats_ = Run(root, entries, max_bytes, &cancel_);
+    done_.store(true, std::memory_order_release);
+  });
+  return true;
+}
+
+void FilePrefetcher::Stop() {
+  cancel_.store(true, std::memory_order_relaxed);
+  Wait();
+}
+
+void FilePrefetcher::Wait() {
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+std::vector<FilePrefetcher::Item> FilePrefetcher::Expand(
+    const std::filesystem::path& root,
+    const std::vector<std::filesystem::path>& entries) {
+  std::vector<Item> items;
+  std::set<std::filesystem::path> seen;
+  auto add = [&](const std::filesystem::path& path, uint64_t size) {
+    if (seen.insert(path.lexically_normal()).second) {
+      items.push_back({path, size});
+    }
+  };
+  for (const auto& entry : entries) {
+    const std::filesystem::path path = root / entry;
+    std::error_code error;
+    const auto status = std::filesystem::status(path, error);
+    if (error) {
+      continue;
+    }
+    if (std::filesystem::is_regular_file(status)) {
+      add(path, std::filesystem::file_size(path, error));
+      continue;
+    }
+    if (!std::filesystem::is_directory(status)) {
+      continue;
+    }
+    std::vector<Item> files;
+    for (std::filesystem::recursive_directory_iterator it(path, error), end;
+         !error && it != end; it.increment(error)) {
+      std::error_code entry_error;
+      if (it->is_regular_file(entry_error)) {
+        const uint64_t size = it->file_size(entry_error);
+        files.push_back({it->path(), entry_error ? 0 : size});
+      }
+    }
+    std::stable_sort(files.begin(), files.end(),
+                     [](const Item& a, const Item& b) { return a.size < b.size; });
+    for (const auto& file : files) {
+      add(file.path, file.size);
+    }
+  }
+  return items;
+}
+
+FilePrefetcher::Stats FilePrefetcher::Run(
+    const std::filesystem::path& root,
+    const std::vector<std::filesystem::path>& entries,
+    uint64_t max_bytes,
+    const std::atomic<bool>* cancel) {
+  ScopedTraceSpan span("FilePrefetcher::Run", "startup");
+  const int64_t begin_us = NowMicros();
+  Stats stats;
+  std::vector<char> buffer(kChunkSize);
+  for (const Item& item : Expand(root, entries)) {
+    if (Cancelled(cancel)) {
+      break;
+    }
+    if (stats.bytes + item.size > max_bytes) {
+      ++stats.skipped;
+      continue;
+    }
+    const int64_t read = ReadThrough(item.path, &buffer, cancel);
+    if (read < 0) {
+      ++stats.skipped;
+      continue;
+    }
+    ++stats.files;
+    stats.bytes += static_cast<uint64_t>(read);
+  }
+  stats.elapsed_us = NowMicros() - begin_us;
+  return stats;
+}
+
+std::vector<std::filesystem::path> FilePrefetcher::ReadList(
+    const std::filesystem::path& file) {
+  std::vector<std::filesystem::path> entries;
+  std::ifstream in(file);
+  std::string line;
+  while (std::getline(in, line)) {
+    const size_t begin = line.find_first_not_of(" \t\r");
+    if (begin == std::string::npos || line[begin] == '#') {
+      continue;
+    }
+    const size_t end = line.find_last_not_of(" \t\r");
+    entries.push_back(
+        std::filesystem::u8path(line.substr(begin, end - begin + 1)));
+  }
+  return entries;
+}
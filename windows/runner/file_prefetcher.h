@@ -0,0 +1,76 @@
+#ifndef RUNNER_FILE_PREFETCHER_H_
+#define RUNNER_FILE_PREFETCHER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 在后台线程把引擎启动时要读的文件预读进系统文件缓存。
+//
+// 引擎第一次访问 app.so、icudtl.dat、flutter_assets 和 CJK 字体时才从
+// 磁盘读取，冷启动时这部分 I/O 排在预检查之后串行进行。预读在 wWinMain
+// 开头启动，与预检查窗口并行；线程使用最低的 I/O 优先级（Windows 的后台
+// 模式，Linux 的 idle 类），不和前台读取抢磁盘。
+//
+// 条目是相对 |root| 的路径，目录会递归展开。按给出的顺序处理，目录内
+// 小文件优先（清单文件先到），重复的文件只读一次。累计超过 |max_bytes|
+// 后不再读取新文件。
+class FilePrefetcher {
+ public:
+  struct Item {
+    std::filesystem::path path;
+    uint64_t size = 0;
+  };
+
+  struct Stats {
+    uint64_t files = 0;    // 读完的文件数
+    uint64_t bytes = 0;    // 读取的字节数
+    uint64_t skipped = 0;  // 不存在、打不开或超出预算的文件数
+    int64_t elapsed_us = 0;
+  };
+
+  FilePrefetcher() = default;
+  // 取消尚未完成的预读并等待线程退出。
+  ~FilePrefetcher();
+
+  FilePrefetcher(const FilePrefetcher&) = delete;
+  FilePrefetcher& operator=(const FilePrefetcher&) = delete;
+
+  // 启动后台线程。已经启动过时返回 false。
+  bool Start(std::filesystem::path root,
+             std::vector<std::filesystem::path> entries,
+             uint64_t max_bytes);
+  // 尽快结束并等待线程退出。
+  void Stop();
+  // 等待预读完成。
+  void Wait();
+
+  bool done() const { return done_.load(std::memory_order_acquire); }
+  // done() 为 true 之后才有意义。
+  const Stats& stats() const { return stats_; }
+
+  // 展开条目，得到按预读顺序排列的文件。
+  static std::vector<Item> Expand(const std::filesystem::path& root,
+                                  const std::vector<std::filesystem::path>& entries);
+
+  // 在调用线程上同步执行预读。|cancel| 可以为 nullptr。
+  static Stats Run(const std::filesystem::path& root,
+                   const std::vector<std::filesystem::path>& entries,
+                   uint64_t max_bytes,
+                   const std::atomic<bool>* cancel);
+
+  // 读取预读清单：每行一个相对路径，忽略空行和以 '#' 开头的行。
+  static std::vector<std::filesystem::path> ReadList(
+      const std::filesystem::path& file);
+
+ private:
+  std::thread thread_;
+  std::atomic<bool> cancel_{false};
+  std::atomic<bool> done_{false};
+  Stats stats_;
+};
+
+#endif  // RUNNER_FILE_PREFETCHER_H_
@@ -0,0 +1,739 @@
+#include "flat_json.h"
+
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <system_error>
+
+#include "cpu_features.h"
+#include "xxhash64.h"
+
+#if RUNNER_ARCH_X86
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+constexpr size_t kBlockSize = 64;
+
+int CountTrailingZeros(uint64_t value) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+  unsigned long index;
+  _BitScanForward64(&index, value);
+  return static_cast<int>(index);
+#elif defined(_MSC_VER)
+  unsigned long index;
+  if (_BitScanForward(&index, static_cast<uint32_t>(value))) {
+    return static_cast<int>(index);
+  }
+  _BitScanForward(&index, static_cast<uint32_t>(value >> 32));
+  return static_cast<int>(index) + 32;
+#else
+  return __builtin_ctzll(value);
+#endif
+}
+
+// 第 i 位为第 0 到 i 位的异或，即该位置是否位于一对引号之间。
+uint64_t PrefixXor(uint64_t bits) {
+  bits ^= bits << 1;
+  bits ^= bits << 2;
+  bits ^= bits << 4;
+  bits ^= bits << 8;
+  bits ^= bits << 16;
+  bits ^= bits << 32;
+  return bits;
+}
+
+// 一个 64 字节块中各类字符的位图，第 i 位对应第 i 个字节。
+struct BlockMasks {
+  uint64_t quote = 0;
+  uint64_t backslash = 0;
+  uint64_t control = 0;  // 小于 0x20 的字节，不能出现在字符串中
+};
+
+void ClassifyScalar(const uint8_t* block, BlockMasks* masks) {
+  uint64_t quote = 0;
+  uint64_t backslash = 0;
+  uint64_t control = 0;
+  for (size_t i = 0; i < kBlockSize; ++i) {
+    const uint64_t bit = 1ull << i;
+    quote |= block[i] == '"' ? bit : 0;
+    backslash |= block[i] == '\\' ? bit : 0;
+    control |= block[i] < 0x20 ? bit : 0;
+  }
+  masks->quote = quote;
+  masks->backslash = backslash;
+  masks->control = control;
+}
+
+// 逐块收集不在转义中的引号位置，同时检查字符串中的控制字符。
+class QuoteIndexer {
+ public:
+  explicit QuoteIndexer(std::vector<uint32_t>* quotes) : quotes_(quotes) {}
+
+  bool Process(const BlockMasks& masks, size_t base) {
+    const uint64_t quote = masks.quote & ~FindEscaped(masks.backslash);
+    const uint64_t in_string = PrefixXor(quote) ^ in_string_;
+    in_string_ = 0ull - (in_string >> 63);
+    const uint64_t invalid = masks.control & in_string;
+    if (invalid) {
+      error_offset_ = base + static_cast<size_t>(CountTrailingZeros(invalid));
+      return false;
+    }
+    for (uint64_t bits = quote; bits; bits &= bits - 1) {
+      quotes_->push_back(
+          static_cast<uint32_t>(base + static_cast<size_t>(
+                                           CountTrailingZeros(bits))));
+    }
+    return true;
+  }
+
+  // 全部块处理完后调用，最后一个字符串没有结束时返回 false。
+  bool Finish(size_t size) {
+    if (in_string_) {
+      error_offset_ = size;
+      return false;
+    }
+    return true;
+  }
+
+  size_t error_offset() const { return error_offset_; }
+
+ private:
+  // 返回被反斜杠转义的字节的位图。连续的反斜杠两两成对，块末尾的
+  // 反斜杠转义下一块的第一个字节。
+  uint64_t FindEscaped(uint64_t backslash) {
+    uint64_t escaped = 0;
+    if (escape_carry_) {
+      escaped = 1;
+      backslash &= ~1ull;
+      escape_carry_ = false;
+    }
+    while (backslash) {
+      const int bit = CountTrailingZeros(backslash);
+      if (bit == 63) {
+        escape_carry_ = true;
+        break;
+      }
+      escaped |= 1ull << (bit + 1);
+      backslash &= ~(3ull << bit);
+    }
+    return escaped;
+  }
+
+  std::vector<uint32_t>* quotes_;
+  uint64_t in_string_ = 0;
+  bool escape_carry_ = false;
+  size_t error_offset_ = 0;
+};
+
+// |size| 为 kBlockSize 的整数倍，记录的位置加上 |offset|。
+bool IndexBlocksScalar(const uint8_t* data,
+                       size_t size,
+                       size_t offset,
+                       QuoteIndexer* indexer) {
+  BlockMasks masks;
+  for (size_t base = 0; base < size; base += kBlockSize) {
+    ClassifyScalar(data + base, &masks);
+    if (!indexer->Process(masks, offset + base)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+#if RUNNER_ARCH_X86
+
+uint64_t MoveMask16x4(__m128i a, __m128i b, __m128i c, __m128i d) {
+  return static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(a))) |
+         static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(b)))
+             << 16 |
+         static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(c)))
+             << 32 |
+         static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(d)))
+             << 48;
+}
+
+bool IndexBlocksSse2(const uint8_t* data,
+                     size_t size,
+                     size_t offset,
+                     QuoteIndexer* indexer) {
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i control_max = _mm_set1_epi8(0x1F);
+  BlockMasks masks;
+  for (size_t base = 0; base < size; base += kBlockSize) {
+    __m128i chunk[4];
+    for (int i = 0; i < 4; ++i) {
+      chunk[i] = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(data + base + i * 16));
+    }
+    masks.quote = MoveMask16x4(
+        _mm_cmpeq_epi8(chunk[0], quote), _mm_cmpeq_epi8(chunk[1], quote),
+        _mm_cmpeq_epi8(chunk[2], quote), _mm_cmpeq_epi8(chunk[3], quote));
+    masks.backslash = MoveMask16x4(_mm_cmpeq_epi8(chunk[0], backslash),
+                                   _mm_cmpeq_epi8(chunk[1], backslash),
+                                   _mm_cmpeq_epi8(chunk[2], backslash),
+                                   _mm_cmpeq_epi8(chunk[3], backslash));
+    // 无符号比较：min(x, 0x1F) == x 即 x <= 0x1F
+    masks.control = MoveMask16x4(
+        _mm_cmpeq_epi8(_mm_min_epu8(chunk[0], control_max), chunk[0]),
+        _mm_cmpeq_epi8(_mm_min_epu8(chunk[1], control_max), chunk[1]),
+        _mm_cmpeq_epi8(_mm_min_epu8(chunk[2], control_max), chunk[2]),
+        _mm_cmpeq_epi8(_mm_min_epu8(chunk[3], control_max), chunk[3]));
+    if (!indexer->Process(masks, offset + base)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RUNNER_TARGET_ATTRIBUTE("avx2")
+uint64_t MoveMask32x2(__m256i low, __m256i high) {
+  return static_cast<uint64_t>(
+             static_cast<uint32_t>(_mm256_movemask_epi8(low))) |
+         static_cast<uint64_t>(
+             static_cast<uint32_t>(_mm256_movemask_epi8(high)))
+             << 32;
+}
+
+RUNNER_TARGET_ATTRIBUTE("avx2")
+bool IndexBlocksAvx2(const uint8_t* data,
+                     size_t size,
+                     size_t offset,
+                     QuoteIndexer* indexer) {
+  const __m256i quote = _mm256_set1_epi8('"');
+  const __m256i backslash = _mm256_set1_epi8('\\');
+  const __m256i control_max = _mm256_set1_epi8(0x1F);
+  BlockMasks masks;
+  for (size_t base = 0; base < size; base += kBlockSize) {
+    const __m256i low =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + base));
+    const __m256i high =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + base + 32));
+    masks.quote = MoveMask32x2(_mm256_cmpeq_epi8(low, quote),
+                               _mm256_cmpeq_epi8(high, quote));
+    masks.backslash = MoveMask32x2(_mm256_cmpeq_epi8(low, backslash),
+                                   _mm256_cmpeq_epi8(high, backslash));
+    masks.control = MoveMask32x2(
+        _mm256_cmpeq_epi8(_mm256_min_epu8(low, control_max), low),
+        _mm256_cmpeq_epi8(_mm256_min_epu8(high, control_max), high));
+    if (!indexer->Process(masks, offset + base)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+#endif  // RUNNER_ARCH_X86
+
+using IndexBlocksFunction = bool (*)(const uint8_t*,
+                                     size_t,
+                                     size_t,
+                                     QuoteIndexer*);
+
+IndexBlocksFunction SelectIndexBlocks() {
+#if RUNNER_ARCH_X86
+  if (GetCpuFeatures().avx2) {
+    return IndexBlocksAvx2;
+  }
+  return IndexBlocksSse2;
+#else
+  return IndexBlocksScalar;
+#endif
+}
+
+// 第一遍：收集 |data| 中所有作为字符串边界的引号位置。
+bool IndexQuotes(const uint8_t* data,
+                 size_t size,
+                 std::vector<uint32_t>* quotes,
+                 size_t* error_offset) {
+  static const IndexBlocksFunction index_blocks = SelectIndexBlocks();
+  QuoteIndexer indexer(quotes);
+  const size_t full_size = size / kBlockSize * kBlockSize;
+  bool ok = index_blocks(data, full_size, 0, &indexer);
+  if (ok && full_size < size) {
+    // 尾部不足一块，补空格后按标量处理
+    uint8_t tail[kBlockSize];
+    std::memset(tail, ' ', sizeof(tail));
+    std::memcpy(tail, data + full_size, size - full_size);
+    ok = IndexBlocksScalar(tail, kBlockSize, full_size, &indexer);
+  }
+  ok = ok && indexer.Finish(size);
+  if (!ok) {
+    *error_offset = indexer.error_offset();
+  }
+  return ok;
+}
+
+bool IsDigit(uint8_t c) {
+  return c >= '0' && c <= '9';
+}
+
+int HexValue(uint8_t c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+// 解析 |p| 开始的 4 位十六进制数，无效时返回 -1。
+int32_t ParseHex4(const uint8_t* p) {
+  int32_t value = 0;
+  for (int i = 0; i < 4; ++i) {
+    const int digit = HexValue(p[i]);
+    if (digit < 0) {
+      return -1;
+    }
+    value = value << 4 | digit;
+  }
+  return value;
+}
+
+void AppendUtf8(uint32_t code_point, std::vector<uint8_t>* output) {
+  if (code_point < 0x80) {
+    output->push_back(static_cast<uint8_t>(code_point));
+  } else if (code_point < 0x800) {
+    output->push_back(static_cast<uint8_t>(0xC0 | code_point >> 6));
+    output->push_back(static_cast<uint8_t>(0x80 | (code_point & 0x3F)));
+  } else if (code_point < 0x10000) {
+    output->push_back(static_cast<uint8_t>(0xE0 | code_point >> 12));
+    output->push_back(static_cast<uint8_t>(0x80 | (code_point >> 6 & 0x3F)));
+    output->push_back(static_cast<uint8_t>(0x80 | (code_point & 0x3F)));
+  } else {
+    output->push_back(static_cast<uint8_t>(0xF0 | code_point >> 18));
+    output->push_back(static_cast<uint8_t>(0x80 | (code_point >> 12 & 0x3F)));
+    output->push_back(static_cast<uint8_t>(0x80 | (code_point >> 6 & 0x3F)));
+    output->push_back(static_cast<uint8_t>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+// 第二遍：按引号索引解析，生成节点和字符串区。
+class Parser {
+ public:
+  Parser(const uint8_t* data, size_t size, const std::vector<uint32_t>& quotes)
+      : data_(data), size_(size), quotes_(quotes) {
+    // 典型的接口数据大约每 8 字节一个节点
+    nodes_.reserve(size / 8 + 1);
+    strings_.reserve(size / 2);
+  }
+
+  bool Parse() {
+    SkipWhitespace();
+    if (!ParseValue(0)) {
+      return false;
+    }
+    SkipWhitespace();
+    return pos_ == size_ || Fail(pos_);
+  }
+
+  void Write(std::vector<uint8_t>* output) const {
+    FlatJsonHeader header{};
+    header.magic = kFlatJsonMagic;
+    header.node_count = static_cast<uint32_t>(nodes_.size());
+    header.string_bytes = static_cast<uint32_t>(strings_.size());
+    const size_t node_bytes = nodes_.size() * sizeof(FlatJsonNode);
+    output->resize(sizeof(header) + node_bytes + strings_.size());
+    uint8_t* out = output->data();
+    std::memcpy(out, &header, sizeof(header));
+    std::memcpy(out + sizeof(header), nodes_.data(), node_bytes);
+    if (!strings_.empty()) {
+      std::memcpy(out + sizeof(header) + node_bytes, strings_.data(),
+                  strings_.size());
+    }
+  }
+
+  size_t error_offset() const { return error_offset_; }
+
+ private:
+  struct KeySlot {
+    uint64_t hash = 0;
+    uint32_t offset = 0;
+    uint32_t length = kEmptySlot;
+  };
+  static constexpr uint32_t kEmptySlot = 0xFFFFFFFF;
+
+  bool Fail(size_t offset) {
+    error_offset_ = offset;
+    return false;
+  }
+
+  void SkipWhitespace() {
+    while (pos_ < size_) {
+      const uint8_t c = data_[pos_];
+      if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+        break;
+      }
+      ++pos_;
+    }
+  }
+
+  // 跳过空白后当前字节是 |c| 时消费它。
+  bool Consume(uint8_t c) {
+    SkipWhitespace();
+    if (pos_ < size_ && data_[pos_] == c) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  size_t AddNode(FlatJsonType type, uint32_t a, uint64_t b) {
+    FlatJsonNode node{};
+    node.type = static_cast<uint8_t>(type);
+    node.a = a;
+    node.b = b;
+    nodes_.push_back(node);
+    return nodes_.size() - 1;
+  }
+
+  bool ParseValue(uint32_t depth) {
+    if (pos_ >= size_) {
+      return Fail(pos_);
+    }
+    switch (data_[pos_]) {
+      case '{':
+        return ParseObject(depth + 1);
+      case '[':
+        return ParseArray(depth + 1);
+      case '"':
+        return ParseString(false);
+      case 't':
+        return ParseLiteral("true", FlatJsonType::kTrue);
+      case 'f':
+        return ParseLiteral("false", FlatJsonType::kFalse);
+      case 'n':
+        return ParseLiteral("null", FlatJsonType::kNull);
+      default:
+        return ParseNumber();
+    }
+  }
+
+  bool ParseObject(uint32_t depth) {
+    if (depth > kFlatJsonMaxDepth) {
+      return Fail(pos_);
+    }
+    const size_t index = AddNode(FlatJsonType::kObject, 0, 0);
+    ++pos_;
+    uint32_t count = 0;
+    if (!Consume('}')) {
+      do {
+        SkipWhitespace();
+        if (pos_ >= size_ || data_[pos_] != '"') {
+          return Fail(pos_);
+        }
+        if (!ParseString(true)) {
+          return false;
+        }
+        if (!Consume(':')) {
+          return Fail(pos_);
+        }
+        SkipWhitespace();
+        if (!ParseValue(depth)) {
+          return false;
+        }
+        ++count;
+      } while (Consume(','));
+      if (!Consume('}')) {
+        return Fail(pos_);
+      }
+    }
+    nodes_[index].a = count;
+    nodes_[index].b = nodes_.size();
+    return true;
+  }
+
+  bool ParseArray(uint32_t depth) {
+    if (depth > kFlatJsonMaxDepth) {
+      return Fail(pos_);
+    }
+    const size_t index = AddNode(FlatJsonType::kArray, 0, 0);
+    ++pos_;
+    uint32_t count = 0;
+    if (!Consume(']')) {
+      do {
+        SkipWhitespace();
+        if (!ParseValue(depth)) {
+          return false;
+        }
+        ++count;
+      } while (Consume(','));
+      if (!Consume(']')) {
+        return Fail(pos_);
+      }
+    }
+    nodes_[index].a = count;
+    nodes_[index].b = nodes_.size();
+    return true;
+  }
+
+  // 当前字节是字符串的起始引号，结束引号从索引中直接取得。
+  bool ParseString(bool key) {
+    if (next_quote_ + 1 >= quotes_.size() || quotes_[next_quote_] != pos_) {
+      return Fail(pos_);
+    }
+    const size_t end = quotes_[next_quote_ + 1];
+    next_quote_ += 2;
+    const uint8_t* begin = data_ + pos_ + 1;
+    const size_t length = end - pos_ - 1;
+    const size_t offset = strings_.size();
+    if (!std::memchr(begin, '\\', length)) {
+      strings_.insert(strings_.end(), begin, begin + length);
+    } else if (!AppendUnescaped(begin, begin + length)) {
+      return false;
+    }
+    pos_ = end + 1;
+    const uint32_t string_length =
+        static_cast<uint32_t>(strings_.size() - offset);
+    const uint64_t string_offset =
+        key ? InternKey(static_cast<uint32_t>(offset), string_length) : offset;
+    AddNode(FlatJsonType::kString, string_length, string_offset);
+    return true;
+  }
+
+  bool AppendUnescaped(const uint8_t* p, const uint8_t* end) {
+    while (p < end) {
+      const auto* slash = static_cast<const uint8_t*>(
+          std::memchr(p, '\\', static_cast<size_t>(end - p)));
+      if (!slash) {
+        strings_.insert(strings_.end(), p, end);
+        break;
+      }
+      strings_.insert(strings_.end(), p, slash);
+      // 转义字符总在字符串内部，结束引号之前一定还有一个字节
+      const uint8_t escape = slash[1];
+      p = slash + 2;
+      switch (escape) {
+        case '"':
+        case '\\':
+        case '/':
+          strings_.push_back(escape);
+          break;
+        case 'b':
+          strings_.push_back('\b');
+          break;
+        case 'f':
+          strings_.push_back('\f');
+          break;
+        case 'n':
+          strings_.push_back('\n');
+          break;
+        case 'r':
+          strings_.push_back('\r');
+          break;
+        case 't':
+          strings_.push_back('\t');
+          break;
+        case 'u': {
+          if (end - p < 4) {
+            return Fail(static_cast<size_t>(slash - data_));
+          }
+          int32_t code_point = ParseHex4(p);
+          if (code_point < 0) {
+            return Fail(static_cast<size_t>(slash - data_));
+          }
+          p += 4;
+          if (code_point >= 0xD800 && code_point <= 0xDBFF && end - p >= 6 &&
+              p[0] == '\\' && p[1] == 'u') {
+            const int32_t low = ParseHex4(p + 2);
+            if (low >= 0xDC00 && low <= 0xDFFF) {
+              code_point =
+                  0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+              p += 6;
+            }
+          }
+          // 落单的代理项无法编码为 UTF-8，替换为 U+FFFD
+          if (code_point >= 0xD800 && code_point <= 0xDFFF) {
+            code_point = 0xFFFD;
+          }
+          AppendUtf8(static_cast<uint32_t>(code_point), &strings_);
+          break;
+        }
+        default:
+          return Fail(static_cast<size_t>(slash - data_));
+      }
+    }
+    return true;
+  }
+
+  // 刚追加到字符串区末尾的键如果之前出现过，撤销追加并返回已有的偏移。
+  uint32_t InternKey(uint32_t offset, uint32_t length) {
+    const uint8_t* bytes = strings_.data() + offset;
+    const uint64_t hash = XxHash64(bytes, length);
+    if ((key_count_ + 1) * 2 > key_slots_.size()) {
+      GrowKeySlots();
+    }
+    const size_t mask = key_slots_.size() - 1;
+    for (size_t i = static_cast<size_t>(hash) & mask;; i = (i + 1) & mask) {
+      KeySlot& slot = key_slots_[i];
+      if (slot.length == kEmptySlot) {
+        slot.hash = hash;
+        slot.offset = offset;
+        slot.length = length;
+        ++key_count_;
+        return offset;
+      }
+      if (slot.hash == hash && slot.length == length &&
+          std::memcmp(strings_.data() + slot.offset, bytes, length) == 0) {
+        strings_.resize(offset);
+        return slot.offset;
+      }
+    }
+  }
+
+  void GrowKeySlots() {
+    std::vector<KeySlot> old_slots(key_slots_.empty() ? 64
+                                                      : key_slots_.size() * 2);
+    old_slots.swap(key_slots_);
+    const size_t mask = key_slots_.size() - 1;
+    for (const KeySlot& slot : old_slots) {
+      if (slot.length == kEmptySlot) {
+        continue;
+      }
+      size_t i = static_cast<size_t>(slot.hash) & mask;
+      while (key_slots_[i].length != kEmptySlot) {
+        i = (i + 1) & mask;
+      }
+      key_slots_[i] = slot;
+    }
+  }
+
+  bool ParseLiteral(const char* text, FlatJsonType type) {
+    const size_t length = std::strlen(text);
+    if (size_ - pos_ < length || std::memcmp(data_ + pos_, text, length) != 0) {
+      return Fail(pos_);
+    }
+    pos_ += length;
+    AddNode(type, 0, 0);
+    return true;
+  }
+
+  // 按 JSON 的数字语法检查后再转换，整数超出 int64 范围时存为 double。
+  bool ParseNumber() {
+    const size_t start = pos_;
+    size_t p = pos_;
+    if (p < size_ && data_[p] == '-') {
+      ++p;
+    }
+    if (p >= size_ || !IsDigit(data_[p])) {
+      return Fail(start);
+    }
+    if (data_[p] == '0') {
+      ++p;
+    } else {
+      while (p < size_ && IsDigit(data_[p])) {
+        ++p;
+      }
+    }
+    bool is_integer = true;
+    if (p < size_ && data_[p] == '.') {
+      is_integer = false;
+      ++p;
+      if (p >= size_ || !IsDigit(data_[p])) {
+        return Fail(p);
+      }
+      while (p < size_ && IsDigit(data_[p])) {
+        ++p;
+      }
+    }
+    if (p < size_ && (data_[p] == 'e' || data_[p] == 'E')) {
+      is_integer = false;
+      ++p;
+      if (p < size_ && (data_[p] == '+' || data_[p] == '-')) {
+        ++p;
+      }
+      if (p >= size_ || !IsDigit(data_[p])) {
+        return Fail(p);
+      }
+      while (p < size_ && IsDigit(data_[p])) {
+        ++p;
+      }
+    }
+    const char* first = reinterpret_cast<const char*>(data_ + start);
+    const char* last = reinterpret_cast<const char*>(data_ + p);
+    pos_ = p;
+    if (is_integer) {
+      int64_t value = 0;
+      if (std::from_chars(first, last, value).ec == std::errc()) {
+        AddNode(FlatJsonType::kInt, 0, static_cast<uint64_t>(value));
+        return true;
+      }
+    }
+    double value = 0.0;
+    const std::from_chars_result result = std::from_chars(first, last, value);
+    if (result.ec != std::errc() &&
+        result.ec != std::errc::result_out_of_range) {
+      return Fail(start);
+    }
+    if (result.ec == std::errc::result_out_of_range) {
+      // 和 double.parse 一致：下溢为 0，上溢为无穷
+      const bool negative = *first == '-';
+      const char* digits = negative ? first + 1 : first;
+      const auto* exponent = static_cast<const char*>(
+          std::memchr(first, 'e', static_cast<size_t>(last - first)));
+      if (!exponent) {
+        exponent = static_cast<const char*>(
+            std::memchr(first, 'E', static_cast<size_t>(last - first)));
+      }
+      const bool underflow =
+          (exponent && exponent[1] == '-') || *digits == '0';
+      value = underflow ? 0.0 : std::numeric_limits<double>::infinity();
+      if (negative) {
+        value = -value;
+      }
+    }
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    AddNode(FlatJsonType::kDouble, 0, bits);
+    return true;
+  }
+
+  const uint8_t* data_;
+  size_t size_;
+  const std::vector<uint32_t>& quotes_;
+  size_t pos_ = 0;
+  size_t next_quote_ = 0;
+  size_t error_offset_ = 0;
+  std::vector<FlatJsonNode> nodes_;
+  std::vector<uint8_t> strings_;
+  std::vector<KeySlot> key_slots_;
+  size_t key_count_ = 0;
+};
+
+}  // namespace
+
+bool ParseFlatJson(const uint8_t* data,
+                   size_t size,
+                   std::vector<uint8_t>* output,
+                   size_t* error_offset) {
+  size_t ignored_offset = 0;
+  if (!error_offset) {
+    error_offset = &ignored_offset;
+  }
+  // 引号位置和节点字段都用 32 位
+  if (size == 0 || size >= std::numeric_limits<uint32_t>::max()) {
+    *error_offset = 0;
+    return false;
+  }
+  std::vector<uint32_t> quotes;
+  quotes.reserve(size / 16);
+  if (!IndexQuotes(data, size, &quotes, error_offset)) {
+    return false;
+  }
+  Parser parser(data, size, quotes);
+  if (!parser.Parse()) {
+    *error_offset = parser.error_offset();
+    return false;
+  }
+  parser.Write(output);
+  return true;
+}
@@ -0,0 +1,61 @@
+#ifndef RUNNER_FLAT_JSON_H_
+#define RUNNER_FLAT_JSON_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 把 JSON 文本解码为扁平的二进制布局（与平台无关），供 Dart 按需读取，
+// 不构建中间的 Map/List。
+//
+// 布局（小端）：
+//   FlatJsonHeader
+//   FlatJsonNode[node_count]   按文档顺序排列的定长节点，根节点下标为 0
+//   字符串区[string_bytes]     反转义后的 UTF-8，对象的键去重后只存一份
+//
+// 容器节点后面紧跟它的子节点：数组为各个元素，对象为交替的键（字符串
+// 节点）和值。容器的 |b| 是子树之后的第一个节点下标，用于跳过整个子树。
+//
+// 第一遍用 SIMD 一次 64 字节地找出所有不在转义中的引号，第二遍解析时
+// 字符串直接跳到配对的引号，不再逐字节扫描字符串内容。
+
+enum class FlatJsonType : uint8_t {
+  kNull = 0,
+  kFalse = 1,
+  kTrue = 2,
+  kInt = 3,     // b 为 int64
+  kDouble = 4,  // b 为 double 的位模式
+  kString = 5,  // a 为字节数，b 为在字符串区中的偏移
+  kArray = 6,   // a 为元素数，b 为子树结束位置
+  kObject = 7,  // a 为键值对数，b 为子树结束位置
+};
+
+struct FlatJsonHeader {
+  uint32_t magic;
+  uint32_t node_count;
+  uint32_t string_bytes;
+  uint32_t reserved;
+};
+
+struct FlatJsonNode {
+  uint8_t type;
+  uint8_t reserved[3];
+  uint32_t a;
+  uint64_t b;
+};
+
+static_assert(sizeof(FlatJsonHeader) == 16, "FlatJsonHeader must be 16 bytes");
+static_assert(sizeof(FlatJsonNode) == 16, "FlatJsonNode must be 16 bytes");
+
+constexpr uint32_t kFlatJsonMagic = 0x4A465853;  // "SXFJ"
+// 超过这个嵌套深度的文档视为无效
+constexpr uint32_t kFlatJsonMaxDepth = 512;
+
+// 解码 |data|，结果写入 |output|。失败时返回 false，|error_offset|
+// （可以为 nullptr）为出错的字节位置。
+bool ParseFlatJson(const uint8_t* data,
+                   size_t size,
+                   std::vector<uint8_t>* output,
+                   size_t* error_offset);
+
+#endif  // RUNNER_FLAT_JSON_H_
@@ -0,0 +1,34 @@
+#include "flat_json_ffi.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "flat_json.h"
+
+uint8_t* runner_json_parse(const uint8_t* data,
+                           int64_t length,
+                           int64_t* size,
+                           int64_t* error_offset) {
+  if (!size || !error_offset || length < 0 || (length > 0 && !data)) {
+    return nullptr;
+  }
+  std::vector<uint8_t> output;
+  size_t offset = 0;
+  if (!ParseFlatJson(data, static_cast<size_t>(length), &output, &offset)) {
+    *error_offset = static_cast<int64_t>(offset);
+    return nullptr;
+  }
+  auto* buffer = static_cast<uint8_t*>(std::malloc(output.size()));
+  if (!buffer) {
+    *error_offset = 0;
+    return nullptr;
+  }
+  std::memcpy(buffer, output.data(), output.size());
+  *size = static_cast<int64_t>(output.size());
+  return buffer;
+}
+
+void runner_json_free(void* pointer) {
+  std::free(pointer);
+}
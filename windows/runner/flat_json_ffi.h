@@ -0,0 +1,21 @@
+#ifndef RUNNER_FLAT_JSON_FFI_H_
+#define RUNNER_FLAT_JSON_FFI_H_
+
+#include <cstdint>
+
+#include "ffi_export.h"
+
+// ParseFlatJson 的 C 接口，供 lib/windows/native/native_flat_json.dart
+// 使用。不访问全局状态，可以在任意 isolate 上调用。
+
+// 成功时返回用 malloc 分配的扁平布局（长度写入 |size|），失败时返回
+// nullptr 并把出错的字节位置写入 |error_offset|。
+RUNNER_FFI_EXPORT uint8_t* runner_json_parse(const uint8_t* data,
+                                             int64_t length,
+                                             int64_t* size,
+                                             int64_t* error_offset);
+
+// 可以作为 Dart NativeFinalizer 的回调。
+RUNNER_FFI_EXPORT void runner_json_free(void* pointer);
+
+#endif  // RUNNER_FLAT_JSON_FFI_H_
@@ -1,8 +1,19 @@
 #include "flutter_window.h"
 
+#include <filesystem>
 #include <optional>
+#include <thread>
 
 #include "flutter/generated_plugin_registrant.h"
+#include "kv_store_ffi.h"
+#include "startup_trace.h"
+#include "utils.h"
+
+namespace {
+
+constexpr wchar_t kStartupSnapshotFileName[] = L"startup_snapshot.bin";
+
+}  // namespace
 
 FlutterWindow::FlutterWindow(const flutter::DartProject& project)
     : project_(project) {}
@@ -16,20 +27,75 @@ bool FlutterWindow::OnCreate() {
 
   RECT frame = GetClientArea();
 
+  // Map and verify the startup snapshot while the engine is being created.
+  std::filesystem::path snapshot_path;
+  const std::wstring app_data_dir = GetAppDataDirectory();
+  if (!app_data_dir.empty()) {
+    snapshot_path =
+        std::filesystem::path(app_data_dir) / kStartupSnapshotFileName;
+  }
+  auto snapshot = std::make_unique<StartupSnapshotReader>();
+  std::thread snapshot_loader([reader = snapshot.get(), &snapshot_path]() {
+    StartupTrace::GetInstance().SetCurrentThreadName("snapshot_loader");
+    ScopedTraceSpan span("StartupSnapshot::Open", "startup");
+    if (!snapshot_path.empty()) {
+      reader->Open(snapshot_path);
+    }
+  });
+
   // The size here must match the window dimensions to avoid unnecessary surface
   // creation / destruction in the startup path.
-  flutter_controller_ = std::make_unique<flutter::FlutterViewController>(
-      frame.right - frame.left, frame.bottom - frame.top, project_);
+  {
+    ScopedTraceSpan span("FlutterViewController", "startup");
+    flutter_controller_ = std::make_unique<flutter::FlutterViewController>(
+        frame.right - frame.left, frame.bottom - frame.top, project_);
+  }
+  snapshot_loader.join();
   // Ensure that basic setup of the controller was successful.
   if (!flutter_controller_->engine() || !flutter_controller_->view()) {
     return false;
   }
-  RegisterPlugins(flutter_controller_->engine());
+  {
+    ScopedTraceSpan span("RegisterPlugins", "startup");
+    RegisterPlugins(flutter_controller_->engine());
+  }
+  startup_trace_channel_ = std::make_unique<StartupTraceChannel>(
+      flutter_controller_->engine()->messenger());
+  startup_snapshot_channel_ = std::make_unique<StartupSnapshotChannel>(
+      flutter_controller_->engine()->messenger(), snapshot_path,
+      std::move(snapshot));
+  task_runner_ = std::make_shared<PlatformTaskRunner>(GetHandle());
+  http_channel_ = std::make_unique<HttpChannel>(
+      flutter_controller_->engine()->messenger(), task_runner_);
+  font_subset_channel_ = std::make_unique<FontSubsetChannel>(
+      flutter_controller_->engine()->messenger(), task_runner_);
+  download_channel_ = std::make_unique<DownloadChannel>(
+      flutter_controller_->engine()->messenger(), task_runner_);
+  image_channel_ = std::make_unique<ImageChannel>(
+      flutter_controller_->engine()->messenger(), task_runner_);
+  memory_telemetry_channel_ = std::make_unique<MemoryTelemetryChannel>(
+      flutter_controller_->engine()->messenger());
+  thumbnail_channel_ = std::make_unique<ThumbnailChannel>(
+      flutter_controller_->engine()->messenger(), task_runner_);
+  window_resize_channel_ = std::make_unique<WindowResizeChannel>(
+      flutter_controller_->engine()->messenger());
+  render_budget_channel_ = std::make_unique<RenderBudgetChannel>(
+      flutter_controller_->engine()->messenger());
+  render_budget_monitor_ = std::make_unique<RenderBudgetMonitor>(
+      GetHandle(), [this](RenderBudgetLevel level) {
+        render_budget_channel_->Send(level);
+      });
+  render_budget_channel_->Send(render_budget_monitor_->level());
   SetChildContent(flutter_controller_->view()->GetNativeWindow());
 
-  flutter_controller_->engine()->SetNextFrameCallback([&]() {
-    this->Show();
-  });
+  const int64_t first_frame_wait_begin = StartupTrace::NowMicros();
+  flutter_controller_->engine()->SetNextFrameCallback(
+      [&, first_frame_wait_begin]() {
+        StartupTrace::GetInstance().AddSpan("WaitForFirstFrame", "startup",
+                                            first_frame_wait_begin,
+                                            StartupTrace::NowMicros());
+        this->Show();
+      });
 
   // Flutter can complete the first frame before the "show window" callback is
   // registered. The following call ensures a frame is pending to ensure the
@@ -40,17 +106,57 @@ bool FlutterWindow::OnCreate() {
 }
 
 void FlutterWindow::OnDestroy() {
+  render_budget_monitor_ = nullptr;
+  render_budget_channel_ = nullptr;
+  window_resize_channel_ = nullptr;
+  thumbnail_channel_ = nullptr;
+  memory_telemetry_channel_ = nullptr;
+  image_channel_ = nullptr;
+  font_subset_channel_ = nullptr;
+  // Pauses running downloads so they resume on the next launch.
+  download_channel_ = nullptr;
+  http_channel_ = nullptr;
+  if (task_runner_) {
+    task_runner_->Shutdown();
+    task_runner_ = nullptr;
+  }
+  if (startup_snapshot_channel_) {
+    startup_snapshot_channel_->Save();
+    startup_snapshot_channel_ = nullptr;
+  }
+  startup_trace_channel_ = nullptr;
   if (flutter_controller_) {
     flutter_controller_ = nullptr;
   }
+  // 引擎已经关闭，不会再有写入
+  FlushNamedKvStores();
 
   Win32Window::OnDestroy();
 }
 
+void FlutterWindow::OnLiveResize(bool resizing) {
+  if (window_resize_channel_) {
+    window_resize_channel_->Send(resizing);
+  }
+}
+
 LRESULT
 FlutterWindow::MessageHandler(HWND hwnd, UINT const message,
                               WPARAM const wparam,
                               LPARAM const lparam) noexcept {
+  if (message == PlatformTaskRunner::kRunTasksMessage) {
+    if (task_runner_) {
+      task_runner_->RunPendingTasks();
+    }
+    return 0;
+  }
+
+  // The monitor only observes messages, apart from its own timers.
+  if (render_budget_monitor_ &&
+      render_budget_monitor_->HandleMessage(message, wparam, lparam)) {
+    return 0;
+  }
+
   // Give Flutter, including plugins, an opportunity to handle window messages.
   if (flutter_controller_) {
     std::optional<LRESULT> result =
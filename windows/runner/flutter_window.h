@@ -6,7 +6,19 @@
 
 #include <memory>
 
+#include "download_channel.h"
+#include "font_subset_channel.h"
+#include "http_channel.h"
+#include "image_channel.h"
+#include "memory_telemetry_channel.h"
+#include "platform_task_runner.h"
+#include "render_budget_channel.h"
+#include "render_budget_monitor.h"
+#include "startup_snapshot_channel.h"
+#include "startup_trace_channel.h"
+#include "thumbnail_channel.h"
 #include "win32_window.h"
+#include "window_resize_channel.h"
 
 // A window that does nothing but host a Flutter view.
 class FlutterWindow : public Win32Window {
@@ -24,6 +36,7 @@ class FlutterWindow : public Win32Window {
   // Win32Window:
   bool OnCreate() override;
   void OnDestroy() override;
+  void OnLiveResize(bool resizing) override;
   LRESULT MessageHandler(HWND window, UINT const message, WPARAM const wparam,
                          LPARAM const lparam) noexcept override;
 
@@ -33,6 +46,43 @@ class FlutterWindow : public Win32Window {
 
   // The Flutter instance hosted by this window.
   std::unique_ptr<flutter::FlutterViewController> flutter_controller_;
+
+  // Lets Dart append its own startup spans to the native timeline.
+  std::unique_ptr<StartupTraceChannel> startup_trace_channel_;
+
+  // Hands the last session's home screen data to Dart before the first frame
+  // and writes the updated snapshot on shutdown.
+  std::unique_ptr<StartupSnapshotChannel> startup_snapshot_channel_;
+
+  // Runs replies from native worker threads on the platform thread.
+  std::shared_ptr<PlatformTaskRunner> task_runner_;
+
+  // Native HTTP client backed by the connection pool warmed during pre-init.
+  std::unique_ptr<HttpChannel> http_channel_;
+
+  // Records the characters the UI uses and builds a subset of the bundled
+  // CJK font for the next launch.
+  std::unique_ptr<FontSubsetChannel> font_subset_channel_;
+
+  // Downloads direct game links over several resumable connections.
+  std::unique_ptr<DownloadChannel> download_channel_;
+
+  // Decodes, crops and encodes images for the crop dialog off the UI thread.
+  std::unique_ptr<ImageChannel> image_channel_;
+
+  // Lets the admin panel read and dump the memory telemetry series.
+  std::unique_ptr<MemoryTelemetryChannel> memory_telemetry_channel_;
+
+  // Serves display-sized cover thumbnails to list and grid screens.
+  std::unique_ptr<ThumbnailChannel> thumbnail_channel_;
+
+  // Tells Dart exactly when the user starts and stops resizing the window.
+  std::unique_ptr<WindowResizeChannel> window_resize_channel_;
+
+  // Throttles background animations while the window is hidden or the
+  // machine is saving power.
+  std::unique_ptr<RenderBudgetChannel> render_budget_channel_;
+  std::unique_ptr<RenderBudgetMonitor> render_budget_monitor_;
 };
 
 #endif  // RUNNER_FLUTTER_WINDOW_H_
\ No newline at end of file
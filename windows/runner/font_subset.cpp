@@ -0,0 +1,641 @@
+#include "font_subset.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+uint16_t ReadU16(const uint8_t* p) {
+  return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+uint32_t ReadU32(const uint8_t* p) {
+  return (static_cast<uint32_t>(p[0]) << 24) |
+         (static_cast<uint32_t>(p[1]) << 16) |
+         (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+void PutU16(std::vector<uint8_t>* out, uint32_t value) {
+  out->push_back(static_cast<uint8_t>(value >> 8));
+  out->push_back(static_cast<uint8_t>(value));
+}
+
+void PutU32(std::vector<uint8_t>* out, uint32_t value) {
+  PutU16(out, value >> 16);
+  PutU16(out, value & 0xFFFF);
+}
+
+void SetU16(std::vector<uint8_t>* out, size_t offset, uint32_t value) {
+  (*out)[offset] = static_cast<uint8_t>(value >> 8);
+  (*out)[offset + 1] = static_cast<uint8_t>(value);
+}
+
+void SetU32(std::vector<uint8_t>* out, size_t offset, uint32_t value) {
+  SetU16(out, offset, value >> 16);
+  SetU16(out, offset + 2, value & 0xFFFF);
+}
+
+uint32_t TableChecksum(const uint8_t* data, size_t size) {
+  uint32_t sum = 0;
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    sum += ReadU32(data + i);
+  }
+  if (i < size) {
+    uint8_t tail[4] = {};
+    std::memcpy(tail, data + i, size - i);
+    sum += ReadU32(tail);
+  }
+  return sum;
+}
+
+struct Table {
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+};
+
+// 解析后的源字体，所有指针指向调用方的数据。
+class SourceFont {
+ public:
+  bool Parse(const uint8_t* font, size_t size);
+
+  const Table* Find(const char* tag) const {
+    auto it = tables_.find(tag);
+    return it == tables_.end() ? nullptr : &it->second;
+  }
+  uint16_t num_glyphs() const { return num_glyphs_; }
+  // 字形 |glyph| 在 glyf 中的数据，空字形的 size 为 0。
+  bool GlyphData(uint32_t glyph, Table* out) const;
+  void Metrics(uint32_t glyph, uint16_t* advance, uint16_t* lsb) const;
+  // 码位映射到的字形，没有时为 0。
+  uint32_t Lookup(uint32_t code_point) const;
+  std::vector<uint32_t> CodePoints() const;
+
+ private:
+  bool ParseCmap();
+
+  std::map<std::string, Table> tables_;
+  uint16_t num_glyphs_ = 0;
+  uint16_t num_h_metrics_ = 0;
+  bool long_loca_ = false;
+  Table glyf_;
+  Table loca_;
+  Table hmtx_;
+  // 格式 12 的 (start, end, start_glyph) 或由格式 4 展开的映射
+  struct Group {
+    uint32_t start;
+    uint32_t end;
+    uint32_t start_glyph;
+  };
+  std::vector<Group> groups_;
+  std::unordered_map<uint32_t, uint32_t> format4_;
+};
+
+bool SourceFont::Parse(const uint8_t* font, size_t size) {
+  if (size < 12) {
+    return false;
+  }
+  const uint32_t version = ReadU32(font);
+  if (version != 0x00010000 && version != 0x74727565) {  // 'true'
+    return false;
+  }
+  const uint16_t num_tables = ReadU16(font + 4);
+  if (12 + static_cast<size_t>(num_tables) * 16 > size) {
+    return false;
+  }
+  for (uint16_t i = 0; i < num_tables; ++i) {
+    const uint8_t* record = font + 12 + i * 16;
+    const uint32_t offset = ReadU32(record + 8);
+    const uint32_t length = ReadU32(record + 12);
+    if (offset > size || length > size - offset) {
+      return false;
+    }
+    tables_[std::string(reinterpret_cast<const char*>(record), 4)] = {
+        font + offset, length};
+  }
+
+  const Table* head = Find("head");
+  const Table* hhea = Find("hhea");
+  const Table* maxp = Find("maxp");
+  const Table* hmtx = Find("hmtx");
+  const Table* loca = Find("loca");
+  const Table* glyf = Find("glyf");
+  if (!head || !hhea || !maxp || !hmtx || !loca || !glyf || !Find("cmap") ||
+      head->size < 54 || hhea->size < 36 || maxp->size < 6) {
+    return false;
+  }
+  long_loca_ = ReadU16(head->data + 50) != 0;
+  num_glyphs_ = ReadU16(maxp->data + 4);
+  num_h_metrics_ = ReadU16(hhea->data + 34);
+  glyf_ = *glyf;
+  loca_ = *loca;
+  hmtx_ = *hmtx;
+  const size_t loca_entry = long_loca_ ? 4 : 2;
+  if (num_glyphs_ == 0 || num_h_metrics_ == 0 ||
+      num_h_metrics_ > num_glyphs_ ||
+      loca_.size < (static_cast<size_t>(num_glyphs_) + 1) * loca_entry ||
+      hmtx_.size < static_cast<size_t>(num_h_metrics_) * 4 +
+                       static_cast<size_t>(num_glyphs_ - num_h_metrics_) * 2) {
+    return false;
+  }
+  return ParseCmap();
+}
+
+bool SourceFont::ParseCmap() {
+  const Table* cmap = Find("cmap");
+  if (cmap->size < 4) {
+    return false;
+  }
+  const uint8_t* data = cmap->data;
+  const uint16_t count = ReadU16(data + 2);
+  if (4 + static_cast<size_t>(count) * 8 > cmap->size) {
+    return false;
+  }
+  const uint8_t* format12 = nullptr;
+  const uint8_t* format4 = nullptr;
+  for (uint16_t i = 0; i < count; ++i) {
+    const uint8_t* record = data + 4 + i * 8;
+    const uint16_t platform = ReadU16(record);
+    const uint16_t encoding = ReadU16(record + 2);
+    const uint32_t offset = ReadU32(record + 4);
+    if (offset + 4 > cmap->size) {
+      continue;
+    }
+    const uint16_t format = ReadU16(data + offset);
+    const bool unicode =
+        platform == 0 || (platform == 3 && (encoding == 1 || encoding == 10));
+    if (!unicode) {
+      continue;
+    }
+    if (format == 12 && !format12) {
+      format12 = data + offset;
+    } else if (format == 4 && !format4) {
+      format4 = data + offset;
+    }
+  }
+  const uint8_t* end = data + cmap->size;
+
+  if (format12) {
+    if (format12 + 16 > end) {
+      return false;
+    }
+    const uint32_t num_groups = ReadU32(format12 + 12);
+    if (num_groups > static_cast<size_t>(end - format12 - 16) / 12) {
+      return false;
+    }
+    groups_.reserve(num_groups);
+    for (uint32_t i = 0; i < num_groups; ++i) {
+      const uint8_t* group = format12 + 16 + i * 12;
+      const uint32_t start = ReadU32(group);
+      const uint32_t stop = ReadU32(group + 4);
+      if (stop >= start) {
+        groups_.push_back({start, stop, ReadU32(group + 8)});
+      }
+    }
+    std::sort(groups_.begin(), groups_.end(),
+              [](const Group& a, const Group& b) { return a.start < b.start; });
+    return true;
+  }
+
+  if (!format4 || format4 + 14 > end) {
+    return false;
+  }
+  const uint16_t seg_count = ReadU16(format4 + 6) / 2;
+  const uint8_t* end_codes = format4 + 14;
+  const uint8_t* start_codes = end_codes + seg_count * 2 + 2;
+  const uint8_t* deltas = start_codes + seg_count * 2;
+  const uint8_t* range_offsets = deltas + seg_count * 2;
+  if (range_offsets + seg_count * 2 > end) {
+    return false;
+  }
+  for (uint16_t i = 0; i < seg_count; ++i) {
+    const uint16_t start = ReadU16(start_codes + i * 2);
+    const uint16_t stop = ReadU16(end_codes + i * 2);
+    const uint16_t delta = ReadU16(deltas + i * 2);
+    const uint16_t range_offset = ReadU16(range_offsets + i * 2);
+    for (uint32_t code = start; code <= stop && code != 0xFFFF; ++code) {
+      uint32_t glyph = 0;
+      if (range_offset == 0) {
+        glyph = (code + delta) & 0xFFFF;
+      } else {
+        const uint8_t* entry =
+            range_offsets + i * 2 + range_offset + (code - start) * 2;
+        if (entry + 2 > end) {
+          return false;
+        }
+        glyph = ReadU16(entry);
+        if (glyph != 0) {
+          glyph = (glyph + delta) & 0xFFFF;
+        }
+      }
+      if (glyph != 0) {
+        format4_[code] = glyph;
+      }
+    }
+  }
+  return true;
+}
+
+bool SourceFont::GlyphData(uint32_t glyph, Table* out) const {
+  if (glyph >= num_glyphs_) {
+    return false;
+  }
+  uint32_t begin = 0;
+  uint32_t end = 0;
+  if (long_loca_) {
+    begin = ReadU32(loca_.data + glyph * 4);
+    end = ReadU32(loca_.data + glyph * 4 + 4);
+  } else {
+    begin = ReadU16(loca_.data + glyph * 2) * 2u;
+    end = ReadU16(loca_.data + glyph * 2 + 2) * 2u;
+  }
+  if (begin > end || end > glyf_.size) {
+    return false;
+  }
+  out->data = glyf_.data + begin;
+  out->size = end - begin;
+  return true;
+}
+
+void SourceFont::Metrics(uint32_t glyph,
+                         uint16_t* advance,
+                         uint16_t* lsb) const {
+  if (glyph < num_h_metrics_) {
+    *advance = ReadU16(hmtx_.data + glyph * 4);
+    *lsb = ReadU16(hmtx_.data + glyph * 4 + 2);
+    return;
+  }
+  *advance = ReadU16(hmtx_.data + (num_h_metrics_ - 1) * 4);
+  *lsb = ReadU16(hmtx_.data + num_h_metrics_ * 4 +
+                 (glyph - num_h_metrics_) * 2);
+}
+
+uint32_t SourceFont::Lookup(uint32_t code_point) const {
+  if (!groups_.empty()) {
+    auto it = std::upper_bound(
+        groups_.begin(), groups_.end(), code_point,
+        [](uint32_t value, const Group& group) { return value < group.start; });
+    if (it == groups_.begin()) {
+      return 0;
+    }
+    --it;
+    return code_point <= it->end ? it->start_glyph + (code_point - it->start)
+                                 : 0;
+  }
+  auto it = format4_.find(code_point);
+  return it == format4_.end() ? 0 : it->second;
+}
+
+std::vector<uint32_t> SourceFont::CodePoints() const {
+  std::vector<uint32_t> code_points;
+  for (const Group& group : groups_) {
+    for (uint32_t code = group.start; code <= group.end; ++code) {
+      code_points.push_back(code);
+      if (code == UINT32_MAX) {
+        break;
+      }
+    }
+  }
+  for (const auto& entry : format4_) {
+    code_points.push_back(entry.first);
+  }
+  std::sort(code_points.begin(), code_points.end());
+  code_points.erase(std::unique(code_points.begin(), code_points.end()),
+                    code_points.end());
+  return code_points;
+}
+
+// 复合字形的部件标志
+constexpr uint16_t kArg1And2AreWords = 0x0001;
+constexpr uint16_t kWeHaveAScale = 0x0008;
+constexpr uint16_t kMoreComponents = 0x0020;
+constexpr uint16_t kWeHaveAnXAndYScale = 0x0040;
+constexpr uint16_t kWeHaveATwoByTwo = 0x0080;
+
+// 对复合字形的每个部件调用 |visit(offset_of_glyph_index)|。结构无效时
+// 返回 false。
+template <typename Visit>
+bool ForEachComponent(const Table& glyph, Visit visit) {
+  if (glyph.size < 10 || static_cast<int16_t>(ReadU16(glyph.data)) >= 0) {
+    return true;
+  }
+  size_t offset = 10;
+  for (;;) {
+    if (offset + 4 > glyph.size) {
+      return false;
+    }
+    const uint16_t flags = ReadU16(glyph.data + offset);
+    visit(offset + 2);
+    offset += 4;
+    offset += (flags & kArg1And2AreWords) ? 4 : 2;
+    if (flags & kWeHaveAScale) {
+      offset += 2;
+    } else if (flags & kWeHaveAnXAndYScale) {
+      offset += 4;
+    } else if (flags & kWeHaveATwoByTwo) {
+      offset += 8;
+    }
+    if (!(flags & kMoreComponents)) {
+      return offset <= glyph.size;
+    }
+  }
+}
+
+struct Mapping {
+  uint32_t code_point;
+  uint32_t glyph;  // 新编号
+};
+
+// 连续码位且字形也连续的区间。
+struct Range {
+  uint32_t start;
+  uint32_t end;
+  uint32_t start_glyph;
+};
+
+std::vector<Range> DeltaRanges(const std::vector<Mapping>& mappings) {
+  std::vector<Range> ranges;
+  for (const Mapping& mapping : mappings) {
+    if (!ranges.empty() && ranges.back().end + 1 == mapping.code_point &&
+        ranges.back().start_glyph + (mapping.code_point - ranges.back().start) ==
+            mapping.glyph) {
+      ranges.back().end = mapping.code_point;
+    } else {
+      ranges.push_back({mapping.code_point, mapping.code_point, mapping.glyph});
+    }
+  }
+  return ranges;
+}
+
+std::vector<uint8_t> BuildCmapFormat12(const std::vector<Mapping>& mappings) {
+  const std::vector<Range> ranges = DeltaRanges(mappings);
+  std::vector<uint8_t> out;
+  PutU16(&out, 12);
+  PutU16(&out, 0);
+  PutU32(&out, static_cast<uint32_t>(16 + ranges.size() * 12));
+  PutU32(&out, 0);
+  PutU32(&out, static_cast<uint32_t>(ranges.size()));
+  for (const Range& range : ranges) {
+    PutU32(&out, range.start);
+    PutU32(&out, range.end);
+    PutU32(&out, range.start_glyph);
+  }
+  return out;
+}
+
+// 只含 BMP 码位。超出格式 4 的 64KB 上限时返回空数组。
+std::vector<uint8_t> BuildCmapFormat4(const std::vector<Mapping>& mappings) {
+  std::vector<Range> ranges;
+  for (const Range& range : DeltaRanges(mappings)) {
+    if (range.start >= 0xFFFF) {
+      break;
+    }
+    ranges.push_back({range.start, std::min<uint32_t>(range.end, 0xFFFE),
+                      range.start_glyph});
+  }
+  ranges.push_back({0xFFFF, 0xFFFF, 0});  // 结束段，映射到 0
+  const size_t seg_count = ranges.size();
+  const size_t length = 16 + seg_count * 8;
+  if (length > 0xFFFF) {
+    return {};
+  }
+  uint32_t search_range = 2;
+  uint32_t entry_selector = 0;
+  while (search_range * 2 <= seg_count * 2) {
+    search_range *= 2;
+    ++entry_selector;
+  }
+  std::vector<uint8_t> out;
+  PutU16(&out, 4);
+  PutU16(&out, static_cast<uint32_t>(length));
+  PutU16(&out, 0);
+  PutU16(&out, static_cast<uint32_t>(seg_count * 2));
+  PutU16(&out, search_range);
+  PutU16(&out, entry_selector);
+  PutU16(&out, static_cast<uint32_t>(seg_count * 2) - search_range);
+  for (const Range& range : ranges) {
+    PutU16(&out, range.end);
+  }
+  PutU16(&out, 0);
+  for (const Range& range : ranges) {
+    PutU16(&out, range.start);
+  }
+  for (const Range& range : ranges) {
+    const uint32_t delta =
+        range.start == 0xFFFF ? 1 : range.start_glyph - range.start;
+    PutU16(&out, delta & 0xFFFF);
+  }
+  for (size_t i = 0; i < seg_count; ++i) {
+    PutU16(&out, 0);
+  }
+  return out;
+}
+
+std::vector<uint8_t> BuildCmap(const std::vector<Mapping>& mappings) {
+  const std::vector<uint8_t> format4 = BuildCmapFormat4(mappings);
+  const std::vector<uint8_t> format12 = BuildCmapFormat12(mappings);
+  const uint32_t subtable_count = format4.empty() ? 1 : 2;
+  std::vector<uint8_t> out;
+  PutU16(&out, 0);
+  PutU16(&out, subtable_count);
+  uint32_t offset = 4 + subtable_count * 8;
+  if (!format4.empty()) {
+    PutU16(&out, 3);
+    PutU16(&out, 1);
+    PutU32(&out, offset);
+    offset += static_cast<uint32_t>(format4.size());
+  }
+  PutU16(&out, 3);
+  PutU16(&out, 10);
+  PutU32(&out, offset);
+  out.insert(out.end(), format4.begin(), format4.end());
+  out.insert(out.end(), format12.begin(), format12.end());
+  return out;
+}
+
+}  // namespace
+
+bool SubsetTrueTypeFont(const uint8_t* font,
+                        size_t size,
+                        const std::vector<uint32_t>& code_points,
+                        std::vector<uint8_t>* output) {
+  SourceFont source;
+  if (!font || !source.Parse(font, size)) {
+    return false;
+  }
+
+  // 需要的字形：.notdef、码位映射到的字形和复合字形部件的闭包
+  std::vector<bool> keep(source.num_glyphs(), false);
+  keep[0] = true;
+  std::vector<uint32_t> pending = {0};
+  std::vector<std::pair<uint32_t, uint32_t>> mapped;  // 码位、原字形
+  for (uint32_t code_point : code_points) {
+    const uint32_t glyph = source.Lookup(code_point);
+    if (glyph == 0 || glyph >= source.num_glyphs()) {
+      continue;
+    }
+    mapped.emplace_back(code_point, glyph);
+    if (!keep[glyph]) {
+      keep[glyph] = true;
+      pending.push_back(glyph);
+    }
+  }
+  while (!pending.empty()) {
+    const uint32_t glyph = pending.back();
+    pending.pop_back();
+    Table data;
+    if (!source.GlyphData(glyph, &data)) {
+      return false;
+    }
+    bool valid = true;
+    const bool parsed = ForEachComponent(data, [&](size_t offset) {
+      const uint16_t component = ReadU16(data.data + offset);
+      if (component >= source.num_glyphs()) {
+        valid = false;
+      } else if (!keep[component]) {
+        keep[component] = true;
+        pending.push_back(component);
+      }
+    });
+    if (!parsed || !valid) {
+      return false;
+    }
+  }
+
+  std::vector<uint32_t> new_ids(source.num_glyphs(), 0);
+  std::vector<uint32_t> old_ids;
+  for (uint32_t glyph = 0; glyph < source.num_glyphs(); ++glyph) {
+    if (keep[glyph]) {
+      new_ids[glyph] = static_cast<uint32_t>(old_ids.size());
+      old_ids.push_back(glyph);
+    }
+  }
+  const uint32_t glyph_count = static_cast<uint32_t>(old_ids.size());
+
+  // glyf 与 loca，字形数据按 4 字节对齐
+  std::vector<uint8_t> glyf;
+  std::vector<uint8_t> loca;
+  for (uint32_t old_id : old_ids) {
+    PutU32(&loca, static_cast<uint32_t>(glyf.size()));
+    Table data;
+    source.GlyphData(old_id, &data);
+    const size_t begin = glyf.size();
+    glyf.insert(glyf.end(), data.data, data.data + data.size);
+    const Table copy = {glyf.data() + begin, data.size};
+    ForEachComponent(copy, [&](size_t offset) {
+      SetU16(&glyf, begin + offset, new_ids[ReadU16(copy.data + offset)]);
+    });
+    glyf.resize((glyf.size() + 3) & ~size_t{3}, 0);
+  }
+  PutU32(&loca, static_cast<uint32_t>(glyf.size()));
+
+  // hmtx：末尾等宽的字形只保留左侧方位
+  std::vector<uint16_t> advances(glyph_count);
+  std::vector<uint16_t> lsbs(glyph_count);
+  for (uint32_t i = 0; i < glyph_count; ++i) {
+    source.Metrics(old_ids[i], &advances[i], &lsbs[i]);
+  }
+  uint32_t h_metrics = glyph_count;
+  while (h_metrics > 1 && advances[h_metrics - 2] == advances[glyph_count - 1]) {
+    --h_metrics;
+  }
+  std::vector<uint8_t> hmtx;
+  for (uint32_t i = 0; i < glyph_count; ++i) {
+    if (i < h_metrics) {
+      PutU16(&hmtx, advances[i]);
+    }
+    PutU16(&hmtx, lsbs[i]);
+  }
+
+  std::sort(mapped.begin(), mapped.end());
+  mapped.erase(std::unique(mapped.begin(), mapped.end()), mapped.end());
+  std::vector<Mapping> mappings;
+  mappings.reserve(mapped.size());
+  for (const auto& entry : mapped) {
+    mappings.push_back({entry.first, new_ids[entry.second]});
+  }
+
+  const Table* head_table = source.Find("head");
+  std::vector<uint8_t> head(head_table->data,
+                            head_table->data + head_table->size);
+  SetU32(&head, 8, 0);   // checkSumAdjustment，最后填写
+  SetU16(&head, 50, 1);  // indexToLocFormat：长格式
+  const Table* hhea_table = source.Find("hhea");
+  std::vector<uint8_t> hhea(hhea_table->data,
+                            hhea_table->data + hhea_table->size);
+  SetU16(&hhea, 34, h_metrics);
+  const Table* maxp_table = source.Find("maxp");
+  std::vector<uint8_t> maxp(maxp_table->data,
+                            maxp_table->data + maxp_table->size);
+  SetU16(&maxp, 4, glyph_count);
+  std::vector<uint8_t> post;
+  PutU32(&post, 0x00030000);
+  if (const Table* post_table = source.Find("post");
+      post_table && post_table->size >= 32) {
+    // 保留斜角、下划线和等宽信息
+    post.insert(post.end(), post_table->data + 4, post_table->data + 32);
+  } else {
+    post.resize(32, 0);
+  }
+
+  std::map<std::string, std::vector<uint8_t>> tables;
+  tables["cmap"] = BuildCmap(mappings);
+  tables["glyf"] = std::move(glyf);
+  tables["head"] = std::move(head);
+  tables["hhea"] = std::move(hhea);
+  tables["hmtx"] = std::move(hmtx);
+  tables["loca"] = std::move(loca);
+  tables["maxp"] = std::move(maxp);
+  tables["post"] = std::move(post);
+  for (const char* tag : {"OS/2", "name", "cvt ", "fpgm", "prep", "gasp"}) {
+    if (const Table* table = source.Find(tag)) {
+      tables[tag].assign(table->data, table->data + table->size);
+    }
+  }
+
+  // 表目录按标签排序（std::map 的顺序即字节序）
+  const uint32_t num_tables = static_cast<uint32_t>(tables.size());
+  uint32_t search_range = 16;
+  uint32_t entry_selector = 0;
+  while (search_range * 2 <= num_tables * 16) {
+    search_range *= 2;
+    ++entry_selector;
+  }
+  std::vector<uint8_t> out;
+  PutU32(&out, 0x00010000);
+  PutU16(&out, num_tables);
+  PutU16(&out, search_range);
+  PutU16(&out, entry_selector);
+  PutU16(&out, num_tables * 16 - search_range);
+  size_t offset = 12 + num_tables * 16;
+  size_t head_offset = 0;
+  for (const auto& [tag, data] : tables) {
+    out.insert(out.end(), tag.begin(), tag.end());
+    PutU32(&out, TableChecksum(data.data(), data.size()));
+    PutU32(&out, static_cast<uint32_t>(offset));
+    PutU32(&out, static_cast<uint32_t>(data.size()));
+    if (tag == "head") {
+      head_offset = offset;
+    }
+    offset += (data.size() + 3) & ~size_t{3};
+  }
+  for (const auto& entry : tables) {
+    out.insert(out.end(), entry.second.begin(), entry.second.end());
+    out.resize((out.size() + 3) & ~size_t{3}, 0);
+  }
+  SetU32(&out, head_offset + 8,
+         0xB1B0AFBA - TableChecksum(out.data(), out.size()));
+  *output = std::move(out);
+  return true;
+}
+
+std::vector<uint32_t> FontCodePoints(const uint8_t* font, size_t size) {
+  SourceFont source;
+  if (!font || !source.Parse(font, size)) {
+    return {};
+  }
+  return source.CodePoints();
+}
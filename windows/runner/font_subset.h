@@ -0,0 +1,26 @@
+#ifndef RUNNER_FONT_SUBSET_H_
+#define RUNNER_FONT_SUBSET_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 生成 TrueType（glyf 轮廓）字体的子集（与平台无关）。
+//
+// 子集只保留 |code_points| 映射到的字形、.notdef 和复合字形引用的部件，
+// 字形按原顺序重新编号。输出的表：cmap（(3,1) 格式 4 和 (3,10) 格式
+// 12）、glyf、loca（长格式）、head、hhea、hmtx、maxp、name、OS/2、
+// post（3.0，不含字形名），原字体有 cvt/fpgm/prep/gasp 时原样保留。
+// GSUB/GPOS 和竖排的 vhea/vmtx/VORG 不保留：子集只用于横排 UI 文本，
+// 缺少的字形和排版特性由完整字体作为后备。
+//
+// 字体不是 TrueType 轮廓（例如 CFF）或结构无效时返回 false。
+bool SubsetTrueTypeFont(const uint8_t* font,
+                        size_t size,
+                        const std::vector<uint32_t>& code_points,
+                        std::vector<uint8_t>* output);
+
+// 返回字体 cmap 覆盖的全部码位，按升序排列。字体无效时返回空数组。
+std::vector<uint32_t> FontCodePoints(const uint8_t* font, size_t size);
+
+#endif  // RUNNER_FONT_SUBSET_H_
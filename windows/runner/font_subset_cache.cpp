@@ -0,0 +1,314 @@
+#include "font_subset_cache.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "font_subset.h"
+#include "mapped_file.h"
+#include "xxhash64.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kUsageFileName[] = "usage.bin";
+constexpr char kManifestSuffix[] = ".manifest";
+constexpr char kSubsetSuffix[] = ".ttf";
+constexpr uint32_t kUsageMagic = 0x55465853;     // "SXFU"
+constexpr uint32_t kManifestMagic = 0x4D465853;  // "SXFM"
+constexpr uint32_t kVersion = 1;
+constexpr size_t kMaxCodePoints = 1u << 16;
+
+// 总是包含的码位：ASCII、常用标点、中文标点和全角字符。
+constexpr uint32_t kBaseRanges[][2] = {
+    {0x0020, 0x007E},
+    {0x00A0, 0x00FF},
+    {0x2010, 0x2027},
+    {0x3000, 0x303F},
+    {0xFF00, 0xFFEF},
+};
+
+struct UsageHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t count;
+  uint32_t reserved;
+};
+
+struct Manifest {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t font_size;
+  int64_t font_modified_time;
+  uint64_t font_hash;
+  uint64_t set_hash;
+};
+
+int64_t NowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+int64_t ModifiedTime(const fs::path& path, std::error_code* error) {
+  const auto time = fs::last_write_time(path, *error);
+  return static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+std::string Hex(uint64_t value) {
+  static const char kDigits[] = "0123456789abcdef";
+  std::string text(16, '0');
+  for (int i = 15; i >= 0; --i) {
+    text[static_cast<size_t>(i)] = kDigits[value & 0xF];
+    value >>= 4;
+  }
+  return text;
+}
+
+// 先写临时文件再改名。
+bool WriteFileAtomically(const fs::path& path, const void* data, size_t size) {
+  fs::path temp_path = path;
+  temp_path += ".tmp";
+  {
+    std::ofstream out(temp_path,
+                      std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!out) {
+      return false;
+    }
+    out.write(static_cast<const char*>(data),
+              static_cast<std::streamsize>(size));
+    if (!out) {
+      return false;
+    }
+  }
+  std::error_code error;
+  fs::rename(temp_path, path, error);
+  return !error;
+}
+
+}  // namespace
+
+FontSubsetCache::FontSubsetCache(fs::path directory, fs::path font_path)
+    : directory_(std::move(directory)), font_path_(std::move(font_path)) {
+  LoadUsage();
+}
+
+FontSubsetCache::~FontSubsetCache() {
+  SaveUsage();
+}
+
+void FontSubsetCache::RecordUtf8(std::string_view text) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto* bytes = reinterpret_cast<const uint8_t*>(text.data());
+  const size_t size = text.size();
+  for (size_t i = 0; i < size;) {
+    const uint8_t lead = bytes[i];
+    uint32_t code_point = 0;
+    size_t length = 0;
+    if (lead < 0x80) {
+      ++i;  // ASCII 总是包含在子集里
+      continue;
+    } else if ((lead & 0xE0) == 0xC0) {
+      code_point = lead & 0x1F;
+      length = 2;
+    } else if ((lead & 0xF0) == 0xE0) {
+      code_point = lead & 0x0F;
+      length = 3;
+    } else if ((lead & 0xF8) == 0xF0) {
+      code_point = lead & 0x07;
+      length = 4;
+    } else {
+      ++i;
+      continue;
+    }
+    if (i + length > size) {
+      break;
+    }
+    bool valid = true;
+    for (size_t k = 1; k < length; ++k) {
+      if ((bytes[i + k] & 0xC0) != 0x80) {
+        valid = false;
+        break;
+      }
+      code_point = (code_point << 6) | (bytes[i + k] & 0x3F);
+    }
+    if (!valid) {
+      ++i;
+      continue;
+    }
+    i += length;
+    if (code_points_.size() < kMaxCodePoints &&
+        code_points_.insert(code_point).second) {
+      usage_dirty_ = true;
+    }
+  }
+}
+
+size_t FontSubsetCache::recorded_count() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return code_points_.size();
+}
+
+fs::path FontSubsetCache::UsagePath() const {
+  return directory_ / kUsageFileName;
+}
+
+fs::path FontSubsetCache::ManifestPath() const {
+  fs::path path = directory_ / font_path_.stem();
+  path += kManifestSuffix;
+  return path;
+}
+
+void FontSubsetCache::LoadUsage() {
+  std::ifstream in(UsagePath(), std::ios::in | std::ios::binary);
+  UsageHeader header = {};
+  if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      header.magic != kUsageMagic || header.version != kVersion ||
+      header.count > kMaxCodePoints) {
+    return;
+  }
+  std::vector<uint32_t> values(header.count);
+  if (!in.read(reinterpret_cast<char*>(values.data()),
+               static_cast<std::streamsize>(values.size() * sizeof(uint32_t)))) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  code_points_.insert(values.begin(), values.end());
+}
+
+bool FontSubsetCache::SaveUsage() {
+  std::vector<uint8_t> bytes;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!usage_dirty_) {
+      return true;
+    }
+    UsageHeader header = {kUsageMagic, kVersion,
+                          static_cast<uint32_t>(code_points_.size()), 0};
+    bytes.resize(sizeof(header) + code_points_.size() * sizeof(uint32_t));
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    size_t offset = sizeof(header);
+    for (uint32_t code_point : code_points_) {
+      std::memcpy(bytes.data() + offset, &code_point, sizeof(code_point));
+      offset += sizeof(code_point);
+    }
+    usage_dirty_ = false;
+  }
+  std::error_code error;
+  fs::create_directories(directory_, error);
+  if (!WriteFileAtomically(UsagePath(), bytes.data(), bytes.size())) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    usage_dirty_ = true;
+    return false;
+  }
+  return true;
+}
+
+fs::path FontSubsetCache::Lookup() const {
+  std::ifstream in(ManifestPath(), std::ios::in | std::ios::binary);
+  Manifest manifest = {};
+  if (!in.read(reinterpret_cast<char*>(&manifest), sizeof(manifest)) ||
+      manifest.magic != kManifestMagic || manifest.version != kVersion) {
+    return fs::path();
+  }
+  std::error_code error;
+  const uint64_t font_size = fs::file_size(font_path_, error);
+  if (error || font_size != manifest.font_size ||
+      ModifiedTime(font_path_, &error) != manifest.font_modified_time ||
+      error) {
+    return fs::path();
+  }
+  fs::path path = directory_ / font_path_.stem();
+  path += "-" + Hex(manifest.font_hash) + "-" + Hex(manifest.set_hash) +
+          kSubsetSuffix;
+  return fs::is_regular_file(path, error) ? path : fs::path();
+}
+
+bool FontSubsetCache::Build(BuildResult* result) {
+  std::lock_guard<std::mutex> build_lock(build_mutex_);
+  const int64_t begin_us = NowMicros();
+  SaveUsage();
+
+  MappedFile font;
+  if (!font.Open(font_path_) || !font.data()) {
+    return false;
+  }
+  std::error_code error;
+  const int64_t modified_time = ModifiedTime(font_path_, &error);
+  if (error) {
+    return false;
+  }
+  const uint64_t font_hash = XxHash64(font.data(), font.size());
+
+  // 记录的码位加上基础区间，只保留字体里有的
+  std::set<uint32_t> wanted;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    wanted = code_points_;
+  }
+  for (const auto& range : kBaseRanges) {
+    for (uint32_t code_point = range[0]; code_point <= range[1];
+         ++code_point) {
+      wanted.insert(code_point);
+    }
+  }
+  std::vector<uint32_t> code_points;
+  for (uint32_t code_point : FontCodePoints(font.data(), font.size())) {
+    if (wanted.count(code_point)) {
+      code_points.push_back(code_point);
+    }
+  }
+  const uint64_t set_hash = XxHash64(
+      code_points.data(), code_points.size() * sizeof(uint32_t));
+
+  const std::string prefix = font_path_.stem().u8string() + "-";
+  const fs::path path = directory_ / fs::u8path(prefix + Hex(font_hash) +
+                                                "-" + Hex(set_hash) +
+                                                kSubsetSuffix);
+  fs::create_directories(directory_, error);
+  BuildResult build;
+  build.path = path;
+  build.font_bytes = font.size();
+  build.code_points = code_points.size();
+  build.reused = fs::is_regular_file(path, error);
+  if (build.reused) {
+    build.subset_bytes = fs::file_size(path, error);
+  } else {
+    std::vector<uint8_t> subset;
+    if (!SubsetTrueTypeFont(font.data(), font.size(), code_points, &subset) ||
+        !WriteFileAtomically(path, subset.data(), subset.size())) {
+      return false;
+    }
+    build.subset_bytes = subset.size();
+  }
+  font.Close();
+
+  const Manifest manifest = {kManifestMagic, kVersion, build.font_bytes,
+                             modified_time, font_hash, set_hash};
+  if (!WriteFileAtomically(ManifestPath(), &manifest, sizeof(manifest))) {
+    return false;
+  }
+
+  // 删除同一字体的旧子集
+  std::vector<fs::path> stale;
+  for (fs::directory_iterator it(directory_, error), end; !error && it != end;
+       it.increment(error)) {
+    const std::string name = it->path().filename().u8string();
+    if (it->path() != path && name.compare(0, prefix.size(), prefix) == 0 &&
+        it->path().extension() == kSubsetSuffix) {
+      stale.push_back(it->path());
+    }
+  }
+  for (const fs::path& stale_path : stale) {
+    fs::remove(stale_path, error);
+  }
+
+  build.elapsed_us = NowMicros() - begin_us;
+  *result = std::move(build);
+  return true;
+}
@@ -0,0 +1,64 @@
+#ifndef RUNNER_FONT_SUBSET_CACHE_H_
+#define RUNNER_FONT_SUBSET_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <set>
+#include <string_view>
+
+// 按实际用到的字符生成并缓存字体子集（与平台无关）。
+//
+// 记录 UI 文本和缓存内容里出现过的码位，跨次运行累积在 usage.bin 里。
+// Build 生成的子集文件名由字体的 XXH64 和码位集合（与字体 cmap 取交集，
+// 并总是包含 ASCII 和中文标点）的 XXH64 组成，同名文件已存在时直接复用。
+// 清单记录字体的大小、修改时间和当前子集，下次启动时 Lookup 不必读取
+// 字体就能判断子集是否可用。子集缺少的字符由完整字体作为后备显示。
+class FontSubsetCache {
+ public:
+  struct BuildResult {
+    std::filesystem::path path;
+    uint64_t font_bytes = 0;
+    uint64_t subset_bytes = 0;
+    size_t code_points = 0;  // 子集覆盖的码位数
+    bool reused = false;     // 码位集合没有变化，沿用已有文件
+    int64_t elapsed_us = 0;
+  };
+
+  // 子集、清单和 usage.bin 都放在 |directory| 下。
+  FontSubsetCache(std::filesystem::path directory,
+                  std::filesystem::path font_path);
+  // 写出尚未保存的码位。
+  ~FontSubsetCache();
+
+  FontSubsetCache(const FontSubsetCache&) = delete;
+  FontSubsetCache& operator=(const FontSubsetCache&) = delete;
+
+  // 记录 UTF-8 文本里的码位，无效序列跳过。线程安全。
+  void RecordUtf8(std::string_view text);
+  size_t recorded_count() const;
+
+  // 写出累积的码位。
+  bool SaveUsage();
+
+  // 当前字体对应的子集。没有子集或字体已经变化时返回空路径。
+  std::filesystem::path Lookup() const;
+
+  // 按当前记录的码位生成子集，耗时操作，应在后台线程调用。
+  bool Build(BuildResult* result);
+
+ private:
+  std::filesystem::path UsagePath() const;
+  std::filesystem::path ManifestPath() const;
+  void LoadUsage();
+
+  const std::filesystem::path directory_;
+  const std::filesystem::path font_path_;
+  mutable std::mutex mutex_;
+  std::set<uint32_t> code_points_;
+  bool usage_dirty_ = false;
+  std::mutex build_mutex_;  // 同时只生成一个子集
+};
+
+#endif  // RUNNER_FONT_SUBSET_CACHE_H_
@@ -0,0 +1,117 @@
+#include "font_subset_channel.h"
+
+#include <flutter/standard_method_codec.h>
+
+#include <filesystem>
+#include <string>
+#include <utility>
+
+#include "method_channel_utils.h"
+#include "utils.h"
+
+namespace {
+
+constexpr char kChannelName[] = "com.example.suxingchahui/font_subset";
+constexpr wchar_t kSubsetDirName[] = L"font_subsets";
+constexpr wchar_t kFontPath[] =
+    L"data\\flutter_assets\\assets\\fonts\\NotoSansSC-Regular.ttf";
+
+using flutter::EncodableMap;
+using flutter::EncodableValue;
+
+}  // namespace
+
+FontSubsetChannel::FontSubsetChannel(
+    flutter::BinaryMessenger* messenger,
+    std::shared_ptr<PlatformTaskRunner> task_runner)
+    : channel_(std::make_unique<flutter::MethodChannel<EncodableValue>>(
+          messenger, kChannelName,
+          &flutter::StandardMethodCodec::GetInstance())),
+      task_runner_(std::move(task_runner)) {
+  const std::wstring app_data_dir = GetAppDataDirectory();
+  const std::wstring exe_dir = GetExecutableDirectory();
+  if (!app_data_dir.empty() && !exe_dir.empty()) {
+    cache_ = std::make_shared<FontSubsetCache>(
+        std::filesystem::path(app_data_dir) / kSubsetDirName,
+        std::filesystem::path(exe_dir) / kFontPath);
+  }
+  channel_->SetMethodCallHandler(
+      [this](const auto& call, auto result) {
+        HandleMethodCall(call, std::move(result));
+      });
+}
+
+void FontSubsetChannel::HandleMethodCall(
+    const flutter::MethodCall<EncodableValue>& call,
+    std::unique_ptr<flutter::MethodResult<EncodableValue>> result) {
+  const std::string& method = call.method_name();
+
+  if (method == "lookup") {
+    const std::filesystem::path path =
+        cache_ ? cache_->Lookup() : std::filesystem::path();
+    if (path.empty()) {
+      result->Success();
+    } else {
+      result->Success(EncodableValue(Utf8FromUtf16(path.c_str())));
+    }
+    return;
+  }
+
+  if (method == "record") {
+    const auto text = GetStringArgument(call.arguments(), "text");
+    if (!text) {
+      result->Error("bad_args", "Missing text");
+      return;
+    }
+    if (cache_) {
+      cache_->RecordUtf8(*text);
+    }
+    result->Success();
+    return;
+  }
+
+  if (method == "build") {
+    HandleBuild(std::move(result));
+    return;
+  }
+
+  result->NotImplemented();
+}
+
+void FontSubsetChannel::HandleBuild(
+    std::unique_ptr<flutter::MethodResult<EncodableValue>> result) {
+  if (!cache_) {
+    result->Error("unavailable", "No application data directory");
+    return;
+  }
+  // 回复切回平台线程，窗口已销毁时任务被丢弃。
+  std::shared_ptr<flutter::MethodResult<EncodableValue>> shared_result =
+      std::move(result);
+  std::weak_ptr<PlatformTaskRunner> weak_runner = task_runner_;
+  workers_.Post([cache = cache_, weak_runner, shared_result]() {
+    FontSubsetCache::BuildResult build;
+    const bool ok = cache->Build(&build);
+    auto runner = weak_runner.lock();
+    if (!runner) {
+      return;
+    }
+    runner->PostTask([shared_result, ok, build = std::move(build)]() {
+      if (!ok) {
+        shared_result->Error("build_failed", "Failed to build font subset");
+        return;
+      }
+      shared_result->Success(EncodableValue(EncodableMap{
+          {EncodableValue("path"),
+           EncodableValue(Utf8FromUtf16(build.path.c_str()))},
+          {EncodableValue("fontBytes"),
+           EncodableValue(static_cast<int64_t>(build.font_bytes))},
+          {EncodableValue("subsetBytes"),
+           EncodableValue(static_cast<int64_t>(build.subset_bytes))},
+          {EncodableValue("codePoints"),
+           EncodableValue(static_cast<int64_t>(build.code_points))},
+          {EncodableValue("reused"), EncodableValue(build.reused)},
+          {EncodableValue("elapsedMicros"), EncodableValue(build.elapsed_us)},
+      }));
+    });
+  });
+}
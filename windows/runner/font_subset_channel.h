@@ -0,0 +1,46 @@
+#ifndef RUNNER_FONT_SUBSET_CHANNEL_H_
+#define RUNNER_FONT_SUBSET_CHANNEL_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+#include <flutter/method_channel.h>
+
+#include <memory>
+
+#include "font_subset_cache.h"
+#include "platform_task_runner.h"
+#include "thread_pool.h"
+
+// 内置 NotoSansSC 的子集缓存，见 font_subset_cache.h。
+//
+// 通道：com.example.suxingchahui/font_subset
+//   lookup           -> String | null  上次生成的子集文件，Dart 用
+//                                      FontLoader 注册
+//   record {text}    记录 UI 文本或缓存内容里出现的字符
+//   build            -> {path, fontBytes, subsetBytes, codePoints, reused,
+//                        elapsedMicros}
+//                    在后台按已记录的字符生成子集，供下次启动使用
+class FontSubsetChannel {
+ public:
+  FontSubsetChannel(flutter::BinaryMessenger* messenger,
+                    std::shared_ptr<PlatformTaskRunner> task_runner);
+
+  FontSubsetChannel(const FontSubsetChannel&) = delete;
+  FontSubsetChannel& operator=(const FontSubsetChannel&) = delete;
+
+ private:
+  void HandleMethodCall(
+      const flutter::MethodCall<flutter::EncodableValue>& call,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleBuild(
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> channel_;
+  std::shared_ptr<PlatformTaskRunner> task_runner_;
+  // 找不到应用数据目录时为 nullptr，此时 lookup 返回 null。
+  std::shared_ptr<FontSubsetCache> cache_;
+  ThreadPool workers_{1};
+};
+
+#endif  // RUNNER_FONT_SUBSET_CHANNEL_H_
@@ -0,0 +1,431 @@
+#include "game_column_store.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+namespace {
+
+// 筛选后的行数少于总行数的这个比例时，直接对这些行排序而不是扫描排列
+constexpr size_t kSparseFilterRatio = 8;
+
+// 一次变化不超过这么多行时逐行移动，否则整体归并
+constexpr size_t kMaxMovedRows = 16;
+
+// 把 double 映射为保持大小顺序的 int64
+int64_t OrderedBits(double value) {
+  int64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits < 0 ? bits ^ std::numeric_limits<int64_t>::max() : bits;
+}
+
+}  // namespace
+
+GameColumnStore::GameColumnStore() {
+  std::fill(std::begin(order_dirty_), std::end(order_dirty_), true);
+}
+
+void GameColumnStore::Upsert(const GameRecord* records, size_t count) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<uint32_t> changed_rows;
+  changed_rows.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    if (records[i].handle != 0) {
+      changed_rows.push_back(UpsertLocked(records[i]));
+    }
+  }
+  ReorderLocked(&changed_rows);
+}
+
+bool GameColumnStore::Remove(uint32_t handle) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = rows_by_handle_.find(handle);
+  if (it == rows_by_handle_.end()) {
+    return false;
+  }
+  std::vector<uint32_t> changed_rows = {it->second};
+  rows_by_handle_.erase(it);
+  RemoveRowLocked(changed_rows[0]);
+  ReorderLocked(&changed_rows);
+  return true;
+}
+
+void GameColumnStore::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  handles_.clear();
+  create_times_.clear();
+  update_times_.clear();
+  view_counts_.clear();
+  like_counts_.clear();
+  ratings_.clear();
+  categories_.clear();
+  row_tags_.clear();
+  free_rows_.clear();
+  live_rows_.Clear();
+  rows_by_handle_.clear();
+  label_ids_.clear();
+  category_rows_.clear();
+  tag_rows_.clear();
+  for (size_t key = 0; key < kGameSortKeyCount; ++key) {
+    orders_[key].clear();
+    ranks_[key].clear();
+    order_dirty_[key] = true;
+  }
+}
+
+uint32_t GameColumnStore::UpsertLocked(const GameRecord& record) {
+  uint32_t row;
+  auto it = rows_by_handle_.find(record.handle);
+  if (it != rows_by_handle_.end()) {
+    row = it->second;
+    // 先从旧的分类和标签位图中移除，再按新值加入
+    UnindexRowLocked(row);
+  } else if (!free_rows_.empty()) {
+    row = free_rows_.back();
+    free_rows_.pop_back();
+  } else {
+    row = static_cast<uint32_t>(handles_.size());
+    handles_.push_back(0);
+    create_times_.push_back(0);
+    update_times_.push_back(0);
+    view_counts_.push_back(0);
+    like_counts_.push_back(0);
+    ratings_.push_back(0.0);
+    categories_.push_back(kNoLabel);
+    row_tags_.emplace_back();
+  }
+  rows_by_handle_[record.handle] = row;
+  handles_[row] = record.handle;
+  create_times_[row] = record.create_time;
+  update_times_[row] = record.update_time;
+  view_counts_[row] = record.view_count;
+  like_counts_[row] = record.like_count;
+  ratings_[row] = std::isfinite(record.rating) ? record.rating : 0.0;
+  categories_[row] = kNoLabel;
+  if (!record.category.empty()) {
+    const uint32_t label = LabelIdLocked(record.category, true);
+    categories_[row] = label;
+    category_rows_[label].Add(row);
+  }
+  std::vector<uint32_t>& tags = row_tags_[row];
+  tags.clear();
+  for (std::string_view tag : record.tags) {
+    if (tag.empty()) {
+      continue;
+    }
+    const uint32_t label = LabelIdLocked(tag, true);
+    if (std::find(tags.begin(), tags.end(), label) == tags.end()) {
+      tags.push_back(label);
+      tag_rows_[label].Add(row);
+    }
+  }
+  live_rows_.Add(row);
+  return row;
+}
+
+void GameColumnStore::RemoveRowLocked(uint32_t row) {
+  UnindexRowLocked(row);
+  handles_[row] = 0;
+  free_rows_.push_back(row);
+}
+
+void GameColumnStore::UnindexRowLocked(uint32_t row) {
+  if (categories_[row] != kNoLabel) {
+    category_rows_[categories_[row]].Remove(row);
+    categories_[row] = kNoLabel;
+  }
+  for (uint32_t label : row_tags_[row]) {
+    tag_rows_[label].Remove(row);
+  }
+  row_tags_[row].clear();
+  live_rows_.Remove(row);
+}
+
+uint32_t GameColumnStore::LabelIdLocked(std::string_view label, bool create) {
+  auto it = label_ids_.find(std::string(label));
+  if (it != label_ids_.end()) {
+    return it->second;
+  }
+  if (!create) {
+    return kNoLabel;
+  }
+  const uint32_t id = static_cast<uint32_t>(category_rows_.size());
+  label_ids_.emplace(std::string(label), id);
+  category_rows_.emplace_back();
+  tag_rows_.emplace_back();
+  return id;
+}
+
+int64_t GameColumnStore::SortValueLocked(GameSortKey key, uint32_t row) const {
+  switch (key) {
+    case GameSortKey::kCreateTime:
+      return create_times_[row];
+    case GameSortKey::kUpdateTime:
+      return update_times_[row];
+    case GameSortKey::kViewCount:
+      return view_counts_[row];
+    case GameSortKey::kRating:
+      return OrderedBits(ratings_[row]);
+    case GameSortKey::kLikeCount:
+      return like_counts_[row];
+  }
+  return 0;
+}
+
+bool GameColumnStore::RowLessLocked(GameSortKey key,
+                                    uint32_t a,
+                                    uint32_t b) const {
+  const int64_t left = SortValueLocked(key, a);
+  const int64_t right = SortValueLocked(key, b);
+  if (left != right) {
+    return left < right;
+  }
+  return handles_[a] < handles_[b];
+}
+
+void GameColumnStore::SortRowsLocked(GameSortKey key,
+                                     std::vector<uint32_t>* rows) const {
+  // 先取出排序键，排序时不再按字段分支和随机访问各列
+  std::vector<std::pair<int64_t, uint64_t>> keyed;
+  keyed.reserve(rows->size());
+  for (uint32_t row : *rows) {
+    keyed.emplace_back(SortValueLocked(key, row),
+                       (static_cast<uint64_t>(handles_[row]) << 32) | row);
+  }
+  std::sort(keyed.begin(), keyed.end());
+  for (size_t i = 0; i < keyed.size(); ++i) {
+    (*rows)[i] = static_cast<uint32_t>(keyed[i].second);
+  }
+}
+
+void GameColumnStore::RebuildRanksLocked(size_t index) {
+  const std::vector<uint32_t>& order = orders_[index];
+  std::vector<uint32_t>& ranks = ranks_[index];
+  ranks.assign(handles_.size(), 0);
+  for (size_t rank = 0; rank < order.size(); ++rank) {
+    ranks[order[rank]] = static_cast<uint32_t>(rank);
+  }
+}
+
+void GameColumnStore::EnsureSortedLocked(GameSortKey key) {
+  const size_t index = static_cast<size_t>(key);
+  if (!order_dirty_[index]) {
+    return;
+  }
+  std::vector<uint32_t>& order = orders_[index];
+  order.clear();
+  live_rows_.AppendTo(&order);
+  SortRowsLocked(key, &order);
+  RebuildRanksLocked(index);
+  order_dirty_[index] = false;
+}
+
+void GameColumnStore::ReorderLocked(std::vector<uint32_t>* changed_rows) {
+  if (changed_rows->empty()) {
+    return;
+  }
+  std::sort(changed_rows->begin(), changed_rows->end());
+  changed_rows->erase(
+      std::unique(changed_rows->begin(), changed_rows->end()),
+      changed_rows->end());
+  if (changed_rows->size() <= kMaxMovedRows) {
+    for (size_t index = 0; index < kGameSortKeyCount; ++index) {
+      if (!order_dirty_[index]) {
+        for (uint32_t row : *changed_rows) {
+          MoveRowLocked(index, row);
+        }
+      }
+    }
+    return;
+  }
+  std::vector<bool> changed(handles_.size(), false);
+  for (uint32_t row : *changed_rows) {
+    changed[row] = true;
+  }
+  std::vector<uint32_t> inserted;
+  std::vector<uint32_t> merged;
+  for (size_t index = 0; index < kGameSortKeyCount; ++index) {
+    if (order_dirty_[index]) {
+      continue;
+    }
+    // 去掉变化的行，把仍然存活的变化行排序后归并回去，开销和总行数
+    // 成线性而不是重新排序
+    const GameSortKey key = static_cast<GameSortKey>(index);
+    inserted.clear();
+    for (uint32_t row : *changed_rows) {
+      if (handles_[row] != 0) {
+        inserted.push_back(row);
+      }
+    }
+    SortRowsLocked(key, &inserted);
+    std::vector<uint32_t>& order = orders_[index];
+    order.erase(std::remove_if(order.begin(), order.end(),
+                               [&changed](uint32_t row) {
+                                 return changed[row];
+                               }),
+                order.end());
+    merged.clear();
+    merged.reserve(order.size() + inserted.size());
+    std::merge(order.begin(), order.end(), inserted.begin(), inserted.end(),
+               std::back_inserter(merged), [this, key](uint32_t a, uint32_t b) {
+                 return RowLessLocked(key, a, b);
+               });
+    order.swap(merged);
+    RebuildRanksLocked(index);
+  }
+}
+
+void GameColumnStore::MoveRowLocked(size_t index, uint32_t row) {
+  const GameSortKey key = static_cast<GameSortKey>(index);
+  std::vector<uint32_t>& order = orders_[index];
+  std::vector<uint32_t>& ranks = ranks_[index];
+  if (ranks.size() < handles_.size()) {
+    ranks.resize(handles_.size(), 0);
+  }
+  // 行号会被复用，名次指向的必须是这一行才说明它在排列中
+  const size_t old_rank = ranks[row];
+  const bool was_ordered = old_rank < order.size() && order[old_rank] == row;
+  size_t first = order.size();
+  size_t last = order.size();
+  if (was_ordered) {
+    order.erase(order.begin() + static_cast<ptrdiff_t>(old_rank));
+    first = old_rank;
+  }
+  if (handles_[row] != 0) {
+    auto it = std::lower_bound(order.begin(), order.end(), row,
+                               [this, key](uint32_t a, uint32_t b) {
+                                 return RowLessLocked(key, a, b);
+                               });
+    const size_t new_rank = static_cast<size_t>(it - order.begin());
+    order.insert(it, row);
+    // 行在排列内移动时，只有新旧位置之间的名次改变
+    first = std::min(first, new_rank);
+    last = was_ordered ? std::max(old_rank, new_rank) + 1 : order.size();
+  } else {
+    last = order.size();
+  }
+  for (size_t rank = first; rank < last; ++rank) {
+    ranks[order[rank]] = static_cast<uint32_t>(rank);
+  }
+}
+
+size_t GameColumnStore::Query(const GameQuery& query,
+                              std::vector<uint32_t>* handles) {
+  handles->clear();
+  const size_t key_index = static_cast<size_t>(query.sort_key);
+  if (key_index >= kGameSortKeyCount) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // 筛选：分类和标签都给出时取交集
+  const RoaringBitmap* filter = nullptr;
+  RoaringBitmap intersection;
+  if (!query.category.empty() || !query.tag.empty()) {
+    const RoaringBitmap* category = nullptr;
+    const RoaringBitmap* tag = nullptr;
+    if (!query.category.empty()) {
+      const uint32_t label = LabelIdLocked(query.category, false);
+      if (label == kNoLabel) {
+        return 0;
+      }
+      category = &category_rows_[label];
+    }
+    if (!query.tag.empty()) {
+      const uint32_t label = LabelIdLocked(query.tag, false);
+      if (label == kNoLabel) {
+        return 0;
+      }
+      tag = &tag_rows_[label];
+    }
+    if (category && tag) {
+      intersection = RoaringBitmap::And(*category, *tag);
+      filter = &intersection;
+    } else {
+      filter = category ? category : tag;
+    }
+  }
+
+  const size_t live = rows_by_handle_.size();
+  const size_t total = filter ? static_cast<size_t>(filter->Cardinality())
+                              : live;
+  if (query.offset >= total || query.limit == 0) {
+    return total;
+  }
+  const size_t wanted = std::min(query.limit, total - query.offset);
+  handles->reserve(wanted);
+
+  EnsureSortedLocked(query.sort_key);
+  const std::vector<uint32_t>& order = orders_[key_index];
+  const std::vector<uint32_t>& ranks = ranks_[key_index];
+
+  if (!filter) {
+    // 没有筛选：名次就是位置
+    for (size_t i = query.offset; i < query.offset + wanted; ++i) {
+      const uint32_t row =
+          query.descending ? order[order.size() - 1 - i] : order[i];
+      handles->push_back(handles_[row]);
+    }
+    return total;
+  }
+
+  if (total * kSparseFilterRatio < live) {
+    // 筛选后的行少：按名次对这些行做部分排序
+    std::vector<uint32_t> rows;
+    filter->AppendTo(&rows);
+    const size_t end = query.offset + wanted;
+    auto by_rank = [&ranks, &query](uint32_t a, uint32_t b) {
+      return query.descending ? ranks[a] > ranks[b] : ranks[a] < ranks[b];
+    };
+    std::partial_sort(rows.begin(), rows.begin() + static_cast<ptrdiff_t>(end),
+                      rows.end(), by_rank);
+    for (size_t i = query.offset; i < end; ++i) {
+      handles->push_back(handles_[rows[i]]);
+    }
+    return total;
+  }
+
+  // 筛选后的行多：沿排列扫描，平均每 live/total 行命中一次
+  size_t skipped = 0;
+  for (size_t i = 0; i < order.size() && handles->size() < wanted; ++i) {
+    const uint32_t row =
+        query.descending ? order[order.size() - 1 - i] : order[i];
+    if (!filter->Contains(row)) {
+      continue;
+    }
+    if (skipped < query.offset) {
+      ++skipped;
+      continue;
+    }
+    handles->push_back(handles_[row]);
+  }
+  return total;
+}
+
+GameColumnStore::Stats GameColumnStore::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Stats stats;
+  stats.games = rows_by_handle_.size();
+  stats.labels = label_ids_.size();
+  uint64_t bytes = live_rows_.memory_bytes();
+  for (const RoaringBitmap& bitmap : category_rows_) {
+    bytes += bitmap.memory_bytes();
+  }
+  for (const RoaringBitmap& bitmap : tag_rows_) {
+    bytes += bitmap.memory_bytes();
+  }
+  for (size_t key = 0; key < kGameSortKeyCount; ++key) {
+    bytes += (orders_[key].capacity() + ranks_[key].capacity()) *
+             sizeof(uint32_t);
+  }
+  stats.index_bytes = bytes;
+  return stats;
+}
+
+GameColumnStore& GlobalGameColumnStore() {
+  static GameColumnStore* store = new GameColumnStore();
+  return *store;
+}
@@ -0,0 +1,126 @@
+#ifndef RUNNER_GAME_COLUMN_STORE_H_
+#define RUNNER_GAME_COLUMN_STORE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "roaring_bitmap.h"
+
+// 与 Game.defaultFilter 的排序选项对应，数值与 Dart 侧一致。
+enum class GameSortKey : int32_t {
+  kCreateTime = 0,
+  kUpdateTime = 1,
+  kViewCount = 2,
+  kRating = 3,
+  kLikeCount = 4,
+};
+
+constexpr size_t kGameSortKeyCount = 5;
+
+struct GameRecord {
+  uint32_t handle = 0;  // ObjectId 句柄
+  int64_t create_time = 0;  // 毫秒
+  int64_t update_time = 0;
+  int64_t view_count = 0;
+  int64_t like_count = 0;
+  double rating = 0.0;
+  std::string_view category;  // UTF-8，空表示没有分类
+  std::vector<std::string_view> tags;
+};
+
+struct GameQuery {
+  std::string_view category;  // 为空时不限
+  std::string_view tag;       // 为空时不限
+  GameSortKey sort_key = GameSortKey::kCreateTime;
+  bool descending = true;
+  size_t offset = 0;
+  size_t limit = 0;
+};
+
+// 本地已知游戏的列式存储（与平台无关），按分类、标签筛选后排序分页。
+//
+// 每个字段一列，行号在删除后复用。分类和标签的字符串只存一份，每个
+// 取值一个 Roaring 位图记录包含它的行。每个排序字段维护一个按该字段
+// 升序排好的行号排列（相同时按句柄）和行号到名次的反查表：第一次用到
+// 该字段时排序，之后的变化把变化的行归并进去。
+//
+// 查询先得到筛选后的位图：没有筛选时直接按名次取出一页；筛选后的行
+// 较少时按名次对这些行做部分排序；否则沿排列扫描并跳过不在位图中的
+// 行。可以在多个线程上调用。
+class GameColumnStore {
+ public:
+  struct Stats {
+    uint64_t games = 0;
+    uint64_t labels = 0;        // 不同的分类和标签数
+    uint64_t index_bytes = 0;   // 位图和排列占用的字节数
+  };
+
+  GameColumnStore();
+
+  GameColumnStore(const GameColumnStore&) = delete;
+  GameColumnStore& operator=(const GameColumnStore&) = delete;
+
+  // 添加或替换句柄相同的游戏。
+  void Upsert(const GameRecord* records, size_t count);
+
+  // 删除游戏，返回是否存在。
+  bool Remove(uint32_t handle);
+
+  void Clear();
+
+  // 返回符合条件的游戏总数，按排序后位于 [offset, offset + limit) 的
+  // 句柄写入 |handles|。
+  size_t Query(const GameQuery& query, std::vector<uint32_t>* handles);
+
+  Stats stats() const;
+
+ private:
+  static constexpr uint32_t kNoLabel = 0xFFFFFFFF;
+
+  // 以下方法要求持有 mutex_。
+  uint32_t UpsertLocked(const GameRecord& record);  // 返回行号
+  void RemoveRowLocked(uint32_t row);
+  void UnindexRowLocked(uint32_t row);  // 只从位图中移除，保留行
+  uint32_t LabelIdLocked(std::string_view label, bool create);
+  int64_t SortValueLocked(GameSortKey key, uint32_t row) const;
+  bool RowLessLocked(GameSortKey key, uint32_t a, uint32_t b) const;
+  // 按 (排序键, 句柄) 升序排列 |rows|。
+  void SortRowsLocked(GameSortKey key, std::vector<uint32_t>* rows) const;
+  void RebuildRanksLocked(size_t index);
+  void EnsureSortedLocked(GameSortKey key);
+  // 行变化后更新已经排好的排列，没有排好的留到用到时再排序。
+  void ReorderLocked(std::vector<uint32_t>* changed_rows);
+  void MoveRowLocked(size_t index, uint32_t row);
+
+  mutable std::mutex mutex_;
+  // 列，下标为行号
+  std::vector<uint32_t> handles_;
+  std::vector<int64_t> create_times_;
+  std::vector<int64_t> update_times_;
+  std::vector<int64_t> view_counts_;
+  std::vector<int64_t> like_counts_;
+  std::vector<double> ratings_;
+  std::vector<uint32_t> categories_;              // 标签 ID，kNoLabel 为没有
+  std::vector<std::vector<uint32_t>> row_tags_;   // 每行的标签 ID
+  std::vector<uint32_t> free_rows_;
+  RoaringBitmap live_rows_;
+  std::unordered_map<uint32_t, uint32_t> rows_by_handle_;
+  // 分类和标签共用一个字符串表，位图分开
+  std::unordered_map<std::string, uint32_t> label_ids_;
+  std::vector<RoaringBitmap> category_rows_;  // 下标为标签 ID
+  std::vector<RoaringBitmap> tag_rows_;       // 下标为标签 ID
+  // 每个排序字段的升序行号排列、行号到名次的反查表和是否需要重建
+  std::vector<uint32_t> orders_[kGameSortKeyCount];
+  std::vector<uint32_t> ranks_[kGameSortKeyCount];
+  bool order_dirty_[kGameSortKeyCount];
+};
+
+// 进程内共享的存储。
+GameColumnStore& GlobalGameColumnStore();
+
+#endif  // RUNNER_GAME_COLUMN_STORE_H_
@@ -0,0 +1,89 @@
+#include "game_column_store_ffi.h"
+
+#include <string_view>
+#include <vector>
+
+#include "game_column_store.h"
+
+namespace {
+
+std::string_view AsView(const uint8_t* data, int64_t length) {
+  if (!data || length <= 0) {
+    return std::string_view();
+  }
+  return std::string_view(reinterpret_cast<const char*>(data),
+                          static_cast<size_t>(length));
+}
+
+}  // namespace
+
+void runner_games_upsert(const RunnerGameRecord* records, int32_t count) {
+  if (!records || count <= 0) {
+    return;
+  }
+  std::vector<GameRecord> converted(static_cast<size_t>(count));
+  for (size_t i = 0; i < converted.size(); ++i) {
+    const RunnerGameRecord& source = records[i];
+    GameRecord& record = converted[i];
+    record.handle = source.handle;
+    record.create_time = source.create_time;
+    record.update_time = source.update_time;
+    record.view_count = source.view_count;
+    record.like_count = source.like_count;
+    record.rating = source.rating;
+    record.category = AsView(source.category, source.category_length);
+    std::string_view tags = AsView(source.tags, source.tags_length);
+    while (!tags.empty()) {
+      const size_t end = tags.find('\0');
+      record.tags.push_back(tags.substr(0, end));
+      if (end == std::string_view::npos) {
+        break;
+      }
+      tags.remove_prefix(end + 1);
+    }
+  }
+  GlobalGameColumnStore().Upsert(converted.data(), converted.size());
+}
+
+int32_t runner_games_remove(uint32_t handle) {
+  return GlobalGameColumnStore().Remove(handle) ? 1 : 0;
+}
+
+void runner_games_clear() {
+  GlobalGameColumnStore().Clear();
+}
+
+int32_t runner_games_query(const RunnerGameQuery* query,
+                           uint32_t* handles,
+                           int32_t capacity,
+                           int64_t* total) {
+  if (!query || !handles || capacity < 0 || query->offset < 0) {
+    return 0;
+  }
+  GameQuery converted;
+  converted.category = AsView(query->category, query->category_length);
+  converted.tag = AsView(query->tag, query->tag_length);
+  converted.sort_key = static_cast<GameSortKey>(query->sort_key);
+  converted.descending = query->descending != 0;
+  converted.offset = static_cast<size_t>(query->offset);
+  converted.limit = static_cast<size_t>(capacity);
+  std::vector<uint32_t> results;
+  const size_t matched = GlobalGameColumnStore().Query(converted, &results);
+  for (size_t i = 0; i < results.size(); ++i) {
+    handles[i] = results[i];
+  }
+  if (total) {
+    *total = static_cast<int64_t>(matched);
+  }
+  return static_cast<int32_t>(results.size());
+}
+
+void runner_games_stats(RunnerGameStats* stats) {
+  if (!stats) {
+    return;
+  }
+  const GameColumnStore::Stats current = GlobalGameColumnStore().stats();
+  stats->games = static_cast<int64_t>(current.games);
+  stats->labels = static_cast<int64_t>(current.labels);
+  stats->index_bytes = static_cast<int64_t>(current.index_bytes);
+}
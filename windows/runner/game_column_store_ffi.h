@@ -0,0 +1,58 @@
+#ifndef RUNNER_GAME_COLUMN_STORE_FFI_H_
+#define RUNNER_GAME_COLUMN_STORE_FFI_H_
+
+#include <cstdint>
+
+#include "ffi_export.h"
+
+// GlobalGameColumnStore 的 C 接口，供 lib/windows/native/native_game_store.dart
+// 使用。结构体布局必须和 Dart 侧的 Struct 定义一致。游戏以
+// runner_oid_intern 返回的句柄标识，字符串均为 UTF-8，不要求以 '\0' 结尾。
+
+struct RunnerGameRecord {
+  uint32_t handle;
+  int32_t reserved;
+  int64_t create_time;  // 毫秒
+  int64_t update_time;
+  int64_t view_count;
+  int64_t like_count;
+  double rating;
+  const uint8_t* category;
+  int64_t category_length;
+  const uint8_t* tags;  // 以 '\0' 分隔的标签
+  int64_t tags_length;
+};
+
+struct RunnerGameQuery {
+  const uint8_t* category;  // 为空时不限
+  int64_t category_length;
+  const uint8_t* tag;  // 为空时不限
+  int64_t tag_length;
+  int32_t sort_key;  // GameSortKey
+  int32_t descending;
+  int64_t offset;
+};
+
+struct RunnerGameStats {
+  int64_t games;
+  int64_t labels;
+  int64_t index_bytes;
+};
+
+RUNNER_FFI_EXPORT void runner_games_upsert(const RunnerGameRecord* records,
+                                           int32_t count);
+
+RUNNER_FFI_EXPORT int32_t runner_games_remove(uint32_t handle);
+
+RUNNER_FFI_EXPORT void runner_games_clear();
+
+// 向 |handles| 写入最多 |capacity| 个句柄，返回写入的个数。符合条件的
+// 总数写入 |total|。
+RUNNER_FFI_EXPORT int32_t runner_games_query(const RunnerGameQuery* query,
+                                             uint32_t* handles,
+                                             int32_t capacity,
+                                             int64_t* total);
+
+RUNNER_FFI_EXPORT void runner_games_stats(RunnerGameStats* stats);
+
+#endif  // RUNNER_GAME_COLUMN_STORE_FFI_H_
@@ -0,0 +1,195 @@
+#include "hang_watchdog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <utility>
+
+namespace {
+
+int64_t NowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+int64_t NowUnixMillis() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+void AppendJsonString(const std::string& value, std::string* out) {
+  out->push_back('"');
+  for (const char c : value) {
+    if (c == '"' || c == '\\') {
+      out->push_back('\\');
+      out->push_back(c);
+    } else if (static_cast<unsigned char>(c) >= 0x20) {
+      out->push_back(c);
+    }
+  }
+  out->push_back('"');
+}
+
+}  // namespace
+
+std::string FormatHangStall(const HangStall& stall) {
+  char numbers[128];
+  std::snprintf(numbers, sizeof(numbers),
+                "{\"time\":%lld,\"duration_ms\":%lld,\"message\":\"0x%04x\","
+                "\"span\":",
+                static_cast<long long>(stall.begin_unix_ms),
+                static_cast<long long>(stall.duration_ms), stall.message);
+  std::string line = numbers;
+  AppendJsonString(stall.span, &line);
+  line += stall.ongoing ? ",\"ongoing\":true}" : ",\"ongoing\":false}";
+  return line;
+}
+
+void HangDetector::Busy(uint32_t message, int64_t now_us) {
+  message_.store(message, std::memory_order_relaxed);
+  busy_since_us_.store(now_us, std::memory_order_relaxed);
+}
+
+void HangDetector::Idle() {
+  busy_since_us_.store(kIdle, std::memory_order_relaxed);
+}
+
+void HangDetector::Pong(int64_t now_us) {
+  pong_us_.store(now_us, std::memory_order_relaxed);
+  // release：监视线程看到新的序号时也能看到响应时刻
+  answered_.store(sent_.load(std::memory_order_acquire),
+                  std::memory_order_release);
+}
+
+HangDetector::Action HangDetector::Poll(int64_t now_us, int64_t threshold_us) {
+  Action action;
+  const uint64_t sent = sent_.load(std::memory_order_relaxed);
+  const bool outstanding =
+      answered_.load(std::memory_order_acquire) < sent;
+
+  if (stalled_) {
+    if (!outstanding) {
+      stalled_ = false;
+      action.event = Event::kEnd;
+      action.begin_us = stall_begin_us_;
+      action.duration_us = std::max<int64_t>(
+          pong_us_.load(std::memory_order_relaxed) - stall_begin_us_, 0);
+      action.message = stall_message_;
+    }
+    return action;
+  }
+
+  if (outstanding) {
+    if (now_us - candidate_begin_us_ >= threshold_us) {
+      stalled_ = true;
+      stall_begin_us_ = candidate_begin_us_;
+      stall_message_ = message_.load(std::memory_order_relaxed);
+      action.event = Event::kBegin;
+      action.begin_us = stall_begin_us_;
+      action.duration_us = now_us - stall_begin_us_;
+      action.message = stall_message_;
+    }
+    return action;
+  }
+
+  const int64_t busy_since = busy_since_us_.load(std::memory_order_relaxed);
+  if (busy_since == kIdle) {
+    return action;
+  }
+  // 模态循环里平台线程一直忙碌，但会响应心跳，从最近一次响应算起
+  const int64_t since =
+      std::max(busy_since, pong_us_.load(std::memory_order_relaxed));
+  if (now_us - since >= threshold_us / 4) {
+    candidate_begin_us_ = since;
+    sent_.store(sent + 1, std::memory_order_release);
+    action.ping = true;
+  }
+  return action;
+}
+
+HangWatchdog& HangWatchdog::GetInstance() {
+  static HangWatchdog instance;
+  return instance;
+}
+
+HangWatchdog::~HangWatchdog() {
+  Stop();
+}
+
+bool HangWatchdog::Start(int64_t threshold_ms,
+                         PingFunction ping,
+                         SpanFunction span,
+                         ReportFunction report) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (thread_.joinable()) {
+    return false;
+  }
+  threshold_us_ = std::max<int64_t>(threshold_ms, 1) * 1000;
+  ping_ = std::move(ping);
+  span_ = std::move(span);
+  report_ = std::move(report);
+  stopping_ = false;
+  thread_ = std::thread([this]() { Run(); });
+  return true;
+}
+
+void HangWatchdog::Stop() {
+  std::thread thread;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+    thread = std::move(thread_);
+  }
+  wake_.notify_one();
+  if (thread.joinable()) {
+    thread.join();
+  }
+}
+
+void HangWatchdog::Busy(uint32_t message) {
+  detector_.Busy(message, NowMicros());
+}
+
+void HangWatchdog::Idle() {
+  detector_.Idle();
+}
+
+void HangWatchdog::Pong() {
+  detector_.Pong(NowMicros());
+}
+
+void HangWatchdog::Run() {
+  // 阈值的八分之一检查一次，判定误差不超过阈值的八分之一
+  const auto interval = std::chrono::microseconds(
+      std::max<int64_t>(threshold_us_ / 8, 10000));
+  const int64_t unix_offset_ms = NowUnixMillis() - NowMicros() / 1000;
+  std::string stall_span;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!wake_.wait_for(lock, interval, [this]() { return stopping_; })) {
+    lock.unlock();
+    const HangDetector::Action action =
+        detector_.Poll(NowMicros(), threshold_us_);
+    if (action.ping && ping_) {
+      ping_();
+    }
+    if (action.event != HangDetector::Event::kNone) {
+      if (action.event == HangDetector::Event::kBegin) {
+        // 卡住时读取，恢复后平台线程可能已经进入别的阶段
+        stall_span = span_ ? span_() : std::string();
+      }
+      HangStall stall;
+      stall.begin_unix_ms = unix_offset_ms + action.begin_us / 1000;
+      stall.duration_ms = action.duration_us / 1000;
+      stall.message = action.message;
+      stall.span = stall_span;
+      stall.ongoing = action.event == HangDetector::Event::kBegin;
+      if (report_) {
+        report_(stall);
+      }
+    }
+    lock.lock();
+  }
+}
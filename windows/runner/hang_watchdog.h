@@ -0,0 +1,123 @@
+#ifndef RUNNER_HANG_WATCHDOG_H_
+#define RUNNER_HANG_WATCHDOG_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// 一次卡顿。检测到时报告一次（ongoing 为 true，duration 为已持续的
+// 时间），恢复响应后再报告一次最终时长。
+struct HangStall {
+  int64_t begin_unix_ms = 0;
+  int64_t duration_ms = 0;
+  uint32_t message = 0;  // 卡住时正在分发的消息，0 表示不在消息循环里
+  std::string span;      // 卡住时被监视线程上尚未结束的最内层时间段
+  bool ongoing = false;
+};
+
+// 一行 JSON，不含换行。
+std::string FormatHangStall(const HangStall& stall);
+
+// 平台线程卡顿检测的状态机（与平台无关，时间由调用方传入，单位微秒）。
+//
+// 平台线程在 GetMessage 之外（分发消息或启动阶段）标记为忙碌。忙碌超过
+// 阈值的四分之一后，监视线程发出一次心跳，要求平台线程调用 Pong；心跳
+// 超过阈值仍未响应即判定为卡顿，响应后结束。MessageBox 之类的模态循环
+// 会继续分发心跳，不算卡顿。Busy、Idle 和 Pong 只在平台线程调用，
+// Poll 只在监视线程调用。
+class HangDetector {
+ public:
+  enum class Event {
+    kNone,
+    kBegin,  // 开始卡顿
+    kEnd,    // 恢复响应
+  };
+
+  struct Action {
+    bool ping = false;  // 现在发出心跳
+    Event event = Event::kNone;
+    int64_t begin_us = 0;
+    int64_t duration_us = 0;
+    uint32_t message = 0;
+  };
+
+  HangDetector() = default;
+
+  HangDetector(const HangDetector&) = delete;
+  HangDetector& operator=(const HangDetector&) = delete;
+
+  void Busy(uint32_t message, int64_t now_us);
+  void Idle();
+  void Pong(int64_t now_us);
+
+  Action Poll(int64_t now_us, int64_t threshold_us);
+
+ private:
+  static constexpr int64_t kIdle = -1;
+
+  // 平台线程写入
+  std::atomic<int64_t> busy_since_us_{kIdle};
+  std::atomic<uint32_t> message_{0};
+  std::atomic<int64_t> pong_us_{0};
+  std::atomic<uint64_t> answered_{0};  // 已响应的心跳序号
+  // 监视线程写入
+  std::atomic<uint64_t> sent_{0};  // 已发出的心跳序号
+  int64_t candidate_begin_us_ = 0;  // 最近一次响应或开始忙碌的时刻
+  bool stalled_ = false;
+  int64_t stall_begin_us_ = 0;
+  uint32_t stall_message_ = 0;
+};
+
+// 在后台线程上运行 HangDetector。
+//
+// 心跳怎样送到平台线程、时间段名称从哪里来、记录写到哪里都由调用方
+// 提供，见 platform_hang_watchdog.h。
+class HangWatchdog {
+ public:
+  // 让平台线程尽快调用 Pong，在监视线程上调用。
+  using PingFunction = std::function<void()>;
+  // 被监视线程上尚未结束的最内层时间段，在监视线程上调用。
+  using SpanFunction = std::function<std::string()>;
+  // 在监视线程上调用。
+  using ReportFunction = std::function<void(const HangStall& stall)>;
+
+  static HangWatchdog& GetInstance();
+
+  HangWatchdog() = default;
+  ~HangWatchdog();
+
+  HangWatchdog(const HangWatchdog&) = delete;
+  HangWatchdog& operator=(const HangWatchdog&) = delete;
+
+  // 已经启动时返回 false。
+  bool Start(int64_t threshold_ms,
+             PingFunction ping,
+             SpanFunction span,
+             ReportFunction report);
+  void Stop();
+
+  // 以下在平台线程调用，未启动时也可以调用，开销为几次原子写入。
+  void Busy(uint32_t message);
+  void Idle();
+  void Pong();
+
+ private:
+  void Run();
+
+  HangDetector detector_;
+  int64_t threshold_us_ = 0;
+  PingFunction ping_;
+  SpanFunction span_;
+  ReportFunction report_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  bool stopping_ = false;
+  std::thread thread_;
+};
+
+#endif  // RUNNER_HANG_WATCHDOG_H_
@@ -0,0 +1,193 @@
+#include "http_channel.h"
+
+#include <flutter/standard_method_codec.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "method_channel_utils.h"
+#include "native_http_client.h"
+
+namespace {
+
+constexpr char kChannelName[] = "com.example.suxingchahui/http";
+
+using flutter::EncodableList;
+using flutter::EncodableMap;
+using flutter::EncodableValue;
+
+std::vector<std::string> GetStringListArgument(const EncodableValue* arguments,
+                                               const char* key) {
+  std::vector<std::string> strings;
+  const auto* value = FindArgument(arguments, key);
+  const auto* list = value ? std::get_if<EncodableList>(value) : nullptr;
+  if (!list) {
+    return strings;
+  }
+  for (const auto& item : *list) {
+    if (const auto* string_value = std::get_if<std::string>(&item)) {
+      strings.push_back(*string_value);
+    }
+  }
+  return strings;
+}
+
+std::vector<HttpOrigin> ParseOrigins(const std::vector<std::string>& urls) {
+  std::vector<HttpOrigin> origins;
+  for (const auto& url : urls) {
+    HttpOrigin origin;
+    if (ParseHttpUrl(url, &origin, nullptr) &&
+        std::find(origins.begin(), origins.end(), origin) == origins.end()) {
+      origins.push_back(std::move(origin));
+    }
+  }
+  return origins;
+}
+
+std::string ToLower(std::string value) {
+  std::transform(value.begin(), value.end(), value.begin(), [](char c) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  });
+  return value;
+}
+
+EncodableValue EncodeResponse(HttpResponse response) {
+  // 同名的头（Set-Cookie 等）合并成列表
+  EncodableMap headers;
+  for (auto& header : response.headers) {
+    EncodableValue& values = headers[EncodableValue(ToLower(header.first))];
+    if (values.IsNull()) {
+      values = EncodableValue(EncodableList());
+    }
+    std::get<EncodableList>(values).emplace_back(std::move(header.second));
+  }
+  return EncodableValue(EncodableMap{
+      {EncodableValue("statusCode"), EncodableValue(response.status_code)},
+      {EncodableValue("headers"), EncodableValue(std::move(headers))},
+      {EncodableValue("body"),
+       EncodableValue(std::vector<uint8_t>(response.body.begin(),
+                                           response.body.end()))},
+  });
+}
+
+EncodableValue EncodeStats(const HttpConnectionPool::Stats& stats) {
+  return EncodableValue(EncodableMap{
+      {EncodableValue("opened"),
+       EncodableValue(static_cast<int64_t>(stats.connections_opened))},
+      {EncodableValue("reused"),
+       EncodableValue(static_cast<int64_t>(stats.connections_reused))},
+      {EncodableValue("evicted"),
+       EncodableValue(static_cast<int64_t>(stats.connections_evicted))},
+      {EncodableValue("failed"),
+       EncodableValue(static_cast<int64_t>(stats.requests_failed))},
+  });
+}
+
+}  // namespace
+
+HttpChannel::HttpChannel(flutter::BinaryMessenger* messenger,
+                         std::shared_ptr<PlatformTaskRunner> task_runner)
+    : channel_(std::make_unique<flutter::MethodChannel<EncodableValue>>(
+          messenger, kChannelName,
+          &flutter::StandardMethodCodec::GetInstance())),
+      task_runner_(std::move(task_runner)) {
+  channel_->SetMethodCallHandler(
+      [this](const auto& call, auto result) {
+        HandleMethodCall(call, std::move(result));
+      });
+}
+
+void HttpChannel::HandleMethodCall(
+    const flutter::MethodCall<EncodableValue>& call,
+    std::unique_ptr<flutter::MethodResult<EncodableValue>> result) {
+  NativeHttpClient& client = NativeHttpClient::GetInstance();
+  const std::string& method = call.method_name();
+
+  if (method == "request") {
+    HandleRequest(call.arguments(), std::move(result));
+    return;
+  }
+
+  if (method == "configurePrewarm") {
+    const bool saved = client.SavePrewarmOrigins(
+        GetStringListArgument(call.arguments(), "origins"));
+    result->Success(EncodableValue(saved));
+    return;
+  }
+
+  if (method == "prewarm") {
+    client.PrewarmAsync(
+        ParseOrigins(GetStringListArgument(call.arguments(), "origins")));
+    result->Success();
+    return;
+  }
+
+  if (method == "stats") {
+    result->Success(EncodeStats(client.stats()));
+    return;
+  }
+
+  result->NotImplemented();
+}
+
+void HttpChannel::HandleRequest(
+    const EncodableValue* arguments,
+    std::unique_ptr<flutter::MethodResult<EncodableValue>> result) {
+  const auto url = GetStringArgument(arguments, "url");
+  if (!url) {
+    result->Error("bad_args", "Missing url");
+    return;
+  }
+
+  HttpRequest request;
+  request.method = GetStringArgument(arguments, "method").value_or("GET");
+  if (const auto timeout = GetIntArgument(arguments, "timeoutMillis")) {
+    request.timeout = std::chrono::milliseconds(*timeout);
+  }
+  if (const auto* value = FindArgument(arguments, "headers")) {
+    if (const auto* headers = std::get_if<EncodableMap>(value)) {
+      for (const auto& [name, header_value] : *headers) {
+        const auto* name_string = std::get_if<std::string>(&name);
+        const auto* value_string = std::get_if<std::string>(&header_value);
+        if (name_string && value_string) {
+          request.headers.emplace_back(*name_string, *value_string);
+        }
+      }
+    }
+  }
+  if (const auto* value = FindArgument(arguments, "body")) {
+    if (const auto* body = std::get_if<std::vector<uint8_t>>(value)) {
+      request.body.assign(body->begin(), body->end());
+    } else if (const auto* text = std::get_if<std::string>(value)) {
+      request.body = *text;
+    }
+  }
+
+  // 回调在工作线程上执行，回复必须切回平台线程。窗口已销毁时任务被丢弃，
+  // MethodResult 随 lambda 一起析构。
+  std::shared_ptr<flutter::MethodResult<EncodableValue>> shared_result =
+      std::move(result);
+  std::weak_ptr<PlatformTaskRunner> weak_runner = task_runner_;
+  NativeHttpClient::GetInstance().ExecuteAsync(
+      *url, std::move(request),
+      [shared_result, weak_runner](bool ok, HttpResponse response,
+                                   std::string error) {
+        auto runner = weak_runner.lock();
+        if (!runner) {
+          return;
+        }
+        runner->PostTask([shared_result, ok,
+                          response = std::move(response),
+                          error = std::move(error)]() mutable {
+          if (ok) {
+            shared_result->Success(EncodeResponse(std::move(response)));
+          } else {
+            shared_result->Error("network_error", error);
+          }
+        });
+      });
+}
@@ -0,0 +1,42 @@
+#ifndef RUNNER_HTTP_CHANNEL_H_
+#define RUNNER_HTTP_CHANNEL_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+#include <flutter/method_channel.h>
+
+#include <memory>
+
+#include "platform_task_runner.h"
+
+// 让 Dart 通过 NativeHttpClient 的连接池发请求。
+//
+// 通道：com.example.suxingchahui/http
+//   configurePrewarm {origins}   保存下次启动时要预热的 origin
+//   prewarm {origins}            立即在后台预热
+//   request {method, url, headers, body, timeoutMillis}
+//       -> {statusCode, headers: Map<String, List<String>>, body: Uint8List}
+//       响应头名称统一为小写
+//   stats -> {opened, reused, evicted, failed}
+class HttpChannel {
+ public:
+  HttpChannel(flutter::BinaryMessenger* messenger,
+              std::shared_ptr<PlatformTaskRunner> task_runner);
+
+  HttpChannel(const HttpChannel&) = delete;
+  HttpChannel& operator=(const HttpChannel&) = delete;
+
+ private:
+  void HandleMethodCall(
+      const flutter::MethodCall<flutter::EncodableValue>& call,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleRequest(
+      const flutter::EncodableValue* arguments,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> channel_;
+  std::shared_ptr<PlatformTaskRunner> task_runner_;
+};
+
+#endif  // RUNNER_HTTP_CHANNEL_H_
@@ -0,0 +1,322 @@
+#include "http_connection_pool.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iterator>
+#include <tuple>
+
+namespace {
+
+constexpr uint16_t kDefaultHttpPort = 80;
+constexpr uint16_t kDefaultHttpsPort = 443;
+
+std::string ToLowerAscii(std::string value) {
+  std::transform(value.begin(), value.end(), value.begin(), [](char c) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  });
+  return value;
+}
+
+// 复用的连接可能已被服务器关闭，只有幂等请求可以安全地重发
+bool IsIdempotent(const std::string& method) {
+  return method == "GET" || method == "HEAD" || method == "PUT" ||
+         method == "DELETE" || method == "OPTIONS";
+}
+
+}  // namespace
+
+std::string HttpOrigin::ToString() const {
+  std::string result = secure ? "https://" : "http://";
+  result += host;
+  if (port != (secure ? kDefaultHttpsPort : kDefaultHttpPort)) {
+    result += ":" + std::to_string(port);
+  }
+  return result;
+}
+
+bool HttpOrigin::operator<(const HttpOrigin& other) const {
+  return std::tie(secure, host, port) <
+         std::tie(other.secure, other.host, other.port);
+}
+
+bool HttpOrigin::operator==(const HttpOrigin& other) const {
+  return secure == other.secure && host == other.host && port == other.port;
+}
+
+bool ParseHttpUrl(const std::string& url,
+                  HttpOrigin* origin,
+                  std::string* path) {
+  const size_t scheme_end = url.find("://");
+  if (scheme_end == std::string::npos) {
+    return false;
+  }
+  const std::string scheme = ToLowerAscii(url.substr(0, scheme_end));
+  HttpOrigin result;
+  if (scheme == "https") {
+    result.secure = true;
+    result.port = kDefaultHttpsPort;
+  } else if (scheme == "http") {
+    result.secure = false;
+    result.port = kDefaultHttpPort;
+  } else {
+    return false;
+  }
+
+  const size_t authority_begin = scheme_end + 3;
+  size_t authority_end = url.find_first_of("/?#", authority_begin);
+  if (authority_end == std::string::npos) {
+    authority_end = url.size();
+  }
+  std::string authority =
+      url.substr(authority_begin, authority_end - authority_begin);
+  // 不支持 URL 中的用户信息
+  if (authority.empty() || authority.find('@') != std::string::npos) {
+    return false;
+  }
+
+  // IPv6 字面量写作 [::1]:8080
+  size_t port_separator = std::string::npos;
+  if (authority[0] == '[') {
+    const size_t bracket = authority.find(']');
+    if (bracket == std::string::npos) {
+      return false;
+    }
+    if (bracket + 1 < authority.size()) {
+      if (authority[bracket + 1] != ':') {
+        return false;
+      }
+      port_separator = bracket + 1;
+    }
+  } else {
+    port_separator = authority.rfind(':');
+  }
+  if (port_separator != std::string::npos) {
+    const std::string port = authority.substr(port_separator + 1);
+    if (port.empty() || port.size() > 5 ||
+        !std::all_of(port.begin(), port.end(),
+                     [](char c) { return c >= '0' && c <= '9'; })) {
+      return false;
+    }
+    const unsigned long value = std::strtoul(port.c_str(), nullptr, 10);
+    if (value == 0 || value > 65535) {
+      return false;
+    }
+    result.port = static_cast<uint16_t>(value);
+    authority.resize(port_separator);
+  }
+  if (authority.empty()) {
+    return false;
+  }
+  result.host = ToLowerAscii(authority);
+
+  // 片段不发给服务器
+  std::string rest = url.substr(authority_end);
+  const size_t fragment = rest.find('#');
+  if (fragment != std::string::npos) {
+    rest.resize(fragment);
+  }
+  if (rest.empty() || rest[0] != '/') {
+    rest.insert(0, "/");
+  }
+
+  *origin = std::move(result);
+  if (path) {
+    *path = std::move(rest);
+  }
+  return true;
+}
+
+HttpConnectionPool::HttpConnectionPool(
+    std::unique_ptr<HttpConnectionFactory> factory,
+    const Options& options)
+    : factory_(std::move(factory)), options_(options) {}
+
+HttpConnectionPool::~HttpConnectionPool() = default;
+
+bool HttpConnectionPool::Execute(const HttpOrigin& origin,
+                                 const HttpRequest& request,
+                                 HttpResponse* response,
+                                 std::string* error) {
+  for (int attempt = 0;; ++attempt) {
+    std::unique_ptr<HttpConnection> connection;
+    bool reused = false;
+    if (!Acquire(origin, &connection, &reused)) {
+      *error = "Timed out waiting for a connection to " + origin.ToString();
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++stats_.requests_failed;
+      return false;
+    }
+    if (!connection) {
+      connection = factory_->Create(origin);
+      if (!connection) {
+        Release(origin, nullptr);
+        *error = "Unable to create a connection to " + origin.ToString();
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.requests_failed;
+        return false;
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++stats_.connections_opened;
+    }
+
+    *response = HttpResponse();
+    const bool sent = connection->Send(request, response, error);
+    // 响应体已经交给 body_sink 的请求不能重发
+    const bool retry = !sent && reused && attempt == 0 &&
+                       IsIdempotent(request.method) &&
+                       (!request.body_sink || response->status_code == 0);
+    Release(origin, sent && connection->reusable() ? std::move(connection)
+                                                   : nullptr);
+    if (sent) {
+      return true;
+    }
+    if (!retry) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++stats_.requests_failed;
+      return false;
+    }
+  }
+}
+
+size_t HttpConnectionPool::Prewarm(const HttpOrigin& origin, size_t count) {
+  // 先占住名额再在锁外建立连接，避免与同时到来的请求一起超过上限
+  size_t slots = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& state = hosts_[origin];
+    if (!state) {
+      state = std::make_unique<HostState>();
+    }
+    const size_t used = state->active + state->idle.size();
+    if (used < options_.max_connections_per_host) {
+      slots = std::min(count, options_.max_connections_per_host - used);
+    }
+    state->active += slots;
+  }
+
+  std::vector<std::unique_ptr<HttpConnection>> connections(slots);
+  std::vector<char> warmed(slots, 0);
+  for (size_t i = 0; i < slots; ++i) {
+    connections[i] = factory_->Create(origin);
+    std::string error;
+    warmed[i] = connections[i] && connections[i]->Warm(&error);
+  }
+
+  size_t succeeded = 0;
+  for (size_t i = 0; i < slots; ++i) {
+    if (warmed[i]) {
+      ++succeeded;
+    }
+    Release(origin, warmed[i] ? std::move(connections[i]) : nullptr);
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.connections_opened += succeeded;
+  return succeeded;
+}
+
+size_t HttpConnectionPool::EvictIdle() {
+  std::vector<IdleConnection> expired;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto now = Clock::now();
+    for (auto& entry : hosts_) {
+      CollectExpiredLocked(entry.second.get(), now, &expired);
+    }
+  }
+  return expired.size();
+}
+
+size_t HttpConnectionPool::idle_count(const HttpOrigin& origin) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = hosts_.find(origin);
+  return it == hosts_.end() ? 0 : it->second->idle.size();
+}
+
+size_t HttpConnectionPool::active_count(const HttpOrigin& origin) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = hosts_.find(origin);
+  return it == hosts_.end() ? 0 : it->second->active;
+}
+
+HttpConnectionPool::Stats HttpConnectionPool::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+bool HttpConnectionPool::Acquire(const HttpOrigin& origin,
+                                 std::unique_ptr<HttpConnection>* connection,
+                                 bool* reused) {
+  std::vector<IdleConnection> expired;
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto& slot = hosts_[origin];
+  if (!slot) {
+    slot = std::make_unique<HostState>();
+  }
+  HostState* state = slot.get();
+  const auto deadline = Clock::now() + options_.acquire_timeout;
+  bool acquired = false;
+  for (;;) {
+    CollectExpiredLocked(state, Clock::now(), &expired);
+    // 取最近用过的连接，它最不可能已被服务器关闭
+    if (!state->idle.empty()) {
+      *connection = std::move(state->idle.back().connection);
+      state->idle.pop_back();
+      *reused = true;
+      ++stats_.connections_reused;
+      acquired = true;
+      break;
+    }
+    if (state->active < options_.max_connections_per_host) {
+      connection->reset();
+      *reused = false;
+      acquired = true;
+      break;
+    }
+    if (state->available.wait_until(lock, deadline) ==
+            std::cv_status::timeout &&
+        state->idle.empty() &&
+        state->active >= options_.max_connections_per_host) {
+      break;
+    }
+  }
+  if (acquired) {
+    ++state->active;
+  }
+  lock.unlock();
+  return acquired;
+}
+
+void HttpConnectionPool::Release(const HttpOrigin& origin,
+                                 std::unique_ptr<HttpConnection> connection) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    HostState* state = hosts_[origin].get();
+    --state->active;
+    if (connection) {
+      state->idle.push_back({std::move(connection), Clock::now()});
+    }
+    state->available.notify_one();
+  }
+  // 不能复用的连接在锁外关闭
+}
+
+void HttpConnectionPool::CollectExpiredLocked(
+    HostState* state,
+    Clock::time_point now,
+    std::vector<IdleConnection>* expired) {
+  // idle 按使用时间排序，超时的都在前面
+  auto first_alive = std::find_if(
+      state->idle.begin(), state->idle.end(),
+      [&](const IdleConnection& idle) {
+        return now - idle.last_used < options_.idle_timeout;
+      });
+  const size_t count =
+      static_cast<size_t>(first_alive - state->idle.begin());
+  if (count == 0) {
+    return;
+  }
+  std::move(state->idle.begin(), first_alive, std::back_inserter(*expired));
+  state->idle.erase(state->idle.begin(), first_alive);
+  stats_.connections_evicted += count;
+}
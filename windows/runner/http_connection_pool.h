@@ -0,0 +1,160 @@
+#ifndef RUNNER_HTTP_CONNECTION_POOL_H_
+#define RUNNER_HTTP_CONNECTION_POOL_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// HTTP keep-alive 连接池（与平台无关）。
+//
+// 连接的建立和收发由 HttpConnectionFactory 提供（Windows 上为 WinHTTP）。
+// 连接池按 origin（scheme + host + port）管理连接：每个 origin 有并发上限，
+// 用完的连接放回空闲列表供下一个请求复用，空闲超时的连接被关闭。
+// 启动阶段可以先对常用 origin 预热，让第一批请求不必再付 DNS + TCP + TLS
+// 的开销。
+
+using HttpHeaders = std::vector<std::pair<std::string, std::string>>;
+
+struct HttpOrigin {
+  bool secure = true;
+  std::string host;
+  uint16_t port = 443;
+
+  // "https://api.example.com:8443"
+  std::string ToString() const;
+  bool operator<(const HttpOrigin& other) const;
+  bool operator==(const HttpOrigin& other) const;
+};
+
+// 拆分 "http(s)://host[:port][/path][?query]"。|path| 至少为 "/"。
+bool ParseHttpUrl(const std::string& url,
+                  HttpOrigin* origin,
+                  std::string* path);
+
+struct HttpRequest {
+  std::string method = "GET";
+  std::string path = "/";
+  HttpHeaders headers;
+  std::string body;
+  std::chrono::milliseconds timeout{15000};
+  // 设置后响应体按块交给它，不再保存到 HttpResponse::body。调用时状态码和
+  // 响应头已经可用。返回 false 时停止读取，请求失败，连接不再复用。
+  std::function<bool(const char* data, size_t size)> body_sink;
+};
+
+struct HttpResponse {
+  int status_code = 0;
+  HttpHeaders headers;
+  std::string body;
+};
+
+// 一条到某个 origin 的连接。同一时刻只被一个请求使用。
+class HttpConnection {
+ public:
+  virtual ~HttpConnection() = default;
+
+  // 建立连接（包括 TLS 握手），用于预热。
+  virtual bool Warm(std::string* error) = 0;
+
+  // 发送请求并读取完整响应。失败时 |error| 为可读的原因。
+  virtual bool Send(const HttpRequest& request,
+                    HttpResponse* response,
+                    std::string* error) = 0;
+
+  // 连接是否还能放回连接池（出过传输错误或服务器要求关闭时为 false）。
+  virtual bool reusable() const = 0;
+};
+
+class HttpConnectionFactory {
+ public:
+  virtual ~HttpConnectionFactory() = default;
+
+  // 创建连接对象，不要求立即建立连接。
+  virtual std::unique_ptr<HttpConnection> Create(const HttpOrigin& origin) = 0;
+};
+
+class HttpConnectionPool {
+ public:
+  struct Options {
+    size_t max_connections_per_host = 6;
+    std::chrono::milliseconds idle_timeout{std::chrono::seconds(60)};
+    // 等待空闲连接的最长时间，超过后请求失败
+    std::chrono::milliseconds acquire_timeout{std::chrono::seconds(30)};
+  };
+
+  struct Stats {
+    size_t connections_opened = 0;
+    size_t connections_reused = 0;
+    size_t connections_evicted = 0;
+    size_t requests_failed = 0;
+  };
+
+  HttpConnectionPool(std::unique_ptr<HttpConnectionFactory> factory,
+                     const Options& options);
+  ~HttpConnectionPool();
+
+  HttpConnectionPool(const HttpConnectionPool&) = delete;
+  HttpConnectionPool& operator=(const HttpConnectionPool&) = delete;
+
+  // 同步执行请求，可以在多个线程上同时调用。复用的连接已被服务器关闭时，
+  // 幂等请求会用新连接重试一次；设置了 body_sink 的请求只在还没收到响应
+  // 时重试。
+  bool Execute(const HttpOrigin& origin,
+               const HttpRequest& request,
+               HttpResponse* response,
+               std::string* error);
+
+  // 同步建立最多 |count| 条连接并放入空闲列表（受并发上限约束），
+  // 返回成功建立的数量。
+  size_t Prewarm(const HttpOrigin& origin, size_t count);
+
+  // 关闭空闲超时的连接，返回关闭的数量。Execute 时也会顺带清理。
+  size_t EvictIdle();
+
+  size_t idle_count(const HttpOrigin& origin) const;
+  size_t active_count(const HttpOrigin& origin) const;
+  Stats stats() const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct IdleConnection {
+    std::unique_ptr<HttpConnection> connection;
+    Clock::time_point last_used;
+  };
+
+  struct HostState {
+    std::vector<IdleConnection> idle;  // 末尾是最近用过的
+    size_t active = 0;                 // 正在使用或正在建立的连接
+    std::condition_variable available;
+  };
+
+  // 取得一条连接：优先复用空闲连接，否则在未达上限时返回空指针并占用一个
+  // 名额，由调用方新建。|reused| 表示是否复用。超时返回 false。
+  bool Acquire(const HttpOrigin& origin,
+               std::unique_ptr<HttpConnection>* connection,
+               bool* reused);
+  void Release(const HttpOrigin& origin,
+               std::unique_ptr<HttpConnection> connection);
+  // 移出 |state| 中超时的空闲连接，调用方在锁外析构它们。
+  void CollectExpiredLocked(HostState* state,
+                            Clock::time_point now,
+                            std::vector<IdleConnection>* expired);
+
+  const std::unique_ptr<HttpConnectionFactory> factory_;
+  const Options options_;
+
+  mutable std::mutex mutex_;
+  std::map<HttpOrigin, std::unique_ptr<HostState>> hosts_;
+  Stats stats_;
+};
+
+#endif  // RUNNER_HTTP_CONNECTION_POOL_H_
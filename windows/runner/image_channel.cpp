@@ -0,0 +1,280 @@
+#include "image_channel.h"
+
+#include <flutter/standard_method_codec.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "memory_telemetry.h"
+#include "method_channel_utils.h"
+#include "utils.h"
+#include "wic_image_codec.h"
+
+namespace {
+
+constexpr char kChannelName[] = "com.example.suxingchahui/image";
+constexpr int64_t kDefaultPreviewMaxDimension = 2048;
+constexpr int kDefaultJpegQuality = 90;
+
+using flutter::EncodableMap;
+using flutter::EncodableValue;
+using SharedResult = std::shared_ptr<flutter::MethodResult<EncodableValue>>;
+
+const char* FormatName(ImageFormat format) {
+  switch (format) {
+    case ImageFormat::kJpeg:
+      return "jpeg";
+    case ImageFormat::kPng:
+      return "png";
+    default:
+      return "other";
+  }
+}
+
+// 按比例缩小到最长边不超过 |max_dimension|，不放大。
+void FitWithin(double width,
+               double height,
+               int64_t max_dimension,
+               uint32_t* out_width,
+               uint32_t* out_height) {
+  double scale = 1.0;
+  const double longest = std::max(width, height);
+  if (max_dimension > 0 && longest > static_cast<double>(max_dimension)) {
+    scale = static_cast<double>(max_dimension) / longest;
+  }
+  *out_width = static_cast<uint32_t>(std::max(1.0, std::round(width * scale)));
+  *out_height =
+      static_cast<uint32_t>(std::max(1.0, std::round(height * scale)));
+}
+
+// 在平台线程上回复。窗口已经销毁时直接丢弃，MethodResult 随任务析构。
+void PostReply(const std::weak_ptr<PlatformTaskRunner>& weak_runner,
+               SharedResult result,
+               bool ok,
+               EncodableValue value,
+               const char* error_code,
+               std::string error) {
+  auto runner = weak_runner.lock();
+  if (!runner) {
+    return;
+  }
+  runner->PostTask([result = std::move(result), ok, value = std::move(value),
+                    error_code, error = std::move(error)]() mutable {
+    if (ok) {
+      result->Success(std::move(value));
+    } else {
+      result->Error(error_code, error);
+    }
+  });
+}
+
+}  // namespace
+
+ImageChannel::ImageChannel(flutter::BinaryMessenger* messenger,
+                           std::shared_ptr<PlatformTaskRunner> task_runner)
+    : channel_(std::make_unique<flutter::MethodChannel<EncodableValue>>(
+          messenger, kChannelName,
+          &flutter::StandardMethodCodec::GetInstance())),
+      task_runner_(std::move(task_runner)),
+      sessions_(std::make_shared<Sessions>()) {
+  // 裁剪对话框打开期间持有的原图
+  MemoryTelemetry::GetInstance().RegisterCounter(
+      "image.sessions", [sessions = sessions_]() {
+        std::lock_guard<std::mutex> lock(sessions->mutex);
+        int64_t bytes = 0;
+        for (const auto& entry : sessions->images) {
+          bytes += static_cast<int64_t>(entry.second->pixels.size());
+        }
+        return bytes;
+      });
+  channel_->SetMethodCallHandler(
+      [this](const auto& call, auto result) {
+        HandleMethodCall(call, std::move(result));
+      });
+}
+
+void ImageChannel::HandleMethodCall(
+    const flutter::MethodCall<EncodableValue>& call,
+    std::unique_ptr<flutter::MethodResult<EncodableValue>> result) {
+  const std::string& method = call.method_name();
+
+  if (method == "open") {
+    HandleOpen(call.arguments(), std::move(result));
+    return;
+  }
+
+  if (method == "crop") {
+    HandleCrop(call.arguments(), std::move(result));
+    return;
+  }
+
+  if (method == "close") {
+    if (const auto session = GetIntArgument(call.arguments(), "session")) {
+      std::lock_guard<std::mutex> lock(sessions_->mutex);
+      sessions_->images.erase(*session);
+    }
+    result->Success();
+    return;
+  }
+
+  result->NotImplemented();
+}
+
+void ImageChannel::HandleOpen(
+    const EncodableValue* arguments,
+    std::unique_ptr<flutter::MethodResult<EncodableValue>> result) {
+  std::wstring path;
+  std::vector<uint8_t> bytes;
+  if (const auto path_argument = GetStringArgument(arguments, "path")) {
+    path = Utf16FromUtf8(*path_argument);
+  } else if (const auto* value = FindArgument(arguments, "bytes")) {
+    if (const auto* data = std::get_if<std::vector<uint8_t>>(value)) {
+      bytes = *data;
+    }
+  }
+  if (path.empty() && bytes.empty()) {
+    result->Error("bad_args", "Missing path or bytes");
+    return;
+  }
+  const int64_t preview_max_dimension =
+      GetIntArgument(arguments, "previewMaxDimension")
+          .value_or(kDefaultPreviewMaxDimension);
+
+  SharedResult shared_result = std::move(result);
+  std::weak_ptr<PlatformTaskRunner> weak_runner = task_runner_;
+  workers_.Post([sessions = sessions_, weak_runner, shared_result,
+                 path = std::move(path), bytes = std::move(bytes),
+                 preview_max_dimension]() {
+    ScopedComInitializer com;
+    auto image = std::make_shared<PixelBuffer>();
+    ImageFormat format = ImageFormat::kUnknown;
+    std::string error = "CoInitializeEx failed";
+    bool ok = com.succeeded();
+    if (ok) {
+      ok = path.empty() ? DecodeImageBytes(bytes.data(), bytes.size(),
+                                           image.get(), &format, &error)
+                        : DecodeImageFile(path, image.get(), &format, &error);
+    }
+    if (!ok) {
+      PostReply(weak_runner, shared_result, false, EncodableValue(),
+                "decode_failed", std::move(error));
+      return;
+    }
+
+    uint32_t preview_width = 0;
+    uint32_t preview_height = 0;
+    FitWithin(image->width, image->height, preview_max_dimension,
+              &preview_width, &preview_height);
+    PixelBuffer preview;
+    if (preview_width == image->width && preview_height == image->height) {
+      preview = *image;
+    } else {
+      const SourceRect whole{0, 0, static_cast<double>(image->width),
+                             static_cast<double>(image->height)};
+      ResampleRegion(*image, whole, preview_width, preview_height, &preview);
+    }
+    // dart:ui 的 decodeImageFromPixels 要求非预乘 alpha
+    UnpremultiplyAlpha(&preview);
+
+    int64_t session = 0;
+    {
+      std::lock_guard<std::mutex> lock(sessions->mutex);
+      session = sessions->next_id++;
+      sessions->images.emplace(session, image);
+    }
+    EncodableValue reply(EncodableMap{
+        {EncodableValue("session"), EncodableValue(session)},
+        {EncodableValue("width"),
+         EncodableValue(static_cast<int64_t>(image->width))},
+        {EncodableValue("height"),
+         EncodableValue(static_cast<int64_t>(image->height))},
+        {EncodableValue("format"), EncodableValue(FormatName(format))},
+        {EncodableValue("previewWidth"),
+         EncodableValue(static_cast<int64_t>(preview.width))},
+        {EncodableValue("previewHeight"),
+         EncodableValue(static_cast<int64_t>(preview.height))},
+        {EncodableValue("preview"), EncodableValue(std::move(preview.pixels))},
+    });
+    PostReply(weak_runner, shared_result, true, std::move(reply), nullptr,
+              std::string());
+  });
+}
+
+void ImageChannel::HandleCrop(
+    const EncodableValue* arguments,
+    std::unique_ptr<flutter::MethodResult<EncodableValue>> result) {
+  const auto session = GetIntArgument(arguments, "session");
+  std::shared_ptr<const PixelBuffer> image;
+  if (session) {
+    std::lock_guard<std::mutex> lock(sessions_->mutex);
+    auto it = sessions_->images.find(*session);
+    if (it != sessions_->images.end()) {
+      image = it->second;
+    }
+  }
+  if (!image) {
+    result->Error("no_session", "Unknown image session");
+    return;
+  }
+
+  const auto clamp_fraction = [arguments](const char* key, double fallback) {
+    return std::clamp(GetDoubleArgument(arguments, key).value_or(fallback),
+                      0.0, 1.0);
+  };
+  const double left = clamp_fraction("left", 0.0);
+  const double top = clamp_fraction("top", 0.0);
+  SourceRect rect;
+  rect.left = left * image->width;
+  rect.top = top * image->height;
+  rect.width = std::min(clamp_fraction("width", 1.0), 1.0 - left) *
+               image->width;
+  rect.height = std::min(clamp_fraction("height", 1.0), 1.0 - top) *
+                image->height;
+  if (rect.width < 1.0 || rect.height < 1.0) {
+    result->Error("bad_args", "Crop region is empty");
+    return;
+  }
+
+  const ImageFormat format =
+      GetStringArgument(arguments, "format").value_or("png") == "jpeg"
+          ? ImageFormat::kJpeg
+          : ImageFormat::kPng;
+  const int quality = static_cast<int>(
+      GetIntArgument(arguments, "quality").value_or(kDefaultJpegQuality));
+  const bool circle = GetBoolArgument(arguments, "circle").value_or(true);
+  const int64_t max_output_size =
+      GetIntArgument(arguments, "maxOutputSize").value_or(0);
+
+  SharedResult shared_result = std::move(result);
+  std::weak_ptr<PlatformTaskRunner> weak_runner = task_runner_;
+  workers_.Post([image = std::move(image), weak_runner, shared_result, rect,
+                 format, quality, circle, max_output_size]() {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    FitWithin(rect.width, rect.height, max_output_size, &width, &height);
+
+    PixelBuffer output;
+    std::vector<uint8_t> bytes;
+    std::string error = "Crop region out of bounds";
+    bool ok = ResampleRegion(*image, rect, width, height, &output);
+    if (ok) {
+      if (circle) {
+        ApplyCircleMask(&output);
+      }
+      ScopedComInitializer com;
+      error = "CoInitializeEx failed";
+      ok = com.succeeded() &&
+           EncodeImage(output, format, quality, &bytes, &error);
+    }
+    if (!ok) {
+      PostReply(weak_runner, shared_result, false, EncodableValue(),
+                "encode_failed", std::move(error));
+      return;
+    }
+    PostReply(weak_runner, shared_result, true,
+              EncodableValue(std::move(bytes)), nullptr, std::string());
+  });
+}
@@ -0,0 +1,65 @@
+#ifndef RUNNER_IMAGE_CHANNEL_H_
+#define RUNNER_IMAGE_CHANNEL_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+#include <flutter/method_channel.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "image_ops.h"
+#include "platform_task_runner.h"
+#include "thread_pool.h"
+
+// 裁剪对话框使用的原生图片管线：解码、裁剪、缩放、遮罩和编码都在后台
+// 线程上完成，Dart 只收到预览像素和最终的文件字节。
+//
+// 通道：com.example.suxingchahui/image
+//   open {path | bytes, previewMaxDimension}
+//       -> {session, width, height, format: 'jpeg'|'png'|'other',
+//           previewWidth, previewHeight, preview: Uint8List}
+//       preview 为非预乘的 BGRA 像素（PixelFormat.bgra8888），
+//       用于 InteractiveViewer 显示
+//   crop {session, left, top, width, height, maxOutputSize, circle,
+//         format: 'jpeg'|'png', quality} -> Uint8List
+//       裁剪区域为原图宽高的比例（0-1）。不传 maxOutputSize 时按原图
+//       分辨率输出
+//   close {session}
+class ImageChannel {
+ public:
+  ImageChannel(flutter::BinaryMessenger* messenger,
+               std::shared_ptr<PlatformTaskRunner> task_runner);
+
+  ImageChannel(const ImageChannel&) = delete;
+  ImageChannel& operator=(const ImageChannel&) = delete;
+
+ private:
+  // 解码后的原图，工作线程和平台线程共享。
+  struct Sessions {
+    std::mutex mutex;
+    int64_t next_id = 1;
+    std::unordered_map<int64_t, std::shared_ptr<const PixelBuffer>> images;
+  };
+
+  void HandleMethodCall(
+      const flutter::MethodCall<flutter::EncodableValue>& call,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleOpen(
+      const flutter::EncodableValue* arguments,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+  void HandleCrop(
+      const flutter::EncodableValue* arguments,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> channel_;
+  std::shared_ptr<PlatformTaskRunner> task_runner_;
+  std::shared_ptr<Sessions> sessions_;
+  // 一个线程就够：请求按顺序处理，单张图片的缩放内部再并行。
+  ThreadPool workers_{1};
+};
+
+#endif  // RUNNER_IMAGE_CHANNEL_H_
@@ -0,0 +1,459 @@
+#include "image_ops.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+#include "cpu_features.h"
+#include "thread_pool.h"
+
+#if RUNNER_ARCH_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// 权重为 14 位定点数，两个权重可以放进一次 pmaddwd
+constexpr int kPrecisionBits = 14;
+constexpr int32_t kRounding = 1 << (kPrecisionBits - 1);
+constexpr double kBicubicSupport = 2.0;
+// 少于这么多输出行时不值得开线程
+constexpr uint32_t kRowsPerBand = 64;
+
+double BicubicFilter(double x) {
+  // Catmull-Rom（a = -0.5）
+  constexpr double a = -0.5;
+  x = std::fabs(x);
+  if (x < 1.0) {
+    return ((a + 2.0) * x - (a + 3.0)) * x * x + 1.0;
+  }
+  if (x < 2.0) {
+    return (((x - 5.0) * x + 8.0) * x - 4.0) * a;
+  }
+  return 0.0;
+}
+
+// 一个方向上的卷积系数：第 i 个输出取输入 [start[i], start[i] + count[i])，
+// 权重从 weights[i * taps] 开始。
+struct FilterBank {
+  std::vector<int32_t> start;
+  std::vector<int32_t> count;
+  std::vector<int16_t> weights;
+  int32_t taps = 0;
+};
+
+void BuildFilterBank(double in_start,
+                     double in_length,
+                     uint32_t in_limit,
+                     uint32_t out_size,
+                     FilterBank* bank) {
+  const double scale = in_length / out_size;
+  const double filter_scale = std::max(scale, 1.0);
+  const double support = kBicubicSupport * filter_scale;
+  bank->taps = static_cast<int32_t>(std::ceil(support)) * 2 + 1;
+  bank->start.assign(out_size, 0);
+  bank->count.assign(out_size, 0);
+  bank->weights.assign(static_cast<size_t>(out_size) * bank->taps, 0);
+
+  std::vector<double> raw(static_cast<size_t>(bank->taps));
+  const int32_t limit = static_cast<int32_t>(in_limit);
+  for (uint32_t i = 0; i < out_size; ++i) {
+    const double center = in_start + (i + 0.5) * scale;
+    int32_t first =
+        std::max(static_cast<int32_t>(std::floor(center - support + 0.5)), 0);
+    const int32_t last = std::min(
+        static_cast<int32_t>(std::floor(center + support + 0.5)), limit);
+    int32_t count = std::min(last - first, bank->taps);
+    int16_t* weights =
+        bank->weights.data() + static_cast<size_t>(i) * bank->taps;
+
+    double total = 0.0;
+    for (int32_t k = 0; k < count; ++k) {
+      raw[static_cast<size_t>(k)] =
+          BicubicFilter((first + k - center + 0.5) / filter_scale);
+      total += raw[static_cast<size_t>(k)];
+    }
+    if (count <= 0 || total == 0.0) {
+      // 区域贴着图像边缘时可能取不到任何采样点，退化为最近的像素
+      first = std::min(std::max(static_cast<int32_t>(center), 0), limit - 1);
+      count = 1;
+      raw[0] = 1.0;
+      total = 1.0;
+    }
+
+    // 定点化后权重之和必须正好是 1，误差补到最大的权重上
+    int32_t sum = 0;
+    int32_t largest = 0;
+    for (int32_t k = 0; k < count; ++k) {
+      const double value = raw[static_cast<size_t>(k)] / total;
+      weights[k] = static_cast<int16_t>(
+          std::lround(value * (1 << kPrecisionBits)));
+      sum += weights[k];
+      if (weights[k] > weights[largest]) {
+        largest = k;
+      }
+    }
+    weights[largest] =
+        static_cast<int16_t>(weights[largest] + (1 << kPrecisionBits) - sum);
+    bank->start[i] = first;
+    bank->count[i] = count;
+  }
+}
+
+uint8_t ClampToByte(int32_t value) {
+  return static_cast<uint8_t>(std::min(std::max(value, 0), 255));
+}
+
+// 水平方向：|input| 的一行 -> |output| 的一行。
+void HorizontalRowScalar(const uint8_t* input,
+                         uint8_t* output,
+                         const FilterBank& bank) {
+  const size_t out_width = bank.start.size();
+  for (size_t x = 0; x < out_width; ++x) {
+    const uint8_t* pixel = input + static_cast<size_t>(bank.start[x]) * 4;
+    const int16_t* weights = bank.weights.data() + x * bank.taps;
+    int32_t sum[4] = {kRounding, kRounding, kRounding, kRounding};
+    for (int32_t k = 0; k < bank.count[x]; ++k) {
+      for (int c = 0; c < 4; ++c) {
+        sum[c] += pixel[k * 4 + c] * weights[k];
+      }
+    }
+    for (int c = 0; c < 4; ++c) {
+      output[x * 4 + c] = ClampToByte(sum[c] >> kPrecisionBits);
+    }
+  }
+}
+
+// 垂直方向：|rows| 中 count 行的 [begin, end) 字节按权重合成到 |output|。
+void VerticalSpanScalar(const uint8_t* const* rows,
+                        const int16_t* weights,
+                        int32_t count,
+                        size_t begin,
+                        size_t end,
+                        uint8_t* output) {
+  for (size_t i = begin; i < end; ++i) {
+    int32_t sum = kRounding;
+    for (int32_t k = 0; k < count; ++k) {
+      sum += rows[k][i] * weights[k];
+    }
+    output[i] = ClampToByte(sum >> kPrecisionBits);
+  }
+}
+
+#if RUNNER_ARCH_X86
+
+// 两个 16 位权重拼成 pmaddwd 的一个 32 位元素，低位对应第一个抽头。
+int32_t WeightPair(int16_t first, int16_t second) {
+  const uint32_t low = static_cast<uint16_t>(first);
+  const uint32_t high = static_cast<uint16_t>(second);
+  return static_cast<int32_t>(low | (high << 16));
+}
+
+// 一次处理两个相邻像素（两个抽头）：字节重排为
+// [b0 b1 g0 g1 r0 r1 a0 a1] 的 16 位数，与 [w0 w1] x 4 做 pmaddwd，
+// 得到 4 个通道各自的 32 位累加值。
+RUNNER_TARGET_ATTRIBUTE("ssse3")
+void HorizontalRowSsse3(const uint8_t* input,
+                        uint8_t* output,
+                        const FilterBank& bank) {
+  const __m128i shuffle = _mm_setr_epi8(0, -1, 4, -1, 1, -1, 5, -1, 2, -1, 6,
+                                        -1, 3, -1, 7, -1);
+  const size_t out_width = bank.start.size();
+  for (size_t x = 0; x < out_width; ++x) {
+    const uint8_t* pixel = input + static_cast<size_t>(bank.start[x]) * 4;
+    const int16_t* weights = bank.weights.data() + x * bank.taps;
+    const int32_t count = bank.count[x];
+    __m128i sum = _mm_set1_epi32(kRounding);
+    int32_t k = 0;
+    for (; k + 1 < count; k += 2) {
+      const __m128i pair = _mm_shuffle_epi8(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixel + k * 4)),
+          shuffle);
+      const __m128i w = _mm_set1_epi32(WeightPair(weights[k], weights[k + 1]));
+      sum = _mm_add_epi32(sum, _mm_madd_epi16(pair, w));
+    }
+    if (k < count) {
+      // 最后一个单独的抽头只读 4 个字节，不会越过行尾
+      int32_t last;
+      std::memcpy(&last, pixel + k * 4, sizeof(last));
+      const __m128i single =
+          _mm_shuffle_epi8(_mm_cvtsi32_si128(last), shuffle);
+      const __m128i w = _mm_set1_epi32(WeightPair(weights[k], 0));
+      sum = _mm_add_epi32(sum, _mm_madd_epi16(single, w));
+    }
+    sum = _mm_srai_epi32(sum, kPrecisionBits);
+    const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(sum, sum), sum);
+    const int32_t result = _mm_cvtsi128_si32(packed);
+    std::memcpy(output + x * 4, &result, sizeof(result));
+  }
+}
+
+// 两行交错成 [a0 b0 a1 b1 ...] 后与 [wa wb] 做 pmaddwd，一次处理两个抽头。
+// SSE2 是 x64 的基线指令集，不需要检测。
+void VerticalRowSse2(const uint8_t* const* rows,
+                     const int16_t* weights,
+                     int32_t count,
+                     size_t row_bytes,
+                     uint8_t* output) {
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 16 <= row_bytes; i += 16) {
+    __m128i sum0 = _mm_set1_epi32(kRounding);
+    __m128i sum1 = sum0;
+    __m128i sum2 = sum0;
+    __m128i sum3 = sum0;
+    for (int32_t k = 0; k < count; k += 2) {
+      // 奇数个抽头时最后一行与全 0 配对
+      const bool has_pair = k + 1 < count;
+      const __m128i a =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k] + i));
+      const __m128i b =
+          has_pair ? _mm_loadu_si128(
+                         reinterpret_cast<const __m128i*>(rows[k + 1] + i))
+                   : zero;
+      const __m128i w = _mm_set1_epi32(
+          WeightPair(weights[k], has_pair ? weights[k + 1] : int16_t{0}));
+      const __m128i low = _mm_unpacklo_epi8(a, b);
+      const __m128i high = _mm_unpackhi_epi8(a, b);
+      sum0 = _mm_add_epi32(
+          sum0, _mm_madd_epi16(_mm_unpacklo_epi8(low, zero), w));
+      sum1 = _mm_add_epi32(
+          sum1, _mm_madd_epi16(_mm_unpackhi_epi8(low, zero), w));
+      sum2 = _mm_add_epi32(
+          sum2, _mm_madd_epi16(_mm_unpacklo_epi8(high, zero), w));
+      sum3 = _mm_add_epi32(
+          sum3, _mm_madd_epi16(_mm_unpackhi_epi8(high, zero), w));
+    }
+    const __m128i words0 =
+        _mm_packs_epi32(_mm_srai_epi32(sum0, kPrecisionBits),
+                        _mm_srai_epi32(sum1, kPrecisionBits));
+    const __m128i words1 =
+        _mm_packs_epi32(_mm_srai_epi32(sum2, kPrecisionBits),
+                        _mm_srai_epi32(sum3, kPrecisionBits));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i),
+                     _mm_packus_epi16(words0, words1));
+  }
+  VerticalSpanScalar(rows, weights, count, i, row_bytes, output);
+}
+
+RUNNER_TARGET_ATTRIBUTE("avx2")
+void VerticalRowAvx2(const uint8_t* const* rows,
+                     const int16_t* weights,
+                     int32_t count,
+                     size_t row_bytes,
+                     uint8_t* output) {
+  const __m256i zero = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 32 <= row_bytes; i += 32) {
+    __m256i sum0 = _mm256_set1_epi32(kRounding);
+    __m256i sum1 = sum0;
+    __m256i sum2 = sum0;
+    __m256i sum3 = sum0;
+    for (int32_t k = 0; k < count; k += 2) {
+      const bool has_pair = k + 1 < count;
+      const __m256i a =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows[k] + i));
+      const __m256i b =
+          has_pair ? _mm256_loadu_si256(
+                         reinterpret_cast<const __m256i*>(rows[k + 1] + i))
+                   : zero;
+      const __m256i w = _mm256_set1_epi32(
+          WeightPair(weights[k], has_pair ? weights[k + 1] : int16_t{0}));
+      // unpack 在每个 128 位半边内进行，pack 时顺序会还原
+      const __m256i low = _mm256_unpacklo_epi8(a, b);
+      const __m256i high = _mm256_unpackhi_epi8(a, b);
+      sum0 = _mm256_add_epi32(
+          sum0, _mm256_madd_epi16(_mm256_unpacklo_epi8(low, zero), w));
+      sum1 = _mm256_add_epi32(
+          sum1, _mm256_madd_epi16(_mm256_unpackhi_epi8(low, zero), w));
+      sum2 = _mm256_add_epi32(
+          sum2, _mm256_madd_epi16(_mm256_unpacklo_epi8(high, zero), w));
+      sum3 = _mm256_add_epi32(
+          sum3, _mm256_madd_epi16(_mm256_unpackhi_epi8(high, zero), w));
+    }
+    const __m256i words0 =
+        _mm256_packs_epi32(_mm256_srai_epi32(sum0, kPrecisionBits),
+                           _mm256_srai_epi32(sum1, kPrecisionBits));
+    const __m256i words1 =
+        _mm256_packs_epi32(_mm256_srai_epi32(sum2, kPrecisionBits),
+                           _mm256_srai_epi32(sum3, kPrecisionBits));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i),
+                        _mm256_packus_epi16(words0, words1));
+  }
+  VerticalSpanScalar(rows, weights, count, i, row_bytes, output);
+}
+
+#else
+
+void VerticalRowScalar(const uint8_t* const* rows,
+                       const int16_t* weights,
+                       int32_t count,
+                       size_t row_bytes,
+                       uint8_t* output) {
+  VerticalSpanScalar(rows, weights, count, 0, row_bytes, output);
+}
+
+#endif  // RUNNER_ARCH_X86
+
+using HorizontalRowFunction = void (*)(const uint8_t*,
+                                       uint8_t*,
+                                       const FilterBank&);
+using VerticalRowFunction = void (*)(const uint8_t* const*,
+                                     const int16_t*,
+                                     int32_t,
+                                     size_t,
+                                     uint8_t*);
+
+HorizontalRowFunction SelectHorizontalRow() {
+#if RUNNER_ARCH_X86
+  if (GetCpuFeatures().ssse3) {
+    return HorizontalRowSsse3;
+  }
+#endif
+  return HorizontalRowScalar;
+}
+
+VerticalRowFunction SelectVerticalRow() {
+#if RUNNER_ARCH_X86
+  if (GetCpuFeatures().avx2) {
+    return VerticalRowAvx2;
+  }
+  return VerticalRowSse2;
+#else
+  return VerticalRowScalar;
+#endif
+}
+
+// 把 [0, rows) 分成若干块并行处理。
+void ForEachRowBand(uint32_t rows,
+                    const std::function<void(uint32_t, uint32_t)>& body) {
+  const uint32_t bands = std::max<uint32_t>(1, rows / kRowsPerBand);
+  ParallelFor(bands, 0, [&](size_t band) {
+    const uint32_t begin =
+        static_cast<uint32_t>(static_cast<uint64_t>(rows) * band / bands);
+    const uint32_t end =
+        static_cast<uint32_t>(static_cast<uint64_t>(rows) * (band + 1) / bands);
+    body(begin, end);
+  });
+}
+
+}  // namespace
+
+void PixelBuffer::Allocate(uint32_t new_width, uint32_t new_height) {
+  width = new_width;
+  height = new_height;
+  pixels.assign(stride() * height, 0);
+}
+
+bool ResampleRegion(const PixelBuffer& source,
+                    const SourceRect& rect,
+                    uint32_t width,
+                    uint32_t height,
+                    PixelBuffer* output) {
+  if (source.empty() || width == 0 || height == 0 || rect.width <= 0 ||
+      rect.height <= 0 || rect.left < 0 || rect.top < 0 ||
+      rect.left + rect.width > source.width + 1e-6 ||
+      rect.top + rect.height > source.height + 1e-6) {
+    return false;
+  }
+  static const HorizontalRowFunction horizontal_row = SelectHorizontalRow();
+  static const VerticalRowFunction vertical_row = SelectVerticalRow();
+
+  FilterBank horizontal;
+  FilterBank vertical;
+  BuildFilterBank(rect.left, rect.width, source.width, width, &horizontal);
+  BuildFilterBank(rect.top, rect.height, source.height, height, &vertical);
+
+  // 只对垂直方向用得到的源行做水平缩放
+  const int32_t first_row = vertical.start.front();
+  const int32_t last_row = vertical.start.back() + vertical.count.back();
+  const uint32_t band_rows = static_cast<uint32_t>(last_row - first_row);
+  PixelBuffer band;
+  band.Allocate(width, band_rows);
+  ForEachRowBand(band_rows, [&](uint32_t begin, uint32_t end) {
+    for (uint32_t y = begin; y < end; ++y) {
+      horizontal_row(source.row(static_cast<uint32_t>(first_row) + y),
+                     band.row(y), horizontal);
+    }
+  });
+
+  output->Allocate(width, height);
+  ForEachRowBand(height, [&](uint32_t begin, uint32_t end) {
+    std::vector<const uint8_t*> rows(static_cast<size_t>(vertical.taps));
+    for (uint32_t y = begin; y < end; ++y) {
+      const int32_t start = vertical.start[y] - first_row;
+      const int32_t count = vertical.count[y];
+      for (int32_t k = 0; k < count; ++k) {
+        rows[static_cast<size_t>(k)] =
+            band.row(static_cast<uint32_t>(start + k));
+      }
+      const int16_t* weights =
+          vertical.weights.data() + static_cast<size_t>(y) * vertical.taps;
+      vertical_row(rows.data(), weights, count, output->stride(),
+                   output->row(y));
+    }
+  });
+  return true;
+}
+
+void ApplyCircleMask(PixelBuffer* image) {
+  const double center_x = image->width / 2.0;
+  const double center_y = image->height / 2.0;
+  const double radius = std::min(center_x, center_y);
+  for (uint32_t y = 0; y < image->height; ++y) {
+    uint8_t* row = image->row(y);
+    const double dy = y + 0.5 - center_y;
+    for (uint32_t x = 0; x < image->width; ++x) {
+      const double dx = x + 0.5 - center_x;
+      // 像素中心到圆周的距离在 ±0.5 内时按距离线性过渡
+      const double coverage =
+          std::min(std::max(radius - std::sqrt(dx * dx + dy * dy) + 0.5, 0.0),
+                   1.0);
+      if (coverage >= 1.0) {
+        continue;
+      }
+      const uint32_t scale = static_cast<uint32_t>(coverage * 256.0);
+      uint8_t* pixel = row + static_cast<size_t>(x) * 4;
+      for (int c = 0; c < 4; ++c) {
+        pixel[c] = static_cast<uint8_t>((pixel[c] * scale) >> 8);
+      }
+    }
+  }
+}
+
+void UnpremultiplyAlpha(PixelBuffer* image) {
+  uint8_t* pixel = image->pixels.data();
+  uint8_t* const end = pixel + image->pixels.size();
+  for (; pixel < end; pixel += 4) {
+    const uint32_t alpha = pixel[3];
+    if (alpha == 255) {
+      continue;
+    }
+    if (alpha == 0) {
+      pixel[0] = pixel[1] = pixel[2] = 0;
+      continue;
+    }
+    for (int c = 0; c < 3; ++c) {
+      pixel[c] = static_cast<uint8_t>(
+          std::min<uint32_t>((pixel[c] * 255u + alpha / 2) / alpha, 255u));
+    }
+  }
+}
+
+std::vector<uint8_t> FlattenOnWhite(const PixelBuffer& image) {
+  std::vector<uint8_t> output(static_cast<size_t>(image.width) * image.height *
+                              3);
+  const uint8_t* pixel = image.pixels.data();
+  uint8_t* out = output.data();
+  const size_t count = static_cast<size_t>(image.width) * image.height;
+  for (size_t i = 0; i < count; ++i, pixel += 4, out += 3) {
+    // 预乘 alpha：结果 = 颜色 + 白色 * (1 - alpha)
+    const uint32_t background = 255u - pixel[3];
+    for (int c = 0; c < 3; ++c) {
+      out[c] = static_cast<uint8_t>(
+          std::min<uint32_t>(pixel[c] + background, 255u));
+    }
+  }
+  return output;
+}
@@ -0,0 +1,50 @@
+#ifndef RUNNER_IMAGE_OPS_H_
+#define RUNNER_IMAGE_OPS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 与平台无关的像素处理：缩放、圆形遮罩和编码前的格式转换。
+// 编解码由平台层负责（Windows 上为 WIC，见 wic_image_codec.h）。
+
+// 32 位 BGRA 像素，alpha 预乘，行之间没有填充。
+struct PixelBuffer {
+  uint32_t width = 0;
+  uint32_t height = 0;
+  std::vector<uint8_t> pixels;
+
+  void Allocate(uint32_t new_width, uint32_t new_height);
+  size_t stride() const { return static_cast<size_t>(width) * 4; }
+  uint8_t* row(uint32_t y) { return pixels.data() + y * stride(); }
+  const uint8_t* row(uint32_t y) const { return pixels.data() + y * stride(); }
+  bool empty() const { return width == 0 || height == 0; }
+};
+
+// 源图像上的矩形区域，单位为像素，可以是小数。
+struct SourceRect {
+  double left = 0;
+  double top = 0;
+  double width = 0;
+  double height = 0;
+};
+
+// 把 |source| 的 |rect| 区域缩放为 |width| x |height|（裁剪和缩放一次完成）。
+// 使用可分离的双三次卷积，缩小时按比例扩大滤波器范围，不会产生混叠。
+// 大图会在多个线程上按行分块处理。|rect| 为空或超出图像时返回 false。
+bool ResampleRegion(const PixelBuffer& source,
+                    const SourceRect& rect,
+                    uint32_t width,
+                    uint32_t height,
+                    PixelBuffer* output);
+
+// 只保留内切圆，圆外透明，边缘按覆盖率抗锯齿。
+void ApplyCircleMask(PixelBuffer* image);
+
+// 预乘 alpha 转为普通 alpha（PNG 编码使用）。
+void UnpremultiplyAlpha(PixelBuffer* image);
+
+// 合成到白色背景上并转为 24 位 BGR（JPEG 编码使用），行之间没有填充。
+std::vector<uint8_t> FlattenOnWhite(const PixelBuffer& image);
+
+#endif  // RUNNER_IMAGE_OPS_H_
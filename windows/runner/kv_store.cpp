@@ -0,0 +1,469 @@
+#include "kv_store.h"
+
+#include <algorithm>
+#include <cstring>
+#include <system_error>
+#include <utility>
+
+#include "xxhash64.h"
+
+namespace {
+
+constexpr uint32_t kLogMagic = 0x564B5853;  // "SXKV"
+constexpr uint32_t kLogVersion = 1;
+constexpr uint32_t kFlagTombstone = 1;
+constexpr uint64_t kMaxGrowth = 256ull << 20;
+constexpr char kLogFileName[] = "data.log";
+constexpr char kCompactFileName[] = "data.log.compact";
+
+struct LogHeader {
+  uint32_t magic;
+  uint32_t version;
+  // 这个位置之前的记录已经在上次 Flush 或打开时校验过
+  uint64_t clean_end;
+  uint8_t reserved[48];
+};
+static_assert(sizeof(LogHeader) == 64, "LogHeader must be 64 bytes");
+
+// 记录：RecordHeader、键、值，整体按 8 字节对齐。
+struct RecordHeader {
+  uint32_t key_size;  // 0 表示日志结束（映射区域的空白部分全为 0）
+  uint32_t value_size;
+  uint64_t sequence;
+  uint32_t flags;
+  // 头部前 20 字节和键值的 XXH64 低 32 位，用于丢弃写了一半的记录
+  uint32_t checksum;
+};
+static_assert(sizeof(RecordHeader) == 24, "RecordHeader must be 24 bytes");
+
+constexpr size_t kChecksummedHeaderBytes = 20;
+
+uint32_t RecordSize(size_t key_size, size_t value_size) {
+  return static_cast<uint32_t>((sizeof(RecordHeader) + key_size + value_size +
+                                7) & ~size_t{7});
+}
+
+uint32_t RecordChecksum(const RecordHeader& header, const uint8_t* payload) {
+  const uint64_t seed = XxHash64(&header, kChecksummedHeaderBytes);
+  return static_cast<uint32_t>(XxHash64(
+      payload, static_cast<size_t>(header.key_size) + header.value_size,
+      seed));
+}
+
+bool HasPrefix(std::string_view value, std::string_view prefix) {
+  return value.size() >= prefix.size() &&
+         value.compare(0, prefix.size(), prefix) == 0;
+}
+
+}  // namespace
+
+KvStore::KvStore(std::filesystem::path directory, const Options& options)
+    : directory_(std::move(directory)),
+      log_path_(directory_ / kLogFileName),
+      options_(options) {}
+
+KvStore::~KvStore() {
+  if (!log_.is_open()) {
+    return;
+  }
+  Flush();
+  // 去掉映射区域预留的空白部分
+  log_.Close();
+  std::error_code error;
+  std::filesystem::resize_file(log_path_, end_, error);
+}
+
+bool KvStore::Open() {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  std::error_code error;
+  std::filesystem::create_directories(directory_, error);
+  // 上次压缩到一半退出留下的文件，原日志仍然完整
+  std::filesystem::remove(directory_ / kCompactFileName, error);
+
+  const uint64_t file_size = std::filesystem::file_size(log_path_, error);
+  uint64_t capacity = std::max<uint64_t>(options_.initial_capacity,
+                                         sizeof(LogHeader) + 4096);
+  if (!error) {
+    capacity = std::max(capacity, file_size);
+  }
+  if (!MapLog(capacity)) {
+    return false;
+  }
+  LoadLog();
+  return true;
+}
+
+bool KvStore::Get(std::string_view key, std::vector<uint8_t>* value) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    return false;
+  }
+  const uint8_t* data = log_.data() + it->second.offset +
+                        sizeof(RecordHeader) + it->first.size();
+  value->assign(data, data + it->second.value_size);
+  return true;
+}
+
+bool KvStore::Contains(std::string_view key) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return index_.find(key) != index_.end();
+}
+
+bool KvStore::Put(std::string_view key, const void* data, size_t size) {
+  if (key.empty() || key.size() > kMaxKeySize || size > kMaxValueSize) {
+    return false;
+  }
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    Location location;
+    if (!AppendLocked(key, data, size, false, &location)) {
+      return false;
+    }
+    ReplaceLocked(key, &location);
+    if (ShouldCompactLocked()) {
+      CompactLocked();
+    }
+  }
+  Notify(key, false);
+  return true;
+}
+
+bool KvStore::Remove(std::string_view key) {
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (index_.find(key) == index_.end()) {
+      return false;
+    }
+    Location tombstone;
+    if (!AppendLocked(key, nullptr, 0, true, &tombstone)) {
+      return false;
+    }
+    dead_bytes_ += tombstone.record_size;
+    ReplaceLocked(key, nullptr);
+    if (ShouldCompactLocked()) {
+      CompactLocked();
+    }
+  }
+  Notify(key, true);
+  return true;
+}
+
+size_t KvStore::RemovePrefix(std::string_view prefix) {
+  std::vector<std::string> removed;
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    for (auto it = index_.lower_bound(prefix);
+         it != index_.end() && HasPrefix(it->first, prefix); ++it) {
+      removed.push_back(it->first);
+    }
+    for (const auto& key : removed) {
+      Location tombstone;
+      if (!AppendLocked(key, nullptr, 0, true, &tombstone)) {
+        // 空间不足：已经写入的墓碑有效，其余的键保留
+        removed.resize(static_cast<size_t>(&key - removed.data()));
+        break;
+      }
+      dead_bytes_ += tombstone.record_size;
+      ReplaceLocked(key, nullptr);
+    }
+    if (ShouldCompactLocked()) {
+      CompactLocked();
+    }
+  }
+  for (const auto& key : removed) {
+    Notify(key, true);
+  }
+  return removed.size();
+}
+
+std::vector<std::string> KvStore::Keys(std::string_view prefix,
+                                       size_t limit) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  std::vector<std::string> keys;
+  for (auto it = index_.lower_bound(prefix);
+       it != index_.end() && HasPrefix(it->first, prefix); ++it) {
+    if (limit != 0 && keys.size() >= limit) {
+      break;
+    }
+    keys.push_back(it->first);
+  }
+  return keys;
+}
+
+void KvStore::Scan(std::string_view prefix,
+                   const std::function<bool(std::string_view key,
+                                            const uint8_t* value,
+                                            size_t size)>& visitor) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  for (auto it = index_.lower_bound(prefix);
+       it != index_.end() && HasPrefix(it->first, prefix); ++it) {
+    const uint8_t* value = log_.data() + it->second.offset +
+                           sizeof(RecordHeader) + it->first.size();
+    if (!visitor(it->first, value, it->second.value_size)) {
+      break;
+    }
+  }
+}
+
+uint64_t KvStore::Subscribe(std::string prefix, ChangeCallback callback) {
+  std::lock_guard<std::mutex> lock(subscription_mutex_);
+  const uint64_t id = next_subscription_++;
+  subscriptions_.push_back(
+      {id, std::move(prefix),
+       std::make_shared<ChangeCallback>(std::move(callback))});
+  return id;
+}
+
+void KvStore::Unsubscribe(uint64_t subscription) {
+  std::lock_guard<std::mutex> lock(subscription_mutex_);
+  subscriptions_.erase(
+      std::remove_if(subscriptions_.begin(), subscriptions_.end(),
+                     [subscription](const Subscription& item) {
+                       return item.id == subscription;
+                     }),
+      subscriptions_.end());
+}
+
+bool KvStore::Compact() {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  return CompactLocked();
+}
+
+void KvStore::Flush() {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (!log_.is_open()) {
+    return;
+  }
+  log_.Flush();
+  WriteHeaderLocked(end_);
+  log_.Flush();
+}
+
+KvStore::Stats KvStore::stats() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  Stats stats;
+  stats.entries = index_.size();
+  stats.live_bytes = live_bytes_;
+  stats.dead_bytes = dead_bytes_;
+  stats.file_bytes = end_;
+  stats.compactions = compactions_;
+  return stats;
+}
+
+bool KvStore::EnsureCapacityLocked(uint64_t required) {
+  uint64_t capacity = log_.size();
+  if (required <= capacity) {
+    return true;
+  }
+  const uint64_t old_capacity = capacity;
+  while (capacity < required) {
+    capacity += std::min(capacity, kMaxGrowth);
+  }
+  if (MapLog(capacity)) {
+    return true;
+  }
+  // 扩展失败（例如磁盘已满）时恢复原来的映射
+  RestoreMappingLocked(old_capacity);
+  return false;
+}
+
+bool KvStore::AppendLocked(std::string_view key,
+                           const void* data,
+                           size_t size,
+                           bool tombstone,
+                           Location* location) {
+  const uint32_t record_size = RecordSize(key.size(), size);
+  if (!log_.is_open() || !EnsureCapacityLocked(end_ + record_size)) {
+    return false;
+  }
+  uint8_t* record = log_.mutable_data() + end_;
+  uint8_t* payload = record + sizeof(RecordHeader);
+  std::memcpy(payload, key.data(), key.size());
+  if (size > 0) {
+    std::memcpy(payload + key.size(), data, size);
+  }
+
+  RecordHeader header = {};
+  header.key_size = static_cast<uint32_t>(key.size());
+  header.value_size = static_cast<uint32_t>(size);
+  header.sequence = next_sequence_++;
+  header.flags = tombstone ? kFlagTombstone : 0;
+  header.checksum = RecordChecksum(header, payload);
+  // 头部最后写入：键长度不为 0 才表示这里有记录
+  std::memcpy(record, &header, sizeof(header));
+
+  location->offset = end_;
+  location->value_size = header.value_size;
+  location->record_size = record_size;
+  end_ += record_size;
+  return true;
+}
+
+void KvStore::ReplaceLocked(std::string_view key, const Location* location) {
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    live_bytes_ -= it->second.record_size;
+    dead_bytes_ += it->second.record_size;
+    if (!location) {
+      index_.erase(it);
+      return;
+    }
+    it->second = *location;
+  } else if (!location) {
+    return;
+  } else {
+    index_.emplace(std::string(key), *location);
+  }
+  live_bytes_ += location->record_size;
+}
+
+bool KvStore::CompactLocked() {
+  if (!log_.is_open()) {
+    return false;
+  }
+  const std::filesystem::path compact_path = directory_ / kCompactFileName;
+  const uint64_t compact_size = sizeof(LogHeader) + live_bytes_;
+  std::map<std::string, Location, std::less<>> compacted;
+  {
+    MappedFile output;
+    if (!output.OpenWritable(compact_path, compact_size)) {
+      std::error_code error;
+      std::filesystem::remove(compact_path, error);
+      return false;
+    }
+    uint64_t offset = sizeof(LogHeader);
+    for (const auto& [key, location] : index_) {
+      std::memcpy(output.mutable_data() + offset,
+                  log_.data() + location.offset, location.record_size);
+      Location moved = location;
+      moved.offset = offset;
+      compacted.emplace_hint(compacted.end(), key, moved);
+      offset += location.record_size;
+    }
+    LogHeader header = {};
+    header.magic = kLogMagic;
+    header.version = kLogVersion;
+    header.clean_end = compact_size;
+    std::memcpy(output.mutable_data(), &header, sizeof(header));
+    output.Flush();
+  }
+
+  const uint64_t old_capacity = log_.size();
+  log_.Close();
+  std::error_code error;
+  std::filesystem::rename(compact_path, log_path_, error);
+  if (error) {
+    std::filesystem::remove(compact_path, error);
+    RestoreMappingLocked(old_capacity);
+    return false;
+  }
+  index_ = std::move(compacted);
+  end_ = compact_size;
+  dead_bytes_ = 0;
+  ++compactions_;
+  if (!MapLog(std::max(compact_size * 2, options_.initial_capacity))) {
+    RestoreMappingLocked(compact_size);
+  }
+  return true;
+}
+
+void KvStore::WriteHeaderLocked(uint64_t clean_end) {
+  LogHeader header = {};
+  header.magic = kLogMagic;
+  header.version = kLogVersion;
+  header.clean_end = clean_end;
+  std::memcpy(log_.mutable_data(), &header, sizeof(header));
+}
+
+bool KvStore::ShouldCompactLocked() const {
+  return dead_bytes_ >= options_.compaction_min_dead_bytes &&
+         dead_bytes_ > live_bytes_;
+}
+
+void KvStore::RestoreMappingLocked(uint64_t capacity) {
+  if (MapLog(capacity)) {
+    return;
+  }
+  // 连原来的大小都无法映射：索引指向的数据不可读，之后的写入都会失败
+  index_.clear();
+  live_bytes_ = dead_bytes_ = 0;
+}
+
+bool KvStore::MapLog(uint64_t capacity) {
+  return log_.OpenWritable(log_path_, static_cast<size_t>(capacity));
+}
+
+void KvStore::LoadLog() {
+  index_.clear();
+  live_bytes_ = dead_bytes_ = 0;
+  next_sequence_ = 1;
+
+  const uint64_t size = log_.size();
+  uint8_t* data = log_.mutable_data();
+  LogHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != kLogMagic || header.version != kLogVersion) {
+    // 新文件或格式不同：从空日志开始
+    std::memset(data, 0, static_cast<size_t>(size));
+    end_ = sizeof(LogHeader);
+    WriteHeaderLocked(end_);
+    return;
+  }
+
+  const uint64_t clean_end = std::min(header.clean_end, size);
+  uint64_t offset = sizeof(LogHeader);
+  bool torn = false;
+  while (offset + sizeof(RecordHeader) <= size) {
+    RecordHeader record;
+    std::memcpy(&record, data + offset, sizeof(record));
+    if (record.key_size == 0) {
+      break;
+    }
+    const uint32_t record_size = RecordSize(record.key_size, record.value_size);
+    if (record.key_size > kMaxKeySize || record.value_size > kMaxValueSize ||
+        offset + record_size > size) {
+      torn = true;
+      break;
+    }
+    const uint8_t* payload = data + offset + sizeof(RecordHeader);
+    if (offset + record_size > clean_end &&
+        RecordChecksum(record, payload) != record.checksum) {
+      torn = true;
+      break;
+    }
+
+    const std::string_view key(reinterpret_cast<const char*>(payload),
+                               record.key_size);
+    if (record.flags & kFlagTombstone) {
+      dead_bytes_ += record_size;
+      ReplaceLocked(key, nullptr);
+    } else {
+      const Location location{offset, record.value_size, record_size};
+      ReplaceLocked(key, &location);
+    }
+    next_sequence_ = std::max(next_sequence_, record.sequence + 1);
+    offset += record_size;
+  }
+  end_ = offset;
+  if (torn) {
+    // 写了一半的记录之后的内容都不可信，清零后新记录从这里开始
+    std::memset(data + end_, 0, static_cast<size_t>(size - end_));
+  }
+  WriteHeaderLocked(end_);
+}
+
+void KvStore::Notify(std::string_view key, bool deleted) {
+  std::vector<std::shared_ptr<ChangeCallback>> callbacks;
+  {
+    std::lock_guard<std::mutex> lock(subscription_mutex_);
+    for (const auto& subscription : subscriptions_) {
+      if (HasPrefix(key, subscription.prefix)) {
+        callbacks.push_back(subscription.callback);
+      }
+    }
+  }
+  for (const auto& callback : callbacks) {
+    (*callback)(key, deleted);
+  }
+}
@@ -0,0 +1,144 @@
+#ifndef RUNNER_KV_STORE_H_
+#define RUNNER_KV_STORE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mapped_file.h"
+
+// 日志结构的键值存储（与平台无关），用于列表页等结构化缓存。
+//
+// 所有写入都追加到一个内存映射的日志文件 data.log，内存中的有序索引
+// 记录每个键最新一条记录的位置，读取直接从映射中复制值。每条记录带有
+// 校验和，打开时从日志重建索引，丢弃进程退出时写了一半的尾部记录，
+// 之前的记录不受影响。上次 Flush 之前的记录在打开时不再校验。
+// 失效的记录超过存活记录时把存活记录重写到新文件再替换（压缩）。
+//
+// 可以按键前缀订阅变化，回调在写入的线程上调用，调用时不持有锁。
+class KvStore {
+ public:
+  struct Options {
+    // 映射区域首次创建的大小，之后按需翻倍（最多每次增加 256MB）
+    uint64_t initial_capacity = 1ull << 20;
+    // 失效字节数超过这个值且超过存活字节数时自动压缩
+    uint64_t compaction_min_dead_bytes = 4ull << 20;
+  };
+
+  struct Stats {
+    uint64_t entries = 0;
+    uint64_t live_bytes = 0;   // 存活记录占用的日志字节数
+    uint64_t dead_bytes = 0;   // 被覆盖或删除的记录占用的字节数
+    uint64_t file_bytes = 0;   // 日志的有效长度
+    uint64_t compactions = 0;
+  };
+
+  // |key| 为发生变化的键，|deleted| 表示键被删除。
+  using ChangeCallback = std::function<void(std::string_view key,
+                                            bool deleted)>;
+
+  // 单个值的上限。
+  static constexpr uint32_t kMaxValueSize = 256u << 20;
+  static constexpr uint32_t kMaxKeySize = 4096;
+
+  KvStore(std::filesystem::path directory, const Options& options);
+  ~KvStore();
+
+  KvStore(const KvStore&) = delete;
+  KvStore& operator=(const KvStore&) = delete;
+
+  // 创建目录、映射日志并重建索引。
+  bool Open();
+
+  // 以下方法可以在多个线程上同时调用。
+
+  bool Get(std::string_view key, std::vector<uint8_t>* value) const;
+  bool Contains(std::string_view key) const;
+
+  // 键不能为空，长度不超过 kMaxKeySize。
+  bool Put(std::string_view key, const void* data, size_t size);
+  bool Remove(std::string_view key);
+
+  // 删除所有以 |prefix| 开头的键，返回删除的数量。
+  size_t RemovePrefix(std::string_view prefix);
+
+  // 按键的字典序返回以 |prefix| 开头的键，最多 |limit| 个（0 表示不限）。
+  std::vector<std::string> Keys(std::string_view prefix, size_t limit) const;
+
+  // 按键的字典序对以 |prefix| 开头的每个键值调用 |visitor|，返回 false
+  // 时停止。|visitor| 在持有读锁时调用，不能再调用本对象的写方法。
+  void Scan(std::string_view prefix,
+            const std::function<bool(std::string_view key,
+                                     const uint8_t* value,
+                                     size_t size)>& visitor) const;
+
+  // 订阅以 |prefix| 开头的键的变化（空前缀表示全部），返回订阅 ID。
+  uint64_t Subscribe(std::string prefix, ChangeCallback callback);
+  void Unsubscribe(uint64_t subscription);
+
+  // 立即压缩日志。
+  bool Compact();
+
+  // 把已修改的页写回磁盘，并记录之后打开时无需校验的位置。
+  void Flush();
+
+  Stats stats() const;
+
+ private:
+  struct Location {
+    uint64_t offset = 0;        // 记录在日志中的偏移
+    uint32_t value_size = 0;
+    uint32_t record_size = 0;   // 含头部和填充
+  };
+  struct Subscription {
+    uint64_t id = 0;
+    std::string prefix;
+    std::shared_ptr<ChangeCallback> callback;
+  };
+
+  // 以下方法要求持有 mutex_ 的写锁。
+  bool EnsureCapacityLocked(uint64_t required);
+  bool AppendLocked(std::string_view key,
+                    const void* data,
+                    size_t size,
+                    bool tombstone,
+                    Location* location);
+  void ReplaceLocked(std::string_view key, const Location* location);
+  bool CompactLocked();
+  // 重新映射失败后恢复到 |capacity|，仍然失败时清空索引。
+  void RestoreMappingLocked(uint64_t capacity);
+  void WriteHeaderLocked(uint64_t clean_end);
+  bool ShouldCompactLocked() const;
+
+  bool MapLog(uint64_t capacity);
+  void LoadLog();
+
+  void Notify(std::string_view key, bool deleted);
+
+  const std::filesystem::path directory_;
+  const std::filesystem::path log_path_;
+  const Options options_;
+
+  mutable std::shared_mutex mutex_;
+  MappedFile log_;
+  uint64_t end_ = 0;           // 下一条记录的写入位置
+  uint64_t next_sequence_ = 1;
+  uint64_t live_bytes_ = 0;
+  uint64_t dead_bytes_ = 0;
+  uint64_t compactions_ = 0;
+  std::map<std::string, Location, std::less<>> index_;
+
+  std::mutex subscription_mutex_;
+  uint64_t next_subscription_ = 1;
+  std::vector<Subscription> subscriptions_;
+};
+
+#endif  // RUNNER_KV_STORE_H_
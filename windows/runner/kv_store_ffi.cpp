@@ -0,0 +1,227 @@
+#include "kv_store_ffi.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "kv_store.h"
+#include "memory_telemetry.h"
+#include "utils.h"
+
+namespace {
+
+constexpr wchar_t kKvStoreDirName[] = L"kv_store";
+
+bool IsValidStoreName(const std::string& name) {
+  if (name.empty() || name.size() > 64) {
+    return false;
+  }
+  for (char c : name) {
+    const bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                       (c >= '0' && c <= '9') || c == '_' || c == '-';
+    if (!valid) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 不析构：Dart 侧可能在任何时候持有句柄
+std::mutex& RegistryMutex() {
+  static std::mutex* mutex = new std::mutex();
+  return *mutex;
+}
+
+std::map<std::string, KvStore*>& Registry() {
+  static auto* stores = new std::map<std::string, KvStore*>();
+  return *stores;
+}
+
+KvStore* AsStore(void* store) {
+  return static_cast<KvStore*>(store);
+}
+
+}  // namespace
+
+KvStore* OpenNamedKvStore(const std::string& name) {
+  if (!IsValidStoreName(name)) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(RegistryMutex());
+  auto& stores = Registry();
+  auto it = stores.find(name);
+  if (it != stores.end()) {
+    return it->second;
+  }
+  const std::wstring app_data_dir = GetAppDataDirectory();
+  if (app_data_dir.empty()) {
+    return nullptr;
+  }
+  auto store = std::make_unique<KvStore>(
+      std::filesystem::path(app_data_dir) / kKvStoreDirName /
+          Utf16FromUtf8(name),
+      KvStore::Options());
+  if (!store->Open()) {
+    return nullptr;
+  }
+  KvStore* raw = store.release();
+  stores.emplace(name, raw);
+  // 日志整个映射进内存，按有效长度计
+  MemoryTelemetry::GetInstance().RegisterCounter("kv." + name, [raw]() {
+    return static_cast<int64_t>(raw->stats().file_bytes);
+  });
+  return raw;
+}
+
+void FlushNamedKvStores() {
+  std::lock_guard<std::mutex> lock(RegistryMutex());
+  for (const auto& [name, store] : Registry()) {
+    store->Flush();
+  }
+}
+
+void* runner_kv_open(const char* name) {
+  if (!name) {
+    return nullptr;
+  }
+  return OpenNamedKvStore(name);
+}
+
+uint8_t* runner_kv_get(void* store, const char* key, int64_t* size) {
+  std::vector<uint8_t> value;
+  if (!store || !key || !AsStore(store)->Get(key, &value)) {
+    return nullptr;
+  }
+  auto* data = static_cast<uint8_t*>(
+      runner_kv_alloc(static_cast<int64_t>(value.size())));
+  if (!data) {
+    return nullptr;
+  }
+  if (!value.empty()) {
+    std::memcpy(data, value.data(), value.size());
+  }
+  *size = static_cast<int64_t>(value.size());
+  return data;
+}
+
+int32_t runner_kv_put(void* store,
+                      const char* key,
+                      const uint8_t* data,
+                      int64_t size) {
+  if (!store || !key || size < 0 || (size > 0 && !data)) {
+    return 0;
+  }
+  return AsStore(store)->Put(key, data, static_cast<size_t>(size)) ? 1 : 0;
+}
+
+int32_t runner_kv_remove(void* store, const char* key) {
+  if (!store || !key) {
+    return 0;
+  }
+  return AsStore(store)->Remove(key) ? 1 : 0;
+}
+
+int64_t runner_kv_remove_prefix(void* store, const char* prefix) {
+  if (!store || !prefix) {
+    return 0;
+  }
+  return static_cast<int64_t>(AsStore(store)->RemovePrefix(prefix));
+}
+
+char* runner_kv_keys(void* store,
+                     const char* prefix,
+                     int32_t limit,
+                     int64_t* size) {
+  if (!store || !prefix) {
+    return nullptr;
+  }
+  const std::vector<std::string> keys = AsStore(store)->Keys(
+      prefix, limit > 0 ? static_cast<size_t>(limit) : 0);
+  if (keys.empty()) {
+    return nullptr;
+  }
+  size_t total = 0;
+  for (const auto& key : keys) {
+    total += key.size() + 1;
+  }
+  auto* buffer =
+      static_cast<char*>(runner_kv_alloc(static_cast<int64_t>(total)));
+  if (!buffer) {
+    return nullptr;
+  }
+  char* cursor = buffer;
+  for (const auto& key : keys) {
+    std::memcpy(cursor, key.data(), key.size());
+    cursor[key.size()] = '\0';
+    cursor += key.size() + 1;
+  }
+  *size = static_cast<int64_t>(total);
+  return buffer;
+}
+
+int64_t runner_kv_subscribe(void* store,
+                            const char* prefix,
+                            RunnerKvChangeCallback callback) {
+  if (!store || !prefix || !callback) {
+    return 0;
+  }
+  const uint64_t subscription = AsStore(store)->Subscribe(
+      prefix, [callback](std::string_view key, bool deleted) {
+        auto* copy = static_cast<char*>(
+            runner_kv_alloc(static_cast<int64_t>(key.size())));
+        if (!copy) {
+          return;
+        }
+        std::memcpy(copy, key.data(), key.size());
+        callback(copy, static_cast<int32_t>(key.size()), deleted ? 1 : 0);
+      });
+  return static_cast<int64_t>(subscription);
+}
+
+void runner_kv_unsubscribe(void* store, int64_t subscription) {
+  if (store && subscription > 0) {
+    AsStore(store)->Unsubscribe(static_cast<uint64_t>(subscription));
+  }
+}
+
+void runner_kv_flush(void* store) {
+  if (store) {
+    AsStore(store)->Flush();
+  }
+}
+
+int32_t runner_kv_compact(void* store) {
+  if (!store) {
+    return 0;
+  }
+  return AsStore(store)->Compact() ? 1 : 0;
+}
+
+void runner_kv_stats(void* store, RunnerKvStats* stats) {
+  KvStore::Stats values;
+  if (store) {
+    values = AsStore(store)->stats();
+  }
+  stats->entries = static_cast<int64_t>(values.entries);
+  stats->live_bytes = static_cast<int64_t>(values.live_bytes);
+  stats->dead_bytes = static_cast<int64_t>(values.dead_bytes);
+  stats->file_bytes = static_cast<int64_t>(values.file_bytes);
+  stats->compactions = static_cast<int64_t>(values.compactions);
+}
+
+void* runner_kv_alloc(int64_t size) {
+  if (size < 0) {
+    return nullptr;
+  }
+  // 长度为 0 时也返回有效指针，便于区分“空值”和“未命中”
+  return std::malloc(size > 0 ? static_cast<size_t>(size) : 1);
+}
+
+void runner_kv_free(void* pointer) {
+  std::free(pointer);
+}
@@ -0,0 +1,82 @@
+#ifndef RUNNER_KV_STORE_FFI_H_
+#define RUNNER_KV_STORE_FFI_H_
+
+#include <cstdint>
+#include <string>
+
+#include "ffi_export.h"
+
+class KvStore;
+
+// KvStore 的 C 接口，供 lib/windows/native/native_kv_store.dart 使用。
+// 结构体布局必须和 Dart 侧的 Struct 定义一致。
+//
+// 存储按名称打开，位于 %LOCALAPPDATA%\suxingchahui\kv_store\<name>，
+// 同名存储只打开一次，句柄在进程退出前一直有效。字符串均为 UTF-8。
+
+struct RunnerKvStats {
+  int64_t entries;
+  int64_t live_bytes;
+  int64_t dead_bytes;
+  int64_t file_bytes;
+  int64_t compactions;
+};
+
+// 键变化的回调，可能在任意线程上调用。|key| 由 runner_kv_alloc 分配，
+// 接收方用完后调用 runner_kv_free 释放。
+typedef void (*RunnerKvChangeCallback)(char* key,
+                                       int32_t key_length,
+                                       int32_t deleted);
+
+// 打开（或取得已经打开的）同名存储，失败时返回 nullptr。
+// |name| 只能包含字母、数字、'_' 和 '-'。
+KvStore* OpenNamedKvStore(const std::string& name);
+
+// 把所有已打开的存储写回磁盘，在 Flutter 引擎关闭后调用。
+void FlushNamedKvStores();
+
+RUNNER_FFI_EXPORT void* runner_kv_open(const char* name);
+
+// 命中时返回用 runner_kv_alloc 分配的值（长度写入 |size|，值为空时
+// 也返回非空指针），未命中返回 nullptr。
+RUNNER_FFI_EXPORT uint8_t* runner_kv_get(void* store,
+                                         const char* key,
+                                         int64_t* size);
+
+RUNNER_FFI_EXPORT int32_t runner_kv_put(void* store,
+                                        const char* key,
+                                        const uint8_t* data,
+                                        int64_t size);
+
+RUNNER_FFI_EXPORT int32_t runner_kv_remove(void* store, const char* key);
+
+RUNNER_FFI_EXPORT int64_t runner_kv_remove_prefix(void* store,
+                                                  const char* prefix);
+
+// 返回以 |prefix| 开头的键，以 '\0' 分隔，总字节数写入 |size|。
+// 结果由 runner_kv_alloc 分配，没有键时返回 nullptr。
+RUNNER_FFI_EXPORT char* runner_kv_keys(void* store,
+                                       const char* prefix,
+                                       int32_t limit,
+                                       int64_t* size);
+
+// 返回订阅 ID，失败时返回 0。取消订阅之前 |callback| 必须一直有效。
+RUNNER_FFI_EXPORT int64_t runner_kv_subscribe(void* store,
+                                              const char* prefix,
+                                              RunnerKvChangeCallback callback);
+
+RUNNER_FFI_EXPORT void runner_kv_unsubscribe(void* store,
+                                             int64_t subscription);
+
+RUNNER_FFI_EXPORT void runner_kv_flush(void* store);
+
+RUNNER_FFI_EXPORT int32_t runner_kv_compact(void* store);
+
+RUNNER_FFI_EXPORT void runner_kv_stats(void* store, RunnerKvStats* stats);
+
+RUNNER_FFI_EXPORT void* runner_kv_alloc(int64_t size);
+
+// 可以作为 Dart NativeFinalizer 的回调。
+RUNNER_FFI_EXPORT void runner_kv_free(void* pointer);
+
+#endif  // RUNNER_KV_STORE_FFI_H_
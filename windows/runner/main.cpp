@@ -4,39 +4,102 @@
 #include "flutter_window.h"
 #include "utils.h"
 #include "pre_init_window.h"
+#include "file_prefetcher.h"
+#include "hang_watchdog.h"
+#include "memory_telemetry.h"
+#include "platform_hang_watchdog.h"
+#include "startup_trace.h"
+
+namespace {
+
+// Upper bound for the startup prefetch; flutter_assets may hold large media.
+constexpr uint64_t kMaxPrefetchBytes = 256ull << 20;
+
+// Starts reading the engine's files into the file cache so that disk I/O
+// overlaps the pre-init checks instead of following them.
+void StartPrefetch(FilePrefetcher* prefetcher) {
+const std::wstring exe_dir = GetExecutableDirectory();
+if (!GetRunnerFlags().prefetch || exe_dir.empty()) {
+return;
+}
+std::vector<std::filesystem::path> entries;
+const std::string& list_file = GetRunnerFlags().prefetch_list;
+if (!list_file.empty()) {
+entries = FilePrefetcher::ReadList(std::filesystem::u8path(list_file));
+} else {
+for (const auto& resource : PreInitWindow::GetPrefetchResources()) {
+entries.emplace_back(resource);
+}
+}
+prefetcher->Start(exe_dir, std::move(entries), kMaxPrefetchBytes);
+}
+
+}  // namespace
 
 int APIENTRY wWinMain(_In_ HINSTANCE instance, _In_opt_ HINSTANCE prev,
         _In_ wchar_t *command_line, _In_ int show_command) {
+// Parse arguments first so runner flags (e.g. --startup-trace) apply to the
+// whole startup path.
+std::vector<std::string> command_line_arguments = GetCommandLineArguments();
+ScopedTraceFlush trace_flush;
+if (GetRunnerFlags().write_bundle_manifest) {
+return PreInitWindow::WriteBundleManifest() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+FilePrefetcher prefetcher;
+StartPrefetch(&prefetcher);
+StartupTrace::GetInstance().SetCurrentThreadName("platform");
+StartupTrace::GetInstance().WatchCurrentThread();
+StartPlatformHangWatchdog(GetRunnerFlags().hang_threshold_ms);
+if (GetRunnerFlags().memory_sample_ms > 0) {
+MemoryTelemetry::GetInstance().Start(GetRunnerFlags().memory_sample_ms);
+}
+StartupTrace::GetInstance().AddInstant("wWinMain", "startup");
+
 // Run pre-menu check
+{
+ScopedTraceSpan span("PreInitWindow::ShowPreInitCheck", "startup");
 if (!PreInitWindow::ShowPreInitCheck()) {
 return EXIT_FAILURE;
 }
+}
 
 // Initialize Flutter environment
 if (!::AttachConsole(ATTACH_PARENT_PROCESS) && ::IsDebuggerPresent()) {
 CreateAndAttachConsole();
 }
 
+{
+ScopedTraceSpan span("CoInitializeEx", "startup");
 ::CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+}
 
 flutter::DartProject project(L"data");
-std::vector<std::string> command_line_arguments = GetCommandLineArguments();
 project.set_dart_entrypoint_arguments(std::move(command_line_arguments));
 
 FlutterWindow window(project);
 Win32Window::Point origin(10, 10);
 Win32Window::Size size(1280, 720);
+{
+ScopedTraceSpan span("FlutterWindow::Create", "startup");
 if (!window.Create(L"suxingchahui", origin, size)) {
 return EXIT_FAILURE;
 }
+}
 window.SetQuitOnClose(true);
 
+// Only time spent outside GetMessage counts towards a stall.
+HangWatchdog& hang_watchdog = HangWatchdog::GetInstance();
 ::MSG msg;
+hang_watchdog.Idle();
 while (::GetMessage(&msg, nullptr, 0, 0)) {
+hang_watchdog.Busy(msg.message);
 ::TranslateMessage(&msg);
 ::DispatchMessage(&msg);
+hang_watchdog.Idle();
 }
 
+MemoryTelemetry::GetInstance().Stop();
+StopPlatformHangWatchdog();
 ::CoUninitialize();
 return EXIT_SUCCESS;
 }
\ No newline at end of file
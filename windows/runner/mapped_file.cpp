@@ -0,0 +1,195 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+  Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::filesystem::path& path) {
+  Close();
+  HANDLE file = ::CreateFileW(path.c_str(), GENERIC_READ,
+                              FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  LARGE_INTEGER file_size;
+  if (!::GetFileSizeEx(file, &file_size)) {
+    ::CloseHandle(file);
+    return false;
+  }
+  file_handle_ = file;
+  size_ = static_cast<size_t>(file_size.QuadPart);
+  is_open_ = true;
+  if (size_ == 0) {
+    // 空文件不能创建映射
+    return true;
+  }
+  HANDLE mapping =
+      ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping) {
+    Close();
+    return false;
+  }
+  mapping_handle_ = mapping;
+  data_ = static_cast<uint8_t*>(
+      ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  if (!data_) {
+    Close();
+    return false;
+  }
+  return true;
+}
+
+bool MappedFile::OpenWritable(const std::filesystem::path& path, size_t size) {
+  Close();
+  if (size == 0) {
+    return false;
+  }
+  HANDLE file = ::CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                              FILE_SHARE_READ, nullptr, OPEN_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  file_handle_ = file;
+  is_open_ = true;
+  LARGE_INTEGER file_size;
+  file_size.QuadPart = static_cast<LONGLONG>(size);
+  if (!::SetFilePointerEx(file, file_size, nullptr, FILE_BEGIN) ||
+      !::SetEndOfFile(file)) {
+    Close();
+    return false;
+  }
+  HANDLE mapping = ::CreateFileMappingW(
+      file, nullptr, PAGE_READWRITE, static_cast<DWORD>(file_size.HighPart),
+      file_size.LowPart, nullptr);
+  if (!mapping) {
+    Close();
+    return false;
+  }
+  mapping_handle_ = mapping;
+  data_ = static_cast<uint8_t*>(
+      ::MapViewOfFile(mapping, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, 0));
+  if (!data_) {
+    Close();
+    return false;
+  }
+  size_ = size;
+  writable_ = true;
+  return true;
+}
+
+bool MappedFile::Flush() {
+  if (!data_ || !writable_) {
+    return true;
+  }
+  return ::FlushViewOfFile(data_, 0) != FALSE;
+}
+
+void MappedFile::Close() {
+  if (data_) {
+    ::UnmapViewOfFile(data_);
+    data_ = nullptr;
+  }
+  if (mapping_handle_) {
+    ::CloseHandle(mapping_handle_);
+    mapping_handle_ = nullptr;
+  }
+  if (file_handle_) {
+    ::CloseHandle(file_handle_);
+    file_handle_ = nullptr;
+  }
+  size_ = 0;
+  is_open_ = false;
+  writable_ = false;
+}
+
+#else
+
+bool MappedFile::Open(const std::filesystem::path& path) {
+  Close();
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    return false;
+  }
+  fd_ = fd;
+  size_ = static_cast<size_t>(st.st_size);
+  is_open_ = true;
+  if (size_ == 0) {
+    return true;
+  }
+  void* address = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (address == MAP_FAILED) {
+    Close();
+    return false;
+  }
+  ::madvise(address, size_, MADV_SEQUENTIAL);
+  data_ = static_cast<uint8_t*>(address);
+  return true;
+}
+
+bool MappedFile::OpenWritable(const std::filesystem::path& path, size_t size) {
+  Close();
+  if (size == 0) {
+    return false;
+  }
+  const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return false;
+  }
+  fd_ = fd;
+  is_open_ = true;
+  if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    Close();
+    return false;
+  }
+  void* address =
+      ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (address == MAP_FAILED) {
+    Close();
+    return false;
+  }
+  data_ = static_cast<uint8_t*>(address);
+  size_ = size;
+  writable_ = true;
+  return true;
+}
+
+bool MappedFile::Flush() {
+  if (!data_ || !writable_) {
+    return true;
+  }
+  return ::msync(data_, size_, MS_ASYNC) == 0;
+}
+
+void MappedFile::Close() {
+  if (data_) {
+    ::munmap(data_, size_);
+    data_ = nullptr;
+  }
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+  size_ = 0;
+  is_open_ = false;
+  writable_ = false;
+}
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef RUNNER_MAPPED_FILE_H_
+#define RUNNER_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+// 内存映射文件。Windows 使用 CreateFileMapping，其它平台使用 mmap。
+class MappedFile {
+ public:
+  MappedFile() = default;
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  // 映射 |path| 的全部内容。空文件也会成功，此时 data() 为 nullptr。
+  bool Open(const std::filesystem::path& path);
+  // 以读写方式映射 |path|，文件不存在时创建，并把文件大小调整为 |size|
+  // （扩展出的部分为 0）。修改直接写回文件。
+  bool OpenWritable(const std::filesystem::path& path, size_t size);
+  void Close();
+
+  // 把已修改的页异步写回磁盘。
+  bool Flush();
+
+  const uint8_t* data() const { return data_; }
+  // 只读映射时为 nullptr。
+  uint8_t* mutable_data() { return writable_ ? data_ : nullptr; }
+  size_t size() const { return size_; }
+  bool is_open() const { return is_open_; }
+
+ private:
+  uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  bool is_open_ = false;
+  bool writable_ = false;
+#ifdef _WIN32
+  void* file_handle_ = nullptr;
+  void* mapping_handle_ = nullptr;
+#else
+  int fd_ = -1;
+#endif
+};
+
+#endif  // RUNNER_MAPPED_FILE_H_
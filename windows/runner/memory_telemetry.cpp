@@ -0,0 +1,284 @@
+#include "memory_telemetry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <cstdlib>
+#include <cstring>
+#endif
+
+namespace {
+
+int64_t NowUnixMillis() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+// 标签会写进 CSV 的表头，只允许字母、数字、'.'、'_' 和 '-'。
+bool IsValidLabel(const std::string& label) {
+  if (label.empty() || label.size() > 64) {
+    return false;
+  }
+  for (char c : label) {
+    const bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                       (c >= '0' && c <= '9') || c == '.' || c == '_' ||
+                       c == '-';
+    if (!valid) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+#ifdef _WIN32
+
+bool SampleProcessMemory(ProcessMemory* memory) {
+  const HANDLE process = GetCurrentProcess();
+  PROCESS_MEMORY_COUNTERS_EX counters = {};
+  counters.cb = sizeof(counters);
+  if (!GetProcessMemoryInfo(
+          process, reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters),
+          sizeof(counters))) {
+    return false;
+  }
+  memory->working_set = counters.WorkingSetSize;
+  memory->private_bytes = counters.PrivateUsage;
+
+  // 已提交页包括映射的缓存文件和模块，逐个区域累加
+  uint64_t committed = 0;
+  MEMORY_BASIC_INFORMATION region;
+  const uint8_t* address = nullptr;
+  while (VirtualQuery(address, &region, sizeof(region)) == sizeof(region)) {
+    if (region.State == MEM_COMMIT) {
+      committed += region.RegionSize;
+    }
+    const uint8_t* next =
+        static_cast<const uint8_t*>(region.BaseAddress) + region.RegionSize;
+    if (next <= address) {
+      break;
+    }
+    address = next;
+  }
+  memory->commit = committed;
+
+  DWORD handles = 0;
+  memory->handles = GetProcessHandleCount(process, &handles) ? handles : 0;
+  return true;
+}
+
+#else
+
+bool SampleProcessMemory(ProcessMemory* memory) {
+  std::ifstream status("/proc/self/status");
+  if (!status) {
+    return false;
+  }
+  uint64_t rss_anon_kb = 0;
+  uint64_t swap_kb = 0;
+  std::string line;
+  while (std::getline(status, line)) {
+    const size_t colon = line.find(':');
+    if (colon == std::string::npos) {
+      continue;
+    }
+    const uint64_t kb = std::strtoull(line.c_str() + colon + 1, nullptr, 10);
+    if (line.compare(0, colon, "VmRSS") == 0) {
+      memory->working_set = kb << 10;
+    } else if (line.compare(0, colon, "VmSize") == 0) {
+      memory->commit = kb << 10;
+    } else if (line.compare(0, colon, "RssAnon") == 0) {
+      rss_anon_kb = kb;
+    } else if (line.compare(0, colon, "VmSwap") == 0) {
+      swap_kb = kb;
+    }
+  }
+  memory->private_bytes = (rss_anon_kb + swap_kb) << 10;
+
+  std::error_code error;
+  uint64_t handles = 0;
+  for (std::filesystem::directory_iterator it("/proc/self/fd", error), end;
+       !error && it != end; it.increment(error)) {
+    ++handles;
+  }
+  memory->handles = handles;
+  return true;
+}
+
+#endif
+
+MemoryTelemetry& MemoryTelemetry::GetInstance() {
+  static MemoryTelemetry instance;
+  return instance;
+}
+
+MemoryTelemetry::MemoryTelemetry(size_t capacity)
+    : capacity_(std::max<size_t>(capacity, 1)) {}
+
+MemoryTelemetry::~MemoryTelemetry() {
+  Stop();
+}
+
+bool MemoryTelemetry::RegisterCounter(const std::string& label,
+                                      CounterReader reader) {
+  if (!IsValidLabel(label)) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (Counter& counter : counters_) {
+    if (counter.label == label) {
+      counter.reader = std::move(reader);
+      return true;
+    }
+  }
+  if (counters_.size() >= kMaxCounters) {
+    return false;
+  }
+  counters_.push_back({label, std::move(reader), 0});
+  return true;
+}
+
+bool MemoryTelemetry::SetCounter(const std::string& label, int64_t value) {
+  if (!IsValidLabel(label)) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (Counter& counter : counters_) {
+    if (counter.label == label) {
+      counter.reader = nullptr;
+      counter.value = value;
+      return true;
+    }
+  }
+  if (counters_.size() >= kMaxCounters) {
+    return false;
+  }
+  counters_.push_back({label, nullptr, value});
+  return true;
+}
+
+std::vector<std::string> MemoryTelemetry::CounterLabels() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<std::string> labels;
+  labels.reserve(counters_.size());
+  for (const Counter& counter : counters_) {
+    labels.push_back(counter.label);
+  }
+  return labels;
+}
+
+void MemoryTelemetry::Start(int64_t interval_ms) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  interval_ms_ = std::max<int64_t>(interval_ms, 1);
+  if (thread_.joinable()) {
+    interval_changed_ = true;
+    wake_.notify_one();
+    return;
+  }
+  stopping_ = false;
+  thread_ = std::thread([this]() { Run(); });
+}
+
+void MemoryTelemetry::Stop() {
+  std::thread thread;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+    thread = std::move(thread_);
+  }
+  wake_.notify_one();
+  if (thread.joinable()) {
+    thread.join();
+  }
+}
+
+bool MemoryTelemetry::running() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return thread_.joinable() && !stopping_;
+}
+
+int64_t MemoryTelemetry::interval_ms() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return interval_ms_;
+}
+
+void MemoryTelemetry::SampleNow() {
+  Row row;
+  row.time_ms = NowUnixMillis();
+  SampleProcessMemory(&row.process);
+
+  // 读取函数可能要拿子系统自己的锁，不在持有 mutex_ 时调用
+  std::vector<Counter> counters;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters = counters_;
+  }
+  for (size_t i = 0; i < counters.size(); ++i) {
+    row.counters[i] =
+        counters[i].reader ? counters[i].reader() : counters[i].value;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (rows_.empty()) {
+    rows_.resize(capacity_);
+  }
+  row.sequence = next_sequence_++;
+  rows_[row.sequence % capacity_] = row;
+}
+
+std::vector<MemoryTelemetry::Row> MemoryTelemetry::Rows(uint64_t after) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<Row> rows;
+  const uint64_t last = next_sequence_ - 1;
+  const uint64_t oldest = last >= capacity_ ? last - capacity_ + 1 : 1;
+  for (uint64_t sequence = std::max(after + 1, oldest); sequence <= last;
+       ++sequence) {
+    rows.push_back(rows_[sequence % capacity_]);
+  }
+  return rows;
+}
+
+bool MemoryTelemetry::WriteCsv(const std::filesystem::path& path) const {
+  const std::vector<std::string> labels = CounterLabels();
+  const std::vector<Row> rows = Rows(0);
+
+  std::ofstream out(path, std::ios::out | std::ios::trunc);
+  if (!out) {
+    return false;
+  }
+  out << "sequence,time_ms,working_set,private_bytes,commit,handles";
+  for (const std::string& label : labels) {
+    out << ',' << label;
+  }
+  out << '\n';
+  for (const Row& row : rows) {
+    out << row.sequence << ',' << row.time_ms << ',' << row.process.working_set
+        << ',' << row.process.private_bytes << ',' << row.process.commit << ','
+        << row.process.handles;
+    for (size_t i = 0; i < labels.size(); ++i) {
+      out << ',' << row.counters[i];
+    }
+    out << '\n';
+  }
+  return static_cast<bool>(out);
+}
+
+void MemoryTelemetry::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    lock.unlock();
+    SampleNow();
+    lock.lock();
+    interval_changed_ = false;
+    wake_.wait_for(lock, std::chrono::milliseconds(interval_ms_),
+                   [this]() { return stopping_ || interval_changed_; });
+  }
+}
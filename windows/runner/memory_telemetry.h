@@ -0,0 +1,104 @@
+#ifndef RUNNER_MEMORY_TELEMETRY_H_
+#define RUNNER_MEMORY_TELEMETRY_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 进程级的内存数据。Windows 上 commit 是所有已提交页（含映射文件和
+// 模块），private_bytes 是私有提交；Linux 没有提交的概念，commit 取
+// VmSize，private_bytes 取 RssAnon + VmSwap，handles 为打开的文件描述符数。
+struct ProcessMemory {
+  uint64_t working_set = 0;
+  uint64_t private_bytes = 0;
+  uint64_t commit = 0;
+  uint64_t handles = 0;
+};
+
+// 读取当前进程的内存数据，失败时返回 false。
+bool SampleProcessMemory(ProcessMemory* memory);
+
+// 周期性的内存采样（与平台无关，进程数据来自 SampleProcessMemory）。
+//
+// 采样线程按固定间隔记录进程内存和各子系统登记的计数器，写入固定大小
+// 的环形缓冲区，写满后覆盖最早的记录。计数器有两种：登记读取函数的，
+// 在采样线程上调用（必须线程安全，不能调用本类）；由外部推送数值的，
+// 例如 Dart 侧的图片缓存大小。计数器数量有上限，登记后不能注销，同名
+// 登记会替换读取函数。标签会写进 CSV 表头，只能包含字母、数字、'.'、
+// '_' 和 '-'。
+class MemoryTelemetry {
+ public:
+  static constexpr size_t kDefaultCapacity = 2048;
+  static constexpr size_t kMaxCounters = 24;
+
+  using CounterReader = std::function<int64_t()>;
+
+  struct Row {
+    uint64_t sequence = 0;  // 从 1 开始递增
+    int64_t time_ms = 0;    // Unix 时间，毫秒
+    ProcessMemory process;
+    int64_t counters[kMaxCounters] = {};  // 与 CounterLabels() 的顺序一致
+  };
+
+  static MemoryTelemetry& GetInstance();
+
+  explicit MemoryTelemetry(size_t capacity = kDefaultCapacity);
+  ~MemoryTelemetry();
+
+  MemoryTelemetry(const MemoryTelemetry&) = delete;
+  MemoryTelemetry& operator=(const MemoryTelemetry&) = delete;
+
+  // 登记或替换名为 |label| 的计数器。标签无效或已满时返回 false。
+  bool RegisterCounter(const std::string& label, CounterReader reader);
+
+  // 设置外部推送的计数器，不存在时登记。标签无效或已满时返回 false。
+  bool SetCounter(const std::string& label, int64_t value);
+
+  std::vector<std::string> CounterLabels() const;
+
+  // 启动采样线程；已经启动时修改间隔，立即记录一行后按新间隔继续。
+  void Start(int64_t interval_ms);
+  void Stop();
+  bool running() const;
+  int64_t interval_ms() const;
+  size_t capacity() const { return capacity_; }
+
+  // 立即记录一行，可以在任意线程调用。
+  void SampleNow();
+
+  // 返回序号大于 |after| 的记录，从旧到新。
+  std::vector<Row> Rows(uint64_t after) const;
+
+  // 以 CSV 写出全部记录，第一行为列名。
+  bool WriteCsv(const std::filesystem::path& path) const;
+
+ private:
+  struct Counter {
+    std::string label;
+    CounterReader reader;  // 为空时使用 value
+    int64_t value = 0;
+  };
+
+  void Run();
+
+  const size_t capacity_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;
+  std::vector<Counter> counters_;
+  std::vector<Row> rows_;  // 第一次采样时分配
+  uint64_t next_sequence_ = 1;
+  int64_t interval_ms_ = 0;
+  bool stopping_ = false;
+  bool interval_changed_ = false;
+  std::thread thread_;
+};
+
+#endif  // RUNNER_MEMORY_TELEMETRY_H_
@@ -0,0 +1,165 @@
+#include "memory_telemetry_channel.h"
+
+#include <flutter/standard_method_codec.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "game_column_store.h"
+#include "memory_telemetry.h"
+#include "method_channel_utils.h"
+#include "object_id_table.h"
+#include "utils.h"
+
+namespace {
+
+constexpr char kChannelName[] = "com.example.suxingchahui/memory_telemetry";
+constexpr wchar_t kDumpFileName[] = L"memory_telemetry.csv";
+constexpr int64_t kColumnsBeforeCounters = 6;
+
+using flutter::EncodableList;
+using flutter::EncodableMap;
+using flutter::EncodableValue;
+
+EncodableValue EncodeLabels(const std::vector<std::string>& labels) {
+  EncodableList list;
+  list.reserve(labels.size());
+  for (const std::string& label : labels) {
+    list.emplace_back(label);
+  }
+  return EncodableValue(std::move(list));
+}
+
+int64_t Clamp(uint64_t value) {
+  return value > static_cast<uint64_t>(INT64_MAX) ? INT64_MAX
+                                                  : static_cast<int64_t>(value);
+}
+
+}  // namespace
+
+MemoryTelemetryChannel::MemoryTelemetryChannel(
+    flutter::BinaryMessenger* messenger)
+    : channel_(std::make_unique<flutter::MethodChannel<EncodableValue>>(
+          messenger, kChannelName,
+          &flutter::StandardMethodCodec::GetInstance())) {
+  // 进程级的单例在这里登记；按名称打开的存储和索引在各自打开时登记
+  MemoryTelemetry& telemetry = MemoryTelemetry::GetInstance();
+  telemetry.RegisterCounter("object_ids", []() {
+    return static_cast<int64_t>(GlobalObjectIdTable().memory_bytes());
+  });
+  telemetry.RegisterCounter("games.index", []() {
+    return Clamp(GlobalGameColumnStore().stats().index_bytes);
+  });
+
+  channel_->SetMethodCallHandler(
+      [this](const auto& call, auto result) {
+        HandleMethodCall(call, std::move(result));
+      });
+}
+
+void MemoryTelemetryChannel::HandleMethodCall(
+    const flutter::MethodCall<EncodableValue>& call,
+    std::unique_ptr<flutter::MethodResult<EncodableValue>> result) {
+  MemoryTelemetry& telemetry = MemoryTelemetry::GetInstance();
+  const std::string& method = call.method_name();
+
+  if (method == "status") {
+    EncodableMap status;
+    status[EncodableValue("running")] = EncodableValue(telemetry.running());
+    status[EncodableValue("intervalMs")] =
+        EncodableValue(telemetry.interval_ms());
+    status[EncodableValue("capacity")] =
+        EncodableValue(static_cast<int64_t>(telemetry.capacity()));
+    status[EncodableValue("labels")] = EncodeLabels(telemetry.CounterLabels());
+    result->Success(EncodableValue(std::move(status)));
+    return;
+  }
+
+  if (method == "start") {
+    const auto interval_ms = GetIntArgument(call.arguments(), "intervalMs");
+    if (!interval_ms || *interval_ms <= 0) {
+      result->Error("bad_args", "intervalMs must be positive");
+      return;
+    }
+    telemetry.Start(*interval_ms);
+    result->Success();
+    return;
+  }
+
+  if (method == "stop") {
+    telemetry.Stop();
+    result->Success();
+    return;
+  }
+
+  if (method == "sample") {
+    telemetry.SampleNow();
+    result->Success();
+    return;
+  }
+
+  if (method == "series") {
+    const int64_t after =
+        GetIntArgument(call.arguments(), "after").value_or(0);
+    // 先取标签：之后新登记的计数器不会出现在这一批里
+    const std::vector<std::string> labels = telemetry.CounterLabels();
+    const std::vector<MemoryTelemetry::Row> rows =
+        telemetry.Rows(after > 0 ? static_cast<uint64_t>(after) : 0);
+    const size_t columns = kColumnsBeforeCounters + labels.size();
+    std::vector<int64_t> values;
+    values.reserve(rows.size() * columns);
+    for (const MemoryTelemetry::Row& row : rows) {
+      values.push_back(static_cast<int64_t>(row.sequence));
+      values.push_back(row.time_ms);
+      values.push_back(Clamp(row.process.working_set));
+      values.push_back(Clamp(row.process.private_bytes));
+      values.push_back(Clamp(row.process.commit));
+      values.push_back(Clamp(row.process.handles));
+      values.insert(values.end(), row.counters, row.counters + labels.size());
+    }
+    EncodableMap series;
+    series[EncodableValue("labels")] = EncodeLabels(labels);
+    series[EncodableValue("columns")] =
+        EncodableValue(static_cast<int64_t>(columns));
+    series[EncodableValue("values")] = EncodableValue(std::move(values));
+    result->Success(EncodableValue(std::move(series)));
+    return;
+  }
+
+  if (method == "setCounter") {
+    const auto label = GetStringArgument(call.arguments(), "label");
+    const auto value = GetIntArgument(call.arguments(), "value");
+    if (!label || !value) {
+      result->Error("bad_args", "Missing label or value");
+      return;
+    }
+    result->Success(EncodableValue(telemetry.SetCounter(*label, *value)));
+    return;
+  }
+
+  if (method == "dump") {
+    std::filesystem::path path;
+    if (const auto requested = GetStringArgument(call.arguments(), "path")) {
+      path = std::filesystem::u8path(*requested);
+    } else {
+      const std::wstring app_data_dir = GetAppDataDirectory();
+      if (app_data_dir.empty()) {
+        result->Error("io_error", "App data directory is unavailable");
+        return;
+      }
+      path = std::filesystem::path(app_data_dir) / kDumpFileName;
+    }
+    // 最多几千行，直接在平台线程上写
+    if (!telemetry.WriteCsv(path)) {
+      result->Error("io_error", "Failed to write memory telemetry");
+      return;
+    }
+    result->Success(EncodableValue(path.u8string()));
+    return;
+  }
+
+  result->NotImplemented();
+}
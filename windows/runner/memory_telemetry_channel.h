@@ -0,0 +1,38 @@
+#ifndef RUNNER_MEMORY_TELEMETRY_CHANNEL_H_
+#define RUNNER_MEMORY_TELEMETRY_CHANNEL_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+#include <flutter/method_channel.h>
+
+#include <memory>
+
+// 让 Dart 查询和控制 MemoryTelemetry，供管理面板的内存监控页使用。
+//
+// 通道：com.example.suxingchahui/memory_telemetry
+//   status -> {running, intervalMs, capacity, labels: List<String>}
+//   start {intervalMs}
+//   stop
+//   sample                  立即记录一行
+//   series {after}          -> {labels, columns, values: Int64List}
+//       values 按行展开，每行依次为 sequence、timeMs、workingSet、
+//       privateBytes、commit、handles 和各计数器，只包含序号大于 after 的行
+//   setCounter {label, value} -> bool
+//   dump {path?}            -> String
+//       写出 CSV 并返回路径，不传 path 时写到应用数据目录
+class MemoryTelemetryChannel {
+ public:
+  explicit MemoryTelemetryChannel(flutter::BinaryMessenger* messenger);
+
+  MemoryTelemetryChannel(const MemoryTelemetryChannel&) = delete;
+  MemoryTelemetryChannel& operator=(const MemoryTelemetryChannel&) = delete;
+
+ private:
+  void HandleMethodCall(
+      const flutter::MethodCall<flutter::EncodableValue>& call,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> channel_;
+};
+
+#endif  // RUNNER_MEMORY_TELEMETRY_CHANNEL_H_
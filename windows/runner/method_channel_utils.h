@@ -0,0 +1,77 @@
+#ifndef RUNNER_METHOD_CHANNEL_UTILS_H_
+#define RUNNER_METHOD_CHANNEL_UTILS_H_
+
+#include <flutter/encodable_value.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <variant>
+
+// 读取 MethodCall 参数（Dart 侧传 Map）的辅助函数。
+
+// 返回 |arguments| 中 |key| 对应的值，不存在或参数不是 Map 时返回 nullptr。
+inline const flutter::EncodableValue* FindArgument(
+    const flutter::EncodableValue* arguments, const char* key) {
+  const auto* map = arguments
+                        ? std::get_if<flutter::EncodableMap>(arguments)
+                        : nullptr;
+  if (!map) {
+    return nullptr;
+  }
+  auto it = map->find(flutter::EncodableValue(key));
+  return it == map->end() ? nullptr : &it->second;
+}
+
+inline std::optional<std::string> GetStringArgument(
+    const flutter::EncodableValue* arguments, const char* key) {
+  const auto* value = FindArgument(arguments, key);
+  const auto* string_value = value ? std::get_if<std::string>(value) : nullptr;
+  if (!string_value) {
+    return std::nullopt;
+  }
+  return *string_value;
+}
+
+// Dart 的 int 会按大小编码为 int32 或 int64，这里统一转为 int64。
+inline std::optional<int64_t> GetIntArgument(
+    const flutter::EncodableValue* arguments, const char* key) {
+  const auto* value = FindArgument(arguments, key);
+  if (!value) {
+    return std::nullopt;
+  }
+  if (const auto* v = std::get_if<int32_t>(value)) {
+    return *v;
+  }
+  if (const auto* v = std::get_if<int64_t>(value)) {
+    return *v;
+  }
+  return std::nullopt;
+}
+
+inline std::optional<double> GetDoubleArgument(
+    const flutter::EncodableValue* arguments, const char* key) {
+  const auto* value = FindArgument(arguments, key);
+  if (!value) {
+    return std::nullopt;
+  }
+  if (const auto* v = std::get_if<double>(value)) {
+    return *v;
+  }
+  if (auto v = GetIntArgument(arguments, key)) {
+    return static_cast<double>(*v);
+  }
+  return std::nullopt;
+}
+
+inline std::optional<bool> GetBoolArgument(
+    const flutter::EncodableValue* arguments, const char* key) {
+  const auto* value = FindArgument(arguments, key);
+  const auto* bool_value = value ? std::get_if<bool>(value) : nullptr;
+  if (!bool_value) {
+    return std::nullopt;
+  }
+  return *bool_value;
+}
+
+#endif  // RUNNER_METHOD_CHANNEL_UTILS_H_
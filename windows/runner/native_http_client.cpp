@@ -0,0 +1,118 @@
+#include "native_http_client.h"
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <utility>
+
+#include "pre_init_window.h"
+#include "utils.h"
+#include "winhttp_connection.h"
+
+namespace {
+
+constexpr wchar_t kPrewarmOriginsFileName[] = L"http_prewarm.txt";
+
+HttpConnectionPool::Options PoolOptions() {
+  HttpConnectionPool::Options options;
+  options.max_connections_per_host = 6;
+  options.idle_timeout = std::chrono::seconds(90);
+  return options;
+}
+
+std::filesystem::path PrewarmOriginsFile() {
+  const std::wstring app_data_dir = GetAppDataDirectory();
+  if (app_data_dir.empty()) {
+    return std::filesystem::path();
+  }
+  return std::filesystem::path(app_data_dir) / kPrewarmOriginsFileName;
+}
+
+}  // namespace
+
+NativeHttpClient& NativeHttpClient::GetInstance() {
+  // 不析构：退出时可能还有请求在途，等它们超时会拖慢退出
+  static NativeHttpClient* instance = new NativeHttpClient();
+  return *instance;
+}
+
+NativeHttpClient::NativeHttpClient()
+    : pool_(std::make_unique<WinHttpConnectionFactory>(
+                [](const std::string& hostname, PCCERT_CONTEXT certificate) {
+                  return PreInitWindow::ValidateServerCertificate(
+                      hostname.c_str(), certificate);
+                }),
+            PoolOptions()),
+      workers_(kWorkerThreads) {}
+
+bool NativeHttpClient::Execute(const std::string& url,
+                               HttpRequest request,
+                               HttpResponse* response,
+                               std::string* error) {
+  HttpOrigin origin;
+  if (!ParseHttpUrl(url, &origin, &request.path)) {
+    *error = "Unsupported URL: " + url;
+    return false;
+  }
+  pool_.EvictIdle();
+  return pool_.Execute(origin, request, response, error);
+}
+
+void NativeHttpClient::ExecuteAsync(const std::string& url,
+                                    HttpRequest request,
+                                    Callback callback) {
+  workers_.Post([this, url, request = std::move(request),
+                 callback = std::move(callback)]() mutable {
+    HttpResponse response;
+    std::string error;
+    const bool ok = Execute(url, std::move(request), &response, &error);
+    callback(ok, std::move(response), std::move(error));
+  });
+}
+
+void NativeHttpClient::PrewarmAsync(const std::vector<HttpOrigin>& origins) {
+  // 每条连接单独一个任务，握手并行进行
+  for (const auto& origin : origins) {
+    for (size_t i = 0; i < kPrewarmConnectionsPerOrigin; ++i) {
+      workers_.Post([this, origin]() { pool_.Prewarm(origin, 1); });
+    }
+  }
+}
+
+bool NativeHttpClient::SavePrewarmOrigins(
+    const std::vector<std::string>& urls) {
+  const std::filesystem::path file = PrewarmOriginsFile();
+  if (file.empty()) {
+    return false;
+  }
+  std::string contents;
+  for (const auto& url : urls) {
+    HttpOrigin origin;
+    if (ParseHttpUrl(url, &origin, nullptr)) {
+      contents += origin.ToString() + "\n";
+    }
+  }
+  std::ofstream out(file, std::ios::out | std::ios::trunc | std::ios::binary);
+  out << contents;
+  return static_cast<bool>(out);
+}
+
+std::vector<HttpOrigin> NativeHttpClient::LoadPrewarmOrigins() const {
+  std::vector<HttpOrigin> origins;
+  const std::filesystem::path file = PrewarmOriginsFile();
+  if (file.empty()) {
+    return origins;
+  }
+  std::ifstream in(file, std::ios::in | std::ios::binary);
+  std::string line;
+  while (std::getline(in, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    HttpOrigin origin;
+    if (ParseHttpUrl(line, &origin, nullptr)) {
+      origins.push_back(std::move(origin));
+    }
+  }
+  return origins;
+}
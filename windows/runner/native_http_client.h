@@ -0,0 +1,59 @@
+#ifndef RUNNER_NATIVE_HTTP_CLIENT_H_
+#define RUNNER_NATIVE_HTTP_CLIENT_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "http_connection_pool.h"
+#include "thread_pool.h"
+
+// 进程内共享的原生 HTTP 客户端（WinHTTP 连接池 + 工作线程）。
+//
+// 预检查窗口在启动时对 API 主机预热连接，Flutter 启动后 Dart 通过
+// HttpChannel 使用同一个连接池，第一批 API 请求直接复用已经完成握手的
+// 连接。HTTPS 响应都会经过 PreInitWindow 的证书固定校验。
+class NativeHttpClient {
+ public:
+  using Callback =
+      std::function<void(bool ok, HttpResponse response, std::string error)>;
+
+  static NativeHttpClient& GetInstance();
+
+  NativeHttpClient(const NativeHttpClient&) = delete;
+  NativeHttpClient& operator=(const NativeHttpClient&) = delete;
+
+  // 同步执行。|request.path| 会被 |url| 中的路径覆盖。
+  bool Execute(const std::string& url,
+               HttpRequest request,
+               HttpResponse* response,
+               std::string* error);
+
+  // 在工作线程上执行，|callback| 也在工作线程上调用。
+  void ExecuteAsync(const std::string& url,
+                    HttpRequest request,
+                    Callback callback);
+
+  // 在工作线程上为每个 origin 建立 kPrewarmConnectionsPerOrigin 条连接，
+  // 立即返回。
+  void PrewarmAsync(const std::vector<HttpOrigin>& origins);
+
+  // 保存需要预热的 origin（取 URL 的 scheme://host:port），下次启动时
+  // 在预检查窗口中预热。
+  bool SavePrewarmOrigins(const std::vector<std::string>& urls);
+  std::vector<HttpOrigin> LoadPrewarmOrigins() const;
+
+  HttpConnectionPool::Stats stats() const { return pool_.stats(); }
+
+ private:
+  // 首页、公告、维护检查等首批请求会同时发出
+  static constexpr size_t kPrewarmConnectionsPerOrigin = 3;
+  static constexpr size_t kWorkerThreads = 8;
+
+  NativeHttpClient();
+
+  HttpConnectionPool pool_;
+  ThreadPool workers_;
+};
+
+#endif  // RUNNER_NATIVE_HTTP_CLIENT_H_
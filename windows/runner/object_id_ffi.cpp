@@ -0,0 +1,87 @@
+#include "object_id_ffi.h"
+
+#include <string_view>
+#include <vector>
+
+#include "object_id_table.h"
+
+uint32_t runner_oid_intern(const char* hex, int32_t length) {
+  ObjectId id;
+  if (!hex || length < 0 ||
+      !ParseObjectIdHex(std::string_view(hex, static_cast<size_t>(length)),
+                        &id)) {
+    return ObjectIdTable::kInvalidHandle;
+  }
+  return GlobalObjectIdTable().Intern(id);
+}
+
+void runner_oid_intern_batch(const char* hex,
+                             int32_t count,
+                             uint32_t* handles) {
+  if (!hex || !handles || count <= 0) {
+    return;
+  }
+  std::vector<ObjectId> ids;
+  std::vector<size_t> positions;
+  ids.reserve(static_cast<size_t>(count));
+  positions.reserve(static_cast<size_t>(count));
+  for (size_t i = 0; i < static_cast<size_t>(count); ++i) {
+    ObjectId id;
+    handles[i] = ObjectIdTable::kInvalidHandle;
+    if (ParseObjectIdHex(std::string_view(hex + i * kObjectIdHexLength,
+                                          kObjectIdHexLength),
+                         &id)) {
+      ids.push_back(id);
+      positions.push_back(i);
+    }
+  }
+  std::vector<uint32_t> interned(ids.size());
+  GlobalObjectIdTable().InternBatch(ids.data(), ids.size(), interned.data());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    handles[positions[i]] = interned[i];
+  }
+}
+
+uint32_t runner_oid_find(const char* hex, int32_t length) {
+  ObjectId id;
+  if (!hex || length < 0 ||
+      !ParseObjectIdHex(std::string_view(hex, static_cast<size_t>(length)),
+                        &id)) {
+    return ObjectIdTable::kInvalidHandle;
+  }
+  return GlobalObjectIdTable().Find(id);
+}
+
+int32_t runner_oid_format(uint32_t handle, char* hex) {
+  ObjectId id;
+  if (!hex || !GlobalObjectIdTable().Get(handle, &id)) {
+    return 0;
+  }
+  FormatObjectIdHex(id, hex);
+  return 1;
+}
+
+int64_t runner_oid_timestamp(uint32_t handle) {
+  ObjectId id;
+  if (!GlobalObjectIdTable().Get(handle, &id)) {
+    return -1;
+  }
+  return ObjectIdTimestamp(id);
+}
+
+uint32_t runner_oid_generate(char* hex) {
+  const ObjectId id = GenerateObjectId();
+  if (hex) {
+    FormatObjectIdHex(id, hex);
+  }
+  return GlobalObjectIdTable().Intern(id);
+}
+
+void runner_oid_stats(RunnerOidStats* stats) {
+  if (!stats) {
+    return;
+  }
+  const ObjectIdTable& table = GlobalObjectIdTable();
+  stats->count = static_cast<int64_t>(table.size());
+  stats->memory_bytes = static_cast<int64_t>(table.memory_bytes());
+}
@@ -0,0 +1,37 @@
+#ifndef RUNNER_OBJECT_ID_FFI_H_
+#define RUNNER_OBJECT_ID_FFI_H_
+
+#include <cstdint>
+
+#include "ffi_export.h"
+
+// GlobalObjectIdTable 的 C 接口，供 lib/windows/native/native_object_id.dart
+// 使用。十六进制字符串不以 '\0' 结尾，固定为 24 个 ASCII 字符。
+// 句柄 0 表示无效。
+
+struct RunnerOidStats {
+  int64_t count;
+  int64_t memory_bytes;
+};
+
+RUNNER_FFI_EXPORT uint32_t runner_oid_intern(const char* hex, int32_t length);
+
+// |hex| 为 |count| 个首尾相连的 24 字符 ObjectId，无效的项句柄为 0。
+RUNNER_FFI_EXPORT void runner_oid_intern_batch(const char* hex,
+                                               int32_t count,
+                                               uint32_t* handles);
+
+RUNNER_FFI_EXPORT uint32_t runner_oid_find(const char* hex, int32_t length);
+
+// 向 |hex| 写入 24 个字符，句柄无效时返回 0。
+RUNNER_FFI_EXPORT int32_t runner_oid_format(uint32_t handle, char* hex);
+
+// 返回内嵌的创建时间（Unix 秒），句柄无效时返回 -1。
+RUNNER_FFI_EXPORT int64_t runner_oid_timestamp(uint32_t handle);
+
+// 生成并驻留新的 ObjectId，十六进制形式写入 |hex|。
+RUNNER_FFI_EXPORT uint32_t runner_oid_generate(char* hex);
+
+RUNNER_FFI_EXPORT void runner_oid_stats(RunnerOidStats* stats);
+
+#endif  // RUNNER_OBJECT_ID_FFI_H_
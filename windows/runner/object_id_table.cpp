@@ -0,0 +1,218 @@
+#include "object_id_table.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+
+namespace {
+
+constexpr size_t kInitialSlots = 1024;
+constexpr uint32_t kMaxHandle = 0xFFFFFFFE;
+constexpr uint8_t kInvalidNibble = 0x10;
+constexpr char kHexDigits[] = "0123456789abcdef";
+
+constexpr std::array<uint8_t, 256> kHexValues = [] {
+  std::array<uint8_t, 256> values{};
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = kInvalidNibble;
+  }
+  for (uint8_t i = 0; i < 10; ++i) {
+    values['0' + i] = i;
+  }
+  for (uint8_t i = 0; i < 6; ++i) {
+    values['a' + i] = static_cast<uint8_t>(10 + i);
+    values['A' + i] = static_cast<uint8_t>(10 + i);
+  }
+  return values;
+}();
+
+uint64_t HashObjectId(const ObjectId& id) {
+  // 前 8 字节是时间戳和随机数，后 4 字节主要是计数器
+  uint64_t head;
+  uint32_t tail;
+  std::memcpy(&head, id.bytes, sizeof(head));
+  std::memcpy(&tail, id.bytes + 8, sizeof(tail));
+  uint64_t hash = (head ^ tail * 0xC2B2AE3D27D4EB4Full) * 0x9E3779B97F4A7C15ull;
+  return hash ^ (hash >> 32);
+}
+
+uint64_t MakeSlot(uint64_t hash, uint32_t handle) {
+  return (hash & 0xFFFFFFFF00000000ull) | handle;
+}
+
+// 进程随机数和计数器起点在第一次生成时确定。
+struct GeneratorState {
+  uint8_t process_random[5];
+  std::atomic<uint32_t> counter;
+
+  GeneratorState() {
+    std::random_device device;
+    std::mt19937_64 engine((static_cast<uint64_t>(device()) << 32) ^ device());
+    const uint64_t random = engine();
+    for (int i = 0; i < 5; ++i) {
+      process_random[i] = static_cast<uint8_t>(random >> (i * 8));
+    }
+    counter.store(static_cast<uint32_t>(engine()), std::memory_order_relaxed);
+  }
+};
+
+}  // namespace
+
+size_t ObjectIdHash::operator()(const ObjectId& id) const {
+  return static_cast<size_t>(HashObjectId(id));
+}
+
+bool ParseObjectIdHex(std::string_view hex, ObjectId* id) {
+  if (hex.size() != kObjectIdHexLength) {
+    return false;
+  }
+  uint8_t invalid = 0;
+  for (size_t i = 0; i < sizeof(id->bytes); ++i) {
+    const uint8_t high = kHexValues[static_cast<uint8_t>(hex[i * 2])];
+    const uint8_t low = kHexValues[static_cast<uint8_t>(hex[i * 2 + 1])];
+    invalid |= high | low;
+    id->bytes[i] = static_cast<uint8_t>(high << 4 | (low & 0x0F));
+  }
+  return (invalid & kInvalidNibble) == 0;
+}
+
+void FormatObjectIdHex(const ObjectId& id, char* hex) {
+  for (size_t i = 0; i < sizeof(id.bytes); ++i) {
+    hex[i * 2] = kHexDigits[id.bytes[i] >> 4];
+    hex[i * 2 + 1] = kHexDigits[id.bytes[i] & 0x0F];
+  }
+}
+
+uint32_t ObjectIdTimestamp(const ObjectId& id) {
+  return static_cast<uint32_t>(id.bytes[0]) << 24 |
+         static_cast<uint32_t>(id.bytes[1]) << 16 |
+         static_cast<uint32_t>(id.bytes[2]) << 8 | id.bytes[3];
+}
+
+ObjectId GenerateObjectId() {
+  static GeneratorState state;
+  const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(
+      std::chrono::system_clock::now().time_since_epoch());
+  const uint32_t timestamp = static_cast<uint32_t>(seconds.count());
+  const uint32_t counter =
+      state.counter.fetch_add(1, std::memory_order_relaxed);
+  ObjectId id;
+  id.bytes[0] = static_cast<uint8_t>(timestamp >> 24);
+  id.bytes[1] = static_cast<uint8_t>(timestamp >> 16);
+  id.bytes[2] = static_cast<uint8_t>(timestamp >> 8);
+  id.bytes[3] = static_cast<uint8_t>(timestamp);
+  std::memcpy(id.bytes + 4, state.process_random, 5);
+  id.bytes[9] = static_cast<uint8_t>(counter >> 16);
+  id.bytes[10] = static_cast<uint8_t>(counter >> 8);
+  id.bytes[11] = static_cast<uint8_t>(counter);
+  return id;
+}
+
+ObjectIdTable::ObjectIdTable() : slots_(kInitialSlots, 0) {}
+
+uint32_t ObjectIdTable::Intern(const ObjectId& id) {
+  const uint64_t hash = HashObjectId(id);
+  {
+    std::shared_lock lock(mutex_);
+    const uint32_t handle = FindLocked(id, hash);
+    if (handle != kInvalidHandle) {
+      return handle;
+    }
+  }
+  std::unique_lock lock(mutex_);
+  return InsertLocked(id, hash);
+}
+
+void ObjectIdTable::InternBatch(const ObjectId* ids,
+                                size_t count,
+                                uint32_t* handles) {
+  std::unique_lock lock(mutex_);
+  for (size_t i = 0; i < count; ++i) {
+    handles[i] = InsertLocked(ids[i], HashObjectId(ids[i]));
+  }
+}
+
+uint32_t ObjectIdTable::Find(const ObjectId& id) const {
+  const uint64_t hash = HashObjectId(id);
+  std::shared_lock lock(mutex_);
+  return FindLocked(id, hash);
+}
+
+bool ObjectIdTable::Get(uint32_t handle, ObjectId* id) const {
+  std::shared_lock lock(mutex_);
+  if (handle == kInvalidHandle || handle > ids_.size()) {
+    return false;
+  }
+  *id = ids_[handle - 1];
+  return true;
+}
+
+size_t ObjectIdTable::size() const {
+  std::shared_lock lock(mutex_);
+  return ids_.size();
+}
+
+size_t ObjectIdTable::memory_bytes() const {
+  std::shared_lock lock(mutex_);
+  return ids_.capacity() * sizeof(ObjectId) +
+         slots_.capacity() * sizeof(uint64_t);
+}
+
+uint32_t ObjectIdTable::FindLocked(const ObjectId& id, uint64_t hash) const {
+  const size_t mask = slots_.size() - 1;
+  const uint64_t tag = hash & 0xFFFFFFFF00000000ull;
+  for (size_t i = static_cast<size_t>(hash) & mask;; i = (i + 1) & mask) {
+    const uint64_t slot = slots_[i];
+    if (slot == 0) {
+      return kInvalidHandle;
+    }
+    const uint32_t handle = static_cast<uint32_t>(slot);
+    if ((slot & 0xFFFFFFFF00000000ull) == tag && ids_[handle - 1] == id) {
+      return handle;
+    }
+  }
+}
+
+uint32_t ObjectIdTable::InsertLocked(const ObjectId& id, uint64_t hash) {
+  const uint32_t existing = FindLocked(id, hash);
+  if (existing != kInvalidHandle) {
+    return existing;
+  }
+  if (ids_.size() >= kMaxHandle) {
+    return kInvalidHandle;
+  }
+  // 装载因子保持在 0.7 以下
+  if ((ids_.size() + 1) * 10 > slots_.size() * 7) {
+    GrowLocked();
+  }
+  ids_.push_back(id);
+  const uint32_t handle = static_cast<uint32_t>(ids_.size());
+  const size_t mask = slots_.size() - 1;
+  size_t i = static_cast<size_t>(hash) & mask;
+  while (slots_[i] != 0) {
+    i = (i + 1) & mask;
+  }
+  slots_[i] = MakeSlot(hash, handle);
+  return handle;
+}
+
+void ObjectIdTable::GrowLocked() {
+  std::vector<uint64_t> slots(slots_.size() * 2, 0);
+  const size_t mask = slots.size() - 1;
+  for (uint32_t handle = 1; handle <= ids_.size(); ++handle) {
+    const uint64_t hash = HashObjectId(ids_[handle - 1]);
+    size_t i = static_cast<size_t>(hash) & mask;
+    while (slots[i] != 0) {
+      i = (i + 1) & mask;
+    }
+    slots[i] = MakeSlot(hash, handle);
+  }
+  slots_.swap(slots);
+}
+
+ObjectIdTable& GlobalObjectIdTable() {
+  static ObjectIdTable* table = new ObjectIdTable();
+  return *table;
+}
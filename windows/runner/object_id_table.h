@@ -0,0 +1,92 @@
+#ifndef RUNNER_OBJECT_ID_TABLE_H_
+#define RUNNER_OBJECT_ID_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <shared_mutex>
+#include <string_view>
+#include <vector>
+
+// MongoDB ObjectId 的 12 字节二进制形式：4 字节大端秒级时间戳、
+// 5 字节进程随机数、3 字节大端计数器。
+struct ObjectId {
+  uint8_t bytes[12];
+
+  bool operator==(const ObjectId& other) const {
+    return std::memcmp(bytes, other.bytes, sizeof(bytes)) == 0;
+  }
+  bool operator!=(const ObjectId& other) const { return !(*this == other); }
+  // 字节序比较，与十六进制字符串的字典序一致
+  bool operator<(const ObjectId& other) const {
+    return std::memcmp(bytes, other.bytes, sizeof(bytes)) < 0;
+  }
+};
+static_assert(sizeof(ObjectId) == 12, "ObjectId must be 12 bytes");
+
+// 用于 std::unordered_map 等容器。
+struct ObjectIdHash {
+  size_t operator()(const ObjectId& id) const;
+};
+
+constexpr size_t kObjectIdHexLength = 24;
+
+// 解析 24 位十六进制字符串（大小写均可），长度或字符无效时返回 false。
+bool ParseObjectIdHex(std::string_view hex, ObjectId* id);
+
+// 向 |hex| 写入 24 个小写十六进制字符（不含结尾的 '\0'）。
+void FormatObjectIdHex(const ObjectId& id, char* hex);
+
+// 内嵌的创建时间，单位为秒（Unix 时间）。
+uint32_t ObjectIdTimestamp(const ObjectId& id);
+
+// 按 MongoDB 驱动的规则生成新的 ObjectId，可以在任意线程上调用。
+ObjectId GenerateObjectId();
+
+// ObjectId 的驻留表（与平台无关）。每个不同的 ObjectId 只存一份
+// 12 字节，并分配一个从 1 开始连续递增的 32 位句柄，原生缓存和索引
+// 用句柄代替 24 字符的字符串作为键和外键。
+//
+// 哈希表为开放寻址、线性探测，每个槽 8 字节（句柄和 32 位哈希标签），
+// 大多数不命中的探测不需要访问 ObjectId 本身。条目不会删除，句柄在
+// 进程退出前一直有效。可以在多个线程上同时调用。
+class ObjectIdTable {
+ public:
+  static constexpr uint32_t kInvalidHandle = 0;
+
+  ObjectIdTable();
+
+  ObjectIdTable(const ObjectIdTable&) = delete;
+  ObjectIdTable& operator=(const ObjectIdTable&) = delete;
+
+  // 返回 |id| 的句柄，不存在时插入。表满时返回 kInvalidHandle。
+  uint32_t Intern(const ObjectId& id);
+
+  // 一次加锁驻留 |count| 个 ObjectId，句柄写入 |handles|。
+  void InternBatch(const ObjectId* ids, size_t count, uint32_t* handles);
+
+  // 返回 |id| 的句柄，不存在时返回 kInvalidHandle。
+  uint32_t Find(const ObjectId& id) const;
+
+  // 取得 |handle| 对应的 ObjectId，句柄无效时返回 false。
+  bool Get(uint32_t handle, ObjectId* id) const;
+
+  size_t size() const;
+
+  // ObjectId 数组和哈希表占用的字节数（按容量计算）。
+  size_t memory_bytes() const;
+
+ private:
+  uint32_t FindLocked(const ObjectId& id, uint64_t hash) const;
+  uint32_t InsertLocked(const ObjectId& id, uint64_t hash);
+  void GrowLocked();
+
+  mutable std::shared_mutex mutex_;
+  std::vector<ObjectId> ids_;     // 下标为句柄减 1
+  std::vector<uint64_t> slots_;   // 高 32 位为哈希标签，低 32 位为句柄，0 为空
+};
+
+// 进程内共享的驻留表，FFI 和各个原生缓存使用同一张表。
+ObjectIdTable& GlobalObjectIdTable();
+
+#endif  // RUNNER_OBJECT_ID_TABLE_H_
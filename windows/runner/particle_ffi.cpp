@@ -0,0 +1,115 @@
+#include "particle_ffi.h"
+
+#include "particle_system.h"
+
+namespace {
+
+// 防止 Dart 传入的容量把内存撑爆；背景和拖尾都远小于这个值
+constexpr int32_t kMaxCapacity = 1 << 20;
+
+ParticleSystem* AsSystem(void* particles) {
+  return static_cast<ParticleSystem*>(particles);
+}
+
+}  // namespace
+
+void* runner_particles_create(int32_t capacity, uint32_t seed) {
+  if (capacity <= 0 || capacity > kMaxCapacity) {
+    return nullptr;
+  }
+  return new ParticleSystem(static_cast<uint32_t>(capacity), seed);
+}
+
+void runner_particles_destroy(void* particles) {
+  delete AsSystem(particles);
+}
+
+void runner_particles_set_behavior(void* particles,
+                                   const RunnerParticleBehavior* behavior) {
+  ParticleBehavior converted;
+  converted.drag = behavior->drag;
+  converted.jitter = behavior->jitter;
+  converted.spin = behavior->spin;
+  converted.opacity_decay = behavior->opacity_decay;
+  converted.size_decay = behavior->size_decay;
+  converted.min_opacity = behavior->min_opacity;
+  converted.min_size = behavior->min_size;
+  converted.wrap = behavior->wrap != 0;
+  converted.ranges.rise_min = behavior->rise_min;
+  converted.ranges.rise_max = behavior->rise_max;
+  converted.ranges.size_min = behavior->size_min;
+  converted.ranges.size_max = behavior->size_max;
+  converted.ranges.opacity_min = behavior->opacity_min;
+  converted.ranges.opacity_max = behavior->opacity_max;
+  AsSystem(particles)->SetBehavior(converted);
+}
+
+void runner_particles_set_palette(void* particles,
+                                  const uint32_t* colors,
+                                  int32_t count) {
+  AsSystem(particles)->SetPalette(
+      colors, count > 0 ? static_cast<uint32_t>(count) : 0);
+}
+
+void runner_particles_set_sprites(void* particles,
+                                  const float* rects,
+                                  int32_t shape_count,
+                                  float radius) {
+  if (shape_count <= 0) {
+    return;
+  }
+  AsSystem(particles)->SetSprites(rects, static_cast<uint32_t>(shape_count),
+                                  radius);
+}
+
+void runner_particles_scatter(void* particles,
+                              int32_t count,
+                              float width,
+                              float height) {
+  AsSystem(particles)->Scatter(count > 0 ? static_cast<uint32_t>(count) : 0,
+                               width, height);
+}
+
+void runner_particles_spawn(void* particles,
+                            const RunnerParticleSpawn* spawn,
+                            int32_t count) {
+  ParticleSystem* system = AsSystem(particles);
+  for (int32_t i = 0; i < count; ++i) {
+    const RunnerParticleSpawn& from = spawn[i];
+    ParticleSpawn converted;
+    converted.x = from.x;
+    converted.y = from.y;
+    converted.vx = from.vx;
+    converted.vy = from.vy;
+    converted.rise = from.rise;
+    converted.size = from.size;
+    converted.opacity = from.opacity;
+    converted.angle = from.angle;
+    converted.color = from.color;
+    converted.shape = from.shape;
+    system->Spawn(converted);
+  }
+}
+
+void runner_particles_clear(void* particles) {
+  AsSystem(particles)->Clear();
+}
+
+int32_t runner_particles_step(void* particles,
+                              float frames,
+                              float width,
+                              float height) {
+  return static_cast<int32_t>(AsSystem(particles)->Step(frames, width, height));
+}
+
+const float* runner_particles_transforms(void* particles) {
+  return AsSystem(particles)->transforms();
+}
+
+const float* runner_particles_rects(void* particles) {
+  return AsSystem(particles)->rects();
+}
+
+const uint32_t* runner_particles_colors(void* particles) {
+  return AsSystem(particles)->colors();
+}
@@ -0,0 +1,84 @@
+#ifndef RUNNER_PARTICLE_FFI_H_
+#define RUNNER_PARTICLE_FFI_H_
+
+#include <cstdint>
+
+#include "ffi_export.h"
+
+// ParticleSystem 的 C 接口，供 lib/windows/native/native_particle_system.dart
+// 使用。结构体布局必须和 Dart 侧的 Struct 定义一致。
+//
+// 句柄只能在创建它的线程（UI 线程）上使用。
+
+struct RunnerParticleBehavior {
+  float drag;
+  float jitter;
+  float spin;
+  float opacity_decay;
+  float size_decay;
+  float min_opacity;
+  float min_size;
+  int32_t wrap;
+  float rise_min;
+  float rise_max;
+  float size_min;
+  float size_max;
+  float opacity_min;
+  float opacity_max;
+};
+
+struct RunnerParticleSpawn {
+  float x;
+  float y;
+  float vx;
+  float vy;
+  float rise;
+  float size;
+  float opacity;
+  float angle;
+  uint32_t color;
+  uint32_t shape;
+};
+
+RUNNER_FFI_EXPORT void* runner_particles_create(int32_t capacity,
+                                                uint32_t seed);
+
+RUNNER_FFI_EXPORT void runner_particles_destroy(void* particles);
+
+RUNNER_FFI_EXPORT void runner_particles_set_behavior(
+    void* particles,
+    const RunnerParticleBehavior* behavior);
+
+RUNNER_FFI_EXPORT void runner_particles_set_palette(void* particles,
+                                                    const uint32_t* colors,
+                                                    int32_t count);
+
+// |rects| 为 |shape_count| 组 (left, top, right, bottom)。
+RUNNER_FFI_EXPORT void runner_particles_set_sprites(void* particles,
+                                                    const float* rects,
+                                                    int32_t shape_count,
+                                                    float radius);
+
+RUNNER_FFI_EXPORT void runner_particles_scatter(void* particles,
+                                                int32_t count,
+                                                float width,
+                                                float height);
+
+RUNNER_FFI_EXPORT void runner_particles_spawn(void* particles,
+                                              const RunnerParticleSpawn* spawn,
+                                              int32_t count);
+
+RUNNER_FFI_EXPORT void runner_particles_clear(void* particles);
+
+// 返回存活的粒子数。
+RUNNER_FFI_EXPORT int32_t runner_particles_step(void* particles,
+                                                float frames,
+                                                float width,
+                                                float height);
+
+// 以下三个数组长度为 capacity，地址在句柄销毁前不变，Dart 只需取一次。
+RUNNER_FFI_EXPORT const float* runner_particles_transforms(void* particles);
+RUNNER_FFI_EXPORT const float* runner_particles_rects(void* particles);
+RUNNER_FFI_EXPORT const uint32_t* runner_particles_colors(void* particles);
+
+#endif  // RUNNER_PARTICLE_FFI_H_
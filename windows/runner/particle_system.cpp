@@ -0,0 +1,505 @@
+#include "particle_system.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "cpu_features.h"
+
+#if RUNNER_ARCH_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr float kPi = 3.14159265f;
+constexpr float kTwoPi = 6.28318531f;
+// 数组长度按 AVX2 的宽度对齐，SIMD 循环不需要处理尾部
+constexpr uint32_t kLanes = 8;
+// 窗口被拖动或切到后台时帧间隔可能很长，一步最多补 8 帧
+constexpr float kMaxFramesPerStep = 8.0f;
+
+uint32_t PaddedSize(uint32_t count) {
+  return (count + kLanes - 1) / kLanes * kLanes;
+}
+
+uint32_t XorShift32(uint32_t state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+// 高 24 位转为 [0, 1) 的 float。
+float UnitFloat(uint32_t bits) {
+  return static_cast<float>(bits >> 8) * (1.0f / 16777216.0f);
+}
+
+float WrapAngle(float angle) {
+  angle = std::fmod(angle + kPi, kTwoPi);
+  return (angle < 0.0f ? angle + kTwoPi : angle) - kPi;
+}
+
+// |x| 在 [-pi, pi] 内。抛物线近似加一次修正，最大误差约 0.001，
+// 对几像素大的精灵的旋转足够了。
+float FastSin(float x) {
+  const float y = 1.27323954f * x - 0.405284735f * x * std::fabs(x);
+  return 0.225f * (y * std::fabs(y) - y) + y;
+}
+
+struct ParticleArrays {
+  float* x;
+  float* y;
+  float* vx;
+  float* vy;
+  const float* rise;
+  float* size;
+  float* opacity;
+  float* angle;
+  uint32_t* random;
+};
+
+// 每帧的参数换算成本次步长的量。
+struct StepConstants {
+  float frames;
+  float drag;
+  float jitter;
+  float spin;
+  float opacity_decay;
+  float size_decay;
+};
+
+struct InstanceArrays {
+  const float* x;
+  const float* y;
+  const float* size;
+  const float* opacity;
+  const float* angle;
+  const uint32_t* base_color;
+  float* transforms;
+  uint32_t* colors;
+  float radius;
+};
+
+// 积分处理 [0, count)，count 是 kLanes 的倍数。
+[[maybe_unused]] void IntegrateScalar(const ParticleArrays& p,
+                                      uint32_t count,
+                                      const StepConstants& c) {
+  for (uint32_t i = 0; i < count; ++i) {
+    p.random[i] = XorShift32(p.random[i]);
+    p.vx[i] += c.jitter * (UnitFloat(p.random[i]) - 0.5f);
+    p.x[i] += p.vx[i] * c.frames;
+    p.y[i] += (p.vy[i] - p.rise[i]) * c.frames;
+    p.vx[i] *= c.drag;
+    p.vy[i] *= c.drag;
+    float angle = p.angle[i] + c.spin;
+    angle = angle > kPi ? angle - kTwoPi : angle;
+    p.angle[i] = angle < -kPi ? angle + kTwoPi : angle;
+    p.opacity[i] *= c.opacity_decay;
+    p.size[i] *= c.size_decay;
+  }
+}
+
+// 写出 [0, count) 的绘制数据，count 是 4 的倍数。
+[[maybe_unused]] void WriteInstancesScalar(const InstanceArrays& p,
+                                           uint32_t count) {
+  for (uint32_t i = 0; i < count; ++i) {
+    const float scale = p.size[i] / p.radius;
+    float cos_angle = p.angle[i] + kPi / 2;
+    cos_angle = cos_angle > kPi ? cos_angle - kTwoPi : cos_angle;
+    const float scos = scale * FastSin(cos_angle);
+    const float ssin = scale * FastSin(p.angle[i]);
+    float* transform = p.transforms + static_cast<size_t>(i) * 4;
+    transform[0] = scos;
+    transform[1] = ssin;
+    transform[2] = p.x[i] - (scos - ssin) * p.radius;
+    transform[3] = p.y[i] - (ssin + scos) * p.radius;
+
+    const float alpha =
+        std::min(static_cast<float>(p.base_color[i] >> 24) * p.opacity[i],
+                 255.0f);
+    p.colors[i] = (static_cast<uint32_t>(alpha) << 24) |
+                  (p.base_color[i] & 0x00FFFFFFu);
+  }
+}
+
+#if RUNNER_ARCH_X86
+
+void IntegrateSse2(const ParticleArrays& p,
+                   uint32_t count,
+                   const StepConstants& c) {
+  const __m128 frames = _mm_set1_ps(c.frames);
+  const __m128 drag = _mm_set1_ps(c.drag);
+  const __m128 jitter = _mm_set1_ps(c.jitter);
+  const __m128 spin = _mm_set1_ps(c.spin);
+  const __m128 opacity_decay = _mm_set1_ps(c.opacity_decay);
+  const __m128 size_decay = _mm_set1_ps(c.size_decay);
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 unit = _mm_set1_ps(1.0f / 16777216.0f);
+  const __m128 pi = _mm_set1_ps(kPi);
+  const __m128 negative_pi = _mm_set1_ps(-kPi);
+  const __m128 two_pi = _mm_set1_ps(kTwoPi);
+
+  for (uint32_t i = 0; i < count; i += 4) {
+    __m128i random =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p.random + i));
+    random = _mm_xor_si128(random, _mm_slli_epi32(random, 13));
+    random = _mm_xor_si128(random, _mm_srli_epi32(random, 17));
+    random = _mm_xor_si128(random, _mm_slli_epi32(random, 5));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p.random + i), random);
+    const __m128 noise = _mm_sub_ps(
+        _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(random, 8)), unit), half);
+
+    __m128 vx = _mm_add_ps(_mm_loadu_ps(p.vx + i), _mm_mul_ps(jitter, noise));
+    __m128 vy = _mm_loadu_ps(p.vy + i);
+    const __m128 rise = _mm_loadu_ps(p.rise + i);
+    _mm_storeu_ps(p.x + i,
+                  _mm_add_ps(_mm_loadu_ps(p.x + i), _mm_mul_ps(vx, frames)));
+    _mm_storeu_ps(p.y + i, _mm_add_ps(_mm_loadu_ps(p.y + i),
+                                      _mm_mul_ps(_mm_sub_ps(vy, rise),
+                                                 frames)));
+    _mm_storeu_ps(p.vx + i, _mm_mul_ps(vx, drag));
+    _mm_storeu_ps(p.vy + i, _mm_mul_ps(vy, drag));
+
+    __m128 angle = _mm_add_ps(_mm_loadu_ps(p.angle + i), spin);
+    angle = _mm_sub_ps(angle, _mm_and_ps(_mm_cmpgt_ps(angle, pi), two_pi));
+    angle = _mm_add_ps(angle, _mm_and_ps(_mm_cmplt_ps(angle, negative_pi),
+                                         two_pi));
+    _mm_storeu_ps(p.angle + i, angle);
+
+    _mm_storeu_ps(p.opacity + i,
+                  _mm_mul_ps(_mm_loadu_ps(p.opacity + i), opacity_decay));
+    _mm_storeu_ps(p.size + i,
+                  _mm_mul_ps(_mm_loadu_ps(p.size + i), size_decay));
+  }
+}
+
+__m128 FastSinSse2(__m128 x) {
+  const __m128 sign_mask = _mm_set1_ps(-0.0f);
+  const __m128 abs_x = _mm_andnot_ps(sign_mask, x);
+  const __m128 y =
+      _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(1.27323954f), x),
+                 _mm_mul_ps(_mm_set1_ps(0.405284735f), _mm_mul_ps(x, abs_x)));
+  const __m128 abs_y = _mm_andnot_ps(sign_mask, y);
+  return _mm_add_ps(
+      _mm_mul_ps(_mm_set1_ps(0.225f), _mm_sub_ps(_mm_mul_ps(y, abs_y), y)),
+      y);
+}
+
+void WriteInstancesSse2(const InstanceArrays& p, uint32_t count) {
+  const __m128 inverse_radius = _mm_set1_ps(1.0f / p.radius);
+  const __m128 radius = _mm_set1_ps(p.radius);
+  const __m128 pi = _mm_set1_ps(kPi);
+  const __m128 two_pi = _mm_set1_ps(kTwoPi);
+  const __m128 half_pi = _mm_set1_ps(kPi / 2);
+  const __m128 max_alpha = _mm_set1_ps(255.0f);
+  const __m128i rgb_mask = _mm_set1_epi32(0x00FFFFFF);
+
+  for (uint32_t i = 0; i < count; i += 4) {
+    const __m128 angle = _mm_loadu_ps(p.angle + i);
+    __m128 cos_angle = _mm_add_ps(angle, half_pi);
+    cos_angle = _mm_sub_ps(cos_angle,
+                           _mm_and_ps(_mm_cmpgt_ps(cos_angle, pi), two_pi));
+    const __m128 scale = _mm_mul_ps(_mm_loadu_ps(p.size + i), inverse_radius);
+    __m128 scos = _mm_mul_ps(scale, FastSinSse2(cos_angle));
+    __m128 ssin = _mm_mul_ps(scale, FastSinSse2(angle));
+    __m128 tx = _mm_sub_ps(_mm_loadu_ps(p.x + i),
+                           _mm_mul_ps(_mm_sub_ps(scos, ssin), radius));
+    __m128 ty = _mm_sub_ps(_mm_loadu_ps(p.y + i),
+                           _mm_mul_ps(_mm_add_ps(ssin, scos), radius));
+    // 四个粒子的 SoA 转成 RSTransform 需要的交错排列
+    _MM_TRANSPOSE4_PS(scos, ssin, tx, ty);
+    float* transform = p.transforms + static_cast<size_t>(i) * 4;
+    _mm_storeu_ps(transform, scos);
+    _mm_storeu_ps(transform + 4, ssin);
+    _mm_storeu_ps(transform + 8, tx);
+    _mm_storeu_ps(transform + 12, ty);
+
+    const __m128i color =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p.base_color + i));
+    const __m128 alpha =
+        _mm_min_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(color, 24)),
+                              _mm_loadu_ps(p.opacity + i)),
+                   max_alpha);
+    const __m128i argb = _mm_or_si128(
+        _mm_slli_epi32(_mm_cvttps_epi32(alpha), 24),
+        _mm_and_si128(color, rgb_mask));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p.colors + i), argb);
+  }
+}
+
+RUNNER_TARGET_ATTRIBUTE("avx2")
+void IntegrateAvx2(const ParticleArrays& p,
+                   uint32_t count,
+                   const StepConstants& c) {
+  const __m256 frames = _mm256_set1_ps(c.frames);
+  const __m256 drag = _mm256_set1_ps(c.drag);
+  const __m256 jitter = _mm256_set1_ps(c.jitter);
+  const __m256 spin = _mm256_set1_ps(c.spin);
+  const __m256 opacity_decay = _mm256_set1_ps(c.opacity_decay);
+  const __m256 size_decay = _mm256_set1_ps(c.size_decay);
+  const __m256 half = _mm256_set1_ps(0.5f);
+  const __m256 unit = _mm256_set1_ps(1.0f / 16777216.0f);
+  const __m256 pi = _mm256_set1_ps(kPi);
+  const __m256 negative_pi = _mm256_set1_ps(-kPi);
+  const __m256 two_pi = _mm256_set1_ps(kTwoPi);
+
+  for (uint32_t i = 0; i < count; i += 8) {
+    __m256i random =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p.random + i));
+    random = _mm256_xor_si256(random, _mm256_slli_epi32(random, 13));
+    random = _mm256_xor_si256(random, _mm256_srli_epi32(random, 17));
+    random = _mm256_xor_si256(random, _mm256_slli_epi32(random, 5));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p.random + i), random);
+    const __m256 noise = _mm256_sub_ps(
+        _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(random, 8)), unit),
+        half);
+
+    const __m256 vx =
+        _mm256_add_ps(_mm256_loadu_ps(p.vx + i), _mm256_mul_ps(jitter, noise));
+    const __m256 vy = _mm256_loadu_ps(p.vy + i);
+    const __m256 rise = _mm256_loadu_ps(p.rise + i);
+    _mm256_storeu_ps(p.x + i, _mm256_add_ps(_mm256_loadu_ps(p.x + i),
+                                            _mm256_mul_ps(vx, frames)));
+    _mm256_storeu_ps(p.y + i,
+                     _mm256_add_ps(_mm256_loadu_ps(p.y + i),
+                                   _mm256_mul_ps(_mm256_sub_ps(vy, rise),
+                                                 frames)));
+    _mm256_storeu_ps(p.vx + i, _mm256_mul_ps(vx, drag));
+    _mm256_storeu_ps(p.vy + i, _mm256_mul_ps(vy, drag));
+
+    __m256 angle = _mm256_add_ps(_mm256_loadu_ps(p.angle + i), spin);
+    angle = _mm256_sub_ps(
+        angle,
+        _mm256_and_ps(_mm256_cmp_ps(angle, pi, _CMP_GT_OQ), two_pi));
+    angle = _mm256_add_ps(
+        angle, _mm256_and_ps(_mm256_cmp_ps(angle, negative_pi, _CMP_LT_OQ),
+                             two_pi));
+    _mm256_storeu_ps(p.angle + i, angle);
+
+    _mm256_storeu_ps(p.opacity + i, _mm256_mul_ps(_mm256_loadu_ps(p.opacity + i),
+                                                  opacity_decay));
+    _mm256_storeu_ps(p.size + i,
+                     _mm256_mul_ps(_mm256_loadu_ps(p.size + i), size_decay));
+  }
+}
+
+#endif  // RUNNER_ARCH_X86
+
+using IntegrateFunction = void (*)(const ParticleArrays&,
+                                   uint32_t,
+                                   const StepConstants&);
+using WriteInstancesFunction = void (*)(const InstanceArrays&, uint32_t);
+
+IntegrateFunction SelectIntegrate() {
+#if RUNNER_ARCH_X86
+  if (GetCpuFeatures().avx2) {
+    return IntegrateAvx2;
+  }
+  return IntegrateSse2;
+#else
+  return IntegrateScalar;
+#endif
+}
+
+WriteInstancesFunction SelectWriteInstances() {
+#if RUNNER_ARCH_X86
+  return WriteInstancesSse2;
+#else
+  return WriteInstancesScalar;
+#endif
+}
+
+}  // namespace
+
+ParticleSystem::ParticleSystem(uint32_t capacity, uint32_t seed)
+    : capacity_(capacity), random_state_(seed ? seed : 0x9E3779B9u) {
+  const uint32_t padded = PaddedSize(capacity);
+  for (auto* array : {&x_, &y_, &vx_, &vy_, &rise_, &size_, &opacity_,
+                      &angle_}) {
+    array->assign(padded, 0.0f);
+  }
+  base_color_.assign(padded, 0);
+  shape_.assign(padded, 0);
+  lane_random_.resize(padded);
+  for (auto& state : lane_random_) {
+    state = NextRandom() | 1;  // xorshift 的状态不能为 0
+  }
+  transforms_.assign(static_cast<size_t>(padded) * 4, 0.0f);
+  rects_.assign(static_cast<size_t>(padded) * 4, 0.0f);
+  colors_.assign(padded, 0);
+  sprite_rects_ = {0.0f, 0.0f, 2.0f, 2.0f};
+  palette_ = {0xFFFFFFFFu};
+}
+
+void ParticleSystem::SetPalette(const uint32_t* colors, uint32_t count) {
+  if (count == 0) {
+    palette_ = {0xFFFFFFFFu};
+    return;
+  }
+  palette_.assign(colors, colors + count);
+}
+
+void ParticleSystem::SetSprites(const float* rects,
+                                uint32_t shape_count,
+                                float radius) {
+  if (shape_count == 0 || !(radius > 0.0f)) {
+    return;
+  }
+  sprite_rects_.assign(rects, rects + static_cast<size_t>(shape_count) * 4);
+  sprite_radius_ = radius;
+  for (uint32_t i = 0; i < count_; ++i) {
+    shape_[i] %= shape_count;
+    std::memcpy(&rects_[static_cast<size_t>(i) * 4],
+                &sprite_rects_[static_cast<size_t>(shape_[i]) * 4],
+                4 * sizeof(float));
+  }
+}
+
+void ParticleSystem::Scatter(uint32_t count, float width, float height) {
+  const ParticleRanges& ranges = behavior_.ranges;
+  const auto shape_count = static_cast<uint32_t>(sprite_rects_.size() / 4);
+  count_ = 0;
+  count = std::min(count, capacity_);
+  for (uint32_t i = 0; i < count; ++i) {
+    ParticleSpawn spawn;
+    spawn.x = RandomRange(0.0f, width);
+    spawn.y = RandomRange(0.0f, height);
+    spawn.rise = RandomRange(ranges.rise_min, ranges.rise_max);
+    spawn.size = RandomRange(ranges.size_min, ranges.size_max);
+    spawn.opacity = RandomRange(ranges.opacity_min, ranges.opacity_max);
+    spawn.angle = RandomRange(-kPi, kPi);
+    spawn.color = palette_[NextRandom() % palette_.size()];
+    spawn.shape = NextRandom() % shape_count;
+    Place(count_++, spawn);
+  }
+}
+
+void ParticleSystem::Spawn(const ParticleSpawn& spawn) {
+  if (capacity_ == 0) {
+    return;
+  }
+  if (count_ < capacity_) {
+    Place(count_++, spawn);
+    return;
+  }
+  const auto dimmest = static_cast<uint32_t>(
+      std::min_element(opacity_.begin(), opacity_.begin() + count_) -
+      opacity_.begin());
+  Place(dimmest, spawn);
+}
+
+uint32_t ParticleSystem::Step(float frames, float width, float height) {
+  static const IntegrateFunction integrate = SelectIntegrate();
+  static const WriteInstancesFunction write_instances =
+      SelectWriteInstances();
+
+  frames = std::clamp(frames, 0.0f, kMaxFramesPerStep);
+  if (count_ == 0) {
+    return 0;
+  }
+
+  const StepConstants constants = {
+      frames,
+      std::pow(behavior_.drag, frames),
+      behavior_.jitter * frames,
+      behavior_.spin * frames,
+      std::pow(behavior_.opacity_decay, frames),
+      std::pow(behavior_.size_decay, frames),
+  };
+  const ParticleArrays particles = {
+      x_.data(),    y_.data(),       vx_.data(),    vy_.data(),
+      rise_.data(), size_.data(),    opacity_.data(), angle_.data(),
+      lane_random_.data(),
+  };
+  integrate(particles, PaddedSize(count_), constants);
+
+  // 越界和淡出的粒子很少，逐个检查即可
+  for (uint32_t i = 0; i < count_;) {
+    if (behavior_.wrap) {
+      if (y_[i] < -size_[i]) {
+        Respawn(i, width, height);
+      }
+      if (x_[i] < -size_[i]) {
+        x_[i] = width + size_[i];
+      } else if (x_[i] > width + size_[i]) {
+        x_[i] = -size_[i];
+      }
+    } else if (opacity_[i] < behavior_.min_opacity ||
+               size_[i] < behavior_.min_size) {
+      RemoveAt(i);
+      continue;
+    }
+    ++i;
+  }
+
+  const InstanceArrays instances = {
+      x_.data(),          y_.data(),           size_.data(),
+      opacity_.data(),    angle_.data(),       base_color_.data(),
+      transforms_.data(), colors_.data(),      sprite_radius_,
+  };
+  write_instances(instances, PaddedSize(count_));
+  return count_;
+}
+
+uint32_t ParticleSystem::NextRandom() {
+  random_state_ = XorShift32(random_state_);
+  return random_state_;
+}
+
+float ParticleSystem::RandomRange(float min, float max) {
+  return min + (max - min) * UnitFloat(NextRandom());
+}
+
+void ParticleSystem::Place(uint32_t index, const ParticleSpawn& spawn) {
+  const auto shape_count = static_cast<uint32_t>(sprite_rects_.size() / 4);
+  x_[index] = spawn.x;
+  y_[index] = spawn.y;
+  vx_[index] = spawn.vx;
+  vy_[index] = spawn.vy;
+  rise_[index] = spawn.rise;
+  size_[index] = spawn.size;
+  opacity_[index] = spawn.opacity;
+  angle_[index] = WrapAngle(spawn.angle);
+  base_color_[index] = spawn.color;
+  shape_[index] = spawn.shape % shape_count;
+  std::memcpy(&rects_[static_cast<size_t>(index) * 4],
+              &sprite_rects_[static_cast<size_t>(shape_[index]) * 4],
+              4 * sizeof(float));
+}
+
+void ParticleSystem::Respawn(uint32_t index, float width, float height) {
+  const ParticleRanges& ranges = behavior_.ranges;
+  ParticleSpawn spawn;
+  spawn.x = RandomRange(0.0f, width);
+  spawn.y = height + size_[index];
+  spawn.rise = rise_[index];
+  spawn.size = size_[index];
+  spawn.opacity = RandomRange(ranges.opacity_min, ranges.opacity_max);
+  spawn.angle = angle_[index];
+  spawn.color = palette_[NextRandom() % palette_.size()];
+  spawn.shape = NextRandom();
+  Place(index, spawn);
+}
+
+void ParticleSystem::RemoveAt(uint32_t index) {
+  const uint32_t last = --count_;
+  if (index != last) {
+    x_[index] = x_[last];
+    y_[index] = y_[last];
+    vx_[index] = vx_[last];
+    vy_[index] = vy_[last];
+    rise_[index] = rise_[last];
+    size_[index] = size_[last];
+    opacity_[index] = opacity_[last];
+    angle_[index] = angle_[last];
+    base_color_[index] = base_color_[last];
+    shape_[index] = shape_[last];
+    std::memcpy(&rects_[static_cast<size_t>(index) * 4],
+                &rects_[static_cast<size_t>(last) * 4], 4 * sizeof(float));
+  }
+  // 空出的槽位清零，SIMD 循环处理填充项时不会一直衰减出非规格化数
+  x_[last] = y_[last] = vx_[last] = vy_[last] = 0.0f;
+  rise_[last] = size_[last] = opacity_[last] = angle_[last] = 0.0f;
+  base_color_[last] = 0;
+}
@@ -0,0 +1,124 @@
+#ifndef RUNNER_PARTICLE_SYSTEM_H_
+#define RUNNER_PARTICLE_SYSTEM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 背景粒子和鼠标拖尾的模拟（与平台无关）。
+//
+// 粒子按属性分别存放（SoA），每帧的积分用 SIMD 一次处理 4/8 个粒子。
+// 每一步之后直接写出 Canvas.drawRawAtlas 需要的三个数组（RSTransform、
+// 图集矩形、颜色），Dart 用零拷贝的视图一次画完所有粒子。
+// 粒子池容量固定，生成和回收只是在数组末尾增减，不分配内存。
+
+// 随机初始值的范围。
+struct ParticleRanges {
+  float rise_min = 0.0f;
+  float rise_max = 0.0f;
+  float size_min = 1.0f;
+  float size_max = 1.0f;
+  float opacity_min = 1.0f;
+  float opacity_max = 1.0f;
+};
+
+// 运动规则，数值都是每帧（1/60 秒）的量。
+struct ParticleBehavior {
+  float drag = 1.0f;           // 速度每帧的乘数
+  float jitter = 0.0f;         // X 速度每帧的随机扰动，均匀分布于 ±jitter/2
+  float spin = 0.0f;           // 角度每帧的增量（弧度）
+  float opacity_decay = 1.0f;  // 不透明度每帧的乘数
+  float size_decay = 1.0f;     // 尺寸每帧的乘数
+  float min_opacity = 0.0f;    // 低于此值时回收（wrap 为 false）
+  float min_size = 0.0f;       // 同上
+  // true：从顶部飘出后在底部重生，左右循环（背景）；false：淡出后回收（拖尾）
+  bool wrap = false;
+  ParticleRanges ranges;       // Scatter 和重生使用
+};
+
+struct ParticleSpawn {
+  float x = 0.0f;
+  float y = 0.0f;
+  float vx = 0.0f;
+  float vy = 0.0f;
+  float rise = 0.0f;  // 每帧上升的距离，不受 drag 影响
+  float size = 1.0f;  // 半径
+  float opacity = 1.0f;
+  float angle = 0.0f;
+  uint32_t color = 0xFFFFFFFF;  // ARGB，alpha 会再乘以 opacity
+  uint32_t shape = 0;
+};
+
+class ParticleSystem {
+ public:
+  ParticleSystem(uint32_t capacity, uint32_t seed);
+
+  ParticleSystem(const ParticleSystem&) = delete;
+  ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+  void SetBehavior(const ParticleBehavior& behavior) { behavior_ = behavior; }
+
+  // Scatter 和重生时随机选取的颜色（ARGB）。
+  void SetPalette(const uint32_t* colors, uint32_t count);
+
+  // 图集中每种形状的精灵 (left, top, right, bottom)，共 |shape_count| 组。
+  // 精灵以中心为锚点，|radius| 为精灵的半边长，对应粒子尺寸 1.0 的缩放。
+  void SetSprites(const float* rects, uint32_t shape_count, float radius);
+
+  // 清空后在 |width| x |height| 内随机生成 |count| 个粒子。
+  void Scatter(uint32_t count, float width, float height);
+
+  // 生成一个粒子。池满时替换最暗的粒子（衰减速度相同时就是最早生成的）。
+  void Spawn(const ParticleSpawn& spawn);
+
+  void Clear() { count_ = 0; }
+
+  // 前进 |frames| 帧（可以是小数，帧率不是 60 时按实际间隔传入），
+  // 处理重生和回收，并写出绘制数组。返回存活的粒子数。
+  uint32_t Step(float frames, float width, float height);
+
+  uint32_t count() const { return count_; }
+  uint32_t capacity() const { return capacity_; }
+
+  // 以下数组的前 count() 项有效，地址在对象存续期间不变。
+  // 每个粒子 4 个 float：scos, ssin, tx, ty。
+  const float* transforms() const { return transforms_.data(); }
+  // 每个粒子 4 个 float：left, top, right, bottom。
+  const float* rects() const { return rects_.data(); }
+  // 每个粒子一个 ARGB。
+  const uint32_t* colors() const { return colors_.data(); }
+
+ private:
+  uint32_t NextRandom();
+  float RandomRange(float min, float max);
+  void Place(uint32_t index, const ParticleSpawn& spawn);
+  void Respawn(uint32_t index, float width, float height);
+  void RemoveAt(uint32_t index);
+
+  const uint32_t capacity_;
+  uint32_t count_ = 0;
+  ParticleBehavior behavior_;
+  std::vector<uint32_t> palette_;
+  std::vector<float> sprite_rects_;
+  float sprite_radius_ = 1.0f;
+  uint32_t random_state_;
+
+  // SoA，长度按 SIMD 宽度向上取整，末尾的填充项保持为 0。
+  std::vector<float> x_;
+  std::vector<float> y_;
+  std::vector<float> vx_;
+  std::vector<float> vy_;
+  std::vector<float> rise_;
+  std::vector<float> size_;
+  std::vector<float> opacity_;
+  std::vector<float> angle_;
+  std::vector<uint32_t> base_color_;
+  std::vector<uint32_t> shape_;
+  std::vector<uint32_t> lane_random_;  // 每个粒子独立的随机数状态
+
+  std::vector<float> transforms_;
+  std::vector<float> rects_;
+  std::vector<uint32_t> colors_;
+};
+
+#endif  // RUNNER_PARTICLE_SYSTEM_H_
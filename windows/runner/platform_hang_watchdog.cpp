@@ -0,0 +1,88 @@
+#include "platform_hang_watchdog.h"
+
+#include <windows.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "hang_watchdog.h"
+#include "rotating_log.h"
+#include "startup_trace.h"
+#include "utils.h"
+
+namespace {
+
+constexpr wchar_t kWindowClassName[] = L"SUXINGCHAHUI_HANG_WATCHDOG";
+constexpr UINT kPingMessage = WM_APP + 0x101;
+constexpr wchar_t kLogDirName[] = L"logs";
+constexpr wchar_t kLogFileName[] = L"stalls.log";
+constexpr uint64_t kLogMaxBytes = 256 << 10;
+constexpr int kLogMaxFiles = 3;
+
+HWND g_ping_window = nullptr;
+
+LRESULT CALLBACK PingWindowProc(HWND window,
+                                UINT message,
+                                WPARAM wparam,
+                                LPARAM lparam) {
+  if (message == kPingMessage) {
+    HangWatchdog::GetInstance().Pong();
+    return 0;
+  }
+  return DefWindowProc(window, message, wparam, lparam);
+}
+
+}  // namespace
+
+bool StartPlatformHangWatchdog(int64_t threshold_ms) {
+  if (threshold_ms <= 0 || g_ping_window) {
+    return false;
+  }
+  WNDCLASSW window_class = {};
+  window_class.lpfnWndProc = PingWindowProc;
+  window_class.hInstance = GetModuleHandle(nullptr);
+  window_class.lpszClassName = kWindowClassName;
+  RegisterClassW(&window_class);
+  g_ping_window =
+      CreateWindowExW(0, kWindowClassName, L"", 0, 0, 0, 0, 0, HWND_MESSAGE,
+                      nullptr, window_class.hInstance, nullptr);
+  if (!g_ping_window) {
+    return false;
+  }
+
+  std::shared_ptr<RotatingLog> log;
+  const std::wstring app_data_dir = GetAppDataDirectory();
+  if (!app_data_dir.empty()) {
+    log = std::make_shared<RotatingLog>(
+        std::filesystem::path(app_data_dir) / kLogDirName / kLogFileName,
+        kLogMaxBytes, kLogMaxFiles);
+  }
+
+  const HWND ping_window = g_ping_window;
+  HangWatchdog& watchdog = HangWatchdog::GetInstance();
+  watchdog.Start(
+      threshold_ms,
+      [ping_window]() { PostMessage(ping_window, kPingMessage, 0, 0); },
+      []() {
+        const char* span = StartupTrace::GetInstance().watched_span();
+        return std::string(span ? span : "");
+      },
+      [log](const HangStall& stall) {
+        const std::string line = FormatHangStall(stall);
+        OutputDebugStringA((line + "\n").c_str());
+        if (log) {
+          log->Append(line);
+        }
+      });
+  watchdog.Busy(0);
+  return true;
+}
+
+void StopPlatformHangWatchdog() {
+  HangWatchdog::GetInstance().Stop();
+  if (g_ping_window) {
+    DestroyWindow(g_ping_window);
+    g_ping_window = nullptr;
+  }
+}
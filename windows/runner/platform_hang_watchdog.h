@@ -0,0 +1,17 @@
+#ifndef RUNNER_PLATFORM_HANG_WATCHDOG_H_
+#define RUNNER_PLATFORM_HANG_WATCHDOG_H_
+
+#include <cstdint>
+
+// 在平台线程上启动 HangWatchdog。
+//
+// 心跳发给一个只接收消息的窗口，主循环和 MessageBox 等模态循环都会分发
+// 它。卡顿记录写到应用数据目录下的 logs\stalls.log，超过 256KB 滚动，
+// 保留 3 个文件。调用后到进入消息循环之前算作忙碌，启动阶段的卡顿也会
+// 记录。|threshold_ms| 不大于 0 时不启动。
+bool StartPlatformHangWatchdog(int64_t threshold_ms);
+
+// 在平台线程上调用。
+void StopPlatformHangWatchdog();
+
+#endif  // RUNNER_PLATFORM_HANG_WATCHDOG_H_
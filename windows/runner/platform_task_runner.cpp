@@ -0,0 +1,40 @@
+#include "platform_task_runner.h"
+
+#include <utility>
+
+PlatformTaskRunner::PlatformTaskRunner(HWND window) : window_(window) {}
+
+bool PlatformTaskRunner::PostTask(std::function<void()> task) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!window_) {
+    return false;
+  }
+  tasks_.push_back(std::move(task));
+  if (!wake_pending_) {
+    wake_pending_ = ::PostMessage(window_, kRunTasksMessage, 0, 0) != FALSE;
+  }
+  return true;
+}
+
+void PlatformTaskRunner::RunPendingTasks() {
+  std::deque<std::function<void()>> tasks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks.swap(tasks_);
+    wake_pending_ = false;
+  }
+  // 任务执行期间可能继续投递新任务，它们会在下一条唤醒消息里执行
+  for (auto& task : tasks) {
+    task();
+  }
+}
+
+void PlatformTaskRunner::Shutdown() {
+  std::deque<std::function<void()>> tasks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    window_ = nullptr;
+    tasks.swap(tasks_);
+  }
+  // 在锁外析构，任务捕获的对象析构时可能再次调用 PostTask
+}
@@ -0,0 +1,41 @@
+#ifndef RUNNER_PLATFORM_TASK_RUNNER_H_
+#define RUNNER_PLATFORM_TASK_RUNNER_H_
+
+#include <windows.h>
+
+#include <deque>
+#include <functional>
+#include <mutex>
+
+// 把任务从工作线程切回平台线程（Flutter 窗口所在的 UI 线程）执行。
+//
+// MethodResult、EventSink 只能在平台线程上调用，原生的异步功能在工作线程上
+// 完成后通过这里回复 Dart。任务通过 kRunTasksMessage 唤醒窗口，由
+// FlutterWindow::MessageHandler 调用 RunPendingTasks 执行。
+class PlatformTaskRunner {
+ public:
+  static constexpr UINT kRunTasksMessage = WM_APP + 0x100;
+
+  explicit PlatformTaskRunner(HWND window);
+
+  PlatformTaskRunner(const PlatformTaskRunner&) = delete;
+  PlatformTaskRunner& operator=(const PlatformTaskRunner&) = delete;
+
+  // 可以在任意线程调用。Shutdown 之后投递的任务会被直接丢弃，返回 false。
+  bool PostTask(std::function<void()> task);
+
+  // 只能在平台线程调用。
+  void RunPendingTasks();
+
+  // 窗口销毁前调用，丢弃尚未执行的任务。
+  void Shutdown();
+
+ private:
+  std::mutex mutex_;
+  HWND window_;
+  std::deque<std::function<void()>> tasks_;
+  // 已经投递过唤醒消息、但还没被处理，避免消息队列里堆积重复的消息
+  bool wake_pending_ = false;
+};
+
+#endif  // RUNNER_PLATFORM_TASK_RUNNER_H_
@@ -1,11 +1,21 @@
 // pre_init_window.cpp
 #include "pre_init_window.h"
 #include <CommCtrl.h>
+#include <algorithm>
 #include <vector>
 #include <functional>
 #include <shlobj.h>
 #include <dwmapi.h>
 #include <shlwapi.h> 
+#include <filesystem>
+#include <mutex>
+
+#include "bundle_resources.h"
+#include "bundle_verifier.h"
+#include "hang_watchdog.h"
+#include "native_http_client.h"
+#include "thread_pool.h"
+#include "utils.h"
 
 #pragma comment(lib, "comctl32.lib")
 #pragma comment(lib, "dwmapi.lib")
@@ -34,8 +44,7 @@ PreInitWindow::PreInitWindow()
     : window_handle_(nullptr)
     , progress_bar_(nullptr)
     , status_text_(nullptr)
-    , timer_id_(0)
-    , current_check_(0) {
+    , timer_id_(0) {
     
     INITCOMMONCONTROLSEX icex = {
         sizeof(INITCOMMONCONTROLSEX),
@@ -80,6 +89,8 @@ PreInitWindow::PreInitWindow()
 }
 
 PreInitWindow::~PreInitWindow() {
+    // 先等待仍在执行的检查结束，它们可能还引用着本对象
+    scheduler_.reset();
     Cleanup();
 }
 
@@ -110,26 +121,24 @@ bool PreInitWindow::ShowPreInitCheck() {
     ShowWindow(window.window_handle_, SW_SHOW);
     UpdateWindow(window.window_handle_);
 
-    window.timer_id_ = SetTimer(window.window_handle_, 1, 50, nullptr);
-
-    // 消息循环带超时
-    DWORD start_time = GetTickCount();
-    const DWORD max_wait_time = 2000; // 2秒超时
-    bool result = true;
+    // 兜底超时，最后一个检查完成时窗口会立即关闭，不再固定等待
+    window.timer_id_ = SetTimer(window.window_handle_, 1, kMaxWaitMilliseconds, nullptr);
+    if (!window.StartChecks()) {
+        return false;
+    }
 
+    HangWatchdog& hang_watchdog = HangWatchdog::GetInstance();
     MSG msg;
-    while (GetTickCount() - start_time < max_wait_time) {
-        while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
-            if (msg.message == WM_QUIT) {
-                return msg.wParam != 0;
-            }
-            TranslateMessage(&msg);
-            DispatchMessage(&msg);
-        }
-        Sleep(1);
+    hang_watchdog.Idle();
+    while (GetMessage(&msg, nullptr, 0, 0) > 0) {
+        hang_watchdog.Busy(msg.message);
+        TranslateMessage(&msg);
+        DispatchMessage(&msg);
+        hang_watchdog.Idle();
     }
-
-    return result;
+    hang_watchdog.Busy(0);  // 回到启动流程
+    // WM_QUIT: wParam 为 1 表示检查通过
+    return msg.message == WM_QUIT && msg.wParam != 0;
 }
 
 void PreInitWindow::CreateControls() {
@@ -204,110 +213,306 @@ void PreInitWindow::UpdateStatus(const wchar_t* message, int progress) {
         UpdateWindow(window_handle_);
     }
 }
-std::vector<std::wstring> PreInitWindow::GetRequiredResources() {
-	return {
-			L"data\\flutter_assets",
-			L"data\\icudtl.dat",
-	};
+std::vector<std::wstring> PreInitWindow::GetPrefetchResources() {
+	std::vector<std::wstring> resources;
+	for (const auto& resource : PrefetchBundleResources()) {
+			resources.push_back(resource.wstring());
+	}
+	return resources;
 }
 
-bool PreInitWindow::RunChecks() {
-	struct CheckItem {
-			std::wstring message;
-			std::function<bool()> check;
-	};
+bool PreInitWindow::StartChecks() {
+	scheduler_ = std::make_unique<CheckScheduler>();
 
-	const CheckItem checks[] = {
-			{
-					L"Checking system requirements...",
-					[this]() {
-							SYSTEM_INFO si;
-							GetSystemInfo(&si);
-							if (si.wProcessorArchitecture != PROCESSOR_ARCHITECTURE_AMD64 && !has_shown_error_) {
-									MessageBoxW(window_handle_, L"System architecture not supported", L"Error", MB_ICONERROR);
-									has_shown_error_ = true;
-									return false;
-							}
-							return si.wProcessorArchitecture == PROCESSOR_ARCHITECTURE_AMD64;
+	const auto architecture = scheduler_->AddCheck(
+			L"Checking system requirements...",
+			[]() {
+					SYSTEM_INFO si;
+					GetSystemInfo(&si);
+					if (si.wProcessorArchitecture != PROCESSOR_ARCHITECTURE_AMD64) {
+							return CheckResult::Fail(L"System architecture not supported");
 					}
-			},
-			{
-					L"Checking runtime environment...",
-					[this]() {
-							if (HMODULE hModule = LoadLibraryW(L"vcruntime140.dll")) {
-									FreeLibrary(hModule);
-									return true;
-							}
-							if (!has_shown_error_) {
-									MessageBoxW(window_handle_, L"Required runtime not found: vcruntime140.dll", L"Error", MB_ICONERROR);
-									has_shown_error_ = true;
-							}
-							return false;
+					return CheckResult::Pass();
+			});
+
+	const auto runtime = scheduler_->AddCheck(
+			L"Checking runtime environment...",
+			[]() {
+					if (HMODULE hModule = LoadLibraryW(L"vcruntime140.dll")) {
+							FreeLibrary(hModule);
+							return CheckResult::Pass();
 					}
+					return CheckResult::Fail(L"Required runtime not found: vcruntime140.dll");
 			},
-			{
-					L"Checking storage access...",
-					[this]() {
-							wchar_t path[MAX_PATH];
-							if (!SUCCEEDED(SHGetFolderPathW(nullptr, CSIDL_LOCAL_APPDATA, nullptr, 0, path)) && !has_shown_error_) {
-									MessageBoxW(window_handle_, L"Unable to access local storage", L"Error", MB_ICONERROR);
-									has_shown_error_ = true;
-									return false;
-							}
-							return SUCCEEDED(SHGetFolderPathW(nullptr, CSIDL_LOCAL_APPDATA, nullptr, 0, path));
+			{architecture});
+
+	scheduler_->AddCheck(
+			L"Checking storage access...",
+			[]() {
+					wchar_t path[MAX_PATH];
+					if (!SUCCEEDED(SHGetFolderPathW(nullptr, CSIDL_LOCAL_APPDATA, nullptr, 0, path))) {
+							return CheckResult::Fail(L"Unable to access local storage");
 					}
+					return CheckResult::Pass();
+			});
+
+	const auto resources = scheduler_->AddCheck(
+			L"Checking resource files...",
+			[this]() { return this->CheckResourceFiles(); },
+			{architecture});
+
+	// 网络检查依赖运行库（WinHTTP 在 vcruntime 之上）
+	const auto network = scheduler_->AddCheck(
+			L"Checking network...",
+			[this]() { return this->CheckNetworkSecurity(); },
+			{runtime});
+
+	// 完整性校验和证书固定探测即使超时也要等到结果，失败时不能继续启动
+	scheduler_->SetRequired(resources);
+	scheduler_->SetRequired(network);
+
+	// 回调在工作线程上执行，只投递消息，不直接操作窗口
+	const HWND hwnd = window_handle_;
+	return scheduler_->Start(
+			[hwnd](CheckScheduler::CheckId id, CheckStatus status) {
+					PostMessageW(hwnd, kCheckProgressMessage, static_cast<WPARAM>(id),
+							static_cast<LPARAM>(status));
 			},
-			{
-					L"Checking resource files...",
-					[this]() { return this->CheckResourceFiles(); }
-			},
-			{
-				L"Checking network...",
-				[this]() { return this->CheckNetworkSecurity(); }
-			}
-	};
+			[hwnd](bool all_passed) {
+					PostMessageW(hwnd, kChecksCompleteMessage, all_passed ? 1 : 0, 0);
+			});
+}
+
+void PreInitWindow::OnCheckProgress(CheckScheduler::CheckId id, CheckStatus status) {
+	if (!scheduler_) {
+			return;
+	}
+	const size_t total = scheduler_->check_count();
+	const int progress = total == 0
+			? 100
+			: static_cast<int>((scheduler_->resolved_count() * 100) / total);
+	if (status == CheckStatus::kRunning) {
+			UpdateStatus(scheduler_->name(id).c_str(), progress);
+	} else if (progress_bar_) {
+			SendMessage(progress_bar_, PBM_SETPOS, progress, 0);
+	}
+}
 
-	const int total_checks = sizeof(checks) / sizeof(checks[0]);
+void PreInitWindow::OnChecksComplete(bool all_passed) {
+	if (timer_id_) {
+			KillTimer(window_handle_, timer_id_);
+			timer_id_ = 0;
+	}
 
-	if (current_check_ >= total_checks) {
+	if (all_passed) {
 			UpdateStatus(L"Initialization complete", 100);
-			Sleep(100);
 			PostQuitMessage(1);
-			return true;
+			return;
 	}
 
-	const auto& check = checks[current_check_];
-	UpdateStatus(check.message.c_str(), (current_check_ * 100) / total_checks);
-
-	bool check_result = check.check();
-	if (!check_result) {
-			KillTimer(window_handle_, timer_id_);  // 在检查失败时也停止定时器
-			timer_id_ = 0;
+	// 找到第一个失败的检查并提示（只提示一次）
+	for (CheckScheduler::CheckId id = 0; id < scheduler_->check_count(); ++id) {
+			if (scheduler_->status(id) != CheckStatus::kFailed) {
+					continue;
+			}
+			const CheckResult result = scheduler_->result(id);
+			if (!has_shown_error_ && !result.error.empty()) {
+					MessageBoxW(window_handle_, result.error.c_str(), L"Error", MB_ICONERROR);
+					has_shown_error_ = true;
+			}
 			PostQuitMessage(0);
-			return false;
+			return;
 	}
-	current_check_++;
-	return true;
+
+	// 没有失败，只是超时后跳过了非必需检查
+	UpdateStatus(L"Initialization complete", 100);
+	PostQuitMessage(1);
+}
+
+void PreInitWindow::OnCheckTimeout() {
+	KillTimer(window_handle_, timer_id_);
+	timer_id_ = 0;
+	if (!scheduler_) {
+			PostQuitMessage(1);
+			return;
+	}
+	// 跳过尚未开始的非必需检查；必需检查结束后由 kChecksCompleteMessage 关闭窗口
+	scheduler_->CancelOptional();
+	UpdateStatus(L"Verifying installation and secure connection...",
+			static_cast<int>((scheduler_->resolved_count() * 100) /
+					std::max<size_t>(1, scheduler_->check_count())));
 }
 
 // 初始化静态变量
 HINTERNET PreInitWindow::http_session_ = NULL;
 
-// 实现网络安全检查方法
-// 实现网络安全检查方法
-bool PreInitWindow::CheckNetworkSecurity() {
-    // 检查 TLS 安全设置
-    //bool tlsCheck = VerifyTLSSettings();
+bool PreInitWindow::SetupSecureNetworkLayer() {
+	static std::once_flag once;
+	std::call_once(once, []() {
+			http_session_ = WinHttpOpen(L"suxingchahui", WINHTTP_ACCESS_TYPE_AUTOMATIC_PROXY,
+					WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
+			if (!http_session_) {
+					return;
+			}
+			// 只允许 TLS 1.2 及以上
+			DWORD protocols = WINHTTP_FLAG_SECURE_PROTOCOL_TLS1_2;
+#ifdef WINHTTP_FLAG_SECURE_PROTOCOL_TLS1_3
+			protocols |= WINHTTP_FLAG_SECURE_PROTOCOL_TLS1_3;
+#endif
+			if (!WinHttpSetOption(http_session_, WINHTTP_OPTION_SECURE_PROTOCOLS, &protocols, sizeof(protocols))) {
+					// 旧系统不认识 TLS 1.3 标志，退回只用 TLS 1.2
+					protocols = WINHTTP_FLAG_SECURE_PROTOCOL_TLS1_2;
+					WinHttpSetOption(http_session_, WINHTTP_OPTION_SECURE_PROTOCOLS, &protocols, sizeof(protocols));
+			}
+			WinHttpSetTimeouts(http_session_, kProbeStageTimeoutMilliseconds, kProbeStageTimeoutMilliseconds,
+					kProbeStageTimeoutMilliseconds, kProbeStageTimeoutMilliseconds);
+	});
+	return http_session_ != NULL;
+}
+
+CertificatePinner& PreInitWindow::GetCertificatePinner() {
+	static CertificatePinner pinner;
+	static std::once_flag once;
+	std::call_once(once, []() {
+			const std::wstring exe_dir = GetExecutableDirectory();
+			if (exe_dir.empty()) {
+					return;
+			}
+			// 文件在 data 目录下，由完整性清单保护；格式错误时整个文件不生效
+			pinner.LoadPinsFromFile(std::filesystem::path(exe_dir) / kBundleDataDirectory / kCertificatePinsFileName);
+	});
+	return pinner;
+}
+
+bool PreInitWindow::ValidateCertificate(const char* hostname, const uint8_t* certData, size_t certSize) {
+	const PinVerdict verdict = GetCertificatePinner().Check(hostname, certData, certSize);
+	return verdict == PinVerdict::kAllowed || verdict == PinVerdict::kNotPinned;
+}
+
+std::vector<uint8_t> PreInitWindow::CalculateCertificateHash(const uint8_t* certData, size_t certSize) {
+	Sha256Digest digest;
+	if (!ComputeSpkiDigest(certData, certSize, &digest)) {
+			return {};
+	}
+	return std::vector<uint8_t>(digest.begin(), digest.end());
+}
+
+std::string PreInitWindow::HashToString(const std::vector<uint8_t>& hash) {
+	return BytesToHex(hash.data(), hash.size());
+}
+
+std::vector<uint8_t> PreInitWindow::GetPinnedCertificateHash(const char* hostname) {
+	const std::vector<Sha256Digest> pins = GetCertificatePinner().FindPins(hostname);
+	if (pins.empty()) {
+			return {};
+	}
+	return std::vector<uint8_t>(pins.front().begin(), pins.front().end());
+}
+
+bool PreInitWindow::ValidateServerCertificate(const char* hostname, PCCERT_CONTEXT certificate) {
+	const PinVerdict verdict = CheckServerCertificate(hostname, certificate);
+	return verdict == PinVerdict::kAllowed || verdict == PinVerdict::kNotPinned;
+}
+
+PinVerdict PreInitWindow::CheckServerCertificate(const char* hostname, PCCERT_CONTEXT certificate) {
+	CertificatePinner& pinner = GetCertificatePinner();
+	PinVerdict verdict = pinner.Check(hostname, certificate->pbCertEncoded, certificate->cbCertEncoded);
+	if (verdict != PinVerdict::kMismatch) {
+			return verdict;
+	}
 
+	// 叶子证书不匹配时再看中间证书和根证书（固定 CA 公钥的情况）
+	CERT_CHAIN_PARA chain_para = {};
+	chain_para.cbSize = sizeof(chain_para);
+	PCCERT_CHAIN_CONTEXT chain = nullptr;
+	if (!CertGetCertificateChain(nullptr, certificate, nullptr, certificate->hCertStore,
+			&chain_para, 0, nullptr, &chain)) {
+			return verdict;
+	}
+	for (DWORD i = 0; i < chain->cChain && verdict != PinVerdict::kAllowed; ++i) {
+			const PCERT_SIMPLE_CHAIN simple_chain = chain->rgpChain[i];
+			for (DWORD j = 0; j < simple_chain->cElement; ++j) {
+					const PCCERT_CONTEXT element = simple_chain->rgpElement[j]->pCertContext;
+					if (pinner.Check(hostname, element->pbCertEncoded, element->cbCertEncoded) == PinVerdict::kAllowed) {
+							verdict = PinVerdict::kAllowed;
+							break;
+					}
+			}
+	}
+	CertFreeCertificateChain(chain);
+	return verdict;
+}
+
+CheckResult PreInitWindow::ProbePinnedHost(const std::string& hostname) {
+	const std::wstring host(hostname.begin(), hostname.end());
+	HINTERNET connection = WinHttpConnect(http_session_, host.c_str(), INTERNET_DEFAULT_HTTPS_PORT, 0);
+	HINTERNET request = connection
+			? WinHttpOpenRequest(connection, L"HEAD", L"/", nullptr, WINHTTP_NO_REFERER,
+					WINHTTP_DEFAULT_ACCEPT_TYPES, WINHTTP_FLAG_SECURE)
+			: NULL;
+
+	// 同步模式下握手在 WinHttpSendRequest 中完成，之后即可取得服务器证书
+	PinVerdict verdict = PinVerdict::kNotPinned;
+	if (request && WinHttpSendRequest(request, WINHTTP_NO_ADDITIONAL_HEADERS, 0,
+			WINHTTP_NO_REQUEST_DATA, 0, 0, 0)) {
+			PCCERT_CONTEXT certificate = nullptr;
+			DWORD size = sizeof(certificate);
+			if (WinHttpQueryOption(request, WINHTTP_OPTION_SERVER_CERT_CONTEXT, &certificate, &size) && certificate) {
+					verdict = CheckServerCertificate(hostname.c_str(), certificate);
+					CertFreeCertificateContext(certificate);
+			}
+	}
+	if (request) WinHttpCloseHandle(request);
+	if (connection) WinHttpCloseHandle(connection);
+
+	if (verdict == PinVerdict::kMismatch || verdict == PinVerdict::kMalformed) {
+			return CheckResult::Fail(L"The secure connection to " + host +
+					L" could not be verified.\nYour network may be intercepting encrypted traffic.");
+	}
+	// 离线、超时等网络错误不阻止启动
+	return CheckResult::Pass();
+}
+
+// 实现网络安全检查方法
+CheckResult PreInitWindow::CheckNetworkSecurity() {
+    CertificatePinner& pinner = GetCertificatePinner();
+
+    // 通配符无法直接探测，只探测具体主机
+    std::vector<std::string> hosts;
+    for (const auto& pattern : pinner.host_patterns()) {
+        if (pattern.rfind("*.", 0) != 0) {
+            hosts.push_back(pattern);
+        }
+    }
 
-    // if (!tlsCheck && !has_shown_error_) { // <--- 把这行注释掉
-    //     MessageBoxW(window_handle_, L"setting warning,connection is not safe",
-    //                L"waring", MB_ICONWARNING); // <--- 把这行注释掉 (或者直接删除这两行)
-    // } // <--- 把这行注释掉
+    // 在后台为 API 主机预热连接，不等待结果；Flutter 起来后的第一批请求
+    // 直接复用这些连接。固定了证书的主机一定是 API 主机，也一起预热
+    NativeHttpClient& http_client = NativeHttpClient::GetInstance();
+    std::vector<HttpOrigin> prewarm_origins = http_client.LoadPrewarmOrigins();
+    for (const auto& host : hosts) {
+        HttpOrigin origin;
+        origin.host = host;
+        if (std::find(prewarm_origins.begin(), prewarm_origins.end(), origin) == prewarm_origins.end()) {
+            prewarm_origins.push_back(origin);
+        }
+    }
+    http_client.PrewarmAsync(prewarm_origins);
 
+    if (hosts.empty() || !SetupSecureNetworkLayer()) {
+        return CheckResult::Pass();
+    }
 
-    // 即使有警告也继续，但记录了警告状态
-    return true;
+    // 各主机并行探测，总耗时约等于一次握手
+    std::vector<CheckResult> results(hosts.size(), CheckResult::Pass());
+    ParallelFor(hosts.size(), hosts.size(), [&](size_t i) {
+        results[i] = ProbePinnedHost(hosts[i]);
+    });
+    for (const auto& result : results) {
+        if (!result.passed) {
+            return result;
+        }
+    }
+    return CheckResult::Pass();
 }
 
 //bool PreInitWindow::VerifyTLSSettings() {
@@ -371,53 +576,105 @@ bool PreInitWindow::CheckSystemProxies() {
     return false;
 }
 
-bool PreInitWindow::CheckResourceFiles() {
-	const auto resources = GetRequiredResources();
+CheckResult PreInitWindow::CheckResourceFiles() const {
+	const std::wstring exe_dir = GetExecutableDirectory();
 	std::wstring missing_files;
-	
-	for (const auto& resource : resources) {
-			wchar_t full_path[MAX_PATH];
-			if (GetModuleFileNameW(nullptr, full_path, MAX_PATH) == 0) {
-					continue;
-			}
-			
-			if (!PathRemoveFileSpecW(full_path)) {
-					continue;
-			}
-			
-			if (!PathAppendW(full_path, resource.c_str())) {
-					continue;
-			}
-			
-			if (GetFileAttributesW(full_path) == INVALID_FILE_ATTRIBUTES) {
+	if (!exe_dir.empty()) {
+			for (const auto& resource : FindMissingResources(exe_dir, RequiredBundleResources())) {
 					if (!missing_files.empty()) {
 							missing_files += L"\n";
 					}
-					missing_files += resource;
+					missing_files += resource.wstring();
 			}
 	}
 	
-	if (!missing_files.empty() && !has_shown_error_) {
-			std::wstring error_message = L"Missing required files:\n" + missing_files;
-			MessageBoxW(window_handle_, error_message.c_str(), L"Resource Error", MB_ICONERROR);
-			has_shown_error_ = true;
-			return false;
+	if (!missing_files.empty()) {
+			return CheckResult::Fail(L"Missing required files:\n" + missing_files);
 	}
 	
-	return missing_files.empty();
+	return VerifyBundleIntegrity();
+}
+
+CheckResult PreInitWindow::VerifyBundleIntegrity() {
+	const std::wstring exe_dir = GetExecutableDirectory();
+	if (exe_dir.empty()) {
+			return CheckResult::Pass();
+	}
+	const std::filesystem::path data_dir = std::filesystem::path(exe_dir) / kBundleDataDirectory;
+
+	// 开发构建没有清单，只做上面的存在性检查
+	BundleManifest manifest;
+	if (!ReadBundleManifest(data_dir / kBundleManifestFileName, &manifest)) {
+			return CheckResult::Pass();
+	}
+
+	// 指纹缓存放在本地应用数据目录，热启动只重新计算变化过的文件
+	BundleFingerprintCache cache;
+	std::filesystem::path cache_file;
+	const std::wstring app_data_dir = GetAppDataDirectory();
+	if (!app_data_dir.empty()) {
+			cache_file = std::filesystem::path(app_data_dir) / kBundleFingerprintCacheFileName;
+			cache.Load(cache_file, data_dir);
+	}
+
+	const BundleVerifyResult result = VerifyBundle(data_dir, manifest, &cache);
+	if (!cache_file.empty() && result.hashed_files > 0) {
+			cache.Save(cache_file, data_dir);
+	}
+	if (result.ok()) {
+			return CheckResult::Pass();
+	}
+
+	// 列出前几个有问题的文件，提示重新完整解压
+	constexpr size_t kMaxListedFiles = 8;
+	std::wstring message = L"The installation is incomplete or damaged:\n";
+	size_t listed = 0;
+	auto list_files = [&](const std::vector<std::string>& files, const wchar_t* reason) {
+			for (const auto& file : files) {
+					if (listed++ >= kMaxListedFiles) {
+							return;
+					}
+					message += std::filesystem::u8path(file).wstring() + L" (" + reason + L")\n";
+			}
+	};
+	list_files(result.missing, L"missing");
+	list_files(result.corrupted, L"damaged");
+	const size_t total = result.missing.size() + result.corrupted.size();
+	if (total > kMaxListedFiles) {
+			message += L"... and " + std::to_wstring(total - kMaxListedFiles) + L" more\n";
+	}
+	message += L"\nPlease extract the whole archive again before starting the app.";
+	return CheckResult::Fail(message);
+}
+
+bool PreInitWindow::WriteBundleManifest() {
+	const std::wstring exe_dir = GetExecutableDirectory();
+	if (exe_dir.empty()) {
+			return false;
+	}
+	const std::filesystem::path data_dir = std::filesystem::path(exe_dir) / kBundleDataDirectory;
+	BundleManifest manifest;
+	if (!BuildBundleManifest(data_dir, &manifest)) {
+			return false;
+	}
+	return ::WriteBundleManifest(data_dir / kBundleManifestFileName, manifest);
 }
 
 LRESULT CALLBACK PreInitWindow::WindowProc(HWND hwnd, UINT msg, WPARAM wp, LPARAM lp) {
 	if (PreInitWindow* window = reinterpret_cast<PreInitWindow*>(GetWindowLongPtr(hwnd, GWLP_USERDATA))) {
 			switch (msg) {
+					case kCheckProgressMessage:
+							window->OnCheckProgress(static_cast<CheckScheduler::CheckId>(wp),
+									static_cast<CheckStatus>(lp));
+							return 0;
+
+					case kChecksCompleteMessage:
+							window->OnChecksComplete(wp != 0);
+							return 0;
+
 					case WM_TIMER:
-							if (wp == window->timer_id_ && !window->is_checking_) {
-									window->is_checking_ = true;  // 设置检查标志
-									if (!window->RunChecks()) {
-											KillTimer(hwnd, window->timer_id_);  // 停止定时器
-											window->timer_id_ = 0;
-									}
-									window->is_checking_ = false;  // 清除检查标志
+							if (wp == window->timer_id_) {
+									window->OnCheckTimeout();
 							}
 							return 0;
 
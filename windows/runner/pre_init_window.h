@@ -15,6 +15,9 @@
 #include <functional>
 #include <memory>
 
+#include "cert_pinning.h"
+#include "check_scheduler.h"
+
 #pragma comment(lib, "Shlwapi.lib")
 
 class PreInitWindow {
@@ -37,9 +40,18 @@ public:
 		// 静态方法：计算证书哈希
 		static std::vector<uint8_t> CalculateCertificateHash(const uint8_t* certData, size_t certSize);
 		
+		// 静态方法：校验 WinHTTP 连接的服务器证书链（未固定的主机直接通过）
+		static bool ValidateServerCertificate(const char* hostname, PCCERT_CONTEXT certificate);
+		
 		// 静态方法：将哈希转换为字符串
 		static std::string HashToString(const std::vector<uint8_t>& hash);
 
+		// 静态方法：为 data 目录生成完整性清单（安装步骤通过 --write-bundle-manifest 调用）
+		static bool WriteBundleManifest();
+
+		// 静态方法：启动时预读的文件（相对可执行文件目录），见 bundle_resources.h
+		static std::vector<std::wstring> GetPrefetchResources();
+
 private:
     class WindowClass {
     public:
@@ -56,14 +68,26 @@ private:
         HINSTANCE instance_;
     };
 
+    // 工作线程通过 PostMessage 把检查进度切回 UI 线程
+    static constexpr UINT kCheckProgressMessage = WM_APP + 1;
+    static constexpr UINT kChecksCompleteMessage = WM_APP + 2;
+    // 兜底超时（与旧版 2 秒窗口一致）：到时跳过尚未开始的非必需检查，
+    // 完整性校验和证书固定等必需检查仍然等待结果
+    static constexpr UINT kMaxWaitMilliseconds = 2000;
+
     static LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
     void CreateControls();
     void UpdateStatus(const wchar_t* message, int progress);
-    bool RunChecks();
+    bool StartChecks();
+    void OnCheckProgress(CheckScheduler::CheckId id, CheckStatus status);
+    void OnChecksComplete(bool all_passed);
+    void OnCheckTimeout();
     void Cleanup();
-    bool CheckResourceFiles();
+    CheckResult CheckResourceFiles() const;
+    // 按安装时生成的清单校验 data 目录，发现截断或解压不完整的文件
+    static CheckResult VerifyBundleIntegrity();
 		// 网络安全检查方法
-		bool CheckNetworkSecurity();
+		CheckResult CheckNetworkSecurity();
 				
 		// TLS 设置验证
 		//bool VerifyTLSSettings();
@@ -73,22 +97,36 @@ private:
 		
 		// 获取固定证书哈希
 		static std::vector<uint8_t> GetPinnedCertificateHash(const char* hostname);
+
+		// 固定值从 data\certificate_pins.conf 读取，文件不存在时不做固定
+		static CertificatePinner& GetCertificatePinner();
+
+		// 校验服务器证书链，链上任意一张证书的公钥匹配即通过
+		static PinVerdict CheckServerCertificate(const char* hostname, PCCERT_CONTEXT certificate);
+
+		// 对一个已固定的主机发起一次 HEAD 请求并校验证书
+		static CheckResult ProbePinnedHost(const std::string& hostname);
 		
 		// WinHTTP 会话句柄
 		static HINTERNET http_session_;
+		static constexpr const wchar_t* kCertificatePinsFileName = L"certificate_pins.conf";
+		// 探测请求每个阶段（解析、连接、发送、接收）的超时，限定兜底超时后还需等待的时间
+		static constexpr int kProbeStageTimeoutMilliseconds = 450;
 		
-    static std::vector<std::wstring> GetRequiredResources();
-		bool is_checking_ = false;  // 添加此变量
+    static constexpr const wchar_t* kBundleDataDirectory = L"data";
+    static constexpr const wchar_t* kBundleFingerprintCacheFileName = L"bundle_fingerprints.bin";
 
     static WindowClass window_class_;
 
     HWND window_handle_;
     HWND progress_bar_;
     HWND status_text_;
-    UINT_PTR timer_id_;
-    int current_check_;
+    UINT_PTR timer_id_;  // 兜底超时定时器
     bool has_shown_error_ = false;
 
+    // 并发检查调度器，回调通过 kCheckProgressMessage/kChecksCompleteMessage 回到 UI 线程
+    std::unique_ptr<CheckScheduler> scheduler_;
+
     struct WindowDeleter {
         void operator()(HWND hwnd) const {
             if (hwnd) {
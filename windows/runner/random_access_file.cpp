@@ -0,0 +1,178 @@
+#include "random_access_file.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+RandomAccessFile::~RandomAccessFile() {
+  Close();
+}
+
+#ifdef _WIN32
+
+namespace {
+
+// ReadFile/WriteFile 的长度是 DWORD，大块分成多次传输
+constexpr size_t kMaxTransfer = 1u << 30;
+
+OVERLAPPED OffsetOverlapped(uint64_t offset) {
+  OVERLAPPED overlapped = {};
+  overlapped.Offset = static_cast<DWORD>(offset);
+  overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+  return overlapped;
+}
+
+}  // namespace
+
+bool RandomAccessFile::Open(const std::filesystem::path& path) {
+  Close();
+  HANDLE file = ::CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                              FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                              OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  handle_ = file;
+  return true;
+}
+
+void RandomAccessFile::Close() {
+  if (handle_) {
+    ::CloseHandle(handle_);
+    handle_ = nullptr;
+  }
+}
+
+bool RandomAccessFile::Resize(uint64_t size) {
+  FILE_END_OF_FILE_INFO info;
+  info.EndOfFile.QuadPart = static_cast<LONGLONG>(size);
+  return handle_ && ::SetFileInformationByHandle(handle_, FileEndOfFileInfo,
+                                                 &info, sizeof(info));
+}
+
+bool RandomAccessFile::WriteAt(uint64_t offset,
+                               const void* data,
+                               size_t size) {
+  const char* input = static_cast<const char*>(data);
+  while (size > 0) {
+    const DWORD chunk = static_cast<DWORD>(std::min(size, kMaxTransfer));
+    OVERLAPPED overlapped = OffsetOverlapped(offset);
+    DWORD written = 0;
+    if (!handle_ ||
+        !::WriteFile(handle_, input, chunk, &written, &overlapped) ||
+        written == 0) {
+      return false;
+    }
+    input += written;
+    offset += written;
+    size -= written;
+  }
+  return true;
+}
+
+bool RandomAccessFile::ReadAt(uint64_t offset, void* data, size_t size) const {
+  char* output = static_cast<char*>(data);
+  while (size > 0) {
+    const DWORD chunk = static_cast<DWORD>(std::min(size, kMaxTransfer));
+    OVERLAPPED overlapped = OffsetOverlapped(offset);
+    DWORD read = 0;
+    if (!handle_ || !::ReadFile(handle_, output, chunk, &read, &overlapped) ||
+        read == 0) {
+      return false;
+    }
+    output += read;
+    offset += read;
+    size -= read;
+  }
+  return true;
+}
+
+bool RandomAccessFile::Sync() {
+  return handle_ && ::FlushFileBuffers(handle_);
+}
+
+uint64_t RandomAccessFile::size() const {
+  LARGE_INTEGER size;
+  if (!handle_ || !::GetFileSizeEx(handle_, &size)) {
+    return 0;
+  }
+  return static_cast<uint64_t>(size.QuadPart);
+}
+
+bool RandomAccessFile::is_open() const {
+  return handle_ != nullptr;
+}
+
+#else
+
+bool RandomAccessFile::Open(const std::filesystem::path& path) {
+  Close();
+  fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  return fd_ >= 0;
+}
+
+void RandomAccessFile::Close() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+}
+
+bool RandomAccessFile::Resize(uint64_t size) {
+  return fd_ >= 0 && ::ftruncate(fd_, static_cast<off_t>(size)) == 0;
+}
+
+bool RandomAccessFile::WriteAt(uint64_t offset,
+                               const void* data,
+                               size_t size) {
+  const char* input = static_cast<const char*>(data);
+  while (size > 0) {
+    const ssize_t written =
+        ::pwrite(fd_, input, size, static_cast<off_t>(offset));
+    if (written <= 0) {
+      return false;
+    }
+    input += written;
+    offset += static_cast<uint64_t>(written);
+    size -= static_cast<size_t>(written);
+  }
+  return true;
+}
+
+bool RandomAccessFile::ReadAt(uint64_t offset, void* data, size_t size) const {
+  char* output = static_cast<char*>(data);
+  while (size > 0) {
+    const ssize_t read = ::pread(fd_, output, size, static_cast<off_t>(offset));
+    if (read <= 0) {
+      return false;
+    }
+    output += read;
+    offset += static_cast<uint64_t>(read);
+    size -= static_cast<size_t>(read);
+  }
+  return true;
+}
+
+bool RandomAccessFile::Sync() {
+  return fd_ >= 0 && ::fsync(fd_) == 0;
+}
+
+uint64_t RandomAccessFile::size() const {
+  struct stat info;
+  if (fd_ < 0 || ::fstat(fd_, &info) != 0) {
+    return 0;
+  }
+  return static_cast<uint64_t>(info.st_size);
+}
+
+bool RandomAccessFile::is_open() const {
+  return fd_ >= 0;
+}
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef RUNNER_RANDOM_ACCESS_FILE_H_
+#define RUNNER_RANDOM_ACCESS_FILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+// 按偏移量读写的文件。Windows 使用带 OVERLAPPED 偏移的 ReadFile/WriteFile，
+// 其它平台使用 pread/pwrite，不共享文件指针，多个线程可以同时读写不重叠
+// 的区域。
+class RandomAccessFile {
+ public:
+  RandomAccessFile() = default;
+  ~RandomAccessFile();
+
+  RandomAccessFile(const RandomAccessFile&) = delete;
+  RandomAccessFile& operator=(const RandomAccessFile&) = delete;
+
+  // 以读写方式打开，文件不存在时创建。
+  bool Open(const std::filesystem::path& path);
+  void Close();
+
+  // 调整文件大小，扩展出的部分为 0。
+  bool Resize(uint64_t size);
+  bool WriteAt(uint64_t offset, const void* data, size_t size);
+  // 读满 |size| 字节才返回 true。
+  bool ReadAt(uint64_t offset, void* data, size_t size) const;
+  // 把已写入的数据刷到磁盘。
+  bool Sync();
+
+  uint64_t size() const;
+  bool is_open() const;
+
+ private:
+#ifdef _WIN32
+  void* handle_ = nullptr;
+#else
+  int fd_ = -1;
+#endif
+};
+
+#endif  // RUNNER_RANDOM_ACCESS_FILE_H_
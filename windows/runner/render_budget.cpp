@@ -0,0 +1,38 @@
+#include "render_budget.h"
+
+RenderBudget::RenderBudget(int64_t downgrade_delay_us)
+    : downgrade_delay_us_(downgrade_delay_us > 0 ? downgrade_delay_us : 0) {}
+
+bool RenderBudget::Update(const RenderBudgetSignals& signals, int64_t now_us) {
+  RenderBudgetLevel target = RenderBudgetLevel::kFull;
+  bool immediate = false;
+  if (signals.minimized || signals.session_locked || signals.display_off) {
+    target = RenderBudgetLevel::kPaused;
+    immediate = true;
+  } else if (signals.occluded) {
+    target = RenderBudgetLevel::kPaused;
+  } else if (signals.on_battery || signals.battery_saver) {
+    target = RenderBudgetLevel::kReduced;
+  }
+
+  if (target <= level_ || immediate) {
+    // 升级或确定的降级立即生效
+    pending_ = false;
+    if (target == level_) {
+      return false;
+    }
+    level_ = target;
+    return true;
+  }
+  if (!pending_ || pending_level_ != target) {
+    pending_ = true;
+    pending_level_ = target;
+    pending_since_us_ = now_us;
+  }
+  if (now_us - pending_since_us_ < downgrade_delay_us_) {
+    return false;
+  }
+  pending_ = false;
+  level_ = target;
+  return true;
+}
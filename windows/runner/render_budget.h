@@ -0,0 +1,52 @@
+#ifndef RUNNER_RENDER_BUDGET_H_
+#define RUNNER_RENDER_BUDGET_H_
+
+#include <cstdint>
+
+// 背景动画的渲染预算（与平台无关）。
+//
+// 窗口最小化、锁屏、显示器关闭或被其它窗口完全遮挡时暂停；使用电池或
+// 开启节电模式时降帧；其余情况全速。恢复到更高的预算立即生效；遮挡和
+// 电源变化导致的降级要持续一段时间才生效，避免切换窗口时反复暂停。
+// 最小化、锁屏和关屏是确定的状态，立即降级。时间单位为微秒。
+enum class RenderBudgetLevel : int32_t {
+  kFull = 0,
+  kReduced = 1,
+  kPaused = 2,
+};
+
+struct RenderBudgetSignals {
+  bool minimized = false;
+  bool occluded = false;
+  bool session_locked = false;
+  bool display_off = false;
+  bool on_battery = false;
+  bool battery_saver = false;
+};
+
+class RenderBudget {
+ public:
+  explicit RenderBudget(int64_t downgrade_delay_us = 1000000);
+
+  RenderBudget(const RenderBudget&) = delete;
+  RenderBudget& operator=(const RenderBudget&) = delete;
+
+  // 返回级别是否变化。
+  bool Update(const RenderBudgetSignals& signals, int64_t now_us);
+
+  RenderBudgetLevel level() const { return level_; }
+
+  // 正在等待降级时，到这个时刻需要再调用一次 Update；否则为 -1。
+  int64_t deadline_us() const {
+    return pending_ ? pending_since_us_ + downgrade_delay_us_ : -1;
+  }
+
+ private:
+  const int64_t downgrade_delay_us_;
+  RenderBudgetLevel level_ = RenderBudgetLevel::kFull;
+  bool pending_ = false;
+  RenderBudgetLevel pending_level_ = RenderBudgetLevel::kFull;
+  int64_t pending_since_us_ = 0;
+};
+
+#endif  // RUNNER_RENDER_BUDGET_H_
@@ -0,0 +1,45 @@
+#include "render_budget_channel.h"
+
+#include <flutter/event_stream_handler_functions.h>
+#include <flutter/standard_method_codec.h>
+
+#include <utility>
+
+namespace {
+
+constexpr char kChannelName[] = "com.example.suxingchahui/render_budget";
+
+using flutter::EncodableValue;
+
+EncodableValue Encode(RenderBudgetLevel level) {
+  return EncodableValue(static_cast<int32_t>(level));
+}
+
+}  // namespace
+
+RenderBudgetChannel::RenderBudgetChannel(flutter::BinaryMessenger* messenger)
+    : channel_(std::make_unique<flutter::EventChannel<EncodableValue>>(
+          messenger, kChannelName,
+          &flutter::StandardMethodCodec::GetInstance())) {
+  channel_->SetStreamHandler(
+      std::make_unique<flutter::StreamHandlerFunctions<EncodableValue>>(
+          [this](const EncodableValue* /*arguments*/,
+                 std::unique_ptr<flutter::EventSink<EncodableValue>>&& events)
+              -> std::unique_ptr<flutter::StreamHandlerError<EncodableValue>> {
+            sink_ = std::move(events);
+            sink_->Success(Encode(level_));
+            return nullptr;
+          },
+          [this](const EncodableValue* /*arguments*/)
+              -> std::unique_ptr<flutter::StreamHandlerError<EncodableValue>> {
+            sink_ = nullptr;
+            return nullptr;
+          }));
+}
+
+void RenderBudgetChannel::Send(RenderBudgetLevel level) {
+  level_ = level;
+  if (sink_) {
+    sink_->Success(Encode(level));
+  }
+}
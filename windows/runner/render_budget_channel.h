@@ -0,0 +1,34 @@
+#ifndef RUNNER_RENDER_BUDGET_CHANNEL_H_
+#define RUNNER_RENDER_BUDGET_CHANNEL_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+#include <flutter/event_channel.h>
+#include <flutter/event_sink.h>
+
+#include <memory>
+
+#include "render_budget.h"
+
+// 把背景动画的渲染预算推送给 Dart，见 render_budget.h。
+//
+// 通道：com.example.suxingchahui/render_budget（EventChannel）
+//   事件为 int：0 全速，1 降帧，2 暂停。开始监听时先发送当前级别。
+class RenderBudgetChannel {
+ public:
+  explicit RenderBudgetChannel(flutter::BinaryMessenger* messenger);
+
+  RenderBudgetChannel(const RenderBudgetChannel&) = delete;
+  RenderBudgetChannel& operator=(const RenderBudgetChannel&) = delete;
+
+  // 只能在平台线程调用。
+  void Send(RenderBudgetLevel level);
+
+ private:
+  std::unique_ptr<flutter::EventChannel<flutter::EncodableValue>> channel_;
+  // Dart 没有监听时为 nullptr。
+  std::unique_ptr<flutter::EventSink<flutter::EncodableValue>> sink_;
+  RenderBudgetLevel level_ = RenderBudgetLevel::kFull;
+};
+
+#endif  // RUNNER_RENDER_BUDGET_CHANNEL_H_
@@ -0,0 +1,341 @@
+#include "render_budget_monitor.h"
+
+#include <dwmapi.h>
+#include <wtsapi32.h>
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include "memory_telemetry.h"
+
+namespace {
+
+constexpr UINT_PTR kRefreshTimerId = 0x5242;
+constexpr UINT_PTR kCoverageTimerId = 0x5243;
+// 窗口事件到达后等这么久再检查遮挡，拖动窗口时的连续事件合并成一次
+constexpr UINT kCoverageDelayMs = 100;
+
+// winnt.h 里的 GUID_CONSOLE_DISPLAY_STATE 和 GUID_POWER_SAVING_STATUS，
+// 在这里定义以免依赖 INITGUID
+constexpr GUID kConsoleDisplayState = {
+    0x6fe69556,
+    0x704a,
+    0x47a0,
+    {0x8f, 0x24, 0xc2, 0x8d, 0x93, 0x6f, 0xda, 0x47}};
+constexpr GUID kPowerSavingStatus = {
+    0xe00958c0,
+    0xc213,
+    0x4ace,
+    {0xac, 0x77, 0xfe, 0xcc, 0xed, 0x2e, 0xee, 0xa5}};
+
+int64_t NowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+bool IsCloaked(HWND window) {
+  DWORD cloaked = 0;
+  return SUCCEEDED(DwmGetWindowAttribute(window, DWMWA_CLOAKED, &cloaked,
+                                         sizeof(cloaked))) &&
+         cloaked != 0;
+}
+
+// 不含 DWM 阴影的窗口区域。
+bool GetVisibleBounds(HWND window, RECT* bounds) {
+  if (SUCCEEDED(DwmGetWindowAttribute(window, DWMWA_EXTENDED_FRAME_BOUNDS,
+                                      bounds, sizeof(*bounds)))) {
+    return true;
+  }
+  return GetWindowRect(window, bounds) != FALSE;
+}
+
+// |window| 是否会挡住它下面的窗口。分层窗口可能是半透明的，穿透鼠标的
+// 窗口通常是覆盖层，都不算。
+bool OccludesBelow(HWND window) {
+  if (!IsWindowVisible(window) || IsIconic(window) || IsCloaked(window)) {
+    return false;
+  }
+  const LONG_PTR ex_style = GetWindowLongPtr(window, GWL_EXSTYLE);
+  return (ex_style & (WS_EX_LAYERED | WS_EX_TRANSPARENT |
+                      WS_EX_NOREDIRECTIONBITMAP)) == 0;
+}
+
+// 可见部分是否被 z 序在它之上的窗口完全盖住，或完全在屏幕外。
+bool IsFullyCovered(HWND window) {
+  RECT bounds;
+  if (!GetVisibleBounds(window, &bounds)) {
+    return false;
+  }
+  const int screen_left = GetSystemMetrics(SM_XVIRTUALSCREEN);
+  const int screen_top = GetSystemMetrics(SM_YVIRTUALSCREEN);
+  const RECT screen = {screen_left, screen_top,
+                       screen_left + GetSystemMetrics(SM_CXVIRTUALSCREEN),
+                       screen_top + GetSystemMetrics(SM_CYVIRTUALSCREEN)};
+  RECT visible;
+  if (!IntersectRect(&visible, &bounds, &screen)) {
+    return true;
+  }
+  HRGN remaining = CreateRectRgnIndirect(&visible);
+  HRGN covered = CreateRectRgn(0, 0, 0, 0);
+  bool occluded = false;
+  if (remaining && covered) {
+    for (HWND above = GetWindow(window, GW_HWNDPREV); above;
+         above = GetWindow(above, GW_HWNDPREV)) {
+      RECT above_bounds;
+      if (!OccludesBelow(above) || !GetVisibleBounds(above, &above_bounds)) {
+        continue;
+      }
+      SetRectRgn(covered, above_bounds.left, above_bounds.top,
+                 above_bounds.right, above_bounds.bottom);
+      if (CombineRgn(remaining, remaining, covered, RGN_DIFF) == NULLREGION) {
+        occluded = true;
+        break;
+      }
+    }
+  }
+  if (covered) {
+    DeleteObject(covered);
+  }
+  if (remaining) {
+    DeleteObject(remaining);
+  }
+  return occluded;
+}
+
+bool IsTopLevelWindowEvent(HWND window, LONG object, LONG child) {
+  return window && object == OBJID_WINDOW && child == CHILDID_SELF &&
+         GetAncestor(window, GA_ROOT) == window;
+}
+
+DWORD SettingValue(const POWERBROADCAST_SETTING* setting) {
+  if (setting->DataLength < sizeof(DWORD)) {
+    return 0;
+  }
+  return *reinterpret_cast<const DWORD*>(setting->Data);
+}
+
+}  // namespace
+
+RenderBudgetMonitor* RenderBudgetMonitor::instance_ = nullptr;
+
+RenderBudgetMonitor::RenderBudgetMonitor(HWND window, Callback callback)
+    : window_(window),
+      callback_(std::move(callback)),
+      wakeups_(std::make_shared<std::atomic<int64_t>>(0)) {
+  display_notification_ = RegisterPowerSettingNotification(
+      window_, &kConsoleDisplayState, DEVICE_NOTIFY_WINDOW_HANDLE);
+  saver_notification_ = RegisterPowerSettingNotification(
+      window_, &kPowerSavingStatus, DEVICE_NOTIFY_WINDOW_HANDLE);
+  session_registered_ =
+      WTSRegisterSessionNotification(window_, NOTIFY_FOR_THIS_SESSION) != FALSE;
+  instance_ = this;
+  // 自己窗口的隐去；其它窗口切到前台、最小化和还原、开始和结束拖动。
+  // WINEVENT_OUTOFCONTEXT 的回调在本线程取消息时调用
+  const struct {
+    DWORD min;
+    DWORD max;
+    DWORD process;
+    DWORD thread;
+  } hooks[] = {
+      {EVENT_OBJECT_CLOAKED, EVENT_OBJECT_UNCLOAKED, GetCurrentProcessId(),
+       GetCurrentThreadId()},
+      {EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND, 0, 0},
+      {EVENT_SYSTEM_MOVESIZESTART, EVENT_SYSTEM_MOVESIZEEND, 0, 0},
+      {EVENT_SYSTEM_MINIMIZESTART, EVENT_SYSTEM_MINIMIZEEND, 0, 0},
+  };
+  for (const auto& hook : hooks) {
+    if (HWINEVENTHOOK handle = SetWinEventHook(
+            hook.min, hook.max, nullptr, OnWinEvent, hook.process,
+            hook.thread, WINEVENT_OUTOFCONTEXT)) {
+      hooks_.push_back(handle);
+    }
+  }
+  MemoryTelemetry::GetInstance().RegisterCounter(
+      "render_budget.wakeups", [wakeups = wakeups_]() {
+        return wakeups->load(std::memory_order_relaxed);
+      });
+  signals_.minimized = IsIconic(window_) != FALSE;
+  ReadPowerStatus();
+  CheckCoverage();
+}
+
+RenderBudgetMonitor::~RenderBudgetMonitor() {
+  KillTimer(window_, kRefreshTimerId);
+  KillTimer(window_, kCoverageTimerId);
+  if (move_hook_) {
+    UnhookWinEvent(move_hook_);
+  }
+  for (HWINEVENTHOOK hook : hooks_) {
+    UnhookWinEvent(hook);
+  }
+  if (instance_ == this) {
+    instance_ = nullptr;
+  }
+  if (session_registered_) {
+    WTSUnRegisterSessionNotification(window_);
+  }
+  if (saver_notification_) {
+    UnregisterPowerSettingNotification(saver_notification_);
+  }
+  if (display_notification_) {
+    UnregisterPowerSettingNotification(display_notification_);
+  }
+}
+
+bool RenderBudgetMonitor::HandleMessage(UINT message,
+                                        WPARAM wparam,
+                                        LPARAM lparam) {
+  switch (message) {
+    case WM_TIMER:
+      if (wparam == kRefreshTimerId) {
+        KillTimer(window_, kRefreshTimerId);
+        CountWakeup();
+        Refresh();
+        return true;
+      }
+      if (wparam == kCoverageTimerId) {
+        KillTimer(window_, kCoverageTimerId);
+        coverage_pending_ = false;
+        CountWakeup();
+        CheckCoverage();
+        return true;
+      }
+      return false;
+
+    case WM_SIZE:
+      signals_.minimized = wparam == SIZE_MINIMIZED;
+      Refresh();
+      ScheduleCoverageCheck();
+      return false;
+
+    case WM_WINDOWPOSCHANGED: {
+      // 显示和隐藏立即生效；移动、缩放和 z 序变化可能改变遮挡
+      const auto* position = reinterpret_cast<const WINDOWPOS*>(lparam);
+      if (!position) {
+        return false;
+      }
+      if ((position->flags & (SWP_SHOWWINDOW | SWP_HIDEWINDOW)) != 0) {
+        Refresh();
+      }
+      if ((position->flags & (SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER)) !=
+          (SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER)) {
+        ScheduleCoverageCheck();
+      }
+      return false;
+    }
+
+    case WM_WTSSESSION_CHANGE:
+      if (wparam == WTS_SESSION_LOCK) {
+        signals_.session_locked = true;
+      } else if (wparam == WTS_SESSION_UNLOCK) {
+        signals_.session_locked = false;
+      }
+      Refresh();
+      return false;
+
+    case WM_POWERBROADCAST:
+      if (wparam == PBT_APMPOWERSTATUSCHANGE) {
+        ReadPowerStatus();
+      } else if (wparam == PBT_POWERSETTINGCHANGE && lparam != 0) {
+        const auto* setting =
+            reinterpret_cast<const POWERBROADCAST_SETTING*>(lparam);
+        if (IsEqualGUID(setting->PowerSetting, kConsoleDisplayState)) {
+          signals_.display_off = SettingValue(setting) == 0;  // 1 开，2 变暗
+        } else if (IsEqualGUID(setting->PowerSetting, kPowerSavingStatus)) {
+          signals_.battery_saver = SettingValue(setting) != 0;
+        }
+      }
+      Refresh();
+      return false;
+  }
+  return false;
+}
+
+void RenderBudgetMonitor::Refresh() {
+  // 隐藏（例如收到托盘）、在其它虚拟桌面上或被其它窗口完全盖住
+  signals_.occluded =
+      !signals_.minimized &&
+      (!IsWindowVisible(window_) || IsCloaked(window_) || covered_);
+  const int64_t now = NowMicros();
+  if (budget_.Update(signals_, now) && callback_) {
+    callback_(budget_.level());
+  }
+
+  if (budget_.deadline_us() < 0) {
+    KillTimer(window_, kRefreshTimerId);
+    return;
+  }
+  const int64_t delay_us = std::max<int64_t>(budget_.deadline_us() - now, 0);
+  SetTimer(window_, kRefreshTimerId,
+           static_cast<UINT>(std::max<int64_t>((delay_us + 999) / 1000,
+                                               USER_TIMER_MINIMUM)),
+           nullptr);
+}
+
+void RenderBudgetMonitor::CheckCoverage() {
+  covered_ = !signals_.minimized && IsWindowVisible(window_) &&
+             !IsCloaked(window_) && IsFullyCovered(window_);
+  Refresh();
+}
+
+void RenderBudgetMonitor::ScheduleCoverageCheck() {
+  if (coverage_pending_) {
+    return;
+  }
+  coverage_pending_ =
+      SetTimer(window_, kCoverageTimerId, kCoverageDelayMs, nullptr) != 0;
+}
+
+void CALLBACK RenderBudgetMonitor::OnWinEvent(HWINEVENTHOOK,
+                                              DWORD event,
+                                              HWND window,
+                                              LONG object,
+                                              LONG child,
+                                              DWORD,
+                                              DWORD) {
+  RenderBudgetMonitor* monitor = instance_;
+  if (!monitor) {
+    return;
+  }
+  monitor->CountWakeup();
+  if (!IsTopLevelWindowEvent(window, object, child)) {
+    return;
+  }
+  switch (event) {
+    case EVENT_SYSTEM_MOVESIZESTART: {
+      // 只在拖动期间跟踪位置变化，并且只跟踪被拖动窗口所在的进程，
+      // 避免平时收到全系统的光标和窗口移动事件
+      DWORD process = 0;
+      GetWindowThreadProcessId(window, &process);
+      if (!monitor->move_hook_ && process != GetCurrentProcessId()) {
+        monitor->move_hook_ = SetWinEventHook(
+            EVENT_OBJECT_LOCATIONCHANGE, EVENT_OBJECT_LOCATIONCHANGE, nullptr,
+            OnWinEvent, process, 0, WINEVENT_OUTOFCONTEXT);
+      }
+      return;
+    }
+    case EVENT_SYSTEM_MOVESIZEEND:
+      if (monitor->move_hook_) {
+        UnhookWinEvent(monitor->move_hook_);
+        monitor->move_hook_ = nullptr;
+      }
+      break;
+  }
+  monitor->ScheduleCoverageCheck();
+}
+
+void RenderBudgetMonitor::CountWakeup() {
+  wakeups_->fetch_add(1, std::memory_order_relaxed);
+}
+
+void RenderBudgetMonitor::ReadPowerStatus() {
+  SYSTEM_POWER_STATUS status;
+  if (!GetSystemPowerStatus(&status)) {
+    return;
+  }
+  signals_.on_battery = status.ACLineStatus == 0;
+  // 节电模式也会通过 GUID_POWER_SAVING_STATUS 通知
+  signals_.battery_saver = (status.SystemStatusFlag & 1) != 0;
+}
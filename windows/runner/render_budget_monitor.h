@@ -0,0 +1,78 @@
+#ifndef RUNNER_RENDER_BUDGET_MONITOR_H_
+#define RUNNER_RENDER_BUDGET_MONITOR_H_
+
+#include <windows.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "render_budget.h"
+
+// 收集 RenderBudget 需要的窗口和电源状态，级别变化时回调。
+//
+// 全部由通知驱动，没有轮询：最小化来自 WM_SIZE，隐藏来自
+// WM_WINDOWPOSCHANGED，被 DWM 隐去（切到其它虚拟桌面）来自
+// EVENT_OBJECT_CLOAKED/UNCLOAKED，锁屏来自 WM_WTSSESSION_CHANGE，显示器
+// 开关和节电模式来自电源设置通知，电池来自 GetSystemPowerStatus。是否被
+// 其它窗口完全盖住没有直接的通知，在可能改变它的事件之后重新计算：自己
+// 窗口的 WM_WINDOWPOSCHANGED，其它窗口切到前台、最小化和还原、拖动
+// （拖动期间跟踪 EVENT_OBJECT_LOCATIONCHANGE），事件合并后 100 毫秒内
+// 计算一次。此外只有等待降级生效时才设一次性定时器，窗口空闲时不唤醒。
+// 只能在平台线程上使用，同时只能有一个实例。
+class RenderBudgetMonitor {
+ public:
+  using Callback = std::function<void(RenderBudgetLevel level)>;
+
+  RenderBudgetMonitor(HWND window, Callback callback);
+  ~RenderBudgetMonitor();
+
+  RenderBudgetMonitor(const RenderBudgetMonitor&) = delete;
+  RenderBudgetMonitor& operator=(const RenderBudgetMonitor&) = delete;
+
+  // 由窗口过程对每条消息调用。只有自己的定时器返回 true，其它消息照常
+  // 交给后续的处理。
+  bool HandleMessage(UINT message, WPARAM wparam, LPARAM lparam);
+
+  RenderBudgetLevel level() const { return budget_.level(); }
+
+ private:
+  // 重新读取窗口状态，更新级别，需要时安排降级生效的定时器。
+  void Refresh();
+  // 重新计算是否被完全盖住，然后 Refresh。
+  void CheckCoverage();
+  // 稍后检查遮挡；已经安排时不重复安排。
+  void ScheduleCoverageCheck();
+  void ReadPowerStatus();
+  void CountWakeup();
+
+  static void CALLBACK OnWinEvent(HWINEVENTHOOK hook,
+                                  DWORD event,
+                                  HWND window,
+                                  LONG object,
+                                  LONG child,
+                                  DWORD event_thread,
+                                  DWORD event_time);
+
+  // WinEvent 回调据此找到监视器
+  static RenderBudgetMonitor* instance_;
+
+  HWND window_;
+  Callback callback_;
+  RenderBudget budget_;
+  RenderBudgetSignals signals_;
+  HPOWERNOTIFY display_notification_ = nullptr;
+  HPOWERNOTIFY saver_notification_ = nullptr;
+  std::vector<HWINEVENTHOOK> hooks_;
+  // 其它进程拖动窗口期间的 EVENT_OBJECT_LOCATIONCHANGE 钩子
+  HWINEVENTHOOK move_hook_ = nullptr;
+  bool session_registered_ = false;
+  bool covered_ = false;
+  bool coverage_pending_ = false;
+  // 定时器和窗口事件唤醒平台线程的次数，登记到内存采样
+  std::shared_ptr<std::atomic<int64_t>> wakeups_;
+};
+
+#endif  // RUNNER_RENDER_BUDGET_MONITOR_H_
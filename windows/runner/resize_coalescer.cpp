@@ -0,0 +1,90 @@
+#include "resize_coalescer.h"
+
+ResizeCoalescer::ResizeCoalescer(int64_t frame_interval_us)
+    : frame_interval_us_(frame_interval_us > 0 ? frame_interval_us : 1) {}
+
+ResizeCoalescer::Action ResizeCoalescer::EnterSizeMove(int64_t now_us) {
+  (void)now_us;
+  in_loop_ = true;
+  return Action();
+}
+
+ResizeCoalescer::Action ResizeCoalescer::Size(uint32_t width,
+                                              uint32_t height,
+                                              int64_t now_us) {
+  Action action;
+  width_ = width;
+  height_ = height;
+  if (!in_loop_) {
+    Apply(now_us, &action);
+    return action;
+  }
+  if (has_applied_ && width == applied_width_ && height == applied_height_) {
+    // 拖回了原来的尺寸，之前记下的调整不再需要
+    if (pending_) {
+      pending_ = false;
+      ++stats_.coalesced;
+    }
+    return action;
+  }
+  if (!resizing_) {
+    resizing_ = true;
+    ++stats_.sessions;
+    action.event = Event::kBegin;
+  }
+  const int64_t elapsed = now_us - last_apply_us_;
+  if (!has_applied_ || elapsed >= frame_interval_us_) {
+    Apply(now_us, &action);
+    return action;
+  }
+  if (pending_) {
+    ++stats_.coalesced;  // 覆盖了上一次还没应用的尺寸
+  }
+  pending_ = true;
+  if (!timer_armed_) {
+    timer_armed_ = true;
+    action.timer_delay_us = frame_interval_us_ - elapsed;
+  }
+  return action;
+}
+
+ResizeCoalescer::Action ResizeCoalescer::Timer(int64_t now_us) {
+  Action action;
+  timer_armed_ = false;
+  if (!pending_ || !in_loop_) {
+    return action;
+  }
+  const int64_t elapsed = now_us - last_apply_us_;
+  if (elapsed >= frame_interval_us_) {
+    Apply(now_us, &action);
+  } else {
+    // 定时器提前到达
+    timer_armed_ = true;
+    action.timer_delay_us = frame_interval_us_ - elapsed;
+  }
+  return action;
+}
+
+ResizeCoalescer::Action ResizeCoalescer::ExitSizeMove(int64_t now_us) {
+  Action action;
+  in_loop_ = false;
+  timer_armed_ = false;
+  if (pending_) {
+    Apply(now_us, &action);
+  }
+  if (resizing_) {
+    resizing_ = false;
+    action.event = Event::kEnd;
+  }
+  return action;
+}
+
+void ResizeCoalescer::Apply(int64_t now_us, Action* action) {
+  action->move_child = true;
+  pending_ = false;
+  has_applied_ = true;
+  last_apply_us_ = now_us;
+  applied_width_ = width_;
+  applied_height_ = height_;
+  ++stats_.child_moves;
+}
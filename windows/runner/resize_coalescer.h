@@ -0,0 +1,70 @@
+#ifndef RUNNER_RESIZE_COALESCER_H_
+#define RUNNER_RESIZE_COALESCER_H_
+
+#include <cstdint>
+
+// 拖动窗口边框时合并子窗口的尺寸调整（与平台无关）。
+//
+// 在 WM_ENTERSIZEMOVE 和 WM_EXITSIZEMOVE 之间，WM_SIZE 的频率跟随鼠标，
+// 每次都 MoveWindow 会让 Flutter 视图反复重建交换链。这里把子窗口的调整
+// 限制为每帧最多一次：距上次调整不足一帧时只记下待调整，并要求调用方
+// 定时回调；退出尺寸循环时立即补上。循环外的 WM_SIZE（最大化、还原等）
+// 直接调整。
+//
+// 同时给出准确的开始/结束事件：循环内第一次尺寸变化时开始，退出循环时
+// 结束；只移动窗口、尺寸不变的循环不产生事件。时间单位为微秒。
+class ResizeCoalescer {
+ public:
+  enum class Event {
+    kNone,
+    kBegin,
+    kEnd,
+  };
+
+  // 每个输入返回的动作，调用方按顺序执行：先调整子窗口，再发送事件。
+  struct Action {
+    bool move_child = false;      // 现在把子窗口调整到当前客户区
+    Event event = Event::kNone;   // 发给 Dart 的事件
+    int64_t timer_delay_us = -1;  // 不小于 0 时，在这么久之后调用 Timer
+  };
+
+  struct Stats {
+    uint64_t child_moves = 0;  // 实际调整子窗口的次数
+    uint64_t coalesced = 0;    // 被合并掉的 WM_SIZE 次数
+    uint64_t sessions = 0;     // 产生过尺寸变化的循环数
+  };
+
+  explicit ResizeCoalescer(int64_t frame_interval_us = 16667);
+
+  ResizeCoalescer(const ResizeCoalescer&) = delete;
+  ResizeCoalescer& operator=(const ResizeCoalescer&) = delete;
+
+  Action EnterSizeMove(int64_t now_us);
+  Action Size(uint32_t width, uint32_t height, int64_t now_us);
+  Action Timer(int64_t now_us);
+  Action ExitSizeMove(int64_t now_us);
+
+  // 是否处于已经发出开始事件、还没有结束的调整中。
+  bool resizing() const { return resizing_; }
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  // 记录一次子窗口调整。
+  void Apply(int64_t now_us, Action* action);
+
+  const int64_t frame_interval_us_;
+  bool in_loop_ = false;
+  bool resizing_ = false;
+  bool pending_ = false;      // 有尚未应用到子窗口的尺寸
+  bool timer_armed_ = false;  // 已经要求过调用方定时回调
+  bool has_applied_ = false;  // 还没调整过时，第一次一定生效
+  int64_t last_apply_us_ = 0;
+  uint32_t width_ = 0;  // 最近一次 WM_SIZE 的尺寸
+  uint32_t height_ = 0;
+  uint32_t applied_width_ = 0;  // 子窗口当前的尺寸
+  uint32_t applied_height_ = 0;
+  Stats stats_;
+};
+
+#endif  // RUNNER_RESIZE_COALESCER_H_
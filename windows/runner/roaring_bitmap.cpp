@@ -0,0 +1,237 @@
+#include "roaring_bitmap.h"
+
+#include <algorithm>
+#include <bitset>
+#include <iterator>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+// 超过这个元素数的容器用位图表示，两种表示此时大小相同（8KB）
+constexpr uint32_t kArrayMaxCardinality = 4096;
+constexpr size_t kBitmapWords = 65536 / 64;
+
+int CountTrailingZeros(uint64_t value) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+  unsigned long index;
+  _BitScanForward64(&index, value);
+  return static_cast<int>(index);
+#elif defined(_MSC_VER)
+  unsigned long index;
+  if (_BitScanForward(&index, static_cast<uint32_t>(value))) {
+    return static_cast<int>(index);
+  }
+  _BitScanForward(&index, static_cast<uint32_t>(value >> 32));
+  return static_cast<int>(index) + 32;
+#else
+  return __builtin_ctzll(value);
+#endif
+}
+
+uint32_t PopCount(uint64_t value) {
+  return static_cast<uint32_t>(std::bitset<64>(value).count());
+}
+
+bool TestBit(const std::vector<uint64_t>& bitmap, uint16_t low) {
+  return ((bitmap[low >> 6] >> (low & 63)) & 1) != 0;
+}
+
+}  // namespace
+
+ptrdiff_t RoaringBitmap::FindContainer(uint16_t key) const {
+  auto it = std::lower_bound(
+      containers_.begin(), containers_.end(), key,
+      [](const Container& container, uint16_t k) { return container.key < k; });
+  const ptrdiff_t index = it - containers_.begin();
+  if (it != containers_.end() && it->key == key) {
+    return index;
+  }
+  return ~index;
+}
+
+void RoaringBitmap::Add(uint32_t value) {
+  const uint16_t key = static_cast<uint16_t>(value >> 16);
+  const uint16_t low = static_cast<uint16_t>(value);
+  ptrdiff_t index = FindContainer(key);
+  if (index < 0) {
+    index = ~index;
+    Container container;
+    container.key = key;
+    containers_.insert(containers_.begin() + index, std::move(container));
+  }
+  Container& container = containers_[static_cast<size_t>(index)];
+  if (container.is_bitmap()) {
+    uint64_t& word = container.bitmap[low >> 6];
+    const uint64_t bit = uint64_t{1} << (low & 63);
+    if (!(word & bit)) {
+      word |= bit;
+      ++container.cardinality;
+    }
+    return;
+  }
+  auto it = std::lower_bound(container.array.begin(), container.array.end(),
+                             low);
+  if (it != container.array.end() && *it == low) {
+    return;
+  }
+  container.array.insert(it, low);
+  ++container.cardinality;
+  if (container.cardinality > kArrayMaxCardinality) {
+    container.bitmap.assign(kBitmapWords, 0);
+    for (uint16_t item : container.array) {
+      container.bitmap[item >> 6] |= uint64_t{1} << (item & 63);
+    }
+    std::vector<uint16_t>().swap(container.array);
+  }
+}
+
+void RoaringBitmap::Remove(uint32_t value) {
+  const ptrdiff_t index = FindContainer(static_cast<uint16_t>(value >> 16));
+  if (index < 0) {
+    return;
+  }
+  const uint16_t low = static_cast<uint16_t>(value);
+  Container& container = containers_[static_cast<size_t>(index)];
+  if (container.is_bitmap()) {
+    uint64_t& word = container.bitmap[low >> 6];
+    const uint64_t bit = uint64_t{1} << (low & 63);
+    if (!(word & bit)) {
+      return;
+    }
+    word &= ~bit;
+    --container.cardinality;
+    if (container.cardinality <= kArrayMaxCardinality) {
+      container.array.reserve(container.cardinality);
+      for (size_t i = 0; i < kBitmapWords; ++i) {
+        for (uint64_t bits = container.bitmap[i]; bits; bits &= bits - 1) {
+          container.array.push_back(
+              static_cast<uint16_t>(i * 64 + CountTrailingZeros(bits)));
+        }
+      }
+      std::vector<uint64_t>().swap(container.bitmap);
+    }
+  } else {
+    auto it = std::lower_bound(container.array.begin(), container.array.end(),
+                               low);
+    if (it == container.array.end() || *it != low) {
+      return;
+    }
+    container.array.erase(it);
+    --container.cardinality;
+  }
+  if (container.cardinality == 0) {
+    containers_.erase(containers_.begin() + index);
+  }
+}
+
+bool RoaringBitmap::Contains(uint32_t value) const {
+  const ptrdiff_t index = FindContainer(static_cast<uint16_t>(value >> 16));
+  if (index < 0) {
+    return false;
+  }
+  const uint16_t low = static_cast<uint16_t>(value);
+  const Container& container = containers_[static_cast<size_t>(index)];
+  if (container.is_bitmap()) {
+    return TestBit(container.bitmap, low);
+  }
+  return std::binary_search(container.array.begin(), container.array.end(),
+                            low);
+}
+
+uint64_t RoaringBitmap::Cardinality() const {
+  uint64_t total = 0;
+  for (const Container& container : containers_) {
+    total += container.cardinality;
+  }
+  return total;
+}
+
+size_t RoaringBitmap::memory_bytes() const {
+  size_t bytes = containers_.capacity() * sizeof(Container);
+  for (const Container& container : containers_) {
+    bytes += container.array.capacity() * sizeof(uint16_t) +
+             container.bitmap.capacity() * sizeof(uint64_t);
+  }
+  return bytes;
+}
+
+void RoaringBitmap::AppendTo(std::vector<uint32_t>* values) const {
+  values->reserve(values->size() + static_cast<size_t>(Cardinality()));
+  for (const Container& container : containers_) {
+    const uint32_t high = static_cast<uint32_t>(container.key) << 16;
+    if (container.is_bitmap()) {
+      for (size_t i = 0; i < kBitmapWords; ++i) {
+        for (uint64_t bits = container.bitmap[i]; bits; bits &= bits - 1) {
+          values->push_back(high | static_cast<uint32_t>(
+                                       i * 64 + CountTrailingZeros(bits)));
+        }
+      }
+    } else {
+      for (uint16_t low : container.array) {
+        values->push_back(high | low);
+      }
+    }
+  }
+}
+
+RoaringBitmap RoaringBitmap::And(const RoaringBitmap& a,
+                                 const RoaringBitmap& b) {
+  RoaringBitmap result;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < a.containers_.size() && j < b.containers_.size()) {
+    const Container& left = a.containers_[i];
+    const Container& right = b.containers_[j];
+    if (left.key < right.key) {
+      ++i;
+      continue;
+    }
+    if (right.key < left.key) {
+      ++j;
+      continue;
+    }
+    Container out;
+    out.key = left.key;
+    if (left.is_bitmap() && right.is_bitmap()) {
+      // 逐字与运算，结果足够稀疏时再换回数组
+      out.bitmap.resize(kBitmapWords);
+      for (size_t w = 0; w < kBitmapWords; ++w) {
+        out.bitmap[w] = left.bitmap[w] & right.bitmap[w];
+        out.cardinality += PopCount(out.bitmap[w]);
+      }
+      if (out.cardinality <= kArrayMaxCardinality) {
+        out.array.reserve(out.cardinality);
+        for (size_t w = 0; w < kBitmapWords; ++w) {
+          for (uint64_t bits = out.bitmap[w]; bits; bits &= bits - 1) {
+            out.array.push_back(
+                static_cast<uint16_t>(w * 64 + CountTrailingZeros(bits)));
+          }
+        }
+        std::vector<uint64_t>().swap(out.bitmap);
+      }
+    } else if (left.is_bitmap() || right.is_bitmap()) {
+      const Container& sparse = left.is_bitmap() ? right : left;
+      const Container& dense = left.is_bitmap() ? left : right;
+      for (uint16_t low : sparse.array) {
+        if (TestBit(dense.bitmap, low)) {
+          out.array.push_back(low);
+        }
+      }
+      out.cardinality = static_cast<uint32_t>(out.array.size());
+    } else {
+      std::set_intersection(left.array.begin(), left.array.end(),
+                            right.array.begin(), right.array.end(),
+                            std::back_inserter(out.array));
+      out.cardinality = static_cast<uint32_t>(out.array.size());
+    }
+    if (out.cardinality > 0) {
+      result.containers_.push_back(std::move(out));
+    }
+    ++i;
+    ++j;
+  }
+  return result;
+}
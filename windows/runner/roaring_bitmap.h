@@ -0,0 +1,48 @@
+#ifndef RUNNER_ROARING_BITMAP_H_
+#define RUNNER_ROARING_BITMAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 32 位整数集合的 Roaring 位图（与平台无关）。
+//
+// 按高 16 位分成容器，每个容器保存低 16 位：不超过 4096 个元素时是
+// 有序的 uint16 数组，超过后换成 8KB 的定长位图。稀疏的集合只占几个
+// 字节每元素，稠密的集合每元素一位，求交集按容器类型选择合并、查表
+// 或逐字与运算。不是线程安全的。
+class RoaringBitmap {
+ public:
+  RoaringBitmap() = default;
+
+  void Add(uint32_t value);
+  void Remove(uint32_t value);
+  bool Contains(uint32_t value) const;
+  void Clear() { containers_.clear(); }
+
+  bool empty() const { return containers_.empty(); }
+  uint64_t Cardinality() const;
+  size_t memory_bytes() const;
+
+  // 按升序把所有元素追加到 |values|。
+  void AppendTo(std::vector<uint32_t>* values) const;
+
+  static RoaringBitmap And(const RoaringBitmap& a, const RoaringBitmap& b);
+
+ private:
+  struct Container {
+    uint16_t key = 0;                // 元素的高 16 位
+    uint32_t cardinality = 0;
+    std::vector<uint16_t> array;     // 有序的低 16 位，位图容器时为空
+    std::vector<uint64_t> bitmap;    // 1024 个字，数组容器时为空
+
+    bool is_bitmap() const { return !bitmap.empty(); }
+  };
+
+  // 返回高 16 位为 |key| 的容器下标，没有时返回插入位置的按位取反。
+  ptrdiff_t FindContainer(uint16_t key) const;
+
+  std::vector<Container> containers_;  // 按 key 升序
+};
+
+#endif  // RUNNER_ROARING_BITMAP_H_
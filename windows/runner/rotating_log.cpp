@@ -0,0 +1,53 @@
+#include "rotating_log.h"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <utility>
+
+RotatingLog::RotatingLog(std::filesystem::path path,
+                         uint64_t max_bytes,
+                         int max_files)
+    : path_(std::move(path)),
+      max_bytes_(std::max<uint64_t>(max_bytes, 1)),
+      max_files_(std::max(max_files, 1)) {}
+
+bool RotatingLog::Append(std::string_view line) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::error_code error;
+  const uint64_t size = std::filesystem::file_size(path_, error);
+  if (!error && size > 0 && size + line.size() + 1 > max_bytes_) {
+    Rotate();
+  }
+  if (path_.has_parent_path()) {
+    std::filesystem::create_directories(path_.parent_path(), error);
+  }
+  std::ofstream out(path_, std::ios::out | std::ios::app | std::ios::binary);
+  if (!out) {
+    return false;
+  }
+  out.write(line.data(), static_cast<std::streamsize>(line.size()));
+  out.put('\n');
+  out.flush();
+  return static_cast<bool>(out);
+}
+
+std::filesystem::path RotatingLog::RotatedPath(int index) const {
+  std::filesystem::path rotated = path_;
+  rotated += "." + std::to_string(index);
+  return rotated;
+}
+
+void RotatingLog::Rotate() {
+  std::error_code error;
+  if (max_files_ == 1) {
+    std::filesystem::remove(path_, error);
+    return;
+  }
+  std::filesystem::remove(RotatedPath(max_files_ - 1), error);
+  for (int index = max_files_ - 2; index >= 1; --index) {
+    std::filesystem::rename(RotatedPath(index), RotatedPath(index + 1), error);
+  }
+  std::filesystem::rename(path_, RotatedPath(1), error);
+}
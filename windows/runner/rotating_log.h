@@ -0,0 +1,37 @@
+#ifndef RUNNER_ROTATING_LOG_H_
+#define RUNNER_ROTATING_LOG_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string_view>
+
+// 按行追加的滚动日志（与平台无关）。
+//
+// 文件超过 |max_bytes| 时依次改名为 <path>.1、<path>.2……，最多保留
+// |max_files| 个文件（含当前文件），最早的被删除。每次追加都打开并关闭
+// 文件，写入后立即落盘，适合卡顿记录这类很少写、进程可能随时被结束的
+// 场景。可以在多个线程上调用。
+class RotatingLog {
+ public:
+  RotatingLog(std::filesystem::path path, uint64_t max_bytes, int max_files);
+
+  RotatingLog(const RotatingLog&) = delete;
+  RotatingLog& operator=(const RotatingLog&) = delete;
+
+  // 追加一行，自动补上换行。
+  bool Append(std::string_view line);
+
+  const std::filesystem::path& path() const { return path_; }
+
+ private:
+  std::filesystem::path RotatedPath(int index) const;
+  void Rotate();
+
+  const std::filesystem::path path_;
+  const uint64_t max_bytes_;
+  const int max_files_;
+  std::mutex mutex_;
+};
+
+#endif  // RUNNER_ROTATING_LOG_H_
@@ -0,0 +1,83 @@
+#include "runner_flags.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "utf_transcode.h"
+
+namespace {
+
+constexpr std::string_view kStartupTraceFlag = "--startup-trace";
+constexpr char kDefaultStartupTracePath[] = "startup_trace.json";
+constexpr std::string_view kWriteBundleManifestFlag = "--write-bundle-manifest";
+constexpr std::string_view kMemorySampleFlag = "--memory-sample-ms=";
+constexpr std::string_view kHangThresholdFlag = "--hang-threshold-ms=";
+constexpr std::string_view kNoPrefetchFlag = "--no-prefetch";
+constexpr std::string_view kPrefetchListFlag = "--prefetch-list=";
+
+bool StartsWith(std::string_view text, std::string_view prefix) {
+  return text.substr(0, prefix.size()) == prefix;
+}
+
+// 负数按 0 处理。|value| 后面不是数字时同样为 0，与 atoll 一致。
+int64_t ParseMilliseconds(std::string_view value) {
+  const std::string text(value);
+  return std::max<int64_t>(0, std::atoll(text.c_str()));
+}
+
+}  // namespace
+
+bool ConsumeRunnerFlag(std::string_view argument, RunnerFlags* flags) {
+  if (argument == kWriteBundleManifestFlag) {
+    flags->write_bundle_manifest = true;
+    return true;
+  }
+  if (StartsWith(argument, kMemorySampleFlag)) {
+    flags->memory_sample_ms =
+        ParseMilliseconds(argument.substr(kMemorySampleFlag.size()));
+    return true;
+  }
+  if (StartsWith(argument, kHangThresholdFlag)) {
+    flags->hang_threshold_ms =
+        ParseMilliseconds(argument.substr(kHangThresholdFlag.size()));
+    return true;
+  }
+  if (argument == kNoPrefetchFlag) {
+    flags->prefetch = false;
+    return true;
+  }
+  if (StartsWith(argument, kPrefetchListFlag)) {
+    flags->prefetch_list = argument.substr(kPrefetchListFlag.size());
+    return true;
+  }
+  if (argument == kStartupTraceFlag) {
+    flags->startup_trace_path = kDefaultStartupTracePath;
+    return true;
+  }
+  if (StartsWith(argument, kStartupTraceFlag) &&
+      argument.size() > kStartupTraceFlag.size() &&
+      argument[kStartupTraceFlag.size()] == '=') {
+    flags->startup_trace_path = argument.substr(kStartupTraceFlag.size() + 1);
+    return true;
+  }
+  return false;
+}
+
+std::vector<std::string> ParseCommandLineArguments(
+    const std::u16string_view* arguments,
+    size_t count,
+    RunnerFlags* flags) {
+  // 所有参数转换到同一块缓冲区
+  Utf8Batch utf8_arguments;
+  Utf16ToUtf8Batch(arguments, count, &utf8_arguments);
+
+  std::vector<std::string> forwarded;
+  forwarded.reserve(utf8_arguments.size());
+  for (size_t i = 0; i < utf8_arguments.size(); i++) {
+    const std::string_view argument = utf8_arguments[i];
+    if (!ConsumeRunnerFlag(argument, flags)) {
+      forwarded.emplace_back(argument);
+    }
+  }
+  return forwarded;
+}
@@ -0,0 +1,32 @@
+#ifndef RUNNER_RUNNER_FLAGS_H_
+#define RUNNER_RUNNER_FLAGS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// runner 自己处理、不转发给 Dart 的命令行参数（与平台无关）。
+// 参数列表见 utils.h 中 GetCommandLineArguments 的说明。
+struct RunnerFlags {
+  bool write_bundle_manifest = false;
+  int64_t memory_sample_ms = 10000;
+  int64_t hang_threshold_ms = 2000;
+  bool prefetch = true;
+  std::string prefetch_list;
+  // 非空时记录启动时间线，退出时写到该路径
+  std::string startup_trace_path;
+};
+
+// |argument| 是 runner 参数时写入 |flags| 并返回 true。
+bool ConsumeRunnerFlag(std::string_view argument, RunnerFlags* flags);
+
+// 把 UTF-16 命令行参数（不含程序名）转成 UTF-8，取出 runner 参数写入
+// |flags|，其余按原顺序返回。无效的参数转为空串。
+std::vector<std::string> ParseCommandLineArguments(
+    const std::u16string_view* arguments,
+    size_t count,
+    RunnerFlags* flags);
+
+#endif  // RUNNER_RUNNER_FLAGS_H_
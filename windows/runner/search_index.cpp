@@ -0,0 +1,565 @@
+#include "search_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <utility>
+
+#include "xxhash64.h"
+
+namespace {
+
+constexpr float kK1 = 1.2f;
+constexpr float kB = 0.75f;
+// 词频按 1/4 精度存储，字段权重可以是 0.25 的倍数
+constexpr float kFrequencyScale = 4.0f;
+constexpr size_t kMaxWordBytes = 64;
+constexpr size_t kMaxPrefixExpansions = 32;
+constexpr float kPrefixWeight = 0.5f;
+constexpr size_t kMinDeletedForCompaction = 1024;
+constexpr size_t kInitialTermSlots = 1024;
+
+enum class TokenKind {
+  kWord,
+  kCjkUnigram,
+  kCjkBigram,
+};
+
+enum class CharClass {
+  kSeparator,
+  kWord,
+  kCjk,
+};
+
+// 解码一个 UTF-8 字符并前进，无效的字节按分隔符处理。
+uint32_t DecodeUtf8(const uint8_t** cursor, const uint8_t* end) {
+  const uint8_t* p = *cursor;
+  const uint8_t lead = *p;
+  size_t length;
+  uint32_t code_point;
+  if (lead < 0x80) {
+    *cursor = p + 1;
+    return lead;
+  } else if ((lead & 0xE0) == 0xC0) {
+    length = 2;
+    code_point = lead & 0x1Fu;
+  } else if ((lead & 0xF0) == 0xE0) {
+    length = 3;
+    code_point = lead & 0x0Fu;
+  } else if ((lead & 0xF8) == 0xF0) {
+    length = 4;
+    code_point = lead & 0x07u;
+  } else {
+    *cursor = p + 1;
+    return 0;
+  }
+  if (static_cast<size_t>(end - p) < length) {
+    *cursor = end;
+    return 0;
+  }
+  for (size_t i = 1; i < length; ++i) {
+    if ((p[i] & 0xC0) != 0x80) {
+      *cursor = p + i;
+      return 0;
+    }
+    code_point = code_point << 6 | (p[i] & 0x3Fu);
+  }
+  *cursor = p + length;
+  return code_point;
+}
+
+void AppendUtf8(uint32_t code_point, std::string* output) {
+  if (code_point < 0x80) {
+    output->push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    output->push_back(static_cast<char>(0xC0 | code_point >> 6));
+    output->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point < 0x10000) {
+    output->push_back(static_cast<char>(0xE0 | code_point >> 12));
+    output->push_back(static_cast<char>(0x80 | (code_point >> 6 & 0x3F)));
+    output->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else {
+    output->push_back(static_cast<char>(0xF0 | code_point >> 18));
+    output->push_back(static_cast<char>(0x80 | (code_point >> 12 & 0x3F)));
+    output->push_back(static_cast<char>(0x80 | (code_point >> 6 & 0x3F)));
+    output->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+// 全角字母数字转半角，字母转小写。
+uint32_t Normalize(uint32_t code_point) {
+  if (code_point >= 0xFF01 && code_point <= 0xFF5E) {
+    code_point -= 0xFEE0;
+  }
+  if (code_point >= 'A' && code_point <= 'Z') {
+    return code_point + 0x20;
+  }
+  // Latin-1 大写字母（不含乘号）
+  if (code_point >= 0xC0 && code_point <= 0xDE && code_point != 0xD7) {
+    return code_point + 0x20;
+  }
+  return code_point;
+}
+
+CharClass Classify(uint32_t code_point) {
+  if ((code_point >= 'a' && code_point <= 'z') ||
+      (code_point >= '0' && code_point <= '9')) {
+    return CharClass::kWord;
+  }
+  // Latin-1 补充和拉丁扩展字母（不含乘号和除号）
+  if (code_point >= 0xC0 && code_point <= 0x24F && code_point != 0xD7 &&
+      code_point != 0xF7) {
+    return CharClass::kWord;
+  }
+  if ((code_point >= 0x3040 && code_point <= 0x30FF) ||  // 假名
+      (code_point >= 0x3400 && code_point <= 0x4DBF) ||  // 扩展 A
+      (code_point >= 0x4E00 && code_point <= 0x9FFF) ||  // 基本汉字
+      (code_point >= 0xAC00 && code_point <= 0xD7AF) ||  // 谚文
+      (code_point >= 0xF900 && code_point <= 0xFAFF) ||  // 兼容汉字
+      (code_point >= 0x20000 && code_point <= 0x2FFFF)) {
+    return CharClass::kCjk;
+  }
+  return CharClass::kSeparator;
+}
+
+// 对 |text| 分词，每个词调用 |emit(term, kind, at_end)|。|at_end| 表示
+// 这个拉丁词一直延续到文本末尾。|is_query| 时中日韩字符按查询规则处理。
+template <typename Emit>
+void Tokenize(std::string_view text, bool is_query, Emit&& emit) {
+  const auto* p = reinterpret_cast<const uint8_t*>(text.data());
+  const uint8_t* end = p + text.size();
+  std::string word;
+  std::string term;
+  std::vector<uint32_t> run;  // 查询中当前的中日韩字符序列
+  uint32_t previous_cjk = 0;
+
+  const auto flush_word = [&](bool at_end) {
+    if (!word.empty()) {
+      emit(std::string_view(word), TokenKind::kWord, at_end);
+      word.clear();
+    }
+  };
+  const auto flush_run = [&]() {
+    if (run.size() == 1) {
+      term.clear();
+      AppendUtf8(run[0], &term);
+      emit(std::string_view(term), TokenKind::kCjkUnigram, false);
+    }
+    for (size_t i = 1; i < run.size(); ++i) {
+      term.clear();
+      AppendUtf8(run[i - 1], &term);
+      AppendUtf8(run[i], &term);
+      emit(std::string_view(term), TokenKind::kCjkBigram, false);
+    }
+    run.clear();
+  };
+
+  while (p < end) {
+    const uint32_t code_point = Normalize(DecodeUtf8(&p, end));
+    const CharClass char_class = Classify(code_point);
+    if (char_class != CharClass::kWord) {
+      flush_word(false);
+    }
+    if (char_class != CharClass::kCjk) {
+      flush_run();
+      previous_cjk = 0;
+    }
+    if (char_class == CharClass::kWord) {
+      if (word.size() < kMaxWordBytes) {
+        AppendUtf8(code_point, &word);
+      }
+    } else if (char_class == CharClass::kCjk) {
+      if (is_query) {
+        run.push_back(code_point);
+      } else {
+        term.clear();
+        AppendUtf8(code_point, &term);
+        emit(std::string_view(term), TokenKind::kCjkUnigram, false);
+        if (previous_cjk) {
+          term.clear();
+          AppendUtf8(previous_cjk, &term);
+          AppendUtf8(code_point, &term);
+          emit(std::string_view(term), TokenKind::kCjkBigram, false);
+        }
+        previous_cjk = code_point;
+      }
+    }
+  }
+  flush_word(true);
+  flush_run();
+}
+
+size_t AppendVarint(uint32_t value, std::vector<uint8_t>* output) {
+  size_t written = 1;
+  while (value >= 0x80) {
+    output->push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+    ++written;
+  }
+  output->push_back(static_cast<uint8_t>(value));
+  return written;
+}
+
+uint32_t ReadVarint(const uint8_t** cursor) {
+  const uint8_t* p = *cursor;
+  uint32_t value = 0;
+  int shift = 0;
+  while (*p & 0x80) {
+    value |= static_cast<uint32_t>(*p++ & 0x7F) << shift;
+    shift += 7;
+  }
+  value |= static_cast<uint32_t>(*p++) << shift;
+  *cursor = p;
+  return value;
+}
+
+// 按顺序解码倒排表，对每个条目调用 |visit(doc, frequency)|。
+template <typename Visit>
+void DecodePostings(const std::vector<uint8_t>& bytes, Visit&& visit) {
+  const uint8_t* p = bytes.data();
+  const uint8_t* end = p + bytes.size();
+  uint32_t doc = 0;
+  bool first = true;
+  while (p < end) {
+    const uint32_t delta = ReadVarint(&p);
+    doc = first ? delta : doc + delta;
+    first = false;
+    const uint32_t frequency = ReadVarint(&p);
+    visit(doc, frequency);
+  }
+}
+
+// 查询期间的得分累加器，按线程复用。
+struct Accumulator {
+  std::vector<float> scores;
+  std::vector<uint32_t> touched;
+};
+
+Accumulator& ThreadAccumulator() {
+  thread_local Accumulator accumulator;
+  return accumulator;
+}
+
+uint64_t HashTerm(std::string_view text) {
+  return XxHash64(text.data(), text.size());
+}
+
+}  // namespace
+
+SearchIndex::SearchIndex()
+    : term_offsets_{0}, term_slots_(kInitialTermSlots, 0) {}
+
+void SearchIndex::Upsert(uint32_t id, const std::vector<Field>& fields) {
+  std::unique_lock lock(mutex_);
+  RemoveLocked(id);
+
+  std::vector<std::pair<uint32_t, float>> frequencies;
+  float length = 0.0f;
+  for (const Field& field : fields) {
+    const float weight = field.weight > 0.0f ? field.weight : 1.0f;
+    Tokenize(field.text, false,
+             [&](std::string_view term, TokenKind kind, bool) {
+               frequencies.emplace_back(
+                   TermIdLocked(term, kind == TokenKind::kWord), weight);
+               length += weight;
+             });
+  }
+  std::sort(frequencies.begin(), frequencies.end());
+
+  const uint32_t doc = static_cast<uint32_t>(documents_.size());
+  Document document;
+  document.id = id;
+  document.length = length;
+  document.alive = true;
+  documents_.push_back(document);
+  doc_numbers_[id] = doc;
+  total_length_ += length;
+
+  for (size_t i = 0; i < frequencies.size();) {
+    const uint32_t term = frequencies[i].first;
+    float frequency = 0.0f;
+    for (; i < frequencies.size() && frequencies[i].first == term; ++i) {
+      frequency += frequencies[i].second;
+    }
+    PostingList& list = postings_[term];
+    const uint32_t delta = list.count == 0 ? doc : doc - list.last_doc;
+    posting_bytes_ += AppendVarint(delta, &list.bytes);
+    posting_bytes_ += AppendVarint(
+        std::max(1u, static_cast<uint32_t>(
+                         std::lround(frequency * kFrequencyScale))),
+        &list.bytes);
+    list.last_doc = doc;
+    ++list.count;
+  }
+}
+
+bool SearchIndex::Remove(uint32_t id) {
+  std::unique_lock lock(mutex_);
+  if (doc_numbers_.find(id) == doc_numbers_.end()) {
+    return false;
+  }
+  RemoveLocked(id);
+  return true;
+}
+
+void SearchIndex::Clear() {
+  std::unique_lock lock(mutex_);
+  term_bytes_.clear();
+  term_offsets_.assign(1, 0);
+  term_slots_.assign(kInitialTermSlots, 0);
+  words_.clear();
+  postings_.clear();
+  documents_.clear();
+  doc_numbers_.clear();
+  total_length_ = 0.0;
+  posting_bytes_ = 0;
+}
+
+std::vector<SearchIndex::Hit> SearchIndex::Search(std::string_view query,
+                                                  size_t limit) const {
+  std::vector<Hit> hits;
+  if (limit == 0) {
+    return hits;
+  }
+  std::shared_lock lock(mutex_);
+  if (doc_numbers_.empty()) {
+    return hits;
+  }
+
+  // 查询词及其权重，前缀展开的词权重较低
+  std::vector<std::pair<uint32_t, float>> query_terms;
+  Tokenize(query, true, [&](std::string_view term, TokenKind kind,
+                            bool at_end) {
+    const uint32_t exact = FindTerm(term, HashTerm(term));
+    if (exact != kNoTerm) {
+      query_terms.emplace_back(exact, 1.0f);
+    }
+    if (kind != TokenKind::kWord || !at_end) {
+      return;
+    }
+    size_t expanded = 0;
+    for (auto it = words_.lower_bound(term);
+         it != words_.end() && expanded < kMaxPrefixExpansions &&
+         it->first.compare(0, term.size(), term) == 0;
+         ++it) {
+      if (it->first.size() != term.size()) {
+        query_terms.emplace_back(it->second, kPrefixWeight);
+        ++expanded;
+      }
+    }
+  });
+  if (query_terms.empty()) {
+    return hits;
+  }
+  // 同一个词只保留最高的权重
+  std::sort(query_terms.begin(), query_terms.end(),
+            [](const auto& a, const auto& b) {
+              return a.first != b.first ? a.first < b.first
+                                        : a.second > b.second;
+            });
+  query_terms.erase(
+      std::unique(query_terms.begin(), query_terms.end(),
+                  [](const auto& a, const auto& b) {
+                    return a.first == b.first;
+                  }),
+      query_terms.end());
+
+  const double live = static_cast<double>(doc_numbers_.size());
+  const float average_length =
+      static_cast<float>(std::max(total_length_ / live, 1.0));
+  Accumulator& accumulator = ThreadAccumulator();
+  if (accumulator.scores.size() < documents_.size()) {
+    accumulator.scores.resize(documents_.size(), 0.0f);
+  }
+  float* scores = accumulator.scores.data();
+  std::vector<uint32_t>& touched = accumulator.touched;
+  touched.clear();
+
+  for (const auto& [term, weight] : query_terms) {
+    const PostingList& list = postings_[term];
+    const double frequency_in_docs =
+        std::min(static_cast<double>(list.count), live);
+    const float idf = static_cast<float>(std::log(
+        1.0 + (live - frequency_in_docs + 0.5) / (frequency_in_docs + 0.5)));
+    const float term_weight = weight;
+    DecodePostings(list.bytes, [&](uint32_t doc, uint32_t frequency) {
+      const Document& document = documents_[doc];
+      if (!document.alive) {
+        return;
+      }
+      const float tf = static_cast<float>(frequency) / kFrequencyScale;
+      const float norm =
+          kK1 * (1.0f - kB + kB * document.length / average_length);
+      if (scores[doc] == 0.0f) {
+        touched.push_back(doc);
+      }
+      scores[doc] += term_weight * idf * tf * (kK1 + 1.0f) / (tf + norm);
+    });
+  }
+
+  // 得分相同时较新的文档在前
+  const auto better = [scores](uint32_t a, uint32_t b) {
+    return scores[a] != scores[b] ? scores[a] > scores[b] : a > b;
+  };
+  const size_t count = std::min(limit, touched.size());
+  std::partial_sort(touched.begin(),
+                    touched.begin() + static_cast<ptrdiff_t>(count),
+                    touched.end(), better);
+  hits.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    Hit hit;
+    hit.id = documents_[touched[i]].id;
+    hit.score = scores[touched[i]];
+    hits.push_back(hit);
+  }
+  for (uint32_t doc : touched) {
+    scores[doc] = 0.0f;
+  }
+  return hits;
+}
+
+SearchIndex::Stats SearchIndex::stats() const {
+  std::shared_lock lock(mutex_);
+  Stats stats;
+  stats.documents = doc_numbers_.size();
+  stats.deleted = documents_.size() - doc_numbers_.size();
+  stats.terms = postings_.size();
+  stats.posting_bytes = posting_bytes_;
+  stats.compactions = compactions_;
+  return stats;
+}
+
+void SearchIndex::RemoveLocked(uint32_t id) {
+  const auto it = doc_numbers_.find(id);
+  if (it == doc_numbers_.end()) {
+    return;
+  }
+  Document& document = documents_[it->second];
+  document.alive = false;
+  total_length_ -= document.length;
+  doc_numbers_.erase(it);
+  const size_t deleted = documents_.size() - doc_numbers_.size();
+  if (deleted >= kMinDeletedForCompaction && deleted > doc_numbers_.size()) {
+    CompactLocked();
+  }
+}
+
+std::string_view SearchIndex::TermText(uint32_t term) const {
+  return std::string_view(term_bytes_).substr(
+      term_offsets_[term], term_offsets_[term + 1] - term_offsets_[term]);
+}
+
+uint32_t SearchIndex::FindTerm(std::string_view text, uint64_t hash) const {
+  const size_t mask = term_slots_.size() - 1;
+  for (size_t i = static_cast<size_t>(hash) & mask;; i = (i + 1) & mask) {
+    const uint32_t slot = term_slots_[i];
+    if (slot == 0) {
+      return kNoTerm;
+    }
+    if (TermText(slot - 1) == text) {
+      return slot - 1;
+    }
+  }
+}
+
+uint32_t SearchIndex::TermIdLocked(std::string_view text, bool is_word) {
+  const uint64_t hash = HashTerm(text);
+  const uint32_t existing = FindTerm(text, hash);
+  if (existing != kNoTerm) {
+    return existing;
+  }
+  const uint32_t term = static_cast<uint32_t>(postings_.size());
+  term_bytes_.append(text);
+  term_offsets_.push_back(static_cast<uint32_t>(term_bytes_.size()));
+  postings_.emplace_back();
+  if (is_word) {
+    words_.emplace(std::string(text), term);
+  }
+  // 装载因子保持在 0.5 以下
+  if (postings_.size() * 2 > term_slots_.size()) {
+    RehashTermsLocked(term_slots_.size() * 2);
+  } else {
+    InsertTermSlotLocked(term, hash);
+  }
+  return term;
+}
+
+void SearchIndex::RehashTermsLocked(size_t slot_count) {
+  term_slots_.assign(slot_count, 0);
+  for (uint32_t term = 0; term < postings_.size(); ++term) {
+    InsertTermSlotLocked(term, HashTerm(TermText(term)));
+  }
+}
+
+void SearchIndex::InsertTermSlotLocked(uint32_t term, uint64_t hash) {
+  const size_t mask = term_slots_.size() - 1;
+  size_t i = static_cast<size_t>(hash) & mask;
+  while (term_slots_[i] != 0) {
+    i = (i + 1) & mask;
+  }
+  term_slots_[i] = term + 1;
+}
+
+void SearchIndex::CompactLocked() {
+  constexpr uint32_t kRemoved = 0xFFFFFFFF;
+  std::vector<uint32_t> renumbered(documents_.size(), kRemoved);
+  std::vector<Document> documents;
+  documents.reserve(doc_numbers_.size());
+  for (size_t doc = 0; doc < documents_.size(); ++doc) {
+    if (documents_[doc].alive) {
+      renumbered[doc] = static_cast<uint32_t>(documents.size());
+      doc_numbers_[documents_[doc].id] = renumbered[doc];
+      documents.push_back(documents_[doc]);
+    }
+  }
+
+  // 重写倒排表，去掉不再出现在任何文档中的词后重建词典
+  std::vector<PostingList> postings;
+  std::string term_bytes;
+  std::vector<uint32_t> term_offsets{0};
+  postings.reserve(postings_.size());
+  posting_bytes_ = 0;
+  for (uint32_t term = 0; term < postings_.size(); ++term) {
+    PostingList list;
+    DecodePostings(postings_[term].bytes,
+                   [&](uint32_t doc, uint32_t frequency) {
+                     const uint32_t new_doc = renumbered[doc];
+                     if (new_doc == kRemoved) {
+                       return;
+                     }
+                     const uint32_t delta =
+                         list.count == 0 ? new_doc : new_doc - list.last_doc;
+                     AppendVarint(delta, &list.bytes);
+                     AppendVarint(frequency, &list.bytes);
+                     list.last_doc = new_doc;
+                     ++list.count;
+                   });
+    if (list.count == 0) {
+      continue;
+    }
+    list.bytes.shrink_to_fit();
+    posting_bytes_ += list.bytes.size();
+    postings.push_back(std::move(list));
+    term_bytes.append(TermText(term));
+    term_offsets.push_back(static_cast<uint32_t>(term_bytes.size()));
+  }
+  postings_.swap(postings);
+  term_bytes_.swap(term_bytes);
+  term_offsets_.swap(term_offsets);
+  documents_.swap(documents);
+
+  size_t slot_count = kInitialTermSlots;
+  while (slot_count < postings_.size() * 2) {
+    slot_count *= 2;
+  }
+  RehashTermsLocked(slot_count);
+  std::map<std::string, uint32_t, std::less<>> words;
+  for (uint32_t term = 0; term < postings_.size(); ++term) {
+    const std::string_view text = TermText(term);
+    if (words_.find(text) != words_.end()) {
+      words.emplace(std::string(text), term);
+    }
+  }
+  words_.swap(words);
+  ++compactions_;
+}
@@ -0,0 +1,102 @@
+#ifndef RUNNER_SEARCH_INDEX_H_
+#define RUNNER_SEARCH_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// 本地全文索引（与平台无关），用于在缓存的游戏和帖子中即时搜索。
+//
+// 分词：连续的拉丁字母和数字为一个词（转小写，全角转半角）；连续的
+// 中日韩字符按字切分，文档同时索引单字和相邻两字（bigram），查询中
+// 两个字以上的部分只用 bigram，单字查询用单字。查询最后一个拉丁词
+// 没有以分隔符结束时按前缀匹配，便于边输入边搜索。
+//
+// 倒排表按内部文档号递增排列，以 varint 编码文档号差值和词频。更新
+// 文档时分配新的内部文档号并把旧的标记为删除，因此追加总是有序的；
+// 删除的文档超过存活文档时重新编号并重写倒排表。
+//
+// 排序使用 BM25，字段的权重乘到词频和文档长度上。被删除但尚未压缩
+// 的文档仍计入词的文档频率。可以在多个线程上同时调用。
+class SearchIndex {
+ public:
+  struct Field {
+    std::string_view text;  // UTF-8
+    float weight = 1.0f;
+  };
+
+  struct Hit {
+    uint32_t id = 0;
+    float score = 0.0f;
+  };
+
+  struct Stats {
+    uint64_t documents = 0;       // 存活文档数
+    uint64_t deleted = 0;         // 等待压缩的文档数
+    uint64_t terms = 0;
+    uint64_t posting_bytes = 0;   // 倒排表编码后的字节数
+    uint64_t compactions = 0;
+  };
+
+  SearchIndex();
+
+  SearchIndex(const SearchIndex&) = delete;
+  SearchIndex& operator=(const SearchIndex&) = delete;
+
+  // 添加或替换外部 ID 为 |id| 的文档。
+  void Upsert(uint32_t id, const std::vector<Field>& fields);
+
+  // 删除文档，返回是否存在。
+  bool Remove(uint32_t id);
+
+  void Clear();
+
+  // 按 BM25 得分从高到低返回最多 |limit| 个结果。
+  std::vector<Hit> Search(std::string_view query, size_t limit) const;
+
+  Stats stats() const;
+
+ private:
+  struct PostingList {
+    std::vector<uint8_t> bytes;
+    uint32_t last_doc = 0;
+    uint32_t count = 0;
+  };
+  struct Document {
+    uint32_t id = 0;
+    float length = 0.0f;  // 加权后的词数
+    bool alive = false;
+  };
+
+  static constexpr uint32_t kNoTerm = 0xFFFFFFFF;
+
+  std::string_view TermText(uint32_t term) const;
+  uint32_t FindTerm(std::string_view text, uint64_t hash) const;
+
+  // 以下方法要求持有 mutex_ 的写锁。
+  void RemoveLocked(uint32_t id);
+  uint32_t TermIdLocked(std::string_view text, bool is_word);
+  void InsertTermSlotLocked(uint32_t term, uint64_t hash);
+  void RehashTermsLocked(size_t slot_count);
+  void CompactLocked();
+
+  mutable std::shared_mutex mutex_;
+  // 词典：所有词的 UTF-8 首尾相连存放，开放寻址表按哈希找到词 ID
+  std::string term_bytes_;
+  std::vector<uint32_t> term_offsets_;  // 词 ID 对应的起始偏移，末尾多一项
+  std::vector<uint32_t> term_slots_;    // 词 ID 加 1，0 为空
+  std::map<std::string, uint32_t, std::less<>> words_;  // 拉丁词，用于前缀查找
+  std::vector<PostingList> postings_;                   // 下标为词 ID
+  std::vector<Document> documents_;                     // 下标为内部文档号
+  std::unordered_map<uint32_t, uint32_t> doc_numbers_;  // 外部 ID 到内部文档号
+  double total_length_ = 0.0;                           // 存活文档的长度之和
+  uint64_t posting_bytes_ = 0;
+  uint64_t compactions_ = 0;
+};
+
+#endif  // RUNNER_SEARCH_INDEX_H_
@@ -0,0 +1,129 @@
+#include "search_index_ffi.h"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "memory_telemetry.h"
+#include "search_index.h"
+
+namespace {
+
+bool IsValidIndexName(const std::string& name) {
+  if (name.empty() || name.size() > 64) {
+    return false;
+  }
+  for (char c : name) {
+    const bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                       (c >= '0' && c <= '9') || c == '_' || c == '-';
+    if (!valid) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 不析构：Dart 侧可能在任何时候持有句柄
+std::mutex& RegistryMutex() {
+  static std::mutex* mutex = new std::mutex();
+  return *mutex;
+}
+
+std::map<std::string, SearchIndex*>& Registry() {
+  static auto* indexes = new std::map<std::string, SearchIndex*>();
+  return *indexes;
+}
+
+SearchIndex* AsIndex(void* index) {
+  return static_cast<SearchIndex*>(index);
+}
+
+}  // namespace
+
+void* runner_search_open(const char* name) {
+  if (!name || !IsValidIndexName(name)) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(RegistryMutex());
+  auto& indexes = Registry();
+  auto it = indexes.find(name);
+  if (it == indexes.end()) {
+    it = indexes.emplace(name, new SearchIndex()).first;
+    SearchIndex* raw = it->second;
+    MemoryTelemetry::GetInstance().RegisterCounter(
+        std::string("search.") + name, [raw]() {
+          return static_cast<int64_t>(raw->stats().posting_bytes);
+        });
+  }
+  return it->second;
+}
+
+int32_t runner_search_upsert(void* index,
+                             uint32_t id,
+                             const RunnerSearchField* fields,
+                             int32_t count) {
+  if (!index || count < 0 || (count > 0 && !fields)) {
+    return 0;
+  }
+  std::vector<SearchIndex::Field> converted;
+  converted.reserve(static_cast<size_t>(count));
+  for (int32_t i = 0; i < count; ++i) {
+    const RunnerSearchField& field = fields[i];
+    if (field.length <= 0 || !field.text || !(field.weight > 0.0f)) {
+      continue;
+    }
+    SearchIndex::Field item;
+    item.text = std::string_view(reinterpret_cast<const char*>(field.text),
+                                 static_cast<size_t>(field.length));
+    item.weight = field.weight;
+    converted.push_back(item);
+  }
+  AsIndex(index)->Upsert(id, converted);
+  return 1;
+}
+
+int32_t runner_search_remove(void* index, uint32_t id) {
+  if (!index) {
+    return 0;
+  }
+  return AsIndex(index)->Remove(id) ? 1 : 0;
+}
+
+void runner_search_clear(void* index) {
+  if (index) {
+    AsIndex(index)->Clear();
+  }
+}
+
+int32_t runner_search_query(void* index,
+                            const uint8_t* query,
+                            int64_t length,
+                            RunnerSearchHit* hits,
+                            int32_t capacity) {
+  if (!index || !query || length <= 0 || !hits || capacity <= 0) {
+    return 0;
+  }
+  const std::vector<SearchIndex::Hit> results = AsIndex(index)->Search(
+      std::string_view(reinterpret_cast<const char*>(query),
+                       static_cast<size_t>(length)),
+      static_cast<size_t>(capacity));
+  for (size_t i = 0; i < results.size(); ++i) {
+    hits[i].id = results[i].id;
+    hits[i].score = results[i].score;
+  }
+  return static_cast<int32_t>(results.size());
+}
+
+void runner_search_stats(void* index, RunnerSearchStats* stats) {
+  if (!index || !stats) {
+    return;
+  }
+  const SearchIndex::Stats current = AsIndex(index)->stats();
+  stats->documents = static_cast<int64_t>(current.documents);
+  stats->deleted = static_cast<int64_t>(current.deleted);
+  stats->terms = static_cast<int64_t>(current.terms);
+  stats->posting_bytes = static_cast<int64_t>(current.posting_bytes);
+  stats->compactions = static_cast<int64_t>(current.compactions);
+}
@@ -0,0 +1,56 @@
+#ifndef RUNNER_SEARCH_INDEX_FFI_H_
+#define RUNNER_SEARCH_INDEX_FFI_H_
+
+#include <cstdint>
+
+#include "ffi_export.h"
+
+// SearchIndex 的 C 接口，供 lib/windows/native/native_search_index.dart 使用。
+// 结构体布局必须和 Dart 侧的 Struct 定义一致。
+//
+// 索引只在内存中，按名称打开，同名索引只创建一次，句柄在进程退出前
+// 一直有效。文档 ID 通常是 runner_oid_intern 返回的句柄。字符串均为
+// UTF-8，不要求以 '\0' 结尾。
+
+struct RunnerSearchField {
+  const uint8_t* text;
+  int64_t length;
+  float weight;
+};
+
+struct RunnerSearchHit {
+  uint32_t id;
+  float score;
+};
+
+struct RunnerSearchStats {
+  int64_t documents;
+  int64_t deleted;
+  int64_t terms;
+  int64_t posting_bytes;
+  int64_t compactions;
+};
+
+// |name| 只能包含字母、数字、'_' 和 '-'，无效时返回 nullptr。
+RUNNER_FFI_EXPORT void* runner_search_open(const char* name);
+
+RUNNER_FFI_EXPORT int32_t runner_search_upsert(void* index,
+                                               uint32_t id,
+                                               const RunnerSearchField* fields,
+                                               int32_t count);
+
+RUNNER_FFI_EXPORT int32_t runner_search_remove(void* index, uint32_t id);
+
+RUNNER_FFI_EXPORT void runner_search_clear(void* index);
+
+// 向 |hits| 写入最多 |capacity| 个结果，返回写入的个数。
+RUNNER_FFI_EXPORT int32_t runner_search_query(void* index,
+                                              const uint8_t* query,
+                                              int64_t length,
+                                              RunnerSearchHit* hits,
+                                              int32_t capacity);
+
+RUNNER_FFI_EXPORT void runner_search_stats(void* index,
+                                           RunnerSearchStats* stats);
+
+#endif  // RUNNER_SEARCH_INDEX_FFI_H_
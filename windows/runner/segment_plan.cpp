@@ -0,0 +1,226 @@
+#include "segment_plan.h"
+
+#include <algorithm>
+
+namespace {
+
+// 拆分点按 4 KB 对齐，和文件系统的块对齐
+constexpr uint64_t kSplitAlignment = 4096;
+// 测速窗口，太短时每块数据的到达间隔抖动很大
+constexpr int64_t kRateWindowUs = 200000;
+// 新窗口的速度所占的权重
+constexpr double kRateSmoothing = 0.3;
+
+}  // namespace
+
+SegmentPlan::SegmentPlan(uint64_t min_split_size)
+    : min_split_size_(std::max<uint64_t>(min_split_size, kSplitAlignment)) {}
+
+void SegmentPlan::Reset(uint64_t total_size) {
+  Segment segment;
+  segment.end = total_size;
+  total_size_ = total_size;
+  completed_ = 0;
+  contiguous_end_ = 0;
+  segments_.assign(1, segment);
+  by_begin_.clear();
+  by_begin_[0] = 0;
+}
+
+bool SegmentPlan::Restore(uint64_t total_size,
+                          const std::vector<Segment>& segments) {
+  uint64_t expected_begin = 0;
+  uint64_t completed = 0;
+  for (const Segment& segment : segments) {
+    if (segment.begin != expected_begin || segment.end < segment.begin ||
+        segment.done > segment.end - segment.begin) {
+      return false;
+    }
+    expected_begin = segment.end;
+    completed += segment.done;
+  }
+  if (expected_begin != total_size || segments.empty()) {
+    return false;
+  }
+  segments_.clear();
+  by_begin_.clear();
+  for (const Segment& restored : segments) {
+    Segment segment;
+    segment.begin = restored.begin;
+    segment.end = restored.end;
+    segment.done = restored.done;
+    by_begin_[segment.begin] = segments_.size();
+    segments_.push_back(segment);
+  }
+  total_size_ = total_size;
+  completed_ = completed;
+  contiguous_end_ = 0;
+  AdvanceContiguousEnd();
+  return true;
+}
+
+size_t SegmentPlan::Acquire(int64_t now_us) {
+  size_t chosen = kNone;
+  for (const auto& entry : by_begin_) {
+    const Segment& segment = segments_[entry.second];
+    if (!segment.active && segment.remaining() > 0) {
+      chosen = entry.second;
+      break;
+    }
+  }
+  if (chosen == kNone) {
+    uint64_t split_at = 0;
+    const size_t index = ChooseSplit(&split_at);
+    if (index == kNone) {
+      return kNone;
+    }
+    Segment tail;
+    tail.begin = split_at;
+    tail.end = segments_[index].end;
+    segments_[index].end = split_at;
+    chosen = segments_.size();
+    by_begin_[tail.begin] = chosen;
+    segments_.push_back(tail);
+  }
+  Segment& segment = segments_[chosen];
+  segment.active = true;
+  segment.bytes_per_second = 0.0;
+  segment.window_begin_us = now_us;
+  segment.window_bytes = 0;
+  return chosen;
+}
+
+uint64_t SegmentPlan::Commit(size_t index, uint64_t size, int64_t now_us) {
+  Segment& segment = segments_[index];
+  const uint64_t counted = std::min(size, segment.remaining());
+  segment.done += counted;
+  completed_ += counted;
+  segment.window_bytes += counted;
+  const int64_t elapsed = now_us - segment.window_begin_us;
+  if (elapsed >= kRateWindowUs) {
+    const double rate =
+        static_cast<double>(segment.window_bytes) * 1e6 / elapsed;
+    segment.bytes_per_second =
+        segment.bytes_per_second == 0.0
+            ? rate
+            : segment.bytes_per_second * (1.0 - kRateSmoothing) +
+                  rate * kRateSmoothing;
+    segment.window_begin_us = now_us;
+    segment.window_bytes = 0;
+  }
+  if (segment.begin <= contiguous_end_) {
+    AdvanceContiguousEnd();
+  }
+  return counted;
+}
+
+void SegmentPlan::Release(size_t index) {
+  Segment& segment = segments_[index];
+  segment.active = false;
+  segment.bytes_per_second = 0.0;
+}
+
+size_t SegmentPlan::active_count() const {
+  return static_cast<size_t>(
+      std::count_if(segments_.begin(), segments_.end(),
+                    [](const Segment& segment) { return segment.active; }));
+}
+
+double SegmentPlan::bytes_per_second() const {
+  double total = 0.0;
+  for (const Segment& segment : segments_) {
+    if (segment.active) {
+      total += segment.bytes_per_second;
+    }
+  }
+  return total;
+}
+
+std::vector<SegmentPlan::Segment> SegmentPlan::Snapshot() const {
+  std::vector<Segment> result;
+  for (const auto& entry : by_begin_) {
+    const Segment& segment = segments_[entry.second];
+    if (!result.empty() && result.back().remaining() == 0 &&
+        segment.remaining() == 0) {
+      result.back().end = segment.end;
+      result.back().done += segment.done;
+      continue;
+    }
+    Segment copy;
+    copy.begin = segment.begin;
+    copy.end = segment.end;
+    copy.done = segment.done;
+    result.push_back(copy);
+  }
+  return result;
+}
+
+size_t SegmentPlan::ChooseSplit(uint64_t* split_at) const {
+  double rate_sum = 0.0;
+  size_t measured = 0;
+  for (const Segment& segment : segments_) {
+    if (segment.active && segment.bytes_per_second > 0.0) {
+      rate_sum += segment.bytes_per_second;
+      ++measured;
+    }
+  }
+  const double average_rate = measured > 0 ? rate_sum / measured : 0.0;
+
+  size_t chosen = kNone;
+  double latest_finish = 0.0;
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    const Segment& segment = segments_[i];
+    if (!segment.active || segment.remaining() < 2 * min_split_size_) {
+      continue;
+    }
+    // 还没测出速度的连接按平均速度估计；都没测出来时只比较剩余字节
+    double rate = segment.bytes_per_second;
+    if (rate <= 0.0) {
+      rate = average_rate > 0.0 ? average_rate : 1.0;
+    }
+    const double finish = static_cast<double>(segment.remaining()) / rate;
+    if (chosen == kNone || finish > latest_finish) {
+      chosen = i;
+      latest_finish = finish;
+    }
+  }
+  if (chosen == kNone) {
+    return kNone;
+  }
+
+  // 新连接按平均速度估计，两边同时完成时新连接分到的比例
+  const Segment& segment = segments_[chosen];
+  double tail_share = 0.5;
+  if (segment.bytes_per_second > 0.0 && average_rate > 0.0) {
+    tail_share = average_rate / (segment.bytes_per_second + average_rate);
+  }
+  const uint64_t remaining = segment.remaining();
+  uint64_t tail = static_cast<uint64_t>(static_cast<double>(remaining) *
+                                        tail_share);
+  tail = std::clamp(tail, min_split_size_, remaining - min_split_size_);
+  uint64_t point = segment.end - tail;
+  point -= point % kSplitAlignment;
+  if (point < segment.position() + min_split_size_) {
+    point = segment.position() + min_split_size_;
+  }
+  if (point >= segment.end) {
+    return kNone;
+  }
+  *split_at = point;
+  return chosen;
+}
+
+void SegmentPlan::AdvanceContiguousEnd() {
+  for (;;) {
+    auto it = by_begin_.upper_bound(contiguous_end_);
+    if (it == by_begin_.begin()) {
+      return;
+    }
+    --it;
+    const uint64_t position = segments_[it->second].position();
+    if (position <= contiguous_end_) {
+      return;
+    }
+    contiguous_end_ = position;
+  }
+}
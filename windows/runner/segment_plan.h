@@ -0,0 +1,79 @@
+#ifndef RUNNER_SEGMENT_PLAN_H_
+#define RUNNER_SEGMENT_PLAN_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+// 分段下载的分段表（与平台无关，不加锁，由调用方同步）。
+//
+// 文件被分成互不重叠、首尾相接的段，每段 [begin, end) 的前 done 字节已经
+// 写入。一条连接同一时刻只下载一段。空闲的连接先领取没有连接在下载的
+// 未完成段（最靠前的优先，已下载部分尽量连续，校验可以跟上）；没有时拆分
+// 预计最晚完成的段：按这一段当前的速度和所有连接的平均速度分配剩余字节，
+// 让两边差不多同时完成。剩余不足两个 min_split_size 的段不再拆分。被拆短
+// 的段，原来的连接读到新的结尾后停止。时间单位为微秒。
+class SegmentPlan {
+ public:
+  static constexpr size_t kNone = static_cast<size_t>(-1);
+
+  struct Segment {
+    uint64_t begin = 0;
+    uint64_t end = 0;
+    uint64_t done = 0;
+    bool active = false;             // 有连接正在下载
+    double bytes_per_second = 0.0;   // 当前连接的速度，没有测出来时为 0
+    int64_t window_begin_us = 0;     // 测速窗口
+    uint64_t window_bytes = 0;
+
+    uint64_t position() const { return begin + done; }
+    uint64_t remaining() const { return end - begin - done; }
+  };
+
+  explicit SegmentPlan(uint64_t min_split_size = 1u << 20);
+
+  // 整个文件作为一段。
+  void Reset(uint64_t total_size);
+  // 按日志恢复。各段按 begin 排序、首尾相接地覆盖 [0, total_size) 时才
+  // 接受，否则返回 false 且不修改。只使用 begin、end 和 done。
+  bool Restore(uint64_t total_size, const std::vector<Segment>& segments);
+
+  // 给一条空闲连接分配一段并标记为 active，没有可分配的工作时返回 kNone。
+  size_t Acquire(int64_t now_us);
+  // 记录第 |index| 段又写入了 |size| 字节，返回计入的字节数：段被拆短后
+  // 超出结尾的部分不计入。
+  uint64_t Commit(size_t index, uint64_t size, int64_t now_us);
+  // 连接不再下载这一段（完成、出错或停止）。
+  void Release(size_t index);
+
+  // 从 0 开始连续写入的字节数。
+  uint64_t contiguous_end() const { return contiguous_end_; }
+  uint64_t completed() const { return completed_; }
+  uint64_t total_size() const { return total_size_; }
+  bool complete() const { return completed_ == total_size_; }
+  size_t active_count() const;
+  // 所有 active 段的速度之和。
+  double bytes_per_second() const;
+
+  const Segment& segment(size_t index) const { return segments_[index]; }
+  size_t segment_count() const { return segments_.size(); }
+  // 按位置排序的各段，相邻的已完成段合并，用于写日志。
+  std::vector<Segment> Snapshot() const;
+
+  uint64_t min_split_size() const { return min_split_size_; }
+
+ private:
+  // 选出要拆分的段，并返回拆分点；没有可拆分的段时返回 kNone。
+  size_t ChooseSplit(uint64_t* split_at) const;
+  void AdvanceContiguousEnd();
+
+  uint64_t min_split_size_;
+  uint64_t total_size_ = 0;
+  uint64_t completed_ = 0;
+  uint64_t contiguous_end_ = 0;
+  std::vector<Segment> segments_;    // 下标在拆分后保持不变
+  std::map<uint64_t, size_t> by_begin_;
+};
+
+#endif  // RUNNER_SEGMENT_PLAN_H_
@@ -0,0 +1,925 @@
+#include "segmented_download.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string_view>
+#include <utility>
+
+#include "xxhash64.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr uint32_t kJournalMagic = 0x4A445853;  // "SXDJ"
+constexpr uint32_t kJournalVersion = 1;
+constexpr size_t kMaxUrlSize = 64 * 1024;
+constexpr size_t kMaxValidatorSize = 1024;
+constexpr size_t kMaxJournalSegments = 1u << 20;
+// 追赶校验时每次从文件读回的大小
+constexpr size_t kHashReadSize = 1u << 20;
+// 大小未知的单连接下载
+constexpr uint64_t kUnknownSize = std::numeric_limits<uint64_t>::max();
+
+struct JournalHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t total_size;
+  uint32_t url_size;
+  uint32_t validator_size;
+  uint32_t segment_count;
+  uint32_t reserved;
+  uint64_t hashed_bytes;
+  uint32_t hash_state[8];
+  uint8_t hash_buffer[64];
+};
+static_assert(sizeof(JournalHeader) == 136, "JournalHeader must be 136 bytes");
+
+struct JournalSegment {
+  uint64_t begin;
+  uint64_t end;
+  uint64_t done;
+};
+
+bool EqualsIgnoreCase(std::string_view a, std::string_view b) {
+  return a.size() == b.size() &&
+         std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+           return std::tolower(static_cast<unsigned char>(x)) ==
+                  std::tolower(static_cast<unsigned char>(y));
+         });
+}
+
+const std::string* FindHeader(const HttpHeaders& headers, const char* name) {
+  for (const auto& header : headers) {
+    if (EqualsIgnoreCase(header.first, name)) {
+      return &header.second;
+    }
+  }
+  return nullptr;
+}
+
+bool ParseUint64(std::string_view text, uint64_t* value) {
+  if (text.empty() || text.size() > 19) {
+    return false;
+  }
+  uint64_t result = 0;
+  for (char c : text) {
+    if (c < '0' || c > '9') {
+      return false;
+    }
+    result = result * 10 + static_cast<uint64_t>(c - '0');
+  }
+  *value = result;
+  return true;
+}
+
+std::string_view Trim(std::string_view text) {
+  while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+    text.remove_prefix(1);
+  }
+  while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+    text.remove_suffix(1);
+  }
+  return text;
+}
+
+// "bytes 0-1023/4096"，总大小为 "*" 时 |total| 为 kUnknownSize。
+bool ParseContentRange(std::string_view text,
+                       uint64_t* first,
+                       uint64_t* last,
+                       uint64_t* total) {
+  text = Trim(text);
+  if (text.size() < 6 || !EqualsIgnoreCase(text.substr(0, 6), "bytes ")) {
+    return false;
+  }
+  text.remove_prefix(6);
+  const size_t dash = text.find('-');
+  const size_t slash = text.find('/');
+  if (dash == std::string_view::npos || slash == std::string_view::npos ||
+      dash > slash) {
+    return false;
+  }
+  if (!ParseUint64(Trim(text.substr(0, dash)), first) ||
+      !ParseUint64(Trim(text.substr(dash + 1, slash - dash - 1)), last) ||
+      *last < *first) {
+    return false;
+  }
+  const std::string_view total_text = Trim(text.substr(slash + 1));
+  if (total_text == "*") {
+    *total = kUnknownSize;
+    return true;
+  }
+  return ParseUint64(total_text, total) && *last < *total;
+}
+
+// If-Range 只接受强 ETag 或 Last-Modified。
+std::string ResponseValidator(const HttpHeaders& headers) {
+  const std::string* etag = FindHeader(headers, "etag");
+  if (etag && !etag->empty() && etag->compare(0, 2, "W/") != 0) {
+    return *etag;
+  }
+  const std::string* last_modified = FindHeader(headers, "last-modified");
+  return last_modified ? *last_modified : std::string();
+}
+
+std::string PercentDecode(std::string_view text) {
+  std::string result;
+  result.reserve(text.size());
+  for (size_t i = 0; i < text.size(); ++i) {
+    if (text[i] == '%' && i + 2 < text.size() &&
+        std::isxdigit(static_cast<unsigned char>(text[i + 1])) &&
+        std::isxdigit(static_cast<unsigned char>(text[i + 2]))) {
+      result.push_back(static_cast<char>(
+          std::stoi(std::string(text.substr(i + 1, 2)), nullptr, 16)));
+      i += 2;
+    } else {
+      result.push_back(text[i]);
+    }
+  }
+  return result;
+}
+
+// attachment; filename="a.zip"; filename*=UTF-8''%E6%B8%B8%E6%88%8F.zip
+std::string FileNameFromDisposition(std::string_view value) {
+  std::string plain;
+  while (!value.empty()) {
+    const size_t end = value.find(';');
+    const std::string_view part = Trim(value.substr(0, end));
+    value = end == std::string_view::npos ? std::string_view()
+                                          : value.substr(end + 1);
+    const size_t equals = part.find('=');
+    if (equals == std::string_view::npos) {
+      continue;
+    }
+    const std::string_view key = Trim(part.substr(0, equals));
+    std::string_view argument = Trim(part.substr(equals + 1));
+    if (EqualsIgnoreCase(key, "filename*")) {
+      const size_t quote = argument.find("''");
+      if (quote != std::string_view::npos &&
+          EqualsIgnoreCase(argument.substr(0, quote), "UTF-8")) {
+        return PercentDecode(argument.substr(quote + 2));
+      }
+    } else if (EqualsIgnoreCase(key, "filename")) {
+      if (argument.size() >= 2 && argument.front() == '"' &&
+          argument.back() == '"') {
+        argument = argument.substr(1, argument.size() - 2);
+      }
+      plain = std::string(argument);
+    }
+  }
+  return plain;
+}
+
+std::string FileNameFromPath(std::string_view path) {
+  path = path.substr(0, path.find_first_of("?#"));
+  const size_t slash = path.rfind('/');
+  if (slash != std::string_view::npos) {
+    path.remove_prefix(slash + 1);
+  }
+  return PercentDecode(path);
+}
+
+std::string ContentType(const HttpHeaders& headers) {
+  const std::string* value = FindHeader(headers, "content-type");
+  if (!value) {
+    return std::string();
+  }
+  std::string type(Trim(std::string_view(*value).substr(0, value->find(';'))));
+  std::transform(type.begin(), type.end(), type.begin(), [](char c) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  });
+  return type;
+}
+
+template <typename T>
+void AppendBytes(std::vector<uint8_t>* output, const T& value) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+  output->insert(output->end(), bytes, bytes + sizeof(T));
+}
+
+}  // namespace
+
+std::vector<uint8_t> DownloadJournal::Serialize() const {
+  std::vector<uint8_t> output;
+  if (url.size() > kMaxUrlSize || validator.size() > kMaxValidatorSize ||
+      segments.size() > kMaxJournalSegments) {
+    return output;
+  }
+  JournalHeader header = {};
+  header.magic = kJournalMagic;
+  header.version = kJournalVersion;
+  header.total_size = total_size;
+  header.url_size = static_cast<uint32_t>(url.size());
+  header.validator_size = static_cast<uint32_t>(validator.size());
+  header.segment_count = static_cast<uint32_t>(segments.size());
+  header.hashed_bytes = hash.total_length;
+  std::memcpy(header.hash_state, hash.state, sizeof(header.hash_state));
+  std::memcpy(header.hash_buffer, hash.buffer, sizeof(header.hash_buffer));
+  output.reserve(sizeof(header) + url.size() + validator.size() +
+                 segments.size() * sizeof(JournalSegment) + sizeof(uint64_t));
+  AppendBytes(&output, header);
+  output.insert(output.end(), url.begin(), url.end());
+  output.insert(output.end(), validator.begin(), validator.end());
+  for (const auto& segment : segments) {
+    AppendBytes(&output, JournalSegment{segment.begin, segment.end,
+                                        segment.done});
+  }
+  AppendBytes(&output, XxHash64(output.data(), output.size()));
+  return output;
+}
+
+bool DownloadJournal::Parse(const uint8_t* data, size_t size) {
+  if (!data || size < sizeof(JournalHeader) + sizeof(uint64_t)) {
+    return false;
+  }
+  uint64_t checksum = 0;
+  std::memcpy(&checksum, data + size - sizeof(checksum), sizeof(checksum));
+  if (XxHash64(data, size - sizeof(checksum)) != checksum) {
+    return false;
+  }
+  JournalHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != kJournalMagic || header.version != kJournalVersion ||
+      header.url_size > kMaxUrlSize ||
+      header.validator_size > kMaxValidatorSize ||
+      header.segment_count > kMaxJournalSegments ||
+      sizeof(header) + header.url_size + header.validator_size +
+              static_cast<size_t>(header.segment_count) *
+                  sizeof(JournalSegment) +
+              sizeof(checksum) !=
+          size) {
+    return false;
+  }
+  const char* text = reinterpret_cast<const char*>(data + sizeof(header));
+  url.assign(text, header.url_size);
+  validator.assign(text + header.url_size, header.validator_size);
+  const uint8_t* table =
+      data + sizeof(header) + header.url_size + header.validator_size;
+  segments.assign(header.segment_count, SegmentPlan::Segment());
+  for (size_t i = 0; i < segments.size(); ++i) {
+    JournalSegment entry;
+    std::memcpy(&entry, table + i * sizeof(entry), sizeof(entry));
+    segments[i].begin = entry.begin;
+    segments[i].end = entry.end;
+    segments[i].done = entry.done;
+  }
+  total_size = header.total_size;
+  hash = {};
+  std::memcpy(hash.state, header.hash_state, sizeof(hash.state));
+  std::memcpy(hash.buffer, header.hash_buffer, sizeof(hash.buffer));
+  hash.total_length = header.hashed_bytes;
+  return true;
+}
+
+bool DownloadJournal::Save(const fs::path& path) const {
+  const std::vector<uint8_t> bytes = Serialize();
+  if (bytes.empty()) {
+    return false;
+  }
+  fs::path temp_path = path;
+  temp_path += ".tmp";
+  {
+    std::ofstream out(temp_path,
+                      std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!out) {
+      return false;
+    }
+    out.write(reinterpret_cast<const char*>(bytes.data()),
+              static_cast<std::streamsize>(bytes.size()));
+    if (!out) {
+      return false;
+    }
+  }
+  std::error_code error;
+  fs::rename(temp_path, path, error);
+  return !error;
+}
+
+bool DownloadJournal::Load(const fs::path& path) {
+  std::ifstream in(path, std::ios::in | std::ios::binary);
+  if (!in) {
+    return false;
+  }
+  const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)),
+                                   std::istreambuf_iterator<char>());
+  return Parse(bytes.data(), bytes.size());
+}
+
+bool ProbeDownload(HttpConnectionPool* pool,
+                   const std::string& url,
+                   DownloadProbe* probe,
+                   std::string* error) {
+  HttpOrigin origin;
+  HttpRequest request;
+  if (!ParseHttpUrl(url, &origin, &request.path)) {
+    *error = "Unsupported URL: " + url;
+    return false;
+  }
+  request.headers.emplace_back("Range", "bytes=0-0");
+  request.headers.emplace_back("Accept-Encoding", "identity");
+  // 不支持 Range 的服务器会返回整个文件，拿到响应头就停止
+  HttpResponse response;
+  bool received_headers = false;
+  request.body_sink = [&](const char*, size_t) {
+    received_headers = true;
+    return response.status_code == 206;
+  };
+  if (!pool->Execute(origin, request, &response, error) &&
+      !received_headers) {
+    return false;
+  }
+  *probe = DownloadProbe();
+  probe->status_code = response.status_code;
+  uint64_t first = 0;
+  uint64_t last = 0;
+  uint64_t total = 0;
+  const std::string* content_range = FindHeader(response.headers,
+                                                "content-range");
+  if (response.status_code == 206 && content_range &&
+      ParseContentRange(*content_range, &first, &last, &total) &&
+      total != kUnknownSize) {
+    probe->ranges = true;
+    probe->total_size = total;
+  } else if (response.status_code == 200) {
+    const std::string* length = FindHeader(response.headers, "content-length");
+    if (length) {
+      ParseUint64(Trim(*length), &probe->total_size);
+    }
+  }
+  probe->content_type = ContentType(response.headers);
+  const std::string* disposition =
+      FindHeader(response.headers, "content-disposition");
+  if (disposition) {
+    probe->file_name = FileNameFromDisposition(*disposition);
+  }
+  if (probe->file_name.empty()) {
+    probe->file_name = FileNameFromPath(request.path);
+  }
+  return true;
+}
+
+// 一次 HTTP 请求的状态。
+struct SegmentedDownload::Transfer {
+  size_t index = SegmentPlan::kNone;  // 第一个请求还没有分段时为 kNone
+  uint64_t position = 0;              // 下一个字节写入的位置
+  bool first = false;      // 决定下载方式的请求
+  bool checked = false;    // 已检查响应头
+  bool stopped = false;    // 读到段尾或暂停而主动停止，不算失败
+  bool progressed = false;
+  bool fatal = false;      // 不再重试
+  bool yield = false;      // 服务器拒绝额外的连接
+  bool restart = false;    // 续传时服务器上的文件已经变了
+};
+
+SegmentedDownload::SegmentedDownload(HttpConnectionPool* pool,
+                                     std::string url,
+                                     fs::path destination,
+                                     const DownloadOptions& options)
+    : pool_(pool),
+      url_(std::move(url)),
+      destination_(std::move(destination)),
+      options_(options),
+      start_time_(Clock::now()),
+      plan_(options.min_split_size),
+      hash_checkpoint_(hasher_.GetMidstate()) {}
+
+SegmentedDownload::~SegmentedDownload() {
+  Pause();
+  for (auto& worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+fs::path SegmentedDownload::PartPath(const fs::path& path) {
+  fs::path result = path;
+  result += ".part";
+  return result;
+}
+
+fs::path SegmentedDownload::JournalPath(const fs::path& path) {
+  fs::path result = path;
+  result += ".part.journal";
+  return result;
+}
+
+void SegmentedDownload::Discard(const fs::path& destination) {
+  std::error_code error;
+  fs::remove(PartPath(destination), error);
+  fs::remove(JournalPath(destination), error);
+}
+
+void SegmentedDownload::Pause() {
+  paused_ = true;
+  std::lock_guard<std::mutex> lock(mutex_);
+  cv_.notify_all();
+}
+
+DownloadResult SegmentedDownload::Run(const ProgressCallback& progress) {
+  DownloadResult result;
+  if (!ParseHttpUrl(url_, &origin_, &request_path_)) {
+    result.error = "Unsupported URL: " + url_;
+    return result;
+  }
+  std::error_code error;
+  fs::create_directories(destination_.parent_path(), error);
+  result.resumed_from = LoadJournal();
+  if (!file_.is_open()) {
+    Discard(destination_);
+    if (!file_.Open(PartPath(destination_)) || !file_.Resize(0)) {
+      result.error = "Unable to create " + PartPath(destination_).u8string();
+      return result;
+    }
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    StartWorkerLocked();
+    bool spread = false;
+    auto last_checkpoint = Clock::now();
+    auto last_report = last_checkpoint;
+    uint64_t last_received = plan_.completed();
+    double rate = 0.0;
+    for (;;) {
+      // 第一个响应确定支持分段后再打开其余连接
+      if (probed_ && !single_stream_ && !spread) {
+        spread = true;
+        for (size_t i = 1; i < options_.max_connections; ++i) {
+          StartWorkerLocked();
+        }
+      }
+      // 所有连接都退出了但还有没下载的部分（让出的连接在其它连接领完
+      // 工作之后才退出），补一条连接
+      if (running_workers_ == 0 && probed_ && !single_stream_ && !failed_ &&
+          !paused_ && !plan_.complete()) {
+        StartWorkerLocked();
+      }
+      if (running_workers_ == 0) {
+        break;
+      }
+      cv_.wait_for(lock, options_.progress_interval);
+
+      const auto now = Clock::now();
+      const double seconds =
+          std::chrono::duration<double>(now - last_report).count();
+      if (seconds > 0.0 && progress) {
+        const uint64_t received = plan_.completed();
+        const double current =
+            static_cast<double>(received - std::min(received, last_received)) /
+            seconds;
+        rate = rate == 0.0 ? current : rate * 0.7 + current * 0.3;
+        last_received = received;
+        last_report = now;
+        DownloadProgress snapshot = ProgressLocked();
+        snapshot.bytes_per_second = rate;
+        lock.unlock();
+        progress(snapshot);
+        lock.lock();
+      }
+      if (probed_ && !single_stream_ &&
+          now - last_checkpoint >= options_.checkpoint_interval) {
+        last_checkpoint = now;
+        lock.unlock();
+        Checkpoint();
+        lock.lock();
+      }
+    }
+  }
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  const bool complete = probed_ && !failed_ && plan_.complete();
+  if (complete) {
+    AdvanceHash(lock, nullptr, 0, 0);
+  }
+  if (complete && !failed_) {
+    result.size = plan_.total_size();
+    result.sha256 = hasher_.Finish();
+    lock.unlock();
+    const bool synced = file_.Sync();
+    file_.Close();
+    if (expected_ && *expected_ != result.sha256) {
+      Discard(destination_);
+      result.checksum_mismatch = true;
+      result.error = "SHA-256 mismatch";
+      return result;
+    }
+    fs::rename(PartPath(destination_), destination_, error);
+    if (!synced || error) {
+      result.error = "Unable to move the download to " +
+                     destination_.u8string();
+      return result;
+    }
+    fs::remove(JournalPath(destination_), error);
+    result.status = DownloadStatus::kCompleted;
+    return result;
+  }
+
+  const bool resumable = !single_stream_ && (probed_ || resumed_);
+  const bool failed = failed_;
+  result.error = failed_ ? error_ : std::string();
+  lock.unlock();
+  if (resumable) {
+    Checkpoint();
+  } else {
+    fs::remove(JournalPath(destination_), error);
+  }
+  file_.Close();
+  if (!failed && paused_) {
+    result.status = DownloadStatus::kPaused;
+  } else if (result.error.empty()) {
+    result.error = "Download stopped";
+  }
+  return result;
+}
+
+uint64_t SegmentedDownload::LoadJournal() {
+  DownloadJournal journal;
+  if (!journal.Load(JournalPath(destination_)) || journal.url != url_ ||
+      journal.total_size == 0) {
+    return 0;
+  }
+  if (!file_.Open(PartPath(destination_))) {
+    return 0;
+  }
+  if (file_.size() != journal.total_size ||
+      !plan_.Restore(journal.total_size, journal.segments) ||
+      journal.hash.total_length > plan_.contiguous_end()) {
+    file_.Close();
+    return 0;
+  }
+  hasher_.SetMidstate(journal.hash);
+  hashed_ = journal.hash.total_length;
+  hash_checkpoint_ = journal.hash;
+  validator_ = journal.validator;
+  resumed_ = true;
+  return plan_.completed();
+}
+
+bool SegmentedDownload::Checkpoint() {
+  DownloadJournal journal;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (single_stream_ || plan_.segment_count() == 0) {
+      return false;
+    }
+    journal.url = url_;
+    journal.validator = validator_;
+    journal.total_size = plan_.total_size();
+    journal.segments = plan_.Snapshot();
+    journal.hash = hash_checkpoint_;
+  }
+  // 日志记录的数据必须先落盘
+  return file_.Sync() && journal.Save(JournalPath(destination_));
+}
+
+void SegmentedDownload::StartWorkerLocked() {
+  ++running_workers_;
+  workers_.emplace_back(&SegmentedDownload::WorkerLoop, this);
+}
+
+void SegmentedDownload::WorkerLoop() {
+  int failures = 0;
+  for (;;) {
+    Transfer transfer;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (paused_ || failed_) {
+        break;
+      }
+      if (!probed_) {
+        transfer.first = true;
+        if (resumed_) {
+          if (plan_.complete()) {
+            // 上次下载完但还没改名就退出了
+            probed_ = true;
+            break;
+          }
+          transfer.index = plan_.Acquire(NowMicros());
+          transfer.position = plan_.segment(transfer.index).position();
+        }
+      } else if (single_stream_ || plan_.complete()) {
+        break;
+      } else {
+        transfer.index = plan_.Acquire(NowMicros());
+        if (transfer.index == SegmentPlan::kNone) {
+          break;
+        }
+        transfer.position = plan_.segment(transfer.index).position();
+      }
+      ++requests_in_flight_;
+    }
+
+    std::string error;
+    const bool ok = Fetch(&transfer, &error);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    --requests_in_flight_;
+    if (transfer.index != SegmentPlan::kNone) {
+      plan_.Release(transfer.index);
+    }
+    if (ok || transfer.stopped) {
+      failures = 0;
+      continue;
+    }
+    if (transfer.restart) {
+      // 从头下载：丢掉恢复的分段和校验状态
+      resumed_ = false;
+      validator_.clear();
+      plan_ = SegmentPlan(options_.min_split_size);
+      hasher_.Reset();
+      hashed_ = 0;
+      hash_checkpoint_ = hasher_.GetMidstate();
+      file_.Resize(0);
+      continue;
+    }
+    if (single_stream_) {
+      // 不能续传，下次从头开始
+      probed_ = false;
+      single_stream_ = false;
+      size_known_ = true;
+      plan_ = SegmentPlan(options_.min_split_size);
+      hasher_.Reset();
+      hashed_ = 0;
+      hash_checkpoint_ = hasher_.GetMidstate();
+      file_.Resize(0);
+    }
+    if (transfer.progressed) {
+      failures = 0;
+    }
+    if (transfer.yield && running_workers_ > 1) {
+      break;
+    }
+    if (transfer.fatal || ++failures > options_.max_retries) {
+      FailLocked(error);
+      break;
+    }
+    // 指数退避，暂停或失败时立即醒来
+    const auto delay = options_.retry_delay * (1 << std::min(failures - 1, 4));
+    cv_.wait_for(lock, delay, [this] { return paused_ || failed_; });
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  --running_workers_;
+  cv_.notify_all();
+}
+
+bool SegmentedDownload::Fetch(Transfer* transfer, std::string* error) {
+  HttpRequest request;
+  request.path = request_path_;
+  request.timeout = options_.request_timeout;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (transfer->index == SegmentPlan::kNone) {
+      request.headers.emplace_back("Range", "bytes=0-");
+    } else {
+      const uint64_t end = plan_.segment(transfer->index).end;
+      request.headers.emplace_back(
+          "Range", "bytes=" + std::to_string(transfer->position) + "-" +
+                       std::to_string(end - 1));
+      if (!validator_.empty()) {
+        request.headers.emplace_back("If-Range", validator_);
+      }
+    }
+  }
+  // 分段的偏移量以未压缩的内容为准
+  request.headers.emplace_back("Accept-Encoding", "identity");
+
+  HttpResponse response;
+  std::string consumer_error;
+  request.body_sink = [&](const char* data, size_t size) {
+    if (!transfer->checked) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      transfer->checked = true;
+      if (!CheckResponseLocked(response, transfer, &consumer_error)) {
+        return false;
+      }
+    }
+    return Consume(transfer, data, size);
+  };
+  std::string transport_error;
+  const bool sent =
+      pool_->Execute(origin_, request, &response, &transport_error);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (sent && !transfer->checked) {
+    // 空的响应体不会调用 body_sink
+    transfer->checked = true;
+    if (!CheckResponseLocked(response, transfer, &consumer_error)) {
+      *error = consumer_error;
+      return false;
+    }
+  }
+  if (!consumer_error.empty()) {
+    *error = consumer_error;
+    return false;
+  }
+  if (!sent) {
+    *error = transport_error;
+    return false;
+  }
+  if (single_stream_ && !size_known_) {
+    // 大小未知时读到结尾就是完成
+    plan_.Restore(transfer->position,
+                  {SegmentPlan::Segment{0, transfer->position,
+                                        transfer->position}});
+    cv_.notify_all();
+    return true;
+  }
+  if (transfer->index != SegmentPlan::kNone &&
+      transfer->position < plan_.segment(transfer->index).end) {
+    *error = "Connection closed before the requested range was received";
+    return false;
+  }
+  return true;
+}
+
+bool SegmentedDownload::CheckResponseLocked(const HttpResponse& response,
+                                            Transfer* transfer,
+                                            std::string* error) {
+  const int status = response.status_code;
+  if (status == 206) {
+    const std::string* content_range =
+        FindHeader(response.headers, "content-range");
+    uint64_t first = 0;
+    uint64_t last = 0;
+    uint64_t total = 0;
+    if (!content_range ||
+        !ParseContentRange(*content_range, &first, &last, &total)) {
+      *error = "Malformed Content-Range";
+      transfer->fatal = true;
+      return false;
+    }
+    if (transfer->index == SegmentPlan::kNone) {
+      if (first != 0) {
+        *error = "Server returned an unexpected range";
+        transfer->fatal = true;
+        return false;
+      }
+      validator_ = ResponseValidator(response.headers);
+      if (total == kUnknownSize) {
+        // 不知道总大小就没法分段
+        single_stream_ = true;
+        size_known_ = false;
+        plan_.Reset(kUnknownSize);
+      } else {
+        plan_.Reset(total);
+        if (!file_.Resize(total)) {
+          *error = "Unable to allocate " + std::to_string(total) + " bytes";
+          transfer->fatal = true;
+          return false;
+        }
+      }
+      transfer->index = plan_.Acquire(NowMicros());
+    } else if (first != transfer->position || total != plan_.total_size()) {
+      *error = "Server returned an unexpected range";
+      // 没有 ETag 和 Last-Modified 时，续传靠文件大小发现变化
+      transfer->restart = transfer->first && resumed_;
+      transfer->fatal = !transfer->restart;
+      return false;
+    }
+    if (transfer->first) {
+      probed_ = true;
+      cv_.notify_all();
+    }
+    return true;
+  }
+
+  if (status == 200 && transfer->first && !resumed_) {
+    // 不支持 Range，只能单连接顺序下载
+    single_stream_ = true;
+    uint64_t length = 0;
+    const std::string* content_length =
+        FindHeader(response.headers, "content-length");
+    size_known_ = content_length && ParseUint64(Trim(*content_length), &length);
+    plan_.Reset(size_known_ ? length : kUnknownSize);
+    transfer->index = plan_.Acquire(NowMicros());
+    probed_ = true;
+    cv_.notify_all();
+    return true;
+  }
+  if ((status == 200 || status == 416) && transfer->first && resumed_) {
+    *error = "The file changed on the server";
+    transfer->restart = true;
+    return false;
+  }
+  if (status == 200) {
+    *error = "Server stopped honoring range requests";
+    transfer->fatal = true;
+    return false;
+  }
+  *error = "HTTP " + std::to_string(status);
+  transfer->yield = status == 429 || status == 503;
+  transfer->fatal =
+      status >= 400 && status < 500 && status != 408 && status != 429;
+  return false;
+}
+
+bool SegmentedDownload::Consume(Transfer* transfer,
+                                const char* data,
+                                size_t size) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (paused_ || failed_) {
+    transfer->stopped = true;
+    return false;
+  }
+  const uint64_t end = plan_.segment(transfer->index).end;
+  const uint64_t length = std::min<uint64_t>(
+      size, end > transfer->position ? end - transfer->position : 0);
+  const uint64_t offset = transfer->position;
+  lock.unlock();
+  // 各连接写入的区域不重叠，不需要持锁
+  if (length > 0 && !file_.WriteAt(offset, data, static_cast<size_t>(length))) {
+    lock.lock();
+    transfer->fatal = true;
+    FailLocked("Unable to write " + PartPath(destination_).u8string());
+    return false;
+  }
+  lock.lock();
+  const uint64_t counted = plan_.Commit(transfer->index, length, NowMicros());
+  transfer->position += counted;
+  if (counted > 0) {
+    transfer->progressed = true;
+  }
+  AdvanceHash(lock, data, offset, counted);
+  if (counted < size) {
+    // 这一段被拆短了，后面的数据由别的连接下载
+    transfer->stopped = true;
+    return false;
+  }
+  return true;
+}
+
+void SegmentedDownload::AdvanceHash(std::unique_lock<std::mutex>& lock,
+                                    const char* data,
+                                    uint64_t offset,
+                                    uint64_t size) {
+  if (hashing_) {
+    return;
+  }
+  hashing_ = true;
+  while (!failed_ && hashed_ < plan_.contiguous_end()) {
+    const uint64_t target = plan_.contiguous_end();
+    if (data && offset == hashed_ && size > 0) {
+      const uint64_t length = std::min(size, target - hashed_);
+      lock.unlock();
+      hasher_.Update(data, static_cast<size_t>(length));
+      lock.lock();
+      hashed_ += length;
+    } else {
+      // 前面的段刚完成，从文件读回
+      const size_t length = static_cast<size_t>(
+          std::min<uint64_t>(target - hashed_, kHashReadSize));
+      const uint64_t position = hashed_;
+      lock.unlock();
+      hash_buffer_.resize(kHashReadSize);
+      const bool read = file_.ReadAt(position, hash_buffer_.data(), length);
+      if (read) {
+        hasher_.Update(hash_buffer_.data(), length);
+      }
+      lock.lock();
+      if (!read) {
+        FailLocked("Unable to read back " + PartPath(destination_).u8string());
+        break;
+      }
+      hashed_ += length;
+    }
+    data = nullptr;
+    hash_checkpoint_ = hasher_.GetMidstate();
+  }
+  hashing_ = false;
+}
+
+void SegmentedDownload::FailLocked(const std::string& error) {
+  if (!failed_) {
+    failed_ = true;
+    error_ = error;
+  }
+  cv_.notify_all();
+}
+
+DownloadProgress SegmentedDownload::ProgressLocked() const {
+  DownloadProgress progress;
+  if (probed_ || resumed_) {
+    progress.total_size =
+        size_known_ && plan_.segment_count() > 0 ? plan_.total_size() : 0;
+    progress.received = plan_.completed();
+    progress.segments = plan_.segment_count();
+  }
+  progress.verified = hashed_;
+  progress.connections = requests_in_flight_;
+  return progress;
+}
+
+int64_t SegmentedDownload::NowMicros() const {
+  return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() -
+                                                               start_time_)
+      .count();
+}
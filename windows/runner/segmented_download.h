@@ -0,0 +1,188 @@
+#ifndef RUNNER_SEGMENTED_DOWNLOAD_H_
+#define RUNNER_SEGMENTED_DOWNLOAD_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "http_connection_pool.h"
+#include "random_access_file.h"
+#include "segment_plan.h"
+#include "sha256.h"
+
+// 分段、可续传的大文件下载（与平台无关）。
+//
+// 第一个请求带 "Range: bytes=0-"：服务器返回 206 时得到文件大小，之后由
+// 最多 max_connections 条连接按 SegmentPlan 分段并行下载；返回 200 时
+// 退化为单连接顺序下载，不能续传。数据写入 <目标>.part，完成后改名。
+//
+// 续传：分段表和 SHA-256 中间状态定期写入 <目标>.part.journal（先把数据
+// 刷到磁盘再写日志）。再次下载同一目标时从日志继续，请求带 If-Range，
+// 服务器上的文件变了会返回 200，此时从头下载。
+//
+// 校验：SHA-256 按文件顺序流式计算。写入的数据正好接在已校验部分之后时
+// 直接从内存计算，否则等前面的段完成后从文件读回。下载完成时摘要已经
+// 算好，给了期望值而不一致时删除文件并报告失败。
+//
+// 出错的连接按退避重试，同一条连接连续失败 max_retries 次后放弃，其它
+// 连接接手它的段；服务器以 429/503 拒绝额外的连接时，该连接直接退出。
+
+// 续传日志。
+struct DownloadJournal {
+  std::string url;
+  std::string validator;  // ETag，没有时为 Last-Modified，都没有时为空
+  uint64_t total_size = 0;
+  std::vector<SegmentPlan::Segment> segments;  // 只保存 begin、end、done
+  Sha256::Midstate hash = {};  // hash.total_length 为已校验的字节数
+
+  std::vector<uint8_t> Serialize() const;
+  bool Parse(const uint8_t* data, size_t size);
+  // 先写临时文件再改名。
+  bool Save(const std::filesystem::path& path) const;
+  bool Load(const std::filesystem::path& path);
+};
+
+// 下载前探测链接（GET，Range: bytes=0-0）。
+struct DownloadProbe {
+  int status_code = 0;
+  bool ranges = false;       // 支持分段
+  uint64_t total_size = 0;   // 0 表示未知
+  std::string content_type;  // 小写，不含参数
+  std::string file_name;     // Content-Disposition 或 URL 路径中的文件名
+};
+
+bool ProbeDownload(HttpConnectionPool* pool,
+                   const std::string& url,
+                   DownloadProbe* probe,
+                   std::string* error);
+
+struct DownloadOptions {
+  size_t max_connections = 4;
+  uint64_t min_split_size = 4u << 20;
+  int max_retries = 5;
+  std::chrono::milliseconds retry_delay{1000};
+  std::chrono::milliseconds request_timeout{30000};
+  std::chrono::milliseconds progress_interval{250};
+  std::chrono::milliseconds checkpoint_interval{2000};
+};
+
+struct DownloadProgress {
+  uint64_t total_size = 0;  // 0 表示未知
+  uint64_t received = 0;    // 已写入，包括之前下载的部分
+  uint64_t verified = 0;    // 已计算 SHA-256 的连续字节
+  double bytes_per_second = 0.0;
+  size_t connections = 0;
+  size_t segments = 0;
+};
+
+enum class DownloadStatus {
+  kCompleted,
+  kPaused,
+  kFailed,
+};
+
+struct DownloadResult {
+  DownloadStatus status = DownloadStatus::kFailed;
+  std::string error;
+  bool checksum_mismatch = false;
+  uint64_t size = 0;
+  uint64_t resumed_from = 0;  // 从日志恢复的字节数
+  Sha256Digest sha256 = {};   // 完成时有效
+};
+
+class SegmentedDownload {
+ public:
+  using ProgressCallback = std::function<void(const DownloadProgress&)>;
+
+  SegmentedDownload(HttpConnectionPool* pool,
+                    std::string url,
+                    std::filesystem::path destination,
+                    const DownloadOptions& options);
+  ~SegmentedDownload();
+
+  SegmentedDownload(const SegmentedDownload&) = delete;
+  SegmentedDownload& operator=(const SegmentedDownload&) = delete;
+
+  void set_expected_sha256(const Sha256Digest& digest) { expected_ = digest; }
+
+  // 阻塞直到完成、暂停或失败，|progress| 在调用线程上定期调用。只能调用
+  // 一次。
+  DownloadResult Run(const ProgressCallback& progress);
+
+  // 可以在任意线程调用，Run 写好日志后以 kPaused 返回。
+  void Pause();
+
+  static std::filesystem::path PartPath(const std::filesystem::path& path);
+  static std::filesystem::path JournalPath(const std::filesystem::path& path);
+  // 删除未完成的 .part 和日志。
+  static void Discard(const std::filesystem::path& destination);
+
+ private:
+  using Clock = std::chrono::steady_clock;
+  struct Transfer;
+
+  // 从日志恢复，返回恢复的字节数，没有可用的日志时返回 0。
+  uint64_t LoadJournal();
+  bool Checkpoint();
+
+  void WorkerLoop();
+  bool Fetch(Transfer* transfer, std::string* error);
+  // 检查响应头，第一个请求在这里确定文件大小和下载方式。
+  bool CheckResponseLocked(const HttpResponse& response,
+                           Transfer* transfer,
+                           std::string* error);
+  bool Consume(Transfer* transfer, const char* data, size_t size);
+  // 计算已连续写入部分的 SHA-256。|data| 为刚写到 |offset| 的数据，可以
+  // 为 nullptr。同一时刻只有一个线程在计算。
+  void AdvanceHash(std::unique_lock<std::mutex>& lock,
+                   const char* data,
+                   uint64_t offset,
+                   uint64_t size);
+  void FailLocked(const std::string& error);
+  DownloadProgress ProgressLocked() const;
+  void StartWorkerLocked();
+  int64_t NowMicros() const;
+
+  HttpConnectionPool* const pool_;
+  const std::string url_;
+  const std::filesystem::path destination_;
+  const DownloadOptions options_;
+  const Clock::time_point start_time_;
+  std::optional<Sha256Digest> expected_;
+  HttpOrigin origin_;
+  std::string request_path_;
+  RandomAccessFile file_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<std::thread> workers_;
+  size_t running_workers_ = 0;
+  size_t requests_in_flight_ = 0;
+  std::atomic<bool> paused_{false};
+  bool failed_ = false;
+  std::string error_;
+
+  bool probed_ = false;       // 第一个响应已经确定了下载方式
+  bool resumed_ = false;      // 从日志恢复，第一个请求需要 If-Range
+  bool single_stream_ = false;
+  bool size_known_ = true;    // 单连接且没有 Content-Length 时为 false
+  std::string validator_;
+  SegmentPlan plan_;
+
+  Sha256 hasher_;
+  uint64_t hashed_ = 0;
+  bool hashing_ = false;
+  Sha256::Midstate hash_checkpoint_ = {};
+  std::vector<char> hash_buffer_;  // 只由正在计算的线程使用
+};
+
+#endif  // RUNNER_SEGMENTED_DOWNLOAD_H_
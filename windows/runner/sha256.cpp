@@ -0,0 +1,269 @@
+#include "sha256.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "cpu_features.h"
+
+#if RUNNER_ARCH_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+alignas(16) constexpr uint32_t kRoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+constexpr uint32_t kInitialState[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372,
+                                       0xa54ff53a, 0x510e527f, 0x9b05688c,
+                                       0x1f83d9ab, 0x5be0cd19};
+
+inline uint32_t RotateRight(uint32_t value, int bits) {
+  return (value >> bits) | (value << (32 - bits));
+}
+
+inline uint32_t LoadBigEndian32(const uint8_t* p) {
+  return (static_cast<uint32_t>(p[0]) << 24) |
+         (static_cast<uint32_t>(p[1]) << 16) |
+         (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+void ProcessBlocksScalar(uint32_t state[8], const uint8_t* data,
+                         size_t blocks) {
+  uint32_t w[64];
+  for (; blocks > 0; --blocks, data += 64) {
+    for (int i = 0; i < 16; ++i) {
+      w[i] = LoadBigEndian32(data + 4 * i);
+    }
+    for (int i = 16; i < 64; ++i) {
+      const uint32_t s0 = RotateRight(w[i - 15], 7) ^
+                          RotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+      const uint32_t s1 = RotateRight(w[i - 2], 17) ^
+                          RotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+      w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; ++i) {
+      const uint32_t s1 =
+          RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25);
+      const uint32_t choose = (e & f) ^ (~e & g);
+      const uint32_t temp1 = h + s1 + choose + kRoundConstants[i] + w[i];
+      const uint32_t s0 =
+          RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22);
+      const uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+      const uint32_t temp2 = s0 + majority;
+      h = g;
+      g = f;
+      f = e;
+      e = d + temp1;
+      d = c;
+      c = b;
+      b = a;
+      a = temp1 + temp2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+  }
+}
+
+#if RUNNER_ARCH_X86
+// Intel SHA 扩展实现。每 4 轮一组，消息扩展用 sha256msg1/msg2 在寄存器中
+// 滚动计算，state 按 ABEF/CDGH 的排列保存在两个 XMM 寄存器中。
+// 分组用模板展开，保证四个消息寄存器不会落到栈上。
+template <int Group>
+RUNNER_TARGET_ATTRIBUTE("sha,sse4.1,ssse3")
+inline void ShaNiRounds(__m128i& state0, __m128i& state1, __m128i& current,
+                        __m128i& next, __m128i& previous) {
+  __m128i message = _mm_add_epi32(
+      current, _mm_load_si128(reinterpret_cast<const __m128i*>(
+                   kRoundConstants + 4 * Group)));
+  state1 = _mm_sha256rnds2_epu32(state1, state0, message);
+  if constexpr (Group >= 3 && Group <= 14) {
+    next = _mm_add_epi32(next, _mm_alignr_epi8(current, previous, 4));
+    next = _mm_sha256msg2_epu32(next, current);
+  }
+  message = _mm_shuffle_epi32(message, 0x0E);
+  state0 = _mm_sha256rnds2_epu32(state0, state1, message);
+  if constexpr (Group >= 1 && Group <= 12) {
+    previous = _mm_sha256msg1_epu32(previous, current);
+  }
+}
+
+RUNNER_TARGET_ATTRIBUTE("sha,sse4.1,ssse3")
+void ProcessBlocksShaNi(uint32_t state[8], const uint8_t* data,
+                        size_t blocks) {
+  const __m128i byte_swap_mask =
+      _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+  __m128i temp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state));
+  __m128i state1 =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4));
+  temp = _mm_shuffle_epi32(temp, 0xB1);               // CDAB
+  state1 = _mm_shuffle_epi32(state1, 0x1B);           // EFGH
+  __m128i state0 = _mm_alignr_epi8(temp, state1, 8);  // ABEF
+  state1 = _mm_blend_epi16(state1, temp, 0xF0);       // CDGH
+
+  for (; blocks > 0; --blocks, data += 64) {
+    const __m128i abef_save = state0;
+    const __m128i cdgh_save = state1;
+    const __m128i* input = reinterpret_cast<const __m128i*>(data);
+    __m128i m0 = _mm_shuffle_epi8(_mm_loadu_si128(input), byte_swap_mask);
+    __m128i m1 = _mm_shuffle_epi8(_mm_loadu_si128(input + 1), byte_swap_mask);
+    __m128i m2 = _mm_shuffle_epi8(_mm_loadu_si128(input + 2), byte_swap_mask);
+    __m128i m3 = _mm_shuffle_epi8(_mm_loadu_si128(input + 3), byte_swap_mask);
+
+    // 参数依次为：本组消息、下一组消息、上一组消息
+    ShaNiRounds<0>(state0, state1, m0, m1, m3);
+    ShaNiRounds<1>(state0, state1, m1, m2, m0);
+    ShaNiRounds<2>(state0, state1, m2, m3, m1);
+    ShaNiRounds<3>(state0, state1, m3, m0, m2);
+    ShaNiRounds<4>(state0, state1, m0, m1, m3);
+    ShaNiRounds<5>(state0, state1, m1, m2, m0);
+    ShaNiRounds<6>(state0, state1, m2, m3, m1);
+    ShaNiRounds<7>(state0, state1, m3, m0, m2);
+    ShaNiRounds<8>(state0, state1, m0, m1, m3);
+    ShaNiRounds<9>(state0, state1, m1, m2, m0);
+    ShaNiRounds<10>(state0, state1, m2, m3, m1);
+    ShaNiRounds<11>(state0, state1, m3, m0, m2);
+    ShaNiRounds<12>(state0, state1, m0, m1, m3);
+    ShaNiRounds<13>(state0, state1, m1, m2, m0);
+    ShaNiRounds<14>(state0, state1, m2, m3, m1);
+    ShaNiRounds<15>(state0, state1, m3, m0, m2);
+
+    state0 = _mm_add_epi32(state0, abef_save);
+    state1 = _mm_add_epi32(state1, cdgh_save);
+  }
+
+  temp = _mm_shuffle_epi32(state0, 0x1B);        // FEBA
+  state1 = _mm_shuffle_epi32(state1, 0xB1);      // DCHG
+  state0 = _mm_blend_epi16(temp, state1, 0xF0);  // DCBA
+  state1 = _mm_alignr_epi8(state1, temp, 8);     // ABEF
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(state), state0);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), state1);
+}
+#endif
+
+using ProcessBlocksFunction = void (*)(uint32_t*, const uint8_t*, size_t);
+
+ProcessBlocksFunction SelectProcessBlocks() {
+#if RUNNER_ARCH_X86
+  const CpuFeatures& features = GetCpuFeatures();
+  if (features.sha && features.sse41 && features.ssse3) {
+    return ProcessBlocksShaNi;
+  }
+#endif
+  return ProcessBlocksScalar;
+}
+
+void ProcessBlocks(uint32_t state[8], const uint8_t* data, size_t blocks) {
+  static const ProcessBlocksFunction process = SelectProcessBlocks();
+  process(state, data, blocks);
+}
+
+}  // namespace
+
+Sha256::Sha256() {
+  Reset();
+}
+
+void Sha256::Reset() {
+  std::memcpy(state_, kInitialState, sizeof(state_));
+  buffer_length_ = 0;
+  total_length_ = 0;
+}
+
+void Sha256::Update(const void* data, size_t length) {
+  const uint8_t* input = static_cast<const uint8_t*>(data);
+  total_length_ += length;
+  if (buffer_length_ > 0) {
+    const size_t take = std::min(length, sizeof(buffer_) - buffer_length_);
+    std::memcpy(buffer_ + buffer_length_, input, take);
+    buffer_length_ += take;
+    input += take;
+    length -= take;
+    if (buffer_length_ < sizeof(buffer_)) {
+      return;
+    }
+    ProcessBlocks(state_, buffer_, 1);
+    buffer_length_ = 0;
+  }
+  const size_t blocks = length / 64;
+  if (blocks > 0) {
+    ProcessBlocks(state_, input, blocks);
+    input += blocks * 64;
+    length -= blocks * 64;
+  }
+  if (length > 0) {
+    std::memcpy(buffer_, input, length);
+    buffer_length_ = length;
+  }
+}
+
+Sha256Digest Sha256::Finish() {
+  const uint64_t bit_length = total_length_ * 8;
+  uint8_t padding[72] = {0x80};
+  const size_t padding_length =
+      (buffer_length_ < 56 ? 56 : 120) - buffer_length_;
+  Update(padding, padding_length);
+  uint8_t length_bytes[8];
+  for (int i = 0; i < 8; ++i) {
+    length_bytes[i] = static_cast<uint8_t>(bit_length >> (56 - 8 * i));
+  }
+  Update(length_bytes, sizeof(length_bytes));
+
+  Sha256Digest digest;
+  for (int i = 0; i < 8; ++i) {
+    digest[4 * i] = static_cast<uint8_t>(state_[i] >> 24);
+    digest[4 * i + 1] = static_cast<uint8_t>(state_[i] >> 16);
+    digest[4 * i + 2] = static_cast<uint8_t>(state_[i] >> 8);
+    digest[4 * i + 3] = static_cast<uint8_t>(state_[i]);
+  }
+  return digest;
+}
+
+Sha256::Midstate Sha256::GetMidstate() const {
+  Midstate midstate = {};
+  std::memcpy(midstate.state, state_, sizeof(state_));
+  std::memcpy(midstate.buffer, buffer_, buffer_length_);
+  midstate.total_length = total_length_;
+  return midstate;
+}
+
+void Sha256::SetMidstate(const Midstate& midstate) {
+  std::memcpy(state_, midstate.state, sizeof(state_));
+  buffer_length_ = static_cast<size_t>(midstate.total_length % 64);
+  std::memcpy(buffer_, midstate.buffer, buffer_length_);
+  total_length_ = midstate.total_length;
+}
+
+Sha256Digest Sha256::Hash(const void* data, size_t length) {
+  Sha256 hasher;
+  hasher.Update(data, length);
+  return hasher.Finish();
+}
+
+bool Sha256::IsHardwareAccelerated() {
+#if RUNNER_ARCH_X86
+  const CpuFeatures& features = GetCpuFeatures();
+  return features.sha && features.sse41 && features.ssse3;
+#else
+  return false;
+#endif
+}
@@ -0,0 +1,43 @@
+#ifndef RUNNER_SHA256_H_
+#define RUNNER_SHA256_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+using Sha256Digest = std::array<uint8_t, 32>;
+
+// SHA-256。CPU 支持 SHA 扩展（SHA-NI）时使用硬件指令，否则使用标量实现，
+// 两者结果一致。
+class Sha256 {
+ public:
+  // 可以保存下来、之后接着计算的中间状态。
+  struct Midstate {
+    uint32_t state[8];
+    uint8_t buffer[64];  // 前 total_length % 64 字节有效
+    uint64_t total_length;
+  };
+
+  Sha256();
+
+  void Update(const void* data, size_t length);
+  // 结束计算并返回摘要，之后需要 Reset 才能再次使用。
+  Sha256Digest Finish();
+  void Reset();
+
+  Midstate GetMidstate() const;
+  void SetMidstate(const Midstate& midstate);
+
+  static Sha256Digest Hash(const void* data, size_t length);
+
+  // 当前 CPU 是否走硬件加速路径。
+  static bool IsHardwareAccelerated();
+
+ private:
+  uint32_t state_[8];
+  uint8_t buffer_[64];
+  size_t buffer_length_ = 0;
+  uint64_t total_length_ = 0;
+};
+
+#endif  // RUNNER_SHA256_H_
@@ -0,0 +1,241 @@
+#include "startup_snapshot.h"
+
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <utility>
+
+#include "xxhash64.h"
+
+namespace {
+
+constexpr uint32_t kSnapshotMagic = 0x53535853;  // "SXSS"
+constexpr uint32_t kSnapshotVersion = 1;
+
+struct SnapshotHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t schema;
+  uint32_t section_count;
+  int64_t saved_unix_ms;
+  uint64_t table_checksum;  // 段表的 XXH64
+  uint64_t file_size;
+  uint8_t reserved[24];
+};
+static_assert(sizeof(SnapshotHeader) == 64, "SnapshotHeader must be 64 bytes");
+
+struct SectionEntry {
+  uint32_t name_offset;
+  uint32_t name_size;
+  uint32_t data_offset;
+  uint32_t data_size;
+  uint64_t checksum;  // 段名和段内容的 XXH64
+};
+static_assert(sizeof(SectionEntry) == 24, "SectionEntry must be 24 bytes");
+
+size_t AlignUp(size_t value) {
+  return (value + 7) & ~size_t{7};
+}
+
+uint64_t SectionChecksum(const void* name,
+                         size_t name_size,
+                         const void* data,
+                         size_t data_size) {
+  return XxHash64(data, data_size, XxHash64(name, name_size));
+}
+
+}  // namespace
+
+bool StartupSnapshotWriter::Put(const std::string& name,
+                                std::vector<uint8_t> data) {
+  if (name.empty() || name.size() > kMaxNameSize) {
+    return false;
+  }
+  auto it = sections_.find(name);
+  if (it != sections_.end()) {
+    it->second = std::move(data);
+    return true;
+  }
+  if (sections_.size() >= kMaxSections) {
+    return false;
+  }
+  sections_.emplace(name, std::move(data));
+  return true;
+}
+
+void StartupSnapshotWriter::Remove(const std::string& name) {
+  sections_.erase(name);
+}
+
+std::vector<uint8_t> StartupSnapshotWriter::Serialize(
+    uint32_t schema,
+    int64_t saved_unix_ms) const {
+  const size_t table_size = sections_.size() * sizeof(SectionEntry);
+  size_t total = sizeof(SnapshotHeader) + table_size;
+  for (const auto& entry : sections_) {
+    total += entry.first.size();
+  }
+  total = AlignUp(total);
+  for (const auto& entry : sections_) {
+    total = AlignUp(total + entry.second.size());
+  }
+  if (total > kMaxFileSize) {
+    return {};
+  }
+
+  std::vector<uint8_t> output(total, 0);
+  std::vector<SectionEntry> table;
+  table.reserve(sections_.size());
+  size_t name_offset = sizeof(SnapshotHeader) + table_size;
+  for (const auto& entry : sections_) {
+    SectionEntry section = {};
+    section.name_offset = static_cast<uint32_t>(name_offset);
+    section.name_size = static_cast<uint32_t>(entry.first.size());
+    std::memcpy(output.data() + name_offset, entry.first.data(),
+                entry.first.size());
+    name_offset += entry.first.size();
+    table.push_back(section);
+  }
+  size_t data_offset = AlignUp(name_offset);
+  size_t index = 0;
+  for (const auto& entry : sections_) {
+    SectionEntry& section = table[index++];
+    section.data_offset = static_cast<uint32_t>(data_offset);
+    section.data_size = static_cast<uint32_t>(entry.second.size());
+    section.checksum =
+        SectionChecksum(entry.first.data(), entry.first.size(),
+                        entry.second.data(), entry.second.size());
+    if (!entry.second.empty()) {
+      std::memcpy(output.data() + data_offset, entry.second.data(),
+                  entry.second.size());
+    }
+    data_offset = AlignUp(data_offset + entry.second.size());
+  }
+  if (!table.empty()) {
+    std::memcpy(output.data() + sizeof(SnapshotHeader), table.data(),
+                table_size);
+  }
+
+  SnapshotHeader header = {};
+  header.magic = kSnapshotMagic;
+  header.version = kSnapshotVersion;
+  header.schema = schema;
+  header.section_count = static_cast<uint32_t>(sections_.size());
+  header.saved_unix_ms = saved_unix_ms;
+  header.table_checksum = XxHash64(table.data(), table_size);
+  header.file_size = total;
+  std::memcpy(output.data(), &header, sizeof(header));
+  return output;
+}
+
+bool StartupSnapshotWriter::Write(const std::filesystem::path& path,
+                                  uint32_t schema,
+                                  int64_t saved_unix_ms) const {
+  const std::vector<uint8_t> bytes = Serialize(schema, saved_unix_ms);
+  if (bytes.empty()) {
+    return false;
+  }
+  std::error_code error;
+  std::filesystem::create_directories(path.parent_path(), error);
+  std::filesystem::path temp_path = path;
+  temp_path += ".tmp";
+  {
+    std::ofstream out(temp_path,
+                      std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!out) {
+      return false;
+    }
+    out.write(reinterpret_cast<const char*>(bytes.data()),
+              static_cast<std::streamsize>(bytes.size()));
+    if (!out) {
+      return false;
+    }
+  }
+  std::filesystem::rename(temp_path, path, error);
+  return !error;
+}
+
+bool StartupSnapshotReader::Open(const std::filesystem::path& path) {
+  Close();
+  if (!file_.Open(path)) {
+    return false;
+  }
+  if (!Parse(file_.data(), file_.size())) {
+    file_.Close();
+    return false;
+  }
+  return true;
+}
+
+bool StartupSnapshotReader::Parse(const uint8_t* data, size_t size) {
+  valid_ = false;
+  sections_.clear();
+  if (!data || size < sizeof(SnapshotHeader) ||
+      size > StartupSnapshotWriter::kMaxFileSize) {
+    return false;
+  }
+  SnapshotHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != kSnapshotMagic || header.version != kSnapshotVersion ||
+      header.file_size != size ||
+      header.section_count > StartupSnapshotWriter::kMaxSections) {
+    return false;
+  }
+  const size_t table_size = header.section_count * sizeof(SectionEntry);
+  if (sizeof(SnapshotHeader) + table_size > size) {
+    return false;
+  }
+  const uint8_t* table = data + sizeof(SnapshotHeader);
+  if (XxHash64(table, table_size) != header.table_checksum) {
+    return false;
+  }
+
+  std::vector<Section> sections;
+  sections.reserve(header.section_count);
+  for (uint32_t i = 0; i < header.section_count; ++i) {
+    SectionEntry entry;
+    std::memcpy(&entry, table + i * sizeof(SectionEntry), sizeof(entry));
+    if (entry.name_size == 0 ||
+        entry.name_size > StartupSnapshotWriter::kMaxNameSize ||
+        entry.name_offset > size || entry.name_size > size - entry.name_offset ||
+        entry.data_offset > size || entry.data_size > size - entry.data_offset) {
+      return false;
+    }
+    const uint8_t* name = data + entry.name_offset;
+    const uint8_t* payload = data + entry.data_offset;
+    if (SectionChecksum(name, entry.name_size, payload, entry.data_size) !=
+        entry.checksum) {
+      return false;
+    }
+    Section section;
+    section.name =
+        std::string_view(reinterpret_cast<const char*>(name), entry.name_size);
+    section.data = payload;
+    section.size = entry.data_size;
+    sections.push_back(section);
+  }
+
+  sections_ = std::move(sections);
+  schema_ = header.schema;
+  saved_unix_ms_ = header.saved_unix_ms;
+  valid_ = true;
+  return true;
+}
+
+void StartupSnapshotReader::Close() {
+  valid_ = false;
+  schema_ = 0;
+  saved_unix_ms_ = 0;
+  sections_.clear();
+  file_.Close();
+}
+
+const StartupSnapshotReader::Section* StartupSnapshotReader::Find(
+    std::string_view name) const {
+  for (const Section& section : sections_) {
+    if (section.name == name) {
+      return &section;
+    }
+  }
+  return nullptr;
+}
@@ -0,0 +1,83 @@
+#ifndef RUNNER_STARTUP_SNAPSHOT_H_
+#define RUNNER_STARTUP_SNAPSHOT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mapped_file.h"
+
+// 启动快照：上次退出时首页数据的紧凑二进制副本（与平台无关）。
+//
+// 文件由若干命名段组成，段内容对本模块是不透明的字节（Dart 写入 UTF-8
+// JSON）。布局：64 字节文件头、段表（每段 24 字节）、段名和段内容，段
+// 内容按 8 字节对齐。段表和每一段都有 XXH64 校验，格式版本不同或任何
+// 校验失败时整个快照作废。|schema| 由写入方定义，读取方据此判断段内容
+// 还能不能解析。
+
+// 收集段内容，一次写出。
+class StartupSnapshotWriter {
+ public:
+  static constexpr size_t kMaxSections = 64;
+  static constexpr size_t kMaxNameSize = 64;
+  static constexpr size_t kMaxFileSize = 16u << 20;
+
+  // 名称为空、过长或段数已满时返回 false。
+  bool Put(const std::string& name, std::vector<uint8_t> data);
+  void Remove(const std::string& name);
+
+  bool has(const std::string& name) const { return sections_.count(name) > 0; }
+  size_t section_count() const { return sections_.size(); }
+
+  // 总大小超过 kMaxFileSize 时返回空数组。
+  std::vector<uint8_t> Serialize(uint32_t schema, int64_t saved_unix_ms) const;
+  // 先写临时文件再改名，避免写到一半时退出留下损坏的快照。
+  bool Write(const std::filesystem::path& path,
+             uint32_t schema,
+             int64_t saved_unix_ms) const;
+
+ private:
+  std::map<std::string, std::vector<uint8_t>> sections_;
+};
+
+// 读取快照。Open 使用内存映射并在返回前校验全部内容，段内容直接指向
+// 映射区域，不做拷贝。
+class StartupSnapshotReader {
+ public:
+  struct Section {
+    std::string_view name;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+  };
+
+  StartupSnapshotReader() = default;
+
+  StartupSnapshotReader(const StartupSnapshotReader&) = delete;
+  StartupSnapshotReader& operator=(const StartupSnapshotReader&) = delete;
+
+  // 文件不存在或无效时返回 false。
+  bool Open(const std::filesystem::path& path);
+  // 解析 |data|，调用方保证它在 reader 使用期间有效。
+  bool Parse(const uint8_t* data, size_t size);
+  void Close();
+
+  bool valid() const { return valid_; }
+  uint32_t schema() const { return schema_; }
+  int64_t saved_unix_ms() const { return saved_unix_ms_; }
+  const std::vector<Section>& sections() const { return sections_; }
+  // 没有时返回 nullptr。
+  const Section* Find(std::string_view name) const;
+
+ private:
+  MappedFile file_;
+  bool valid_ = false;
+  uint32_t schema_ = 0;
+  int64_t saved_unix_ms_ = 0;
+  std::vector<Section> sections_;
+};
+
+#endif  // RUNNER_STARTUP_SNAPSHOT_H_
@@ -0,0 +1,117 @@
+#include "startup_snapshot_channel.h"
+
+#include <flutter/standard_method_codec.h>
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "method_channel_utils.h"
+#include "startup_trace.h"
+
+namespace {
+
+constexpr char kChannelName[] = "com.example.suxingchahui/startup_snapshot";
+
+int64_t NowUnixMillis() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+StartupSnapshotChannel::StartupSnapshotChannel(
+    flutter::BinaryMessenger* messenger,
+    std::filesystem::path path,
+    std::unique_ptr<StartupSnapshotReader> loaded)
+    : channel_(std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+          messenger, kChannelName,
+          &flutter::StandardMethodCodec::GetInstance())),
+      path_(std::move(path)),
+      loaded_(std::move(loaded)) {
+  channel_->SetMethodCallHandler(
+      [this](const auto& call, auto result) {
+        HandleMethodCall(call, std::move(result));
+      });
+}
+
+void StartupSnapshotChannel::Save() {
+  if (!dirty_) {
+    return;
+  }
+  dirty_ = false;
+  ScopedTraceSpan span("StartupSnapshot::Save", "shutdown");
+  // 先解除映射，Windows 上才能替换原文件
+  loaded_ = nullptr;
+  pending_.Write(path_, schema_, NowUnixMillis());
+}
+
+void StartupSnapshotChannel::HandleMethodCall(
+    const flutter::MethodCall<flutter::EncodableValue>& call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  const std::string& method = call.method_name();
+
+  if (method == "load") {
+    if (!loaded_ || !loaded_->valid()) {
+      result->Success();
+      return;
+    }
+    flutter::EncodableMap sections;
+    for (const auto& section : loaded_->sections()) {
+      sections[flutter::EncodableValue(std::string(section.name))] =
+          flutter::EncodableValue(std::vector<uint8_t>(
+              section.data, section.data + section.size));
+    }
+    result->Success(flutter::EncodableValue(flutter::EncodableMap{
+        {flutter::EncodableValue("schema"),
+         flutter::EncodableValue(static_cast<int64_t>(loaded_->schema()))},
+        {flutter::EncodableValue("savedAt"),
+         flutter::EncodableValue(loaded_->saved_unix_ms())},
+        {flutter::EncodableValue("sections"),
+         flutter::EncodableValue(std::move(sections))},
+    }));
+    return;
+  }
+
+  if (method == "put") {
+    const auto schema = GetIntArgument(call.arguments(), "schema");
+    const auto name = GetStringArgument(call.arguments(), "name");
+    if (!schema || *schema < 0 || *schema > UINT32_MAX || !name) {
+      result->Error("bad_args", "Missing schema or section name");
+      return;
+    }
+    const auto* data_value = FindArgument(call.arguments(), "data");
+    const auto* data =
+        data_value ? std::get_if<std::vector<uint8_t>>(data_value) : nullptr;
+    if (data && data->size() > kMaxSectionSize) {
+      result->Error("too_large", "Snapshot section is too large");
+      return;
+    }
+    const uint32_t new_schema = static_cast<uint32_t>(*schema);
+    if (!dirty_ || new_schema != schema_) {
+      // 第一次更新或 schema 变了：只保留上次快照里 schema 相同的段
+      pending_ = StartupSnapshotWriter();
+      if (loaded_ && loaded_->valid() && loaded_->schema() == new_schema) {
+        for (const auto& section : loaded_->sections()) {
+          pending_.Put(std::string(section.name),
+                       std::vector<uint8_t>(section.data,
+                                            section.data + section.size));
+        }
+      }
+      schema_ = new_schema;
+    }
+    dirty_ = true;
+    if (!data) {
+      pending_.Remove(*name);
+    } else if (!pending_.Put(*name, *data)) {
+      result->Error("bad_args", "Invalid section name or too many sections");
+      return;
+    }
+    result->Success();
+    return;
+  }
+
+  result->NotImplemented();
+}
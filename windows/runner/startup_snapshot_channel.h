@@ -0,0 +1,53 @@
+#ifndef RUNNER_STARTUP_SNAPSHOT_CHANNEL_H_
+#define RUNNER_STARTUP_SNAPSHOT_CHANNEL_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+#include <flutter/method_channel.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+#include "startup_snapshot.h"
+
+// 把上次退出时的启动快照交给 Dart，退出时写出 Dart 更新过的段。
+//
+// 快照在引擎创建的同时由后台线程映射和校验（见 FlutterWindow::OnCreate），
+// Dart 在 main 里第一时间读取，首页第一帧就能显示上次的内容。
+//
+// 通道：com.example.suxingchahui/startup_snapshot
+//   load                      -> {schema, savedAt, sections: {name: bytes}}，
+//                                没有可用快照时为 null
+//   put {schema, name, data}  更新一段，data 为 null 时删除该段
+class StartupSnapshotChannel {
+ public:
+  // 单段的上限。
+  static constexpr size_t kMaxSectionSize = 4u << 20;
+
+  // |loaded| 可以为 nullptr 或无效。
+  StartupSnapshotChannel(flutter::BinaryMessenger* messenger,
+                         std::filesystem::path path,
+                         std::unique_ptr<StartupSnapshotReader> loaded);
+
+  StartupSnapshotChannel(const StartupSnapshotChannel&) = delete;
+  StartupSnapshotChannel& operator=(const StartupSnapshotChannel&) = delete;
+
+  // 本次运行有更新时写出快照。在窗口销毁时调用。
+  void Save();
+
+ private:
+  void HandleMethodCall(
+      const flutter::MethodCall<flutter::EncodableValue>& call,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> channel_;
+  const std::filesystem::path path_;
+  std::unique_ptr<StartupSnapshotReader> loaded_;
+  // 第一次 put 时从 |loaded_| 复制 schema 相同的段，之后只改这里。
+  StartupSnapshotWriter pending_;
+  uint32_t schema_ = 0;
+  bool dirty_ = false;
+};
+
+#endif  // RUNNER_STARTUP_SNAPSHOT_CHANNEL_H_
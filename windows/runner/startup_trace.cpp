@@ -0,0 +1,257 @@
+#include "startup_trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+std::atomic<uint64_t> next_instance_id{1};
+thread_local uint64_t tls_trace_owner = 0;
+thread_local void* tls_trace_buffer = nullptr;
+thread_local bool tls_watched_thread = false;
+
+// 输出 JSON 字符串字面量（含引号）。
+void WriteJsonString(std::ostream& out, const char* value) {
+  out << '"';
+  for (const char* p = value ? value : ""; *p; ++p) {
+    const unsigned char c = static_cast<unsigned char>(*p);
+    switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      case '\r':
+        out << "\\r";
+        break;
+      case '\t':
+        out << "\\t";
+        break;
+      default:
+        if (c < 0x20) {
+          char escaped[8];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          out << escaped;
+        } else {
+          out << static_cast<char>(c);
+        }
+    }
+  }
+  out << '"';
+}
+
+}  // namespace
+
+StartupTrace& StartupTrace::GetInstance() {
+  static StartupTrace instance;
+  return instance;
+}
+
+StartupTrace::StartupTrace(size_t events_per_thread)
+    : instance_id_(next_instance_id.fetch_add(1, std::memory_order_relaxed)),
+      events_per_thread_(std::max<size_t>(1, events_per_thread)) {}
+
+void StartupTrace::Enable(std::string output_path) {
+  std::lock_guard<std::mutex> lock(registry_mutex_);
+  if (enabled_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  output_path_ = std::move(output_path);
+  origin_us_ = NowMicros();
+  enabled_.store(true, std::memory_order_release);
+}
+
+int64_t StartupTrace::NowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void StartupTrace::AddSpan(const char* name,
+                           const char* category,
+                           int64_t begin_us,
+                           int64_t end_us) {
+  if (!enabled()) {
+    return;
+  }
+  Append({name, category, begin_us, std::max<int64_t>(0, end_us - begin_us),
+          'X'});
+}
+
+void StartupTrace::AddInstant(const char* name, const char* category) {
+  if (!enabled()) {
+    return;
+  }
+  Append({name, category, NowMicros(), 0, 'i'});
+}
+
+const char* StartupTrace::InternName(const std::string& name) {
+  std::lock_guard<std::mutex> lock(registry_mutex_);
+  return interned_names_.insert(name).first->c_str();
+}
+
+void StartupTrace::SetCurrentThreadName(const char* name) {
+  if (!enabled()) {
+    return;
+  }
+  GetThreadBuffer()->thread_name.store(name, std::memory_order_relaxed);
+}
+
+void StartupTrace::WatchCurrentThread() {
+  tls_watched_thread = true;
+}
+
+StartupTrace::ThreadBuffer* StartupTrace::GetThreadBuffer() {
+  if (tls_trace_owner == instance_id_) {
+    return static_cast<ThreadBuffer*>(tls_trace_buffer);
+  }
+  std::lock_guard<std::mutex> lock(registry_mutex_);
+  const std::thread::id self = std::this_thread::get_id();
+  ThreadBuffer* found = nullptr;
+  for (const auto& buffer : buffers_) {
+    if (buffer->owner == self) {
+      found = buffer.get();
+      break;
+    }
+  }
+  if (!found) {
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->slots = std::make_unique<Slot[]>(events_per_thread_);
+    buffer->owner = self;
+    buffer->thread_id = static_cast<uint32_t>(buffers_.size() + 1);
+    found = buffer.get();
+    buffers_.push_back(std::move(buffer));
+  }
+  tls_trace_owner = instance_id_;
+  tls_trace_buffer = found;
+  return found;
+}
+
+void StartupTrace::Append(const Event& event) {
+  ThreadBuffer* buffer = GetThreadBuffer();
+  // 单生产者：只有所属线程写入。先把序号置为奇数再改内容，写完后置为
+  // 偶数，读者据此识别正在改写的槽位
+  const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+  Slot& slot = buffer->slots[head % events_per_thread_];
+  slot.sequence.store(2 * head + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.name.store(event.name, std::memory_order_relaxed);
+  slot.category.store(event.category, std::memory_order_relaxed);
+  slot.begin_us.store(event.begin_us, std::memory_order_relaxed);
+  slot.duration_us.store(event.duration_us, std::memory_order_relaxed);
+  slot.phase.store(event.phase, std::memory_order_relaxed);
+  slot.sequence.store(2 * head + 2, std::memory_order_release);
+  buffer->head.store(head + 1, std::memory_order_release);
+}
+
+bool StartupTrace::ReadEvent(const ThreadBuffer& buffer,
+                             uint64_t index,
+                             Event* event) const {
+  const Slot& slot = buffer.slots[index % events_per_thread_];
+  const uint64_t expected = 2 * index + 2;
+  if (slot.sequence.load(std::memory_order_acquire) != expected) {
+    return false;
+  }
+  event->name = slot.name.load(std::memory_order_relaxed);
+  event->category = slot.category.load(std::memory_order_relaxed);
+  event->begin_us = slot.begin_us.load(std::memory_order_relaxed);
+  event->duration_us = slot.duration_us.load(std::memory_order_relaxed);
+  event->phase = slot.phase.load(std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slot.sequence.load(std::memory_order_relaxed) == expected;
+}
+
+bool StartupTrace::Flush() {
+  if (!enabled()) {
+    return true;
+  }
+  std::lock_guard<std::mutex> lock(registry_mutex_);
+  if (flushed_) {
+    return true;
+  }
+  flushed_ = true;
+
+  std::ofstream out(std::filesystem::u8path(output_path_),
+                    std::ios::out | std::ios::trunc);
+  if (!out) {
+    return false;
+  }
+
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  auto separator = [&out, &first]() {
+    if (!first) {
+      out << ",\n";
+    }
+    first = false;
+  };
+
+  for (const auto& buffer : buffers_) {
+    const char* thread_name =
+        buffer->thread_name.load(std::memory_order_relaxed);
+    if (thread_name) {
+      separator();
+      out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":"
+          << buffer->thread_id << ",\"args\":{\"name\":";
+      WriteJsonString(out, thread_name);
+      out << "}}";
+    }
+
+    // 其他线程可能仍在写入，只读取已经发布的部分；读取期间被覆盖的槽位
+    // 直接跳过，回绕时可能丢失最早的事件
+    const uint64_t head = buffer->head.load(std::memory_order_acquire);
+    const uint64_t count = std::min<uint64_t>(head, events_per_thread_);
+    for (uint64_t i = head - count; i < head; ++i) {
+      Event event;
+      if (!ReadEvent(*buffer, i, &event)) {
+        continue;
+      }
+      separator();
+      out << "{\"ph\":\"" << event.phase << "\",\"name\":";
+      WriteJsonString(out, event.name);
+      out << ",\"cat\":";
+      WriteJsonString(out, event.category);
+      out << ",\"pid\":1,\"tid\":" << buffer->thread_id
+          << ",\"ts\":" << (event.begin_us - origin_us_);
+      if (event.phase == 'X') {
+        out << ",\"dur\":" << event.duration_us;
+      } else {
+        out << ",\"s\":\"t\"";
+      }
+      out << "}";
+    }
+  }
+  out << "]}\n";
+  return static_cast<bool>(out);
+}
+
+ScopedTraceSpan::ScopedTraceSpan(const char* name, const char* category)
+    : name_(name),
+      category_(category),
+      begin_us_(StartupTrace::GetInstance().enabled()
+                    ? StartupTrace::NowMicros()
+                    : 0) {
+  if (tls_watched_thread) {
+    watched_ = true;
+    previous_span_ = StartupTrace::GetInstance().watched_span_.exchange(
+        name, std::memory_order_relaxed);
+  }
+}
+
+ScopedTraceSpan::~ScopedTraceSpan() {
+  StartupTrace& trace = StartupTrace::GetInstance();
+  if (watched_) {
+    // 回到外层的时间段，全部结束后为 nullptr
+    trace.watched_span_.store(previous_span_, std::memory_order_relaxed);
+  }
+  if (trace.enabled() && begin_us_ != 0) {
+    trace.AddSpan(name_, category_, begin_us_, StartupTrace::NowMicros());
+  }
+}
@@ -0,0 +1,150 @@
+#ifndef RUNNER_STARTUP_TRACE_H_
+#define RUNNER_STARTUP_TRACE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 启动阶段的时间线记录器（与平台无关）。
+//
+// 每个线程第一次记录时注册一个固定大小的环形缓冲区，之后写入只由该线程
+// 完成，不需要加锁；每个槽位带序号，Flush 与写入并发时跳过正在改写的
+// 槽位，不会输出半条事件。时间使用单调时钟（steady_clock，Windows 上即 QPC），
+// 退出时输出 Chrome trace-event JSON，可以直接拖进 chrome://tracing 或
+// Perfetto 查看。未启用时所有记录接口只做一次原子读取。
+class StartupTrace {
+ public:
+  // 每个线程环形缓冲区的事件数，超过后覆盖最早的事件
+  static constexpr size_t kEventsPerThread = 8192;
+
+  static StartupTrace& GetInstance();
+
+  // 进程内通常只用 GetInstance；单独构造的实例用于测试。
+  explicit StartupTrace(size_t events_per_thread = kEventsPerThread);
+
+  StartupTrace(const StartupTrace&) = delete;
+  StartupTrace& operator=(const StartupTrace&) = delete;
+
+  // 启用记录，|output_path| 为 UTF-8 编码的输出文件路径。
+  void Enable(std::string output_path);
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  // 单调时钟，微秒。
+  static int64_t NowMicros();
+
+  // 记录一个完整的时间段。|name| 和 |category| 必须是静态字符串，
+  // 动态名称请先通过 InternName 转换。
+  void AddSpan(const char* name, const char* category, int64_t begin_us,
+               int64_t end_us);
+
+  // 记录一个瞬时事件。
+  void AddInstant(const char* name, const char* category);
+
+  // 把动态字符串（例如 Dart 传来的名称）转换为进程内长期有效的指针。
+  const char* InternName(const std::string& name);
+
+  // 设置当前线程在时间线上显示的名称。
+  void SetCurrentThreadName(const char* name);
+
+  // 把当前线程设为被监视的线程（平台线程）。即使未启用记录，该线程上
+  // ScopedTraceSpan 的名称也会发布出来，HangWatchdog 据此报告卡顿时
+  // 所处的阶段。
+  void WatchCurrentThread();
+
+  // 被监视线程上最内层的、尚未结束的 ScopedTraceSpan，没有时为 nullptr。
+  // 可以在任意线程调用。
+  const char* watched_span() const {
+    return watched_span_.load(std::memory_order_relaxed);
+  }
+
+  // 写出 Chrome trace JSON。未启用或已写出时直接返回 true。其他线程可以
+  // 同时写入，输出只包含调用时已经写完的事件。
+  bool Flush();
+
+ private:
+  struct Event {
+    const char* name;
+    const char* category;
+    int64_t begin_us;
+    int64_t duration_us;
+    char phase;
+  };
+
+  // 环形缓冲区的一个槽位。第 n 个事件写入前 sequence 为 2n+1，写完后为
+  // 2n+2；读取前后序号一致且等于 2n+2 时内容完整。字段都是原子变量，
+  // 读写并发时没有数据竞争。
+  struct Slot {
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<const char*> category{nullptr};
+    std::atomic<int64_t> begin_us{0};
+    std::atomic<int64_t> duration_us{0};
+    std::atomic<char> phase{0};
+  };
+
+  struct ThreadBuffer {
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> head{0};
+    std::thread::id owner;
+    uint32_t thread_id = 0;
+    std::atomic<const char*> thread_name{nullptr};
+  };
+
+  friend class ScopedTraceSpan;  // 发布 watched_span_
+
+  ThreadBuffer* GetThreadBuffer();
+  void Append(const Event& event);
+  // 读取第 |index| 个事件，已被覆盖或正在写入时返回 false。
+  bool ReadEvent(const ThreadBuffer& buffer, uint64_t index,
+                 Event* event) const;
+
+  // 线程局部缓存按实例编号区分，避免不同实例共用同一个缓冲区；缓存未
+  // 命中时按线程找回已注册的缓冲区，在实例间切换不会重复注册
+  const uint64_t instance_id_;
+  const size_t events_per_thread_;
+  std::atomic<bool> enabled_{false};
+  std::atomic<const char*> watched_span_{nullptr};
+  int64_t origin_us_ = 0;
+  std::string output_path_;
+  bool flushed_ = false;
+
+  std::mutex registry_mutex_;
+  // 缓冲区在进程退出前不会释放，线程局部指针始终有效
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+  std::set<std::string> interned_names_;
+};
+
+// 作用域内的时间段，析构时记录。
+class ScopedTraceSpan {
+ public:
+  explicit ScopedTraceSpan(const char* name, const char* category = "native");
+  ~ScopedTraceSpan();
+
+  ScopedTraceSpan(const ScopedTraceSpan&) = delete;
+  ScopedTraceSpan& operator=(const ScopedTraceSpan&) = delete;
+
+ private:
+  const char* name_;
+  const char* category_;
+  int64_t begin_us_;
+  // 在被监视线程上构造时，外层时间段的名称，析构时恢复
+  bool watched_ = false;
+  const char* previous_span_ = nullptr;
+};
+
+// 作用域结束时写出时间线，放在 wWinMain 顶部以覆盖所有返回路径。
+class ScopedTraceFlush {
+ public:
+  ScopedTraceFlush() = default;
+  ~ScopedTraceFlush() { StartupTrace::GetInstance().Flush(); }
+
+  ScopedTraceFlush(const ScopedTraceFlush&) = delete;
+  ScopedTraceFlush& operator=(const ScopedTraceFlush&) = delete;
+};
+
+#endif  // RUNNER_STARTUP_TRACE_H_
@@ -0,0 +1,67 @@
+#include "startup_trace_channel.h"
+
+#include <flutter/standard_method_codec.h>
+
+#include "method_channel_utils.h"
+#include "startup_trace.h"
+
+namespace {
+
+constexpr char kChannelName[] = "com.example.suxingchahui/startup_trace";
+constexpr char kDartCategory[] = "dart";
+
+}  // namespace
+
+StartupTraceChannel::StartupTraceChannel(flutter::BinaryMessenger* messenger)
+    : channel_(std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+          messenger, kChannelName,
+          &flutter::StandardMethodCodec::GetInstance())) {
+  channel_->SetMethodCallHandler(
+      [this](const auto& call, auto result) {
+        HandleMethodCall(call, std::move(result));
+      });
+}
+
+void StartupTraceChannel::HandleMethodCall(
+    const flutter::MethodCall<flutter::EncodableValue>& call,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  StartupTrace& trace = StartupTrace::GetInstance();
+  const std::string& method = call.method_name();
+
+  if (method == "isEnabled") {
+    result->Success(flutter::EncodableValue(trace.enabled()));
+    return;
+  }
+
+  if (method == "addSpan" || method == "instant") {
+    const auto name = GetStringArgument(call.arguments(), "name");
+    if (!name) {
+      result->Error("bad_args", "Missing span name");
+      return;
+    }
+    if (!trace.enabled()) {
+      result->Success();
+      return;
+    }
+    const char* interned = trace.InternName(*name);
+    if (method == "instant") {
+      trace.AddInstant(interned, kDartCategory);
+    } else {
+      // Dart 的 Timeline.now 与 steady_clock 在 Windows 上都来自 QPC，
+      // 用 Dart 侧的结束时间，通道排队的延迟不会算进时间段。缺失或
+      // 晚于当前时刻的值退回到收到消息的时间
+      const int64_t now_us = StartupTrace::NowMicros();
+      const int64_t sent_end_us =
+          GetIntArgument(call.arguments(), "endMicros").value_or(0);
+      const int64_t end_us =
+          sent_end_us > 0 && sent_end_us <= now_us ? sent_end_us : now_us;
+      const int64_t duration_us =
+          GetIntArgument(call.arguments(), "durationMicros").value_or(0);
+      trace.AddSpan(interned, kDartCategory, end_us - duration_us, end_us);
+    }
+    result->Success();
+    return;
+  }
+
+  result->NotImplemented();
+}
@@ -0,0 +1,31 @@
+#ifndef RUNNER_STARTUP_TRACE_CHANNEL_H_
+#define RUNNER_STARTUP_TRACE_CHANNEL_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+#include <flutter/method_channel.h>
+
+#include <memory>
+
+// 让 Dart 把自己的启动阶段追加到 StartupTrace 时间线上。
+//
+// 通道：com.example.suxingchahui/startup_trace
+//   isEnabled                        -> bool
+//   addSpan {name, durationMicros}   以收到调用的时刻为结束时间
+//   instant {name}
+class StartupTraceChannel {
+ public:
+  explicit StartupTraceChannel(flutter::BinaryMessenger* messenger);
+
+  StartupTraceChannel(const StartupTraceChannel&) = delete;
+  StartupTraceChannel& operator=(const StartupTraceChannel&) = delete;
+
+ private:
+  void HandleMethodCall(
+      const flutter::MethodCall<flutter::EncodableValue>& call,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> channel_;
+};
+
+#endif  // RUNNER_STARTUP_TRACE_CHANNEL_H_
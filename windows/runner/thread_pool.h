@@ -0,0 +1,47 @@
+#ifndef RUNNER_THREAD_POOL_H_
+#define RUNNER_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 固定线程数的工作线程池，不依赖任何平台 API。
+// 析构时会执行完队列中剩余的任务并等待所有线程退出。
+class ThreadPool {
+ public:
+  // |thread_count| 为 0 时使用 std::thread::hardware_concurrency()。
+  explicit ThreadPool(size_t thread_count = 0);
+  ~ThreadPool();
+
+  // 禁止拷贝
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // 投递任务，任务会在任意一个工作线程上执行。
+  void Post(std::function<void()> task);
+
+  // 工作线程数量。
+  size_t size() const { return workers_.size(); }
+
+ private:
+  void WorkerLoop();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  std::vector<std::thread> workers_;
+  bool stopping_ = false;
+};
+
+// 在 |thread_count| 个线程上并行执行 body(0) ... body(count - 1)，全部完成后
+// 返回。|thread_count| 为 0 时使用 CPU 核数；只有一个任务或一个线程时直接
+// 在调用线程上执行。
+void ParallelFor(size_t count,
+                 size_t thread_count,
+                 const std::function<void(size_t index)>& body);
+
+#endif  // RUNNER_THREAD_POOL_H_
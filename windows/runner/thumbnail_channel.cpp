@@ -0,0 +1,127 @@
+#include "thumbnail_channel.h"
+
+#include <flutter/standard_method_codec.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "disk_cache_ffi.h"
+#include "method_channel_utils.h"
+#include "utils.h"
+#include "wic_image_codec.h"
+
+namespace {
+
+constexpr char kChannelName[] = "com.example.suxingchahui/thumbnail";
+constexpr char kCacheName[] = "thumbnails";
+constexpr uint64_t kCacheMaxBytes = 256ull << 20;
+constexpr uint32_t kCacheMaxEntries = 65536;
+// 变体由原图决定，原图更新时 URL 也会变，只靠 LRU 淘汰。
+constexpr int64_t kValidMillis = 30ll * 24 * 60 * 60 * 1000;
+
+using flutter::EncodableMap;
+using flutter::EncodableValue;
+
+EncodableValue EncodeThumbnail(PixelBuffer thumbnail) {
+  return EncodableValue(EncodableMap{
+      {EncodableValue("width"),
+       EncodableValue(static_cast<int64_t>(thumbnail.width))},
+      {EncodableValue("height"),
+       EncodableValue(static_cast<int64_t>(thumbnail.height))},
+      {EncodableValue("pixels"), EncodableValue(std::move(thumbnail.pixels))},
+  });
+}
+
+}  // namespace
+
+ThumbnailChannel::ThumbnailChannel(
+    flutter::BinaryMessenger* messenger,
+    std::shared_ptr<PlatformTaskRunner> task_runner)
+    : channel_(std::make_unique<flutter::MethodChannel<EncodableValue>>(
+          messenger, kChannelName,
+          &flutter::StandardMethodCodec::GetInstance())),
+      task_runner_(std::move(task_runner)) {
+  if (DiskCache* cache =
+          OpenNamedDiskCache(kCacheName, kCacheMaxBytes, kCacheMaxEntries)) {
+    store_ = std::make_shared<ThumbnailStore>(cache);
+  }
+  channel_->SetMethodCallHandler(
+      [this](const auto& call, auto result) {
+        HandleMethodCall(call, std::move(result));
+      });
+}
+
+void ThumbnailChannel::HandleMethodCall(
+    const flutter::MethodCall<EncodableValue>& call,
+    std::unique_ptr<flutter::MethodResult<EncodableValue>> result) {
+  if (call.method_name() == "load") {
+    HandleLoad(call.arguments(), std::move(result));
+    return;
+  }
+  result->NotImplemented();
+}
+
+void ThumbnailChannel::HandleLoad(
+    const EncodableValue* arguments,
+    std::unique_ptr<flutter::MethodResult<EncodableValue>> result) {
+  const auto key = GetStringArgument(arguments, "key");
+  const auto width = GetIntArgument(arguments, "width");
+  if (!key || !width || *width <= 0) {
+    result->Error("bad_args", "Missing key or width");
+    return;
+  }
+  if (!store_) {
+    result->Success();
+    return;
+  }
+  const uint32_t bucket = ThumbnailWidthFor(
+      static_cast<uint32_t>(std::min<int64_t>(*width, UINT32_MAX)));
+  std::wstring path;
+  if (const auto path_argument = GetStringArgument(arguments, "path")) {
+    path = Utf16FromUtf8(*path_argument);
+  }
+
+  // 回复切回平台线程，窗口已销毁时任务被丢弃。
+  std::shared_ptr<flutter::MethodResult<EncodableValue>> shared_result =
+      std::move(result);
+  std::weak_ptr<PlatformTaskRunner> weak_runner = task_runner_;
+  workers_.Post([store = store_, weak_runner, shared_result, key = *key,
+                 bucket, path = std::move(path)]() {
+    PixelBuffer thumbnail;
+    std::string error;
+    bool found = store->Get(key, bucket, &thumbnail);
+    bool ok = true;
+    if (!found && !path.empty()) {
+      ScopedComInitializer com;
+      PixelBuffer source;
+      ok = com.succeeded() &&
+           DecodeImageFileForWidth(path, bucket, &source, nullptr, &error) &&
+           MakeThumbnail(source, bucket, &thumbnail);
+      if (ok) {
+        store->Put(key, bucket, thumbnail,
+                   DiskCache::NowMillis() + kValidMillis);
+        found = true;
+      } else if (error.empty()) {
+        error = "Failed to create thumbnail";
+      }
+    }
+
+    auto runner = weak_runner.lock();
+    if (!runner) {
+      return;
+    }
+    runner->PostTask([shared_result, ok, found,
+                      thumbnail = std::move(thumbnail),
+                      error = std::move(error)]() mutable {
+      if (!ok) {
+        shared_result->Error("decode_failed", error);
+      } else if (found) {
+        shared_result->Success(EncodeThumbnail(std::move(thumbnail)));
+      } else {
+        shared_result->Success();
+      }
+    });
+  });
+}
@@ -0,0 +1,48 @@
+#ifndef RUNNER_THUMBNAIL_CHANNEL_H_
+#define RUNNER_THUMBNAIL_CHANNEL_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+#include <flutter/method_channel.h>
+
+#include <memory>
+
+#include "platform_task_runner.h"
+#include "thread_pool.h"
+#include "thumbnail_store.h"
+
+// 列表和网格封面的缩略图服务，见 thumbnail_store.h。
+//
+// 通道：com.example.suxingchahui/thumbnail
+//   load {key, width, path?}
+//       -> {width, height, pixels: Uint8List} | null
+//       width 为显示宽度（物理像素），按档位向上取整。先查缩略图缓存；
+//       未命中且传了 path（原图文件）时在后台解码、缩小并写入缓存，
+//       未命中也没有 path 时返回 null，由 Dart 下载原图后再调用一次。
+//       pixels 为非预乘的 BGRA 像素（PixelFormat.bgra8888）。
+class ThumbnailChannel {
+ public:
+  ThumbnailChannel(flutter::BinaryMessenger* messenger,
+                   std::shared_ptr<PlatformTaskRunner> task_runner);
+
+  ThumbnailChannel(const ThumbnailChannel&) = delete;
+  ThumbnailChannel& operator=(const ThumbnailChannel&) = delete;
+
+ private:
+  void HandleMethodCall(
+      const flutter::MethodCall<flutter::EncodableValue>& call,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  void HandleLoad(
+      const flutter::EncodableValue* arguments,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> channel_;
+  std::shared_ptr<PlatformTaskRunner> task_runner_;
+  // 缓存打开失败时为 nullptr，此时 load 只会返回 null。
+  std::shared_ptr<ThumbnailStore> store_;
+  // 命中缓存也要读文件，同样放到后台；几张封面可以同时解码。
+  ThreadPool workers_{3};
+};
+
+#endif  // RUNNER_THUMBNAIL_CHANNEL_H_
@@ -0,0 +1,121 @@
+#include "thumbnail_store.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "mapped_file.h"
+
+namespace {
+
+// 变体文件：16 字节头（magic、版本、宽、高，均为小端 uint32），之后是
+// 紧密排列的 BGRA 像素。
+constexpr uint32_t kMagic = 0x48545853;  // "SXTH"
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderSize = 16;
+constexpr uint32_t kMaxAspect = 4;
+
+void WriteU32(uint8_t* out, uint32_t value) {
+  std::memcpy(out, &value, sizeof(value));
+}
+
+uint32_t ReadU32(const uint8_t* in) {
+  uint32_t value = 0;
+  std::memcpy(&value, in, sizeof(value));
+  return value;
+}
+
+}  // namespace
+
+uint32_t ThumbnailWidthFor(uint32_t physical_width) {
+  for (uint32_t width : kThumbnailWidths) {
+    if (width >= physical_width) {
+      return width;
+    }
+  }
+  return std::end(kThumbnailWidths)[-1];
+}
+
+bool MakeThumbnail(const PixelBuffer& source,
+                   uint32_t width,
+                   PixelBuffer* thumbnail) {
+  if (source.empty() || width == 0) {
+    return false;
+  }
+  width = std::min(width, source.width);
+  const double scale = static_cast<double>(width) / source.width;
+  const uint32_t max_height = width * kMaxAspect;
+  // 卡片按 BoxFit.cover 显示，超长图本来也只露出一部分
+  const double source_height =
+      std::min<double>(source.height, max_height / scale);
+  const auto height = static_cast<uint32_t>(
+      std::clamp(std::round(source_height * scale), 1.0,
+                 static_cast<double>(max_height)));
+
+  if (width == source.width && height == source.height) {
+    *thumbnail = source;
+  } else {
+    const SourceRect rect{0, 0, static_cast<double>(source.width),
+                          source_height};
+    if (!ResampleRegion(source, rect, width, height, thumbnail)) {
+      return false;
+    }
+  }
+  UnpremultiplyAlpha(thumbnail);
+  return true;
+}
+
+bool ThumbnailStore::Get(std::string_view key,
+                         uint32_t width,
+                         PixelBuffer* thumbnail) {
+  DiskCache::Entry entry;
+  if (!cache_->Lookup(VariantKey(key, width), &entry)) {
+    return false;
+  }
+  MappedFile file;
+  if (!file.Open(entry.path) || file.size() < kHeaderSize) {
+    cache_->Remove(VariantKey(key, width));
+    return false;
+  }
+  const uint8_t* data = file.data();
+  const uint32_t stored_width = ReadU32(data + 8);
+  const uint32_t stored_height = ReadU32(data + 12);
+  const uint64_t pixel_bytes =
+      static_cast<uint64_t>(stored_width) * stored_height * 4;
+  if (ReadU32(data) != kMagic || ReadU32(data + 4) != kVersion ||
+      stored_width == 0 || stored_height == 0 ||
+      file.size() != kHeaderSize + pixel_bytes) {
+    cache_->Remove(VariantKey(key, width));
+    return false;
+  }
+  thumbnail->Allocate(stored_width, stored_height);
+  std::memcpy(thumbnail->pixels.data(), data + kHeaderSize,
+              thumbnail->pixels.size());
+  return true;
+}
+
+bool ThumbnailStore::Put(std::string_view key,
+                         uint32_t width,
+                         const PixelBuffer& thumbnail,
+                         int64_t valid_till_ms) {
+  if (thumbnail.empty()) {
+    return false;
+  }
+  std::vector<uint8_t> data(kHeaderSize + thumbnail.pixels.size());
+  WriteU32(data.data(), kMagic);
+  WriteU32(data.data() + 4, kVersion);
+  WriteU32(data.data() + 8, thumbnail.width);
+  WriteU32(data.data() + 12, thumbnail.height);
+  std::memcpy(data.data() + kHeaderSize, thumbnail.pixels.data(),
+              thumbnail.pixels.size());
+  return cache_->Put(VariantKey(key, width), data.data(), data.size(),
+                     valid_till_ms);
+}
+
+std::string ThumbnailStore::VariantKey(std::string_view key, uint32_t width) {
+  std::string variant(key);
+  variant += "#w";
+  variant += std::to_string(width);
+  return variant;
+}
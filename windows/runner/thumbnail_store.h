@@ -0,0 +1,50 @@
+#ifndef RUNNER_THUMBNAIL_STORE_H_
+#define RUNNER_THUMBNAIL_STORE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "disk_cache.h"
+#include "image_ops.h"
+
+// 列表和网格里显示的缩略图（与平台无关）。
+//
+// 原图第一次被列表请求时按显示宽度缩小到少数几档固定宽度之一，每档单独
+// 存进磁盘缓存。缓存的是非预乘 BGRA 像素，Dart 直接用 ImageDescriptor.raw
+// 生成图片，滚动时既不解码也不缩放，内存里也只有显示尺寸的位图。
+
+// 缩略图宽度档位（物理像素），从小到大。档位少一些，同一张图在不同卡片
+// 尺寸、不同缩放比例下能共用同一个变体。
+constexpr uint32_t kThumbnailWidths[] = {96, 160, 240, 320, 480, 640, 960};
+
+// 返回不小于 |physical_width| 的最小档位，超过最大档位时返回最大档位。
+uint32_t ThumbnailWidthFor(uint32_t physical_width);
+
+// 把 |source|（预乘 BGRA）缩小到宽 |width|、高度按比例，并转为非预乘。
+// 原图比 |width| 窄时保持原尺寸。超长的图高度最多为宽度的 4 倍（取顶部）。
+bool MakeThumbnail(const PixelBuffer& source,
+                   uint32_t width,
+                   PixelBuffer* thumbnail);
+
+// 以 DiskCache 为存储的缩略图变体。线程安全性与 DiskCache 相同。
+class ThumbnailStore {
+ public:
+  explicit ThumbnailStore(DiskCache* cache) : cache_(cache) {}
+
+  // 读取 |key| 的 |width| 档变体。未命中或文件损坏时返回 false。
+  bool Get(std::string_view key, uint32_t width, PixelBuffer* thumbnail);
+
+  bool Put(std::string_view key,
+           uint32_t width,
+           const PixelBuffer& thumbnail,
+           int64_t valid_till_ms);
+
+ private:
+  static std::string VariantKey(std::string_view key, uint32_t width);
+
+  DiskCache* cache_;
+};
+
+#endif  // RUNNER_THUMBNAIL_STORE_H_
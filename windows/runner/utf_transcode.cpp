@@ -0,0 +1,510 @@
+#include "utf_transcode.h"
+
+#include <cstdint>
+
+#include "cpu_features.h"
+
+#if RUNNER_ARCH_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+inline bool IsHighSurrogate(char16_t unit) {
+  return unit >= 0xD800 && unit <= 0xDBFF;
+}
+
+inline bool IsLowSurrogate(char16_t unit) {
+  return unit >= 0xDC00 && unit <= 0xDFFF;
+}
+
+// 编码 |*input| 处的一个字符并前移两个指针。输入无效时返回 false。
+inline bool EncodeOne(const char16_t** input,
+                      const char16_t* end,
+                      char** output) {
+  const char16_t* in = *input;
+  char* out = *output;
+  const uint32_t unit = *in++;
+  if (unit < 0x80) {
+    *out++ = static_cast<char>(unit);
+  } else if (unit < 0x800) {
+    *out++ = static_cast<char>(0xC0 | (unit >> 6));
+    *out++ = static_cast<char>(0x80 | (unit & 0x3F));
+  } else if (IsHighSurrogate(static_cast<char16_t>(unit))) {
+    if (in == end || !IsLowSurrogate(*in)) {
+      return false;
+    }
+    const uint32_t low = *in++;
+    const uint32_t code_point = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+    *out++ = static_cast<char>(0xF0 | (code_point >> 18));
+    *out++ = static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+    *out++ = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    *out++ = static_cast<char>(0x80 | (code_point & 0x3F));
+  } else if (IsLowSurrogate(static_cast<char16_t>(unit))) {
+    return false;
+  } else {
+    *out++ = static_cast<char>(0xE0 | (unit >> 12));
+    *out++ = static_cast<char>(0x80 | ((unit >> 6) & 0x3F));
+    *out++ = static_cast<char>(0x80 | (unit & 0x3F));
+  }
+  *input = in;
+  *output = out;
+  return true;
+}
+
+inline bool IsContinuation(uint8_t byte) {
+  return (byte & 0xC0) == 0x80;
+}
+
+// 解码 |*input| 处的一个字符并前移两个指针。拒绝过长编码、代理项区间
+// 和大于 U+10FFFF 的码点。
+inline bool DecodeOne(const uint8_t** input,
+                      const uint8_t* end,
+                      char16_t** output) {
+  const uint8_t* in = *input;
+  const size_t available = static_cast<size_t>(end - in);
+  const uint32_t lead = in[0];
+  uint32_t code_point;
+  size_t length;
+  if (lead < 0x80) {
+    code_point = lead;
+    length = 1;
+  } else if (lead < 0xC2) {
+    return false;
+  } else if (lead < 0xE0) {
+    if (available < 2 || !IsContinuation(in[1])) {
+      return false;
+    }
+    code_point = ((lead & 0x1F) << 6) | (in[1] & 0x3F);
+    length = 2;
+  } else if (lead < 0xF0) {
+    if (available < 3 || !IsContinuation(in[1]) || !IsContinuation(in[2]) ||
+        (lead == 0xE0 && in[1] < 0xA0) || (lead == 0xED && in[1] >= 0xA0)) {
+      return false;
+    }
+    code_point =
+        ((lead & 0x0F) << 12) | ((in[1] & 0x3F) << 6) | (in[2] & 0x3F);
+    length = 3;
+  } else if (lead < 0xF5) {
+    if (available < 4 || !IsContinuation(in[1]) || !IsContinuation(in[2]) ||
+        !IsContinuation(in[3]) || (lead == 0xF0 && in[1] < 0x90) ||
+        (lead == 0xF4 && in[1] >= 0x90)) {
+      return false;
+    }
+    code_point = ((lead & 0x07) << 18) | ((in[1] & 0x3F) << 12) |
+                 ((in[2] & 0x3F) << 6) | (in[3] & 0x3F);
+    length = 4;
+  } else {
+    return false;
+  }
+
+  char16_t* out = *output;
+  if (code_point < 0x10000) {
+    *out++ = static_cast<char16_t>(code_point);
+  } else {
+    code_point -= 0x10000;
+    *out++ = static_cast<char16_t>(0xD800 + (code_point >> 10));
+    *out++ = static_cast<char16_t>(0xDC00 + (code_point & 0x3FF));
+  }
+  *input = in + length;
+  *output = out;
+  return true;
+}
+
+// 逐字符处理 [*input, *input + count)，代理对跨过边界时会多处理一个码元
+inline bool EncodeRun(const char16_t** input,
+                      const char16_t* end,
+                      size_t count,
+                      char** output) {
+  const char16_t* run_end = *input + count;
+  while (*input < run_end) {
+    if (!EncodeOne(input, end, output)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+inline bool DecodeRun(const uint8_t** input,
+                      const uint8_t* end,
+                      size_t count,
+                      char16_t** output) {
+  const uint8_t* run_end = *input + count;
+  while (*input < run_end) {
+    if (!DecodeOne(input, end, output)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 块处理器约定：Encode/Decode 能处理开头的至少一部分时前移指针并返回
+// true，否则不修改指针，由调用方逐字符处理一个块长度。
+template <typename Block>
+inline bool Utf16ToUtf8Loop(const char16_t* input,
+                            size_t length,
+                            char* output,
+                            size_t* output_length) {
+  const char16_t* const end = input + length;
+  char* out = output;
+  while (static_cast<size_t>(end - input) >= Block::kUnits) {
+    if (!Block::Encode(&input, &out) &&
+        !EncodeRun(&input, end, Block::kUnits, &out)) {
+      return false;
+    }
+  }
+  while (input < end) {
+    if (!EncodeOne(&input, end, &out)) {
+      return false;
+    }
+  }
+  *output_length = static_cast<size_t>(out - output);
+  return true;
+}
+
+template <typename Block>
+inline bool Utf8ToUtf16Loop(const char* input,
+                            size_t length,
+                            char16_t* output,
+                            size_t* output_length) {
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(input);
+  const uint8_t* const end = in + length;
+  char16_t* out = output;
+  while (static_cast<size_t>(end - in) >= Block::kBytes) {
+    if (!Block::Decode(&in, &out) &&
+        !DecodeRun(&in, end, Block::kBytes, &out)) {
+      return false;
+    }
+  }
+  while (in < end) {
+    if (!DecodeOne(&in, end, &out)) {
+      return false;
+    }
+  }
+  *output_length = static_cast<size_t>(out - output);
+  return true;
+}
+
+struct ScalarBlock {
+  static constexpr size_t kUnits = 1;
+  static constexpr size_t kBytes = 1;
+  static bool Encode(const char16_t**, char**) { return false; }
+  static bool Decode(const uint8_t**, char16_t**) { return false; }
+};
+
+bool ConvertUtf16ToUtf8Scalar(const char16_t* input,
+                              size_t length,
+                              char* output,
+                              size_t* output_length) {
+  return Utf16ToUtf8Loop<ScalarBlock>(input, length, output, output_length);
+}
+
+bool ConvertUtf8ToUtf16Scalar(const char* input,
+                              size_t length,
+                              char16_t* output,
+                              size_t* output_length) {
+  return Utf8ToUtf16Loop<ScalarBlock>(input, length, output, output_length);
+}
+
+#if RUNNER_ARCH_X86
+// 三字节编码的交错表：前 16 字节从 [b0 x8, b1 x8] 和 [b2 x8] 中各取一部分，
+// 后 8 字节同理。-1 表示该位置由另一个表填充。
+alignas(16) constexpr int8_t kThreeByteShuffle[4][16] = {
+    {0, 8, -1, 1, 9, -1, 2, 10, -1, 3, 11, -1, 4, 12, -1, 5},
+    {-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1},
+    {13, -1, 6, 14, -1, 7, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+    {-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, -1, -1, -1, -1, -1, -1},
+};
+
+inline __m128i LoadShuffle(const int8_t* table) {
+  return _mm_load_si128(reinterpret_cast<const __m128i*>(table));
+}
+
+// 8 个 U+0800..U+FFFF（不含代理项）的码元，每个编码为 3 字节，共 24 字节。
+// 先算出三组字节并打包，再用 pshufb 交错成 [b0 b1 b2] 的顺序。
+RUNNER_TARGET_ATTRIBUTE("ssse3")
+inline bool TryEncodeThreeByteBlock(__m128i units, char* out) {
+  const __m128i top = _mm_and_si128(units, _mm_set1_epi16(-2048));  // 0xF800
+  const __m128i not_three_byte =
+      _mm_or_si128(_mm_cmpeq_epi16(top, _mm_setzero_si128()),
+                   _mm_cmpeq_epi16(top, _mm_set1_epi16(-10240)));  // 0xD800
+  if (_mm_movemask_epi8(not_three_byte) != 0) {
+    return false;
+  }
+  const __m128i low_bits = _mm_set1_epi16(0x3F);
+  const __m128i continuation = _mm_set1_epi16(0x80);
+  const __m128i byte0 =
+      _mm_or_si128(_mm_srli_epi16(units, 12), _mm_set1_epi16(0xE0));
+  const __m128i byte1 = _mm_or_si128(
+      _mm_and_si128(_mm_srli_epi16(units, 6), low_bits), continuation);
+  const __m128i byte2 =
+      _mm_or_si128(_mm_and_si128(units, low_bits), continuation);
+  const __m128i first = _mm_packus_epi16(byte0, byte1);   // b0 x8, b1 x8
+  const __m128i second = _mm_packus_epi16(byte2, byte2);  // b2 x8
+
+  const __m128i lo = _mm_or_si128(
+      _mm_shuffle_epi8(first, LoadShuffle(kThreeByteShuffle[0])),
+      _mm_shuffle_epi8(second, LoadShuffle(kThreeByteShuffle[1])));
+  const __m128i hi = _mm_or_si128(
+      _mm_shuffle_epi8(first, LoadShuffle(kThreeByteShuffle[2])),
+      _mm_shuffle_epi8(second, LoadShuffle(kThreeByteShuffle[3])));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out), lo);
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 16), hi);
+  return true;
+}
+
+struct Ssse3Block {
+  static constexpr size_t kUnits = 8;
+  static constexpr size_t kBytes = 16;
+
+  RUNNER_TARGET_ATTRIBUTE("ssse3")
+  static bool Encode(const char16_t** input, char** output) {
+    const __m128i units =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(*input));
+    const __m128i non_ascii = _mm_and_si128(units, _mm_set1_epi16(-128));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(non_ascii, _mm_setzero_si128())) ==
+        0xFFFF) {
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(*output),
+                       _mm_packus_epi16(units, units));
+      *input += 8;
+      *output += 8;
+      return true;
+    }
+    if (TryEncodeThreeByteBlock(units, *output)) {
+      *input += 8;
+      *output += 24;
+      return true;
+    }
+    return false;
+  }
+
+  RUNNER_TARGET_ATTRIBUTE("ssse3")
+  static bool Decode(const uint8_t** input, char16_t** output) {
+    const __m128i bytes =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(*input));
+    if (_mm_movemask_epi8(bytes) != 0) {
+      return false;
+    }
+    const __m128i zero = _mm_setzero_si128();
+    __m128i* out = reinterpret_cast<__m128i*>(*output);
+    _mm_storeu_si128(out, _mm_unpacklo_epi8(bytes, zero));
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi8(bytes, zero));
+    *input += 16;
+    *output += 16;
+    return true;
+  }
+};
+
+RUNNER_TARGET_ATTRIBUTE("avx2")
+inline __m256i LoadShuffle256(const int8_t* table) {
+  return _mm256_broadcastsi128_si256(LoadShuffle(table));
+}
+
+struct Avx2Block {
+  static constexpr size_t kUnits = 16;
+  static constexpr size_t kBytes = 32;
+
+  RUNNER_TARGET_ATTRIBUTE("avx2")
+  static bool Encode(const char16_t** input, char** output) {
+    const __m256i units =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(*input));
+    const __m256i non_ascii =
+        _mm256_and_si256(units, _mm256_set1_epi16(-128));
+    if (_mm256_testz_si256(non_ascii, non_ascii)) {
+      // packus 按 128 位通道打包，再把两个通道的低 64 位拼到一起
+      const __m256i packed = _mm256_permute4x64_epi64(
+          _mm256_packus_epi16(units, units), 0x08);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(*output),
+                       _mm256_castsi256_si128(packed));
+      *input += 16;
+      *output += 16;
+      return true;
+    }
+    // 两个 128 位通道各自按三字节编码 8 个码元，pshufb 不跨通道，
+    // 所以与 SSSE3 版本共用交错表
+    const __m256i top = _mm256_and_si256(units, _mm256_set1_epi16(-2048));
+    const __m256i not_three_byte =
+        _mm256_or_si256(_mm256_cmpeq_epi16(top, _mm256_setzero_si256()),
+                        _mm256_cmpeq_epi16(top, _mm256_set1_epi16(-10240)));
+    if (!_mm256_testz_si256(not_three_byte, not_three_byte)) {
+      // 混排文本按 8 个码元一组再试一次
+      return Ssse3Block::Encode(input, output);
+    }
+    const __m256i low_bits = _mm256_set1_epi16(0x3F);
+    const __m256i continuation = _mm256_set1_epi16(0x80);
+    const __m256i byte0 =
+        _mm256_or_si256(_mm256_srli_epi16(units, 12), _mm256_set1_epi16(0xE0));
+    const __m256i byte1 = _mm256_or_si256(
+        _mm256_and_si256(_mm256_srli_epi16(units, 6), low_bits), continuation);
+    const __m256i byte2 =
+        _mm256_or_si256(_mm256_and_si256(units, low_bits), continuation);
+    const __m256i first = _mm256_packus_epi16(byte0, byte1);
+    const __m256i second = _mm256_packus_epi16(byte2, byte2);
+    const __m256i lo = _mm256_or_si256(
+        _mm256_shuffle_epi8(first, LoadShuffle256(kThreeByteShuffle[0])),
+        _mm256_shuffle_epi8(second, LoadShuffle256(kThreeByteShuffle[1])));
+    const __m256i hi = _mm256_or_si256(
+        _mm256_shuffle_epi8(first, LoadShuffle256(kThreeByteShuffle[2])),
+        _mm256_shuffle_epi8(second, LoadShuffle256(kThreeByteShuffle[3])));
+    char* out = *output;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                     _mm256_castsi256_si128(lo));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 16),
+                     _mm256_castsi256_si128(hi));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 24),
+                     _mm256_extracti128_si256(lo, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 40),
+                     _mm256_extracti128_si256(hi, 1));
+    *input += 16;
+    *output += 48;
+    return true;
+  }
+
+  RUNNER_TARGET_ATTRIBUTE("avx2")
+  static bool Decode(const uint8_t** input, char16_t** output) {
+    const __m256i bytes =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(*input));
+    if (_mm256_movemask_epi8(bytes) != 0) {
+      return false;
+    }
+    __m256i* out = reinterpret_cast<__m256i*>(*output);
+    _mm256_storeu_si256(
+        out, _mm256_cvtepu8_epi16(_mm256_castsi256_si128(bytes)));
+    _mm256_storeu_si256(
+        out + 1, _mm256_cvtepu8_epi16(_mm256_extracti128_si256(bytes, 1)));
+    *input += 32;
+    *output += 32;
+    return true;
+  }
+};
+
+RUNNER_TARGET_ATTRIBUTE("ssse3")
+bool ConvertUtf16ToUtf8Ssse3(const char16_t* input,
+                             size_t length,
+                             char* output,
+                             size_t* output_length) {
+  return Utf16ToUtf8Loop<Ssse3Block>(input, length, output, output_length);
+}
+
+RUNNER_TARGET_ATTRIBUTE("ssse3")
+bool ConvertUtf8ToUtf16Ssse3(const char* input,
+                             size_t length,
+                             char16_t* output,
+                             size_t* output_length) {
+  return Utf8ToUtf16Loop<Ssse3Block>(input, length, output, output_length);
+}
+
+RUNNER_TARGET_ATTRIBUTE("avx2")
+bool ConvertUtf16ToUtf8Avx2(const char16_t* input,
+                            size_t length,
+                            char* output,
+                            size_t* output_length) {
+  return Utf16ToUtf8Loop<Avx2Block>(input, length, output, output_length);
+}
+
+RUNNER_TARGET_ATTRIBUTE("avx2")
+bool ConvertUtf8ToUtf16Avx2(const char* input,
+                            size_t length,
+                            char16_t* output,
+                            size_t* output_length) {
+  return Utf8ToUtf16Loop<Avx2Block>(input, length, output, output_length);
+}
+#endif
+
+using Utf16ToUtf8Function = bool (*)(const char16_t*, size_t, char*, size_t*);
+using Utf8ToUtf16Function = bool (*)(const char*, size_t, char16_t*, size_t*);
+
+Utf16ToUtf8Function SelectUtf16ToUtf8() {
+#if RUNNER_ARCH_X86
+  const CpuFeatures& features = GetCpuFeatures();
+  if (features.avx2) {
+    return ConvertUtf16ToUtf8Avx2;
+  }
+  if (features.ssse3) {
+    return ConvertUtf16ToUtf8Ssse3;
+  }
+#endif
+  return ConvertUtf16ToUtf8Scalar;
+}
+
+Utf8ToUtf16Function SelectUtf8ToUtf16() {
+#if RUNNER_ARCH_X86
+  const CpuFeatures& features = GetCpuFeatures();
+  if (features.avx2) {
+    return ConvertUtf8ToUtf16Avx2;
+  }
+  if (features.ssse3) {
+    return ConvertUtf8ToUtf16Ssse3;
+  }
+#endif
+  return ConvertUtf8ToUtf16Scalar;
+}
+
+}  // namespace
+
+bool ConvertUtf16ToUtf8(const char16_t* input,
+                        size_t length,
+                        char* output,
+                        size_t* output_length) {
+  static const Utf16ToUtf8Function convert = SelectUtf16ToUtf8();
+  return convert(input, length, output, output_length);
+}
+
+bool ConvertUtf8ToUtf16(const char* input,
+                        size_t length,
+                        char16_t* output,
+                        size_t* output_length) {
+  static const Utf8ToUtf16Function convert = SelectUtf8ToUtf16();
+  return convert(input, length, output, output_length);
+}
+
+bool Utf16ToUtf8(std::u16string_view input, std::string* output) {
+  output->resize(MaxUtf8LengthForUtf16(input.size()));
+  size_t length = 0;
+  if (!ConvertUtf16ToUtf8(input.data(), input.size(), output->data(),
+                          &length)) {
+    output->clear();
+    return false;
+  }
+  output->resize(length);
+  return true;
+}
+
+bool Utf8ToUtf16(std::string_view input, std::u16string* output) {
+  output->resize(MaxUtf16LengthForUtf8(input.size()));
+  size_t length = 0;
+  if (!ConvertUtf8ToUtf16(input.data(), input.size(), output->data(),
+                          &length)) {
+    output->clear();
+    return false;
+  }
+  output->resize(length);
+  return true;
+}
+
+bool Utf16ToUtf8Batch(const std::u16string_view* strings,
+                      size_t count,
+                      Utf8Batch* batch) {
+  size_t capacity = 0;
+  for (size_t i = 0; i < count; ++i) {
+    capacity += MaxUtf8LengthForUtf16(strings[i].size());
+  }
+  batch->buffer.resize(capacity);
+  batch->offsets.assign(1, 0);
+  batch->offsets.reserve(count + 1);
+
+  bool all_valid = true;
+  size_t position = 0;
+  for (size_t i = 0; i < count; ++i) {
+    size_t length = 0;
+    if (ConvertUtf16ToUtf8(strings[i].data(), strings[i].size(),
+                           batch->buffer.data() + position, &length)) {
+      position += length;
+    } else {
+      all_valid = false;
+    }
+    batch->offsets.push_back(position);
+  }
+  batch->buffer.resize(position);
+  return all_valid;
+}
@@ -0,0 +1,53 @@
+#ifndef RUNNER_UTF_TRANSCODE_H_
+#define RUNNER_UTF_TRANSCODE_H_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// UTF-16 与 UTF-8 互转（与平台无关）。
+//
+// 单遍转换：按最坏情况分配输出，一边校验一边写入，不需要先算长度。
+// x86 上按 CPU 选择 SSE2/SSSE3/AVX2 实现：纯 ASCII 块和全部为三字节字符
+// （中日韩文字所在的区间）的块整块处理，其余部分逐字符处理，结果与标量
+// 实现一致。未配对的代理项、过长编码、超出范围的码点都视为无效输入。
+
+// 输出缓冲区的最大长度：一个 UTF-16 码元最多对应 3 个 UTF-8 字节
+// （代理对为 2 个码元对应 4 个字节），一个 UTF-8 字节最多对应一个码元。
+constexpr size_t MaxUtf8LengthForUtf16(size_t length) { return length * 3; }
+constexpr size_t MaxUtf16LengthForUtf8(size_t length) { return length; }
+
+// |output| 至少要有 MaxUtf*LengthFor*(length) 的空间。
+// 输入无效时返回 false，|output| 中的内容不确定。
+bool ConvertUtf16ToUtf8(const char16_t* input,
+                        size_t length,
+                        char* output,
+                        size_t* output_length);
+bool ConvertUtf8ToUtf16(const char* input,
+                        size_t length,
+                        char16_t* output,
+                        size_t* output_length);
+
+bool Utf16ToUtf8(std::u16string_view input, std::string* output);
+bool Utf8ToUtf16(std::string_view input, std::u16string* output);
+
+// 多个字符串转换到同一块连续缓冲区，第 i 个字符串为
+// buffer[offsets[i], offsets[i + 1])。
+struct Utf8Batch {
+  std::string buffer;
+  std::vector<size_t> offsets;
+
+  size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+  std::string_view operator[](size_t index) const {
+    return std::string_view(buffer.data() + offsets[index],
+                            offsets[index + 1] - offsets[index]);
+  }
+};
+
+// 无效的字符串在结果中为空串。全部有效时返回 true。
+bool Utf16ToUtf8Batch(const std::u16string_view* strings,
+                      size_t count,
+                      Utf8Batch* batch);
+
+#endif  // RUNNER_UTF_TRANSCODE_H_
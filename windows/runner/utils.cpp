@@ -2,10 +2,23 @@
 
 #include <flutter_windows.h>
 #include <io.h>
+#include <shlobj.h>
 #include <stdio.h>
 #include <windows.h>
 
 #include <iostream>
+#include <string_view>
+
+#include "startup_trace.h"
+#include "utf_transcode.h"
+
+namespace {
+
+constexpr wchar_t kAppDataFolderName[] = L"suxingchahui";
+
+RunnerFlags g_runner_flags;
+
+}  // namespace
 
 void CreateAndAttachConsole() {
   if (::AllocConsole()) {
@@ -29,37 +42,93 @@ std::vector<std::string> GetCommandLineArguments() {
     return std::vector<std::string>();
   }
 
-  std::vector<std::string> command_line_arguments;
-
-  // Skip the first argument as it's the binary name.
+  // Skip the first argument as it's the binary name. Transcoding and runner
+  // flag parsing are platform-neutral, see runner_flags.h.
+  std::vector<std::u16string_view> utf16_arguments;
   for (int i = 1; i < argc; i++) {
-    command_line_arguments.push_back(Utf8FromUtf16(argv[i]));
+    utf16_arguments.emplace_back(reinterpret_cast<const char16_t*>(argv[i]));
   }
-
+  std::vector<std::string> command_line_arguments = ParseCommandLineArguments(
+      utf16_arguments.data(), utf16_arguments.size(), &g_runner_flags);
   ::LocalFree(argv);
 
+  if (!g_runner_flags.startup_trace_path.empty()) {
+    StartupTrace::GetInstance().Enable(g_runner_flags.startup_trace_path);
+  }
   return command_line_arguments;
 }
 
+const RunnerFlags& GetRunnerFlags() {
+  return g_runner_flags;
+}
+
+std::wstring GetExecutableDirectory() {
+  std::wstring path(MAX_PATH, L'\0');
+  for (;;) {
+    DWORD length = ::GetModuleFileNameW(nullptr, path.data(),
+                                        static_cast<DWORD>(path.size()));
+    if (length == 0) {
+      return std::wstring();
+    }
+    if (length < path.size()) {
+      path.resize(length);
+      break;
+    }
+    path.resize(path.size() * 2);
+  }
+  const size_t separator = path.find_last_of(L"\\/");
+  return separator == std::wstring::npos ? std::wstring()
+                                         : path.substr(0, separator);
+}
+
+std::wstring GetAppDataDirectory() {
+  PWSTR local_app_data = nullptr;
+  if (FAILED(::SHGetKnownFolderPath(FOLDERID_LocalAppData, KF_FLAG_CREATE,
+                                    nullptr, &local_app_data))) {
+    return std::wstring();
+  }
+  std::wstring directory = local_app_data;
+  ::CoTaskMemFree(local_app_data);
+  directory += L"\\";
+  directory += kAppDataFolderName;
+  if (!::CreateDirectoryW(directory.c_str(), nullptr) &&
+      ::GetLastError() != ERROR_ALREADY_EXISTS) {
+    return std::wstring();
+  }
+  return directory;
+}
+
+std::wstring GetDownloadsDirectory() {
+  PWSTR downloads = nullptr;
+  if (FAILED(::SHGetKnownFolderPath(FOLDERID_Downloads, KF_FLAG_CREATE,
+                                    nullptr, &downloads))) {
+    return std::wstring();
+  }
+  std::wstring directory = downloads;
+  ::CoTaskMemFree(downloads);
+  return directory;
+}
+
 std::string Utf8FromUtf16(const wchar_t* utf16_string) {
   if (utf16_string == nullptr) {
     return std::string();
   }
-  unsigned int target_length = ::WideCharToMultiByte(
-      CP_UTF8, WC_ERR_INVALID_CHARS, utf16_string,
-      -1, nullptr, 0, nullptr, nullptr)
-    -1; // remove the trailing null character
-  int input_length = (int)wcslen(utf16_string);
   std::string utf8_string;
-  if (target_length == 0 || target_length > utf8_string.max_size()) {
-    return utf8_string;
-  }
-  utf8_string.resize(target_length);
-  int converted_length = ::WideCharToMultiByte(
-      CP_UTF8, WC_ERR_INVALID_CHARS, utf16_string,
-      input_length, utf8_string.data(), target_length, nullptr, nullptr);
-  if (converted_length == 0) {
+  if (!Utf16ToUtf8(reinterpret_cast<const char16_t*>(utf16_string),
+                   &utf8_string)) {
     return std::string();
   }
   return utf8_string;
 }
+
+std::wstring Utf16FromUtf8(const std::string& utf8_string) {
+  std::wstring utf16_string(MaxUtf16LengthForUtf8(utf8_string.size()), L'\0');
+  size_t length = 0;
+  if (!ConvertUtf8ToUtf16(utf8_string.data(), utf8_string.size(),
+                          reinterpret_cast<char16_t*>(utf16_string.data()),
+                          &length)) {
+    return std::wstring();
+  }
+  utf16_string.resize(length);
+  return utf16_string;
+}
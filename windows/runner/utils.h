@@ -1,9 +1,12 @@
 #ifndef RUNNER_UTILS_H_
 #define RUNNER_UTILS_H_
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
+#include "runner_flags.h"
+
 // Creates a console for the process, and redirects stdout and stderr to
 // it for both the runner and the Flutter library.
 void CreateAndAttachConsole();
@@ -12,8 +15,44 @@ void CreateAndAttachConsole();
 // encoded in UTF-8. Returns an empty std::string on failure.
 std::string Utf8FromUtf16(const wchar_t* utf16_string);
 
+// Takes a UTF-8 std::string and returns a std::wstring encoded in UTF-16.
+// Returns an empty std::wstring on failure.
+std::wstring Utf16FromUtf8(const std::string& utf8_string);
+
 // Gets the command line arguments passed in as a std::vector<std::string>,
 // encoded in UTF-8. Returns an empty std::vector<std::string> on failure.
+//
+// Runner-only flags are consumed here and not forwarded to Dart:
+//   --startup-trace[=<path>]  Record a startup timeline and write it as
+//                             Chrome trace-event JSON on exit (default
+//                             path: startup_trace.json).
+//   --write-bundle-manifest   Hash the data\ directory, write its integrity
+//                             manifest and exit. Run by the install step.
+//   --memory-sample-ms=<n>    Memory telemetry interval in milliseconds
+//                             (default 10000, 0 disables sampling).
+//   --hang-threshold-ms=<n>   Log platform-thread stalls longer than this
+//                             (default 2000, 0 disables the watchdog).
+//   --no-prefetch             Do not warm the file cache for engine assets
+//                             during pre-init.
+//   --prefetch-list=<path>    Prefetch the files listed in |path| (one path
+//                             per line, relative to the executable) instead
+//                             of the built-in list.
 std::vector<std::string> GetCommandLineArguments();
 
+// Runner-only flags parsed by GetCommandLineArguments.
+const RunnerFlags& GetRunnerFlags();
+
+// Returns the directory containing the running executable, without a
+// trailing separator. Returns an empty std::wstring on failure.
+std::wstring GetExecutableDirectory();
+
+// Returns the per-user data directory of the runner
+// (%LOCALAPPDATA%\suxingchahui), creating it if needed. Returns an empty
+// std::wstring on failure.
+std::wstring GetAppDataDirectory();
+
+// Returns the user's Downloads folder, without a trailing separator. Returns
+// an empty std::wstring on failure.
+std::wstring GetDownloadsDirectory();
+
 #endif  // RUNNER_UTILS_H_
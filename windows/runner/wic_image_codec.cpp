@@ -0,0 +1,382 @@
+#include "wic_image_codec.h"
+
+#include <windows.h>
+#include <objbase.h>
+#include <propidl.h>
+#include <wincodec.h>
+#include <wrl/client.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+using Microsoft::WRL::ComPtr;
+
+namespace {
+
+// JPEG 的 EXIF 方向标签（0x0112）。
+constexpr wchar_t kJpegOrientationQuery[] = L"/app1/ifd/{ushort=274}";
+
+std::string HResultMessage(const char* step, HRESULT hr) {
+  char buffer[96];
+  snprintf(buffer, sizeof(buffer), "%s failed (0x%08lX)", step,
+           static_cast<unsigned long>(hr));
+  return buffer;
+}
+
+bool CreateFactory(ComPtr<IWICImagingFactory>* factory, std::string* error) {
+  const HRESULT hr =
+      CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER,
+                       IID_PPV_ARGS(factory->GetAddressOf()));
+  if (FAILED(hr)) {
+    *error = HResultMessage("CreateImagingFactory", hr);
+    return false;
+  }
+  return true;
+}
+
+ImageFormat ContainerFormat(IWICBitmapDecoder* decoder) {
+  GUID container = {};
+  if (FAILED(decoder->GetContainerFormat(&container))) {
+    return ImageFormat::kUnknown;
+  }
+  if (container == GUID_ContainerFormatJpeg) {
+    return ImageFormat::kJpeg;
+  }
+  if (container == GUID_ContainerFormatPng) {
+    return ImageFormat::kPng;
+  }
+  return ImageFormat::kUnknown;
+}
+
+// EXIF 方向（1-8）对应的旋转和翻转，WIC 先旋转再翻转。
+WICBitmapTransformOptions OrientationTransform(IWICBitmapFrameDecode* frame) {
+  ComPtr<IWICMetadataQueryReader> reader;
+  if (FAILED(frame->GetMetadataQueryReader(&reader))) {
+    return WICBitmapTransformRotate0;
+  }
+  PROPVARIANT value;
+  PropVariantInit(&value);
+  USHORT orientation = 1;
+  if (SUCCEEDED(reader->GetMetadataByName(kJpegOrientationQuery, &value)) &&
+      value.vt == VT_UI2) {
+    orientation = value.uiVal;
+  }
+  PropVariantClear(&value);
+
+  const int flip_horizontal = WICBitmapTransformFlipHorizontal;
+  switch (orientation) {
+    case 2:
+      return WICBitmapTransformFlipHorizontal;
+    case 3:
+      return WICBitmapTransformRotate180;
+    case 4:
+      return WICBitmapTransformFlipVertical;
+    case 5:
+      return static_cast<WICBitmapTransformOptions>(
+          WICBitmapTransformRotate90 | flip_horizontal);
+    case 6:
+      return WICBitmapTransformRotate90;
+    case 7:
+      return static_cast<WICBitmapTransformOptions>(
+          WICBitmapTransformRotate270 | flip_horizontal);
+    case 8:
+      return WICBitmapTransformRotate270;
+    default:
+      return WICBitmapTransformRotate0;
+  }
+}
+
+// |min_width| 为 0 时解码全尺寸。
+bool DecodeFirstFrame(IWICImagingFactory* factory,
+                      IWICBitmapDecoder* decoder,
+                      uint32_t min_width,
+                      PixelBuffer* image,
+                      ImageFormat* format,
+                      std::string* error) {
+  if (format) {
+    *format = ContainerFormat(decoder);
+  }
+
+  ComPtr<IWICBitmapFrameDecode> frame;
+  HRESULT hr = decoder->GetFrame(0, &frame);
+  if (FAILED(hr)) {
+    *error = HResultMessage("GetFrame", hr);
+    return false;
+  }
+
+  const WICBitmapTransformOptions transform = OrientationTransform(frame.Get());
+  ComPtr<IWICBitmapSource> decoded = frame;
+  if (min_width > 0) {
+    UINT frame_width = 0;
+    UINT frame_height = 0;
+    hr = frame->GetSize(&frame_width, &frame_height);
+    if (FAILED(hr)) {
+      *error = HResultMessage("GetSize", hr);
+      return false;
+    }
+    // 旋转 90/270 度时，摆正后的宽度是帧的高度
+    const bool transposed = (transform & WICBitmapTransformRotate90) != 0;
+    const UINT upright_width = transposed ? frame_height : frame_width;
+    if (upright_width > 2 * static_cast<uint64_t>(min_width)) {
+      const double scale = 2.0 * min_width / upright_width;
+      const auto scaled_width = static_cast<UINT>(
+          std::max(1.0, std::round(frame_width * scale)));
+      const auto scaled_height = static_cast<UINT>(
+          std::max(1.0, std::round(frame_height * scale)));
+      // 缩放器会优先使用解码器自带的缩放（IWICBitmapSourceTransform）
+      ComPtr<IWICBitmapScaler> scaler;
+      hr = factory->CreateBitmapScaler(&scaler);
+      if (SUCCEEDED(hr)) {
+        hr = scaler->Initialize(frame.Get(), scaled_width, scaled_height,
+                                WICBitmapInterpolationModeFant);
+      }
+      if (FAILED(hr)) {
+        *error = HResultMessage("BitmapScaler", hr);
+        return false;
+      }
+      decoded = scaler;
+    }
+  }
+
+  ComPtr<IWICFormatConverter> converter;
+  hr = factory->CreateFormatConverter(&converter);
+  if (SUCCEEDED(hr)) {
+    hr = converter->Initialize(decoded.Get(), GUID_WICPixelFormat32bppPBGRA,
+                               WICBitmapDitherTypeNone, nullptr, 0.0,
+                               WICBitmapPaletteTypeCustom);
+  }
+  if (FAILED(hr)) {
+    *error = HResultMessage("FormatConverter", hr);
+    return false;
+  }
+
+  ComPtr<IWICBitmapSource> source = converter;
+  if (transform != WICBitmapTransformRotate0) {
+    ComPtr<IWICBitmapFlipRotator> rotator;
+    hr = factory->CreateBitmapFlipRotator(&rotator);
+    if (SUCCEEDED(hr)) {
+      hr = rotator->Initialize(converter.Get(), transform);
+    }
+    if (FAILED(hr)) {
+      *error = HResultMessage("FlipRotator", hr);
+      return false;
+    }
+    source = rotator;
+  }
+
+  UINT width = 0;
+  UINT height = 0;
+  hr = source->GetSize(&width, &height);
+  if (FAILED(hr) || width == 0 || height == 0) {
+    *error = HResultMessage("GetSize", hr);
+    return false;
+  }
+  if (static_cast<uint64_t>(width) * height > kMaxDecodePixels) {
+    *error = "Image too large";
+    return false;
+  }
+
+  image->Allocate(width, height);
+  hr = source->CopyPixels(nullptr, static_cast<UINT>(image->stride()),
+                          static_cast<UINT>(image->pixels.size()),
+                          image->pixels.data());
+  if (FAILED(hr)) {
+    *image = PixelBuffer();
+    *error = HResultMessage("CopyPixels", hr);
+    return false;
+  }
+  return true;
+}
+
+bool CopyStream(IStream* stream,
+                std::vector<uint8_t>* output,
+                std::string* error) {
+  STATSTG stat = {};
+  HRESULT hr = stream->Stat(&stat, STATFLAG_NONAME);
+  HGLOBAL global = nullptr;
+  if (SUCCEEDED(hr)) {
+    hr = GetHGlobalFromStream(stream, &global);
+  }
+  if (FAILED(hr)) {
+    *error = HResultMessage("GetHGlobalFromStream", hr);
+    return false;
+  }
+  const void* data = GlobalLock(global);
+  if (!data) {
+    *error = "GlobalLock failed";
+    return false;
+  }
+  const auto size = static_cast<size_t>(stat.cbSize.QuadPart);
+  output->resize(size);
+  std::memcpy(output->data(), data, size);
+  GlobalUnlock(global);
+  return true;
+}
+
+}  // namespace
+
+ScopedComInitializer::ScopedComInitializer() {
+  const HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+  // S_FALSE 表示已经初始化过，同样需要配对的 CoUninitialize。
+  succeeded_ = SUCCEEDED(hr);
+}
+
+ScopedComInitializer::~ScopedComInitializer() {
+  if (succeeded_) {
+    CoUninitialize();
+  }
+}
+
+bool DecodeImageFile(const std::wstring& path,
+                     PixelBuffer* image,
+                     ImageFormat* format,
+                     std::string* error) {
+  return DecodeImageFileForWidth(path, 0, image, format, error);
+}
+
+bool DecodeImageFileForWidth(const std::wstring& path,
+                             uint32_t min_width,
+                             PixelBuffer* image,
+                             ImageFormat* format,
+                             std::string* error) {
+  ComPtr<IWICImagingFactory> factory;
+  if (!CreateFactory(&factory, error)) {
+    return false;
+  }
+  ComPtr<IWICBitmapDecoder> decoder;
+  const HRESULT hr = factory->CreateDecoderFromFilename(
+      path.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand,
+      &decoder);
+  if (FAILED(hr)) {
+    *error = HResultMessage("CreateDecoderFromFilename", hr);
+    return false;
+  }
+  return DecodeFirstFrame(factory.Get(), decoder.Get(), min_width, image,
+                          format, error);
+}
+
+bool DecodeImageBytes(const uint8_t* data,
+                      size_t size,
+                      PixelBuffer* image,
+                      ImageFormat* format,
+                      std::string* error) {
+  if (size > 0xFFFFFFFFull) {
+    *error = "Image too large";
+    return false;
+  }
+  ComPtr<IWICImagingFactory> factory;
+  if (!CreateFactory(&factory, error)) {
+    return false;
+  }
+  ComPtr<IWICStream> stream;
+  HRESULT hr = factory->CreateStream(&stream);
+  if (SUCCEEDED(hr)) {
+    hr = stream->InitializeFromMemory(const_cast<BYTE*>(data),
+                                      static_cast<DWORD>(size));
+  }
+  ComPtr<IWICBitmapDecoder> decoder;
+  if (SUCCEEDED(hr)) {
+    hr = factory->CreateDecoderFromStream(
+        stream.Get(), nullptr, WICDecodeMetadataCacheOnDemand, &decoder);
+  }
+  if (FAILED(hr)) {
+    *error = HResultMessage("CreateDecoderFromStream", hr);
+    return false;
+  }
+  return DecodeFirstFrame(factory.Get(), decoder.Get(), 0, image, format,
+                          error);
+}
+
+bool EncodeImage(const PixelBuffer& image,
+                 ImageFormat format,
+                 int quality,
+                 std::vector<uint8_t>* output,
+                 std::string* error) {
+  if (image.empty() || format == ImageFormat::kUnknown) {
+    *error = "Nothing to encode";
+    return false;
+  }
+
+  // WIC 的 PNG 编码器不接受预乘 alpha，JPEG 没有 alpha 通道。
+  const bool jpeg = format == ImageFormat::kJpeg;
+  PixelBuffer straight;
+  std::vector<uint8_t> flattened;
+  const uint8_t* pixels = nullptr;
+  size_t stride = 0;
+  if (jpeg) {
+    flattened = FlattenOnWhite(image);
+    pixels = flattened.data();
+    stride = static_cast<size_t>(image.width) * 3;
+  } else {
+    straight = image;
+    UnpremultiplyAlpha(&straight);
+    pixels = straight.pixels.data();
+    stride = straight.stride();
+  }
+
+  ComPtr<IWICImagingFactory> factory;
+  if (!CreateFactory(&factory, error)) {
+    return false;
+  }
+  ComPtr<IStream> stream;
+  HRESULT hr = CreateStreamOnHGlobal(nullptr, TRUE, &stream);
+  ComPtr<IWICBitmapEncoder> encoder;
+  if (SUCCEEDED(hr)) {
+    hr = factory->CreateEncoder(
+        jpeg ? GUID_ContainerFormatJpeg : GUID_ContainerFormatPng, nullptr,
+        &encoder);
+  }
+  if (SUCCEEDED(hr)) {
+    hr = encoder->Initialize(stream.Get(), WICBitmapEncoderNoCache);
+  }
+  ComPtr<IWICBitmapFrameEncode> frame;
+  ComPtr<IPropertyBag2> properties;
+  if (SUCCEEDED(hr)) {
+    hr = encoder->CreateNewFrame(&frame, &properties);
+  }
+  if (SUCCEEDED(hr) && jpeg) {
+    PROPBAG2 option = {};
+    option.pstrName = const_cast<LPOLESTR>(L"ImageQuality");
+    VARIANT value;
+    VariantInit(&value);
+    value.vt = VT_R4;
+    value.fltVal = static_cast<float>(std::clamp(quality, 1, 100)) / 100.0f;
+    hr = properties->Write(1, &option, &value);
+  }
+  if (FAILED(hr)) {
+    *error = HResultMessage("CreateEncoder", hr);
+    return false;
+  }
+
+  WICPixelFormatGUID pixel_format =
+      jpeg ? GUID_WICPixelFormat24bppBGR : GUID_WICPixelFormat32bppBGRA;
+  const WICPixelFormatGUID requested_format = pixel_format;
+  hr = frame->Initialize(properties.Get());
+  if (SUCCEEDED(hr)) {
+    hr = frame->SetSize(image.width, image.height);
+  }
+  if (SUCCEEDED(hr)) {
+    hr = frame->SetPixelFormat(&pixel_format);
+  }
+  if (SUCCEEDED(hr) && pixel_format != requested_format) {
+    hr = WINCODEC_ERR_UNSUPPORTEDPIXELFORMAT;
+  }
+  if (SUCCEEDED(hr)) {
+    hr = frame->WritePixels(image.height, static_cast<UINT>(stride),
+                            static_cast<UINT>(stride * image.height),
+                            const_cast<BYTE*>(pixels));
+  }
+  if (SUCCEEDED(hr)) {
+    hr = frame->Commit();
+  }
+  if (SUCCEEDED(hr)) {
+    hr = encoder->Commit();
+  }
+  if (FAILED(hr)) {
+    *error = HResultMessage("Encode", hr);
+    return false;
+  }
+  return CopyStream(stream.Get(), output, error);
+}
@@ -0,0 +1,61 @@
+#ifndef RUNNER_WIC_IMAGE_CODEC_H_
+#define RUNNER_WIC_IMAGE_CODEC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "image_ops.h"
+
+// 基于 Windows Imaging Component 的解码和编码。
+// 调用线程必须已经初始化 COM（工作线程上用 ScopedComInitializer）。
+
+enum class ImageFormat { kUnknown, kJpeg, kPng };
+
+// 在当前线程上初始化 COM（MTA），析构时反初始化。
+class ScopedComInitializer {
+ public:
+  ScopedComInitializer();
+  ~ScopedComInitializer();
+
+  ScopedComInitializer(const ScopedComInitializer&) = delete;
+  ScopedComInitializer& operator=(const ScopedComInitializer&) = delete;
+
+  bool succeeded() const { return succeeded_; }
+
+ private:
+  bool succeeded_ = false;
+};
+
+// 解码第一帧，按 EXIF 方向摆正并转为预乘 BGRA。|format| 可以为 nullptr。
+// 超过 kMaxDecodePixels 的图片直接拒绝，避免一次分配过大的内存。
+constexpr uint64_t kMaxDecodePixels = 120ull * 1000 * 1000;
+bool DecodeImageFile(const std::wstring& path,
+                     PixelBuffer* image,
+                     ImageFormat* format,
+                     std::string* error);
+// 同 DecodeImageFile，但只需要宽度不小于 |min_width|（按摆正后的方向）。
+// 原图比需要的大很多时由解码器在解码阶段缩小（JPEG 可以直接按 1/2、1/4、
+// 1/8 解码），结果的宽度在 |min_width| 和 2 * |min_width| 之间，再由调用方
+// 精确缩放。
+bool DecodeImageFileForWidth(const std::wstring& path,
+                             uint32_t min_width,
+                             PixelBuffer* image,
+                             ImageFormat* format,
+                             std::string* error);
+bool DecodeImageBytes(const uint8_t* data,
+                      size_t size,
+                      PixelBuffer* image,
+                      ImageFormat* format,
+                      std::string* error);
+
+// 编码 |image|（预乘 BGRA）。PNG 保留透明度，JPEG 合成到白色背景上。
+// |quality| 只对 JPEG 有效，取值 1-100。
+bool EncodeImage(const PixelBuffer& image,
+                 ImageFormat format,
+                 int quality,
+                 std::vector<uint8_t>* output,
+                 std::string* error);
+
+#endif  // RUNNER_WIC_IMAGE_CODEC_H_
@@ -3,6 +3,8 @@
 #include <dwmapi.h>
 #include <flutter_windows.h>
 
+#include <chrono>
+
 #include "resource.h"
 
 namespace {
@@ -29,6 +31,15 @@ constexpr const wchar_t kGetPreferredBrightnessRegValue[] = L"AppsUseLightTheme"
 // The number of Win32Window objects that currently exist.
 static int g_active_window_count = 0;
 
+// Timer that applies a coalesced child resize during a size/move loop.
+constexpr UINT_PTR kResizeTimerId = 0x5253;
+
+int64_t NowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
 using EnableNonClientDpiScaling = BOOL __stdcall(HWND hwnd);
 
 // Scale helper to convert logical scaler values to physical using passed in
@@ -197,15 +208,27 @@ Win32Window::MessageHandler(HWND hwnd,
 
       return 0;
     }
-    case WM_SIZE: {
-      RECT rect = GetClientArea();
-      if (child_content_ != nullptr) {
-        // Size and position the child window.
-        MoveWindow(child_content_, rect.left, rect.top, rect.right - rect.left,
-                   rect.bottom - rect.top, TRUE);
-      }
+    case WM_SIZE:
+      ApplyResizeAction(resize_coalescer_.Size(LOWORD(lparam), HIWORD(lparam),
+                                               NowMicros()));
       return 0;
-    }
+
+    case WM_ENTERSIZEMOVE:
+      ApplyResizeAction(resize_coalescer_.EnterSizeMove(NowMicros()));
+      break;
+
+    case WM_EXITSIZEMOVE:
+      KillTimer(hwnd, kResizeTimerId);
+      ApplyResizeAction(resize_coalescer_.ExitSizeMove(NowMicros()));
+      break;
+
+    case WM_TIMER:
+      if (wparam == kResizeTimerId) {
+        KillTimer(hwnd, kResizeTimerId);
+        ApplyResizeAction(resize_coalescer_.Timer(NowMicros()));
+        return 0;
+      }
+      break;
 
     case WM_ACTIVATE:
       if (child_content_ != nullptr) {
@@ -272,6 +295,27 @@ void Win32Window::OnDestroy() {
   // No-op; provided for subclasses.
 }
 
+void Win32Window::OnLiveResize(bool /*resizing*/) {
+  // No-op; provided for subclasses.
+}
+
+void Win32Window::ApplyResizeAction(const ResizeCoalescer::Action& action) {
+  if (action.move_child && child_content_ != nullptr) {
+    // Size and position the child window.
+    RECT rect = GetClientArea();
+    MoveWindow(child_content_, rect.left, rect.top, rect.right - rect.left,
+               rect.bottom - rect.top, TRUE);
+  }
+  if (action.timer_delay_us >= 0) {
+    const int64_t delay_ms = (action.timer_delay_us + 999) / 1000;
+    SetTimer(window_handle_, kResizeTimerId, static_cast<UINT>(delay_ms),
+             nullptr);
+  }
+  if (action.event != ResizeCoalescer::Event::kNone) {
+    OnLiveResize(action.event == ResizeCoalescer::Event::kBegin);
+  }
+}
+
 void Win32Window::UpdateTheme(HWND const window) {
   DWORD light_mode;
   DWORD light_mode_size = sizeof(light_mode);
@@ -7,6 +7,8 @@
 #include <memory>
 #include <string>
 
+#include "resize_coalescer.h"
+
 // A class abstraction for a high DPI-aware Win32 Window. Intended to be
 // inherited from by classes that wish to specialize with custom
 // rendering and input handling
@@ -71,6 +73,11 @@ class Win32Window {
   // Called when Destroy is called.
   virtual void OnDestroy();
 
+  // Called when the user starts (|resizing| true) or finishes dragging the
+  // window border. Moving the window without changing its size does not
+  // report anything.
+  virtual void OnLiveResize(bool resizing);
+
  private:
   friend class WindowClassRegistrar;
 
@@ -90,6 +97,10 @@ class Win32Window {
   // Update the window frame's theme to match the system theme.
   static void UpdateTheme(HWND const window);
 
+  // Moves the child content, arms the coalescing timer and reports live
+  // resize transitions as requested by |resize_coalescer_|.
+  void ApplyResizeAction(const ResizeCoalescer::Action& action);
+
   bool quit_on_close_ = false;
 
   // window handle for top level window.
@@ -97,6 +108,10 @@ class Win32Window {
 
   // window handle for hosted content.
   HWND child_content_ = nullptr;
+
+  // Limits child content resizes to one per frame while the border is being
+  // dragged.
+  ResizeCoalescer resize_coalescer_;
 };
 
 #endif  // RUNNER_WIN32_WINDOW_H_
@@ -0,0 +1,41 @@
+#include "window_resize_channel.h"
+
+#include <flutter/event_stream_handler_functions.h>
+#include <flutter/standard_method_codec.h>
+
+#include <utility>
+
+namespace {
+
+constexpr char kChannelName[] = "com.example.suxingchahui/window_resize";
+
+using flutter::EncodableValue;
+
+}  // namespace
+
+WindowResizeChannel::WindowResizeChannel(flutter::BinaryMessenger* messenger)
+    : channel_(std::make_unique<flutter::EventChannel<EncodableValue>>(
+          messenger, kChannelName,
+          &flutter::StandardMethodCodec::GetInstance())) {
+  channel_->SetStreamHandler(
+      std::make_unique<flutter::StreamHandlerFunctions<EncodableValue>>(
+          [this](const EncodableValue* /*arguments*/,
+                 std::unique_ptr<flutter::EventSink<EncodableValue>>&& events)
+              -> std::unique_ptr<flutter::StreamHandlerError<EncodableValue>> {
+            sink_ = std::move(events);
+            sink_->Success(EncodableValue(resizing_));
+            return nullptr;
+          },
+          [this](const EncodableValue* /*arguments*/)
+              -> std::unique_ptr<flutter::StreamHandlerError<EncodableValue>> {
+            sink_ = nullptr;
+            return nullptr;
+          }));
+}
+
+void WindowResizeChannel::Send(bool resizing) {
+  resizing_ = resizing;
+  if (sink_) {
+    sink_->Success(EncodableValue(resizing));
+  }
+}
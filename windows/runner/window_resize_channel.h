@@ -0,0 +1,32 @@
+#ifndef RUNNER_WINDOW_RESIZE_CHANNEL_H_
+#define RUNNER_WINDOW_RESIZE_CHANNEL_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+#include <flutter/event_channel.h>
+#include <flutter/event_sink.h>
+
+#include <memory>
+
+// 把拖动窗口边框的开始和结束推送给 Dart，见 resize_coalescer.h。
+//
+// 通道：com.example.suxingchahui/window_resize（EventChannel）
+//   事件为 bool：true 开始调整尺寸，false 结束。开始监听时先发送当前状态。
+class WindowResizeChannel {
+ public:
+  explicit WindowResizeChannel(flutter::BinaryMessenger* messenger);
+
+  WindowResizeChannel(const WindowResizeChannel&) = delete;
+  WindowResizeChannel& operator=(const WindowResizeChannel&) = delete;
+
+  // 只能在平台线程调用。
+  void Send(bool resizing);
+
+ private:
+  std::unique_ptr<flutter::EventChannel<flutter::EncodableValue>> channel_;
+  // Dart 没有监听时为 nullptr。
+  std::unique_ptr<flutter::EventSink<flutter::EncodableValue>> sink_;
+  bool resizing_ = false;
+};
+
+#endif  // RUNNER_WINDOW_RESIZE_CHANNEL_H_
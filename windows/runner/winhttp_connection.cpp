@@ -0,0 +1,333 @@
+#include "winhttp_connection.h"
+
+#include <winhttp.h>
+
+#include <algorithm>
+#include <cctype>
+#include <utility>
+#include <vector>
+
+#include "utf_transcode.h"
+#include "utils.h"
+
+namespace {
+
+constexpr wchar_t kUserAgent[] = L"suxingchahui";
+// 预热只需要完成握手，不需要很长的超时
+constexpr int kWarmTimeoutMilliseconds = 5000;
+constexpr size_t kStreamBufferSize = 64 * 1024;
+
+struct InternetHandleDeleter {
+  void operator()(void* handle) const {
+    if (handle) {
+      ::WinHttpCloseHandle(handle);
+    }
+  }
+};
+using ScopedInternetHandle = std::unique_ptr<void, InternetHandleDeleter>;
+
+std::string LastErrorMessage(const char* operation) {
+  return std::string(operation) + " failed (WinHTTP error " +
+         std::to_string(::GetLastError()) + ")";
+}
+
+bool EqualsIgnoreCase(const std::string& a, const char* b) {
+  const size_t length = std::char_traits<char>::length(b);
+  return a.size() == length &&
+         std::equal(a.begin(), a.end(), b, [](char x, char y) {
+           return std::tolower(static_cast<unsigned char>(x)) ==
+                  std::tolower(static_cast<unsigned char>(y));
+         });
+}
+
+// WINHTTP_QUERY_RAW_HEADERS_CRLF 的结果：状态行之后每行 "Name: value"
+void ParseRawHeaders(const std::wstring& raw, HttpHeaders* headers) {
+  std::string utf8;
+  if (!Utf16ToUtf8(
+          std::u16string_view(reinterpret_cast<const char16_t*>(raw.data()),
+                              raw.size()),
+          &utf8)) {
+    return;
+  }
+  size_t line_begin = utf8.find("\r\n");
+  while (line_begin != std::string::npos) {
+    line_begin += 2;
+    const size_t line_end = utf8.find("\r\n", line_begin);
+    const std::string line = utf8.substr(
+        line_begin, line_end == std::string::npos ? std::string::npos
+                                                  : line_end - line_begin);
+    const size_t colon = line.find(':');
+    if (colon != std::string::npos && colon > 0) {
+      const size_t value_begin = line.find_first_not_of(' ', colon + 1);
+      headers->emplace_back(line.substr(0, colon),
+                            value_begin == std::string::npos
+                                ? std::string()
+                                : line.substr(value_begin));
+    }
+    line_begin = line_end;
+  }
+}
+
+// 一次请求的证书校验状态，经 WINHTTP_OPTION_CONTEXT_VALUE 交给状态回调。
+struct PinCheck {
+  const std::string* hostname;
+  const WinHttpConnectionFactory::CertificateValidator* validator;
+  bool rejected = false;
+};
+
+// TLS 握手完成、请求头写出之前收到 SENDING_REQUEST，此时校验证书，
+// 不通过就关闭请求句柄，WinHttpSendRequest 以
+// ERROR_WINHTTP_OPERATION_CANCELLED 失败，请求头和请求体都不会发出。
+void CALLBACK OnRequestStatus(HINTERNET request,
+                              DWORD_PTR context,
+                              DWORD status,
+                              LPVOID,
+                              DWORD) {
+  if (status != WINHTTP_CALLBACK_STATUS_SENDING_REQUEST || context == 0) {
+    return;
+  }
+  auto* check = reinterpret_cast<PinCheck*>(context);
+  if (check->rejected) {
+    return;
+  }
+  PCCERT_CONTEXT certificate = nullptr;
+  DWORD size = sizeof(certificate);
+  bool valid = false;
+  if (::WinHttpQueryOption(request, WINHTTP_OPTION_SERVER_CERT_CONTEXT,
+                           &certificate, &size) &&
+      certificate) {
+    valid = (*check->validator)(*check->hostname, certificate);
+    ::CertFreeCertificateContext(certificate);
+  }
+  if (!valid) {
+    check->rejected = true;
+    ::WinHttpCloseHandle(request);
+  }
+}
+
+class WinHttpConnection : public HttpConnection {
+ public:
+  WinHttpConnection(HttpOrigin origin,
+                    WinHttpConnectionFactory::CertificateValidator validator)
+      : origin_(std::move(origin)), validator_(std::move(validator)) {}
+
+  bool Warm(std::string* error) override {
+    HttpRequest request;
+    request.method = "HEAD";
+    request.timeout = std::chrono::milliseconds(kWarmTimeoutMilliseconds);
+    HttpResponse response;
+    return Send(request, &response, error);
+  }
+
+  bool Send(const HttpRequest& request,
+            HttpResponse* response,
+            std::string* error) override {
+    if (!Open(error)) {
+      reusable_ = false;
+      return false;
+    }
+    if (!SendOnce(request, response, error)) {
+      reusable_ = false;
+      return false;
+    }
+    return true;
+  }
+
+  bool reusable() const override { return reusable_; }
+
+ private:
+  bool Open(std::string* error) {
+    if (connection_) {
+      return true;
+    }
+    session_.reset(::WinHttpOpen(kUserAgent,
+                                 WINHTTP_ACCESS_TYPE_AUTOMATIC_PROXY,
+                                 WINHTTP_NO_PROXY_NAME,
+                                 WINHTTP_NO_PROXY_BYPASS, 0));
+    if (!session_) {
+      *error = LastErrorMessage("WinHttpOpen");
+      return false;
+    }
+    // 一个会话只保留一个 socket，见头文件说明
+    DWORD max_connections = 1;
+    ::WinHttpSetOption(session_.get(), WINHTTP_OPTION_MAX_CONNS_PER_SERVER,
+                       &max_connections, sizeof(max_connections));
+    ::WinHttpSetOption(session_.get(), WINHTTP_OPTION_MAX_CONNS_PER_1_0_SERVER,
+                       &max_connections, sizeof(max_connections));
+    DWORD protocols = WINHTTP_FLAG_SECURE_PROTOCOL_TLS1_2;
+#ifdef WINHTTP_FLAG_SECURE_PROTOCOL_TLS1_3
+    protocols |= WINHTTP_FLAG_SECURE_PROTOCOL_TLS1_3;
+#endif
+    if (!::WinHttpSetOption(session_.get(), WINHTTP_OPTION_SECURE_PROTOCOLS,
+                            &protocols, sizeof(protocols))) {
+      protocols = WINHTTP_FLAG_SECURE_PROTOCOL_TLS1_2;
+      ::WinHttpSetOption(session_.get(), WINHTTP_OPTION_SECURE_PROTOCOLS,
+                         &protocols, sizeof(protocols));
+    }
+    DWORD decompression = WINHTTP_DECOMPRESSION_FLAG_ALL;
+    ::WinHttpSetOption(session_.get(), WINHTTP_OPTION_DECOMPRESSION,
+                       &decompression, sizeof(decompression));
+
+    const std::wstring host = Utf16FromUtf8(origin_.host);
+    connection_.reset(
+        ::WinHttpConnect(session_.get(), host.c_str(), origin_.port, 0));
+    if (!connection_) {
+      *error = LastErrorMessage("WinHttpConnect");
+      session_.reset();
+      return false;
+    }
+    return true;
+  }
+
+  bool SendOnce(const HttpRequest& request,
+                HttpResponse* response,
+                std::string* error) {
+    const std::wstring method = Utf16FromUtf8(request.method);
+    const std::wstring path = Utf16FromUtf8(request.path);
+    ScopedInternetHandle handle(::WinHttpOpenRequest(
+        connection_.get(), method.c_str(), path.c_str(), nullptr,
+        WINHTTP_NO_REFERER, WINHTTP_DEFAULT_ACCEPT_TYPES,
+        origin_.secure ? WINHTTP_FLAG_SECURE : 0));
+    if (!handle) {
+      *error = LastErrorMessage("WinHttpOpenRequest");
+      return false;
+    }
+    const int timeout = static_cast<int>(request.timeout.count());
+    ::WinHttpSetTimeouts(handle.get(), timeout, timeout, timeout, timeout);
+
+    PinCheck pin_check{&origin_.host, &validator_};
+    if (origin_.secure && validator_) {
+      DWORD_PTR context = reinterpret_cast<DWORD_PTR>(&pin_check);
+      if (::WinHttpSetStatusCallback(handle.get(), OnRequestStatus,
+                                     WINHTTP_CALLBACK_FLAG_SEND_REQUEST, 0) ==
+              WINHTTP_INVALID_STATUS_CALLBACK ||
+          !::WinHttpSetOption(handle.get(), WINHTTP_OPTION_CONTEXT_VALUE,
+                              &context, sizeof(context))) {
+        *error = LastErrorMessage("WinHttpSetStatusCallback");
+        return false;
+      }
+    }
+
+    std::string header_block;
+    for (const auto& header : request.headers) {
+      header_block += header.first + ": " + header.second + "\r\n";
+    }
+    const std::wstring headers = Utf16FromUtf8(header_block);
+    const DWORD body_size = static_cast<DWORD>(request.body.size());
+    if (!::WinHttpSendRequest(
+            handle.get(),
+            headers.empty() ? WINHTTP_NO_ADDITIONAL_HEADERS : headers.c_str(),
+            headers.empty() ? 0 : static_cast<DWORD>(headers.size()),
+            body_size == 0 ? WINHTTP_NO_REQUEST_DATA
+                           : const_cast<char*>(request.body.data()),
+            body_size, body_size, 0)) {
+      if (pin_check.rejected) {
+        handle.release();  // 回调里已经关闭
+        *error = "Certificate pin mismatch for " + origin_.host;
+        return false;
+      }
+      *error = LastErrorMessage("WinHttpSendRequest");
+      return false;
+    }
+    if (!::WinHttpReceiveResponse(handle.get(), nullptr)) {
+      *error = LastErrorMessage("WinHttpReceiveResponse");
+      return false;
+    }
+
+    DWORD status_code = 0;
+    DWORD size = sizeof(status_code);
+    if (!::WinHttpQueryHeaders(
+            handle.get(), WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
+            WINHTTP_HEADER_NAME_BY_INDEX, &status_code, &size,
+            WINHTTP_NO_HEADER_INDEX)) {
+      *error = LastErrorMessage("WinHttpQueryHeaders");
+      return false;
+    }
+    response->status_code = static_cast<int>(status_code);
+
+    size = 0;
+    ::WinHttpQueryHeaders(handle.get(), WINHTTP_QUERY_RAW_HEADERS_CRLF,
+                          WINHTTP_HEADER_NAME_BY_INDEX,
+                          WINHTTP_NO_OUTPUT_BUFFER, &size,
+                          WINHTTP_NO_HEADER_INDEX);
+    if (::GetLastError() == ERROR_INSUFFICIENT_BUFFER && size > 0) {
+      std::wstring raw(size / sizeof(wchar_t), L'\0');
+      if (::WinHttpQueryHeaders(handle.get(), WINHTTP_QUERY_RAW_HEADERS_CRLF,
+                                WINHTTP_HEADER_NAME_BY_INDEX, raw.data(), &size,
+                                WINHTTP_NO_HEADER_INDEX)) {
+        raw.resize(size / sizeof(wchar_t));
+        ParseRawHeaders(raw, &response->headers);
+      }
+    }
+    for (const auto& header : response->headers) {
+      if (EqualsIgnoreCase(header.first, "connection") &&
+          EqualsIgnoreCase(header.second, "close")) {
+        reusable_ = false;
+      }
+    }
+
+    if (request.body_sink) {
+      return StreamBody(handle.get(), request.body_sink, error);
+    }
+    for (;;) {
+      DWORD available = 0;
+      if (!::WinHttpQueryDataAvailable(handle.get(), &available)) {
+        *error = LastErrorMessage("WinHttpQueryDataAvailable");
+        return false;
+      }
+      if (available == 0) {
+        break;
+      }
+      const size_t offset = response->body.size();
+      response->body.resize(offset + available);
+      DWORD read = 0;
+      if (!::WinHttpReadData(handle.get(), response->body.data() + offset,
+                             available, &read)) {
+        *error = LastErrorMessage("WinHttpReadData");
+        return false;
+      }
+      response->body.resize(offset + read);
+    }
+    return true;
+  }
+
+  // 用固定大小的缓冲区把响应体交给 |sink|。
+  bool StreamBody(HINTERNET request,
+                  const std::function<bool(const char*, size_t)>& sink,
+                  std::string* error) {
+    std::vector<char> buffer(kStreamBufferSize);
+    for (;;) {
+      DWORD read = 0;
+      if (!::WinHttpReadData(request, buffer.data(),
+                             static_cast<DWORD>(buffer.size()), &read)) {
+        *error = LastErrorMessage("WinHttpReadData");
+        return false;
+      }
+      if (read == 0) {
+        return true;
+      }
+      if (!sink(buffer.data(), read)) {
+        *error = "Response body consumer stopped reading";
+        reusable_ = false;
+        return false;
+      }
+    }
+  }
+
+  const HttpOrigin origin_;
+  const WinHttpConnectionFactory::CertificateValidator validator_;
+  ScopedInternetHandle session_;
+  ScopedInternetHandle connection_;
+  bool reusable_ = true;
+};
+
+}  // namespace
+
+WinHttpConnectionFactory::WinHttpConnectionFactory(
+    CertificateValidator validator)
+    : validator_(std::move(validator)) {}
+
+std::unique_ptr<HttpConnection> WinHttpConnectionFactory::Create(
+    const HttpOrigin& origin) {
+  return std::make_unique<WinHttpConnection>(origin, validator_);
+}
@@ -0,0 +1,34 @@
+#ifndef RUNNER_WINHTTP_CONNECTION_H_
+#define RUNNER_WINHTTP_CONNECTION_H_
+
+#include <windows.h>
+#include <wincrypt.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "http_connection_pool.h"
+
+// 基于 WinHTTP 的 HttpConnectionFactory。
+//
+// WinHTTP 在会话内部维护自己的 socket 池，调用方无法指定请求走哪条连接。
+// 这里每条连接使用独立的会话，并把每个服务器的连接数限制为 1，这样
+// HttpConnectionPool 关闭一条连接时，对应的 socket 也随之关闭，并发上限
+// 和空闲回收才真正作用在 socket 上。
+class WinHttpConnectionFactory : public HttpConnectionFactory {
+ public:
+  // HTTPS 请求在握手之后、发出请求头之前校验服务器证书，返回 false 时
+  // 请求失败，不发送任何请求数据。
+  using CertificateValidator =
+      std::function<bool(const std::string& hostname, PCCERT_CONTEXT)>;
+
+  explicit WinHttpConnectionFactory(CertificateValidator validator);
+
+  std::unique_ptr<HttpConnection> Create(const HttpOrigin& origin) override;
+
+ private:
+  CertificateValidator validator_;
+};
+
+#endif  // RUNNER_WINHTTP_CONNECTION_H_
@@ -0,0 +1,11 @@
+#ifndef RUNNER_XXHASH64_H_
+#define RUNNER_XXHASH64_H_
+
+#include <cstddef>
+#include <cstdint>
+
+// XXH64 非加密哈希，用于文件完整性比对和缓存键。
+// 结果与官方 xxHash 的 XXH64 一致。
+uint64_t XxHash64(const void* data, size_t length, uint64_t seed = 0);
+
+#endif  // RUNNER_XXHASH64_H_
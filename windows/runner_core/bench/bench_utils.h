@@ -0,0 +1,127 @@
+#ifndef RUNNER_CORE_BENCH_BENCH_UTILS_H_
+#define RUNNER_CORE_BENCH_BENCH_UTILS_H_
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// 系统临时目录下的空目录，已存在时先清空。
+inline std::filesystem::path BenchDirectory(const char* name) {
+  const std::filesystem::path directory =
+      std::filesystem::temp_directory_path() / "runner_core_bench" / name;
+  std::error_code error;
+  std::filesystem::remove_all(directory, error);
+  std::filesystem::create_directories(directory);
+  return directory;
+}
+
+inline std::vector<uint8_t> ReadBenchFile(const std::filesystem::path& path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), {});
+}
+
+// 把文件写回磁盘并从页缓存中丢弃，下一次读取必须走磁盘。返回是否成功。
+inline bool EvictFromPageCache(const std::filesystem::path& root) {
+#ifdef _WIN32
+  (void)root;
+  return false;
+#else
+  bool evicted = true;
+  for (const auto& entry :
+       std::filesystem::recursive_directory_iterator(root)) {
+    if (!entry.is_regular_file()) {
+      continue;
+    }
+    const int fd = open(entry.path().c_str(), O_RDONLY);
+    if (fd < 0) {
+      evicted = false;
+      continue;
+    }
+    fdatasync(fd);
+    evicted &= posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    close(fd);
+  }
+  return evicted;
+#endif
+}
+
+// 当前进程的常驻内存（工作集）字节数，读取失败时返回 0。
+inline uint64_t CurrentResidentBytes() {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters = {};
+  if (!K32GetProcessMemoryInfo(GetCurrentProcess(), &counters,
+                               sizeof(counters))) {
+    return 0;
+  }
+  return counters.WorkingSetSize;
+#else
+  std::ifstream statm("/proc/self/statm");
+  uint64_t pages = 0;
+  uint64_t resident_pages = 0;
+  if (!(statm >> pages >> resident_pages)) {
+    return 0;
+  }
+  return resident_pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+// 堆上已分配未释放的字节数，不支持的平台返回 0。与常驻内存不同，
+// 已释放但分配器尚未归还系统的内存不计入，适合测量一个结构的大小。
+inline uint64_t CurrentHeapBytes() {
+#if defined(_WIN32)
+  HEAP_SUMMARY summary = {};
+  summary.cb = sizeof(summary);
+  if (!HeapSummary(GetProcessHeap(), 0, &summary)) {
+    return 0;
+  }
+  return summary.cbAllocated;
+#elif defined(__GLIBC__)
+  const struct mallinfo2 info = mallinfo2();
+  return info.uordblks + info.hblkhd;
+#else
+  return 0;
+#endif
+}
+
+// PEM 中第一张证书的 DER。
+inline std::vector<uint8_t> ReadBenchCertificate() {
+  const std::vector<uint8_t> pem = ReadBenchFile(RUNNER_CORE_TEST_CERTIFICATE);
+  const std::string text(pem.begin(), pem.end());
+  static constexpr char kAlphabet[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  const size_t start = text.find('\n');
+  const size_t end = text.find("-----END");
+  std::vector<uint8_t> der;
+  uint32_t bits = 0;
+  int bit_count = 0;
+  for (size_t i = start; i < end && i < text.size(); ++i) {
+    const char* digit = std::strchr(kAlphabet, text[i]);
+    if (text[i] == '\0' || digit == nullptr) {
+      continue;
+    }
+    bits = (bits << 6) | static_cast<uint32_t>(digit - kAlphabet);
+    bit_count += 6;
+    if (bit_count >= 8) {
+      bit_count -= 8;
+      der.push_back(static_cast<uint8_t>(bits >> bit_count));
+    }
+  }
+  return der;
+}
+
+#endif  // RUNNER_CORE_BENCH_BENCH_UTILS_H_
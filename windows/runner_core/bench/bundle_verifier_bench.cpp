@@ -0,0 +1,142 @@
+// 安装包完整性校验：按正式包的规模生成 data\ 目录，分别测冷启动（页缓存
+// 里没有这些文件）和热启动（指纹缓存命中）。
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_utils.h"
+#include "bundle_verifier.h"
+#include "xxhash64.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// 内容取自一块 1 MB 的随机数据，|seed| 决定起点，各文件内容互不相同。
+void WriteFileOfSize(const fs::path& path, size_t size, uint32_t seed) {
+  static const std::vector<char> noise = [] {
+    std::vector<char> block(1u << 20);
+    std::mt19937 rng(1);
+    for (auto& byte : block) {
+      byte = static_cast<char>(rng());
+    }
+    return block;
+  }();
+  fs::create_directories(path.parent_path());
+  std::ofstream out(path, std::ios::binary);
+  size_t offset = (seed * 7919u) % noise.size();
+  while (size > 0) {
+    const size_t chunk = std::min(size, noise.size() - offset);
+    out.write(noise.data() + offset, static_cast<std::streamsize>(chunk));
+    size -= chunk;
+    offset = 0;
+  }
+}
+
+// 与发布版 data\ 相同的构成：AOT 快照、完整 ICU 数据、字体和着色器，
+// 以及 |asset_count| 个资源文件。资源大小取对数正态分布，中位数
+// 160 KB，与仓库 assets/ 下的图片接近。
+fs::path MakeReleaseBundle(int asset_count, uint64_t* total_bytes) {
+  const fs::path root =
+      BenchDirectory(("bundle_" + std::to_string(asset_count)).c_str()) /
+      "data";
+  struct File {
+    const char* path;
+    size_t size;
+  };
+  const File fixed[] = {
+      {"app.so", 32u << 20},
+      {"icudtl.dat", 10u << 20},
+      {"flutter_assets/fonts/MaterialIcons-Regular.otf", 1645184},
+      {"flutter_assets/assets/fonts/NotoSansSC-Regular.ttf", 2171336},
+      {"flutter_assets/NOTICES.Z", 118000},
+      {"flutter_assets/AssetManifest.bin", 9000},
+      {"flutter_assets/FontManifest.json", 400},
+      {"flutter_assets/shaders/ink_sparkle.frag", 10200},
+  };
+  *total_bytes = 0;
+  uint32_t seed = 1;
+  for (const File& file : fixed) {
+    WriteFileOfSize(root / file.path, file.size, seed++);
+    *total_bytes += file.size;
+  }
+  std::mt19937 rng(7);
+  std::lognormal_distribution<double> size_distribution(std::log(160000.0),
+                                                        1.0);
+  for (int i = 0; i < asset_count; ++i) {
+    const size_t size = static_cast<size_t>(
+        std::min(size_distribution(rng), static_cast<double>(4u << 20)));
+    WriteFileOfSize(root / "flutter_assets" / "assets" /
+                        ("dir_" + std::to_string(i % 24)) /
+                        ("asset_" + std::to_string(i) + ".png"),
+                    size, seed++);
+    *total_bytes += size;
+  }
+  return root;
+}
+
+}  // namespace
+
+// 冷启动：每轮都重新计算全部文件的哈希，计时前丢弃页缓存。
+static void BM_VerifyBundleCold(benchmark::State& state) {
+  uint64_t total_bytes = 0;
+  const fs::path root =
+      MakeReleaseBundle(static_cast<int>(state.range(0)), &total_bytes);
+  BundleManifest manifest;
+  BuildBundleManifest(root, &manifest);
+  bool evicted = true;
+  uint64_t bytes = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    evicted &= EvictFromPageCache(root);
+    state.ResumeTiming();
+    const auto result = VerifyBundle(root, manifest, nullptr);
+    bytes += result.hashed_bytes;
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(bytes));
+  state.counters["files"] = static_cast<double>(manifest.size());
+  state.counters["bundle_mb"] = static_cast<double>(total_bytes) / (1 << 20);
+  state.SetLabel(evicted ? "page cache dropped" : "page cache warm");
+}
+BENCHMARK(BM_VerifyBundleCold)
+    ->Arg(300)
+    ->Arg(1500)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// 热启动：指纹缓存命中，只比对大小和修改时间。
+static void BM_VerifyBundleWarm(benchmark::State& state) {
+  uint64_t total_bytes = 0;
+  const fs::path root =
+      MakeReleaseBundle(static_cast<int>(state.range(0)), &total_bytes);
+  BundleManifest manifest;
+  BuildBundleManifest(root, &manifest);
+  BundleFingerprintCache cache;
+  VerifyBundle(root, manifest, &cache);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(VerifyBundle(root, manifest, &cache));
+  }
+  state.counters["files"] = static_cast<double>(manifest.size());
+}
+BENCHMARK(BM_VerifyBundleWarm)
+    ->Arg(300)
+    ->Arg(1500)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+static void BM_XxHash64(benchmark::State& state) {
+  const std::vector<uint8_t> data(static_cast<size_t>(state.range(0)), 0x5A);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(XxHash64(data.data(), data.size()));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range(0));
+}
+BENCHMARK(BM_XxHash64)->Arg(1 << 10)->Arg(1 << 20);
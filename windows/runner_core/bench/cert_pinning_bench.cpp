@@ -0,0 +1,92 @@
+// 证书固定：缓存键的开销，以及大量不同证书下 Check 的开销和命中率。
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "bench_utils.h"
+#include "cert_pinning.h"
+#include "sha256.h"
+#include "xxhash64.h"
+
+namespace {
+
+// 改写签名末尾的字节得到 |count| 张不同的证书，公钥不变，仍能正常解析。
+std::vector<std::vector<uint8_t>> DistinctCertificates(size_t count) {
+  const std::vector<uint8_t> der = ReadBenchCertificate();
+  std::vector<std::vector<uint8_t>> certificates(count, der);
+  for (size_t i = 0; i < count; ++i) {
+    auto& certificate = certificates[i];
+    for (size_t b = 0; b < 4; ++b) {
+      certificate[certificate.size() - 1 - b] =
+          static_cast<uint8_t>(i >> (8 * b));
+    }
+  }
+  return certificates;
+}
+
+}  // namespace
+
+// 依次校验 |range(0)| 张不同的证书。缓存上限为默认的 1024 张，超过时
+// 每轮都会清空，相当于全部未命中。
+static void BM_CertificatePinnerCheck(benchmark::State& state) {
+  const auto certificates =
+      DistinctCertificates(static_cast<size_t>(state.range(0)));
+  Sha256Digest pin{};
+  ComputeSpkiDigest(certificates[0].data(), certificates[0].size(), &pin);
+  CertificatePinner pinner;
+  pinner.AddPin("*.example.com", pin);
+  const std::string host = "api.example.com";
+  size_t next = 0;
+  for (auto _ : state) {
+    const auto& certificate = certificates[next];
+    benchmark::DoNotOptimize(
+        pinner.Check(host, certificate.data(), certificate.size()));
+    next = next + 1 == certificates.size() ? 0 : next + 1;
+  }
+  const double lookups =
+      static_cast<double>(pinner.cache_hits() + pinner.cache_misses());
+  state.counters["hit_rate"] =
+      lookups > 0 ? static_cast<double>(pinner.cache_hits()) / lookups : 0;
+}
+BENCHMARK(BM_CertificatePinnerCheck)->Arg(1)->Arg(1000)->Arg(5000);
+
+// 未命中时的开销：DER 解析加 SPKI 哈希。
+static void BM_ComputeSpkiDigestDistinct(benchmark::State& state) {
+  const auto certificates = DistinctCertificates(5000);
+  Sha256Digest digest{};
+  size_t next = 0;
+  for (auto _ : state) {
+    const auto& certificate = certificates[next];
+    benchmark::DoNotOptimize(
+        ComputeSpkiDigest(certificate.data(), certificate.size(), &digest));
+    next = next + 1 == certificates.size() ? 0 : next + 1;
+  }
+}
+BENCHMARK(BM_ComputeSpkiDigestDistinct);
+
+// 缓存键：当前的 XXH64 与原先整张证书的 SHA-256 对比。
+static void BM_CertificateCacheKey(benchmark::State& state) {
+  const std::vector<uint8_t> der = ReadBenchCertificate();
+  const bool sha256 = state.range(0) != 0;
+  for (auto _ : state) {
+    if (sha256) {
+      benchmark::DoNotOptimize(Sha256::Hash(der.data(), der.size()));
+    } else {
+      benchmark::DoNotOptimize(XxHash64(der.data(), der.size()));
+    }
+  }
+  state.SetLabel(sha256 ? "sha256" : "xxh64");
+}
+BENCHMARK(BM_CertificateCacheKey)->Arg(0)->Arg(1);
+
+static void BM_Sha256(benchmark::State& state) {
+  const std::vector<uint8_t> data(static_cast<size_t>(state.range(0)), 0x5A);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Sha256::Hash(data.data(), data.size()));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range(0));
+  state.SetLabel(Sha256::IsHardwareAccelerated() ? "sha-ni" : "scalar");
+}
+BENCHMARK(BM_Sha256)->Arg(1 << 10)->Arg(1 << 20);
@@ -0,0 +1,38 @@
+// 预初始化检查调度的开销：检查本身不做事，只计调度、依赖解析和回调。
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+
+#include "check_scheduler.h"
+
+namespace {
+
+// 与 PreInitWindow 相同的形状：架构 -> 运行库 -> 网络，架构 -> 资源，
+// 外加一个独立的存储检查。其余检查依次挂在前面的检查后面。
+void AddChecks(CheckScheduler* scheduler, int count) {
+  const auto pass = [] { return CheckResult::Pass(); };
+  const auto architecture = scheduler->AddCheck(L"architecture", pass);
+  const auto runtime = scheduler->AddCheck(L"runtime", pass, {architecture});
+  scheduler->AddCheck(L"storage", pass);
+  scheduler->AddCheck(L"resources", pass, {architecture});
+  scheduler->AddCheck(L"network", pass, {runtime});
+  for (int i = 5; i < count; ++i) {
+    scheduler->AddCheck(L"extra", pass,
+                        {static_cast<CheckScheduler::CheckId>(i / 2)});
+  }
+}
+
+}  // namespace
+
+static void BM_CheckSchedulerRun(benchmark::State& state) {
+  for (auto _ : state) {
+    CheckScheduler scheduler;
+    AddChecks(&scheduler, static_cast<int>(state.range(0)));
+    scheduler.Start([](CheckScheduler::CheckId, CheckStatus) {}, nullptr);
+    scheduler.WaitForCompletion(std::chrono::seconds(5));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range(0));
+}
+BENCHMARK(BM_CheckSchedulerRun)->Arg(5)->Arg(64)->Unit(benchmark::kMicrosecond);
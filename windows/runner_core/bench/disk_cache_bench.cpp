@@ -0,0 +1,128 @@
+// 10 万条目的磁盘缓存：查询、写满后的淘汰和打开。
+//
+// 缓存只在进程内建一次（写 10 万个内容文件要几秒），建好后的索引由
+// 各个基准共用。
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "bench_utils.h"
+#include "disk_cache.h"
+
+namespace {
+
+constexpr int kEntryCount = 100000;
+constexpr size_t kEntrySize = 256;
+
+std::string EntryKey(int i) {
+  return "https://img.example.com/games/" + std::to_string(i) + "/cover.webp";
+}
+
+std::string EntryData(int i) {
+  std::string data(kEntrySize, 'x');
+  const std::string tag = std::to_string(i);
+  data.replace(0, tag.size(), tag);
+  return data;
+}
+
+DiskCache::Options CacheOptions() {
+  DiskCache::Options options;
+  options.max_bytes = 1ull << 30;
+  // 16 个分片各 8192 个槽位，最多 114688 个条目
+  options.max_entries = kEntryCount;
+  return options;
+}
+
+struct FilledCache {
+  std::filesystem::path directory;
+  std::unique_ptr<DiskCache> cache;
+  double fill_seconds = 0;
+};
+
+FilledCache& SharedCache() {
+  static FilledCache* filled = [] {
+    auto* result = new FilledCache();
+    result->directory = BenchDirectory("disk_cache");
+    result->cache =
+        std::make_unique<DiskCache>(result->directory, CacheOptions());
+    result->cache->Open();
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kEntryCount; ++i) {
+      const std::string data = EntryData(i);
+      result->cache->Put(EntryKey(i), data.data(), data.size(), 0);
+    }
+    result->cache->Flush();
+    result->fill_seconds = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+    return result;
+  }();
+  return *filled;
+}
+
+}  // namespace
+
+static void BM_DiskCacheLookupHit(benchmark::State& state) {
+  DiskCache& cache = *SharedCache().cache;
+  DiskCache::Entry entry;
+  int i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cache.Lookup(EntryKey(i), &entry));
+    i = (i + 7919) % kEntryCount;
+  }
+  state.counters["fill_s"] = SharedCache().fill_seconds;
+}
+BENCHMARK(BM_DiskCacheLookupHit);
+
+static void BM_DiskCacheLookupMiss(benchmark::State& state) {
+  DiskCache& cache = *SharedCache().cache;
+  DiskCache::Entry entry;
+  int i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cache.Lookup(EntryKey(kEntryCount + i), &entry));
+    ++i;
+  }
+}
+BENCHMARK(BM_DiskCacheLookupMiss);
+
+// 索引已满，每次写入淘汰一个最久未用的条目并删除其内容文件。
+static void BM_DiskCachePutEvict(benchmark::State& state) {
+  DiskCache& cache = *SharedCache().cache;
+  // 先写满到开始淘汰
+  int next = kEntryCount;
+  while (cache.stats().evictions == 0) {
+    const std::string data = EntryData(next);
+    cache.Put(EntryKey(next), data.data(), data.size(), 0);
+    ++next;
+  }
+  const uint64_t evictions_before = cache.stats().evictions;
+  for (auto _ : state) {
+    const std::string data = EntryData(next);
+    cache.Put(EntryKey(next), data.data(), data.size(), 0);
+    ++next;
+  }
+  state.counters["evictions"] = static_cast<double>(
+      cache.stats().evictions - evictions_before);
+  state.counters["entries"] = static_cast<double>(cache.stats().entries);
+}
+BENCHMARK(BM_DiskCachePutEvict);
+
+// 打开已有的 10 万条目索引（映射、校验并重建探测链和 LRU）。
+static void BM_DiskCacheOpen(benchmark::State& state) {
+  // 打开会重写索引，在副本上进行，不影响共用的缓存
+  SharedCache().cache->Flush();
+  const std::filesystem::path directory = BenchDirectory("disk_cache_open");
+  std::filesystem::copy_file(SharedCache().directory / "index.bin",
+                             directory / "index.bin");
+  for (auto _ : state) {
+    DiskCache cache(directory, CacheOptions());
+    benchmark::DoNotOptimize(cache.Open());
+  }
+  state.counters["entries"] =
+      static_cast<double>(SharedCache().cache->stats().entries);
+}
+BENCHMARK(BM_DiskCacheOpen)->Unit(benchmark::kMillisecond);
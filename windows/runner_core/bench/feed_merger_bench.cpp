@@ -0,0 +1,139 @@
+// 动态时间线合并：已有 1 万条时合并一页、乱序页、整体刷新和删除。
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "feed_merger.h"
+
+namespace {
+
+constexpr uint32_t kTimeline = 10000;
+constexpr uint32_t kPage = 20;
+
+// 1 万条，200 个用户、8 种类型，时间间隔 10 秒。
+std::vector<FeedMerger::Item> Timeline() {
+  std::mt19937 rng(7);
+  std::vector<FeedMerger::Item> items(kTimeline);
+  for (uint32_t i = 0; i < kTimeline; ++i) {
+    items[i].id = i + 1;
+    items[i].user = rng() % 200;
+    items[i].type = rng() % 8;
+    items[i].timestamp = 1700000000000 - static_cast<int64_t>(i) * 10000;
+  }
+  return items;
+}
+
+}  // namespace
+
+static void BM_FeedMergerReplace(benchmark::State& state) {
+  const std::vector<FeedMerger::Item> items = Timeline();
+  std::vector<FeedMerger::Op> ops;
+  for (auto _ : state) {
+    FeedMerger merger;
+    ops.clear();
+    merger.Replace(items.data(), items.size(), &ops);
+    benchmark::DoNotOptimize(ops.data());
+  }
+  state.counters["ops"] = static_cast<double>(ops.size());
+}
+BENCHMARK(BM_FeedMergerReplace)->Unit(benchmark::kMillisecond);
+
+// 合并一页 20 条新条目。参数 0：最新一页，插在最前面；1：下拉加载到
+// 时间线中间的一页（乱序到达）；2：一页都是已有条目且内容未变。
+static void BM_FeedMergerMergePage(benchmark::State& state) {
+  const std::vector<FeedMerger::Item> items = Timeline();
+  FeedMerger merger;
+  std::vector<FeedMerger::Op> ops;
+  merger.Replace(items.data(), items.size(), &ops);
+  std::mt19937 rng(3);
+  std::vector<FeedMerger::Item> page(kPage);
+  const size_t page_size = page.size();
+  uint32_t next_id = kTimeline + 1;
+  size_t total_ops = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    const int64_t newest = state.range(0) == 0
+                               ? 1700000000000 + 1000000
+                               : 1700000000000 - 5000 * 10000 - 5;
+    for (uint32_t i = 0; i < kPage; ++i) {
+      if (state.range(0) == 2) {
+        page[i] = items[(rng() % (kTimeline / kPage)) * kPage + i];
+      } else {
+        page[i].id = next_id++;
+        page[i].user = rng() % 200;
+        page[i].type = rng() % 8;
+        page[i].timestamp = newest - i * 10;
+      }
+    }
+    ops.clear();
+    state.ResumeTiming();
+    merger.Merge(page.data(), &page_size, 1, &ops);
+    state.PauseTiming();
+    total_ops += ops.size();
+    if (state.range(0) != 2) {
+      for (const FeedMerger::Item& item : page) {
+        merger.Remove(item.id, &ops);
+      }
+    }
+    state.ResumeTiming();
+  }
+  static const char* kLabels[] = {"newest page", "middle page", "unchanged"};
+  state.SetLabel(kLabels[state.range(0)]);
+  state.counters["ops"] = static_cast<double>(total_ops) /
+                          static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_FeedMergerMergePage)->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
+
+// 下拉刷新：整体替换为新的 1 万条，其中 1% 的条目版本变化，最新的
+// 20 条是新条目，最旧的 20 条被挤出。
+static void BM_FeedMergerRefresh(benchmark::State& state) {
+  const std::vector<FeedMerger::Item> items = Timeline();
+  std::vector<FeedMerger::Item> refreshed(items.begin(), items.end() - kPage);
+  std::mt19937 rng(5);
+  for (auto& item : refreshed) {
+    if (rng() % 100 == 0) {
+      item.version = 1;
+    }
+  }
+  for (uint32_t i = 0; i < kPage; ++i) {
+    FeedMerger::Item item;
+    item.id = kTimeline + 1 + i;
+    item.user = rng() % 200;
+    item.timestamp = 1700000000000 + 1000 * (i + 1);
+    refreshed.push_back(item);
+  }
+  std::vector<FeedMerger::Op> ops;
+  size_t op_count = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    FeedMerger merger;
+    merger.Replace(items.data(), items.size(), &ops);
+    ops.clear();
+    state.ResumeTiming();
+    merger.Replace(refreshed.data(), refreshed.size(), &ops);
+    op_count = ops.size();
+  }
+  state.counters["ops"] = static_cast<double>(op_count);
+}
+BENCHMARK(BM_FeedMergerRefresh)->Unit(benchmark::kMicrosecond);
+
+static void BM_FeedMergerRemove(benchmark::State& state) {
+  const std::vector<FeedMerger::Item> items = Timeline();
+  FeedMerger merger;
+  std::vector<FeedMerger::Op> ops;
+  merger.Replace(items.data(), items.size(), &ops);
+  uint32_t i = 0;
+  for (auto _ : state) {
+    const FeedMerger::Item& item = items[(i++ * 7919) % kTimeline];
+    ops.clear();
+    merger.Remove(item.id, &ops);
+    state.PauseTiming();
+    std::vector<size_t> one = {1};
+    merger.Merge(&item, one.data(), 1, &ops);
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(BM_FeedMergerRemove)->Unit(benchmark::kMicrosecond);
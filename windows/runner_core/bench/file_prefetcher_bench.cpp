@@ -0,0 +1,207 @@
+// 预读对首帧时间的影响：按发布版的规模生成 data\ 目录，丢弃页缓存后
+// 模拟启动——预检查窗口之后引擎第一次读取首帧要用的文件——分别测不预读、
+// 预读和热启动（页缓存里已有这些文件）。
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "bench_utils.h"
+#include "bundle_resources.h"
+#include "file_prefetcher.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr uint64_t kMaxPrefetchBytes = 256ull << 20;  // 与 main.cpp 相同
+constexpr int kAssetCount = 300;
+// 首页用到的图片数
+constexpr int kFirstFrameAssets = 24;
+
+void WriteFileOfSize(const fs::path& path, size_t size, uint32_t seed) {
+  fs::create_directories(path.parent_path());
+  std::vector<char> block(1u << 20);
+  std::mt19937 rng(seed);
+  for (auto& byte : block) {
+    byte = static_cast<char>(rng());
+  }
+  std::ofstream out(path, std::ios::binary);
+  while (size > 0) {
+    const size_t chunk = std::min(size, block.size());
+    out.write(block.data(), static_cast<std::streamsize>(chunk));
+    size -= chunk;
+  }
+}
+
+fs::path AssetPath(int index) {
+  return fs::path("data") / "flutter_assets" / "assets" /
+         ("dir_" + std::to_string(index % 24)) /
+         ("asset_" + std::to_string(index) + ".png");
+}
+
+// 与发布版相同的构成：32 MB 的 AOT 快照、完整 ICU 数据、仓库里的
+// NotoSansSC，以及 |kAssetCount| 个大小取对数正态分布的资源。只生成一次。
+const fs::path& ReleaseInstall() {
+  static const fs::path root = [] {
+    const fs::path root = BenchDirectory("prefetch_install");
+    const fs::path data = root / "data";
+    WriteFileOfSize(data / "app.so", 32u << 20, 1);
+    WriteFileOfSize(data / "icudtl.dat", 10u << 20, 2);
+    const fs::path font =
+        data / "flutter_assets" / "assets" / "fonts" / "NotoSansSC-Regular.ttf";
+    fs::create_directories(font.parent_path());
+    fs::copy_file(RUNNER_CORE_TEST_FONT, font);
+    WriteFileOfSize(data / "flutter_assets" / "AssetManifest.bin", 9000, 3);
+    WriteFileOfSize(data / "flutter_assets" / "FontManifest.json", 400, 4);
+    std::mt19937 rng(7);
+    std::lognormal_distribution<double> size_distribution(std::log(160000.0),
+                                                          1.0);
+    for (int i = 0; i < kAssetCount; ++i) {
+      WriteFileOfSize(root / AssetPath(i),
+                      static_cast<size_t>(std::min(
+                          size_distribution(rng), static_cast<double>(4u << 20))),
+                      100 + i);
+    }
+    return root;
+  }();
+  return root;
+}
+
+// 按 |order| 以 64 KB 为单位读取 |path| 的 |fraction|，模拟映射文件的缺页
+// （每次缺页预读 64 KB 左右）。返回读取的字节数。
+uint64_t TouchFile(const fs::path& path, double fraction, std::mt19937* rng) {
+  constexpr size_t kChunk = 64u << 10;
+  std::vector<char> buffer(kChunk);
+#ifdef _WIN32
+  std::ifstream in(path, std::ios::binary);
+  const uint64_t size = fs::file_size(path);
+  std::vector<uint64_t> offsets;
+  for (uint64_t offset = 0; offset < size; offset += kChunk) {
+    offsets.push_back(offset);
+  }
+  std::shuffle(offsets.begin(), offsets.end(), *rng);
+  offsets.resize(static_cast<size_t>(offsets.size() * fraction));
+  uint64_t total = 0;
+  for (uint64_t offset : offsets) {
+    in.seekg(static_cast<std::streamoff>(offset));
+    in.read(buffer.data(), kChunk);
+    total += static_cast<uint64_t>(in.gcount());
+    in.clear();
+  }
+  return total;
+#else
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return 0;
+  }
+  // 关掉内核的顺序预读，读取量只由缺页决定
+  posix_fadvise(fd, 0, 0, POSIX_FADV_RANDOM);
+  const uint64_t size = fs::file_size(path);
+  std::vector<uint64_t> offsets;
+  for (uint64_t offset = 0; offset < size; offset += kChunk) {
+    offsets.push_back(offset);
+  }
+  std::shuffle(offsets.begin(), offsets.end(), *rng);
+  offsets.resize(static_cast<size_t>(offsets.size() * fraction));
+  uint64_t total = 0;
+  for (uint64_t offset : offsets) {
+    const ssize_t read_size =
+        pread(fd, buffer.data(), kChunk, static_cast<off_t>(offset));
+    if (read_size > 0) {
+      total += static_cast<uint64_t>(read_size);
+    }
+  }
+  close(fd);
+  return total;
+#endif
+}
+
+// 引擎画出首帧前读取的文件：AOT 快照的大部分、ICU 数据的一部分、整个
+// 字体、两个清单文件和首页的图片。
+uint64_t FirstFrameTouch(const fs::path& root) {
+  std::mt19937 rng(11);
+  const fs::path data = root / "data";
+  uint64_t bytes = TouchFile(data / "app.so", 0.8, &rng);
+  bytes += TouchFile(data / "icudtl.dat", 0.25, &rng);
+  bytes += TouchFile(data / "flutter_assets" / "AssetManifest.bin", 1.0, &rng);
+  bytes += TouchFile(data / "flutter_assets" / "FontManifest.json", 1.0, &rng);
+  bytes += TouchFile(data / "flutter_assets" / "assets" / "fonts" /
+                         "NotoSansSC-Regular.ttf",
+                     1.0, &rng);
+  for (int i = 0; i < kFirstFrameAssets; ++i) {
+    bytes += TouchFile(root / AssetPath(i * 7), 1.0, &rng);
+  }
+  return bytes;
+}
+
+}  // namespace
+
+// 参数：cold 为 1 时每轮先丢弃页缓存；prefetch 为 1 时在预检查开始时
+// 启动 FilePrefetcher；precheck_ms 是预检查窗口的时长，预读与它并行。
+// 计时从进程启动（预检查开始）到首帧要用的文件读完。
+static void BM_TimeToFirstFrame(benchmark::State& state) {
+  const bool cold = state.range(0) != 0;
+  const bool prefetch = state.range(1) != 0;
+  const auto precheck = std::chrono::milliseconds(state.range(2));
+  const fs::path& root = ReleaseInstall();
+  std::vector<fs::path> entries;
+  for (const auto& resource : PrefetchBundleResources()) {
+    entries.push_back(resource);
+  }
+  bool evicted = true;
+  uint64_t touched = 0;
+  double touch_ms = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    if (cold) {
+      evicted &= EvictFromPageCache(root);
+    } else {
+      FirstFrameTouch(root);
+    }
+    state.ResumeTiming();
+
+    FilePrefetcher prefetcher;
+    if (prefetch) {
+      prefetcher.Start(root, entries, kMaxPrefetchBytes);
+    }
+    std::this_thread::sleep_for(precheck);
+    const auto touch_begin = std::chrono::steady_clock::now();
+    touched = FirstFrameTouch(root);
+    touch_ms += std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - touch_begin)
+                    .count();
+
+    state.PauseTiming();
+    prefetcher.Stop();
+    state.ResumeTiming();
+  }
+  state.counters["touch_ms"] =
+      touch_ms / static_cast<double>(state.iterations());
+  state.counters["touched_mb"] = static_cast<double>(touched) / (1 << 20);
+  state.SetLabel(!cold ? "warm" : evicted ? "page cache dropped"
+                                          : "page cache warm");
+}
+BENCHMARK(BM_TimeToFirstFrame)
+    ->ArgNames({"cold", "prefetch", "precheck_ms"})
+    ->Args({1, 0, 0})
+    ->Args({1, 1, 0})
+    ->Args({1, 0, 300})
+    ->Args({1, 1, 300})
+    ->Args({0, 0, 300})
+    ->Iterations(5)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
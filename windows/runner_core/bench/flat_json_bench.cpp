@@ -0,0 +1,206 @@
+// JSON 解码：扁平布局对比逐个节点建树的解码（与 Dart 的 jsonDecode 一样，
+// 每个对象、数组和字符串都是一次堆分配），并统计每次解码的分配次数。
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "flat_json.h"
+
+namespace {
+
+thread_local uint64_t g_allocations = 0;
+
+}  // namespace
+
+// 统计本线程的 operator new 次数，两种解码器在同一口径下比较。
+void* operator new(size_t size) {
+  ++g_allocations;
+  void* p = std::malloc(size ? size : 1);
+  if (!p) {
+    std::abort();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  std::free(p);
+}
+
+namespace {
+
+std::string GameListJson(int count) {
+  std::string json = "{\"games\":[";
+  for (int i = 0; i < count; ++i) {
+    if (i > 0) {
+      json += ',';
+    }
+    json += "{\"id\":\"65f0c1a2b3c4d5e6f7a8" + std::to_string(1000 + i) +
+            "\",\"title\":\"塞尔达传说 旷野之息\",\"category\":\"action\","
+            "\"tags\":[\"开放世界\",\"冒险\"],\"rating\":4.5,\"viewCount\":" +
+            std::to_string(i * 37) +
+            ",\"summary\":\"\\u300c\\u5e7f\\u9614\\u4e16\\u754c\\u300d "
+            "line\\nbreak\",\"published\":true}";
+  }
+  return json + "]}";
+}
+
+// 与 jsonDecode 产物对应的树：每个节点一个对象，容器和字符串各自分配。
+struct DomValue {
+  enum Type { kNull, kBool, kInt, kDouble, kString, kArray, kObject };
+  Type type = kNull;
+  bool boolean = false;
+  int64_t integer = 0;
+  double real = 0;
+  std::string string;
+  std::vector<std::unique_ptr<DomValue>> elements;
+  std::vector<std::pair<std::string, std::unique_ptr<DomValue>>> members;
+};
+
+// 只处理格式正确的输入，基准数据由上面的函数生成。
+class DomParser {
+ public:
+  explicit DomParser(const std::string& json) : p_(json.data()) {}
+
+  std::unique_ptr<DomValue> Parse() {
+    auto value = std::make_unique<DomValue>();
+    SkipWhitespace();
+    switch (*p_) {
+      case '{':
+        value->type = DomValue::kObject;
+        ++p_;
+        while (SkipWhitespace(), *p_ != '}') {
+          std::string key = ParseString();
+          SkipWhitespace();
+          ++p_;  // ':'
+          value->members.emplace_back(std::move(key), Parse());
+          SkipWhitespace();
+          if (*p_ == ',') {
+            ++p_;
+          }
+        }
+        ++p_;
+        break;
+      case '[':
+        value->type = DomValue::kArray;
+        ++p_;
+        while (SkipWhitespace(), *p_ != ']') {
+          value->elements.push_back(Parse());
+          SkipWhitespace();
+          if (*p_ == ',') {
+            ++p_;
+          }
+        }
+        ++p_;
+        break;
+      case '"':
+        value->type = DomValue::kString;
+        value->string = ParseString();
+        break;
+      case 't':
+      case 'f':
+        value->type = DomValue::kBool;
+        value->boolean = *p_ == 't';
+        p_ += value->boolean ? 4 : 5;
+        break;
+      case 'n':
+        p_ += 4;
+        break;
+      default: {
+        char* end = nullptr;
+        const double number = std::strtod(p_, &end);
+        bool is_integer = true;
+        for (const char* c = p_; c < end; ++c) {
+          is_integer &= *c != '.' && *c != 'e' && *c != 'E';
+        }
+        value->type = is_integer ? DomValue::kInt : DomValue::kDouble;
+        value->integer = static_cast<int64_t>(number);
+        value->real = number;
+        p_ = end;
+        break;
+      }
+    }
+    return value;
+  }
+
+ private:
+  void SkipWhitespace() {
+    while (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t') {
+      ++p_;
+    }
+  }
+
+  std::string ParseString() {
+    std::string out;
+    ++p_;
+    while (*p_ != '"') {
+      if (*p_ != '\\') {
+        out.push_back(*p_++);
+        continue;
+      }
+      const char escape = p_[1];
+      p_ += 2;
+      if (escape == 'u') {
+        const uint32_t code_point =
+            static_cast<uint32_t>(std::strtoul(std::string(p_, 4).c_str(),
+                                               nullptr, 16));
+        p_ += 4;
+        out.push_back(static_cast<char>(0xE0 | code_point >> 12));
+        out.push_back(static_cast<char>(0x80 | (code_point >> 6 & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+      } else {
+        out.push_back(escape == 'n' ? '\n' : escape);
+      }
+    }
+    ++p_;
+    return out;
+  }
+
+  const char* p_;
+};
+
+}  // namespace
+
+static void BM_ParseFlatJson(benchmark::State& state) {
+  const std::string json = GameListJson(static_cast<int>(state.range(0)));
+  std::vector<uint8_t> output;
+  uint64_t allocations = 0;
+  for (auto _ : state) {
+    // 每轮新建缓冲区，和 FFI 入口一样把结果交给调用方
+    std::vector<uint8_t>().swap(output);
+    const uint64_t before = g_allocations;
+    ParseFlatJson(reinterpret_cast<const uint8_t*>(json.data()), json.size(),
+                  &output, nullptr);
+    allocations = g_allocations - before;
+    benchmark::DoNotOptimize(output.data());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(json.size()));
+  state.counters["allocs"] = static_cast<double>(allocations);
+  state.counters["out_kb"] = static_cast<double>(output.size()) / 1024;
+}
+BENCHMARK(BM_ParseFlatJson)->Arg(20)->Arg(1000)->Arg(20000);
+
+static void BM_ParseJsonTree(benchmark::State& state) {
+  const std::string json = GameListJson(static_cast<int>(state.range(0)));
+  uint64_t allocations = 0;
+  for (auto _ : state) {
+    const uint64_t before = g_allocations;
+    std::unique_ptr<DomValue> root = DomParser(json).Parse();
+    allocations = g_allocations - before;
+    benchmark::DoNotOptimize(root.get());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(json.size()));
+  state.counters["allocs"] = static_cast<double>(allocations);
+}
+BENCHMARK(BM_ParseJsonTree)->Arg(20)->Arg(1000)->Arg(20000);
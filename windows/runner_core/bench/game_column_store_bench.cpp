@@ -0,0 +1,139 @@
+// 游戏列表的列式存储：5 万款游戏上的筛选、排序和分页。
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_utils.h"
+#include "game_column_store.h"
+
+namespace {
+
+constexpr size_t kGames = 50000;
+
+// 分类 12 个，标签 200 个（按 Zipf 分布取，每款 1 到 5 个）。
+struct Catalog {
+  std::vector<std::string> categories;
+  std::vector<std::string> tags;
+  std::vector<GameRecord> records;
+};
+
+const Catalog& SharedCatalog() {
+  static const Catalog catalog = [] {
+    Catalog c;
+    for (int i = 0; i < 12; ++i) {
+      c.categories.push_back("category_" + std::to_string(i));
+    }
+    for (int i = 0; i < 200; ++i) {
+      c.tags.push_back("标签" + std::to_string(i));
+    }
+    std::vector<double> weights(c.tags.size());
+    for (size_t i = 0; i < weights.size(); ++i) {
+      weights[i] = 1.0 / static_cast<double>(i + 1);
+    }
+    std::discrete_distribution<size_t> zipf(weights.begin(), weights.end());
+    std::mt19937 rng(7);
+    c.records.resize(kGames);
+    for (uint32_t i = 0; i < kGames; ++i) {
+      GameRecord& record = c.records[i];
+      record.handle = i + 1;
+      record.create_time = 1700000000000 + static_cast<int64_t>(rng() % 100000000);
+      record.update_time = record.create_time + rng() % 1000000;
+      record.view_count = rng() % 100000;
+      record.like_count = rng() % 5000;
+      record.rating = (rng() % 101) / 20.0;
+      record.category = c.categories[rng() % c.categories.size()];
+      const int tag_count = 1 + static_cast<int>(rng() % 5);
+      for (int t = 0; t < tag_count; ++t) {
+        record.tags.push_back(c.tags[zipf(rng)]);
+      }
+    }
+    return c;
+  }();
+  return catalog;
+}
+
+}  // namespace
+
+static void BM_GameColumnStoreBuild(benchmark::State& state) {
+  const Catalog& catalog = SharedCatalog();
+  GameColumnStore::Stats stats;
+  uint64_t heap_bytes = 0;
+  for (auto _ : state) {
+    const uint64_t before = CurrentHeapBytes();
+    GameColumnStore store;
+    store.Upsert(catalog.records.data(), catalog.records.size());
+    // 第一次查询时按排序字段排好
+    std::vector<uint32_t> handles;
+    GameQuery query;
+    query.limit = 20;
+    store.Query(query, &handles);
+    stats = store.stats();
+    heap_bytes = CurrentHeapBytes() - before;
+  }
+  state.counters["index_kb"] = static_cast<double>(stats.index_bytes) / 1024;
+  state.counters["heap_mb"] = static_cast<double>(heap_bytes) / (1 << 20);
+}
+BENCHMARK(BM_GameColumnStoreBuild)->Unit(benchmark::kMillisecond);
+
+// 参数：0 不筛选，1 分类（约 1/12），2 常见标签，3 分类加少见标签。
+// 第二个参数为页码，每页 20 条。
+static void BM_GameColumnStoreQuery(benchmark::State& state) {
+  const Catalog& catalog = SharedCatalog();
+  GameColumnStore store;
+  store.Upsert(catalog.records.data(), catalog.records.size());
+  GameQuery query;
+  switch (state.range(0)) {
+    case 1:
+      query.category = catalog.categories[3];
+      break;
+    case 2:
+      query.tag = catalog.tags[0];
+      break;
+    case 3:
+      query.category = catalog.categories[3];
+      query.tag = catalog.tags[150];
+      break;
+  }
+  query.sort_key = GameSortKey::kViewCount;
+  query.offset = static_cast<size_t>(state.range(1)) * 20;
+  query.limit = 20;
+  std::vector<uint32_t> handles;
+  size_t total = 0;
+  for (auto _ : state) {
+    total = store.Query(query, &handles);
+    benchmark::DoNotOptimize(handles.data());
+  }
+  state.counters["matches"] = static_cast<double>(total);
+}
+BENCHMARK(BM_GameColumnStoreQuery)
+    ->ArgsProduct({{0, 1, 2, 3}, {0, 50}})
+    ->Unit(benchmark::kMicrosecond);
+
+// 刷新一页：20 款游戏的浏览数变化后重新查询第一页。
+static void BM_GameColumnStoreRefreshPage(benchmark::State& state) {
+  const Catalog& catalog = SharedCatalog();
+  GameColumnStore store;
+  store.Upsert(catalog.records.data(), catalog.records.size());
+  GameQuery query;
+  query.sort_key = GameSortKey::kViewCount;
+  query.limit = 20;
+  std::vector<uint32_t> handles;
+  store.Query(query, &handles);
+  std::vector<GameRecord> page(catalog.records.begin(),
+                               catalog.records.begin() + 20);
+  std::mt19937 rng(3);
+  for (auto _ : state) {
+    const size_t start = rng() % (kGames - 20);
+    for (size_t i = 0; i < page.size(); ++i) {
+      page[i] = catalog.records[start + i];
+      page[i].view_count = rng() % 100000;
+    }
+    store.Upsert(page.data(), page.size());
+    benchmark::DoNotOptimize(store.Query(query, &handles));
+  }
+}
+BENCHMARK(BM_GameColumnStoreRefreshPage)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,131 @@
+// 连接池的首字节时间：冷连接、预热连接和复用连接。
+//
+// 本地回环没有握手开销，用包装的工厂在建立连接时睡眠一段时间来模拟
+// TCP + TLS 握手（参数为毫秒）。每次迭代只计 Execute 本身的时间。
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "http_connection_pool.h"
+#include "local_http_server.h"
+
+namespace {
+
+class HandshakeDelayConnection : public HttpConnection {
+ public:
+  HandshakeDelayConnection(std::unique_ptr<HttpConnection> inner,
+                           std::chrono::milliseconds delay)
+      : inner_(std::move(inner)), delay_(delay) {}
+
+  bool Warm(std::string* error) override {
+    Handshake();
+    return inner_->Warm(error);
+  }
+
+  bool Send(const HttpRequest& request,
+            HttpResponse* response,
+            std::string* error) override {
+    Handshake();
+    return inner_->Send(request, response, error);
+  }
+
+  bool reusable() const override { return inner_->reusable(); }
+
+ private:
+  void Handshake() {
+    if (!connected_) {
+      std::this_thread::sleep_for(delay_);
+      connected_ = true;
+    }
+  }
+
+  std::unique_ptr<HttpConnection> inner_;
+  std::chrono::milliseconds delay_;
+  bool connected_ = false;
+};
+
+class HandshakeDelayFactory : public HttpConnectionFactory {
+ public:
+  explicit HandshakeDelayFactory(std::chrono::milliseconds delay)
+      : delay_(delay) {}
+
+  std::unique_ptr<HttpConnection> Create(const HttpOrigin& origin) override {
+    return std::make_unique<HandshakeDelayConnection>(inner_.Create(origin),
+                                                      delay_);
+  }
+
+ private:
+  SocketHttpConnectionFactory inner_;
+  std::chrono::milliseconds delay_;
+};
+
+enum class PoolState { kCold, kPrewarmed, kReused };
+
+void RunFirstByte(benchmark::State& state, PoolState pool_state) {
+  LocalHttpServer server(std::string(16 * 1024, 'x'),
+                         LocalHttpServer::Options());
+  if (!server.Start()) {
+    state.SkipWithError("server failed to start");
+    return;
+  }
+  HttpOrigin origin;
+  std::string path;
+  ParseHttpUrl(server.url("/api/games?page=1"), &origin, &path);
+  HttpRequest request;
+  request.path = path;
+  const std::chrono::milliseconds delay(state.range(0));
+
+  for (auto _ : state) {
+    HttpConnectionPool pool(std::make_unique<HandshakeDelayFactory>(delay),
+                            HttpConnectionPool::Options());
+    HttpResponse response;
+    std::string error;
+    if (pool_state == PoolState::kPrewarmed) {
+      pool.Prewarm(origin, 1);
+    } else if (pool_state == PoolState::kReused) {
+      pool.Execute(origin, request, &response, &error);
+    }
+    const auto start = std::chrono::steady_clock::now();
+    if (!pool.Execute(origin, request, &response, &error)) {
+      state.SkipWithError(error.c_str());
+      break;
+    }
+    state.SetIterationTime(std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count());
+  }
+  server.Stop();
+}
+
+}  // namespace
+
+static void BM_HttpFirstByteCold(benchmark::State& state) {
+  RunFirstByte(state, PoolState::kCold);
+}
+BENCHMARK(BM_HttpFirstByteCold)
+    ->Arg(0)
+    ->Arg(30)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_HttpFirstBytePrewarmed(benchmark::State& state) {
+  RunFirstByte(state, PoolState::kPrewarmed);
+}
+BENCHMARK(BM_HttpFirstBytePrewarmed)
+    ->Arg(0)
+    ->Arg(30)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_HttpFirstByteReused(benchmark::State& state) {
+  RunFirstByte(state, PoolState::kReused);
+}
+BENCHMARK(BM_HttpFirstByteReused)
+    ->Arg(0)
+    ->Arg(30)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
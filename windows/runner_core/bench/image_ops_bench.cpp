@@ -0,0 +1,82 @@
+// 相机原图（1200 万到 4800 万像素）缩放到屏幕尺寸和缩略图尺寸。
+//
+// 参数为源图像的百万像素数，宽高比 4:3。解码由 WIC 完成，不在这里计时。
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+
+#include "image_ops.h"
+
+namespace {
+
+PixelBuffer CameraImage(int megapixels) {
+  const uint32_t height =
+      static_cast<uint32_t>(std::lround(std::sqrt(megapixels * 1e6 * 3 / 4)));
+  const uint32_t width = height / 3 * 4;
+  PixelBuffer image;
+  image.Allocate(width, height);
+  // 带噪声的渐变，避免全同像素
+  uint32_t seed = 12345;
+  for (uint32_t y = 0; y < height; ++y) {
+    uint8_t* row = image.row(y);
+    for (uint32_t x = 0; x < width; ++x) {
+      seed = seed * 1664525u + 1013904223u;
+      row[x * 4] = static_cast<uint8_t>(x + (seed >> 28));
+      row[x * 4 + 1] = static_cast<uint8_t>(y + (seed >> 24));
+      row[x * 4 + 2] = static_cast<uint8_t>((x ^ y) >> 2);
+      row[x * 4 + 3] = 255;
+    }
+  }
+  return image;
+}
+
+void RunResample(benchmark::State& state, uint32_t width, uint32_t height) {
+  const PixelBuffer source = CameraImage(static_cast<int>(state.range(0)));
+  const SourceRect rect{0, 0, static_cast<double>(source.width),
+                        static_cast<double>(source.height)};
+  PixelBuffer output;
+  for (auto _ : state) {
+    ResampleRegion(source, rect, width, height, &output);
+    benchmark::DoNotOptimize(output.pixels.data());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(source.width) * source.height);
+  state.counters["source_px"] =
+      static_cast<double>(source.width) * source.height;
+}
+
+}  // namespace
+
+static void BM_ResampleToScreen(benchmark::State& state) {
+  RunResample(state, 1920, 1440);
+}
+BENCHMARK(BM_ResampleToScreen)
+    ->Arg(12)
+    ->Arg(24)
+    ->Arg(48)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_ResampleToThumbnail(benchmark::State& state) {
+  RunResample(state, 320, 240);
+}
+BENCHMARK(BM_ResampleToThumbnail)
+    ->Arg(12)
+    ->Arg(24)
+    ->Arg(48)
+    ->Unit(benchmark::kMillisecond);
+
+// 头像：中心裁剪为正方形、缩放并加圆形遮罩。
+static void BM_AvatarFromPhoto(benchmark::State& state) {
+  const PixelBuffer source = CameraImage(static_cast<int>(state.range(0)));
+  const double side = source.height;
+  const SourceRect rect{(source.width - side) / 2, 0, side, side};
+  PixelBuffer output;
+  for (auto _ : state) {
+    ResampleRegion(source, rect, 256, 256, &output);
+    ApplyCircleMask(&output);
+    benchmark::DoNotOptimize(output.pixels.data());
+  }
+}
+BENCHMARK(BM_AvatarFromPhoto)->Arg(12)->Arg(48)->Unit(benchmark::kMillisecond);
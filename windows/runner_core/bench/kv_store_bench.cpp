@@ -0,0 +1,134 @@
+// 键值存储：写入、读取、按前缀扫描，以及 1 GB 日志的冷打开。
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "bench_utils.h"
+#include "kv_store.h"
+
+namespace {
+
+std::string PageKey(int i) {
+  return "games:list:" + std::to_string(i);
+}
+
+// 写满约 1 GB 日志，每个值 |value_size| 字节。只在进程内生成一次。
+const std::filesystem::path& LargeLog(size_t value_size) {
+  static std::filesystem::path small_values;
+  static std::filesystem::path large_values;
+  std::filesystem::path& directory =
+      value_size < 16384 ? small_values : large_values;
+  if (directory.empty()) {
+    directory = BenchDirectory(value_size < 16384 ? "kv_store_1g_small"
+                                                  : "kv_store_1g_large");
+    KvStore store(directory, KvStore::Options());
+    store.Open();
+    const std::string value(value_size, 'v');
+    const int count = static_cast<int>((1ull << 30) / value_size);
+    for (int i = 0; i < count; ++i) {
+      store.Put(PageKey(i), value.data(), value.size());
+    }
+  }
+  return directory;
+}
+
+}  // namespace
+
+static void BM_KvStorePut(benchmark::State& state) {
+  KvStore store(BenchDirectory("kv_store_put"), KvStore::Options());
+  store.Open();
+  const std::string value(static_cast<size_t>(state.range(0)), 'v');
+  int i = 0;
+  for (auto _ : state) {
+    store.Put(PageKey(i++), value.data(), value.size());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+  state.counters["compactions"] = static_cast<double>(store.stats().compactions);
+}
+BENCHMARK(BM_KvStorePut)->Arg(256)->Arg(4096)->Arg(65536);
+
+// 反复覆盖同一批键，计入自动压缩的开销。
+static void BM_KvStoreOverwrite(benchmark::State& state) {
+  KvStore store(BenchDirectory("kv_store_overwrite"), KvStore::Options());
+  store.Open();
+  const std::string value(4096, 'v');
+  int i = 0;
+  for (auto _ : state) {
+    store.Put(PageKey(i++ % 1000), value.data(), value.size());
+  }
+  state.counters["compactions"] = static_cast<double>(store.stats().compactions);
+}
+BENCHMARK(BM_KvStoreOverwrite);
+
+static void BM_KvStoreGet(benchmark::State& state) {
+  KvStore store(BenchDirectory("kv_store_get"), KvStore::Options());
+  store.Open();
+  const std::string value(4096, 'v');
+  constexpr int kEntries = 4096;
+  for (int i = 0; i < kEntries; ++i) {
+    store.Put(PageKey(i), value.data(), value.size());
+  }
+  std::vector<uint8_t> out;
+  int i = 0;
+  for (auto _ : state) {
+    store.Get(PageKey((i++ * 7919) % kEntries), &out);
+    benchmark::DoNotOptimize(out.data());
+  }
+}
+BENCHMARK(BM_KvStoreGet);
+
+// 10 万个键中按前缀扫描一个分类下的 100 个键。
+static void BM_KvStoreScanPrefix(benchmark::State& state) {
+  KvStore store(BenchDirectory("kv_store_scan"), KvStore::Options());
+  store.Open();
+  const std::string value(512, 'v');
+  for (int category = 0; category < 1000; ++category) {
+    for (int page = 0; page < 100; ++page) {
+      store.Put("category:" + std::to_string(category) + ":" +
+                    std::to_string(page),
+                value.data(), value.size());
+    }
+  }
+  int category = 0;
+  for (auto _ : state) {
+    size_t bytes = 0;
+    store.Scan("category:" + std::to_string(category++ % 1000) + ":",
+               [&](std::string_view, const uint8_t*, size_t size) {
+                 bytes += size;
+                 return true;
+               });
+    benchmark::DoNotOptimize(bytes);
+  }
+  state.SetItemsProcessed(state.iterations() * 100);
+}
+BENCHMARK(BM_KvStoreScanPrefix)->Unit(benchmark::kMicrosecond);
+
+// 1 GB 日志冷打开（计时前丢弃页缓存）：映射并从日志重建索引。参数为
+// 每个值的字节数，值越小记录越多。
+static void BM_KvStoreOpenCold1G(benchmark::State& state) {
+  const std::filesystem::path& directory =
+      LargeLog(static_cast<size_t>(state.range(0)));
+  bool evicted = true;
+  uint64_t entries = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    evicted &= EvictFromPageCache(directory);
+    state.ResumeTiming();
+    KvStore store(directory, KvStore::Options());
+    store.Open();
+    state.PauseTiming();
+    entries = store.stats().entries;
+    state.ResumeTiming();
+  }
+  state.counters["entries"] = static_cast<double>(entries);
+  state.counters["evicted"] = evicted ? 1 : 0;
+}
+BENCHMARK(BM_KvStoreOpenCold1G)
+    ->Arg(1024)
+    ->Arg(65536)
+    ->Iterations(3)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,119 @@
+// ObjectId 驻留：解析、驻留和查找，与以 24 字符字符串为键的哈希表对比。
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "object_id_table.h"
+
+namespace {
+
+// 同一进程在几天内生成的 ObjectId：时间戳递增，计数器连续。
+std::vector<ObjectId> RealisticIds(size_t count) {
+  std::vector<ObjectId> ids(count);
+  for (size_t i = 0; i < count; ++i) {
+    ids[i] = GenerateObjectId();
+    const uint32_t timestamp = 0x65F0C1A2u + static_cast<uint32_t>(i / 8);
+    ids[i].bytes[0] = static_cast<uint8_t>(timestamp >> 24);
+    ids[i].bytes[1] = static_cast<uint8_t>(timestamp >> 16);
+    ids[i].bytes[2] = static_cast<uint8_t>(timestamp >> 8);
+    ids[i].bytes[3] = static_cast<uint8_t>(timestamp);
+  }
+  return ids;
+}
+
+std::vector<std::string> ToHex(const std::vector<ObjectId>& ids) {
+  std::vector<std::string> hex(ids.size(), std::string(kObjectIdHexLength, ' '));
+  for (size_t i = 0; i < ids.size(); ++i) {
+    FormatObjectIdHex(ids[i], hex[i].data());
+  }
+  return hex;
+}
+
+}  // namespace
+
+static void BM_ParseObjectIdHex(benchmark::State& state) {
+  const std::vector<std::string> hex = ToHex(RealisticIds(1024));
+  ObjectId id;
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ParseObjectIdHex(hex[i++ & 1023], &id));
+  }
+}
+BENCHMARK(BM_ParseObjectIdHex);
+
+// 从空表驻留 |n| 个新 ObjectId，包括扩容。
+static void BM_ObjectIdTableInternNew(benchmark::State& state) {
+  const std::vector<ObjectId> ids =
+      RealisticIds(static_cast<size_t>(state.range(0)));
+  size_t memory = 0;
+  for (auto _ : state) {
+    ObjectIdTable table;
+    for (const ObjectId& id : ids) {
+      benchmark::DoNotOptimize(table.Intern(id));
+    }
+    memory = table.memory_bytes();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range(0));
+  state.counters["bytes_per_id"] =
+      static_cast<double>(memory) / static_cast<double>(ids.size());
+}
+BENCHMARK(BM_ObjectIdTableInternNew)
+    ->Arg(10000)
+    ->Arg(1000000)
+    ->Unit(benchmark::kMillisecond);
+
+// 一页接口数据的 ObjectId 再次驻留：大多已经存在，只取句柄。
+static void BM_ObjectIdTableInternBatchExisting(benchmark::State& state) {
+  const std::vector<ObjectId> ids = RealisticIds(100000);
+  ObjectIdTable table;
+  std::vector<uint32_t> handles(ids.size());
+  table.InternBatch(ids.data(), ids.size(), handles.data());
+  constexpr size_t kPage = 50;
+  size_t page = 0;
+  for (auto _ : state) {
+    const size_t start = (page++ * 7919 * kPage) % (ids.size() - kPage);
+    table.InternBatch(ids.data() + start, kPage, handles.data());
+    benchmark::DoNotOptimize(handles.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * kPage);
+}
+BENCHMARK(BM_ObjectIdTableInternBatchExisting);
+
+static void BM_ObjectIdTableFind(benchmark::State& state) {
+  const std::vector<ObjectId> ids = RealisticIds(1000000);
+  ObjectIdTable table;
+  for (const ObjectId& id : ids) {
+    table.Intern(id);
+  }
+  const bool hit = state.range(0) != 0;
+  const std::vector<ObjectId> missing = RealisticIds(1024);
+  size_t i = 0;
+  for (auto _ : state) {
+    const ObjectId& id =
+        hit ? ids[(i * 7919) % ids.size()] : missing[i & 1023];
+    benchmark::DoNotOptimize(table.Find(id));
+    ++i;
+  }
+  state.SetLabel(hit ? "hit" : "miss");
+}
+BENCHMARK(BM_ObjectIdTableFind)->Arg(1)->Arg(0);
+
+// 对照：Dart 侧原先以字符串为键的做法。
+static void BM_StringIdMapFind(benchmark::State& state) {
+  const std::vector<std::string> hex = ToHex(RealisticIds(1000000));
+  std::unordered_map<std::string, uint32_t> map;
+  map.reserve(hex.size());
+  for (size_t i = 0; i < hex.size(); ++i) {
+    map.emplace(hex[i], static_cast<uint32_t>(i + 1));
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.find(hex[(i++ * 7919) % hex.size()]));
+  }
+}
+BENCHMARK(BM_StringIdMapFind);
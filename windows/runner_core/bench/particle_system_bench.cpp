@@ -0,0 +1,85 @@
+// 每帧的粒子模拟：积分、越界处理和写出 drawRawAtlas 的数组。
+//
+// 参数为粒子数。背景粒子用与首页相同量级的规则（漂浮、抖动、旋转、
+// 左右循环）；拖尾每帧生成新粒子并回收淡出的粒子。
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "particle_system.h"
+
+namespace {
+
+constexpr float kWidth = 1920.0f;
+constexpr float kHeight = 1080.0f;
+
+void UseSprites(ParticleSystem* system) {
+  const float rects[] = {0, 0, 16, 16, 16, 0, 32, 16, 32, 0, 48, 16};
+  system->SetSprites(rects, 3, 8.0f);
+  const uint32_t palette[] = {0xFFFFFFFF, 0xFFB3E5FC, 0xFFFFF9C4};
+  system->SetPalette(palette, 3);
+}
+
+}  // namespace
+
+static void BM_ParticleStepBackground(benchmark::State& state) {
+  const auto count = static_cast<uint32_t>(state.range(0));
+  ParticleSystem system(count, 1);
+  ParticleBehavior behavior;
+  behavior.drag = 0.98f;
+  behavior.jitter = 0.05f;
+  behavior.spin = 0.01f;
+  behavior.wrap = true;
+  behavior.ranges = {0.2f, 1.0f, 1.0f, 4.0f, 0.2f, 0.8f};
+  system.SetBehavior(behavior);
+  UseSprites(&system);
+  system.Scatter(count, kWidth, kHeight);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(system.Step(1.0f, kWidth, kHeight));
+    benchmark::DoNotOptimize(system.transforms());
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ParticleStepBackground)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMicrosecond);
+
+// 拖尾：每帧生成容量 1/256 的新粒子。粒子约 130 帧后淡出回收，稳定时池
+// 约半满；池满时每次生成都要找最暗的粒子，开销与粒子数成正比。
+static void BM_ParticleStepTrail(benchmark::State& state) {
+  const auto count = static_cast<uint32_t>(state.range(0));
+  ParticleSystem system(count, 1);
+  ParticleBehavior behavior;
+  behavior.drag = 0.9f;
+  behavior.opacity_decay = 0.97f;
+  behavior.size_decay = 0.99f;
+  behavior.min_opacity = 0.02f;
+  behavior.min_size = 0.2f;
+  system.SetBehavior(behavior);
+  UseSprites(&system);
+  const uint32_t spawns_per_frame = count / 256 + 1;
+  uint32_t frame = 0;
+  for (auto _ : state) {
+    for (uint32_t i = 0; i < spawns_per_frame; ++i) {
+      ParticleSpawn spawn;
+      spawn.x = static_cast<float>((frame * 7 + i) % 1920);
+      spawn.y = static_cast<float>((frame * 3 + i) % 1080);
+      spawn.vx = static_cast<float>(i % 5) - 2.0f;
+      spawn.vy = static_cast<float>(i % 3) - 1.0f;
+      spawn.size = 3.0f;
+      spawn.shape = i;
+      system.Spawn(spawn);
+    }
+    benchmark::DoNotOptimize(system.Step(1.0f, kWidth, kHeight));
+    ++frame;
+  }
+  state.counters["alive"] = system.count();
+}
+BENCHMARK(BM_ParticleStepTrail)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMicrosecond);
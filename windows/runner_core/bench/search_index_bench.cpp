@@ -0,0 +1,158 @@
+// 本地全文索引：10 万篇文档（游戏标题加简介）的建立时间、内存和查询延迟。
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_utils.h"
+#include "search_index.h"
+
+namespace {
+
+struct Corpus {
+  std::vector<std::string> titles;
+  std::vector<std::string> summaries;
+};
+
+void AppendUtf8(uint32_t code_point, std::string* out) {
+  out->push_back(static_cast<char>(0xE0 | code_point >> 12));
+  out->push_back(static_cast<char>(0x80 | (code_point >> 6 & 0x3F)));
+  out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+}
+
+// 中文词表 2000 个（2 到 4 字，取自常用字区），按 Zipf 分布取词，
+// 夹杂少量英文词。标题 3 到 8 个词，简介 20 到 60 个词。
+Corpus MakeCorpus(size_t count) {
+  std::mt19937 rng(11);
+  std::vector<std::string> words(2000);
+  for (auto& word : words) {
+    const int length = 2 + static_cast<int>(rng() % 3);
+    for (int i = 0; i < length; ++i) {
+      AppendUtf8(0x4E00 + rng() % 3000, &word);
+    }
+  }
+  const char* latin[] = {"zelda", "mario", "souls", "rpg", "fps", "dlc",
+                         "steam", "switch", "remake", "online"};
+  std::vector<double> weights(words.size());
+  for (size_t i = 0; i < weights.size(); ++i) {
+    weights[i] = 1.0 / static_cast<double>(i + 1);
+  }
+  std::discrete_distribution<size_t> zipf(weights.begin(), weights.end());
+  const auto text = [&](int min_words, int max_words) {
+    std::string out;
+    const int n = min_words + static_cast<int>(rng() % (max_words - min_words + 1));
+    for (int i = 0; i < n; ++i) {
+      if (rng() % 8 == 0) {
+        out += latin[rng() % 10];
+        out += ' ';
+      } else {
+        out += words[zipf(rng)];
+        if (rng() % 3 == 0) {
+          out += "，";
+        }
+      }
+    }
+    return out;
+  };
+  Corpus corpus;
+  for (size_t i = 0; i < count; ++i) {
+    corpus.titles.push_back(text(3, 8));
+    corpus.summaries.push_back(text(20, 60));
+  }
+  return corpus;
+}
+
+const Corpus& SharedCorpus() {
+  static const Corpus corpus = MakeCorpus(100000);
+  return corpus;
+}
+
+void Fill(SearchIndex* index, const Corpus& corpus, size_t count) {
+  for (uint32_t id = 0; id < count; ++id) {
+    index->Upsert(id, {{corpus.titles[id], 3.0f}, {corpus.summaries[id], 1.0f}});
+  }
+}
+
+// 进程内只建一次，同时记录索引占用的堆内存。
+const SearchIndex& SharedIndex(uint64_t* heap_bytes) {
+  static uint64_t heap = 0;
+  static const std::unique_ptr<SearchIndex> index = [] {
+    const Corpus& corpus = SharedCorpus();
+    const uint64_t before = CurrentHeapBytes();
+    auto built = std::make_unique<SearchIndex>();
+    Fill(built.get(), corpus, corpus.titles.size());
+    heap = CurrentHeapBytes() - before;
+    return built;
+  }();
+  *heap_bytes = heap;
+  return *index;
+}
+
+}  // namespace
+
+static void BM_SearchIndexBuild(benchmark::State& state) {
+  const Corpus& corpus = SharedCorpus();
+  const size_t count = static_cast<size_t>(state.range(0));
+  SearchIndex::Stats stats;
+  for (auto _ : state) {
+    SearchIndex index;
+    Fill(&index, corpus, count);
+    stats = index.stats();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+  state.counters["terms"] = static_cast<double>(stats.terms);
+  state.counters["posting_mb"] =
+      static_cast<double>(stats.posting_bytes) / (1 << 20);
+}
+BENCHMARK(BM_SearchIndexBuild)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(3);
+
+// 查询：单字、两字词、多词、拉丁前缀、中英混合。
+static void BM_SearchIndexQuery(benchmark::State& state) {
+  uint64_t heap_bytes = 0;
+  const SearchIndex& index = SharedIndex(&heap_bytes);
+  const Corpus& corpus = SharedCorpus();
+  // 取语料里的真实片段作为查询
+  const std::string bigram = corpus.titles[0].substr(0, 6);
+  const std::string phrase = corpus.titles[1].substr(0, 12);
+  const std::string queries[] = {corpus.titles[2].substr(0, 3), bigram, phrase,
+                                 "zel", bigram + " rpg"};
+  const std::string& query = queries[state.range(0)];
+  size_t hits = 0;
+  for (auto _ : state) {
+    hits = index.Search(query, 20).size();
+    benchmark::DoNotOptimize(hits);
+  }
+  static const char* kLabels[] = {"single char", "bigram", "phrase",
+                                  "latin prefix", "mixed"};
+  state.SetLabel(kLabels[state.range(0)]);
+  state.counters["hits"] = static_cast<double>(hits);
+  state.counters["index_mb"] = static_cast<double>(heap_bytes) / (1 << 20);
+}
+BENCHMARK(BM_SearchIndexQuery)->DenseRange(0, 4)->Unit(benchmark::kMicrosecond);
+
+// 10 万篇中替换一篇，已有索引上的增量更新。
+static void BM_SearchIndexUpsert(benchmark::State& state) {
+  const Corpus& corpus = SharedCorpus();
+  SearchIndex index;
+  Fill(&index, corpus, corpus.titles.size());
+  uint32_t i = 0;
+  for (auto _ : state) {
+    const uint32_t id = (i * 7919) % 100000;
+    const uint32_t source = (i + 1) * 104729 % 100000;
+    index.Upsert(id, {{corpus.titles[source], 3.0f},
+                      {corpus.summaries[source], 1.0f}});
+    ++i;
+  }
+  state.counters["compactions"] =
+      static_cast<double>(index.stats().compactions);
+}
+BENCHMARK(BM_SearchIndexUpsert)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,87 @@
+// 启动路径上的微基准：命令行参数、资源检查、证书哈希、首页快照和字体子集。
+
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "bench_utils.h"
+#include "bundle_resources.h"
+#include "cert_pinning.h"
+#include "font_subset.h"
+#include "runner_flags.h"
+#include "startup_snapshot.h"
+
+namespace fs = std::filesystem;
+
+static void BM_ParseCommandLineArguments(benchmark::State& state) {
+  const std::u16string_view arguments[] = {
+      u"--startup-trace=C:\\Users\\玩家\\trace.json", u"--memory-sample-ms=5000",
+      u"--hang-threshold-ms=1500", u"--route=/game/detail?id=65f0c1a2",
+      u"--prefetch-list=data\\prefetch.txt", u"--locale=zh_CN"};
+  for (auto _ : state) {
+    RunnerFlags flags;
+    benchmark::DoNotOptimize(
+        ParseCommandLineArguments(arguments, std::size(arguments), &flags));
+  }
+}
+BENCHMARK(BM_ParseCommandLineArguments);
+
+static void BM_FindMissingResources(benchmark::State& state) {
+  const fs::path root = BenchDirectory("resources");
+  for (const auto& resource : PrefetchBundleResources()) {
+    fs::create_directories((root / resource).parent_path());
+    std::ofstream(root / resource) << "x";
+  }
+  const auto resources = RequiredBundleResources();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(FindMissingResources(root, resources));
+  }
+}
+BENCHMARK(BM_FindMissingResources);
+
+static void BM_ComputeSpkiDigest(benchmark::State& state) {
+  const std::vector<uint8_t> der = ReadBenchCertificate();
+  Sha256Digest digest{};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ComputeSpkiDigest(der.data(), der.size(), &digest));
+  }
+}
+BENCHMARK(BM_ComputeSpkiDigest);
+
+// 映射并校验约 100 KB 的首页快照。
+static void BM_StartupSnapshotOpen(benchmark::State& state) {
+  const fs::path file = BenchDirectory("snapshot") / "startup_snapshot.bin";
+  StartupSnapshotWriter writer;
+  writer.Put("home.hot_games", std::vector<uint8_t>(40000, 'g'));
+  writer.Put("home.latest_games", std::vector<uint8_t>(40000, 'l'));
+  writer.Put("home.hot_posts", std::vector<uint8_t>(20000, 'p'));
+  writer.Put("session", std::vector<uint8_t>(64, 's'));
+  writer.Write(file, 1, 0);
+  for (auto _ : state) {
+    StartupSnapshotReader reader;
+    benchmark::DoNotOptimize(reader.Open(file));
+  }
+}
+BENCHMARK(BM_StartupSnapshotOpen)->Unit(benchmark::kMicrosecond);
+
+// 常用汉字按步长取样，模拟界面实际用到的字符。
+static void BM_SubsetFont(benchmark::State& state) {
+  const std::vector<uint8_t> font = ReadBenchFile(RUNNER_CORE_TEST_FONT);
+  std::vector<uint32_t> code_points;
+  for (uint32_t c = 0x20; c < 0x7F; ++c) {
+    code_points.push_back(c);
+  }
+  for (uint32_t c = 0x4E00;
+       code_points.size() < static_cast<size_t>(state.range(0)); c += 5) {
+    code_points.push_back(c);
+  }
+  std::vector<uint8_t> subset;
+  for (auto _ : state) {
+    SubsetTrueTypeFont(font.data(), font.size(), code_points, &subset);
+  }
+  state.counters["subset_bytes"] = static_cast<double>(subset.size());
+}
+BENCHMARK(BM_SubsetFont)->Arg(500)->Arg(2000)->Unit(benchmark::kMillisecond);
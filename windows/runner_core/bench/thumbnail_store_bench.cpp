@@ -0,0 +1,144 @@
+// 缩略图的生成和读取吞吐，以及一屏网格常驻内存的对比。
+//
+// 网络封面按 1600x900 解码后的像素计算（解码由 WIC 完成，不在这里计时）。
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bench_utils.h"
+#include "disk_cache.h"
+#include "thumbnail_store.h"
+
+namespace {
+
+constexpr uint32_t kCoverWidth = 1600;
+constexpr uint32_t kCoverHeight = 900;
+constexpr int kGridSize = 200;
+
+PixelBuffer Cover(uint32_t seed) {
+  PixelBuffer image;
+  image.Allocate(kCoverWidth, kCoverHeight);
+  for (size_t i = 0; i < image.pixels.size(); i += 4) {
+    seed = seed * 1664525u + 1013904223u;
+    image.pixels[i] = static_cast<uint8_t>(seed >> 24);
+    image.pixels[i + 1] = static_cast<uint8_t>(seed >> 16);
+    image.pixels[i + 2] = static_cast<uint8_t>(i >> 12);
+    image.pixels[i + 3] = 255;
+  }
+  return image;
+}
+
+DiskCache::Options CacheOptions() {
+  DiskCache::Options options;
+  options.max_bytes = 1ull << 30;
+  options.max_entries = 4096;
+  return options;
+}
+
+}  // namespace
+
+static void BM_MakeThumbnail(benchmark::State& state) {
+  const PixelBuffer cover = Cover(1);
+  const uint32_t width = static_cast<uint32_t>(state.range(0));
+  PixelBuffer thumbnail;
+  for (auto _ : state) {
+    MakeThumbnail(cover, width, &thumbnail);
+    benchmark::DoNotOptimize(thumbnail.pixels.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MakeThumbnail)
+    ->Arg(160)
+    ->Arg(320)
+    ->Arg(640)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_ThumbnailStorePut(benchmark::State& state) {
+  DiskCache cache(BenchDirectory("thumbnail_put"), CacheOptions());
+  cache.Open();
+  ThumbnailStore store(&cache);
+  PixelBuffer thumbnail;
+  MakeThumbnail(Cover(1), static_cast<uint32_t>(state.range(0)), &thumbnail);
+  int i = 0;
+  for (auto _ : state) {
+    // 每次改一个像素，避免内容去重
+    thumbnail.pixels[0] = static_cast<uint8_t>(i);
+    thumbnail.pixels[1] = static_cast<uint8_t>(i >> 8);
+    store.Put("cover" + std::to_string(i++), 320, thumbnail, INT64_MAX);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(thumbnail.pixels.size()));
+}
+BENCHMARK(BM_ThumbnailStorePut)->Arg(320)->Unit(benchmark::kMicrosecond);
+
+static void BM_ThumbnailStoreGet(benchmark::State& state) {
+  DiskCache cache(BenchDirectory("thumbnail_get"), CacheOptions());
+  cache.Open();
+  ThumbnailStore store(&cache);
+  const uint32_t width = static_cast<uint32_t>(state.range(0));
+  for (int i = 0; i < kGridSize; ++i) {
+    PixelBuffer thumbnail;
+    MakeThumbnail(Cover(static_cast<uint32_t>(i)), width, &thumbnail);
+    store.Put("cover" + std::to_string(i), width, thumbnail, INT64_MAX);
+  }
+  PixelBuffer thumbnail;
+  int i = 0;
+  for (auto _ : state) {
+    store.Get("cover" + std::to_string(i), width, &thumbnail);
+    benchmark::DoNotOptimize(thumbnail.pixels.data());
+    i = (i + 1) % kGridSize;
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(thumbnail.pixels.size()));
+}
+BENCHMARK(BM_ThumbnailStoreGet)
+    ->Arg(160)
+    ->Arg(320)
+    ->Arg(640)
+    ->Unit(benchmark::kMicrosecond);
+
+// 同时持有 200 张图（一个长网格里已加载的卡片）时的常驻内存增量：
+// 320 档缩略图对比完整解码的封面。
+static void BM_ThumbnailGridResident(benchmark::State& state) {
+  const bool thumbnails = state.range(0) != 0;
+  DiskCache cache(BenchDirectory("thumbnail_grid"), CacheOptions());
+  cache.Open();
+  ThumbnailStore store(&cache);
+  const PixelBuffer cover = Cover(7);
+  if (thumbnails) {
+    for (int i = 0; i < kGridSize; ++i) {
+      PixelBuffer thumbnail;
+      MakeThumbnail(cover, 320, &thumbnail);
+      thumbnail.pixels[0] = static_cast<uint8_t>(i);
+      store.Put("cover" + std::to_string(i), 320, thumbnail, INT64_MAX);
+    }
+  }
+  double resident_mb = 0;
+  for (auto _ : state) {
+    const uint64_t before = CurrentResidentBytes();
+    std::vector<PixelBuffer> grid(kGridSize);
+    for (int i = 0; i < kGridSize; ++i) {
+      if (thumbnails) {
+        store.Get("cover" + std::to_string(i), 320, &grid[i]);
+      } else {
+        grid[i] = cover;
+      }
+    }
+    const uint64_t after = CurrentResidentBytes();
+    resident_mb = std::max(resident_mb, (after - before) / 1048576.0);
+    benchmark::DoNotOptimize(grid.data());
+  }
+  state.counters["resident_mb"] = resident_mb;
+}
+BENCHMARK(BM_ThumbnailGridResident)
+    ->ArgName("thumbnails")
+    ->Arg(0)
+    ->Arg(1)
+    ->Iterations(3)
+    ->Unit(benchmark::kMillisecond);
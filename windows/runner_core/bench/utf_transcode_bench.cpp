@@ -0,0 +1,51 @@
+// UTF-16 与 UTF-8 互转的吞吐。
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+
+#include "utf_transcode.h"
+
+namespace {
+
+// 中文为主，夹杂 ASCII 的文本，与帖子内容接近。
+std::u16string MixedText(size_t length) {
+  std::mt19937 rng(1);
+  std::u16string text;
+  while (text.size() < length) {
+    if (rng() % 4 == 0) {
+      text += u"Zelda 2024 ";
+    } else {
+      text.push_back(static_cast<char16_t>(0x4E00 + rng() % 0x5000));
+    }
+  }
+  return text;
+}
+
+}  // namespace
+
+static void BM_Utf16ToUtf8(benchmark::State& state) {
+  const std::u16string text = MixedText(static_cast<size_t>(state.range(0)));
+  std::string utf8;
+  for (auto _ : state) {
+    Utf16ToUtf8(text, &utf8);
+    benchmark::DoNotOptimize(utf8.data());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range(0) * 2);
+}
+BENCHMARK(BM_Utf16ToUtf8)->Arg(64)->Arg(4096);
+
+static void BM_Utf8ToUtf16(benchmark::State& state) {
+  std::string utf8;
+  Utf16ToUtf8(MixedText(static_cast<size_t>(state.range(0))), &utf8);
+  std::u16string utf16;
+  for (auto _ : state) {
+    Utf8ToUtf16(utf8, &utf16);
+    benchmark::DoNotOptimize(utf16.data());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(utf8.size()));
+}
+BENCHMARK(BM_Utf8ToUtf16)->Arg(64)->Arg(4096);
@@ -0,0 +1,37 @@
+#include "bundle_resources.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "test_utils.h"
+
+namespace fs = std::filesystem;
+
+TEST(BundleResourcesTest, PrefetchListCoversRequiredResources) {
+  const auto prefetch = PrefetchBundleResources();
+  for (const auto& resource : RequiredBundleResources()) {
+    EXPECT_EQ(std::count(prefetch.begin(), prefetch.end(), resource), 1)
+        << resource;
+  }
+  // 引擎最先读取 AOT 快照
+  ASSERT_FALSE(prefetch.empty());
+  EXPECT_EQ(prefetch.front(), fs::path("data") / "app.so");
+}
+
+TEST(BundleResourcesTest, FindsMissingResourcesInOrder) {
+  const fs::path root = MakeTempDirectory("bundle_resources");
+  WriteTestFile(root / "data" / "icudtl.dat", "icu");
+  fs::create_directories(root / "data" / "flutter_assets");
+
+  EXPECT_TRUE(FindMissingResources(root, RequiredBundleResources()).empty());
+
+  const std::vector<fs::path> resources = {
+      fs::path("data") / "app.so",
+      fs::path("data") / "icudtl.dat",
+      fs::path("data") / "missing.bin",
+  };
+  EXPECT_EQ(FindMissingResources(root, resources),
+            (std::vector<fs::path>{resources[0], resources[2]}));
+  EXPECT_EQ(FindMissingResources(root / "nowhere", resources), resources);
+}
@@ -0,0 +1,101 @@
+#include "bundle_verifier.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+
+#include "test_utils.h"
+
+namespace fs = std::filesystem;
+
+class BundleVerifierTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    root_ = MakeTempDirectory("bundle_verifier") / "data";
+    WriteTestFile(root_ / "app.so", std::string(70000, 'a'));
+    WriteTestFile(root_ / "icudtl.dat", "icu data");
+    WriteTestFile(root_ / "flutter_assets/AssetManifest.bin", "manifest");
+    WriteTestFile(root_ / "flutter_assets/fonts/字体.ttf", "font");
+    ASSERT_TRUE(BuildBundleManifest(root_, &manifest_));
+  }
+
+  fs::path root_;
+  BundleManifest manifest_;
+};
+
+TEST_F(BundleVerifierTest, ManifestRoundTrips) {
+  ASSERT_EQ(manifest_.size(), 4u);
+  EXPECT_EQ(manifest_[0].path, "app.so");
+  EXPECT_EQ(manifest_[2].path, "flutter_assets/fonts/字体.ttf");
+  ASSERT_TRUE(WriteBundleManifest(root_ / kBundleManifestFileName, manifest_));
+
+  BundleManifest read;
+  ASSERT_TRUE(ReadBundleManifest(root_ / kBundleManifestFileName, &read));
+  ASSERT_EQ(read.size(), manifest_.size());
+  for (size_t i = 0; i < read.size(); ++i) {
+    EXPECT_EQ(read[i].path, manifest_[i].path);
+    EXPECT_EQ(read[i].size, manifest_[i].size);
+    EXPECT_EQ(read[i].hash, manifest_[i].hash);
+  }
+  // 清单自身不在清单里
+  BundleManifest rebuilt;
+  ASSERT_TRUE(BuildBundleManifest(root_, &rebuilt));
+  EXPECT_EQ(rebuilt.size(), manifest_.size());
+}
+
+TEST_F(BundleVerifierTest, ReportsMissingAndCorruptedFiles) {
+  EXPECT_TRUE(VerifyBundle(root_, manifest_, nullptr).ok());
+
+  fs::remove(root_ / "icudtl.dat");
+  WriteTestFile(root_ / "flutter_assets/AssetManifest.bin", "MANIFEST");
+  const auto result = VerifyBundle(root_, manifest_, nullptr);
+  EXPECT_EQ(result.missing, (std::vector<std::string>{"icudtl.dat"}));
+  EXPECT_EQ(result.corrupted,
+            (std::vector<std::string>{"flutter_assets/AssetManifest.bin"}));
+}
+
+// 热启动只重新计算变化过的文件。
+TEST_F(BundleVerifierTest, FingerprintCacheSkipsUnchangedFiles) {
+  const fs::path cache_file = root_.parent_path() / "fingerprints.bin";
+  BundleFingerprintCache cache;
+  auto result = VerifyBundle(root_, manifest_, &cache);
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(result.hashed_files, 4u);
+  ASSERT_TRUE(cache.Save(cache_file, root_));
+
+  BundleFingerprintCache warm;
+  ASSERT_TRUE(warm.Load(cache_file, root_));
+  result = VerifyBundle(root_, manifest_, &warm);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(result.hashed_files, 0u);
+
+  // 安装目录变化时缓存作废
+  BundleFingerprintCache moved;
+  EXPECT_FALSE(moved.Load(cache_file, root_ / "elsewhere"));
+  EXPECT_EQ(moved.size(), 0u);
+}
+
+// 大小不变的损坏只有哈希能发现；修改时间变了，指纹缓存不能掩盖它。
+TEST_F(BundleVerifierTest, CacheDoesNotHideSameSizeCorruption) {
+  BundleFingerprintCache cache;
+  ASSERT_TRUE(VerifyBundle(root_, manifest_, &cache).ok());
+
+  std::string app(70000, 'a');
+  app[35000] = 'b';
+  WriteTestFile(root_ / "app.so", app);
+  fs::last_write_time(root_ / "app.so",
+                      fs::last_write_time(root_ / "app.so") +
+                          std::chrono::seconds(5));
+  const auto result = VerifyBundle(root_, manifest_, &cache);
+  EXPECT_EQ(result.corrupted, (std::vector<std::string>{"app.so"}));
+  EXPECT_EQ(result.hashed_files, 1u);
+}
+
+// 截断按大小发现，被截断的文件不需要读取；其余三个文件照常计算哈希。
+TEST_F(BundleVerifierTest, TruncationIsCaughtWithoutHashing) {
+  WriteTestFile(root_ / "app.so", std::string(1000, 'a'));
+  const auto result = VerifyBundle(root_, manifest_, nullptr);
+  EXPECT_EQ(result.corrupted, (std::vector<std::string>{"app.so"}));
+  EXPECT_EQ(result.hashed_files, 3u);
+}
@@ -0,0 +1,173 @@
+#include "cert_pinning.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "sha256.h"
+#include "test_utils.h"
+
+namespace {
+
+constexpr char kClientSpkiHex[] =
+    "20e8c25cbbc69b962e8e2bc9f0af5311be8af4398c97d35ee6c31f96e0760dca";
+constexpr char kClientSpkiBase64[] =
+    "sha256/IOjCXLvGm5YujivJ8K9TEb6K9DmMl9Ne5sMfluB2Dco=";
+
+// 取出 PEM 中第一张证书的 DER。
+std::vector<uint8_t> ReadPemCertificate(const char* path) {
+  const std::vector<uint8_t> pem = ReadTestFile(path);
+  const std::string text(pem.begin(), pem.end());
+  const std::string begin = "-----BEGIN CERTIFICATE-----";
+  const size_t start = text.find(begin);
+  const size_t end = text.find("-----END CERTIFICATE-----");
+  if (start == std::string::npos || end == std::string::npos) {
+    return {};
+  }
+  static constexpr char kAlphabet[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::vector<uint8_t> der;
+  uint32_t bits = 0;
+  int bit_count = 0;
+  for (size_t i = start + begin.size(); i < end; ++i) {
+    const char* digit = std::strchr(kAlphabet, text[i]);
+    if (text[i] == '\0' || digit == nullptr) {
+      continue;  // 换行和填充
+    }
+    bits = (bits << 6) | static_cast<uint32_t>(digit - kAlphabet);
+    bit_count += 6;
+    if (bit_count >= 8) {
+      bit_count -= 8;
+      der.push_back(static_cast<uint8_t>(bits >> bit_count));
+    }
+  }
+  return der;
+}
+
+Sha256Digest Digest(const char* pin) {
+  Sha256Digest digest{};
+  EXPECT_TRUE(ParsePin(pin, &digest)) << pin;
+  return digest;
+}
+
+}  // namespace
+
+TEST(Sha256Test, KnownVectors) {
+  EXPECT_EQ(DigestToHex(Sha256::Hash("abc", 3)),
+            "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  // 分块输入与一次性输入一致
+  const std::string text(1000, 'x');
+  Sha256 sha;
+  for (size_t i = 0; i < text.size(); i += 7) {
+    sha.Update(text.data() + i, std::min<size_t>(7, text.size() - i));
+  }
+  EXPECT_EQ(sha.Finish(), Sha256::Hash(text.data(), text.size()));
+}
+
+TEST(CertPinningTest, BytesToHex) {
+  const uint8_t bytes[] = {0x00, 0x0f, 0xa5, 0xff};
+  EXPECT_EQ(BytesToHex(bytes, sizeof(bytes)), "000fa5ff");
+  EXPECT_EQ(BytesToHex(bytes, 0), "");
+}
+
+TEST(CertPinningTest, ParsesHexAndBase64Pins) {
+  EXPECT_EQ(Digest(kClientSpkiHex), Digest(kClientSpkiBase64));
+  Sha256Digest digest{};
+  EXPECT_FALSE(ParsePin("sha256/not-base64", &digest));
+  EXPECT_FALSE(ParsePin("abcd", &digest));
+}
+
+TEST(CertPinningTest, ComputesSpkiDigestOfCheckedInCertificate) {
+  const std::vector<uint8_t> der =
+      ReadPemCertificate(RUNNER_CORE_TEST_CERTIFICATE);
+  ASSERT_FALSE(der.empty());
+  Sha256Digest digest{};
+  ASSERT_TRUE(ComputeSpkiDigest(der.data(), der.size(), &digest));
+  EXPECT_EQ(DigestToHex(digest), kClientSpkiHex);
+  // 截断的证书无法解析
+  EXPECT_FALSE(ComputeSpkiDigest(der.data(), der.size() / 2, &digest));
+}
+
+TEST(CertPinningTest, ChecksHostsAndCachesCertificates) {
+  const std::vector<uint8_t> der =
+      ReadPemCertificate(RUNNER_CORE_TEST_CERTIFICATE);
+  ASSERT_FALSE(der.empty());
+  CertificatePinner pinner;
+  pinner.AddPin("api.example.com", Digest(kClientSpkiHex));
+  pinner.AddPin("*.cdn.example.com", Sha256Digest{});
+
+  EXPECT_EQ(pinner.Check("API.example.com", der.data(), der.size()),
+            PinVerdict::kAllowed);
+  EXPECT_EQ(pinner.Check("img.cdn.example.com", der.data(), der.size()),
+            PinVerdict::kMismatch);
+  EXPECT_EQ(pinner.Check("a.b.cdn.example.com", der.data(), der.size()),
+            PinVerdict::kNotPinned);
+  EXPECT_EQ(pinner.Check("api.example.com", der.data(), 10),
+            PinVerdict::kMalformed);
+  EXPECT_GE(pinner.cache_hits(), 1u);
+}
+
+// 只改签名字节的证书公钥不变，但缓存键不同，需要重新解析。
+TEST(CertPinningTest, CacheHitsOnlyForIdenticalCertificates) {
+  std::vector<uint8_t> der = ReadPemCertificate(RUNNER_CORE_TEST_CERTIFICATE);
+  ASSERT_FALSE(der.empty());
+  CertificatePinner pinner;
+  pinner.AddPin("api.example.com", Digest(kClientSpkiHex));
+
+  EXPECT_EQ(pinner.Check("api.example.com", der.data(), der.size()),
+            PinVerdict::kAllowed);
+  EXPECT_EQ(pinner.Check("api.example.com", der.data(), der.size()),
+            PinVerdict::kAllowed);
+  EXPECT_EQ(pinner.cache_misses(), 1u);
+  EXPECT_EQ(pinner.cache_hits(), 1u);
+
+  der.back() ^= 0xff;
+  EXPECT_EQ(pinner.Check("api.example.com", der.data(), der.size()),
+            PinVerdict::kAllowed);
+  EXPECT_EQ(pinner.cache_misses(), 2u);
+
+  // 同样长度的垃圾数据不会命中合法证书的缓存
+  std::vector<uint8_t> garbage(der.size(), 0x30);
+  EXPECT_EQ(pinner.Check("api.example.com", garbage.data(), garbage.size()),
+            PinVerdict::kMalformed);
+  EXPECT_EQ(pinner.Check("api.example.com", garbage.data(), garbage.size()),
+            PinVerdict::kMalformed);
+  EXPECT_EQ(pinner.cache_misses(), 3u);
+  EXPECT_EQ(pinner.cache_hits(), 2u);
+}
+
+TEST(CertPinningTest, CacheStaysCorrectPastItsLimit) {
+  const std::vector<uint8_t> der =
+      ReadPemCertificate(RUNNER_CORE_TEST_CERTIFICATE);
+  ASSERT_FALSE(der.empty());
+  CertificatePinner pinner(4);
+  pinner.AddPin("api.example.com", Digest(kClientSpkiHex));
+  for (int round = 0; round < 3; ++round) {
+    for (uint8_t i = 0; i < 10; ++i) {
+      std::vector<uint8_t> variant = der;
+      variant.back() = i;
+      EXPECT_EQ(pinner.Check("api.example.com", variant.data(), variant.size()),
+                PinVerdict::kAllowed);
+    }
+  }
+  EXPECT_EQ(pinner.cache_hits() + pinner.cache_misses(), 30u);
+}
+
+TEST(CertPinningTest, LoadsPinsFromFile) {
+  const auto directory = MakeTempDirectory("cert_pinning");
+  WriteTestFile(directory / "pins.conf",
+                std::string("# comment\n\napi.example.com ") + kClientSpkiHex +
+                    "\n*.example.org " + kClientSpkiBase64 + "\n");
+  CertificatePinner pinner;
+  ASSERT_TRUE(pinner.LoadPinsFromFile(directory / "pins.conf"));
+  EXPECT_EQ(pinner.host_patterns(),
+            (std::vector<std::string>{"*.example.org", "api.example.com"}));
+
+  WriteTestFile(directory / "bad.conf", "api.example.com zz\n");
+  CertificatePinner bad;
+  EXPECT_FALSE(bad.LoadPinsFromFile(directory / "bad.conf"));
+  EXPECT_TRUE(bad.empty());
+}
@@ -0,0 +1,129 @@
+#include "check_scheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST(CheckSchedulerTest, RunsDependenciesFirst) {
+  CheckScheduler scheduler;
+  std::mutex mutex;
+  std::vector<int> order;
+  auto record = [&](int value) {
+    return [&, value]() {
+      std::lock_guard<std::mutex> lock(mutex);
+      order.push_back(value);
+      return CheckResult::Pass();
+    };
+  };
+  const auto a = scheduler.AddCheck(L"a", record(1));
+  const auto b = scheduler.AddCheck(L"b", record(2), {a});
+  scheduler.AddCheck(L"c", record(3), {a, b});
+
+  std::atomic<int> completions{0};
+  bool passed = false;
+  ASSERT_TRUE(scheduler.Start(nullptr, [&](bool all_passed) {
+    passed = all_passed;
+    ++completions;
+  }));
+  ASSERT_TRUE(scheduler.WaitForCompletion(5s));
+  EXPECT_TRUE(passed);
+  EXPECT_EQ(completions.load(), 1);
+  EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+  EXPECT_EQ(scheduler.resolved_count(), 3u);
+  EXPECT_FALSE(scheduler.Start(nullptr, nullptr));
+}
+
+TEST(CheckSchedulerTest, SkipsDependentsOfAFailedCheck) {
+  CheckScheduler::Options options;
+  options.stop_on_first_failure = false;
+  CheckScheduler scheduler(options);
+  const auto failing = scheduler.AddCheck(
+      L"failing", [] { return CheckResult::Fail(L"missing"); });
+  const auto dependent = scheduler.AddCheck(
+      L"dependent", [] { return CheckResult::Pass(); }, {failing});
+  const auto independent =
+      scheduler.AddCheck(L"independent", [] { return CheckResult::Pass(); });
+
+  bool passed = true;
+  ASSERT_TRUE(
+      scheduler.Start(nullptr, [&](bool all_passed) { passed = all_passed; }));
+  ASSERT_TRUE(scheduler.WaitForCompletion(5s));
+  EXPECT_FALSE(passed);
+  EXPECT_EQ(scheduler.status(failing), CheckStatus::kFailed);
+  EXPECT_EQ(scheduler.result(failing).error, L"missing");
+  EXPECT_EQ(scheduler.status(dependent), CheckStatus::kSkipped);
+  EXPECT_EQ(scheduler.status(independent), CheckStatus::kPassed);
+}
+
+TEST(CheckSchedulerTest, RejectsUnknownDependencies) {
+  CheckScheduler scheduler;
+  scheduler.AddCheck(L"a", [] { return CheckResult::Pass(); }, {7});
+  EXPECT_FALSE(scheduler.Start(nullptr, nullptr));
+}
+
+// 超时后只跳过非必需检查，必需检查和它的依赖照常执行。
+TEST(CheckSchedulerTest, CancelOptionalWaitsForRequiredChecks) {
+  CheckScheduler::Options options;
+  options.max_parallelism = 1;
+  CheckScheduler scheduler(options);
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::promise<void> blocked;
+  const auto gate = scheduler.AddCheck(L"gate", [&] {
+    blocked.set_value();
+    released.wait();
+    return CheckResult::Pass();
+  });
+  const auto runtime = scheduler.AddCheck(
+      L"runtime", [] { return CheckResult::Pass(); }, {gate});
+  const auto optional = scheduler.AddCheck(
+      L"optional", [] { return CheckResult::Pass(); }, {gate});
+  const auto network = scheduler.AddCheck(
+      L"network", [] { return CheckResult::Fail(L"pin mismatch"); },
+      {runtime});
+  scheduler.SetRequired(network);
+
+  bool passed = true;
+  ASSERT_TRUE(
+      scheduler.Start(nullptr, [&](bool all_passed) { passed = all_passed; }));
+  blocked.get_future().wait();
+  scheduler.CancelOptional();
+  release.set_value();
+  ASSERT_TRUE(scheduler.WaitForCompletion(5s));
+  EXPECT_FALSE(passed);
+  EXPECT_EQ(scheduler.status(gate), CheckStatus::kPassed);
+  EXPECT_EQ(scheduler.status(runtime), CheckStatus::kPassed);
+  EXPECT_EQ(scheduler.status(optional), CheckStatus::kSkipped);
+  EXPECT_EQ(scheduler.status(network), CheckStatus::kFailed);
+  EXPECT_EQ(scheduler.result(network).error, L"pin mismatch");
+}
+
+TEST(CheckSchedulerTest, CancelSkipsRequiredChecksToo) {
+  CheckScheduler::Options options;
+  options.max_parallelism = 1;
+  CheckScheduler scheduler(options);
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::promise<void> blocked;
+  const auto gate = scheduler.AddCheck(L"gate", [&] {
+    blocked.set_value();
+    released.wait();
+    return CheckResult::Pass();
+  });
+  const auto required = scheduler.AddCheck(
+      L"required", [] { return CheckResult::Pass(); }, {gate});
+  scheduler.SetRequired(required);
+
+  ASSERT_TRUE(scheduler.Start(nullptr, nullptr));
+  blocked.get_future().wait();
+  scheduler.Cancel();
+  release.set_value();
+  ASSERT_TRUE(scheduler.WaitForCompletion(5s));
+  EXPECT_EQ(scheduler.status(required), CheckStatus::kSkipped);
+}
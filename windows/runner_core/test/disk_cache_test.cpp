@@ -0,0 +1,234 @@
+#include "disk_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "test_utils.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+DiskCache::Options SmallOptions() {
+  DiskCache::Options options;
+  options.max_bytes = 16 << 20;
+  options.max_entries = 1024;
+  return options;
+}
+
+std::string ReadEntry(const DiskCache::Entry& entry) {
+  const std::vector<uint8_t> bytes = ReadTestFile(entry.path);
+  return std::string(bytes.begin(), bytes.end());
+}
+
+size_t CountFiles(const fs::path& directory) {
+  size_t count = 0;
+  std::error_code error;
+  for (const auto& item : fs::recursive_directory_iterator(directory, error)) {
+    if (item.is_regular_file()) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST(DiskCacheTest, PutAndLookup) {
+  DiskCache cache(MakeTempDirectory("disk_cache_put"), SmallOptions());
+  ASSERT_TRUE(cache.Open());
+  DiskCache::Entry entry;
+  EXPECT_FALSE(cache.Lookup("https://example.com/a.png", &entry));
+  ASSERT_TRUE(cache.Put("https://example.com/a.png", "image-a", 7, 1234));
+
+  ASSERT_TRUE(cache.Lookup("https://example.com/a.png", &entry));
+  EXPECT_EQ(ReadEntry(entry), "image-a");
+  EXPECT_EQ(entry.size, 7u);
+  EXPECT_EQ(entry.valid_till_ms, 1234);
+
+  const auto stats = cache.stats();
+  EXPECT_EQ(stats.entries, 1u);
+  EXPECT_EQ(stats.bytes, 7u);
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 1u);
+}
+
+// 内容相同的条目共享内容文件，最后一个引用移除后才删除。
+TEST(DiskCacheTest, SharesBlobsBetweenIdenticalContent) {
+  DiskCache cache(MakeTempDirectory("disk_cache_shared"), SmallOptions());
+  ASSERT_TRUE(cache.Open());
+  DiskCache::Entry a;
+  DiskCache::Entry b;
+  ASSERT_TRUE(cache.Put("a", "same", 4, 0, &a));
+  ASSERT_TRUE(cache.Put("b", "same", 4, 0, &b));
+  EXPECT_EQ(a.path, b.path);
+
+  EXPECT_TRUE(cache.Remove("a"));
+  EXPECT_TRUE(fs::exists(b.path));
+  EXPECT_TRUE(cache.Remove("b"));
+  EXPECT_FALSE(fs::exists(b.path));
+  EXPECT_FALSE(cache.Remove("b"));
+}
+
+TEST(DiskCacheTest, OverwritesExistingKey) {
+  DiskCache cache(MakeTempDirectory("disk_cache_overwrite"), SmallOptions());
+  ASSERT_TRUE(cache.Open());
+  DiskCache::Entry old_entry;
+  ASSERT_TRUE(cache.Put("key", "old", 3, 0, &old_entry));
+  ASSERT_TRUE(cache.Put("key", "newer", 5, 0));
+
+  DiskCache::Entry entry;
+  ASSERT_TRUE(cache.Lookup("key", &entry));
+  EXPECT_EQ(ReadEntry(entry), "newer");
+  EXPECT_FALSE(fs::exists(old_entry.path));
+  EXPECT_EQ(cache.stats().entries, 1u);
+  EXPECT_EQ(cache.stats().bytes, 5u);
+}
+
+TEST(DiskCacheTest, PutFileMovesSourceIntoCache) {
+  DiskCache cache(MakeTempDirectory("disk_cache_put_file"), SmallOptions());
+  ASSERT_TRUE(cache.Open());
+  const fs::path first = cache.temp_directory() / "first.part";
+  const fs::path second = cache.temp_directory() / "second.part";
+  WriteTestFile(first, "downloaded");
+  WriteTestFile(second, "downloaded");
+
+  DiskCache::Entry entry;
+  ASSERT_TRUE(cache.PutFile("first", first, 0, &entry));
+  EXPECT_FALSE(fs::exists(first));
+  EXPECT_EQ(ReadEntry(entry), "downloaded");
+  // 内容已经在缓存中，第二个文件直接删除
+  ASSERT_TRUE(cache.PutFile("second", second, 0));
+  EXPECT_FALSE(fs::exists(second));
+
+  EXPECT_FALSE(cache.PutFile("missing", cache.temp_directory() / "missing", 0));
+}
+
+TEST(DiskCacheTest, EvictsLeastRecentlyUsedByBytes) {
+  DiskCache::Options options;
+  options.max_bytes = 16 * 4096;  // 每个分片 4 KB
+  options.max_entries = 1024;
+  const fs::path directory = MakeTempDirectory("disk_cache_evict");
+  DiskCache cache(directory, options);
+  ASSERT_TRUE(cache.Open());
+  EXPECT_FALSE(cache.Put("too-large", std::string(8192, 'x').data(), 8192, 0));
+
+  for (int i = 0; i < 200; ++i) {
+    const std::string data = std::to_string(i) + std::string(1000, 'x');
+    ASSERT_TRUE(cache.Put("key" + std::to_string(i), data.data(), data.size(),
+                          0));
+  }
+  const auto stats = cache.stats();
+  EXPECT_LE(stats.bytes, options.max_bytes);
+  EXPECT_GT(stats.evictions, 0u);
+  EXPECT_EQ(stats.entries + stats.evictions, 200u);
+  // 内容各不相同，被淘汰条目的内容文件都已删除
+  EXPECT_EQ(CountFiles(directory / "blobs"), stats.entries);
+}
+
+TEST(DiskCacheTest, RemovesEntriesOlderThan) {
+  DiskCache cache(MakeTempDirectory("disk_cache_older"), SmallOptions());
+  ASSERT_TRUE(cache.Open());
+  ASSERT_TRUE(cache.Put("old", "1", 1, 0));
+  const int64_t cutoff = DiskCache::NowMillis() + 1;
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  ASSERT_TRUE(cache.Put("new", "2", 1, 0));
+  EXPECT_EQ(cache.RemoveOlderThan(cutoff), 1u);
+  DiskCache::Entry entry;
+  EXPECT_FALSE(cache.Lookup("old", &entry));
+  EXPECT_TRUE(cache.Lookup("new", &entry));
+}
+
+TEST(DiskCacheTest, ReloadsIndexAfterReopen) {
+  const fs::path directory = MakeTempDirectory("disk_cache_reopen");
+  {
+    DiskCache cache(directory, SmallOptions());
+    ASSERT_TRUE(cache.Open());
+    ASSERT_TRUE(cache.Put("a", "alpha", 5, 42));
+    ASSERT_TRUE(cache.Put("b", "beta", 4, 43));
+  }
+  DiskCache cache(directory, SmallOptions());
+  ASSERT_TRUE(cache.Open());
+  DiskCache::Entry entry;
+  ASSERT_TRUE(cache.Lookup("a", &entry));
+  EXPECT_EQ(ReadEntry(entry), "alpha");
+  EXPECT_EQ(entry.valid_till_ms, 42);
+  EXPECT_EQ(cache.stats().entries, 2u);
+  EXPECT_EQ(cache.stats().bytes, 9u);
+}
+
+// 打开时不删除文件：旧的临时文件和找不到的内容文件整体移入 trash/。
+TEST(DiskCacheTest, OpenMovesStaleFilesToTrash) {
+  const fs::path directory = MakeTempDirectory("disk_cache_trash");
+  DiskCache::Entry stored;
+  {
+    DiskCache cache(directory, SmallOptions());
+    ASSERT_TRUE(cache.Open());
+    ASSERT_TRUE(cache.Put("a", "alpha", 5, 0, &stored));
+    WriteTestFile(cache.temp_directory() / "partial.part", "par");
+  }
+  DiskCache::Options options = SmallOptions();
+  options.max_entries = 4096;  // 索引大小变化，需要重建
+  DiskCache cache(directory, options);
+  ASSERT_TRUE(cache.Open());
+  DiskCache::Entry entry;
+  EXPECT_FALSE(cache.Lookup("a", &entry));
+  EXPECT_FALSE(fs::exists(stored.path));
+  EXPECT_EQ(CountFiles(cache.temp_directory()), 0u);
+  EXPECT_EQ(CountFiles(directory / "trash"), 2u);
+
+  EXPECT_GE(cache.EmptyTrash(), 2u);
+  EXPECT_EQ(CountFiles(directory / "trash"), 0u);
+  ASSERT_TRUE(cache.Put("a", "alpha", 5, 0, &entry));
+  EXPECT_EQ(ReadEntry(entry), "alpha");
+}
+
+// 同一内容同时写入时，后来的写入要等内容文件放到位后才返回。
+TEST(DiskCacheTest, ConcurrentPutsOfSameContentWaitForInstall) {
+  DiskCache::Options options;
+  options.max_bytes = 256ull << 20;
+  options.max_entries = 4096;
+  const fs::path directory = MakeTempDirectory("disk_cache_concurrent");
+  DiskCache cache(directory, options);
+  ASSERT_TRUE(cache.Open());
+  const std::string data(4 << 20, 'z');
+
+  for (int round = 0; round < 5; ++round) {
+    std::atomic<int> incomplete{0};
+    std::vector<std::thread> writers;
+    for (int i = 0; i < 8; ++i) {
+      writers.emplace_back([&, i] {
+        const std::string key =
+            "round" + std::to_string(round) + "-" + std::to_string(i);
+        DiskCache::Entry entry;
+        bool stored;
+        if (i % 2 == 0) {
+          stored = cache.Put(key, data.data(), data.size(), 0, &entry);
+        } else {
+          const fs::path source = cache.temp_directory() / (key + ".part");
+          WriteTestFile(source, data);
+          stored = cache.PutFile(key, source, 0, &entry);
+        }
+        std::error_code error;
+        if (!stored || fs::file_size(entry.path, error) != data.size()) {
+          ++incomplete;
+        }
+      });
+    }
+    for (auto& writer : writers) {
+      writer.join();
+    }
+    EXPECT_EQ(incomplete.load(), 0) << "round " << round;
+    for (int i = 0; i < 8; ++i) {
+      cache.Remove("round" + std::to_string(round) + "-" + std::to_string(i));
+    }
+  }
+  EXPECT_EQ(CountFiles(directory / "blobs"), 0u);
+  EXPECT_EQ(CountFiles(cache.temp_directory()), 0u);
+}
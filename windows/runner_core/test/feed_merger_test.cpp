@@ -0,0 +1,307 @@
+#include "feed_merger.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Item = FeedMerger::Item;
+using Op = FeedMerger::Op;
+using OpKind = FeedMerger::OpKind;
+using Scope = FeedMerger::Scope;
+
+bool Newer(const Item& a, const Item& b) {
+  return std::make_pair(a.timestamp, a.id) > std::make_pair(b.timestamp, b.id);
+}
+
+// 按 Dart 端的方式应用差异：三个列表分别对应三个 Scope。
+class FeedMergerTest : public ::testing::Test {
+ protected:
+  void Apply(const std::vector<Op>& ops) {
+    for (const Op& op : ops) {
+      auto& list = lists_[static_cast<int>(op.scope)];
+      if (op.kind == OpKind::kInsert) {
+        ASSERT_LE(op.index, list.size());
+        list.insert(list.begin() + op.index, op.key);
+      } else {
+        ASSERT_LT(op.index, list.size());
+        ASSERT_EQ(list[op.index], op.key);
+        if (op.kind == OpKind::kRemove) {
+          list.erase(list.begin() + op.index);
+        }
+      }
+    }
+  }
+
+  // 列表与按 |truth_| 重新计算的结果一致。
+  void ExpectMatchesTruth() {
+    std::vector<Item> items;
+    for (const auto& entry : truth_) {
+      items.push_back(entry.second);
+    }
+    std::sort(items.begin(), items.end(), Newer);
+    ASSERT_EQ(merger_.size(), items.size());
+    ASSERT_EQ(lists_[0].size(), items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+      ASSERT_EQ(lists_[0][i], items[i].id);
+    }
+    for (int scope = 1; scope < 3; ++scope) {
+      // 分组按最新一条排序
+      std::vector<uint32_t> groups;
+      std::map<uint32_t, std::vector<uint32_t>> members;
+      for (const Item& item : items) {
+        const uint32_t key = scope == 1 ? item.user : item.type;
+        if (members[key].empty()) {
+          groups.push_back(key);
+        }
+        members[key].push_back(item.id);
+      }
+      ASSERT_EQ(lists_[scope], groups);
+      std::vector<uint32_t> ids;
+      for (const auto& entry : members) {
+        merger_.Members(static_cast<Scope>(scope), entry.first, &ids);
+        ASSERT_EQ(ids, entry.second);
+      }
+    }
+  }
+
+  // 合并若干页并同步 |truth_|，返回产生的操作。
+  std::vector<Op> MergePages(const std::vector<std::vector<Item>>& pages) {
+    std::vector<Item> items;
+    std::vector<size_t> page_sizes;
+    for (const auto& page : pages) {
+      items.insert(items.end(), page.begin(), page.end());
+      page_sizes.push_back(page.size());
+    }
+    std::stable_sort(items.begin(), items.end(), Newer);
+    std::map<uint32_t, bool> seen;
+    for (const Item& item : items) {
+      if (!seen[item.id]) {
+        seen[item.id] = true;
+        truth_[item.id] = item;
+      }
+    }
+    items.clear();
+    for (const auto& page : pages) {
+      items.insert(items.end(), page.begin(), page.end());
+    }
+    std::vector<Op> ops;
+    merger_.Merge(items.data(), page_sizes.data(), page_sizes.size(), &ops);
+    Apply(ops);
+    return ops;
+  }
+
+  std::vector<Op> Remove(uint32_t id) {
+    truth_.erase(id);
+    std::vector<Op> ops;
+    merger_.Remove(id, &ops);
+    Apply(ops);
+    return ops;
+  }
+
+  FeedMerger merger_;
+  std::vector<uint32_t> lists_[3];
+  std::map<uint32_t, Item> truth_;
+};
+
+Item MakeItem(uint32_t id,
+              int64_t timestamp,
+              uint32_t user = 0,
+              uint32_t type = 0,
+              uint64_t version = 0) {
+  Item item;
+  item.id = id;
+  item.user = user;
+  item.type = type;
+  item.timestamp = timestamp;
+  item.version = version;
+  return item;
+}
+
+std::vector<Op> ListOps(const std::vector<Op>& ops) {
+  std::vector<Op> list_ops;
+  for (const Op& op : ops) {
+    if (op.scope == Scope::kList) {
+      list_ops.push_back(op);
+    }
+  }
+  return list_ops;
+}
+
+}  // namespace
+
+TEST_F(FeedMergerTest, MergeReplaceAndRemoveMatchModel) {
+  std::mt19937 rng(7);
+  auto make_item = [&]() {
+    Item item;
+    item.id = rng() % 300 + 1;
+    auto existing = truth_.find(item.id);
+    if (existing != truth_.end() && rng() % 2) {
+      item = existing->second;
+    } else {
+      item.user = rng() % 12;
+      item.type = rng() % 4;
+      item.timestamp = rng() % 1000;
+    }
+    item.version = rng() % 3;
+    return item;
+  };
+
+  for (int round = 0; round < 1500; ++round) {
+    std::vector<Op> ops;
+    const int action = static_cast<int>(rng() % 10);
+    if (action < 6) {
+      // 若干页，每页内按时间倒序且不重复
+      std::vector<Item> items;
+      std::vector<size_t> page_sizes;
+      const int pages = static_cast<int>(rng() % 4);
+      for (int page = 0; page < pages; ++page) {
+        std::map<uint32_t, Item> unique;
+        const int count = static_cast<int>(rng() % 20);
+        for (int i = 0; i < count; ++i) {
+          const Item item = make_item();
+          unique.emplace(item.id, item);
+        }
+        std::vector<Item> sorted;
+        for (const auto& entry : unique) {
+          sorted.push_back(entry.second);
+        }
+        std::sort(sorted.begin(), sorted.end(), Newer);
+        items.insert(items.end(), sorted.begin(), sorted.end());
+        page_sizes.push_back(sorted.size());
+      }
+      // 同一条目出现在多页时，按时间最新的为准
+      std::vector<Item> newest = items;
+      std::stable_sort(newest.begin(), newest.end(), Newer);
+      std::map<uint32_t, bool> seen;
+      for (const Item& item : newest) {
+        if (!seen[item.id]) {
+          seen[item.id] = true;
+          truth_[item.id] = item;
+        }
+      }
+      merger_.Merge(items.data(), page_sizes.data(), page_sizes.size(), &ops);
+    } else if (action < 8) {
+      std::vector<Item> items;
+      const int count = static_cast<int>(rng() % 60);
+      for (int i = 0; i < count; ++i) {
+        items.push_back(make_item());
+      }
+      truth_.clear();
+      for (const Item& item : items) {
+        truth_[item.id] = item;
+      }
+      merger_.Replace(items.data(), items.size(), &ops);
+    } else {
+      const uint32_t id = rng() % 300 + 1;
+      truth_.erase(id);
+      merger_.Remove(id, &ops);
+    }
+    Apply(ops);
+    ExpectMatchesTruth();
+    if (HasFatalFailure()) {
+      FAIL() << "round " << round;
+    }
+  }
+}
+
+// 重复出现的条目：内容没变时不产生操作，版本变化时原地更新，
+// 多页中出现的同一条目以时间最新的为准。
+TEST_F(FeedMergerTest, DeduplicatesRepeatedItems) {
+  MergePages({{MakeItem(1, 300, 1), MakeItem(2, 200, 2)}});
+  ExpectMatchesTruth();
+
+  EXPECT_TRUE(MergePages({{MakeItem(1, 300, 1), MakeItem(2, 200, 2)}}).empty());
+
+  const auto updated = ListOps(MergePages({{MakeItem(2, 200, 2, 0, 1)}}));
+  ASSERT_EQ(updated.size(), 1u);
+  EXPECT_EQ(updated[0].kind, OpKind::kUpdate);
+  EXPECT_EQ(updated[0].index, 1u);
+  EXPECT_EQ(updated[0].key, 2u);
+  ExpectMatchesTruth();
+
+  MergePages({{MakeItem(3, 100, 1)}, {MakeItem(3, 400, 1), MakeItem(4, 50)}});
+  ExpectMatchesTruth();
+  EXPECT_EQ(merger_.size(), 4u);
+  EXPECT_EQ(lists_[0], (std::vector<uint32_t>{3, 1, 2, 4}));
+}
+
+// 分页请求乱序返回：较旧的页先到，较新的页插在前面。
+TEST_F(FeedMergerTest, MergesPagesArrivingOutOfOrder) {
+  std::vector<std::vector<Item>> pages(3);
+  for (uint32_t i = 0; i < 60; ++i) {
+    pages[i / 20].push_back(MakeItem(i + 1, 10000 - i * 10, i % 7, i % 3));
+  }
+  MergePages({pages[2]});
+  ExpectMatchesTruth();
+
+  const auto first = ListOps(MergePages({pages[0]}));
+  ASSERT_EQ(first.size(), 20u);
+  for (uint32_t i = 0; i < 20; ++i) {
+    EXPECT_EQ(first[i].kind, OpKind::kInsert);
+    EXPECT_EQ(first[i].index, i);
+    EXPECT_EQ(first[i].key, i + 1);
+  }
+  ExpectMatchesTruth();
+
+  // 中间一页和已有的两页各有一条重叠
+  pages[1].front() = pages[0].back();
+  pages[1].back() = pages[2].front();
+  MergePages({pages[1]});
+  ExpectMatchesTruth();
+  EXPECT_EQ(merger_.size(), 58u);
+
+  // 同一次合并中页的顺序不影响结果
+  FeedMerger reversed;
+  std::vector<Item> items;
+  std::vector<size_t> page_sizes;
+  for (size_t page = pages.size(); page-- > 0;) {
+    items.insert(items.end(), pages[page].begin(), pages[page].end());
+    page_sizes.push_back(pages[page].size());
+  }
+  std::vector<Op> ops;
+  reversed.Merge(items.data(), page_sizes.data(), page_sizes.size(), &ops);
+  std::vector<uint32_t> list;
+  for (const Op& op : ListOps(ops)) {
+    ASSERT_EQ(op.kind, OpKind::kInsert);
+    list.insert(list.begin() + op.index, op.key);
+  }
+  EXPECT_EQ(list, lists_[0]);
+}
+
+// 删除条目时同步更新分组，分组的最后一条被删除时分组也删除。
+TEST_F(FeedMergerTest, RemovesItemsAndEmptyGroups) {
+  MergePages({{MakeItem(1, 300, 1, 0), MakeItem(2, 200, 2, 1),
+               MakeItem(3, 100, 1, 1)}});
+  ExpectMatchesTruth();
+  EXPECT_EQ(lists_[1], (std::vector<uint32_t>{1, 2}));
+
+  EXPECT_TRUE(Remove(42).empty());
+
+  const auto ops = Remove(2);
+  ExpectMatchesTruth();
+  const auto removes_user_group = [](const Op& op) {
+    return op.scope == Scope::kUserGroups && op.kind == OpKind::kRemove &&
+           op.key == 2;
+  };
+  EXPECT_EQ(std::count_if(ops.begin(), ops.end(), removes_user_group), 1);
+  EXPECT_EQ(lists_[1], (std::vector<uint32_t>{1}));
+
+  // 删除分组中最新的一条，分组保留并更新
+  Remove(1);
+  ExpectMatchesTruth();
+  std::vector<uint32_t> members;
+  merger_.Members(Scope::kUserGroups, 1, &members);
+  EXPECT_EQ(members, (std::vector<uint32_t>{3}));
+
+  Remove(3);
+  ExpectMatchesTruth();
+  EXPECT_EQ(merger_.size(), 0u);
+  EXPECT_TRUE(lists_[1].empty());
+  EXPECT_TRUE(lists_[2].empty());
+}
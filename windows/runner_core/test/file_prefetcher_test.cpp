@@ -0,0 +1,71 @@
+#include "file_prefetcher.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+
+#include "test_utils.h"
+
+namespace fs = std::filesystem;
+
+class FilePrefetcherTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    root_ = MakeTempDirectory("file_prefetcher");
+    WriteTestFile(root_ / "data/app.so", std::string(5000, 'x'));
+    WriteTestFile(root_ / "data/icudtl.dat", std::string(3000, 'x'));
+    WriteTestFile(root_ / "data/assets/big.bin", std::string(900, 'x'));
+    WriteTestFile(root_ / "data/assets/AssetManifest.bin", std::string(10, 'x'));
+    WriteTestFile(root_ / "data/assets/fonts/f.ttf", std::string(400, 'x'));
+    entries_ = {"data/app.so", "data/assets/fonts/f.ttf", "data/missing",
+                "data/assets", "data/icudtl.dat"};
+  }
+
+  fs::path root_;
+  std::vector<fs::path> entries_;
+};
+
+// 目录按文件名展开，已经列出的文件不重复。
+TEST_F(FilePrefetcherTest, ExpandsInListOrder) {
+  const auto items = FilePrefetcher::Expand(root_, entries_);
+  ASSERT_EQ(items.size(), 5u);
+  EXPECT_EQ(items[0].path.filename(), "app.so");
+  EXPECT_EQ(items[1].path.filename(), "f.ttf");
+  EXPECT_EQ(items[2].path.filename(), "AssetManifest.bin");
+  EXPECT_EQ(items[3].path.filename(), "big.bin");
+  EXPECT_EQ(items[4].path.filename(), "icudtl.dat");
+}
+
+TEST_F(FilePrefetcherTest, StopsAtByteBudget) {
+  auto stats = FilePrefetcher::Run(root_, entries_, 1u << 20, nullptr);
+  EXPECT_EQ(stats.files, 5u);
+  EXPECT_EQ(stats.bytes, 9310u);
+  EXPECT_EQ(stats.skipped, 0u);
+
+  stats = FilePrefetcher::Run(root_, entries_, 6000, nullptr);
+  EXPECT_EQ(stats.files, 3u);
+  EXPECT_EQ(stats.bytes, 5410u);
+  EXPECT_EQ(stats.skipped, 2u);
+
+  const std::atomic<bool> cancel{true};
+  EXPECT_EQ(FilePrefetcher::Run(root_, entries_, 1u << 20, &cancel).files, 0u);
+}
+
+TEST_F(FilePrefetcherTest, ReadsListFile) {
+  WriteTestFile(root_ / "list.txt", "# comment\n\n  data/app.so \r\ndata/assets\n");
+  EXPECT_EQ(FilePrefetcher::ReadList(root_ / "list.txt"),
+            (std::vector<fs::path>{"data/app.so", "data/assets"}));
+}
+
+TEST_F(FilePrefetcherTest, RunsOnBackgroundThread) {
+  FilePrefetcher prefetcher;
+  ASSERT_TRUE(prefetcher.Start(root_, entries_, 1u << 20));
+  EXPECT_FALSE(prefetcher.Start(root_, entries_, 1));
+  prefetcher.Wait();
+  EXPECT_TRUE(prefetcher.done());
+  EXPECT_EQ(prefetcher.stats().files, 5u);
+  // 析构时取消并等待
+  FilePrefetcher abandoned;
+  abandoned.Start(root_, entries_, 1u << 20);
+}
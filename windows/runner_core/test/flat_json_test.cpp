@@ -0,0 +1,198 @@
+#include "flat_json.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 按 flat_json.h 的布局读取解码结果。
+class Document {
+ public:
+  bool Parse(const std::string& json, size_t* error_offset = nullptr) {
+    return ParseFlatJson(reinterpret_cast<const uint8_t*>(json.data()),
+                         json.size(), &bytes_, error_offset);
+  }
+
+  FlatJsonHeader header() const {
+    FlatJsonHeader header;
+    std::memcpy(&header, bytes_.data(), sizeof(header));
+    return header;
+  }
+
+  FlatJsonNode node(size_t index) const {
+    FlatJsonNode node;
+    std::memcpy(&node,
+                bytes_.data() + sizeof(FlatJsonHeader) +
+                    index * sizeof(FlatJsonNode),
+                sizeof(node));
+    return node;
+  }
+
+  FlatJsonType type(size_t index) const {
+    return static_cast<FlatJsonType>(node(index).type);
+  }
+
+  std::string string(size_t index) const {
+    const FlatJsonNode string_node = node(index);
+    const size_t start = sizeof(FlatJsonHeader) +
+                         header().node_count * sizeof(FlatJsonNode) +
+                         static_cast<size_t>(string_node.b);
+    return std::string(reinterpret_cast<const char*>(bytes_.data() + start),
+                       string_node.a);
+  }
+
+  int64_t integer(size_t index) const {
+    return static_cast<int64_t>(node(index).b);
+  }
+
+  double real(size_t index) const {
+    const uint64_t bits = node(index).b;
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  size_t size() const { return bytes_.size(); }
+
+ private:
+  std::vector<uint8_t> bytes_;
+};
+
+}  // namespace
+
+TEST(FlatJsonTest, DecodesScalars) {
+  Document document;
+  ASSERT_TRUE(document.Parse(
+      R"([null, true, false, 0, -42, 9223372036854775807, 1.5, -2e3, "x"])"));
+  const FlatJsonHeader header = document.header();
+  EXPECT_EQ(header.magic, kFlatJsonMagic);
+  EXPECT_EQ(header.node_count, 10u);
+  EXPECT_EQ(document.type(0), FlatJsonType::kArray);
+  EXPECT_EQ(document.node(0).a, 9u);
+  EXPECT_EQ(document.node(0).b, 10u);
+  EXPECT_EQ(document.type(1), FlatJsonType::kNull);
+  EXPECT_EQ(document.type(2), FlatJsonType::kTrue);
+  EXPECT_EQ(document.type(3), FlatJsonType::kFalse);
+  EXPECT_EQ(document.integer(4), 0);
+  EXPECT_EQ(document.integer(5), -42);
+  EXPECT_EQ(document.integer(6), INT64_MAX);
+  EXPECT_EQ(document.type(7), FlatJsonType::kDouble);
+  EXPECT_EQ(document.real(7), 1.5);
+  EXPECT_EQ(document.real(8), -2000.0);
+  EXPECT_EQ(document.string(9), "x");
+}
+
+// 超出 int64 的整数和 double.parse 一样存为 double。
+TEST(FlatJsonTest, StoresOutOfRangeNumbersAsDouble) {
+  Document document;
+  ASSERT_TRUE(document.Parse("[9223372036854775808, 1e400, -1e400, 1e-400]"));
+  EXPECT_EQ(document.type(1), FlatJsonType::kDouble);
+  EXPECT_EQ(document.real(1), 9223372036854775808.0);
+  EXPECT_EQ(document.real(2), std::numeric_limits<double>::infinity());
+  EXPECT_EQ(document.real(3), -std::numeric_limits<double>::infinity());
+  EXPECT_EQ(document.real(4), 0.0);
+}
+
+TEST(FlatJsonTest, UnescapesStrings) {
+  Document document;
+  ASSERT_TRUE(document.Parse(
+      R"(["a\"b\\c\/d", "\b\f\n\r\t", "\u4e2d\u6587", "\ud83c\udfae",)"
+      R"( "\ud800x", "塞尔达"])"));
+  EXPECT_EQ(document.string(1), "a\"b\\c/d");
+  EXPECT_EQ(document.string(2), "\b\f\n\r\t");
+  EXPECT_EQ(document.string(3), "中文");
+  EXPECT_EQ(document.string(4), "\xF0\x9F\x8E\xAE");  // U+1F3AE
+  // 落单的代理项替换为 U+FFFD
+  EXPECT_EQ(document.string(5), "\xEF\xBF\xBD" "x");
+  EXPECT_EQ(document.string(6), "塞尔达");
+}
+
+// 引号和转义落在 64 字节块的边界上时，SIMD 索引仍要正确配对。
+TEST(FlatJsonTest, HandlesEscapesAcrossBlockBoundaries) {
+  for (size_t padding = 0; padding < 70; ++padding) {
+    const std::string value = std::string(padding, 'p') + "\\\\\\\"q";
+    const std::string json = "[\"" + value + "\",\"" + value + "\"]";
+    Document document;
+    ASSERT_TRUE(document.Parse(json)) << padding;
+    const std::string expected = std::string(padding, 'p') + "\\\"q";
+    EXPECT_EQ(document.string(1), expected) << padding;
+    EXPECT_EQ(document.string(2), expected) << padding;
+  }
+}
+
+// 容器的 b 指向子树之后的节点，重复出现的键只存一份。
+TEST(FlatJsonTest, LinksNestedContainersAndSharesKeys) {
+  Document document;
+  ASSERT_TRUE(document.Parse(
+      R"({"games": [{"id": 1, "tags": ["a"]}, {"id": 2, "tags": []}],)"
+      R"( "total": 2})"));
+  EXPECT_EQ(document.type(0), FlatJsonType::kObject);
+  EXPECT_EQ(document.node(0).a, 2u);
+  EXPECT_EQ(document.node(0).b, 16u);
+  EXPECT_EQ(document.string(1), "games");
+  EXPECT_EQ(document.type(2), FlatJsonType::kArray);
+  EXPECT_EQ(document.node(2).b, 14u);
+  EXPECT_EQ(document.node(3).b, 9u);
+  EXPECT_EQ(document.node(7).b, 9u);
+  EXPECT_EQ(document.node(9).b, 14u);
+  EXPECT_EQ(document.string(14), "total");
+  EXPECT_EQ(document.integer(15), 2);
+
+  EXPECT_EQ(document.node(4).b, document.node(10).b);  // "id"
+  EXPECT_EQ(document.node(6).b, document.node(12).b);  // "tags"
+  // "games" "id" "tags" "a" "total"，第二个对象的键不再写入
+  EXPECT_EQ(document.header().string_bytes, 17u);
+}
+
+TEST(FlatJsonTest, LimitsNestingDepth) {
+  const auto nested = [](uint32_t depth) {
+    return std::string(depth, '[') + std::string(depth, ']');
+  };
+  Document document;
+  EXPECT_TRUE(document.Parse(nested(kFlatJsonMaxDepth)));
+  size_t error_offset = 0;
+  EXPECT_FALSE(document.Parse(nested(kFlatJsonMaxDepth + 1), &error_offset));
+  EXPECT_EQ(error_offset, kFlatJsonMaxDepth);
+}
+
+TEST(FlatJsonTest, RejectsMalformedInput) {
+  const struct {
+    const char* json;
+    size_t error_offset;
+  } cases[] = {
+      {"", 0},
+      {"[1,]", 3},
+      {"[1 2]", 3},
+      {"{\"a\" 1}", 5},
+      {"{a:1}", 1},
+      {"{\"a\":1,}", 7},
+      {"[\"abc", 5},
+      {"[\"a\nb\"]", 3},
+      {"[\"\\x\"]", 2},
+      {"[\"\\u12g4\"]", 2},
+      {"[01]", 2},
+      {"[1.]", 3},
+      {"[-]", 1},
+      {"[1e+]", 4},
+      {"[tru]", 1},
+      {"nul", 0},
+      {"[1] x", 4},
+      {"[1", 2},
+  };
+  for (const auto& test_case : cases) {
+    Document document;
+    size_t error_offset = 99;
+    EXPECT_FALSE(document.Parse(test_case.json, &error_offset))
+        << test_case.json;
+    EXPECT_EQ(error_offset, test_case.error_offset) << test_case.json;
+  }
+}
+
+TEST(FlatJsonTest, AcceptsSurroundingWhitespace) {
+  Document document;
+  ASSERT_TRUE(document.Parse(" \r\n\t{ \"a\" : [ ] } \n"));
+  EXPECT_EQ(document.header().node_count, 3u);
+}
@@ -0,0 +1,119 @@
+#include "font_subset.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "font_subset_cache.h"
+#include "test_utils.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const std::vector<uint8_t>& Font() {
+  static const std::vector<uint8_t> font = ReadTestFile(RUNNER_CORE_TEST_FONT);
+  return font;
+}
+
+}  // namespace
+
+TEST(FontSubsetTest, KeepsRequestedCodePoints) {
+  const auto& font = Font();
+  ASSERT_FALSE(font.empty());
+  const std::vector<uint32_t> all = FontCodePoints(font.data(), font.size());
+  ASSERT_GT(all.size(), 8000u);
+
+  std::vector<uint32_t> wanted;
+  for (uint32_t c = 0x20; c < 0x7F; ++c) {
+    wanted.push_back(c);
+  }
+  for (uint32_t c : {0x9996u, 0x9875u, 0x6E38u, 0x620Fu}) {  // 首页游戏
+    wanted.push_back(c);
+  }
+  wanted.push_back(0x1F600);  // 字体里没有
+  std::vector<uint8_t> subset;
+  ASSERT_TRUE(SubsetTrueTypeFont(font.data(), font.size(), wanted, &subset));
+  EXPECT_LT(subset.size(), font.size() / 10);
+
+  std::vector<uint32_t> expected;
+  for (uint32_t c : wanted) {
+    if (std::binary_search(all.begin(), all.end(), c)) {
+      expected.push_back(c);
+    }
+  }
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(FontCodePoints(subset.data(), subset.size()), expected);
+}
+
+TEST(FontSubsetTest, RejectsTruncatedFonts) {
+  const auto& font = Font();
+  ASSERT_FALSE(font.empty());
+  std::vector<uint8_t> subset;
+  for (size_t size = 0; size < 4000; size += 97) {
+    EXPECT_FALSE(SubsetTrueTypeFont(font.data(), size, {0x4E00}, &subset));
+  }
+}
+
+class FontSubsetCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // 每个测试各用一个目录，ctest 并行运行时互不干扰
+    directory_ = MakeTempDirectory(
+        std::string("font_subset_cache_") +
+        ::testing::UnitTest::GetInstance()->current_test_info()->name());
+    font_ = directory_ / "NotoSansSC-Regular.ttf";
+    fs::copy_file(RUNNER_CORE_TEST_FONT, font_);
+  }
+
+  fs::path directory_;
+  fs::path font_;
+};
+
+TEST_F(FontSubsetCacheTest, BuildsReusesAndReplacesSubsets) {
+  const fs::path cache_dir = directory_ / "cache";
+  FontSubsetCache::BuildResult first;
+  FontSubsetCache::BuildResult second;
+  FontSubsetCache::BuildResult third;
+  {
+    FontSubsetCache cache(cache_dir, font_);
+    EXPECT_TRUE(cache.Lookup().empty());
+    // ASCII、无效和截断的序列都不记录
+    cache.RecordUtf8("首页热门游戏 \xff\xfe abc \xe4\xb8");
+    EXPECT_EQ(cache.recorded_count(), 6u);
+    ASSERT_TRUE(cache.Build(&first));
+    EXPECT_FALSE(first.reused);
+    EXPECT_TRUE(fs::exists(first.path));
+    EXPECT_EQ(cache.Lookup(), first.path);
+
+    ASSERT_TRUE(cache.Build(&second));
+    EXPECT_TRUE(second.reused);
+    EXPECT_EQ(second.path, first.path);
+
+    cache.RecordUtf8("最新帖子");
+    ASSERT_TRUE(cache.Build(&third));
+    EXPECT_FALSE(third.reused);
+    EXPECT_EQ(third.code_points, first.code_points + 4);
+    EXPECT_FALSE(fs::exists(first.path));  // 旧子集被删除
+  }
+  {
+    // 记录的字符跨次运行累积
+    FontSubsetCache cache(cache_dir, font_);
+    EXPECT_EQ(cache.recorded_count(), 10u);
+    EXPECT_EQ(cache.Lookup(), third.path);
+  }
+  // 字体更新后旧子集失效
+  fs::last_write_time(font_,
+                      fs::last_write_time(font_) + std::chrono::hours(1));
+  FontSubsetCache cache(cache_dir, font_);
+  EXPECT_TRUE(cache.Lookup().empty());
+}
+
+TEST_F(FontSubsetCacheTest, FailsWithoutFont) {
+  FontSubsetCache cache(directory_ / "cache", directory_ / "missing.ttf");
+  FontSubsetCache::BuildResult result;
+  EXPECT_FALSE(cache.Build(&result));
+}
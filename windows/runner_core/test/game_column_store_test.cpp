@@ -0,0 +1,152 @@
+#include "game_column_store.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "roaring_bitmap.h"
+
+TEST(RoaringBitmapTest, MatchesStdSet) {
+  std::mt19937 rng(1);
+  for (int round = 0; round < 20; ++round) {
+    RoaringBitmap a;
+    RoaringBitmap b;
+    std::set<uint32_t> set_a;
+    std::set<uint32_t> set_b;
+    // 稀疏和稠密的容器都要覆盖
+    const uint32_t range = round % 2 ? 200000 : 70000;
+    const int count = static_cast<int>(rng() % 20000);
+    for (int i = 0; i < count; ++i) {
+      const uint32_t value = rng() % range;
+      a.Add(value);
+      set_a.insert(value);
+      const uint32_t other = rng() % range;
+      b.Add(other);
+      set_b.insert(other);
+    }
+    for (int i = 0; i < count / 2; ++i) {
+      const uint32_t value = rng() % range;
+      a.Remove(value);
+      set_a.erase(value);
+    }
+    ASSERT_EQ(a.Cardinality(), set_a.size());
+    std::vector<uint32_t> values;
+    a.AppendTo(&values);
+    ASSERT_EQ(values, std::vector<uint32_t>(set_a.begin(), set_a.end()));
+
+    std::vector<uint32_t> expected;
+    std::set_intersection(set_a.begin(), set_a.end(), set_b.begin(),
+                          set_b.end(), std::back_inserter(expected));
+    std::vector<uint32_t> intersection;
+    RoaringBitmap::And(a, b).AppendTo(&intersection);
+    ASSERT_EQ(intersection, expected);
+  }
+}
+
+namespace {
+
+struct Game {
+  GameRecord record;
+  std::string category;
+  std::vector<std::string> tags;
+};
+
+}  // namespace
+
+// 随机的增删改与暴力筛选排序对照。
+TEST(GameColumnStoreTest, QueriesMatchBruteForce) {
+  std::mt19937 rng(7);
+  const char* categories[] = {"", "action", "rpg", "avg", "slg"};
+  std::map<uint32_t, Game> truth;
+  GameColumnStore store;
+
+  for (int step = 0; step < 2000; ++step) {
+    const uint32_t handle = 1 + rng() % 1000;
+    if (rng() % 10 < 7) {
+      Game& game = truth[handle];
+      game.category = categories[rng() % 5];
+      game.tags.clear();
+      for (uint32_t i = rng() % 4; i > 0; --i) {
+        game.tags.push_back("t" + std::to_string(rng() % 30));
+      }
+      GameRecord& record = game.record;
+      record.handle = handle;
+      record.create_time = rng() % 1000;
+      record.update_time = rng() % 1000;
+      record.view_count = rng() % 50;
+      record.like_count = rng() % 50;
+      record.rating = (rng() % 10) / 2.0;
+      record.category = game.category;
+      record.tags.assign(game.tags.begin(), game.tags.end());
+      store.Upsert(&record, 1);
+    } else {
+      const bool existed = truth.erase(handle) > 0;
+      ASSERT_EQ(store.Remove(handle), existed);
+    }
+    if (step % 50 != 0) {
+      continue;
+    }
+    for (int q = 0; q < 20; ++q) {
+      const std::string category = rng() % 2 ? categories[1 + rng() % 4] : "";
+      const std::string tag = rng() % 2 ? "t" + std::to_string(rng() % 32) : "";
+      GameQuery query;
+      query.category = category;
+      query.tag = tag;
+      query.sort_key = static_cast<GameSortKey>(rng() % kGameSortKeyCount);
+      query.descending = rng() % 2;
+      query.offset = rng() % 40;
+      query.limit = 1 + rng() % 30;
+
+      std::vector<const GameRecord*> rows;
+      for (const auto& entry : truth) {
+        const Game& game = entry.second;
+        if (!category.empty() && game.category != category) {
+          continue;
+        }
+        if (!tag.empty() && std::find(game.tags.begin(), game.tags.end(),
+                                      tag) == game.tags.end()) {
+          continue;
+        }
+        rows.push_back(&game.record);
+      }
+      auto key = [&](const GameRecord* r) {
+        switch (query.sort_key) {
+          case GameSortKey::kCreateTime:
+            return static_cast<double>(r->create_time);
+          case GameSortKey::kUpdateTime:
+            return static_cast<double>(r->update_time);
+          case GameSortKey::kViewCount:
+            return static_cast<double>(r->view_count);
+          case GameSortKey::kRating:
+            return r->rating;
+          case GameSortKey::kLikeCount:
+            return static_cast<double>(r->like_count);
+        }
+        return 0.0;
+      };
+      std::sort(rows.begin(), rows.end(),
+                [&](const GameRecord* a, const GameRecord* b) {
+                  const double x = key(a);
+                  const double y = key(b);
+                  return x != y ? x < y : a->handle < b->handle;
+                });
+      if (query.descending) {
+        std::reverse(rows.begin(), rows.end());
+      }
+      std::vector<uint32_t> expected;
+      for (size_t i = query.offset;
+           i < rows.size() && expected.size() < query.limit; ++i) {
+        expected.push_back(rows[i]->handle);
+      }
+      std::vector<uint32_t> handles;
+      ASSERT_EQ(store.Query(query, &handles), rows.size());
+      ASSERT_EQ(handles, expected) << "step " << step;
+    }
+  }
+}
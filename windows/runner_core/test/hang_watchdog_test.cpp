@@ -0,0 +1,173 @@
+#include "hang_watchdog.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rotating_log.h"
+#include "startup_trace.h"
+#include "test_utils.h"
+
+namespace {
+
+using Event = HangDetector::Event;
+
+constexpr int64_t kThresholdUs = 2000000;
+
+}  // namespace
+
+TEST(HangDetectorTest, ShortBusyPeriodIsNotAStall) {
+  HangDetector detector;
+  EXPECT_FALSE(detector.Poll(1000000, kThresholdUs).ping);
+  detector.Busy(0x113, 1000000);
+  EXPECT_FALSE(detector.Poll(1200000, kThresholdUs).ping);
+  // 忙碌达到阈值的四分之一时发出心跳
+  const auto action = detector.Poll(1500000, kThresholdUs);
+  EXPECT_TRUE(action.ping);
+  EXPECT_EQ(action.event, Event::kNone);
+  detector.Pong(1510000);
+  detector.Idle();
+  EXPECT_EQ(detector.Poll(1600000, kThresholdUs).event, Event::kNone);
+}
+
+TEST(HangDetectorTest, ReportsBeginAndEndOnce) {
+  HangDetector detector;
+  detector.Busy(0x0f, 10000000);
+  EXPECT_TRUE(detector.Poll(10600000, kThresholdUs).ping);
+  EXPECT_EQ(detector.Poll(11000000, kThresholdUs).event, Event::kNone);
+
+  auto action = detector.Poll(12000000, kThresholdUs);
+  EXPECT_EQ(action.event, Event::kBegin);
+  EXPECT_EQ(action.begin_us, 10000000);
+  EXPECT_EQ(action.duration_us, 2000000);
+  EXPECT_EQ(action.message, 0x0fu);
+  EXPECT_EQ(detector.Poll(13000000, kThresholdUs).event, Event::kNone);
+
+  detector.Pong(15000000);
+  detector.Idle();
+  action = detector.Poll(15100000, kThresholdUs);
+  EXPECT_EQ(action.event, Event::kEnd);
+  EXPECT_EQ(action.duration_us, 5000000);
+  EXPECT_EQ(detector.Poll(15200000, kThresholdUs).event, Event::kNone);
+}
+
+// 模态循环一直忙碌，但持续响应心跳。
+TEST(HangDetectorTest, ModalLoopThatAnswersPingsIsNotAStall) {
+  HangDetector detector;
+  detector.Busy(0x111, 20000000);
+  int64_t now = 20000000;
+  int64_t last_pong = 0;
+  for (int i = 0; i < 40; ++i) {
+    now += 250000;
+    const auto action = detector.Poll(now, kThresholdUs);
+    ASSERT_EQ(action.event, Event::kNone);
+    if (action.ping) {
+      detector.Pong(last_pong = now + 1000);
+    }
+  }
+  ASSERT_GT(last_pong, 20000000);
+  // 之后卡住：从最近一次响应算起
+  for (int i = 0; i < 20; ++i) {
+    now += 250000;
+    const auto action = detector.Poll(now, kThresholdUs);
+    if (action.event == Event::kBegin) {
+      EXPECT_EQ(action.begin_us, last_pong);
+      return;
+    }
+  }
+  FAIL() << "stall not reported";
+}
+
+TEST(HangWatchdogTest, FormatsStallAsJson) {
+  HangStall stall;
+  stall.begin_unix_ms = 1700000000000;
+  stall.duration_ms = 2500;
+  stall.message = 0x113;
+  stall.span = "Pre\"Init\\";
+  stall.ongoing = true;
+  EXPECT_EQ(FormatHangStall(stall),
+            "{\"time\":1700000000000,\"duration_ms\":2500,\"message\":"
+            "\"0x0113\",\"span\":\"Pre\\\"Init\\\\\",\"ongoing\":true}");
+}
+
+// 卡顿记录里的时间段是卡住时尚未结束的最内层时间段：内层结束后回到
+// 外层，全部结束后为空，不会一直停在最后开始的那个时间段上。
+TEST(HangWatchdogTest, ReportsTheInnermostOpenSpan) {
+  std::mutex mutex;
+  std::condition_variable reported;
+  std::vector<HangStall> stalls;
+  HangWatchdog watchdog;
+  ASSERT_TRUE(watchdog.Start(
+      40, [] {},
+      [] {
+        const char* span = StartupTrace::GetInstance().watched_span();
+        return std::string(span ? span : "");
+      },
+      [&](const HangStall& stall) {
+        std::lock_guard<std::mutex> lock(mutex);
+        stalls.push_back(stall);
+        reported.notify_all();
+      }));
+  // 等到第 |count| 条记录，返回它的时间段
+  auto wait_for_stall = [&](size_t count) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!reported.wait_for(lock, std::chrono::seconds(5),
+                           [&] { return stalls.size() >= count; })) {
+      return std::string("<timeout>");
+    }
+    return stalls[count - 1].span;
+  };
+
+  // 在单独的线程上模拟平台线程，监视标记不影响其它测试
+  std::thread platform([&] {
+    StartupTrace::GetInstance().WatchCurrentThread();
+    {
+      ScopedTraceSpan outer("PreInit");
+      { ScopedTraceSpan inner("RegisterPlugins"); }
+      watchdog.Busy(0x0f);
+      EXPECT_EQ(wait_for_stall(1), "PreInit");
+      watchdog.Pong();
+      watchdog.Idle();
+      EXPECT_EQ(wait_for_stall(2), "PreInit");
+    }
+    EXPECT_EQ(StartupTrace::GetInstance().watched_span(), nullptr);
+    watchdog.Busy(0x113);
+    EXPECT_EQ(wait_for_stall(3), "");
+    watchdog.Pong();
+    watchdog.Idle();
+    EXPECT_EQ(wait_for_stall(4), "");
+  });
+  platform.join();
+  watchdog.Stop();
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_EQ(stalls.size(), 4u);
+  EXPECT_TRUE(stalls[0].ongoing);
+  EXPECT_FALSE(stalls[1].ongoing);
+}
+
+TEST(RotatingLogTest, KeepsAtMostMaxFiles) {
+  const auto directory = MakeTempDirectory("rotating_log");
+  RotatingLog log(directory / "stalls.log", 100, 3);
+  for (int i = 0; i < 20; ++i) {
+    ASSERT_TRUE(log.Append("line " + std::to_string(i) +
+                           " 0123456789012345678901234567890"));
+  }
+  EXPECT_TRUE(std::filesystem::exists(directory / "stalls.log.1"));
+  EXPECT_TRUE(std::filesystem::exists(directory / "stalls.log.2"));
+  EXPECT_FALSE(std::filesystem::exists(directory / "stalls.log.3"));
+  EXPECT_LE(std::filesystem::file_size(directory / "stalls.log"), 100u);
+
+  std::ifstream in(directory / "stalls.log");
+  std::string line;
+  std::string last;
+  while (std::getline(in, line)) {
+    last = line;
+  }
+  EXPECT_EQ(last.rfind("line 19 ", 0), 0u);
+}
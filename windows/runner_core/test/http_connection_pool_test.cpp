@@ -0,0 +1,268 @@
+#include "http_connection_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// 内存中的连接，记录建立、发送和并发数，可以让下一次发送失败或阻塞。
+struct FakeNetwork {
+  std::mutex mutex;
+  std::condition_variable changed;
+  int created = 0;
+  int warmed = 0;
+  int sends = 0;
+  int active = 0;
+  int peak_active = 0;
+  int fail_next_sends = 0;
+  bool blocked = false;
+  std::vector<int> send_connection_ids;
+};
+
+class FakeConnection : public HttpConnection {
+ public:
+  FakeConnection(FakeNetwork* network, int id) : network_(network), id_(id) {}
+
+  bool Warm(std::string* error) override {
+    std::lock_guard<std::mutex> lock(network_->mutex);
+    ++network_->warmed;
+    (void)error;
+    return true;
+  }
+
+  bool Send(const HttpRequest& request,
+            HttpResponse* response,
+            std::string* error) override {
+    std::unique_lock<std::mutex> lock(network_->mutex);
+    ++network_->sends;
+    network_->send_connection_ids.push_back(id_);
+    if (network_->fail_next_sends > 0) {
+      --network_->fail_next_sends;
+      reusable_ = false;
+      *error = "connection reset";
+      return false;
+    }
+    ++network_->active;
+    network_->peak_active = std::max(network_->peak_active, network_->active);
+    network_->changed.notify_all();
+    network_->changed.wait(lock, [this] { return !network_->blocked; });
+    --network_->active;
+    response->status_code = 200;
+    response->body = request.method + " " + request.path;
+    return true;
+  }
+
+  bool reusable() const override { return reusable_; }
+
+ private:
+  FakeNetwork* network_;
+  int id_;
+  bool reusable_ = true;
+};
+
+class FakeFactory : public HttpConnectionFactory {
+ public:
+  explicit FakeFactory(FakeNetwork* network) : network_(network) {}
+
+  std::unique_ptr<HttpConnection> Create(const HttpOrigin& origin) override {
+    (void)origin;
+    std::lock_guard<std::mutex> lock(network_->mutex);
+    return std::make_unique<FakeConnection>(network_, ++network_->created);
+  }
+
+ private:
+  FakeNetwork* network_;
+};
+
+HttpOrigin Origin(const char* host) {
+  HttpOrigin origin;
+  origin.host = host;
+  return origin;
+}
+
+HttpRequest Request(const char* method, const char* path) {
+  HttpRequest request;
+  request.method = method;
+  request.path = path;
+  return request;
+}
+
+}  // namespace
+
+TEST(HttpConnectionPoolTest, ParsesUrls) {
+  HttpOrigin origin;
+  std::string path;
+  ASSERT_TRUE(ParseHttpUrl("https://API.example.com:8443/v1/games?page=2",
+                           &origin, &path));
+  EXPECT_TRUE(origin.secure);
+  EXPECT_EQ(origin.port, 8443);
+  EXPECT_EQ(path, "/v1/games?page=2");
+  EXPECT_EQ(origin.ToString(), "https://" + origin.host + ":8443");
+
+  ASSERT_TRUE(ParseHttpUrl("http://localhost?x=1", &origin, &path));
+  EXPECT_FALSE(origin.secure);
+  EXPECT_EQ(origin.port, 80);
+  EXPECT_EQ(path, "/?x=1");
+
+  EXPECT_FALSE(ParseHttpUrl("ftp://example.com/", &origin, &path));
+  EXPECT_FALSE(ParseHttpUrl("https://", &origin, &path));
+}
+
+TEST(HttpConnectionPoolTest, ReusesIdleConnections) {
+  FakeNetwork network;
+  HttpConnectionPool pool(std::make_unique<FakeFactory>(&network),
+                          HttpConnectionPool::Options());
+  HttpResponse response;
+  std::string error;
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(pool.Execute(Origin("api.example.com"),
+                             Request("GET", "/games"), &response, &error));
+    EXPECT_EQ(response.body, "GET /games");
+  }
+  ASSERT_TRUE(pool.Execute(Origin("cdn.example.com"), Request("GET", "/a.png"),
+                           &response, &error));
+
+  const auto stats = pool.stats();
+  EXPECT_EQ(stats.connections_opened, 2u);
+  EXPECT_EQ(stats.connections_reused, 2u);
+  EXPECT_EQ(pool.idle_count(Origin("api.example.com")), 1u);
+  EXPECT_EQ(pool.idle_count(Origin("cdn.example.com")), 1u);
+}
+
+// 预热的连接受并发上限约束，之后的请求直接复用。
+TEST(HttpConnectionPoolTest, PrewarmedConnectionsServeTheFirstRequests) {
+  FakeNetwork network;
+  HttpConnectionPool::Options options;
+  options.max_connections_per_host = 2;
+  HttpConnectionPool pool(std::make_unique<FakeFactory>(&network), options);
+  EXPECT_EQ(pool.Prewarm(Origin("api.example.com"), 5), 2u);
+  EXPECT_EQ(network.warmed, 2);
+  EXPECT_EQ(pool.idle_count(Origin("api.example.com")), 2u);
+
+  HttpResponse response;
+  std::string error;
+  ASSERT_TRUE(pool.Execute(Origin("api.example.com"), Request("GET", "/"),
+                           &response, &error));
+  EXPECT_EQ(network.created, 2);
+  EXPECT_EQ(pool.stats().connections_reused, 1u);
+}
+
+TEST(HttpConnectionPoolTest, LimitsConcurrentConnectionsPerOrigin) {
+  FakeNetwork network;
+  network.blocked = true;
+  HttpConnectionPool::Options options;
+  options.max_connections_per_host = 2;
+  HttpConnectionPool pool(std::make_unique<FakeFactory>(&network), options);
+
+  std::atomic<int> succeeded{0};
+  std::vector<std::thread> clients;
+  for (int i = 0; i < 5; ++i) {
+    clients.emplace_back([&] {
+      HttpResponse response;
+      std::string error;
+      if (pool.Execute(Origin("api.example.com"), Request("GET", "/"),
+                       &response, &error)) {
+        ++succeeded;
+      }
+    });
+  }
+  {
+    std::unique_lock<std::mutex> lock(network.mutex);
+    ASSERT_TRUE(network.changed.wait_for(lock, 5s,
+                                         [&] { return network.active == 2; }));
+    network.blocked = false;
+    network.changed.notify_all();
+  }
+  for (auto& client : clients) {
+    client.join();
+  }
+  EXPECT_EQ(succeeded.load(), 5);
+  EXPECT_EQ(network.peak_active, 2);
+  EXPECT_EQ(network.created, 2);
+}
+
+TEST(HttpConnectionPoolTest, TimesOutWaitingForAConnection) {
+  FakeNetwork network;
+  network.blocked = true;
+  HttpConnectionPool::Options options;
+  options.max_connections_per_host = 1;
+  options.acquire_timeout = 50ms;
+  HttpConnectionPool pool(std::make_unique<FakeFactory>(&network), options);
+
+  std::thread holder([&] {
+    HttpResponse response;
+    std::string error;
+    pool.Execute(Origin("api.example.com"), Request("GET", "/slow"), &response,
+                 &error);
+  });
+  {
+    std::unique_lock<std::mutex> lock(network.mutex);
+    ASSERT_TRUE(network.changed.wait_for(lock, 5s,
+                                         [&] { return network.active == 1; }));
+  }
+  HttpResponse response;
+  std::string error;
+  EXPECT_FALSE(pool.Execute(Origin("api.example.com"), Request("GET", "/"),
+                            &response, &error));
+  EXPECT_NE(error.find("Timed out"), std::string::npos);
+  {
+    std::lock_guard<std::mutex> lock(network.mutex);
+    network.blocked = false;
+    network.changed.notify_all();
+  }
+  holder.join();
+  EXPECT_EQ(pool.stats().requests_failed, 1u);
+}
+
+// 复用的连接已被服务器关闭时，幂等请求换一条新连接重试一次。
+TEST(HttpConnectionPoolTest, RetriesIdempotentRequestsOnAStaleConnection) {
+  FakeNetwork network;
+  HttpConnectionPool pool(std::make_unique<FakeFactory>(&network),
+                          HttpConnectionPool::Options());
+  HttpResponse response;
+  std::string error;
+  ASSERT_TRUE(pool.Execute(Origin("api.example.com"), Request("GET", "/"),
+                           &response, &error));
+
+  network.fail_next_sends = 1;
+  ASSERT_TRUE(pool.Execute(Origin("api.example.com"), Request("GET", "/again"),
+                           &response, &error));
+  EXPECT_EQ(response.body, "GET /again");
+  EXPECT_EQ(network.send_connection_ids, (std::vector<int>{1, 1, 2}));
+
+  // POST 不重试；新建的连接失败也不重试
+  network.fail_next_sends = 1;
+  EXPECT_FALSE(pool.Execute(Origin("api.example.com"), Request("POST", "/"),
+                            &response, &error));
+  network.fail_next_sends = 1;
+  EXPECT_FALSE(pool.Execute(Origin("fresh.example.com"), Request("GET", "/"),
+                            &response, &error));
+  EXPECT_EQ(pool.stats().requests_failed, 2u);
+}
+
+TEST(HttpConnectionPoolTest, EvictsIdleConnections) {
+  FakeNetwork network;
+  HttpConnectionPool::Options options;
+  options.idle_timeout = 1ms;
+  HttpConnectionPool pool(std::make_unique<FakeFactory>(&network), options);
+  HttpResponse response;
+  std::string error;
+  ASSERT_TRUE(pool.Execute(Origin("api.example.com"), Request("GET", "/"),
+                           &response, &error));
+  EXPECT_EQ(pool.idle_count(Origin("api.example.com")), 1u);
+  std::this_thread::sleep_for(20ms);
+  EXPECT_EQ(pool.EvictIdle(), 1u);
+  EXPECT_EQ(pool.idle_count(Origin("api.example.com")), 0u);
+  EXPECT_EQ(pool.stats().connections_evicted, 1u);
+}
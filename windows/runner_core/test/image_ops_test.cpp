@@ -0,0 +1,172 @@
+#include "image_ops.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+PixelBuffer SolidImage(uint32_t width,
+                       uint32_t height,
+                       uint8_t b,
+                       uint8_t g,
+                       uint8_t r,
+                       uint8_t a) {
+  PixelBuffer image;
+  image.Allocate(width, height);
+  for (size_t i = 0; i < image.pixels.size(); i += 4) {
+    image.pixels[i] = b;
+    image.pixels[i + 1] = g;
+    image.pixels[i + 2] = r;
+    image.pixels[i + 3] = a;
+  }
+  return image;
+}
+
+const uint8_t* Pixel(const PixelBuffer& image, uint32_t x, uint32_t y) {
+  return image.row(y) + static_cast<size_t>(x) * 4;
+}
+
+// 所有像素与 (b, g, r, a) 的差都不超过 |tolerance|。
+::testing::AssertionResult IsSolid(const PixelBuffer& image,
+                                   const uint8_t (&expected)[4],
+                                   int tolerance) {
+  for (uint32_t y = 0; y < image.height; ++y) {
+    for (uint32_t x = 0; x < image.width; ++x) {
+      const uint8_t* pixel = Pixel(image, x, y);
+      for (int c = 0; c < 4; ++c) {
+        if (std::abs(pixel[c] - expected[c]) > tolerance) {
+          return ::testing::AssertionFailure()
+                 << "pixel (" << x << ", " << y << ") channel " << c << " is "
+                 << static_cast<int>(pixel[c]) << ", expected "
+                 << static_cast<int>(expected[c]);
+        }
+      }
+    }
+  }
+  return ::testing::AssertionSuccess();
+}
+
+}  // namespace
+
+TEST(ImageOpsTest, ResamplePreservesSolidColor) {
+  const PixelBuffer source = SolidImage(640, 480, 10, 120, 250, 255);
+  const uint8_t expected[4] = {10, 120, 250, 255};
+  PixelBuffer output;
+  // 缩小、放大和非整数比例
+  for (const auto& size : {std::pair<uint32_t, uint32_t>{64, 48},
+                           std::pair<uint32_t, uint32_t>{1000, 900},
+                           std::pair<uint32_t, uint32_t>{333, 217}}) {
+    ASSERT_TRUE(ResampleRegion(source, SourceRect{0, 0, 640, 480}, size.first,
+                               size.second, &output));
+    EXPECT_EQ(output.width, size.first);
+    EXPECT_EQ(output.height, size.second);
+    EXPECT_TRUE(IsSolid(output, expected, 0));
+  }
+}
+
+TEST(ImageOpsTest, ResampleAtSameSizeIsIdentity) {
+  PixelBuffer source;
+  source.Allocate(97, 61);
+  for (size_t i = 0; i < source.pixels.size(); ++i) {
+    source.pixels[i] = static_cast<uint8_t>((i * 131) >> 3);
+  }
+  for (size_t i = 3; i < source.pixels.size(); i += 4) {
+    source.pixels[i] = 255;
+  }
+  PixelBuffer output;
+  ASSERT_TRUE(
+      ResampleRegion(source, SourceRect{0, 0, 97, 61}, 97, 61, &output));
+  EXPECT_EQ(output.pixels, source.pixels);
+}
+
+TEST(ImageOpsTest, ResampleCropsRegion) {
+  // 左半红、右半蓝，只取右半部分
+  PixelBuffer source = SolidImage(200, 100, 0, 0, 255, 255);
+  for (uint32_t y = 0; y < source.height; ++y) {
+    for (uint32_t x = 100; x < source.width; ++x) {
+      uint8_t* pixel = source.row(y) + static_cast<size_t>(x) * 4;
+      pixel[0] = 255;
+      pixel[2] = 0;
+    }
+  }
+  const uint8_t blue[4] = {255, 0, 0, 255};
+  PixelBuffer output;
+  ASSERT_TRUE(
+      ResampleRegion(source, SourceRect{110, 10, 80, 80}, 40, 40, &output));
+  EXPECT_TRUE(IsSolid(output, blue, 0));
+}
+
+// 缩小时滤波器按比例变宽：一像素的棋盘格应当平均成灰色而不是混叠。
+TEST(ImageOpsTest, DownscaleAveragesFineDetail) {
+  PixelBuffer source;
+  source.Allocate(800, 800);
+  for (uint32_t y = 0; y < source.height; ++y) {
+    for (uint32_t x = 0; x < source.width; ++x) {
+      uint8_t* pixel = source.row(y) + static_cast<size_t>(x) * 4;
+      const uint8_t value = ((x + y) & 1) ? 255 : 0;
+      pixel[0] = pixel[1] = pixel[2] = value;
+      pixel[3] = 255;
+    }
+  }
+  PixelBuffer output;
+  ASSERT_TRUE(
+      ResampleRegion(source, SourceRect{0, 0, 800, 800}, 100, 100, &output));
+  const uint8_t gray[4] = {128, 128, 128, 255};
+  EXPECT_TRUE(IsSolid(output, gray, 3));
+}
+
+TEST(ImageOpsTest, ResampleRejectsInvalidRegions) {
+  const PixelBuffer source = SolidImage(100, 100, 0, 0, 0, 255);
+  PixelBuffer output;
+  EXPECT_FALSE(ResampleRegion(source, SourceRect{0, 0, 0, 10}, 10, 10, &output));
+  EXPECT_FALSE(
+      ResampleRegion(source, SourceRect{-1, 0, 50, 50}, 10, 10, &output));
+  EXPECT_FALSE(
+      ResampleRegion(source, SourceRect{60, 0, 50, 50}, 10, 10, &output));
+  EXPECT_FALSE(
+      ResampleRegion(source, SourceRect{0, 0, 100, 100}, 0, 10, &output));
+  EXPECT_FALSE(
+      ResampleRegion(PixelBuffer(), SourceRect{0, 0, 1, 1}, 1, 1, &output));
+}
+
+TEST(ImageOpsTest, CircleMaskClearsCornersAndKeepsCenter) {
+  PixelBuffer image = SolidImage(64, 64, 200, 100, 50, 255);
+  ApplyCircleMask(&image);
+  const uint8_t transparent[4] = {0, 0, 0, 0};
+  const uint8_t* corner = Pixel(image, 0, 0);
+  EXPECT_EQ(std::vector<uint8_t>(corner, corner + 4),
+            std::vector<uint8_t>(transparent, transparent + 4));
+  const uint8_t* center = Pixel(image, 32, 32);
+  EXPECT_EQ(center[0], 200);
+  EXPECT_EQ(center[3], 255);
+  // 圆周上的像素部分透明，颜色与 alpha 按同一比例缩小（保持预乘）
+  const uint8_t* edge = Pixel(image, 32, 0);
+  EXPECT_GT(edge[3], 0);
+  EXPECT_LT(edge[3], 255);
+  EXPECT_LE(edge[0], edge[3]);
+}
+
+TEST(ImageOpsTest, UnpremultiplyAlpha) {
+  PixelBuffer image;
+  image.Allocate(3, 1);
+  const uint8_t pixels[] = {64, 32, 0, 128, 9, 9, 9, 0, 10, 20, 30, 255};
+  image.pixels.assign(std::begin(pixels), std::end(pixels));
+  UnpremultiplyAlpha(&image);
+  const std::vector<uint8_t> expected = {128, 64, 0,  128, 0,  0,
+                                         0,   0,  10, 20,  30, 255};
+  EXPECT_EQ(image.pixels, expected);
+}
+
+TEST(ImageOpsTest, FlattenOnWhite) {
+  PixelBuffer image;
+  image.Allocate(3, 1);
+  // 透明、半透明黑色和不透明红色
+  const uint8_t pixels[] = {0, 0, 0, 0, 0, 0, 0, 128, 0, 0, 255, 255};
+  image.pixels.assign(std::begin(pixels), std::end(pixels));
+  const std::vector<uint8_t> expected = {255, 255, 255, 127, 127,
+                                         127, 0,   0,   255};
+  EXPECT_EQ(FlattenOnWhite(image), expected);
+}
@@ -0,0 +1,227 @@
+#include "kv_store.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "test_utils.h"
+
+namespace {
+
+KvStore::Options SmallOptions() {
+  KvStore::Options options;
+  options.initial_capacity = 64 << 10;
+  return options;
+}
+
+bool Put(KvStore* store, const std::string& key, const std::string& value) {
+  return store->Put(key, value.data(), value.size());
+}
+
+std::string Get(const KvStore& store, const std::string& key) {
+  std::vector<uint8_t> value;
+  if (!store.Get(key, &value)) {
+    return "<missing>";
+  }
+  return std::string(value.begin(), value.end());
+}
+
+}  // namespace
+
+TEST(KvStoreTest, PutGetRemove) {
+  KvStore store(MakeTempDirectory("kv_store_basic"), SmallOptions());
+  ASSERT_TRUE(store.Open());
+  EXPECT_EQ(Get(store, "games/page/1"), "<missing>");
+  ASSERT_TRUE(Put(&store, "games/page/1", "[1,2,3]"));
+  ASSERT_TRUE(Put(&store, "empty", ""));
+  EXPECT_EQ(Get(store, "games/page/1"), "[1,2,3]");
+  EXPECT_EQ(Get(store, "empty"), "");
+  EXPECT_TRUE(store.Contains("empty"));
+
+  ASSERT_TRUE(Put(&store, "games/page/1", "[4]"));
+  EXPECT_EQ(Get(store, "games/page/1"), "[4]");
+  EXPECT_TRUE(store.Remove("games/page/1"));
+  EXPECT_FALSE(store.Remove("games/page/1"));
+  EXPECT_FALSE(store.Contains("games/page/1"));
+
+  EXPECT_FALSE(Put(&store, "", "value"));
+  EXPECT_FALSE(Put(&store, std::string(KvStore::kMaxKeySize + 1, 'k'), "v"));
+  EXPECT_EQ(store.stats().entries, 1u);
+}
+
+TEST(KvStoreTest, ReopensWithLatestValues) {
+  const std::filesystem::path directory = MakeTempDirectory("kv_store_reopen");
+  {
+    KvStore store(directory, SmallOptions());
+    ASSERT_TRUE(store.Open());
+    ASSERT_TRUE(Put(&store, "a", "1"));
+    ASSERT_TRUE(Put(&store, "b", "2"));
+    ASSERT_TRUE(Put(&store, "a", "3"));
+    ASSERT_TRUE(store.Remove("b"));
+  }
+  KvStore store(directory, SmallOptions());
+  ASSERT_TRUE(store.Open());
+  EXPECT_EQ(Get(store, "a"), "3");
+  EXPECT_FALSE(store.Contains("b"));
+  EXPECT_EQ(store.stats().entries, 1u);
+  // 序号接着上次继续，新写入覆盖旧值
+  ASSERT_TRUE(Put(&store, "a", "4"));
+  EXPECT_EQ(Get(store, "a"), "4");
+}
+
+// 进程在写记录时退出：日志末尾是校验和对不上的半条记录，打开时丢弃，
+// 之前的记录保留，新记录从断点处继续写。
+TEST(KvStoreTest, DiscardsTornTail) {
+  const std::filesystem::path directory = MakeTempDirectory("kv_store_torn");
+  {
+    KvStore store(directory, SmallOptions());
+    ASSERT_TRUE(store.Open());
+    ASSERT_TRUE(Put(&store, "a", "alpha"));
+    ASSERT_TRUE(Put(&store, "b", "beta"));
+  }
+  {
+    // RecordHeader：key_size、value_size、sequence、flags、checksum
+    std::ofstream log(directory / "data.log",
+                      std::ios::binary | std::ios::app);
+    const uint32_t sizes[2] = {3, 5};
+    const uint64_t sequence = 99;
+    const uint32_t tail[2] = {0, 0xDEADBEEF};
+    log.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+    log.write(reinterpret_cast<const char*>(&sequence), sizeof(sequence));
+    log.write(reinterpret_cast<const char*>(tail), sizeof(tail));
+    log.write("keyval\0\0", 8);
+  }
+  {
+    KvStore store(directory, SmallOptions());
+    ASSERT_TRUE(store.Open());
+    EXPECT_EQ(Get(store, "a"), "alpha");
+    EXPECT_EQ(Get(store, "b"), "beta");
+    EXPECT_FALSE(store.Contains("key"));
+    ASSERT_TRUE(Put(&store, "c", "gamma"));
+  }
+  KvStore store(directory, SmallOptions());
+  ASSERT_TRUE(store.Open());
+  EXPECT_EQ(Get(store, "c"), "gamma");
+  EXPECT_EQ(store.stats().entries, 3u);
+}
+
+TEST(KvStoreTest, KeysAndScanFollowPrefixOrder) {
+  KvStore store(MakeTempDirectory("kv_store_scan"), SmallOptions());
+  ASSERT_TRUE(store.Open());
+  for (const char* key : {"page/3", "page/1", "other", "page/2", "pagex"}) {
+    ASSERT_TRUE(Put(&store, key, std::string("v-") + key));
+  }
+  EXPECT_EQ(store.Keys("page/", 0),
+            (std::vector<std::string>{"page/1", "page/2", "page/3"}));
+  EXPECT_EQ(store.Keys("page/", 2),
+            (std::vector<std::string>{"page/1", "page/2"}));
+  EXPECT_EQ(store.Keys("", 0).size(), 5u);
+
+  std::vector<std::pair<std::string, std::string>> visited;
+  store.Scan("page/", [&](std::string_view key, const uint8_t* value,
+                          size_t size) {
+    visited.emplace_back(std::string(key),
+                         std::string(reinterpret_cast<const char*>(value), size));
+    return visited.size() < 2;
+  });
+  ASSERT_EQ(visited.size(), 2u);
+  EXPECT_EQ(visited[0].second, "v-page/1");
+  EXPECT_EQ(visited[1].first, "page/2");
+
+  EXPECT_EQ(store.RemovePrefix("page/"), 3u);
+  EXPECT_EQ(store.Keys("", 0), (std::vector<std::string>{"other", "pagex"}));
+}
+
+TEST(KvStoreTest, NotifiesSubscribersByPrefix) {
+  KvStore store(MakeTempDirectory("kv_store_subscribe"), SmallOptions());
+  ASSERT_TRUE(store.Open());
+  std::vector<std::pair<std::string, bool>> changes;
+  const uint64_t subscription =
+      store.Subscribe("games/", [&](std::string_view key, bool deleted) {
+        changes.emplace_back(std::string(key), deleted);
+      });
+  ASSERT_TRUE(Put(&store, "games/1", "x"));
+  ASSERT_TRUE(Put(&store, "posts/1", "x"));
+  ASSERT_TRUE(store.Remove("games/1"));
+  store.Unsubscribe(subscription);
+  ASSERT_TRUE(Put(&store, "games/2", "x"));
+
+  const std::vector<std::pair<std::string, bool>> expected = {
+      {"games/1", false}, {"games/1", true}};
+  EXPECT_EQ(changes, expected);
+}
+
+// 反复覆盖同一批键，失效记录超过阈值后自动压缩，数据不变。
+TEST(KvStoreTest, CompactsDeadRecords) {
+  const std::filesystem::path directory = MakeTempDirectory("kv_store_compact");
+  KvStore::Options options = SmallOptions();
+  options.compaction_min_dead_bytes = 16 << 10;
+  {
+    KvStore store(directory, options);
+    ASSERT_TRUE(store.Open());
+    const std::string value(500, 'v');
+    for (int round = 0; round < 50; ++round) {
+      for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(Put(&store, "key" + std::to_string(i),
+                        value + std::to_string(round)));
+      }
+    }
+    const auto stats = store.stats();
+    EXPECT_GT(stats.compactions, 0u);
+    EXPECT_EQ(stats.entries, 10u);
+    EXPECT_LT(stats.file_bytes, 50u * 10 * 500 / 2);
+    EXPECT_EQ(Get(store, "key3"), value + "49");
+  }
+  KvStore store(directory, options);
+  ASSERT_TRUE(store.Open());
+  EXPECT_EQ(Get(store, "key9"), std::string(500, 'v') + "49");
+}
+
+TEST(KvStoreTest, GrowsPastInitialCapacity) {
+  const std::filesystem::path directory = MakeTempDirectory("kv_store_grow");
+  const std::string large(1 << 20, 'L');
+  {
+    KvStore store(directory, SmallOptions());
+    ASSERT_TRUE(store.Open());
+    for (int i = 0; i < 4; ++i) {
+      ASSERT_TRUE(Put(&store, "large" + std::to_string(i), large));
+    }
+  }
+  KvStore store(directory, SmallOptions());
+  ASSERT_TRUE(store.Open());
+  EXPECT_EQ(Get(store, "large3"), large);
+}
+
+// 写入触发重新映射时，并发的读取仍然读到完整的值。
+TEST(KvStoreTest, ReadsStayConsistentWhileWriting) {
+  KvStore store(MakeTempDirectory("kv_store_concurrent"), SmallOptions());
+  ASSERT_TRUE(store.Open());
+  ASSERT_TRUE(Put(&store, "stable", std::string(1000, 's')));
+  std::atomic<bool> done{false};
+  std::atomic<int> bad_reads{0};
+  std::thread reader([&] {
+    std::vector<uint8_t> value;
+    while (!done) {
+      if (!store.Get("stable", &value) || value.size() != 1000 ||
+          value.front() != 's' || value.back() != 's') {
+        ++bad_reads;
+      }
+    }
+  });
+  const std::string payload(8 << 10, 'p');
+  for (int i = 0; i < 500; ++i) {
+    ASSERT_TRUE(Put(&store, "key" + std::to_string(i), payload));
+  }
+  done = true;
+  reader.join();
+  EXPECT_EQ(bad_reads.load(), 0);
+  EXPECT_EQ(store.stats().entries, 501u);
+}
@@ -0,0 +1,501 @@
+#include "local_http_server.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+constexpr size_t kChunkSize = 16 * 1024;
+
+std::string ToLower(std::string text) {
+  std::transform(text.begin(), text.end(), text.begin(), [](char c) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  });
+  return text;
+}
+
+std::string Trim(const std::string& text) {
+  const size_t begin = text.find_first_not_of(" \t");
+  if (begin == std::string::npos) {
+    return std::string();
+  }
+  return text.substr(begin, text.find_last_not_of(" \t") - begin + 1);
+}
+
+bool SendAll(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    const ssize_t sent = ::send(fd, data, size, MSG_NOSIGNAL);
+    if (sent <= 0) {
+      return false;
+    }
+    data += sent;
+    size -= static_cast<size_t>(sent);
+  }
+  return true;
+}
+
+// 读到 "\r\n\r\n" 为止，多读的部分留在 |buffer| 里。
+bool ReadHead(int fd, std::string* buffer, std::string* head) {
+  for (;;) {
+    const size_t end = buffer->find("\r\n\r\n");
+    if (end != std::string::npos) {
+      *head = buffer->substr(0, end + 2);
+      buffer->erase(0, end + 4);
+      return true;
+    }
+    char chunk[4096];
+    const ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+    if (received <= 0) {
+      return false;
+    }
+    buffer->append(chunk, static_cast<size_t>(received));
+  }
+}
+
+// 请求行或状态行之后的 "Name: value"，名称转为小写。
+HttpHeaders ParseHeaderLines(const std::string& head) {
+  HttpHeaders headers;
+  size_t line_begin = head.find("\r\n");
+  while (line_begin != std::string::npos && line_begin + 2 < head.size()) {
+    line_begin += 2;
+    const size_t line_end = head.find("\r\n", line_begin);
+    const std::string line = head.substr(line_begin, line_end - line_begin);
+    const size_t colon = line.find(':');
+    if (colon != std::string::npos) {
+      headers.emplace_back(ToLower(line.substr(0, colon)),
+                           Trim(line.substr(colon + 1)));
+    }
+    line_begin = line_end;
+  }
+  return headers;
+}
+
+const std::string* Find(const HttpHeaders& headers, const char* name) {
+  for (const auto& header : headers) {
+    if (header.first == name) {
+      return &header.second;
+    }
+  }
+  return nullptr;
+}
+
+// "bytes=a-b" 或 "bytes=a-"，不支持多段。
+bool ParseRange(const std::string& value,
+                uint64_t size,
+                uint64_t* first,
+                uint64_t* last) {
+  if (value.compare(0, 6, "bytes=") != 0 ||
+      value.find(',') != std::string::npos) {
+    return false;
+  }
+  const size_t dash = value.find('-', 6);
+  if (dash == std::string::npos || dash == 6) {
+    return false;
+  }
+  *first = std::stoull(value.substr(6, dash - 6));
+  *last = dash + 1 < value.size() ? std::stoull(value.substr(dash + 1))
+                                  : size - 1;
+  *last = std::min(*last, size - 1);
+  return *first <= *last && *first < size;
+}
+
+}  // namespace
+
+LocalHttpServer::LocalHttpServer(std::string content, const Options& options)
+    : options_(options),
+      content_(std::make_shared<const std::string>(std::move(content))) {}
+
+LocalHttpServer::~LocalHttpServer() {
+  Stop();
+}
+
+bool LocalHttpServer::Start() {
+  listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (listen_fd_ < 0) {
+    return false;
+  }
+  const int enable = 1;
+  ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = 0;
+  socklen_t length = sizeof(address);
+  if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address),
+             sizeof(address)) != 0 ||
+      ::listen(listen_fd_, 64) != 0 ||
+      ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address),
+                    &length) != 0) {
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    return false;
+  }
+  port_ = ntohs(address.sin_port);
+  accept_thread_ = std::thread(&LocalHttpServer::AcceptLoop, this);
+  return true;
+}
+
+void LocalHttpServer::Stop() {
+  if (stopping_.exchange(true)) {
+    return;
+  }
+  if (listen_fd_ >= 0) {
+    ::shutdown(listen_fd_, SHUT_RDWR);
+  }
+  if (accept_thread_.joinable()) {
+    accept_thread_.join();
+  }
+  if (listen_fd_ >= 0) {
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+  }
+  std::vector<std::thread> threads;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int fd : open_fds_) {
+      ::shutdown(fd, SHUT_RDWR);
+    }
+    threads.swap(connection_threads_);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+std::string LocalHttpServer::url(const std::string& path) const {
+  return "http://127.0.0.1:" + std::to_string(port_) + path;
+}
+
+void LocalHttpServer::SetContent(std::string content, std::string etag) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  content_ = std::make_shared<const std::string>(std::move(content));
+  options_.etag = std::move(etag);
+}
+
+void LocalHttpServer::SetBytesPerSecond(size_t bytes_per_second) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  options_.bytes_per_second = bytes_per_second;
+}
+
+LocalHttpServer::Stats LocalHttpServer::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void LocalHttpServer::AcceptLoop() {
+  while (!stopping_) {
+    const int fd = ::accept(listen_fd_, nullptr, nullptr);
+    if (fd < 0) {
+      if (stopping_) {
+        return;
+      }
+      continue;
+    }
+    const int enable = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+      ::close(fd);
+      return;
+    }
+    open_fds_.insert(fd);
+    stats_.peak_connections = std::max(stats_.peak_connections,
+                                       open_fds_.size());
+    connection_threads_.emplace_back(&LocalHttpServer::ServeConnection, this,
+                                     fd);
+  }
+}
+
+void LocalHttpServer::ServeConnection(int fd) {
+  bool rejected = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rejected = options_.max_connections > 0 &&
+               open_fds_.size() > options_.max_connections;
+  }
+  std::string buffer;
+  std::string head;
+  while (!stopping_ && ReadHead(fd, &buffer, &head)) {
+    if (rejected) {
+      static constexpr char kBusy[] =
+          "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\n"
+          "Connection: close\r\n\r\n";
+      SendAll(fd, kBusy, sizeof(kBusy) - 1);
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++stats_.requests;
+      ++stats_.rejected;
+      break;
+    }
+    if (!HandleRequest(fd, head)) {
+      break;
+    }
+  }
+  ::shutdown(fd, SHUT_RDWR);
+  std::lock_guard<std::mutex> lock(mutex_);
+  open_fds_.erase(fd);
+  ::close(fd);
+}
+
+bool LocalHttpServer::HandleRequest(int fd, const std::string& head) {
+  const HttpHeaders headers = ParseHeaderLines(head);
+  std::shared_ptr<const std::string> content;
+  Options options;
+  bool drop = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    content = content_;
+    options = options_;
+    ++stats_.requests;
+    drop = options.drop_after_bytes > 0 && responses_ < options.drop_responses;
+    ++responses_;
+  }
+  const uint64_t size = content->size();
+
+  uint64_t first = 0;
+  uint64_t last = size == 0 ? 0 : size - 1;
+  bool partial = false;
+  const std::string* range = Find(headers, "range");
+  const std::string* if_range = Find(headers, "if-range");
+  if (options.ranges && range && (!if_range || *if_range == options.etag)) {
+    if (!ParseRange(*range, size, &first, &last)) {
+      const std::string response =
+          "HTTP/1.1 416 Range Not Satisfiable\r\nContent-Range: bytes */" +
+          std::to_string(size) + "\r\nContent-Length: 0\r\n\r\n";
+      return SendAll(fd, response.data(), response.size());
+    }
+    partial = true;
+  }
+  const uint64_t length = size == 0 ? 0 : last - first + 1;
+
+  std::string response = partial ? "HTTP/1.1 206 Partial Content\r\n"
+                                  : "HTTP/1.1 200 OK\r\n";
+  response += "Content-Type: application/zip\r\n";
+  response += "Content-Length: " + std::to_string(length) + "\r\n";
+  if (options.ranges) {
+    response += "Accept-Ranges: bytes\r\nETag: " + options.etag + "\r\n";
+  }
+  if (partial) {
+    response += "Content-Range: bytes " + std::to_string(first) + "-" +
+                std::to_string(last) + "/" + std::to_string(size) + "\r\n";
+  }
+  if (!options.file_name.empty()) {
+    response += "Content-Disposition: attachment; filename=\"" +
+                options.file_name + "\"\r\n";
+  }
+  response += "\r\n";
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++(partial ? stats_.range_requests : stats_.full_responses);
+  }
+  if (!SendAll(fd, response.data(), response.size())) {
+    return false;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  uint64_t sent = 0;
+  while (sent < length) {
+    size_t chunk = static_cast<size_t>(std::min<uint64_t>(kChunkSize,
+                                                          length - sent));
+    if (drop) {
+      if (sent >= options.drop_after_bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.dropped;
+        return false;
+      }
+      chunk = static_cast<size_t>(
+          std::min<uint64_t>(chunk, options.drop_after_bytes - sent));
+    }
+    if (!SendAll(fd, content->data() + first + sent, chunk)) {
+      return false;
+    }
+    sent += chunk;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stats_.body_bytes += chunk;
+    }
+    size_t bytes_per_second = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      bytes_per_second = options_.bytes_per_second;
+    }
+    if (bytes_per_second > 0) {
+      std::this_thread::sleep_until(
+          start + std::chrono::microseconds(sent * 1000000 / bytes_per_second));
+    }
+    if (stopping_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+namespace {
+
+class SocketHttpConnection : public HttpConnection {
+ public:
+  explicit SocketHttpConnection(HttpOrigin origin)
+      : origin_(std::move(origin)) {}
+  ~SocketHttpConnection() override { Close(); }
+
+  bool Warm(std::string* error) override { return Connect(error); }
+
+  bool Send(const HttpRequest& request,
+            HttpResponse* response,
+            std::string* error) override {
+    if (!Connect(error)) {
+      return false;
+    }
+    const timeval timeout = {
+        static_cast<time_t>(request.timeout.count() / 1000),
+        static_cast<suseconds_t>(request.timeout.count() % 1000 * 1000)};
+    ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    ::setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    std::string head = request.method + " " + request.path +
+                       " HTTP/1.1\r\nHost: " + origin_.host + "\r\n";
+    for (const auto& header : request.headers) {
+      head += header.first + ": " + header.second + "\r\n";
+    }
+    if (!request.body.empty()) {
+      head += "Content-Length: " + std::to_string(request.body.size()) +
+              "\r\n";
+    }
+    head += "\r\n" + request.body;
+    std::string buffer;
+    std::string response_head;
+    if (!SendAll(fd_, head.data(), head.size()) ||
+        !ReadHead(fd_, &buffer, &response_head)) {
+      *error = "Connection closed";
+      Close();
+      return false;
+    }
+    const size_t space = response_head.find(' ');
+    response->status_code =
+        space == std::string::npos
+            ? 0
+            : std::atoi(response_head.c_str() + space + 1);
+    response->headers = ParseHeaderLines(response_head);
+    const std::string* connection = Find(response->headers, "connection");
+    if (connection && ToLower(*connection) == "close") {
+      reusable_ = false;
+    }
+    const std::string* content_length =
+        Find(response->headers, "content-length");
+    const bool has_length = content_length != nullptr;
+    uint64_t remaining =
+        has_length ? std::stoull(*content_length) : UINT64_MAX;
+    if (request.method == "HEAD") {
+      remaining = 0;
+    }
+    if (!has_length) {
+      reusable_ = false;
+    }
+
+    auto deliver = [&](const char* data, size_t size) {
+      if (request.body_sink) {
+        return request.body_sink(data, size);
+      }
+      response->body.append(data, size);
+      return true;
+    };
+    if (!buffer.empty() && remaining > 0) {
+      const size_t take =
+          static_cast<size_t>(std::min<uint64_t>(buffer.size(), remaining));
+      remaining -= take;
+      if (!deliver(buffer.data(), take)) {
+        *error = "Response body consumer stopped reading";
+        Close();
+        return false;
+      }
+    }
+    char chunk[kChunkSize];
+    while (remaining > 0) {
+      const ssize_t received = ::recv(
+          fd_, chunk,
+          static_cast<size_t>(std::min<uint64_t>(sizeof(chunk), remaining)),
+          0);
+      if (received == 0 && !has_length) {
+        break;
+      }
+      if (received <= 0) {
+        *error = received == 0 ? "Connection closed" : "Receive timed out";
+        Close();
+        return false;
+      }
+      remaining -= static_cast<uint64_t>(received);
+      if (!deliver(chunk, static_cast<size_t>(received))) {
+        *error = "Response body consumer stopped reading";
+        Close();
+        return false;
+      }
+    }
+    if (!reusable_) {
+      Close();
+    }
+    return true;
+  }
+
+  bool reusable() const override { return reusable_; }
+
+ private:
+  bool Connect(std::string* error) {
+    if (fd_ >= 0) {
+      return true;
+    }
+    if (origin_.secure) {
+      *error = "https is not supported";
+      return false;
+    }
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (::getaddrinfo(origin_.host.c_str(),
+                      std::to_string(origin_.port).c_str(), &hints,
+                      &addresses) != 0) {
+      *error = "Unable to resolve " + origin_.host;
+      return false;
+    }
+    fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    const bool connected =
+        fd_ >= 0 &&
+        ::connect(fd_, addresses->ai_addr, addresses->ai_addrlen) == 0;
+    ::freeaddrinfo(addresses);
+    if (!connected) {
+      *error = "Unable to connect to " + origin_.ToString();
+      Close();
+      return false;
+    }
+    return true;
+  }
+
+  void Close() {
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+    reusable_ = false;
+  }
+
+  const HttpOrigin origin_;
+  int fd_ = -1;
+  bool reusable_ = true;
+};
+
+}  // namespace
+
+std::unique_ptr<HttpConnection> SocketHttpConnectionFactory::Create(
+    const HttpOrigin& origin) {
+  return std::make_unique<SocketHttpConnection>(origin);
+}
@@ -0,0 +1,83 @@
+#ifndef RUNNER_CORE_TEST_LOCAL_HTTP_SERVER_H_
+#define RUNNER_CORE_TEST_LOCAL_HTTP_SERVER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "http_connection_pool.h"
+
+// 测试用的 HTTP/1.1 服务器（POSIX socket，只监听 127.0.0.1）。
+//
+// 提供一个文件，支持 Range、If-Range 和 keep-alive，可以按连接限速、在
+// 响应中途断开连接，以及限制同时打开的连接数（超过时返回 503）。
+class LocalHttpServer {
+ public:
+  struct Options {
+    bool ranges = true;
+    std::string etag = "\"v1\"";
+    std::string file_name;          // 非空时发送 Content-Disposition
+    size_t bytes_per_second = 0;    // 每条连接的限速，0 表示不限
+    uint64_t drop_after_bytes = 0;  // 响应体发送这么多字节后断开
+    int drop_responses = 0;         // 前多少个响应会断开
+    size_t max_connections = 0;     // 同时打开的连接数上限，0 表示不限
+  };
+
+  struct Stats {
+    size_t requests = 0;
+    size_t range_requests = 0;
+    size_t full_responses = 0;
+    size_t dropped = 0;
+    size_t rejected = 0;
+    size_t peak_connections = 0;
+    uint64_t body_bytes = 0;
+  };
+
+  LocalHttpServer(std::string content, const Options& options);
+  ~LocalHttpServer();
+
+  LocalHttpServer(const LocalHttpServer&) = delete;
+  LocalHttpServer& operator=(const LocalHttpServer&) = delete;
+
+  bool Start();
+  void Stop();
+
+  std::string url(const std::string& path = "/game.zip") const;
+  // 模拟服务器上的文件被替换。
+  void SetContent(std::string content, std::string etag);
+  void SetBytesPerSecond(size_t bytes_per_second);
+  Stats stats() const;
+
+ private:
+  void AcceptLoop();
+  void ServeConnection(int fd);
+  // 返回 false 时关闭连接。
+  bool HandleRequest(int fd, const std::string& head);
+
+  Options options_;
+  std::shared_ptr<const std::string> content_;
+  int listen_fd_ = -1;
+  uint16_t port_ = 0;
+  std::atomic<bool> stopping_{false};
+  std::thread accept_thread_;
+
+  mutable std::mutex mutex_;
+  std::vector<std::thread> connection_threads_;
+  std::set<int> open_fds_;
+  int responses_ = 0;
+  Stats stats_;
+};
+
+// 基于 POSIX socket 的 HttpConnectionFactory，只支持 http://。
+class SocketHttpConnectionFactory : public HttpConnectionFactory {
+ public:
+  std::unique_ptr<HttpConnection> Create(const HttpOrigin& origin) override;
+};
+
+#endif  // RUNNER_CORE_TEST_LOCAL_HTTP_SERVER_H_
@@ -0,0 +1,76 @@
+#include "memory_telemetry.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <fstream>
+#include <string>
+
+#include "test_utils.h"
+
+TEST(MemoryTelemetryTest, SamplesCurrentProcess) {
+  ProcessMemory memory;
+  ASSERT_TRUE(SampleProcessMemory(&memory));
+  EXPECT_GT(memory.working_set, 0u);
+  EXPECT_GE(memory.commit, memory.working_set);
+}
+
+TEST(MemoryTelemetryTest, RecordsCountersInARing) {
+  MemoryTelemetry telemetry(4);
+  std::atomic<int64_t> bytes{7};
+  ASSERT_TRUE(telemetry.RegisterCounter("kv.main", [&] { return bytes.load(); }));
+  EXPECT_FALSE(telemetry.RegisterCounter("bad,label", [] { return int64_t{0}; }));
+  ASSERT_TRUE(telemetry.SetCounter("dart.image_cache", 100));
+  EXPECT_TRUE(telemetry.Rows(0).empty());
+
+  telemetry.SampleNow();
+  bytes = 9;
+  telemetry.SetCounter("dart.image_cache", 200);
+  telemetry.SampleNow();
+  auto rows = telemetry.Rows(0);
+  ASSERT_EQ(rows.size(), 2u);
+  EXPECT_EQ(rows[0].sequence, 1u);
+  EXPECT_EQ(rows[0].counters[0], 7);
+  EXPECT_EQ(rows[0].counters[1], 100);
+  EXPECT_EQ(rows[1].counters[0], 9);
+  EXPECT_EQ(rows[1].counters[1], 200);
+  EXPECT_EQ(telemetry.Rows(1).size(), 1u);
+
+  for (int i = 0; i < 5; ++i) {
+    telemetry.SampleNow();
+  }
+  rows = telemetry.Rows(0);
+  ASSERT_EQ(rows.size(), 4u);
+  EXPECT_EQ(rows.front().sequence, 4u);
+  EXPECT_EQ(rows.back().sequence, 7u);
+}
+
+TEST(MemoryTelemetryTest, LimitsCounterCount) {
+  MemoryTelemetry telemetry;
+  for (size_t i = 0; i < MemoryTelemetry::kMaxCounters; ++i) {
+    ASSERT_TRUE(telemetry.SetCounter("c" + std::to_string(i),
+                                     static_cast<int64_t>(i)));
+  }
+  EXPECT_FALSE(telemetry.SetCounter("extra", 1));
+  EXPECT_TRUE(telemetry.SetCounter("c3", 33));
+}
+
+TEST(MemoryTelemetryTest, WritesCsv) {
+  MemoryTelemetry telemetry(8);
+  telemetry.SetCounter("kv.main", 1);
+  telemetry.SampleNow();
+  telemetry.SampleNow();
+  const auto directory = MakeTempDirectory("memory_telemetry");
+  ASSERT_TRUE(telemetry.WriteCsv(directory / "memory.csv"));
+
+  std::ifstream in(directory / "memory.csv");
+  std::string header;
+  std::getline(in, header);
+  EXPECT_EQ(header,
+            "sequence,time_ms,working_set,private_bytes,commit,handles,kv.main");
+  int lines = 0;
+  for (std::string line; std::getline(in, line);) {
+    ++lines;
+  }
+  EXPECT_EQ(lines, 2);
+}
@@ -0,0 +1,173 @@
+#include "object_id_table.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+ObjectId SequentialId(uint32_t counter) {
+  ObjectId id{};
+  const uint8_t prefix[9] = {0x65, 0xF0, 0xC1, 0xA2, 0xB3, 0xC4, 0xD5, 0xE6, 0xF7};
+  std::memcpy(id.bytes, prefix, sizeof(prefix));
+  id.bytes[9] = static_cast<uint8_t>(counter >> 16);
+  id.bytes[10] = static_cast<uint8_t>(counter >> 8);
+  id.bytes[11] = static_cast<uint8_t>(counter);
+  return id;
+}
+
+// 与 |id| 哈希值完全相同的另一个 ObjectId：哈希只用前 8 字节异或后
+// 4 字节乘以常数，调整前 8 字节抵消后 4 字节的变化。
+ObjectId CollidingId(const ObjectId& id, uint32_t tail_delta) {
+  uint64_t head;
+  uint32_t tail;
+  std::memcpy(&head, id.bytes, sizeof(head));
+  std::memcpy(&tail, id.bytes + 8, sizeof(tail));
+  constexpr uint64_t kMultiplier = 0xC2B2AE3D27D4EB4Full;
+  const uint32_t other_tail = tail + tail_delta;
+  const uint64_t other_head =
+      head ^ (tail * kMultiplier) ^ (other_tail * kMultiplier);
+  ObjectId other;
+  std::memcpy(other.bytes, &other_head, sizeof(other_head));
+  std::memcpy(other.bytes + 8, &other_tail, sizeof(other_tail));
+  return other;
+}
+
+}  // namespace
+
+TEST(ObjectIdTest, HexRoundTrip) {
+  ObjectId id;
+  ASSERT_TRUE(ParseObjectIdHex("65F0c1a2B3c4d5e6f7a81000", &id));
+  EXPECT_EQ(id.bytes[0], 0x65);
+  EXPECT_EQ(id.bytes[11], 0x00);
+  EXPECT_EQ(ObjectIdTimestamp(id), 0x65F0C1A2u);
+  char hex[kObjectIdHexLength];
+  FormatObjectIdHex(id, hex);
+  EXPECT_EQ(std::string(hex, sizeof(hex)), "65f0c1a2b3c4d5e6f7a81000");
+}
+
+TEST(ObjectIdTest, RejectsInvalidHex) {
+  ObjectId id;
+  EXPECT_FALSE(ParseObjectIdHex("", &id));
+  EXPECT_FALSE(ParseObjectIdHex("65f0c1a2b3c4d5e6f7a8100", &id));
+  EXPECT_FALSE(ParseObjectIdHex("65f0c1a2b3c4d5e6f7a810000", &id));
+  EXPECT_FALSE(ParseObjectIdHex("65f0c1a2b3c4d5e6f7a8100g", &id));
+  EXPECT_FALSE(ParseObjectIdHex("65f0c1a2b3c4 5e6f7a81000", &id));
+  EXPECT_FALSE(ParseObjectIdHex(std::string_view("65f0c1a2b3c4\0005e6f7a8100", 24),
+                                &id));
+}
+
+TEST(ObjectIdTest, GeneratesDistinctIdsWithCurrentTime) {
+  const uint32_t now = static_cast<uint32_t>(
+      std::chrono::duration_cast<std::chrono::seconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+  std::set<ObjectId> ids;
+  for (int i = 0; i < 10000; ++i) {
+    const ObjectId id = GenerateObjectId();
+    EXPECT_LE(ObjectIdTimestamp(id) - now, 1u);
+    ids.insert(id);
+  }
+  EXPECT_EQ(ids.size(), 10000u);
+}
+
+TEST(ObjectIdTableTest, InternReturnsStableHandles) {
+  ObjectIdTable table;
+  const uint32_t first = table.Intern(SequentialId(1));
+  const uint32_t second = table.Intern(SequentialId(2));
+  EXPECT_EQ(first, 1u);
+  EXPECT_EQ(second, 2u);
+  EXPECT_EQ(table.Intern(SequentialId(1)), first);
+  EXPECT_EQ(table.Find(SequentialId(2)), second);
+  EXPECT_EQ(table.Find(SequentialId(3)), ObjectIdTable::kInvalidHandle);
+  EXPECT_EQ(table.size(), 2u);
+
+  ObjectId id;
+  ASSERT_TRUE(table.Get(second, &id));
+  EXPECT_EQ(id, SequentialId(2));
+  EXPECT_FALSE(table.Get(ObjectIdTable::kInvalidHandle, &id));
+  EXPECT_FALSE(table.Get(3, &id));
+}
+
+// 句柄不回收：扩容前后同一个 ObjectId 的句柄不变，新句柄连续递增。
+TEST(ObjectIdTableTest, KeepsHandlesAcrossGrowth) {
+  ObjectIdTable table;
+  constexpr uint32_t kCount = 100000;
+  for (uint32_t i = 0; i < kCount; ++i) {
+    ASSERT_EQ(table.Intern(SequentialId(i)), i + 1);
+  }
+  for (uint32_t i = 0; i < kCount; i += 997) {
+    EXPECT_EQ(table.Intern(SequentialId(i)), i + 1);
+    ObjectId id;
+    ASSERT_TRUE(table.Get(i + 1, &id));
+    EXPECT_EQ(id, SequentialId(i));
+  }
+  EXPECT_EQ(table.size(), kCount);
+  EXPECT_GE(table.memory_bytes(), kCount * (sizeof(ObjectId) + 8));
+}
+
+// 哈希完全相同（标签也相同）的 ObjectId 仍然分到不同的句柄。
+TEST(ObjectIdTableTest, SeparatesHashCollisions) {
+  ObjectIdTable table;
+  const ObjectId base = SequentialId(7);
+  std::vector<ObjectId> colliding = {base};
+  for (uint32_t delta = 1; delta <= 64; ++delta) {
+    colliding.push_back(CollidingId(base, delta));
+    ASSERT_EQ(ObjectIdHash()(colliding.back()), ObjectIdHash()(base));
+  }
+  std::vector<uint32_t> handles(colliding.size());
+  table.InternBatch(colliding.data(), colliding.size(), handles.data());
+  for (size_t i = 0; i < colliding.size(); ++i) {
+    EXPECT_EQ(handles[i], i + 1);
+    EXPECT_EQ(table.Find(colliding[i]), handles[i]);
+  }
+  EXPECT_EQ(table.Find(CollidingId(base, 65)), ObjectIdTable::kInvalidHandle);
+}
+
+TEST(ObjectIdTableTest, InternBatchDeduplicates) {
+  ObjectIdTable table;
+  const ObjectId ids[] = {SequentialId(1), SequentialId(2), SequentialId(1),
+                          SequentialId(3), SequentialId(2)};
+  uint32_t handles[5];
+  table.InternBatch(ids, 5, handles);
+  EXPECT_EQ(std::vector<uint32_t>(handles, handles + 5),
+            (std::vector<uint32_t>{1, 2, 1, 3, 2}));
+  EXPECT_EQ(table.size(), 3u);
+}
+
+// 多个线程驻留有重叠的 ObjectId，每个 ObjectId 只得到一个句柄。
+TEST(ObjectIdTableTest, ConcurrentInternAgreesOnHandles) {
+  ObjectIdTable table;
+  constexpr int kThreads = 4;
+  constexpr uint32_t kCount = 20000;
+  constexpr uint32_t kStrides[kThreads] = {1, 3, 7, 9};
+  std::vector<std::vector<uint32_t>> handles(kThreads,
+                                             std::vector<uint32_t>(kCount));
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (uint32_t i = 0; i < kCount; ++i) {
+        // 各线程以不同的顺序访问，步长与 kCount 互质
+        const uint32_t value = (i * kStrides[t]) % kCount;
+        handles[t][value] = table.Intern(SequentialId(value));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(table.size(), kCount);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    ObjectId id;
+    ASSERT_TRUE(table.Get(handles[0][i], &id));
+    EXPECT_EQ(id, SequentialId(i));
+    for (int t = 1; t < kThreads; ++t) {
+      EXPECT_EQ(handles[t][i], handles[0][i]);
+    }
+  }
+}
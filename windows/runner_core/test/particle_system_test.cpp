@@ -0,0 +1,182 @@
+#include "particle_system.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+namespace {
+
+constexpr float kRadius = 8.0f;
+
+// 没有随机扰动、不衰减的拖尾规则。
+ParticleBehavior StillBehavior() {
+  ParticleBehavior behavior;
+  behavior.min_opacity = 0.01f;
+  return behavior;
+}
+
+void UseSprites(ParticleSystem* system) {
+  const float rects[] = {0, 0, 16, 16, 16, 0, 32, 16};
+  system->SetSprites(rects, 2, kRadius);
+}
+
+ParticleSpawn At(float x, float y) {
+  ParticleSpawn spawn;
+  spawn.x = x;
+  spawn.y = y;
+  spawn.size = kRadius;
+  return spawn;
+}
+
+}  // namespace
+
+TEST(ParticleSystemTest, StepIntegratesMotionAndWritesTransforms) {
+  ParticleSystem system(16, 1);
+  system.SetBehavior(StillBehavior());
+  UseSprites(&system);
+  ParticleSpawn spawn = At(100, 200);
+  spawn.vx = 2.0f;
+  spawn.vy = 1.0f;
+  spawn.rise = 0.5f;
+  system.Spawn(spawn);
+
+  ASSERT_EQ(system.Step(2.0f, 800, 600), 1u);
+  // 两帧：x += 2 * 2，y += (1 - 0.5) * 2。角度 0、尺寸等于半边长时不缩放
+  const float* transform = system.transforms();
+  EXPECT_NEAR(transform[0], 1.0f, 0.01f);
+  EXPECT_NEAR(transform[1], 0.0f, 0.01f);
+  EXPECT_NEAR(transform[2], 104.0f - kRadius, 0.1f);
+  EXPECT_NEAR(transform[3], 201.0f - kRadius, 0.1f);
+}
+
+TEST(ParticleSystemTest, AlphaFollowsOpacity) {
+  ParticleSystem system(4, 1);
+  ParticleBehavior behavior = StillBehavior();
+  behavior.opacity_decay = 0.5f;
+  system.SetBehavior(behavior);
+  ParticleSpawn spawn = At(10, 10);
+  spawn.color = 0xC0102030;
+  spawn.opacity = 1.0f;
+  system.Spawn(spawn);
+
+  ASSERT_EQ(system.Step(1.0f, 100, 100), 1u);
+  EXPECT_EQ(system.colors()[0], 0x60102030u);
+}
+
+// 拖尾粒子淡出到阈值以下后被回收，其余粒子前移填补。
+TEST(ParticleSystemTest, RemovesFadedParticles) {
+  ParticleSystem system(8, 1);
+  ParticleBehavior behavior = StillBehavior();
+  behavior.opacity_decay = 0.5f;
+  behavior.min_opacity = 0.2f;
+  system.SetBehavior(behavior);
+  ParticleSpawn faint = At(1, 1);
+  faint.opacity = 0.3f;
+  ParticleSpawn bright = At(2, 2);
+  bright.opacity = 1.0f;
+  system.Spawn(faint);
+  system.Spawn(bright);
+
+  EXPECT_EQ(system.Step(1.0f, 100, 100), 1u);
+  EXPECT_NEAR(system.transforms()[2], 2.0f - kRadius, 0.1f);
+  EXPECT_EQ(system.Step(1.0f, 100, 100), 1u);
+  EXPECT_EQ(system.Step(1.0f, 100, 100), 0u);
+  EXPECT_EQ(system.Step(1.0f, 100, 100), 0u);
+}
+
+TEST(ParticleSystemTest, FullPoolReplacesDimmestParticle) {
+  ParticleSystem system(2, 1);
+  system.SetBehavior(StillBehavior());
+  ParticleSpawn dim = At(1, 1);
+  dim.opacity = 0.2f;
+  ParticleSpawn bright = At(2, 2);
+  system.Spawn(dim);
+  system.Spawn(bright);
+  system.Spawn(At(3, 3));
+  ASSERT_EQ(system.count(), 2u);
+
+  system.Step(0.0f, 100, 100);
+  // 0 号粒子（最暗）被替换为 (3, 3)
+  EXPECT_NEAR(system.transforms()[2], 3.0f - kRadius, 0.1f);
+  EXPECT_NEAR(system.transforms()[6], 2.0f - kRadius, 0.1f);
+  EXPECT_EQ(system.colors()[0] >> 24, 0xFFu);
+  EXPECT_EQ(system.colors()[1] >> 24, 0xFFu);
+}
+
+// 背景粒子从顶部飘出后在底部重生，左右越界时从另一侧出现。
+TEST(ParticleSystemTest, WrapsAroundTheViewport) {
+  ParticleSystem system(4, 1);
+  ParticleBehavior behavior = StillBehavior();
+  behavior.wrap = true;
+  behavior.ranges.opacity_min = 0.5f;
+  behavior.ranges.opacity_max = 0.5f;
+  system.SetBehavior(behavior);
+  UseSprites(&system);
+  ParticleSpawn rising = At(50, 0);
+  rising.rise = 20.0f;
+  ParticleSpawn drifting = At(99, 50);
+  drifting.vx = 20.0f;
+  system.Spawn(rising);
+  system.Spawn(drifting);
+
+  ASSERT_EQ(system.Step(1.0f, 100, 100), 2u);
+  const float* transforms = system.transforms();
+  // 重生在底边以下一个尺寸处
+  EXPECT_NEAR(transforms[3], 100.0f, 0.1f);
+  EXPECT_EQ(system.colors()[0] >> 24, 0x7Fu);
+  // 从右侧越界到左侧
+  EXPECT_NEAR(transforms[4 + 2], -kRadius - kRadius, 0.1f);
+}
+
+TEST(ParticleSystemTest, ScatterStaysInBoundsAndUsesSprites) {
+  ParticleSystem system(37, 42);
+  ParticleBehavior behavior = StillBehavior();
+  behavior.ranges.size_min = 1.0f;
+  behavior.ranges.size_max = 4.0f;
+  system.SetBehavior(behavior);
+  UseSprites(&system);
+  system.Scatter(1000, 640, 480);
+  ASSERT_EQ(system.count(), 37u);
+  ASSERT_EQ(system.Step(0.0f, 640, 480), 37u);
+
+  for (uint32_t i = 0; i < system.count(); ++i) {
+    const float* transform = system.transforms() + i * 4;
+    const float scale =
+        transform[0] * transform[0] + transform[1] * transform[1];
+    EXPECT_GE(scale, (1.0f / kRadius) * (1.0f / kRadius) * 0.98f) << i;
+    EXPECT_LE(scale, (4.0f / kRadius) * (4.0f / kRadius) * 1.02f) << i;
+    const float* rect = system.rects() + i * 4;
+    EXPECT_TRUE(rect[0] == 0.0f || rect[0] == 16.0f) << i;
+    EXPECT_EQ(rect[2] - rect[0], 16.0f);
+  }
+}
+
+// 粒子数不是 SIMD 宽度的倍数时，最后几个粒子也要被积分。
+TEST(ParticleSystemTest, IntegratesEveryParticleWithPadding) {
+  ParticleSystem system(37, 1);
+  system.SetBehavior(StillBehavior());
+  for (uint32_t i = 0; i < 37; ++i) {
+    ParticleSpawn spawn = At(static_cast<float>(i), 0);
+    spawn.vx = 1.0f;
+    system.Spawn(spawn);
+  }
+  ASSERT_EQ(system.Step(1.0f, 1000, 1000), 37u);
+  for (uint32_t i = 0; i < 37; ++i) {
+    EXPECT_NEAR(system.transforms()[i * 4 + 2], i + 1.0f - kRadius, 0.1f)
+        << i;
+  }
+}
+
+TEST(ParticleSystemTest, ClampsLongSteps) {
+  ParticleSystem system(4, 1);
+  system.SetBehavior(StillBehavior());
+  ParticleSpawn spawn = At(0, 0);
+  spawn.vx = 1.0f;
+  system.Spawn(spawn);
+  system.Step(100.0f, 1000, 1000);
+  // 一次最多前进 8 帧
+  EXPECT_NEAR(system.transforms()[2], 8.0f - kRadius, 0.1f);
+
+  ParticleSystem empty(4, 1);
+  EXPECT_EQ(empty.Step(1.0f, 100, 100), 0u);
+}
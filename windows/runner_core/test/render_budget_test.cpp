@@ -0,0 +1,79 @@
+#include "render_budget.h"
+
+#include <gtest/gtest.h>
+
+using Level = RenderBudgetLevel;
+
+TEST(RenderBudgetTest, MinimizedPausesImmediately) {
+  RenderBudget budget(1000000);
+  RenderBudgetSignals signals;
+  EXPECT_FALSE(budget.Update(signals, 0));
+  EXPECT_EQ(budget.level(), Level::kFull);
+  EXPECT_EQ(budget.deadline_us(), -1);
+  signals.minimized = true;
+  EXPECT_TRUE(budget.Update(signals, 10));
+  EXPECT_EQ(budget.level(), Level::kPaused);
+  signals.minimized = false;
+  EXPECT_TRUE(budget.Update(signals, 20));
+  EXPECT_EQ(budget.level(), Level::kFull);
+}
+
+TEST(RenderBudgetTest, OcclusionMustLastForTheDelay) {
+  RenderBudget budget(1000000);
+  RenderBudgetSignals signals;
+  signals.occluded = true;
+  EXPECT_FALSE(budget.Update(signals, 100));
+  EXPECT_EQ(budget.deadline_us(), 1000100);
+  EXPECT_FALSE(budget.Update(signals, 500000));
+  // 中途取消
+  signals.occluded = false;
+  EXPECT_FALSE(budget.Update(signals, 600000));
+  EXPECT_EQ(budget.deadline_us(), -1);
+  signals.occluded = true;
+  EXPECT_FALSE(budget.Update(signals, 700000));
+  EXPECT_TRUE(budget.Update(signals, 1700000));
+  EXPECT_EQ(budget.level(), Level::kPaused);
+  // 从暂停恢复到电池供电时直接降帧
+  signals.occluded = false;
+  signals.on_battery = true;
+  EXPECT_TRUE(budget.Update(signals, 1800000));
+  EXPECT_EQ(budget.level(), Level::kReduced);
+}
+
+TEST(RenderBudgetTest, SessionLockPausesAndUnlockRestores) {
+  RenderBudget budget(1000000);
+  RenderBudgetSignals signals;
+  signals.session_locked = true;
+  EXPECT_TRUE(budget.Update(signals, 0));
+  EXPECT_EQ(budget.level(), Level::kPaused);
+  signals.session_locked = false;
+  signals.display_off = true;
+  EXPECT_FALSE(budget.Update(signals, 1));
+  signals.display_off = false;
+  EXPECT_TRUE(budget.Update(signals, 2));
+  EXPECT_EQ(budget.level(), Level::kFull);
+}
+
+// 稳定状态下没有待生效的降级，监视器不设定时器，窗口空闲时不唤醒。
+TEST(RenderBudgetTest, SteadyStatesNeedNoWakeups) {
+  RenderBudget budget(1000000);
+  RenderBudgetSignals signals;
+  budget.Update(signals, 0);
+  EXPECT_EQ(budget.deadline_us(), -1);
+  for (int64_t now = 1; now < 3600; ++now) {
+    EXPECT_FALSE(budget.Update(signals, now * 1000000));
+  }
+  EXPECT_EQ(budget.deadline_us(), -1);
+
+  // 改用电池：等待一次降级，生效后不再需要定时器
+  signals.on_battery = true;
+  EXPECT_FALSE(budget.Update(signals, 3600000000));
+  EXPECT_EQ(budget.deadline_us(), 3601000000);
+  EXPECT_TRUE(budget.Update(signals, 3601000000));
+  EXPECT_EQ(budget.level(), Level::kReduced);
+  EXPECT_EQ(budget.deadline_us(), -1);
+
+  signals.minimized = true;
+  EXPECT_TRUE(budget.Update(signals, 3602000000));
+  EXPECT_EQ(budget.deadline_us(), -1);
+}
@@ -0,0 +1,107 @@
+#include "resize_coalescer.h"
+
+#include <gtest/gtest.h>
+
+using Event = ResizeCoalescer::Event;
+
+TEST(ResizeCoalescerTest, ResizesDirectlyOutsideTheSizeMoveLoop) {
+  ResizeCoalescer coalescer(16000);
+  auto action = coalescer.Size(800, 600, 0);
+  EXPECT_TRUE(action.move_child);
+  EXPECT_EQ(action.event, Event::kNone);
+  EXPECT_LT(action.timer_delay_us, 0);
+  EXPECT_TRUE(coalescer.Size(1920, 1080, 1000).move_child);
+  EXPECT_FALSE(coalescer.resizing());
+}
+
+TEST(ResizeCoalescerTest, MoveOnlyLoopHasNoEvents) {
+  ResizeCoalescer coalescer(16000);
+  coalescer.Size(800, 600, 0);
+  coalescer.EnterSizeMove(100);
+  EXPECT_FALSE(coalescer.Size(800, 600, 200).move_child);
+  const auto action = coalescer.ExitSizeMove(300);
+  EXPECT_FALSE(action.move_child);
+  EXPECT_EQ(action.event, Event::kNone);
+  EXPECT_EQ(coalescer.stats().sessions, 0u);
+}
+
+// 1000 Hz 的鼠标拖动一秒，子窗口每帧最多调整一次。
+TEST(ResizeCoalescerTest, CoalescesToOneMovePerFrame) {
+  ResizeCoalescer coalescer(16000);
+  coalescer.Size(800, 600, 0);
+  coalescer.EnterSizeMove(0);
+  int64_t timer_at = -1;
+  int64_t last_move = -100000;
+  int moves = 0;
+  int begins = 0;
+  for (int64_t now = 1000; now <= 1000000; now += 1000) {
+    if (timer_at >= 0 && now >= timer_at) {
+      timer_at = -1;
+      const auto action = coalescer.Timer(now);
+      if (action.move_child) {
+        ASSERT_GE(now - last_move, 16000);
+        last_move = now;
+        ++moves;
+      }
+      if (action.timer_delay_us >= 0) {
+        timer_at = now + action.timer_delay_us;
+      }
+    }
+    const auto action =
+        coalescer.Size(800 + static_cast<uint32_t>(now / 1000), 600, now);
+    begins += action.event == Event::kBegin;
+    ASSERT_NE(action.event, Event::kEnd);
+    if (action.move_child) {
+      ASSERT_GE(now - last_move, 16000);
+      last_move = now;
+      ++moves;
+    }
+    if (action.timer_delay_us >= 0) {
+      ASSERT_LT(timer_at, 0);
+      timer_at = now + action.timer_delay_us;
+    }
+  }
+  EXPECT_EQ(begins, 1);
+  EXPECT_GE(moves, 55);
+  EXPECT_LE(moves, 63);
+  const auto action = coalescer.ExitSizeMove(1000500);
+  EXPECT_EQ(action.event, Event::kEnd);
+  EXPECT_FALSE(coalescer.resizing());
+  EXPECT_EQ(coalescer.stats().sessions, 1u);
+}
+
+TEST(ResizeCoalescerTest, AppliesPendingSizeOnExit) {
+  ResizeCoalescer coalescer(16000);
+  coalescer.Size(800, 600, 0);
+  coalescer.EnterSizeMove(0);
+  auto action = coalescer.Size(810, 600, 20000);
+  EXPECT_TRUE(action.move_child);
+  EXPECT_EQ(action.event, Event::kBegin);
+  action = coalescer.Size(820, 600, 21000);
+  EXPECT_FALSE(action.move_child);
+  EXPECT_EQ(action.timer_delay_us, 15000);
+  // 已经要求过定时回调
+  EXPECT_LT(coalescer.Size(830, 600, 22000).timer_delay_us, 0);
+  action = coalescer.ExitSizeMove(23000);
+  EXPECT_TRUE(action.move_child);
+  EXPECT_EQ(action.event, Event::kEnd);
+  EXPECT_FALSE(coalescer.Timer(36000).move_child);
+}
+
+TEST(ResizeCoalescerTest, EarlyTimerIsRearmed) {
+  ResizeCoalescer coalescer(16000);
+  coalescer.Size(800, 600, 0);
+  coalescer.EnterSizeMove(0);
+  coalescer.Size(810, 600, 20000);
+  // 拖回已应用的尺寸时取消待调整
+  EXPECT_EQ(coalescer.Size(820, 600, 21000).timer_delay_us, 15000);
+  EXPECT_FALSE(coalescer.Size(810, 600, 22000).move_child);
+  EXPECT_FALSE(coalescer.Timer(36000).move_child);
+
+  EXPECT_TRUE(coalescer.Size(830, 600, 37000).move_child);
+  EXPECT_EQ(coalescer.Size(840, 600, 38000).timer_delay_us, 15000);
+  auto action = coalescer.Timer(45000);
+  EXPECT_FALSE(action.move_child);
+  EXPECT_EQ(action.timer_delay_us, 8000);
+  EXPECT_TRUE(coalescer.Timer(53000).move_child);
+}
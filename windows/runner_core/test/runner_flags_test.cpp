@@ -0,0 +1,67 @@
+#include "runner_flags.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<std::string> Parse(const std::vector<std::u16string>& arguments,
+                               RunnerFlags* flags) {
+  std::vector<std::u16string_view> views(arguments.begin(), arguments.end());
+  return ParseCommandLineArguments(views.data(), views.size(), flags);
+}
+
+}  // namespace
+
+TEST(RunnerFlagsTest, DefaultsWithoutArguments) {
+  RunnerFlags flags;
+  EXPECT_TRUE(Parse({}, &flags).empty());
+  EXPECT_FALSE(flags.write_bundle_manifest);
+  EXPECT_EQ(flags.memory_sample_ms, 10000);
+  EXPECT_EQ(flags.hang_threshold_ms, 2000);
+  EXPECT_TRUE(flags.prefetch);
+  EXPECT_TRUE(flags.prefetch_list.empty());
+  EXPECT_TRUE(flags.startup_trace_path.empty());
+}
+
+TEST(RunnerFlagsTest, ConsumesRunnerFlagsAndForwardsTheRest) {
+  RunnerFlags flags;
+  const auto forwarded =
+      Parse({u"--route=/home", u"--memory-sample-ms=500", u"--no-prefetch",
+             u"--hang-threshold-ms=0", u"--prefetch-list=data/list.txt",
+             u"--write-bundle-manifest", u"--startup-trace", u"用户"},
+            &flags);
+  EXPECT_EQ(forwarded, (std::vector<std::string>{"--route=/home", "用户"}));
+  EXPECT_EQ(flags.memory_sample_ms, 500);
+  EXPECT_EQ(flags.hang_threshold_ms, 0);
+  EXPECT_FALSE(flags.prefetch);
+  EXPECT_EQ(flags.prefetch_list, "data/list.txt");
+  EXPECT_TRUE(flags.write_bundle_manifest);
+  EXPECT_EQ(flags.startup_trace_path, "startup_trace.json");
+}
+
+TEST(RunnerFlagsTest, StartupTracePath) {
+  RunnerFlags flags;
+  EXPECT_TRUE(ConsumeRunnerFlag("--startup-trace=C:/trace.json", &flags));
+  EXPECT_EQ(flags.startup_trace_path, "C:/trace.json");
+  // 只是前缀相同的参数不是 runner 参数
+  EXPECT_FALSE(ConsumeRunnerFlag("--startup-tracer", &flags));
+  EXPECT_FALSE(ConsumeRunnerFlag("--no-prefetch-please", &flags));
+}
+
+TEST(RunnerFlagsTest, NegativeIntervalsBecomeZero) {
+  RunnerFlags flags;
+  EXPECT_TRUE(ConsumeRunnerFlag("--memory-sample-ms=-5", &flags));
+  EXPECT_TRUE(ConsumeRunnerFlag("--hang-threshold-ms=abc", &flags));
+  EXPECT_EQ(flags.memory_sample_ms, 0);
+  EXPECT_EQ(flags.hang_threshold_ms, 0);
+}
+
+TEST(RunnerFlagsTest, InvalidUtf16BecomesEmptyArgument) {
+  RunnerFlags flags;
+  const std::u16string lone_surrogate(1, static_cast<char16_t>(0xD800));
+  const auto forwarded = Parse({u"a", lone_surrogate, u"b"}, &flags);
+  EXPECT_EQ(forwarded, (std::vector<std::string>{"a", "", "b"}));
+}
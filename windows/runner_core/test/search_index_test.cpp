@@ -0,0 +1,110 @@
+#include "search_index.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+
+namespace {
+
+class SearchIndexTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    index_.Upsert(1, {{"塞尔达传说 旷野之息", 3.0f}, {"开放世界 冒险 游戏", 1.0f}});
+    index_.Upsert(2, {{"The Legend of Zelda: Tears of the Kingdom", 3.0f},
+                      {"Open-world adventure", 1.0f}});
+    index_.Upsert(3, {{"原神", 3.0f}, {"开放世界角色扮演游戏 ＲＰＧ", 1.0f}});
+    index_.Upsert(4, {{"艾尔登法环", 3.0f}, {"魂系 动作 RPG 开放世界", 1.0f}});
+  }
+
+  std::vector<SearchIndex::Hit> Search(const char* query) {
+    return index_.Search(query, 10);
+  }
+
+  SearchIndex index_;
+};
+
+}  // namespace
+
+TEST_F(SearchIndexTest, MatchesChineseAndLatinText) {
+  auto hits = Search("塞尔达");
+  ASSERT_FALSE(hits.empty());
+  EXPECT_EQ(hits[0].id, 1u);
+  EXPECT_EQ(Search("开放世界").size(), 3u);
+  ASSERT_EQ(Search("法").size(), 1u);  // 单字
+  // 前缀、大小写和全角字母
+  ASSERT_EQ(Search("zeld").size(), 1u);
+  EXPECT_EQ(Search("ZELDA")[0].id, 2u);
+  EXPECT_EQ(Search("rpg").size(), 2u);
+  // 分隔符之后不再做前缀匹配
+  EXPECT_EQ(Search("zelda ").size(), 1u);
+  EXPECT_TRUE(Search("zel ").empty());
+  EXPECT_TRUE(Search("").empty());
+  EXPECT_TRUE(Search("!!!").empty());
+}
+
+TEST_F(SearchIndexTest, UpsertReplacesAndRemoveDeletes) {
+  index_.Upsert(1, {{"马里奥", 3.0f}});
+  EXPECT_TRUE(Search("塞尔达").empty());
+  ASSERT_EQ(Search("马里奥").size(), 1u);
+  EXPECT_TRUE(index_.Remove(4));
+  EXPECT_FALSE(index_.Remove(4));
+  const auto hits = Search("开放世界");
+  ASSERT_EQ(hits.size(), 1u);
+  EXPECT_EQ(hits[0].id, 3u);
+  // 无效的 UTF-8 不会出错
+  index_.Upsert(9, {{std::string_view("\xff\xe4\xb8" "abc\xe4", 7), 1.0f}});
+  Search("abc");
+}
+
+// 大量删除后压缩，结果与重新建立的索引一致。
+TEST(SearchIndexCompactionTest, CompactedIndexMatchesFreshIndex) {
+  const char* words[] = {"游戏", "冒险", "动作", "角色", "扮演", "开放", "世界",
+                         "射击", "策略", "模拟", "zelda", "mario", "souls",
+                         "rpg",  "fps",  "独立", "像素", "恐怖", "解谜", "赛车"};
+  std::mt19937 rng(3);
+  std::vector<std::string> documents;
+  for (int i = 0; i < 5000; ++i) {
+    std::string text;
+    const int count = 3 + static_cast<int>(rng() % 20);
+    for (int j = 0; j < count; ++j) {
+      text += words[rng() % 20];
+      if (rng() % 2) {
+        text += ' ';
+      }
+    }
+    documents.push_back(std::move(text));
+  }
+  // 删除的文档多于剩余文档时压缩，这里最后一次删除正好触发压缩。
+  // 压缩之后再删除的文档仍计入文档频率，所以不在压缩后继续删除。
+  constexpr uint32_t kRemoved = 2500;
+  SearchIndex compacted;
+  SearchIndex fresh;
+  for (uint32_t id = 0; id < documents.size(); ++id) {
+    compacted.Upsert(id, {{documents[id], 1.0f}});
+    if (id > kRemoved) {
+      fresh.Upsert(id, {{documents[id], 1.0f}});
+    }
+  }
+  for (uint32_t id = 0; id <= kRemoved; ++id) {
+    compacted.Remove(id);
+  }
+  EXPECT_EQ(compacted.stats().compactions, 1u);
+  EXPECT_EQ(compacted.stats().documents, 2499u);
+  // 同分文档按内部槽位排序，压缩后槽位会变，所以取全部结果按 id 比较。
+  const auto by_id = [](std::vector<SearchIndex::Hit> hits) {
+    std::sort(hits.begin(), hits.end(),
+              [](const auto& a, const auto& b) { return a.id < b.id; });
+    return hits;
+  };
+  for (const char* query : {"游戏", "zelda", "开放世界", "rp", "像素 恐怖"}) {
+    const auto expected = by_id(fresh.Search(query, documents.size()));
+    const auto actual = by_id(compacted.Search(query, documents.size()));
+    ASSERT_EQ(actual.size(), expected.size()) << query;
+    for (size_t i = 0; i < actual.size(); ++i) {
+      EXPECT_EQ(actual[i].id, expected[i].id) << query;
+      EXPECT_NEAR(actual[i].score, expected[i].score, 1e-4f) << query;
+    }
+  }
+}
@@ -0,0 +1,150 @@
+#include "segment_plan.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr uint64_t kMin = 64 * 1024;
+constexpr uint64_t kTotal = 64 * kMin;  // 4 MB
+
+}  // namespace
+
+TEST(SegmentPlanTest, FirstConnectionTakesTheWholeFile) {
+  SegmentPlan plan(kMin);
+  plan.Reset(kTotal);
+  const size_t index = plan.Acquire(0);
+  ASSERT_EQ(index, 0u);
+  EXPECT_EQ(plan.segment(index).begin, 0u);
+  EXPECT_EQ(plan.segment(index).end, kTotal);
+  EXPECT_EQ(plan.active_count(), 1u);
+}
+
+// 没有测出速度时对半拆分剩余部分。
+TEST(SegmentPlanTest, SplitsRemainingBytesInHalfWithoutRates) {
+  SegmentPlan plan(kMin);
+  plan.Reset(kTotal);
+  const size_t first = plan.Acquire(0);
+  plan.Commit(first, 1024 * 1024, 1000);
+  const size_t second = plan.Acquire(2000);
+  ASSERT_NE(second, SegmentPlan::kNone);
+  const uint64_t split = plan.segment(second).begin;
+  EXPECT_EQ(split % 4096, 0u);
+  EXPECT_EQ(plan.segment(first).end, split);
+  EXPECT_EQ(plan.segment(second).end, kTotal);
+  EXPECT_EQ(split, 1024 * 1024 + (kTotal - 1024 * 1024) / 2);
+}
+
+// 被拆短的段，超出新结尾的数据不计入。
+TEST(SegmentPlanTest, CommitStopsAtTheShortenedEnd) {
+  SegmentPlan plan(kMin);
+  plan.Reset(kTotal);
+  const size_t first = plan.Acquire(0);
+  const size_t second = plan.Acquire(0);
+  const uint64_t split = plan.segment(second).begin;
+  EXPECT_EQ(plan.Commit(first, kTotal, 1000), split);
+  EXPECT_EQ(plan.segment(first).remaining(), 0u);
+  EXPECT_EQ(plan.contiguous_end(), split);
+  EXPECT_EQ(plan.completed(), split);
+}
+
+// 慢连接的段拆给新连接的部分更多。
+TEST(SegmentPlanTest, GivesMoreOfASlowSegmentToTheNewConnection) {
+  SegmentPlan plan(kMin);
+  plan.Reset(kTotal);
+  const size_t slow = plan.Acquire(0);
+  const size_t fast = plan.Acquire(0);
+  const size_t done = plan.Acquire(0);
+  // 慢的 100 KB/s，快的 900 KB/s，第三条连接已经下完
+  plan.Commit(slow, 100 * 1024 / 5, 200000);
+  plan.Commit(fast, 900 * 1024 / 5, 200000);
+  plan.Commit(done, plan.segment(done).remaining(), 200000);
+  plan.Release(done);
+
+  const uint64_t before = plan.segment(slow).remaining();
+  const size_t next = plan.Acquire(300000);
+  ASSERT_NE(next, SegmentPlan::kNone);
+  // 平均速度 500 KB/s，新连接应分到约 5/6
+  const double share =
+      static_cast<double>(plan.segment(next).remaining()) / before;
+  EXPECT_GT(share, 0.75);
+  EXPECT_LT(share, 0.9);
+}
+
+TEST(SegmentPlanTest, DoesNotSplitBelowTwiceTheMinimum) {
+  SegmentPlan plan(kMin);
+  plan.Reset(2 * kMin - 1);
+  ASSERT_NE(plan.Acquire(0), SegmentPlan::kNone);
+  EXPECT_EQ(plan.Acquire(0), SegmentPlan::kNone);
+  EXPECT_EQ(plan.segment_count(), 1u);
+}
+
+// 释放的段优先于拆分，最靠前的先分配。
+TEST(SegmentPlanTest, ReacquiresReleasedSegmentsEarliestFirst) {
+  SegmentPlan plan(kMin);
+  plan.Reset(kTotal);
+  const size_t a = plan.Acquire(0);
+  const size_t b = plan.Acquire(0);
+  const size_t c = plan.Acquire(0);
+  ASSERT_NE(c, SegmentPlan::kNone);
+  plan.Release(c);
+  plan.Release(a);
+  EXPECT_EQ(plan.Acquire(0), a);
+  EXPECT_EQ(plan.Acquire(0), c);
+  (void)b;
+}
+
+TEST(SegmentPlanTest, ContiguousEndWaitsForEarlierSegments) {
+  SegmentPlan plan(kMin);
+  plan.Reset(kTotal);
+  const size_t first = plan.Acquire(0);
+  const size_t second = plan.Acquire(0);
+  plan.Commit(second, plan.segment(second).remaining(), 0);
+  EXPECT_EQ(plan.contiguous_end(), 0u);
+  plan.Commit(first, 4096, 0);
+  EXPECT_EQ(plan.contiguous_end(), 4096u);
+  plan.Commit(first, plan.segment(first).remaining(), 0);
+  EXPECT_EQ(plan.contiguous_end(), kTotal);
+  EXPECT_TRUE(plan.complete());
+  EXPECT_EQ(plan.Acquire(0), SegmentPlan::kNone);
+}
+
+TEST(SegmentPlanTest, RestoreRejectsGapsAndOverruns) {
+  SegmentPlan plan(kMin);
+  SegmentPlan::Segment a;
+  a.begin = 0;
+  a.end = 100;
+  a.done = 100;
+  SegmentPlan::Segment b;
+  b.begin = 120;
+  b.end = 200;
+  EXPECT_FALSE(plan.Restore(200, {a, b}));
+  b.begin = 100;
+  b.done = 101;
+  EXPECT_FALSE(plan.Restore(200, {a, b}));
+  b.done = 30;
+  EXPECT_FALSE(plan.Restore(300, {a, b}));
+  ASSERT_TRUE(plan.Restore(200, {a, b}));
+  EXPECT_EQ(plan.completed(), 130u);
+  EXPECT_EQ(plan.contiguous_end(), 130u);
+  EXPECT_EQ(plan.Acquire(0), 1u);
+}
+
+TEST(SegmentPlanTest, SnapshotMergesAdjacentCompletedSegments) {
+  SegmentPlan plan(kMin);
+  plan.Reset(kTotal);
+  const size_t first = plan.Acquire(0);
+  const size_t second = plan.Acquire(0);
+  const size_t third = plan.Acquire(0);
+  plan.Commit(first, kTotal, 0);
+  plan.Commit(third, kTotal, 0);
+  plan.Commit(second, 4096, 0);
+
+  // 顺序是 first、third、second
+  const auto snapshot = plan.Snapshot();
+  ASSERT_EQ(snapshot.size(), 2u);
+  EXPECT_EQ(snapshot[0].begin, 0u);
+  EXPECT_EQ(snapshot[0].end, plan.segment(second).begin);
+  EXPECT_EQ(snapshot[0].remaining(), 0u);
+  EXPECT_EQ(snapshot[1].done, 4096u);
+  EXPECT_EQ(snapshot[1].end, kTotal);
+}
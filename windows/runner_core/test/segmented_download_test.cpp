@@ -0,0 +1,311 @@
+#include "segmented_download.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "local_http_server.h"
+#include "test_utils.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string RandomContent(size_t size, uint32_t seed) {
+  std::mt19937 random(seed);
+  std::string content(size, '\0');
+  for (char& c : content) {
+    c = static_cast<char>(random() & 0xff);
+  }
+  return content;
+}
+
+std::unique_ptr<HttpConnectionPool> MakePool() {
+  HttpConnectionPool::Options options;
+  options.max_connections_per_host = 8;
+  options.acquire_timeout = std::chrono::seconds(5);
+  return std::make_unique<HttpConnectionPool>(
+      std::make_unique<SocketHttpConnectionFactory>(), options);
+}
+
+DownloadOptions TestOptions() {
+  DownloadOptions options;
+  options.max_connections = 4;
+  options.min_split_size = 64 * 1024;
+  options.max_retries = 5;
+  options.retry_delay = std::chrono::milliseconds(10);
+  options.request_timeout = std::chrono::seconds(5);
+  options.progress_interval = std::chrono::milliseconds(20);
+  options.checkpoint_interval = std::chrono::milliseconds(100);
+  return options;
+}
+
+std::string ReadContent(const fs::path& path) {
+  const std::vector<uint8_t> bytes = ReadTestFile(path);
+  return std::string(bytes.begin(), bytes.end());
+}
+
+// 下载到接收了 |pause_at| 字节后暂停。
+DownloadResult RunUntil(HttpConnectionPool* pool,
+                        const std::string& url,
+                        const fs::path& destination,
+                        uint64_t pause_at) {
+  SegmentedDownload download(pool, url, destination, TestOptions());
+  return download.Run([&](const DownloadProgress& progress) {
+    if (progress.received >= pause_at) {
+      download.Pause();
+    }
+  });
+}
+
+}  // namespace
+
+TEST(DownloadJournalTest, RoundTripsAndRejectsCorruption) {
+  DownloadJournal journal;
+  journal.url = "https://example.com/game.zip";
+  journal.validator = "\"abc\"";
+  journal.total_size = 300;
+  SegmentPlan::Segment a;
+  a.end = 100;
+  a.done = 100;
+  SegmentPlan::Segment b;
+  b.begin = 100;
+  b.end = 300;
+  b.done = 7;
+  journal.segments = {a, b};
+  Sha256 hasher;
+  hasher.Update("0123456789", 10);
+  journal.hash = hasher.GetMidstate();
+
+  std::vector<uint8_t> bytes = journal.Serialize();
+  DownloadJournal parsed;
+  ASSERT_TRUE(parsed.Parse(bytes.data(), bytes.size()));
+  EXPECT_EQ(parsed.url, journal.url);
+  EXPECT_EQ(parsed.validator, journal.validator);
+  EXPECT_EQ(parsed.total_size, 300u);
+  ASSERT_EQ(parsed.segments.size(), 2u);
+  EXPECT_EQ(parsed.segments[1].begin, 100u);
+  EXPECT_EQ(parsed.segments[1].done, 7u);
+  EXPECT_EQ(parsed.hash.total_length, 10u);
+
+  // 从中间状态继续和一次算完结果相同
+  Sha256 resumed;
+  resumed.SetMidstate(parsed.hash);
+  resumed.Update("abc", 3);
+  EXPECT_EQ(resumed.Finish(), Sha256::Hash("0123456789abc", 13));
+
+  EXPECT_FALSE(parsed.Parse(bytes.data(), bytes.size() - 1));
+  bytes[sizeof(uint32_t) * 2] ^= 1;
+  EXPECT_FALSE(parsed.Parse(bytes.data(), bytes.size()));
+}
+
+TEST(SegmentedDownloadTest, ProbeReportsRangesSizeAndFileName) {
+  LocalHttpServer::Options options;
+  options.file_name = "game v1.zip";
+  LocalHttpServer server(RandomContent(5000, 1), options);
+  ASSERT_TRUE(server.Start());
+  auto pool = MakePool();
+
+  DownloadProbe probe;
+  std::string error;
+  ASSERT_TRUE(ProbeDownload(pool.get(), server.url(), &probe, &error))
+      << error;
+  EXPECT_EQ(probe.status_code, 206);
+  EXPECT_TRUE(probe.ranges);
+  EXPECT_EQ(probe.total_size, 5000u);
+  EXPECT_EQ(probe.content_type, "application/zip");
+  EXPECT_EQ(probe.file_name, "game v1.zip");
+}
+
+TEST(SegmentedDownloadTest, ProbeWithoutRangesUsesContentLength) {
+  LocalHttpServer::Options options;
+  options.ranges = false;
+  LocalHttpServer server(RandomContent(256 * 1024, 2), options);
+  ASSERT_TRUE(server.Start());
+  auto pool = MakePool();
+
+  DownloadProbe probe;
+  std::string error;
+  ASSERT_TRUE(ProbeDownload(pool.get(), server.url("/files/%E6%B8%B8.zip?x=1"),
+                            &probe, &error))
+      << error;
+  EXPECT_EQ(probe.status_code, 200);
+  EXPECT_FALSE(probe.ranges);
+  EXPECT_EQ(probe.total_size, 256u * 1024);
+  EXPECT_EQ(probe.file_name, "\xE6\xB8\xB8.zip");
+}
+
+TEST(SegmentedDownloadTest, DownloadsOverSeveralConnections) {
+  const std::string content = RandomContent(2 * 1024 * 1024, 3);
+  LocalHttpServer::Options options;
+  options.bytes_per_second = 2 * 1024 * 1024;
+  LocalHttpServer server(content, options);
+  ASSERT_TRUE(server.Start());
+  auto pool = MakePool();
+  const fs::path directory = MakeTempDirectory("download_parallel");
+  const fs::path destination = directory / "game.zip";
+
+  SegmentedDownload download(pool.get(), server.url(), destination,
+                             TestOptions());
+  download.set_expected_sha256(Sha256::Hash(content.data(), content.size()));
+  size_t peak_connections = 0;
+  const DownloadResult result =
+      download.Run([&](const DownloadProgress& progress) {
+        peak_connections = std::max(peak_connections, progress.connections);
+        EXPECT_LE(progress.verified, progress.received);
+      });
+
+  ASSERT_EQ(result.status, DownloadStatus::kCompleted) << result.error;
+  EXPECT_EQ(result.size, content.size());
+  EXPECT_EQ(result.sha256, Sha256::Hash(content.data(), content.size()));
+  EXPECT_EQ(ReadContent(destination), content);
+  EXPECT_FALSE(fs::exists(SegmentedDownload::PartPath(destination)));
+  EXPECT_FALSE(fs::exists(SegmentedDownload::JournalPath(destination)));
+  EXPECT_GT(peak_connections, 1u);
+  EXPECT_GT(server.stats().range_requests, 1u);
+}
+
+// 连接在响应中途断开，重试后从断开的位置继续。
+TEST(SegmentedDownloadTest, RetriesDroppedConnections) {
+  const std::string content = RandomContent(1024 * 1024, 4);
+  LocalHttpServer::Options options;
+  options.drop_after_bytes = 100 * 1024;
+  options.drop_responses = 3;
+  LocalHttpServer server(content, options);
+  ASSERT_TRUE(server.Start());
+  auto pool = MakePool();
+  const fs::path destination =
+      MakeTempDirectory("download_dropped") / "game.zip";
+
+  SegmentedDownload download(pool.get(), server.url(), destination,
+                             TestOptions());
+  const DownloadResult result = download.Run(nullptr);
+
+  ASSERT_EQ(result.status, DownloadStatus::kCompleted) << result.error;
+  EXPECT_EQ(ReadContent(destination), content);
+  EXPECT_EQ(server.stats().dropped, 3u);
+}
+
+TEST(SegmentedDownloadTest, ResumesFromTheJournal) {
+  const std::string content = RandomContent(1024 * 1024, 5);
+  LocalHttpServer::Options options;
+  options.bytes_per_second = 128 * 1024;
+  LocalHttpServer server(content, options);
+  ASSERT_TRUE(server.Start());
+  auto pool = MakePool();
+  const fs::path destination = MakeTempDirectory("download_resume") /
+                               "game.zip";
+
+  const DownloadResult paused =
+      RunUntil(pool.get(), server.url(), destination, 256 * 1024);
+  ASSERT_EQ(paused.status, DownloadStatus::kPaused) << paused.error;
+  EXPECT_TRUE(fs::exists(SegmentedDownload::PartPath(destination)));
+  EXPECT_TRUE(fs::exists(SegmentedDownload::JournalPath(destination)));
+
+  // 仍然限速，被拆短的段不会有大量数据已经在 socket 缓冲区里
+  server.SetBytesPerSecond(1024 * 1024);
+  const uint64_t sent_before = server.stats().body_bytes;
+  SegmentedDownload download(pool.get(), server.url(), destination,
+                             TestOptions());
+  download.set_expected_sha256(Sha256::Hash(content.data(), content.size()));
+  const DownloadResult result = download.Run(nullptr);
+
+  ASSERT_EQ(result.status, DownloadStatus::kCompleted) << result.error;
+  EXPECT_GE(result.resumed_from, 256u * 1024);
+  EXPECT_EQ(ReadContent(destination), content);
+  // 每个被拆短或关闭的响应最多多发一块
+  EXPECT_LE(server.stats().body_bytes - sent_before,
+            content.size() - result.resumed_from + 128 * 1024);
+}
+
+// 续传时服务器上的文件已经换了，If-Range 不匹配，从头下载新文件。
+TEST(SegmentedDownloadTest, RestartsWhenTheFileChanged) {
+  LocalHttpServer::Options options;
+  options.bytes_per_second = 128 * 1024;
+  LocalHttpServer server(RandomContent(1024 * 1024, 6), options);
+  ASSERT_TRUE(server.Start());
+  auto pool = MakePool();
+  const fs::path destination = MakeTempDirectory("download_changed") /
+                               "game.zip";
+
+  const DownloadResult paused =
+      RunUntil(pool.get(), server.url(), destination, 128 * 1024);
+  ASSERT_EQ(paused.status, DownloadStatus::kPaused) << paused.error;
+
+  const std::string updated = RandomContent(900 * 1024, 7);
+  server.SetContent(updated, "\"v2\"");
+  server.SetBytesPerSecond(0);
+  SegmentedDownload download(pool.get(), server.url(), destination,
+                             TestOptions());
+  download.set_expected_sha256(Sha256::Hash(updated.data(), updated.size()));
+  const DownloadResult result = download.Run(nullptr);
+
+  ASSERT_EQ(result.status, DownloadStatus::kCompleted) << result.error;
+  EXPECT_GT(result.resumed_from, 0u);
+  EXPECT_EQ(ReadContent(destination), updated);
+}
+
+TEST(SegmentedDownloadTest, FallsBackToOneStreamWithoutRanges) {
+  const std::string content = RandomContent(700 * 1024, 8);
+  LocalHttpServer::Options options;
+  options.ranges = false;
+  LocalHttpServer server(content, options);
+  ASSERT_TRUE(server.Start());
+  auto pool = MakePool();
+  const fs::path destination = MakeTempDirectory("download_single") /
+                               "game.zip";
+
+  SegmentedDownload download(pool.get(), server.url(), destination,
+                             TestOptions());
+  const DownloadResult result = download.Run(nullptr);
+
+  ASSERT_EQ(result.status, DownloadStatus::kCompleted) << result.error;
+  EXPECT_EQ(result.sha256, Sha256::Hash(content.data(), content.size()));
+  EXPECT_EQ(ReadContent(destination), content);
+  EXPECT_EQ(server.stats().requests, 1u);
+  EXPECT_FALSE(fs::exists(SegmentedDownload::JournalPath(destination)));
+}
+
+TEST(SegmentedDownloadTest, DeletesTheFileOnChecksumMismatch) {
+  const std::string content = RandomContent(300 * 1024, 9);
+  LocalHttpServer server(content, LocalHttpServer::Options());
+  ASSERT_TRUE(server.Start());
+  auto pool = MakePool();
+  const fs::path destination = MakeTempDirectory("download_mismatch") /
+                               "game.zip";
+
+  SegmentedDownload download(pool.get(), server.url(), destination,
+                             TestOptions());
+  download.set_expected_sha256(Sha256::Hash("other", 5));
+  const DownloadResult result = download.Run(nullptr);
+
+  EXPECT_EQ(result.status, DownloadStatus::kFailed);
+  EXPECT_TRUE(result.checksum_mismatch);
+  EXPECT_FALSE(fs::exists(destination));
+  EXPECT_FALSE(fs::exists(SegmentedDownload::PartPath(destination)));
+  EXPECT_FALSE(fs::exists(SegmentedDownload::JournalPath(destination)));
+}
+
+// 服务器只允许两条连接，多出的连接收到 503 后退出，其余连接下完。
+TEST(SegmentedDownloadTest, BacksOffWhenTheServerLimitsConnections) {
+  const std::string content = RandomContent(1024 * 1024, 10);
+  LocalHttpServer::Options options;
+  options.max_connections = 2;
+  options.bytes_per_second = 1024 * 1024;
+  LocalHttpServer server(content, options);
+  ASSERT_TRUE(server.Start());
+  auto pool = MakePool();
+  const fs::path destination = MakeTempDirectory("download_limited") /
+                               "game.zip";
+
+  SegmentedDownload download(pool.get(), server.url(), destination,
+                             TestOptions());
+  const DownloadResult result = download.Run(nullptr);
+
+  ASSERT_EQ(result.status, DownloadStatus::kCompleted) << result.error;
+  EXPECT_EQ(ReadContent(destination), content);
+  EXPECT_GT(server.stats().rejected, 0u);
+}
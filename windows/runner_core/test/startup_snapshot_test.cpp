@@ -0,0 +1,78 @@
+#include "startup_snapshot.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "test_utils.h"
+
+namespace {
+
+std::vector<uint8_t> Bytes(const std::string& text) {
+  return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+}  // namespace
+
+TEST(StartupSnapshotTest, RejectsBadSectionNames) {
+  StartupSnapshotWriter writer;
+  EXPECT_FALSE(writer.Put("", {}));
+  EXPECT_FALSE(writer.Put(std::string(65, 'a'), {}));
+  EXPECT_TRUE(writer.Put(std::string(64, 'a'), {}));
+}
+
+TEST(StartupSnapshotTest, SerializesAndParses) {
+  StartupSnapshotWriter writer;
+  writer.Put("home.hot_games", Bytes(std::string(60000, 'g')));
+  writer.Put("home.hot_posts", Bytes(std::string(30000, 'p')));
+  writer.Put("session", Bytes("{}"));
+  writer.Put("empty", {});
+  const std::vector<uint8_t> bytes = writer.Serialize(3, 1234);
+
+  StartupSnapshotReader reader;
+  ASSERT_TRUE(reader.Parse(bytes.data(), bytes.size()));
+  EXPECT_EQ(reader.schema(), 3u);
+  EXPECT_EQ(reader.saved_unix_ms(), 1234);
+  EXPECT_EQ(reader.sections().size(), 4u);
+  const auto* section = reader.Find("home.hot_posts");
+  ASSERT_NE(section, nullptr);
+  EXPECT_EQ(section->size, 30000u);
+  EXPECT_EQ(section->data[0], 'p');
+  EXPECT_EQ(reader.Find("empty")->size, 0u);
+  EXPECT_EQ(reader.Find("missing"), nullptr);
+}
+
+// 截断或损坏的快照整个作废，不会返回部分内容。
+TEST(StartupSnapshotTest, RejectsTruncatedAndCorruptedData) {
+  StartupSnapshotWriter writer;
+  writer.Put("home.latest_games", Bytes(std::string(5000, 'l')));
+  writer.Put("session", Bytes("{\"userId\":\"1\"}"));
+  const std::vector<uint8_t> bytes = writer.Serialize(1, 0);
+  for (size_t size = 0; size < bytes.size(); size += 37) {
+    StartupSnapshotReader reader;
+    EXPECT_FALSE(reader.Parse(bytes.data(), size)) << size;
+  }
+  // 头部、段表和段内容各改一个字节
+  for (size_t offset : {size_t{4}, size_t{70}, bytes.size() - 3}) {
+    std::vector<uint8_t> copy = bytes;
+    copy[offset] ^= 0x40;
+    StartupSnapshotReader reader;
+    EXPECT_FALSE(reader.Parse(copy.data(), copy.size())) << offset;
+  }
+}
+
+TEST(StartupSnapshotTest, WritesAndOpensFile) {
+  const auto directory = MakeTempDirectory("startup_snapshot");
+  StartupSnapshotWriter writer;
+  writer.Put("home.hot_games", Bytes("[1,2,3]"));
+  ASSERT_TRUE(writer.Write(directory / "snapshot.bin", 1, 99));
+
+  StartupSnapshotReader reader;
+  ASSERT_TRUE(reader.Open(directory / "snapshot.bin"));
+  EXPECT_EQ(reader.saved_unix_ms(), 99);
+  ASSERT_NE(reader.Find("home.hot_games"), nullptr);
+  reader.Close();
+  EXPECT_FALSE(reader.valid());
+  EXPECT_FALSE(reader.Open(directory / "missing.bin"));
+}
@@ -0,0 +1,241 @@
+#include "startup_trace.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "test_utils.h"
+
+namespace {
+
+std::string ReadTrace(const std::filesystem::path& path) {
+  const std::vector<uint8_t> bytes = ReadTestFile(path);
+  return std::string(bytes.begin(), bytes.end());
+}
+
+size_t CountOccurrences(const std::string& text, const std::string& needle) {
+  size_t count = 0;
+  for (size_t at = text.find(needle); at != std::string::npos;
+       at = text.find(needle, at + needle.size())) {
+    ++count;
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST(StartupTraceTest, DisabledTraceRecordsNothing) {
+  const auto directory = MakeTempDirectory("startup_trace_disabled");
+  StartupTrace trace;
+  trace.AddSpan("ignored", "startup", 1, 2);
+  trace.AddInstant("ignored", "startup");
+  EXPECT_TRUE(trace.Flush());
+  EXPECT_FALSE(std::filesystem::exists(directory / "trace.json"));
+}
+
+TEST(StartupTraceTest, WritesChromeTraceJson) {
+  const auto path = MakeTempDirectory("startup_trace_json") / "trace.json";
+  StartupTrace trace;
+  trace.Enable(path.u8string());
+  trace.SetCurrentThreadName("platform");
+  const int64_t begin = StartupTrace::NowMicros();
+  trace.AddSpan(trace.InternName("load \"config\"\n"), "startup", begin,
+                begin + 250);
+  trace.AddSpan("inverted", "startup", begin + 10, begin);
+  trace.AddInstant("first_frame", "dart");
+  ASSERT_TRUE(trace.Flush());
+
+  const std::string json = ReadTrace(path);
+  EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+  EXPECT_EQ(json.substr(json.size() - 3), "]}\n");
+  EXPECT_NE(json.find("{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,"
+                      "\"tid\":1,\"args\":{\"name\":\"platform\"}}"),
+            std::string::npos);
+  // 名称按 JSON 转义，时间相对 Enable 时刻
+  EXPECT_NE(json.find("\"name\":\"load \\\"config\\\"\\n\""), std::string::npos);
+  EXPECT_NE(json.find(",\"dur\":250}"), std::string::npos);
+  EXPECT_NE(json.find(",\"dur\":0}"), std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"first_frame\",\"cat\":\"dart\""),
+            std::string::npos);
+  EXPECT_NE(json.find(",\"s\":\"t\"}"), std::string::npos);
+  EXPECT_EQ(json.find("\"ts\":-"), std::string::npos);
+
+  // 只写出一次
+  std::filesystem::remove(path);
+  EXPECT_TRUE(trace.Flush());
+  EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+// 环形缓冲区写满后覆盖最早的事件，输出保留最近的事件并保持顺序。
+TEST(StartupTraceTest, RingBufferKeepsTheNewestEvents) {
+  const auto path = MakeTempDirectory("startup_trace_ring") / "trace.json";
+  StartupTrace trace(4);
+  trace.Enable(path.u8string());
+  const int64_t begin = StartupTrace::NowMicros();
+  for (int i = 0; i < 10; ++i) {
+    trace.AddSpan(trace.InternName("span_" + std::to_string(i)), "startup",
+                  begin + i, begin + i + 1);
+  }
+  ASSERT_TRUE(trace.Flush());
+
+  const std::string json = ReadTrace(path);
+  EXPECT_EQ(CountOccurrences(json, "\"ph\":\"X\""), 4u);
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(json.find("\"span_" + std::to_string(i) + "\""),
+              std::string::npos);
+  }
+  size_t previous = 0;
+  for (int i = 6; i < 10; ++i) {
+    const size_t at = json.find("\"span_" + std::to_string(i) + "\"");
+    ASSERT_NE(at, std::string::npos);
+    EXPECT_GT(at, previous);
+    previous = at;
+  }
+}
+
+// 每个线程写自己的缓冲区；写入过程中 Flush 只读取已经发布的事件。
+TEST(StartupTraceTest, ConcurrentWritersGetTheirOwnBuffers) {
+  const auto path = MakeTempDirectory("startup_trace_threads") / "trace.json";
+  constexpr int kThreads = 4;
+  constexpr int kSpansPerThread = 1000;
+  StartupTrace trace(kSpansPerThread);
+  trace.Enable(path.u8string());
+
+  std::atomic<int> ready{0};
+  std::vector<std::thread> writers;
+  for (int t = 0; t < kThreads; ++t) {
+    writers.emplace_back([&trace, &ready] {
+      ++ready;
+      while (ready.load() < kThreads) {
+        std::this_thread::yield();
+      }
+      for (int i = 0; i < kSpansPerThread; ++i) {
+        const int64_t now = StartupTrace::NowMicros();
+        trace.AddSpan("work", "worker", now, now + 1);
+      }
+    });
+  }
+  while (ready.load() < kThreads) {
+    std::this_thread::yield();
+  }
+  ASSERT_TRUE(trace.Flush());
+  for (auto& writer : writers) {
+    writer.join();
+  }
+
+  const std::string json = ReadTrace(path);
+  EXPECT_EQ(json.substr(json.size() - 3), "]}\n");
+  EXPECT_LE(CountOccurrences(json, "\"ph\":\"X\""),
+            static_cast<size_t>(kThreads * kSpansPerThread));
+  std::set<std::string> thread_ids;
+  for (size_t at = json.find("\"tid\":"); at != std::string::npos;
+       at = json.find("\"tid\":", at + 1)) {
+    thread_ids.insert(json.substr(at + 6, json.find(',', at) - at - 6));
+  }
+  EXPECT_LE(thread_ids.size(), static_cast<size_t>(kThreads));
+}
+
+TEST(StartupTraceTest, EveryThreadIsWrittenOut) {
+  const auto path = MakeTempDirectory("startup_trace_joined") / "trace.json";
+  constexpr int kThreads = 4;
+  constexpr int kSpansPerThread = 500;
+  StartupTrace trace;
+  trace.Enable(path.u8string());
+  std::vector<std::thread> writers;
+  for (int t = 0; t < kThreads; ++t) {
+    writers.emplace_back([&trace] {
+      trace.SetCurrentThreadName("worker");
+      for (int i = 0; i < kSpansPerThread; ++i) {
+        const int64_t now = StartupTrace::NowMicros();
+        trace.AddSpan("work", "worker", now, now + 1);
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  ASSERT_TRUE(trace.Flush());
+
+  const std::string json = ReadTrace(path);
+  EXPECT_EQ(CountOccurrences(json, "\"ph\":\"X\""),
+            static_cast<size_t>(kThreads * kSpansPerThread));
+  EXPECT_EQ(CountOccurrences(json, "\"name\":\"thread_name\""),
+            static_cast<size_t>(kThreads));
+  for (int t = 1; t <= kThreads; ++t) {
+    EXPECT_NE(json.find("\"tid\":" + std::to_string(t) + ","),
+              std::string::npos);
+  }
+}
+
+// Flush 与正在回绕的写入并发时，输出的每条事件都是完整的：名称和时长
+// 总是同一次写入的内容。
+TEST(StartupTraceTest, FlushDuringWraparoundEmitsNoTornEvents) {
+  static const char* const kNames[] = {"d0", "d1", "d2", "d3",
+                                       "d4", "d5", "d6", "d7"};
+  constexpr int kThreads = 4;
+  for (int round = 0; round < 20; ++round) {
+    const auto path = MakeTempDirectory("startup_trace_torn_" +
+                                        std::to_string(round)) /
+                      "trace.json";
+    StartupTrace trace(16);
+    trace.Enable(path.u8string());
+    std::atomic<bool> stop{false};
+    std::atomic<int> ready{0};
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kThreads; ++t) {
+      writers.emplace_back([&] {
+        ++ready;
+        for (int64_t i = 0; !stop.load(std::memory_order_relaxed); ++i) {
+          const int64_t now = StartupTrace::NowMicros();
+          trace.AddSpan(kNames[i % 8], "worker", now, now + i % 8);
+        }
+      });
+    }
+    while (ready.load() < kThreads) {
+      std::this_thread::yield();
+    }
+    ASSERT_TRUE(trace.Flush());
+    stop = true;
+    for (auto& writer : writers) {
+      writer.join();
+    }
+
+    const std::string json = ReadTrace(path);
+    EXPECT_EQ(json.substr(json.size() - 3), "]}\n");
+    for (size_t at = json.find("{\"ph\":\"X\""); at != std::string::npos;
+         at = json.find("{\"ph\":\"X\"", at + 1)) {
+      const std::string event = json.substr(at, json.find('}', at) - at);
+      const size_t name = event.find("\"name\":\"d");
+      const size_t duration = event.find(",\"dur\":");
+      ASSERT_NE(name, std::string::npos) << event;
+      ASSERT_NE(duration, std::string::npos) << event;
+      EXPECT_EQ(event[name + 9], event[duration + 7]) << event;
+      EXPECT_NE(event.find("\"cat\":\"worker\""), std::string::npos) << event;
+    }
+  }
+}
+
+// 同一线程交替写两个实例：每个实例里该线程只注册一个缓冲区。
+TEST(StartupTraceTest, AlternatingInstancesKeepOneBufferPerThread) {
+  const auto directory = MakeTempDirectory("startup_trace_alternating");
+  StartupTrace first;
+  StartupTrace second;
+  first.Enable((directory / "first.json").u8string());
+  second.Enable((directory / "second.json").u8string());
+  for (int i = 0; i < 100; ++i) {
+    const int64_t now = StartupTrace::NowMicros();
+    first.AddSpan("first", "startup", now, now + 1);
+    second.AddSpan("second", "startup", now, now + 1);
+  }
+  ASSERT_TRUE(first.Flush());
+  ASSERT_TRUE(second.Flush());
+  for (const char* name : {"first.json", "second.json"}) {
+    const std::string json = ReadTrace(directory / name);
+    EXPECT_EQ(CountOccurrences(json, "\"ph\":\"X\""), 100u) << name;
+    EXPECT_EQ(CountOccurrences(json, "\"tid\":1,"), 100u) << name;
+  }
+}
@@ -0,0 +1,34 @@
+#ifndef RUNNER_CORE_TEST_TEST_UTILS_H_
+#define RUNNER_CORE_TEST_TEST_UTILS_H_
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// 在 gtest 的临时目录下创建一个空目录，已存在时先清空。
+inline std::filesystem::path MakeTempDirectory(const std::string& name) {
+  const std::filesystem::path directory =
+      std::filesystem::path(::testing::TempDir()) / ("runner_core_" + name);
+  std::error_code error;
+  std::filesystem::remove_all(directory, error);
+  std::filesystem::create_directories(directory);
+  return directory;
+}
+
+inline void WriteTestFile(const std::filesystem::path& path,
+                          const std::string& contents) {
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream(path, std::ios::binary) << contents;
+}
+
+inline std::vector<uint8_t> ReadTestFile(const std::filesystem::path& path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), {});
+}
+
+#endif  // RUNNER_CORE_TEST_TEST_UTILS_H_
@@ -0,0 +1,124 @@
+#include "thumbnail_store.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include "test_utils.h"
+
+namespace {
+
+PixelBuffer Gradient(uint32_t width, uint32_t height, uint8_t alpha) {
+  PixelBuffer image;
+  image.Allocate(width, height);
+  for (uint32_t y = 0; y < height; ++y) {
+    uint8_t* row = image.row(y);
+    for (uint32_t x = 0; x < width; ++x) {
+      // 预乘：颜色不超过 alpha
+      row[x * 4] = static_cast<uint8_t>(x * alpha / width);
+      row[x * 4 + 1] = static_cast<uint8_t>(y * alpha / height);
+      row[x * 4 + 2] = 0;
+      row[x * 4 + 3] = alpha;
+    }
+  }
+  return image;
+}
+
+DiskCache::Options CacheOptions() {
+  DiskCache::Options options;
+  options.max_bytes = 64 << 20;
+  options.max_entries = 1024;
+  return options;
+}
+
+}  // namespace
+
+TEST(ThumbnailStoreTest, PicksWidthBuckets) {
+  EXPECT_EQ(ThumbnailWidthFor(1), 96u);
+  EXPECT_EQ(ThumbnailWidthFor(96), 96u);
+  EXPECT_EQ(ThumbnailWidthFor(97), 160u);
+  EXPECT_EQ(ThumbnailWidthFor(641), 960u);
+  EXPECT_EQ(ThumbnailWidthFor(5000), 960u);
+}
+
+TEST(ThumbnailStoreTest, MakeThumbnailKeepsAspectRatio) {
+  PixelBuffer thumbnail;
+  ASSERT_TRUE(MakeThumbnail(Gradient(1600, 900, 255), 320, &thumbnail));
+  EXPECT_EQ(thumbnail.width, 320u);
+  EXPECT_EQ(thumbnail.height, 180u);
+
+  // 原图比档位窄时不放大
+  ASSERT_TRUE(MakeThumbnail(Gradient(200, 100, 255), 320, &thumbnail));
+  EXPECT_EQ(thumbnail.width, 200u);
+  EXPECT_EQ(thumbnail.height, 100u);
+
+  EXPECT_FALSE(MakeThumbnail(PixelBuffer(), 320, &thumbnail));
+  EXPECT_FALSE(MakeThumbnail(Gradient(10, 10, 255), 0, &thumbnail));
+}
+
+// 超长图只保留顶部，高度最多为宽度的 4 倍。
+TEST(ThumbnailStoreTest, MakeThumbnailCapsTallImages) {
+  PixelBuffer thumbnail;
+  ASSERT_TRUE(MakeThumbnail(Gradient(400, 8000, 255), 160, &thumbnail));
+  EXPECT_EQ(thumbnail.width, 160u);
+  EXPECT_EQ(thumbnail.height, 640u);
+}
+
+TEST(ThumbnailStoreTest, MakeThumbnailUnpremultipliesAlpha) {
+  PixelBuffer source;
+  source.Allocate(4, 4);
+  for (size_t i = 0; i < source.pixels.size(); i += 4) {
+    source.pixels[i] = 64;  // 预乘后的蓝色，alpha 为一半
+    source.pixels[i + 3] = 128;
+  }
+  PixelBuffer thumbnail;
+  ASSERT_TRUE(MakeThumbnail(source, 96, &thumbnail));
+  ASSERT_EQ(thumbnail.width, 4u);
+  EXPECT_EQ(thumbnail.pixels[0], 128);
+  EXPECT_EQ(thumbnail.pixels[3], 128);
+}
+
+TEST(ThumbnailStoreTest, StoresVariantsPerWidth) {
+  DiskCache cache(MakeTempDirectory("thumbnail_store_variants"),
+                  CacheOptions());
+  ASSERT_TRUE(cache.Open());
+  ThumbnailStore store(&cache);
+
+  PixelBuffer small;
+  PixelBuffer large;
+  ASSERT_TRUE(MakeThumbnail(Gradient(1600, 900, 255), 160, &small));
+  ASSERT_TRUE(MakeThumbnail(Gradient(1600, 900, 255), 480, &large));
+  ASSERT_TRUE(store.Put("cover", 160, small, INT64_MAX));
+  ASSERT_TRUE(store.Put("cover", 480, large, INT64_MAX));
+  EXPECT_FALSE(store.Put("cover", 96, PixelBuffer(), INT64_MAX));
+
+  PixelBuffer loaded;
+  ASSERT_TRUE(store.Get("cover", 160, &loaded));
+  EXPECT_EQ(loaded.width, small.width);
+  EXPECT_EQ(loaded.height, small.height);
+  EXPECT_EQ(loaded.pixels, small.pixels);
+  ASSERT_TRUE(store.Get("cover", 480, &loaded));
+  EXPECT_EQ(loaded.pixels, large.pixels);
+  EXPECT_FALSE(store.Get("cover", 240, &loaded));
+  EXPECT_FALSE(store.Get("other", 160, &loaded));
+}
+
+// 内容文件被截断或改写时当作未命中，并移除缓存条目。
+TEST(ThumbnailStoreTest, DropsCorruptVariants) {
+  DiskCache cache(MakeTempDirectory("thumbnail_store_corrupt"), CacheOptions());
+  ASSERT_TRUE(cache.Open());
+  ThumbnailStore store(&cache);
+  PixelBuffer thumbnail;
+  ASSERT_TRUE(MakeThumbnail(Gradient(320, 180, 255), 160, &thumbnail));
+  ASSERT_TRUE(store.Put("cover", 160, thumbnail, INT64_MAX));
+
+  DiskCache::Entry entry;
+  ASSERT_TRUE(cache.Lookup("cover#w160", &entry));
+  std::filesystem::resize_file(entry.path, entry.size - 1);
+
+  PixelBuffer loaded;
+  EXPECT_FALSE(store.Get("cover", 160, &loaded));
+  EXPECT_FALSE(cache.Lookup("cover#w160", &entry));
+}
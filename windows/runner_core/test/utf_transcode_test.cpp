@@ -0,0 +1,124 @@
+#include "utf_transcode.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 逐字符的参考实现，无效输入返回 false。
+bool ReferenceUtf16ToUtf8(const std::u16string& input, std::string* output) {
+  output->clear();
+  for (size_t i = 0; i < input.size(); ++i) {
+    uint32_t c = input[i];
+    if (c >= 0xD800 && c <= 0xDBFF) {
+      if (i + 1 >= input.size() || input[i + 1] < 0xDC00 ||
+          input[i + 1] > 0xDFFF) {
+        return false;
+      }
+      c = 0x10000 + ((c - 0xD800) << 10) + (input[++i] - 0xDC00u);
+    } else if (c >= 0xDC00 && c <= 0xDFFF) {
+      return false;
+    }
+    if (c < 0x80) {
+      output->push_back(static_cast<char>(c));
+    } else if (c < 0x800) {
+      output->push_back(static_cast<char>(0xC0 | (c >> 6)));
+      output->push_back(static_cast<char>(0x80 | (c & 0x3F)));
+    } else if (c < 0x10000) {
+      output->push_back(static_cast<char>(0xE0 | (c >> 12)));
+      output->push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+      output->push_back(static_cast<char>(0x80 | (c & 0x3F)));
+    } else {
+      output->push_back(static_cast<char>(0xF0 | (c >> 18)));
+      output->push_back(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+      output->push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+      output->push_back(static_cast<char>(0x80 | (c & 0x3F)));
+    }
+  }
+  return true;
+}
+
+// ASCII、中文和代理对混合，偶尔插入未配对的代理项。
+std::u16string RandomUtf16(std::mt19937* rng, size_t length) {
+  std::u16string text;
+  while (text.size() < length) {
+    switch ((*rng)() % 8) {
+      case 0:
+        text.push_back(static_cast<char16_t>(0x80 + (*rng)() % 0x780));
+        break;
+      case 1:
+        text.push_back(static_cast<char16_t>(0xD800 + (*rng)() % 0x400));
+        text.push_back(static_cast<char16_t>(0xDC00 + (*rng)() % 0x400));
+        break;
+      case 2:
+      case 3:
+      case 4:
+        text.push_back(static_cast<char16_t>(0x4E00 + (*rng)() % 0x5000));
+        break;
+      default:
+        text.push_back(static_cast<char16_t>(0x20 + (*rng)() % 0x5F));
+        break;
+    }
+  }
+  if ((*rng)() % 16 == 0) {
+    text[(*rng)() % text.size()] = static_cast<char16_t>(0xDC00);
+  }
+  return text;
+}
+
+}  // namespace
+
+TEST(UtfTranscodeTest, RoundTrip) {
+  const std::u16string text = u"首页 Hot games 🎮 ＲＰＧ";
+  std::string utf8;
+  ASSERT_TRUE(Utf16ToUtf8(text, &utf8));
+  EXPECT_EQ(utf8, "首页 Hot games 🎮 ＲＰＧ");
+  std::u16string utf16;
+  ASSERT_TRUE(Utf8ToUtf16(utf8, &utf16));
+  EXPECT_EQ(utf16, text);
+}
+
+TEST(UtfTranscodeTest, RejectsInvalidInput) {
+  std::string utf8;
+  EXPECT_FALSE(Utf16ToUtf8(std::u16string(1, char16_t(0xD83C)), &utf8));
+  EXPECT_FALSE(Utf16ToUtf8(std::u16string(1, char16_t(0xDF2E)), &utf8));
+  std::u16string utf16;
+  EXPECT_FALSE(Utf8ToUtf16("\xC0\xAF", &utf16));          // 过长编码
+  EXPECT_FALSE(Utf8ToUtf16("\xED\xA0\x80", &utf16));      // 代理项
+  EXPECT_FALSE(Utf8ToUtf16("\xF4\x90\x80\x80", &utf16));  // 超出范围
+  EXPECT_FALSE(Utf8ToUtf16("\xE4\xB8", &utf16));          // 截断
+}
+
+// SIMD 路径按块处理，长度覆盖各种块边界。
+TEST(UtfTranscodeTest, MatchesReferenceOnRandomText) {
+  std::mt19937 rng(20240601);
+  for (int round = 0; round < 2000; ++round) {
+    const std::u16string text = RandomUtf16(&rng, 1 + rng() % 200);
+    std::string expected;
+    const bool valid = ReferenceUtf16ToUtf8(text, &expected);
+    std::string actual;
+    ASSERT_EQ(Utf16ToUtf8(text, &actual), valid) << round;
+    if (!valid) {
+      continue;
+    }
+    ASSERT_EQ(actual, expected) << round;
+    std::u16string back;
+    ASSERT_TRUE(Utf8ToUtf16(actual, &back));
+    ASSERT_EQ(back, text);
+  }
+}
+
+TEST(UtfTranscodeTest, BatchKeepsInvalidStringsEmpty) {
+  const std::u16string invalid(1, char16_t(0xD800));
+  const std::u16string_view strings[] = {u"--flag", invalid, u"", u"参数"};
+  Utf8Batch batch;
+  EXPECT_FALSE(Utf16ToUtf8Batch(strings, 4, &batch));
+  ASSERT_EQ(batch.size(), 4u);
+  EXPECT_EQ(batch[0], "--flag");
+  EXPECT_EQ(batch[1], "");
+  EXPECT_EQ(batch[2], "");
+  EXPECT_EQ(batch[3], "参数");
+}